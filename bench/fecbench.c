@@ -0,0 +1,494 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+//
+// fecbench.c : benchmark forward error-correction schemes
+//
+// Runs every combination of fec scheme, crc scheme and message length
+// through the packetizer, measuring the encoder and the hard- and
+// soft-decision decoders. With -o the results are written as one row per
+// combination (whitespace-separated columns, '#' comments) for comparing
+// runs, e.g. after upgrading the library.
+//
+
+// default include headers
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include <string.h>
+#include <math.h>
+#include <sys/resource.h>
+
+#include "liquid.h"
+#include "heapcount.h"
+
+void usage()
+{
+    // help
+    printf("Usage: fecbench [OPTION]\n");
+    printf("Benchmark forward error-correction schemes through the packetizer.\n");
+    printf("  -h            display this help and exit\n");
+    printf("  -v/q          verbose/quiet\n");
+    printf("  -t[SECONDS]   set minimum execution time of each measurement (s)\n");
+    printf("  -o[FILENAME]  export output\n");
+    printf("  -n[LEN_MIN]   minimum message length (bytes)\n");
+    printf("  -N[LEN_MAX]   maximum message length (bytes); lengths double from LEN_MIN\n");
+    printf("  -f[FEC]       run single fec scheme (default: all)\n");
+    printf("  -c[CRC]       run single crc scheme (default: all)\n");
+    printf("  -C[CLOCK]     set cpu clock frequency (Hz) (default: estimate)\n");
+    printf(" available fec schemes:\n");
+    liquid_print_fec_schemes();
+    printf(" available crc schemes:\n");
+    liquid_print_crc_schemes();
+}
+
+// operations measured for each configuration
+enum {
+    FECBENCH_ENCODE=0,      // packetizer_encode()
+    FECBENCH_DECODE,        // packetizer_decode()
+    FECBENCH_DECODE_SOFT,   // packetizer_decode_soft()
+    FECBENCH_NUM_OPS
+};
+
+// benchmark structure
+struct benchmark_s {
+    // packetizer options
+    fec_scheme   fec;           // forward error-correction scheme
+    crc_scheme   crc;           // error-detection scheme
+    unsigned int dec_msg_len;   // message length (bytes)
+    unsigned int enc_msg_len;   // encoded length (bytes)
+
+    // benchmark results, for each operation
+    unsigned long int num_trials[FECBENCH_NUM_OPS]; // number of trials
+    float extime[FECBENCH_NUM_OPS];                 // execution time
+    long int num_allocs[FECBENCH_NUM_OPS];          // allocations per trial
+    int valid;                                      // decoded messages check
+
+    // derived values
+    float mbps[FECBENCH_NUM_OPS];               // message throughput (Mbps)
+    float cycles_per_bit[FECBENCH_NUM_OPS];     // cpu cycles per message bit
+};
+
+// simulation structure
+struct fecbench_s {
+    int verbose;
+    float runtime;              // minimum run time (s)
+    float cpu_clock;            // cpu clock frequency (Hz)
+
+    // sweep
+    fec_scheme   fec;           // single fec scheme (unknown for all)
+    crc_scheme   crc;           // single crc scheme (unknown for all)
+    unsigned int len_min;       // minimum message length
+    unsigned int len_max;       // maximum message length
+
+    // output file
+    char filename[128];         // output filename
+    FILE * fid;                 // output file pointer
+    int output_to_file;         // output file write flag
+};
+
+// helper functions:
+char convert_units(float * _s);
+double calculate_execution_time(struct rusage, struct rusage);
+float estimate_cpu_clock(void);
+
+// run all benchmarks
+void fecbench_execute(struct fecbench_s * _fecbench);
+
+// execute single benchmark
+void execute_benchmark_fec(struct benchmark_s * _benchmark,
+                           float                _runtime,
+                           float                _cpu_clock);
+
+// run operation _op for _num_trials trials, returning execution time
+double benchmark_fec_op(packetizer      _p,
+                        int             _op,
+                        unsigned long   _num_trials,
+                        unsigned char * _msg,
+                        unsigned char * _pkt,
+                        unsigned char * _soft,
+                        unsigned char * _msg_dec);
+
+void benchmark_print_to_file(FILE * _fid,
+                             struct benchmark_s * _benchmark);
+
+void benchmark_print(struct benchmark_s * _benchmark);
+
+// main function
+int main(int argc, char *argv[])
+{
+    // options
+    struct fecbench_s fecbench;
+    fecbench.verbose    = 1;
+    fecbench.runtime    = 0.01f;
+    fecbench.cpu_clock  = 0.0f;
+    fecbench.fec        = LIQUID_FEC_UNKNOWN;
+    fecbench.crc        = LIQUID_CRC_UNKNOWN;
+    fecbench.len_min    = 16;
+    fecbench.len_max    = 1024;
+    fecbench.filename[0]= '\0';
+    fecbench.fid        = NULL;
+    fecbench.output_to_file = 0;
+
+    // get input options
+    int d;
+    while((d = getopt(argc,argv,"hvqt:o:n:N:f:c:C:")) != EOF){
+        switch (d) {
+        case 'h':   usage();        return 0;
+        case 'v':   fecbench.verbose = 1;    break;
+        case 'q':   fecbench.verbose = 0;    break;
+        case 't':
+            fecbench.runtime = atof(optarg);
+            if (fecbench.runtime < 1e-3f)     fecbench.runtime = 1e-3f;
+            else if (fecbench.runtime > 10.f) fecbench.runtime = 10.0f;
+            printf("minimum runtime: %d ms\n", (int) roundf(fecbench.runtime*1e3));
+            break;
+        case 'o':
+            fecbench.output_to_file = 1;
+            strncpy(fecbench.filename, optarg, sizeof(fecbench.filename)-1);
+            fecbench.filename[sizeof(fecbench.filename)-1] = '\0';
+            break;
+        case 'n':   fecbench.len_min = atoi(optarg);    break;
+        case 'N':   fecbench.len_max = atoi(optarg);    break;
+        case 'f':
+            fecbench.fec = liquid_getopt_str2fec(optarg);
+            if (fecbench.fec == LIQUID_FEC_UNKNOWN) {
+                fprintf(stderr,"error: %s, unknown/unsupported fec scheme '%s'\n", argv[0], optarg);
+                exit(1);
+            }
+            break;
+        case 'c':
+            fecbench.crc = liquid_getopt_str2crc(optarg);
+            if (fecbench.crc == LIQUID_CRC_UNKNOWN) {
+                fprintf(stderr,"error: %s, unknown/unsupported crc scheme '%s'\n", argv[0], optarg);
+                exit(1);
+            }
+            break;
+        case 'C':
+            fecbench.cpu_clock = atof(optarg);
+            if (fecbench.cpu_clock <= 0) {
+                fprintf(stderr,"error: %s, cpu clock speed must be positive\n", argv[0]);
+                exit(1);
+            }
+            break;
+        default:
+            usage();
+            return 0;
+        }
+    }
+
+    // validate input
+    if (fecbench.len_min == 0 || fecbench.len_min > fecbench.len_max) {
+        fprintf(stderr,"error: %s, message lengths must satisfy 0 < LEN_MIN <= LEN_MAX\n", argv[0]);
+        exit(1);
+    }
+
+    // estimate cpu clock frequency for cycles/bit
+    if (fecbench.cpu_clock == 0.0f)
+        fecbench.cpu_clock = estimate_cpu_clock();
+
+    // open output file (if applicable)
+    unsigned int i;
+    if (fecbench.output_to_file) {
+        fecbench.fid = fopen(fecbench.filename,"w");
+        if (!fecbench.fid) {
+            fprintf(stderr,"error: %s, could not open file '%s' for writing\n", argv[0], fecbench.filename);
+            exit(1);
+        }
+        FILE * fid = fecbench.fid;
+
+        // print header
+        fprintf(fid,"# %s : auto-generated file\n", fecbench.filename);
+        fprintf(fid,"#\n");
+        fprintf(fid,"# invoked as:\n");
+        fprintf(fid,"#   ");
+        for (i=0; i<argc; i++)
+            fprintf(fid," %s", argv[i]);
+        fprintf(fid,"\n");
+        fprintf(fid,"#\n");
+        fprintf(fid,"# properties:\n");
+        fprintf(fid,"#  runtime             :   %12.8f s\n", fecbench.runtime);
+        fprintf(fid,"#  cpu_clock           :   %e Hz\n", fecbench.cpu_clock);
+        fprintf(fid,"#  lengths             :   %u to %u bytes\n", fecbench.len_min, fecbench.len_max);
+        fprintf(fid,"#\n");
+        fprintf(fid,"# throughput is of message (decoded) bits; allocs are heap allocations\n");
+        fprintf(fid,"# per call once the packetizer is set up (-1 if not counted); valid is\n");
+        fprintf(fid,"# 1 if both decoders recovered the message\n");
+        fprintf(fid,"#\n");
+        fprintf(fid,"# %-10s %-10s %6s %6s %8s %10s %10s %10s %10s %10s %10s %6s %6s %6s %5s\n",
+                "fec", "crc", "n", "k", "rate",
+                "enc Mbps", "enc c/b", "dec Mbps", "dec c/b", "soft Mbps", "soft c/b",
+                "a/enc", "a/dec", "a/soft", "valid");
+    }
+
+    // run benchmarks
+    fecbench_execute(&fecbench);
+
+    if (fecbench.output_to_file) {
+        fclose(fecbench.fid);
+        printf("results written to %s\n", fecbench.filename);
+    }
+
+    return 0;
+}
+
+// convert raw value into metric units,
+//   example: "0.01397s" -> "13.97 ms"
+char convert_units(float * _v)
+{
+    char unit;
+    if (*_v < 1e-9)     {   (*_v) *= 1e12;  unit = 'p';}
+    else if (*_v < 1e-6){   (*_v) *= 1e9;   unit = 'n';}
+    else if (*_v < 1e-3){   (*_v) *= 1e6;   unit = 'u';}
+    else if (*_v < 1e+0){   (*_v) *= 1e3;   unit = 'm';}
+    else if (*_v < 1e3) {   (*_v) *= 1e+0;  unit = ' ';}
+    else if (*_v < 1e6) {   (*_v) *= 1e-3;  unit = 'k';}
+    else if (*_v < 1e9) {   (*_v) *= 1e-6;  unit = 'M';}
+    else if (*_v < 1e12){   (*_v) *= 1e-9;  unit = 'G';}
+    else                {   (*_v) *= 1e-12; unit = 'T';}
+
+    return unit;
+}
+
+double calculate_execution_time(struct rusage _start, struct rusage _finish)
+{
+    return _finish.ru_utime.tv_sec - _start.ru_utime.tv_sec
+        + 1e-6*(_finish.ru_utime.tv_usec - _start.ru_utime.tv_usec)
+        + _finish.ru_stime.tv_sec - _start.ru_stime.tv_sec
+        + 1e-6*(_finish.ru_stime.tv_usec - _start.ru_stime.tv_usec);
+}
+
+// estimate cpu clock frequency (see bench/bench.c)
+float estimate_cpu_clock(void)
+{
+    unsigned long int i, n = 1<<4;
+    struct rusage start, finish;
+    double extime;
+    unsigned int k = 366001;    // large prime number
+    unsigned int g = 184903;    // another large prime number
+    unsigned int s = 1;
+
+    // run trials until execution time threshold is exceeded
+    do {
+        n <<= 1;
+        getrusage(RUSAGE_SELF, &start);
+        for (i=0; i<n; i++)
+            s = (s*k) % g;
+        getrusage(RUSAGE_SELF, &finish);
+        extime = calculate_execution_time(start, finish);
+    } while (extime < 0.5 && n < (1<<28));
+
+    // NOTE: 's' is printed so that the compiler actually runs the loop
+    float cpu_clock = 9.5 * n / extime;
+    float clock_format = cpu_clock;
+    char clock_units = convert_units(&clock_format);
+    printf("estimated clock speed: %7.3f %cHz (s = %u)\n", clock_format, clock_units, s);
+    return cpu_clock;
+}
+
+// run all benchmarks
+void fecbench_execute(struct fecbench_s * _fecbench)
+{
+    // validate input
+    if (_fecbench->runtime <= 0.0f) {
+        fprintf(stderr,"fecbench_execute(), runtime must be greater than zero\n");
+        exit(1);
+    }
+
+    if (_fecbench->verbose) {
+        printf("  %-10s %-10s %6s %6s %6s | %-18s | %-18s | %-18s | %s\n",
+                "fec", "crc", "n", "k", "rate",
+                "encode", "decode (hard)", "decode (soft)", "allocs");
+        printf("  %-10s %-10s %6s %6s %6s | %7s %10s | %7s %10s | %7s %10s |\n",
+                "", "", "", "", "",
+                "Mbps", "cycles/bit", "Mbps", "cycles/bit", "Mbps", "cycles/bit");
+    }
+
+    struct benchmark_s benchmark;
+    int fec;
+    int crc;
+    unsigned int n;
+    for (fec=1; fec<LIQUID_FEC_NUM_SCHEMES; fec++) {
+        if (_fecbench->fec != LIQUID_FEC_UNKNOWN && fec != _fecbench->fec)
+            continue;
+        for (crc=1; crc<LIQUID_CRC_NUM_SCHEMES; crc++) {
+            if (_fecbench->crc != LIQUID_CRC_UNKNOWN && crc != _fecbench->crc)
+                continue;
+            for (n=_fecbench->len_min; n<=_fecbench->len_max; n*=2) {
+                // initialize benchmark structure
+                memset(&benchmark, 0x00, sizeof(struct benchmark_s));
+                benchmark.fec         = fec;
+                benchmark.crc         = crc;
+                benchmark.dec_msg_len = n;
+
+                // run the benchmark
+                execute_benchmark_fec(&benchmark, _fecbench->runtime, _fecbench->cpu_clock);
+
+                if (_fecbench->verbose)
+                    benchmark_print(&benchmark);
+
+                if (_fecbench->output_to_file)
+                    benchmark_print_to_file(_fecbench->fid, &benchmark);
+            }
+        }
+    }
+}
+
+// execute single benchmark
+void execute_benchmark_fec(struct benchmark_s * _benchmark,
+                           float                _runtime,
+                           float                _cpu_clock)
+{
+    // create packetizer and buffers
+    unsigned int n = _benchmark->dec_msg_len;
+    packetizer p = packetizer_create(n, _benchmark->crc, _benchmark->fec, LIQUID_FEC_NONE);
+    unsigned int k = packetizer_get_enc_msg_len(p);
+    _benchmark->enc_msg_len = k;
+
+    unsigned char * msg     = (unsigned char*) malloc(n*sizeof(unsigned char));
+    unsigned char * msg_dec = (unsigned char*) malloc(n*sizeof(unsigned char));
+    unsigned char * pkt     = (unsigned char*) malloc(k*sizeof(unsigned char));
+    unsigned char * soft    = (unsigned char*) malloc(8*k*sizeof(unsigned char));
+    unsigned int i;
+    for (i=0; i<n; i++)
+        msg[i] = rand() & 0xff;
+
+    // encode once and check that both decoders recover the message
+    packetizer_encode(p, msg, pkt);
+    for (i=0; i<8*k; i++)
+        soft[i] = (pkt[i/8] >> (7-(i%8))) & 1 ? LIQUID_SOFTBIT_1 : LIQUID_SOFTBIT_0;
+    int valid = packetizer_decode(p, pkt, msg_dec) && memcmp(msg, msg_dec, n) == 0;
+    valid = packetizer_decode_soft(p, soft, msg_dec) && memcmp(msg, msg_dec, n) == 0 && valid;
+    _benchmark->valid = valid;
+
+    int op;
+    for (op=0; op<FECBENCH_NUM_OPS; op++) {
+        // count allocations of a single call
+        long int num_allocs = heapcount_num_allocs();
+        benchmark_fec_op(p, op, 1, msg, pkt, soft, msg_dec);
+        _benchmark->num_allocs[op] = num_allocs < 0 ? -1 : heapcount_num_allocs() - num_allocs;
+
+        // increase number of trials until minimum run time is reached
+        unsigned long int num_trials = 1;
+        unsigned int num_attempts = 0;
+        double extime;
+        do {
+            num_attempts++;
+            extime = benchmark_fec_op(p, op, num_trials, msg, pkt, soft, msg_dec);
+            if (extime >= _runtime)
+                break;
+            if (num_attempts == 30) {
+                fprintf(stderr,"warning: benchmark could not execute over minimum run time\n");
+                break;
+            }
+            num_trials *= 2;
+        } while (1);
+
+        // derived values
+        _benchmark->num_trials[op]     = num_trials;
+        _benchmark->extime[op]         = extime;
+        _benchmark->mbps[op]           = 8.0f * n * num_trials / extime * 1e-6f;
+        _benchmark->cycles_per_bit[op] = _cpu_clock * extime / (8.0f * n * num_trials);
+    }
+
+    packetizer_destroy(p);
+    free(msg);
+    free(msg_dec);
+    free(pkt);
+    free(soft);
+}
+
+// run operation _op for _num_trials trials, returning execution time
+double benchmark_fec_op(packetizer      _p,
+                        int             _op,
+                        unsigned long   _num_trials,
+                        unsigned char * _msg,
+                        unsigned char * _pkt,
+                        unsigned char * _soft,
+                        unsigned char * _msg_dec)
+{
+    struct rusage start, finish;
+    unsigned long int i;
+
+    getrusage(RUSAGE_SELF, &start);
+    switch (_op) {
+    case FECBENCH_ENCODE:
+        for (i=0; i<_num_trials; i++)
+            packetizer_encode(_p, _msg, _pkt);
+        break;
+    case FECBENCH_DECODE:
+        for (i=0; i<_num_trials; i++)
+            packetizer_decode(_p, _pkt, _msg_dec);
+        break;
+    case FECBENCH_DECODE_SOFT:
+        for (i=0; i<_num_trials; i++)
+            packetizer_decode_soft(_p, _soft, _msg_dec);
+        break;
+    default:
+        fprintf(stderr,"error: benchmark_fec_op(), invalid operation\n");
+        exit(1);
+    }
+    getrusage(RUSAGE_SELF, &finish);
+
+    return calculate_execution_time(start, finish);
+}
+
+void benchmark_print_to_file(FILE * _fid,
+                             struct benchmark_s * _benchmark)
+{
+    fprintf(_fid,"  %-10s %-10s %6u %6u %8.5f %10.3f %10.2f %10.3f %10.2f %10.3f %10.2f %6ld %6ld %6ld %5d\n",
+            fec_scheme_str[_benchmark->fec][0],
+            crc_scheme_str[_benchmark->crc][0],
+            _benchmark->dec_msg_len,
+            _benchmark->enc_msg_len,
+            (float)_benchmark->dec_msg_len / (float)_benchmark->enc_msg_len,
+            _benchmark->mbps[FECBENCH_ENCODE],
+            _benchmark->cycles_per_bit[FECBENCH_ENCODE],
+            _benchmark->mbps[FECBENCH_DECODE],
+            _benchmark->cycles_per_bit[FECBENCH_DECODE],
+            _benchmark->mbps[FECBENCH_DECODE_SOFT],
+            _benchmark->cycles_per_bit[FECBENCH_DECODE_SOFT],
+            _benchmark->num_allocs[FECBENCH_ENCODE],
+            _benchmark->num_allocs[FECBENCH_DECODE],
+            _benchmark->num_allocs[FECBENCH_DECODE_SOFT],
+            _benchmark->valid);
+}
+
+void benchmark_print(struct benchmark_s * _benchmark)
+{
+    printf("  %-10s %-10s %6u %6u %6.4f | %7.2f %10.2f | %7.2f %10.2f | %7.2f %10.2f | %ld/%ld/%ld%s\n",
+            fec_scheme_str[_benchmark->fec][0],
+            crc_scheme_str[_benchmark->crc][0],
+            _benchmark->dec_msg_len,
+            _benchmark->enc_msg_len,
+            (float)_benchmark->dec_msg_len / (float)_benchmark->enc_msg_len,
+            _benchmark->mbps[FECBENCH_ENCODE],
+            _benchmark->cycles_per_bit[FECBENCH_ENCODE],
+            _benchmark->mbps[FECBENCH_DECODE],
+            _benchmark->cycles_per_bit[FECBENCH_DECODE],
+            _benchmark->mbps[FECBENCH_DECODE_SOFT],
+            _benchmark->cycles_per_bit[FECBENCH_DECODE_SOFT],
+            _benchmark->num_allocs[FECBENCH_ENCODE],
+            _benchmark->num_allocs[FECBENCH_DECODE],
+            _benchmark->num_allocs[FECBENCH_DECODE_SOFT],
+            _benchmark->valid ? "" : " (decoding failed)");
+}
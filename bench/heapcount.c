@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+//
+// heapcount.c : heap allocation counter for benchmark programs
+//
+// With glibc, the allocator entry points are interposed so that every
+// call (including those made inside the library) is counted before being
+// passed on to the glibc implementation. Only programs linking this file
+// are affected; the counter is updated atomically so that allocations
+// from other threads (e.g. asynchronous decoders) are counted too.
+//
+
+#include <stdlib.h>
+
+#include "heapcount.h"
+
+#if defined(__GLIBC__)
+extern void * __libc_malloc(size_t);
+extern void * __libc_calloc(size_t, size_t);
+extern void * __libc_realloc(void *, size_t);
+
+static long int heapcount_allocs = 0;
+
+void * malloc(size_t _n)
+{
+    __sync_fetch_and_add(&heapcount_allocs, 1);
+    return __libc_malloc(_n);
+}
+
+void * calloc(size_t _n, size_t _s)
+{
+    __sync_fetch_and_add(&heapcount_allocs, 1);
+    return __libc_calloc(_n,_s);
+}
+
+void * realloc(void * _p, size_t _n)
+{
+    __sync_fetch_and_add(&heapcount_allocs, 1);
+    return __libc_realloc(_p,_n);
+}
+
+long int heapcount_num_allocs(void)
+{
+    return __sync_fetch_and_add(&heapcount_allocs, 0);
+}
+#else
+long int heapcount_num_allocs(void) { return -1; }
+#endif
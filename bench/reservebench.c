@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+//
+// reservebench.c : heap allocations of frame synchronizers
+//
+// Receives frames with random payload lengths, crc and fec schemes
+// through flexframesync, ofdmflexframesync and gmskframesync, counting the
+// heap allocations made while receiving with and without reserving
+// memory (*_reserve()) first. Each synchronizer first receives one frame
+// to set its payload modulation scheme, which reserving does not cover.
+// Returns a non-zero exit status if any reserved synchronizer allocates
+// or recovers different frames.
+//
+
+// default include headers
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include <complex.h>
+#include <sys/resource.h>
+
+#include "liquid.h"
+#include "heapcount.h"
+
+void usage()
+{
+    // help
+    printf("Usage: reservebench [OPTION]\n");
+    printf("Count heap allocations of frame synchronizers receiving frames.\n");
+    printf("  -h            display this help and exit\n");
+    printf("  -n[LEN_MAX]   maximum payload length (bytes), default: 1500\n");
+    printf("  -N[FRAMES]    number of frames, default: 32\n");
+    printf("  -f[FEC]       add fec scheme to those used (default: none, h128,\n");
+    printf("                g2412, secded7264, v27, rs8)\n");
+    printf("  -a            use all fec schemes\n");
+    printf("  -s[SEED]      random seed\n");
+    printf(" available fec schemes:\n");
+    liquid_print_fec_schemes();
+}
+
+// synchronizer types
+enum {
+    RESERVEBENCH_FLEXFRAME=0,
+    RESERVEBENCH_OFDMFLEXFRAME,
+    RESERVEBENCH_GMSKFRAME,
+    RESERVEBENCH_NUM_TYPES
+};
+
+const char * reservebench_type_str[RESERVEBENCH_NUM_TYPES] = {
+    "flexframesync",
+    "ofdmflexframesync",
+    "gmskframesync",
+};
+
+// frame properties
+struct reservebench_frame_s {
+    unsigned int  payload_len;
+    crc_scheme    check;
+    fec_scheme    fec0;
+    fec_scheme    fec1;
+    float complex * samples;
+    unsigned int  num_samples;
+};
+
+// OFDM frame parameters
+#define RESERVEBENCH_OFDM_M         (64)
+#define RESERVEBENCH_OFDM_CP_LEN    (16)
+#define RESERVEBENCH_OFDM_TAPER_LEN (4)
+
+// generate frame samples
+void reservebench_generate(int                           _type,
+                           struct reservebench_frame_s * _frame);
+
+// receive frames, returning number of valid payloads; allocations made
+// while receiving all but the first frame are written to _num_allocs
+unsigned int reservebench_receive(int                           _type,
+                                  struct reservebench_frame_s * _frames,
+                                  unsigned int                  _num_frames,
+                                  unsigned int                  _max_payload_len,
+                                  const fec_scheme *            _fec,
+                                  unsigned int                  _num_fec,
+                                  int                           _reserve,
+                                  long int *                    _num_allocs,
+                                  float *                       _reserve_time);
+
+double calculate_execution_time(struct rusage, struct rusage);
+
+// count valid payloads
+static int reservebench_callback(unsigned char *  _header,
+                                 int              _header_valid,
+                                 unsigned char *  _payload,
+                                 unsigned int     _payload_len,
+                                 int              _payload_valid,
+                                 framesyncstats_s _stats,
+                                 void *           _userdata)
+{
+    if (_header_valid && _payload_valid)
+        (*(unsigned int*)_userdata)++;
+    return 0;
+}
+
+// main function
+int main(int argc, char *argv[])
+{
+    // options
+    unsigned int max_payload_len = 1500;
+    unsigned int num_frames      = 32;
+    fec_scheme   fec[LIQUID_FEC_NUM_SCHEMES];
+    unsigned int num_fec         = 0;
+    unsigned int seed            = 1;
+
+    int d;
+    while((d = getopt(argc,argv,"hn:N:f:as:")) != EOF){
+        switch (d) {
+        case 'h':   usage();                        return 0;
+        case 'n':   max_payload_len = atoi(optarg); break;
+        case 'N':   num_frames      = atoi(optarg); break;
+        case 'f':
+            if (num_fec == LIQUID_FEC_NUM_SCHEMES) {
+                fprintf(stderr,"error: %s, too many fec schemes\n", argv[0]);
+                exit(1);
+            }
+            fec[num_fec] = liquid_getopt_str2fec(optarg);
+            if (fec[num_fec] == LIQUID_FEC_UNKNOWN) {
+                fprintf(stderr,"error: %s, unknown/unsupported fec scheme '%s'\n", argv[0], optarg);
+                exit(1);
+            }
+            num_fec++;
+            break;
+        case 'a':
+            for (num_fec=0; num_fec<LIQUID_FEC_NUM_SCHEMES-1; num_fec++)
+                fec[num_fec] = LIQUID_FEC_NONE + num_fec;
+            break;
+        case 's':   seed = atoi(optarg);            break;
+        default:
+            usage();
+            return 0;
+        }
+    }
+
+    // validate input
+    if (max_payload_len == 0 || num_frames == 0) {
+        fprintf(stderr,"error: %s, payload length and number of frames must be greater than zero\n", argv[0]);
+        exit(1);
+    }
+
+    // default schemes
+    if (num_fec == 0) {
+        fec[num_fec++] = LIQUID_FEC_NONE;
+        fec[num_fec++] = LIQUID_FEC_HAMMING128;
+        fec[num_fec++] = LIQUID_FEC_GOLAY2412;
+        fec[num_fec++] = LIQUID_FEC_SECDED7264;
+        fec[num_fec++] = LIQUID_FEC_CONV_V27;
+        fec[num_fec++] = LIQUID_FEC_RS_M8;
+    }
+
+    printf("  %-18s %8s | %-18s | %-28s\n",
+            "", "", "not reserved", "reserved");
+    printf("  %-18s %8s | %8s %9s | %8s %9s %9s\n",
+            "synchronizer", "frames", "valid", "allocs", "valid", "allocs", "reserve");
+
+    // run each synchronizer with the same sequence of frames
+    int failed = 0;
+    int type;
+    unsigned int i;
+    struct reservebench_frame_s frames[num_frames+1];
+    for (type=0; type<RESERVEBENCH_NUM_TYPES; type++) {
+        srand(seed);
+        for (i=0; i<=num_frames; i++) {
+            // first frame sets modulation scheme
+            frames[i].payload_len = i==0 ? 64 : 1 + rand() % max_payload_len;
+            frames[i].check       = LIQUID_CRC_NONE + rand() % (LIQUID_CRC_NUM_SCHEMES-1);
+            frames[i].fec0        = i==0 ? LIQUID_FEC_NONE : fec[rand() % num_fec];
+            frames[i].fec1        = i==0 ? LIQUID_FEC_NONE : fec[rand() % num_fec];
+            reservebench_generate(type, &frames[i]);
+        }
+
+        long int num_allocs[2];
+        float    reserve_time;
+        unsigned int num_valid_0 = reservebench_receive(type, frames, num_frames+1,
+                max_payload_len, fec, num_fec, 0, &num_allocs[0], &reserve_time);
+        unsigned int num_valid_1 = reservebench_receive(type, frames, num_frames+1,
+                max_payload_len, fec, num_fec, 1, &num_allocs[1], &reserve_time);
+
+        printf("  %-18s %8u | %8u %9ld | %8u %9ld %6.2f ms\n",
+                reservebench_type_str[type], num_frames+1,
+                num_valid_0, num_allocs[0],
+                num_valid_1, num_allocs[1], reserve_time*1e3f);
+
+        // reserving must not change which frames are recovered
+        if (num_valid_1 != num_valid_0 || num_allocs[1] > 0)
+            failed = 1;
+
+        for (i=0; i<=num_frames; i++)
+            free(frames[i].samples);
+    }
+
+    if (heapcount_num_allocs() < 0)
+        printf("allocations are not counted on this platform\n");
+
+    return failed;
+}
+
+double calculate_execution_time(struct rusage _start, struct rusage _finish)
+{
+    return _finish.ru_utime.tv_sec - _start.ru_utime.tv_sec
+        + 1e-6*(_finish.ru_utime.tv_usec - _start.ru_utime.tv_usec)
+        + _finish.ru_stime.tv_sec - _start.ru_stime.tv_sec
+        + 1e-6*(_finish.ru_stime.tv_usec - _start.ru_stime.tv_usec);
+}
+
+// generate frame samples
+void reservebench_generate(int                           _type,
+                           struct reservebench_frame_s * _frame)
+{
+    unsigned int i;
+    unsigned char header[14] = {0};
+    unsigned char payload[_frame->payload_len];
+    for (i=0; i<_frame->payload_len; i++)
+        payload[i] = rand() & 0xff;
+
+    // a few idle samples follow each frame
+    unsigned int pad = 256;
+    switch (_type) {
+    case RESERVEBENCH_FLEXFRAME: {
+        flexframegenprops_s props;
+        flexframegenprops_init_default(&props);
+        props.check = _frame->check;
+        props.fec0  = _frame->fec0;
+        props.fec1  = _frame->fec1;
+        flexframegen fg = flexframegen_create(&props);
+        flexframegen_assemble(fg, header, payload, _frame->payload_len);
+        _frame->num_samples = flexframegen_getframelen(fg) + pad;
+        _frame->samples = (float complex*) calloc(_frame->num_samples, sizeof(float complex));
+        flexframegen_write_samples(fg, _frame->samples, _frame->num_samples);
+        flexframegen_destroy(fg);
+        } break;
+    case RESERVEBENCH_OFDMFLEXFRAME: {
+        ofdmflexframegenprops_s props;
+        ofdmflexframegenprops_init_default(&props);
+        props.check = _frame->check;
+        props.fec0  = _frame->fec0;
+        props.fec1  = _frame->fec1;
+        ofdmflexframegen fg = ofdmflexframegen_create(RESERVEBENCH_OFDM_M,
+                                                      RESERVEBENCH_OFDM_CP_LEN,
+                                                      RESERVEBENCH_OFDM_TAPER_LEN,
+                                                      NULL, &props);
+        ofdmflexframegen_assemble(fg, header, payload, _frame->payload_len);
+        _frame->num_samples = (ofdmflexframegen_getframelen(fg) + 1) *
+                              (RESERVEBENCH_OFDM_M + RESERVEBENCH_OFDM_CP_LEN) + pad;
+        _frame->samples = (float complex*) calloc(_frame->num_samples, sizeof(float complex));
+        ofdmflexframegen_write(fg, _frame->samples, _frame->num_samples);
+        ofdmflexframegen_destroy(fg);
+        } break;
+    case RESERVEBENCH_GMSKFRAME: {
+        // gmskframegen writes one symbol (k=2 samples) per call
+        gmskframegen fg = gmskframegen_create();
+        gmskframegen_assemble(fg, header, payload, _frame->payload_len,
+                              _frame->check, _frame->fec0, _frame->fec1);
+        _frame->num_samples = 2*gmskframegen_getframelen(fg) + pad;
+        _frame->samples = (float complex*) calloc(_frame->num_samples, sizeof(float complex));
+        for (i=0; i+2<=_frame->num_samples; i+=2) {
+            if (gmskframegen_write_samples(fg, &_frame->samples[i]))
+                break;
+        }
+        gmskframegen_destroy(fg);
+        } break;
+    default:;
+    }
+}
+
+// receive frames
+unsigned int reservebench_receive(int                           _type,
+                                  struct reservebench_frame_s * _frames,
+                                  unsigned int                  _num_frames,
+                                  unsigned int                  _max_payload_len,
+                                  const fec_scheme *            _fec,
+                                  unsigned int                  _num_fec,
+                                  int                           _reserve,
+                                  long int *                    _num_allocs,
+                                  float *                       _reserve_time)
+{
+    unsigned int num_valid = 0;
+    flexframesync     fs   = NULL;
+    ofdmflexframesync ofs  = NULL;
+    gmskframesync     gfs  = NULL;
+    switch (_type) {
+    case RESERVEBENCH_FLEXFRAME:
+        fs = flexframesync_create(reservebench_callback, &num_valid);
+        break;
+    case RESERVEBENCH_OFDMFLEXFRAME:
+        ofs = ofdmflexframesync_create(RESERVEBENCH_OFDM_M,
+                                       RESERVEBENCH_OFDM_CP_LEN,
+                                       RESERVEBENCH_OFDM_TAPER_LEN,
+                                       NULL, reservebench_callback, &num_valid);
+        break;
+    case RESERVEBENCH_GMSKFRAME:
+        gfs = gmskframesync_create(reservebench_callback, &num_valid);
+        break;
+    default:;
+    }
+
+    struct rusage start, finish;
+    unsigned int i;
+    long int num_allocs = 0;
+    for (i=0; i<_num_frames; i++) {
+        // reserve memory after the first frame has set the modulation
+        if (i == 1) {
+            getrusage(RUSAGE_SELF, &start);
+            if (_reserve && fs)  flexframesync_reserve    (fs,  _max_payload_len, _fec, _num_fec);
+            if (_reserve && ofs) ofdmflexframesync_reserve(ofs, _max_payload_len, _fec, _num_fec);
+            if (_reserve && gfs) gmskframesync_reserve    (gfs, _max_payload_len, _fec, _num_fec);
+            getrusage(RUSAGE_SELF, &finish);
+            *_reserve_time = calculate_execution_time(start, finish);
+            num_allocs = heapcount_num_allocs();
+        }
+
+        if (fs)  flexframesync_execute    (fs,  _frames[i].samples, _frames[i].num_samples);
+        if (ofs) ofdmflexframesync_execute(ofs, _frames[i].samples, _frames[i].num_samples);
+        if (gfs) gmskframesync_execute    (gfs, _frames[i].samples, _frames[i].num_samples);
+    }
+    *_num_allocs = num_allocs < 0 ? -1 : heapcount_num_allocs() - num_allocs;
+
+    if (fs)  flexframesync_destroy(fs);
+    if (ofs) ofdmflexframesync_destroy(ofs);
+    if (gfs) gmskframesync_destroy(gfs);
+    return num_valid;
+}
@@ -942,9 +942,24 @@ int crc_check_key(crc_scheme      _scheme,
 // get size of key (bytes)
 unsigned int crc_sizeof_key(crc_scheme _scheme);
 
+// Incremental (streaming) key computation: initialize, update with
+// consecutive segments of the message, then finalize to obtain the
+// same key as crc_generate_key() over the whole message.
+//  _scheme     :   error-detection scheme
+//  _key        :   running key
+//  _msg        :   next segment of input data message [size: _n x 1]
+//  _n          :   segment size
+unsigned int crc_init_key(crc_scheme _scheme);
+unsigned int crc_update_key(crc_scheme            _scheme,
+                            unsigned int          _key,
+                            const unsigned char * _msg,
+                            unsigned int          _n);
+unsigned int crc_finalize_key(crc_scheme   _scheme,
+                              unsigned int _key);
+
 
 // available FEC schemes
-#define LIQUID_FEC_NUM_SCHEMES  28
+#define LIQUID_FEC_NUM_SCHEMES  32
 typedef enum {
     LIQUID_FEC_UNKNOWN=0,       // unknown/unsupported scheme
     LIQUID_FEC_NONE,            // no error-correction
@@ -981,7 +996,15 @@ typedef enum {
     LIQUID_FEC_CONV_V29P78,     // r7/8, K=9, dfree=4
 
     // Reed-Solomon codes
-    LIQUID_FEC_RS_M8            // m=8, n=255, k=223
+    LIQUID_FEC_RS_M8,           // m=8, n=255, k=223
+
+    // quasi-cyclic low-density parity-check codes
+    LIQUID_FEC_LDPC_R12,        // r1/2, n=1024, k=512
+    LIQUID_FEC_LDPC_R34,        // r3/4, n=1024, k=768
+
+    // CRC-aided polar codes
+    LIQUID_FEC_POLAR_R12,       // r1/2, n<=1024
+    LIQUID_FEC_POLAR_R34        // r3/4, n<=1024
 } fec_scheme;
 
 // pretty names for fec schemes
@@ -1096,7 +1119,9 @@ packetizer packetizer_create(unsigned int _dec_msg_len,
                              int _fec0,
                              int _fec1);
 
-// re-create packetizer object
+// re-create packetizer object; the object is reconfigured in place and
+// the input pointer is returned (memory is only re-allocated when the
+// new configuration needs more than was previously allocated)
 //
 //  _p      :   initialz packetizer object
 //  _n      :   number of uncoded input bytes
@@ -1109,6 +1134,21 @@ packetizer packetizer_recreate(packetizer _p,
                                int _fec0,
                                int _fec1);
 
+// pre-allocate memory for messages of up to _n bytes with any
+// error-detection scheme, the current error-correction schemes and any of
+// those listed in _fec (creating their codecs in each stage); re-creating
+// the object with shorter messages and these schemes then reconfigures it
+// in place without allocating memory
+//
+//  _p      :   packetizer object
+//  _n      :   maximum number of uncoded input bytes
+//  _fec    :   additional error-correction schemes [size: _num_fec x 1]
+//  _num_fec:   number of additional schemes (may be zero)
+void packetizer_reserve(packetizer         _p,
+                        unsigned int       _n,
+                        const fec_scheme * _fec,
+                        unsigned int       _num_fec);
+
 // destroy packetizer object
 void packetizer_destroy(packetizer _p);
 
@@ -1122,6 +1162,12 @@ crc_scheme   packetizer_get_crc        (packetizer _p);
 fec_scheme   packetizer_get_fec0       (packetizer _p);
 fec_scheme   packetizer_get_fec1       (packetizer _p);
 
+// get/set number of threads used for batch processing; additional
+// threads are started for each batch call and each one holds its own
+// fec/interleaver objects (ignored without pthreads support)
+unsigned int packetizer_get_num_threads(packetizer _p);
+void         packetizer_set_num_threads(packetizer _p, unsigned int _n);
+
 
 // Execute the packetizer on an input message
 //
@@ -1152,6 +1198,45 @@ int packetizer_decode_soft(packetizer            _p,
                            const unsigned char * _pkt,
                            unsigned char *       _msg);
 
+// Execute the packetizer on a batch of input messages
+//
+//  _p      :   packetizer object
+//  _num    :   number of messages
+//  _msg    :   input messages (uncoded bytes), [size: _num*dec_msg_len x 1]
+//  _pkt    :   encoded output messages, [size: _num*enc_msg_len x 1]
+void packetizer_encode_batch(packetizer            _p,
+                             unsigned int          _num,
+                             const unsigned char * _msg,
+                             unsigned char *       _pkt);
+
+// Execute the packetizer to decode a batch of input messages, returning
+// the number of messages which passed the validity check
+//
+//  _p      :   packetizer object
+//  _num    :   number of messages
+//  _pkt    :   input messages (coded bytes), [size: _num*enc_msg_len x 1]
+//  _msg    :   decoded output messages, [size: _num*dec_msg_len x 1]
+//  _valid  :   validity of each decoded message, [size: _num x 1] (can be NULL)
+unsigned int packetizer_decode_batch(packetizer            _p,
+                                     unsigned int          _num,
+                                     const unsigned char * _pkt,
+                                     unsigned char *       _msg,
+                                     int *                 _valid);
+
+// Execute the packetizer to decode a batch of input messages (soft bits),
+// returning the number of messages which passed the validity check
+//
+//  _p      :   packetizer object
+//  _num    :   number of messages
+//  _pkt    :   input messages (coded soft bits), [size: 8*_num*enc_msg_len x 1]
+//  _msg    :   decoded output messages, [size: _num*dec_msg_len x 1]
+//  _valid  :   validity of each decoded message, [size: _num x 1] (can be NULL)
+unsigned int packetizer_decode_soft_batch(packetizer            _p,
+                                          unsigned int          _num,
+                                          const unsigned char * _pkt,
+                                          unsigned char *       _msg,
+                                          int *                 _valid);
+
 
 //
 // interleaver
@@ -1174,6 +1259,16 @@ void interleaver_print(interleaver _q);
 void interleaver_set_depth(interleaver _q,
                            unsigned int _depth);
 
+// set length, re-allocating memory only if _n exceeds all previous
+// lengths of the object
+//  _q      :   interleaver object
+//  _n      :   number of bytes
+void interleaver_set_length(interleaver  _q,
+                            unsigned int _n);
+
+// get length (number of bytes)
+unsigned int interleaver_get_length(interleaver _q);
+
 // execute forward interleaver (encoder)
 //  _q          :   interleaver object
 //  _msg_dec    :   decoded (un-interleaved) message
@@ -3624,6 +3719,24 @@ void framedatastats_reset(framedatastats_s * _stats);
 void framedatastats_print(framedatastats_s * _stats);
 
 
+// framedecqstats : payload decoder queue statistics for frame synchronizers
+//                  operating with asynchronous payload decoding
+typedef struct {
+    unsigned int      num_workers;  // number of decoder worker threads
+    unsigned int      capacity;     // maximum number of frames in flight
+    unsigned int      num_pending;  // frames currently awaiting delivery
+    unsigned int      max_pending;  // peak number of frames awaiting delivery
+    unsigned long int num_decoded;  // number of frames delivered
+    float             latency_avg;  // average decoding latency [s]
+    float             latency_max;  // maximum decoding latency [s]
+    float             delivery_avg; // average submission-to-delivery time [s]
+    float             delivery_max; // maximum submission-to-delivery time [s]
+} framedecqstats_s;
+
+// print framedecqstats object
+void framedecqstats_print(framedecqstats_s * _stats);
+
+
 // Generic frame synchronizer callback function type
 //  _header         :   header data [size: 8 bytes]
 //  _header_valid   :   is header valid? (0:no, 1:yes)
@@ -3663,6 +3776,17 @@ int qpacketmodem_configure(qpacketmodem _q,
                            fec_scheme   _fec1,
                            int          _ms);
 
+// pre-allocate memory for payloads of up to _payload_len bytes with any
+// error-detection scheme, the current error-correction schemes and any of
+// those listed in _fec (see packetizer_reserve), and the current
+// modulation scheme; re-configuring with shorter payloads and these
+// schemes afterwards does not allocate memory unless the modulation
+// scheme changes
+void qpacketmodem_reserve(qpacketmodem       _q,
+                          unsigned int       _payload_len,
+                          const fec_scheme * _fec,
+                          unsigned int       _num_fec);
+
 // get length of encoded frame in symbols
 unsigned int qpacketmodem_get_frame_len(qpacketmodem _q);
 
@@ -3675,6 +3799,12 @@ unsigned int qpacketmodem_get_fec0     (qpacketmodem _q);
 unsigned int qpacketmodem_get_fec1     (qpacketmodem _q);
 unsigned int qpacketmodem_get_modscheme(qpacketmodem _q);
 
+// get/set number of threads used for batch processing; additional
+// threads are started for each batch call and each one holds its own
+// modem and packetizer (ignored without pthreads support)
+unsigned int qpacketmodem_get_num_threads(qpacketmodem _q);
+void         qpacketmodem_set_num_threads(qpacketmodem _q, unsigned int _n);
+
 // encode packet into un-modulated frame symbol indices
 //  _q          :   qpacketmodem object
 //  _payload    :   unencoded payload bytes
@@ -3725,6 +3855,45 @@ int qpacketmodem_decode_soft(qpacketmodem           _q,
                              liquid_float_complex * _frame,
                              unsigned char *        _payload);
 
+// encode and modulate a batch of packets
+//  _q          :   qpacketmodem object
+//  _num        :   number of packets
+//  _payload    :   unencoded payload bytes, [size: _num*payload_len x 1]
+//  _frame      :   encoded/modulated payload symbols, [size: _num*frame_len x 1]
+void qpacketmodem_encode_batch(qpacketmodem           _q,
+                               unsigned int           _num,
+                               const unsigned char *  _payload,
+                               liquid_float_complex * _frame);
+
+// decode a batch of packets from modulated frame samples, returning the
+// number of packets which passed the CRC; each stage (demodulation,
+// de-interleaving, decoding, validity check) runs across a block of packets
+// NOTE: hard-decision decoding
+//  _q          :   qpacketmodem object
+//  _num        :   number of packets
+//  _frame      :   encoded/modulated payload symbols, [size: _num*frame_len x 1]
+//  _payload    :   recovered decoded payload bytes, [size: _num*payload_len x 1]
+//  _valid      :   CRC flag of each packet, [size: _num x 1] (can be NULL)
+unsigned int qpacketmodem_decode_batch(qpacketmodem           _q,
+                                       unsigned int           _num,
+                                       liquid_float_complex * _frame,
+                                       unsigned char *        _payload,
+                                       int *                  _valid);
+
+// decode a batch of packets from modulated frame samples, returning the
+// number of packets which passed the CRC
+// NOTE: soft-decision decoding
+//  _q          :   qpacketmodem object
+//  _num        :   number of packets
+//  _frame      :   encoded/modulated payload symbols, [size: _num*frame_len x 1]
+//  _payload    :   recovered decoded payload bytes, [size: _num*payload_len x 1]
+//  _valid      :   CRC flag of each packet, [size: _num x 1] (can be NULL)
+unsigned int qpacketmodem_decode_soft_batch(qpacketmodem           _q,
+                                            unsigned int           _num,
+                                            liquid_float_complex * _frame,
+                                            unsigned char *        _payload,
+                                            int *                  _valid);
+
 //
 // pilot generator for streaming applications
 //
@@ -3832,6 +4001,17 @@ void framesync64_execute(framesync64            _q,
                          liquid_float_complex * _x,
                          unsigned int           _n);
 
+// set energy gate which skips preamble correlation on an idle channel
+//  _q          :   frame synchronizer object
+//  _pmiss      :   bound on probability of missing preamble at _snr_min (0: disable)
+//  _snr_min    :   minimum signal-to-noise ratio of preamble [dB]
+void framesync64_set_seek_gate(framesync64 _q,
+                               float       _pmiss,
+                               float       _snr_min);
+
+// get number of windows rejected by energy gate while seeking preamble
+unsigned int framesync64_get_seek_num_gated(framesync64 _q);
+
 // enable/disable debugging
 void framesync64_debug_enable(framesync64 _q);
 void framesync64_debug_disable(framesync64 _q);
@@ -3948,6 +4128,32 @@ void flexframesync_decode_header_soft(flexframesync _q,
 void flexframesync_decode_payload_soft(flexframesync _q,
                                        int           _soft);
 
+// pre-allocate memory for payloads of up to _max_payload_len bytes with
+// any error-detection scheme, the current error-correction schemes and
+// any of those listed in _fec, so that receiving such frames does not
+// allocate memory unless the payload modulation scheme changes; the
+// decoders of asynchronous payload decoding are not reserved
+//  _q                  :   frame synchronizer object
+//  _max_payload_len    :   maximum payload length (bytes)
+//  _fec                :   error-correction schemes [size: _num_fec x 1]
+//  _num_fec            :   number of schemes (may be zero)
+void flexframesync_reserve(flexframesync      _q,
+                           unsigned int       _max_payload_len,
+                           const fec_scheme * _fec,
+                           unsigned int       _num_fec);
+
+// enable or disable asynchronous decoding of payload; received payloads
+// are decoded by a pool of worker threads while synchronization continues,
+// and callbacks are invoked in frame order from within _execute() and
+// _flush(). Without thread support payloads are decoded upon reception.
+//  _q              :   frame synchronizer object
+//  _num_workers    :   number of decoder threads (0: disable)
+void flexframesync_decode_payload_async(flexframesync _q,
+                                        unsigned int  _num_workers);
+
+// wait for all pending payloads to be decoded and invoke their callbacks
+void flexframesync_flush(flexframesync _q);
+
 // set properties for header section
 int flexframesync_set_header_props(flexframesync          _q,
                                    flexframegenprops_s * _props);
@@ -3960,10 +4166,24 @@ void flexframesync_execute(flexframesync          _q,
                            liquid_float_complex * _x,
                            unsigned int           _n);
 
+// set energy gate which skips preamble correlation on an idle channel
+//  _q          :   frame synchronizer object
+//  _pmiss      :   bound on probability of missing preamble at _snr_min (0: disable)
+//  _snr_min    :   minimum signal-to-noise ratio of preamble [dB]
+void flexframesync_set_seek_gate(flexframesync _q,
+                                 float         _pmiss,
+                                 float         _snr_min);
+
+// get number of windows rejected by energy gate while seeking preamble
+unsigned int flexframesync_get_seek_num_gated(flexframesync _q);
+
 // frame data statistics
 void             flexframesync_reset_framedatastats(flexframesync _q);
 framedatastats_s flexframesync_get_framedatastats  (flexframesync _q);
 
+// asynchronous payload decoder statistics
+framedecqstats_s flexframesync_get_framedecqstats(flexframesync _q);
+
 // enable/disable debugging
 void flexframesync_debug_enable(flexframesync _q);
 void flexframesync_debug_disable(flexframesync _q);
@@ -4101,11 +4321,19 @@ void gmskframesync_destroy(gmskframesync _q);
 void gmskframesync_print(gmskframesync _q);
 void gmskframesync_set_header_len(gmskframesync _q, unsigned int _len);
 void gmskframesync_reset(gmskframesync _q);
+void gmskframesync_reserve(gmskframesync _q, unsigned int _max_payload_len,
+                           const fec_scheme * _fec, unsigned int _num_fec);
 int  gmskframesync_is_frame_open(gmskframesync _q);
 void gmskframesync_execute(gmskframesync _q,
                            liquid_float_complex * _x,
                            unsigned int _n);
 
+// enable/disable asynchronous payload decoding (see flexframesync)
+void gmskframesync_decode_payload_async(gmskframesync _q,
+                                        unsigned int  _num_workers);
+void gmskframesync_flush(gmskframesync _q);
+framedecqstats_s gmskframesync_get_framedecqstats(gmskframesync _q);
+
 // debugging
 void gmskframesync_debug_enable(gmskframesync _q);
 void gmskframesync_debug_disable(gmskframesync _q);
@@ -4190,6 +4418,15 @@ int ofdmflexframegen_write(ofdmflexframegen       _q,
                           liquid_float_complex * _buf,
                           unsigned int           _buf_len);
 
+// write OFDM symbols of assembled frame directly to output buffer; must
+// start on a symbol boundary (e.g. immediately after assembling a frame)
+//  _q              :   OFDM frame generator object
+//  _buf            :   output buffer [size: _num_symbols*(M+cp_len) x 1]
+//  _num_symbols    :   number of OFDM symbols to write
+int ofdmflexframegen_write_symbols(ofdmflexframegen       _q,
+                                   liquid_float_complex * _buf,
+                                   unsigned int           _num_symbols);
+
 // 
 // OFDM flex frame synchronizer
 //
@@ -4222,6 +4459,12 @@ void ofdmflexframesync_decode_header_soft(ofdmflexframesync _q,
 void ofdmflexframesync_decode_payload_soft(ofdmflexframesync _q,
                                            int _soft);
 
+// pre-allocate memory for payloads (see flexframesync_reserve)
+void ofdmflexframesync_reserve(ofdmflexframesync  _q,
+                               unsigned int       _max_payload_len,
+                               const fec_scheme * _fec,
+                               unsigned int       _num_fec);
+
 void ofdmflexframesync_set_header_props(ofdmflexframesync _q,
                                         ofdmflexframegenprops_s * _props);
 
@@ -4231,6 +4474,12 @@ void ofdmflexframesync_execute(ofdmflexframesync _q,
                                liquid_float_complex * _x,
                                unsigned int _n);
 
+// enable/disable asynchronous payload decoding (see flexframesync)
+void ofdmflexframesync_decode_payload_async(ofdmflexframesync _q,
+                                            unsigned int      _num_workers);
+void ofdmflexframesync_flush(ofdmflexframesync _q);
+framedecqstats_s ofdmflexframesync_get_framedecqstats(ofdmflexframesync _q);
+
 // query the received signal strength indication
 float ofdmflexframesync_get_rssi(ofdmflexframesync _q);
 
@@ -4392,6 +4641,17 @@ void qdetector_cccf_reset  (qdetector_cccf _q);
 void * qdetector_cccf_execute(qdetector_cccf       _q,
                               liquid_float_complex _x);
 
+// run detector on block of samples, stopping as soon as sequence is
+// detected; returns pointer to aligned, buffered samples (or NULL)
+//  _q          :   detector object
+//  _x          :   input samples [size: _n x 1]
+//  _n          :   number of input samples
+//  _num_read   :   number of samples consumed from input
+void * qdetector_cccf_execute_block(qdetector_cccf         _q,
+                                    liquid_float_complex * _x,
+                                    unsigned int           _n,
+                                    unsigned int *         _num_read);
+
 // set detection threshold (should be between 0 and 1, good starting point is 0.5)
 void qdetector_cccf_set_threshold(qdetector_cccf _q,
                                   float          _threshold);
@@ -4400,6 +4660,24 @@ void qdetector_cccf_set_threshold(qdetector_cccf _q,
 void qdetector_cccf_set_range(qdetector_cccf _q,
                               float          _dphi_max);
 
+// set energy gate, skipping correlation of buffers whose power is too close
+// to the estimated noise floor to contain the sequence
+//  _q          :   detector object
+//  _pmiss      :   bound on probability of rejecting a buffer containing
+//                  the sequence at the minimum SNR (0: disable)
+//  _snr_min    :   minimum signal-to-noise ratio of sequence [dB]
+void qdetector_cccf_set_gate(qdetector_cccf _q,
+                             float          _pmiss,
+                             float          _snr_min);
+
+// set carrier offset coarse search step (subcarriers); values greater
+// than one search a coarse grid first and refine around its peak. The
+// step is reduced if half a step off the true offset would lose more than
+// half of the correlation amplitude (limit of 2 to 4 depending on the
+// sequence length)
+void qdetector_cccf_set_coarse_step(qdetector_cccf _q,
+                                    unsigned int   _step);
+
 // access methods
 unsigned int qdetector_cccf_get_seq_len (qdetector_cccf _q); // sequence length
 const void * qdetector_cccf_get_sequence(qdetector_cccf _q); // pointer to sequence
@@ -4408,6 +4686,87 @@ float        qdetector_cccf_get_tau     (qdetector_cccf _q); // fractional timin
 float        qdetector_cccf_get_gamma   (qdetector_cccf _q); // channel gain
 float        qdetector_cccf_get_dphi    (qdetector_cccf _q); // carrier frequency offset estimate
 float        qdetector_cccf_get_phi     (qdetector_cccf _q); // carrier phase offset estimate
+unsigned int qdetector_cccf_get_num_transforms(qdetector_cccf _q); // number of windows searched
+unsigned int qdetector_cccf_get_num_gated     (qdetector_cccf _q); // number of windows rejected by energy gate
+
+//
+// Frame detector bank: shares preamble correlation of one input stream
+// among many templates and receivers
+//
+
+// detection estimates passed to receivers
+typedef struct {
+    unsigned int id;        // template identifier
+    float        tau;       // fractional timing offset estimate
+    float        gamma;     // channel gain estimate
+    float        dphi;      // carrier frequency offset estimate
+    float        phi;       // carrier phase offset estimate
+} qdetectorbank_detection_s;
+
+// detector bank receiver callback; invoked with aligned samples (starting
+// at the detected sequence) and estimates upon detection, and with
+// subsequent stream samples (_detection set to NULL) for as long as the
+// callback returns a non-zero value
+//  _x          :   samples [size: _n x 1]
+//  _n          :   number of samples
+//  _detection  :   detection estimates (NULL for subsequent stream samples)
+//  _userdata   :   user-defined data pointer
+typedef int (*qdetectorbank_callback)(liquid_float_complex *      _x,
+                                      unsigned int                _n,
+                                      qdetectorbank_detection_s * _detection,
+                                      void *                      _userdata);
+
+typedef struct qdetectorbank_cccf_s * qdetectorbank_cccf;
+
+// create empty detector bank
+qdetectorbank_cccf qdetectorbank_cccf_create();
+void qdetectorbank_cccf_destroy(qdetectorbank_cccf _q);
+void qdetectorbank_cccf_print  (qdetectorbank_cccf _q);
+void qdetectorbank_cccf_reset  (qdetectorbank_cccf _q);
+
+// add template to bank, returning its identifier; templates identical to
+// one already in the bank share its identifier (and its correlation)
+//  _q      :   detector bank
+//  _s      :   sample sequence
+//  _s_len  :   length of sample sequence
+unsigned int qdetectorbank_cccf_add_template(qdetectorbank_cccf     _q,
+                                             liquid_float_complex * _s,
+                                             unsigned int           _s_len);
+
+// register receiver with template
+//  _q          :   detector bank
+//  _id         :   template identifier
+//  _callback   :   dispatch callback
+//  _userdata   :   user-defined data pointer passed to callback
+void qdetectorbank_cccf_add_receiver(qdetectorbank_cccf     _q,
+                                     unsigned int           _id,
+                                     qdetectorbank_callback _callback,
+                                     void *                 _userdata);
+
+// set detection threshold and carrier offset search range for all templates
+void qdetectorbank_cccf_set_threshold(qdetectorbank_cccf _q,
+                                      float              _threshold);
+void qdetectorbank_cccf_set_range(qdetectorbank_cccf _q,
+                                  float              _dphi_max);
+
+// run detector bank on block of samples
+//  _q      :   detector bank
+//  _x      :   input samples [size: _n x 1]
+//  _n      :   number of input samples
+void qdetectorbank_cccf_execute(qdetectorbank_cccf     _q,
+                                liquid_float_complex * _x,
+                                unsigned int           _n);
+
+// access methods
+unsigned int qdetectorbank_cccf_get_num_templates (qdetectorbank_cccf _q);
+unsigned int qdetectorbank_cccf_get_num_detections(qdetectorbank_cccf _q);
+
+// attach frame synchronizer to detector bank as receiver; synchronizers
+// with the same preamble share a single correlation in the bank
+void framesync64_attach_qdetectorbank  (framesync64        _q,
+                                        qdetectorbank_cccf _bank);
+void flexframesync_attach_qdetectorbank(flexframesync      _q,
+                                        qdetectorbank_cccf _bank);
 
 //
 // Pre-demodulation detector
@@ -5588,6 +5947,12 @@ unsigned int MODEM(_gen_rand_sym)(MODEM() _q);                  \
 unsigned int      MODEM(_get_bps)   (MODEM() _q);               \
 modulation_scheme MODEM(_get_scheme)(MODEM() _q);               \
                                                                 \
+/* set/get soft-decision scaling relative to default; soft  */  \
+/* bits are 127 + 16*_scale*LLR clipped to [0,255], with    */  \
+/* the approximate log-likelihood ratio LLR of the scheme   */  \
+void MODEM(_set_llr_scale)(MODEM() _q, T _scale);               \
+T    MODEM(_get_llr_scale)(MODEM() _q);                         \
+                                                                \
 /* generic modulate function; simply queries modem scheme   */  \
 /* and calls appropriate subroutine                         */  \
 /*  _q  :   modem object                                    */  \
@@ -5615,14 +5980,56 @@ void MODEM(_demodulate_soft)(MODEM()         _q,                \
                              unsigned int  * _s,                \
                              unsigned char * _soft_bits);       \
                                                                 \
-/* get demodulator's estimated transmit sample */               \
+/* modulate block of symbols (demodulator state, phase      */  \
+/* error and EVM are not affected)                          */  \
+/*  _q  :   modem object                                    */  \
+/*  _s  :   input symbols [size: _n x 1]                    */  \
+/*  _n  :   number of symbols                               */  \
+/*  _y  :   output samples [size: _n x 1]                   */  \
+void MODEM(_modulate_block)(MODEM()               _q,           \
+                            const unsigned char * _s,           \
+                            unsigned int          _n,           \
+                            TC *                  _y);          \
+                                                                \
+/* hard-decision demodulation of block of samples; the      */  \
+/* demodulator sample, phase error and EVM are only kept    */  \
+/* for the last sample of the block                         */  \
+/*  _q  :   modem object                                    */  \
+/*  _x  :   input samples [size: _n x 1]                    */  \
+/*  _n  :   number of samples                               */  \
+/*  _s  :   output symbols [size: _n x 1]                   */  \
+void MODEM(_demodulate_block)(MODEM()         _q,               \
+                              const TC *      _x,               \
+                              unsigned int    _n,               \
+                              unsigned char * _s);              \
+                                                                \
+/* soft-decision demodulation of block of samples; the      */  \
+/* demodulator sample, phase error and EVM are only kept    */  \
+/* for the last sample of the block                         */  \
+/*  _q          :   modem object                            */  \
+/*  _x          :   input samples [size: _n x 1]            */  \
+/*  _n          :   number of samples                       */  \
+/*  _s          :   output hard symbols [size: _n x 1]      */  \
+/*  _soft_bits  :   output soft bits [size: _n*bps x 1]     */  \
+void MODEM(_demodulate_soft_block)(MODEM()         _q,          \
+                                   const TC *      _x,          \
+                                   unsigned int    _n,          \
+                                   unsigned char * _s,          \
+                                   unsigned char * _soft_bits); \
+                                                                \
+/* get demodulator's estimated transmit sample              */  \
+/* (of last sample after a block demodulation call)         */  \
 void MODEM(_get_demodulator_sample)(MODEM() _q,                 \
                                     TC *    _x_hat);            \
                                                                 \
-/* get demodulator phase error */                               \
+/* get demodulator phase error; after a _demodulate_block() */  \
+/* or _demodulate_soft_block() call this refers to the      */  \
+/* last sample of the block only (demodulate sample by      */  \
+/* sample for the phase error of every symbol)              */  \
 float MODEM(_get_demodulator_phase_error)(MODEM() _q);          \
                                                                 \
-/* get demodulator error vector magnitude */                    \
+/* get demodulator error vector magnitude (of last sample   */  \
+/* after a block demodulation call)                         */  \
 float MODEM(_get_demodulator_evm)(MODEM() _q);                  \
 
 // define modem APIs
@@ -5669,6 +6076,28 @@ void gmskdem_demodulate(gmskdem _q,
                         liquid_float_complex * _y,
                         unsigned int * _sym);
 
+// demodulate block of symbols
+//  _q      :   demodulator object
+//  _y      :   input samples [size: _n*k x 1]
+//  _n      :   number of symbols
+//  _sym    :   output symbols [size: _n x 1]
+void gmskdem_demodulate_block(gmskdem                _q,
+                              liquid_float_complex * _y,
+                              unsigned int           _n,
+                              unsigned int *         _sym);
+
+// demodulate block of symbols with soft-decision output
+//  _q      :   demodulator object
+//  _y      :   input samples [size: _n*k x 1]
+//  _n      :   number of symbols
+//  _sym    :   output symbols [size: _n x 1]
+//  _soft   :   output soft bits [size: _n x 1]
+void gmskdem_demodulate_soft_block(gmskdem                _q,
+                                   liquid_float_complex * _y,
+                                   unsigned int           _n,
+                                   unsigned int *         _sym,
+                                   unsigned char *        _soft);
+
 //
 // continuous phase frequency-shift keying (CP-FSK) modems
 //
@@ -5771,6 +6200,16 @@ void cpfskdem_demodulate(cpfskdem               _q,
 //  _y      :   input sample array [size: _k x 1]
 unsigned int cpfskdem_demodulate(cpfskdem               _q,
                                  liquid_float_complex * _y);
+
+// demodulate block of symbols, assuming perfect timing
+//  _q      :   continuous-phase frequency demodulator object
+//  _y      :   input sample array [size: _n*k x 1]
+//  _n      :   number of symbols
+//  _s      :   output symbols [size: _n x 1]
+void cpfskdem_demodulate_block(cpfskdem               _q,
+                               liquid_float_complex * _y,
+                               unsigned int           _n,
+                               unsigned int         * _s);
 #endif
 
 
@@ -5838,6 +6277,44 @@ unsigned int fskdem_demodulate(fskdem                 _q,
 // get demodulator frequency error
 float fskdem_get_frequency_error(fskdem _q);
 
+// Multi-tone detector: correlates a block of samples against a set of
+// tones, one DFT bin per tone
+typedef struct tonedet_s * tonedet;
+
+// create multi-tone detector
+//  _n          :   samples per block, _n > 0
+//  _num_tones  :   number of tones, _num_tones > 0
+//  _freqs      :   normalized tone frequencies [size: _num_tones x 1]
+tonedet tonedet_create(unsigned int _n,
+                       unsigned int _num_tones,
+                       float *      _freqs);
+
+// destroy multi-tone detector
+void tonedet_destroy(tonedet _q);
+
+// print multi-tone detector internals
+void tonedet_print(tonedet _q);
+
+// get block length
+unsigned int tonedet_get_length(tonedet _q);
+
+// get number of tones
+unsigned int tonedet_get_num_tones(tonedet _q);
+
+// correlate input block against each tone
+//  _q      :   multi-tone detector
+//  _x      :   input block [size: _n x 1]
+//  _X      :   correlator output for each tone [size: _num_tones x 1]
+void tonedet_execute(tonedet                _q,
+                     liquid_float_complex * _x,
+                     liquid_float_complex * _X);
+
+// find strongest tone in input block, returning its index
+//  _q      :   multi-tone detector
+//  _x      :   input block [size: _n x 1]
+unsigned int tonedet_detect(tonedet                _q,
+                            liquid_float_complex * _x);
+
 
 // 
 // Analog frequency modulator
@@ -5911,6 +6388,14 @@ void FREQDEM(_print)(FREQDEM() _q);                             \
 /* reset state                                              */  \
 void FREQDEM(_reset)(FREQDEM() _q);                             \
                                                                 \
+/* set maximum phase error of arctangent approximation; the */  \
+/* lowest-order polynomial meeting the tolerance is used    */  \
+/*  _q      :   frequency demodulator object                */  \
+/*  _tol    :   tolerance [radians], 0 for exact (default), */  \
+/*              lowest setting 5e-3                         */  \
+void FREQDEM(_set_tolerance)(FREQDEM() _q,                      \
+                             float     _tol);                   \
+                                                                \
 /* demodulate sample                                        */  \
 /*  _q      :   frequency modulator object                  */  \
 /*  _r      :   received signal r(t)                        */  \
@@ -6220,6 +6705,16 @@ void ofdmframegen_writesymbol(ofdmframegen _q,
                               liquid_float_complex * _x,
                               liquid_float_complex *_y);
 
+// write multiple data symbols directly to contiguous buffer
+//  _q              :   framing generator object
+//  _x              :   input symbols, [size: _num_symbols*_M x 1]
+//  _num_symbols    :   number of OFDM symbols to write
+//  _y              :   output samples, [size: _num_symbols*(_M+_cp_len) x 1]
+void ofdmframegen_writesymbols(ofdmframegen           _q,
+                               liquid_float_complex * _x,
+                               unsigned int           _num_symbols,
+                               liquid_float_complex * _y);
+
 // write tail
 void ofdmframegen_writetail(ofdmframegen _q,
                             liquid_float_complex * _x);
@@ -6269,11 +6764,13 @@ void ofdmframesync_debug_print(ofdmframesync _q, const char * _filename);
 //
 
 // oscillator type
-//  LIQUID_NCO  :   numerically-controlled oscillator (fast)
-//  LIQUID_VCO  :   "voltage"-controlled oscillator (precise)
+//  LIQUID_NCO          :   numerically-controlled oscillator (fast)
+//  LIQUID_VCO          :   "voltage"-controlled oscillator (precise)
+//  LIQUID_NCO_INTERP   :   nco with interpolated quarter-wave table
 typedef enum {
     LIQUID_NCO=0,
-    LIQUID_VCO
+    LIQUID_VCO,
+    LIQUID_NCO_INTERP
 } liquid_ncotype;
 
 #define LIQUID_NCO_MANGLE_FLOAT(name) LIQUID_CONCAT(nco_crcf, name)
@@ -6289,6 +6786,11 @@ NCO() NCO(_create)(liquid_ncotype _type);                       \
 void NCO(_destroy)(NCO() _q);                                   \
 void NCO(_print)(NCO() _q);                                     \
                                                                 \
+/* create LIQUID_NCO_INTERP object with quarter-wave    */      \
+/* table of length 2^_m, 2 <= _m <= 16                  */      \
+NCO() NCO(_create_interp)(unsigned int _m);                     \
+void NCO(_set_table_length)(NCO() _q, unsigned int _m);         \
+                                                                \
 /* set phase/frequency to zero, reset pll filter        */      \
 void NCO(_reset)(NCO() _q);                                     \
                                                                 \
@@ -6313,6 +6815,21 @@ void NCO(_cexpf)(NCO() _q, TC * _y);                            \
 void NCO(_pll_set_bandwidth)(NCO() _q, T _bandwidth);           \
 void NCO(_pll_step)(NCO() _q, T _dphi);                         \
                                                                 \
+/* block pll: mix block down with piecewise-linear      */      \
+/* phase, updating loop filter every _interval samples  */      \
+/* from the average phase of the _m-th power of output; */      \
+/* gains are scaled to the update rate and limited for  */      \
+/* stability, and frequency offsets must be below       */      \
+/* pi/_interval radians/sample                          */      \
+/*  _interval   :   samples per update (default: 1)     */      \
+/*  _m          :   detector order: 1, 2, 4, 8 (def: 1) */      \
+void NCO(_pll_set_interval)(NCO() _q, unsigned int _interval);  \
+void NCO(_pll_set_order)(NCO() _q, unsigned int _m);            \
+void NCO(_pll_mix_block_down)(NCO() _q,                         \
+                              TC *_x,                           \
+                              TC *_y,                           \
+                              unsigned int _N);                 \
+                                                                \
 /* Rotate input sample up by NCO angle (no stepping)    */      \
 void NCO(_mix_up)(NCO() _q, TC _x, TC *_y);                     \
                                                                 \
@@ -6343,6 +6860,140 @@ void NCO(_mix_block_down)(NCO() _q,                             \
 LIQUID_NCO_DEFINE_API(LIQUID_NCO_MANGLE_FLOAT, float, liquid_float_complex)
 
 
+// NCO bank: mixes one input stream down to many carriers at once,
+// optionally followed by a decimating filter on each carrier
+typedef struct ncobank_crcf_s * ncobank_crcf;
+
+// create nco bank
+//  _num_carriers   :   number of carriers, _num_carriers > 0
+//  _freqs          :   carrier frequencies [radians/sample] [size: _num_carriers x 1]
+ncobank_crcf ncobank_crcf_create(unsigned int _num_carriers,
+                                 float *      _freqs);
+
+// create nco bank with decimating filter on each carrier; filter and
+// decimation rate are as for firdecim_crcf_create()
+//  _num_carriers   :   number of carriers, _num_carriers > 0
+//  _freqs          :   carrier frequencies [radians/sample] [size: _num_carriers x 1]
+//  _M              :   decimation rate, _M > 0
+//  _h              :   filter coefficients [size: _h_len x 1]
+//  _h_len          :   filter length, _h_len > 0
+ncobank_crcf ncobank_crcf_create_decim(unsigned int _num_carriers,
+                                       float *      _freqs,
+                                       unsigned int _M,
+                                       float *      _h,
+                                       unsigned int _h_len);
+
+// destroy nco bank
+void ncobank_crcf_destroy(ncobank_crcf _q);
+
+// print nco bank
+void ncobank_crcf_print(ncobank_crcf _q);
+
+// reset phases to zero and clear filter buffers
+void ncobank_crcf_reset(ncobank_crcf _q);
+
+// get number of carriers
+unsigned int ncobank_crcf_get_num_carriers(ncobank_crcf _q);
+
+// get decimation rate
+unsigned int ncobank_crcf_get_decim_rate(ncobank_crcf _q);
+
+// set/get frequency [radians/sample] and phase [radians] of carrier _i
+void  ncobank_crcf_set_frequency(ncobank_crcf _q, unsigned int _i, float _f);
+float ncobank_crcf_get_frequency(ncobank_crcf _q, unsigned int _i);
+void  ncobank_crcf_set_phase(    ncobank_crcf _q, unsigned int _i, float _phi);
+float ncobank_crcf_get_phase(    ncobank_crcf _q, unsigned int _i);
+
+// mix input down to each carrier and decimate; each carrier is rotated
+// as with nco_crcf_mix_block_down()
+//  _q      :   nco bank object
+//  _x      :   input samples [size: _n*M x 1]
+//  _n      :   number of output samples per carrier
+//  _y      :   output samples, one block of _n per carrier
+//              [size: num_carriers*_n x 1]
+void ncobank_crcf_execute(ncobank_crcf           _q,
+                          liquid_float_complex * _x,
+                          unsigned int           _n,
+                          liquid_float_complex * _y);
+
+
+// Digital down-converter: mixes input down, decimates and optionally
+// removes DC offset (input) and controls gain (output) in a single pass
+typedef struct ddc_crcf_s * ddc_crcf;
+
+// create digital down-converter; filter and decimation rate are as for
+// firdecim_crcf_create()
+//  _fc     :   carrier frequency [radians/sample]
+//  _M      :   decimation rate, _M > 0
+//  _h      :   filter coefficients [size: _h_len x 1]
+//  _h_len  :   filter length, _h_len > 0
+ddc_crcf ddc_crcf_create(float        _fc,
+                         unsigned int _M,
+                         float *      _h,
+                         unsigned int _h_len);
+
+// create digital down-converter with Kaiser filter, as for
+// firdecim_crcf_create_kaiser()
+//  _fc     :   carrier frequency [radians/sample]
+//  _M      :   decimation rate, _M > 1
+//  _m      :   filter delay (output samples), _m > 0
+//  _As     :   stop-band attenuation [dB]
+ddc_crcf ddc_crcf_create_kaiser(float        _fc,
+                                unsigned int _M,
+                                unsigned int _m,
+                                float        _As);
+
+// destroy digital down-converter
+void ddc_crcf_destroy(ddc_crcf _q);
+
+// print digital down-converter
+void ddc_crcf_print(ddc_crcf _q);
+
+// reset phase, filter buffer, DC estimate and gain
+void ddc_crcf_reset(ddc_crcf _q);
+
+// get decimation rate
+unsigned int ddc_crcf_get_decim_rate(ddc_crcf _q);
+
+// set/get carrier frequency [radians/sample] and phase [radians]
+void  ddc_crcf_set_frequency(ddc_crcf _q, float _fc);
+float ddc_crcf_get_frequency(ddc_crcf _q);
+void  ddc_crcf_set_phase(    ddc_crcf _q, float _phi);
+float ddc_crcf_get_phase(    ddc_crcf _q);
+
+// DC offset removal on input (disabled by default); bandwidth is as for
+// iirfilt_crcf_create_dc_blocker() (default: 1e-3)
+void ddc_crcf_dc_enable(ddc_crcf _q);
+void ddc_crcf_dc_disable(ddc_crcf _q);
+void ddc_crcf_dc_set_bandwidth(ddc_crcf _q, float _alpha);
+liquid_float_complex ddc_crcf_dc_get_offset(ddc_crcf _q);
+
+// automatic gain control on output (disabled by default); bandwidth is
+// as for agc_crcf_set_bandwidth() at the output rate
+void  ddc_crcf_agc_enable(ddc_crcf _q);
+void  ddc_crcf_agc_disable(ddc_crcf _q);
+void  ddc_crcf_agc_set_bandwidth(ddc_crcf _q, float _bt);
+float ddc_crcf_agc_get_rssi(ddc_crcf _q);
+
+// execute digital down-converter on _M input samples
+//  _q      :   digital down-converter
+//  _x      :   input samples [size: _M x 1]
+//  _y      :   output sample pointer
+void ddc_crcf_execute(ddc_crcf               _q,
+                      liquid_float_complex * _x,
+                      liquid_float_complex * _y);
+
+// execute digital down-converter on block of _n*_M input samples
+//  _q      :   digital down-converter
+//  _x      :   input samples [size: _n*_M x 1]
+//  _n      :   number of output samples
+//  _y      :   output samples [size: _n x 1]
+void ddc_crcf_execute_block(ddc_crcf               _q,
+                            liquid_float_complex * _x,
+                            unsigned int           _n,
+                            liquid_float_complex * _y);
+
+
 // nco utilities
 
 // unwrap phase of array (basic)
@@ -42,6 +42,10 @@
 #  define LIBFEC_ENABLED 1
 #endif
 
+#if defined HAVE_PTHREAD_H && defined HAVE_LIBPTHREAD
+#  define LIQUID_PTHREADS_ENABLED 1
+#endif
+
 
 //
 // Debugging macros
@@ -90,6 +94,36 @@ unsigned int crc8_generate_key(unsigned char * _msg, unsigned int _msg_len);
 unsigned int crc16_generate_key(unsigned char * _msg, unsigned int _msg_len);
 unsigned int crc24_generate_key(unsigned char * _msg, unsigned int _msg_len);
 unsigned int crc32_generate_key(unsigned char * _msg, unsigned int _msg_len);
+unsigned int checksum_update_key(unsigned int          _key,
+                                 const unsigned char * _msg,
+                                 unsigned int          _n);
+
+// slicing-by-8 tables: crcW_gentab[k][b] is the reflected key update
+// for byte b followed by k zero bytes
+extern const unsigned int crc8_gentab[8][256];
+extern const unsigned int crc16_gentab[8][256];
+extern const unsigned int crc24_gentab[8][256];
+extern const unsigned int crc32_gentab[8][256];
+
+// carry-less multiply folding constants
+extern const unsigned long long crc24_fold_gentab[4];
+extern const unsigned long long crc32_fold_gentab[4];
+
+// update reflected key one byte at a time, eight bytes at a time, or
+// with carry-less multiply folding (if supported by the processor)
+unsigned int crc_update_bytes(const unsigned int    _tab[8][256],
+                              unsigned int          _key,
+                              const unsigned char * _msg,
+                              unsigned int          _n);
+unsigned int crc_update_slice8(const unsigned int    _tab[8][256],
+                               unsigned int          _key,
+                               const unsigned char * _msg,
+                               unsigned int          _n);
+unsigned int crc_update_fold(const unsigned int       _tab[8][256],
+                             const unsigned long long _fold[4],
+                             unsigned int             _key,
+                             const unsigned char *    _msg,
+                             unsigned int             _n);
 
 
 // fec : basic object
@@ -106,7 +140,9 @@ struct fec_s {
 
     // convolutional : internal memory structure
     unsigned char * enc_bits;
+    unsigned int enc_bits_cap;  // allocated length of enc_bits
     void * vp;      // decoder object
+    struct fec_viterbi_s * viterbi; // native decoder object (without libfec)
     int * poly;     // polynomial
     unsigned int R; // primitive rate, inverted (e.g. R=3 for 1/3)
     unsigned int K; // constraint length
@@ -132,6 +168,7 @@ struct fec_s {
     int nn;         // 2^symsize - 1
     int kk;         // nn - nroots
     void * rs;      // Reed-Solomon internal object
+    struct fec_rscodec_s * rscodec; // native codec object (without libfec)
 
     // Reed-Solomon decoder
     unsigned int num_blocks;    // number of blocks: ceil(dec_msg_len / nn)
@@ -140,10 +177,27 @@ struct fec_s {
     unsigned int res_block_len; // residual bytes in last block
     unsigned int pad;           // padding for each block
     unsigned char * tblock;     // decoder input sequence [size: 1 x n]
+    unsigned int tblock_cap;    // allocated length of tblock
     int * errlocs;              // error locations [size: 1 x n]
     int * derrlocs;             // decoded error locations [size: 1 x n]
     int erasures;               // number of erasures
 
+    // LDPC (blocks are partitioned as with Reed-Solomon codes)
+    struct fec_minsum_s * ldpc; // min-sum decoder object
+    const short int * ldpc_base;// base matrix of circulant shifts
+    unsigned int ldpc_Z;        // circulant size
+    unsigned int ldpc_mb;       // base matrix rows (parity blocks)
+    unsigned int ldpc_nb;       // base matrix columns
+    unsigned char * ldpc_bits;  // code word bits [size: ldpc_nb*ldpc_Z x 1]
+    short int * ldpc_llr;       // code word LLRs [size: ldpc_nb*ldpc_Z x 1]
+
+    // polar (blocks are partitioned as with Reed-Solomon codes)
+    struct fec_polarcode_s * polar; // code for current block length
+    unsigned int polar_num;     // rate numerator
+    unsigned int polar_den;     // rate denominator
+    short int * polar_llr;      // code word LLRs [size: 8*enc_block_len x 1]
+    unsigned char * polar_buf;  // block data [size: dec_block_len x 1]
+
     // encode function pointer
     void (*encode_func)(fec _q,
                         unsigned int _dec_msg_len,
@@ -167,9 +221,15 @@ struct fec_s {
 int fec_scheme_is_convolutional(fec_scheme _scheme);
 int fec_scheme_is_punctured(fec_scheme _scheme);
 int fec_scheme_is_reedsolomon(fec_scheme _scheme);
+int fec_scheme_is_ldpc(fec_scheme _scheme);
+int fec_scheme_is_polar(fec_scheme _scheme);
 int fec_scheme_is_hamming(fec_scheme _scheme);
 int fec_scheme_is_repeat(fec_scheme _scheme);
 
+// pre-allocate internal memory for messages of up to _dec_msg_len bytes
+void fec_reserve(fec          _q,
+                 unsigned int _dec_msg_len);
+
 // Pass
 fec fec_pass_create(void *_opts);
 void fec_pass_destroy(fec _q);
@@ -217,6 +277,17 @@ void fec_rep5_decode_soft(fec _q,
                           unsigned char * _msg_enc,
                           unsigned char * _msg_dec);
 
+// maximum-likelihood soft decoding of a code with 16 codewords of at
+// most 8 bits each by comparing the soft bits against all codewords
+// (expanded to 0x00/0xff bytes) at once; returns index of codeword with
+// minimum distance (lowest index on ties)
+//  _soft_bits  :   soft bits of received codeword [size: _n x 1]
+//  _n          :   codeword length, 4 <= _n <= 8
+//  _cw_bytes   :   expanded codewords, zero padded [size: 16 x 8]
+unsigned int fecsoft_ml16_decode(unsigned char       * _soft_bits,
+                                 unsigned int          _n,
+                                 const unsigned char * _cw_bytes);
+
 // Hamming(7,4)
 extern unsigned char hamming74_enc_gentab[16];
 extern unsigned char hamming74_dec_gentab[128];
@@ -264,6 +335,7 @@ unsigned char fecsoft_hamming84_decode(unsigned char * _soft_bits);
 unsigned int fec_hamming128_encode_symbol(unsigned int _sym_dec);
 unsigned int fec_hamming128_decode_symbol(unsigned int _sym_enc);
 extern unsigned short int hamming128_enc_gentab[256];   // encoding table
+extern const unsigned char hamming128_dec_gentab[4096]; // decoding table
 
 fec fec_hamming128_create(void *_opts);
 void fec_hamming128_destroy(fec _q);
@@ -282,8 +354,6 @@ void fec_hamming128_decode_soft(fec _q,
                                 unsigned char * _msg_dec);
 // soft decoding of one symbol
 unsigned int fecsoft_hamming128_decode(unsigned char * _soft_bits);
-extern unsigned char fecsoft_hamming128_n3[256][17];
-unsigned int fecsoft_hamming128_decode_n3(unsigned char * _soft_bits);
 
 
 // Hamming(15,11)
@@ -303,6 +373,11 @@ extern unsigned int golay2412_P[12];
 extern unsigned int golay2412_Gt[24];
 extern unsigned int golay2412_H[12];
 
+// look-up tables for encoding, syndrome and error correction
+extern const unsigned int       golay2412_enc_gentab[2][64];
+extern const unsigned short int golay2412_syndrome_gentab[3][256];
+extern const unsigned short int golay2412_dec_gentab[4096];
+
 // multiply input vector with matrix
 unsigned int golay2412_matrix_mul(unsigned int   _v,
                                   unsigned int * _A,
@@ -355,6 +430,10 @@ extern unsigned char secded2216_P[12];
 // syndrome vectors of errors with weight exactly equal to 1
 extern unsigned char secded2216_syndrome_w1[22];
 
+// look-up tables for parity and single-error location
+extern const unsigned char secded2216_parity_gentab[2][256];
+extern const unsigned char secded2216_ehat_gentab[64];
+
 fec fec_secded2216_create(void *_opts);
 void fec_secded2216_destroy(fec _q);
 void fec_secded2216_print(fec _q);
@@ -399,6 +478,10 @@ extern unsigned char secded3932_P[28];
 // syndrome vectors of errors with weight exactly equal to 1
 extern unsigned char secded3932_syndrome_w1[39];
 
+// look-up tables for parity and single-error location
+extern const unsigned char secded3932_parity_gentab[4][256];
+extern const unsigned char secded3932_ehat_gentab[128];
+
 fec fec_secded3932_create(void *_opts);
 void fec_secded3932_destroy(fec _q);
 void fec_secded3932_print(fec _q);
@@ -440,6 +523,10 @@ int fec_secded7264_decode_symbol(unsigned char * _sym_enc,
 extern unsigned char secded7264_P[64];
 extern unsigned char secded7264_syndrome_w1[72];
 
+// look-up tables for parity and single-error location
+extern const unsigned char secded7264_parity_gentab[8][256];
+extern const unsigned char secded7264_ehat_gentab[256];
+
 fec fec_secded7264_create(void *_opts);
 void fec_secded7264_destroy(fec _q);
 void fec_secded7264_print(fec _q);
@@ -515,6 +602,33 @@ void fec_conv_decode(fec _q,
 void fec_conv_setlength(fec _q,
                         unsigned int _dec_msg_len);
 
+// native soft-decision Viterbi decoder, used when libfec is unavailable
+typedef struct fec_viterbi_s * fec_viterbi;
+
+// create Viterbi decoder object for rate 1/_R code
+//  _K          :   constraint length, 6 <= _K <= 16
+//  _R          :   number of generator polynomials
+//  _poly       :   generator polynomials, first and last taps set [size: _R x 1]
+//  _P          :   puncturing period (1 for none)
+//  _pmatrix    :   puncturing matrix, NULL for none [size: _R x _P]
+fec_viterbi fec_viterbi_create(unsigned int _K,
+                               unsigned int _R,
+                               int *        _poly,
+                               unsigned int _P,
+                               int *        _pmatrix);
+void fec_viterbi_destroy(fec_viterbi _q);
+
+// decode block terminated with _K-1 zero-valued tail bits, returning
+// the number of soft bits consumed
+//  _q          :   decoder object
+//  _sym        :   soft bits, punctured symbols omitted
+//  _n          :   number of decoded bits (excluding tail)
+//  _msg_dec    :   decoded message [size: ceil(_n/8) x 1]
+unsigned int fec_viterbi_decode(fec_viterbi     _q,
+                                unsigned char * _sym,
+                                unsigned int    _n,
+                                unsigned char * _msg_dec);
+
 // internal initialization methods (sets r, K, viterbi methods)
 void fec_conv_init_v27(fec _q);
 void fec_conv_init_v29(fec _q);
@@ -583,6 +697,113 @@ void fec_rs_decode(fec _q,
                    unsigned char * _msg_enc,
                    unsigned char * _msg_dec);
 
+// quasi-cyclic LDPC codes
+fec fec_ldpc_create(fec_scheme _fs);
+void fec_ldpc_destroy(fec _q);
+void fec_ldpc_setlength(fec _q,
+                        unsigned int _dec_msg_len);
+void fec_ldpc_encode(fec _q,
+                     unsigned int _dec_msg_len,
+                     unsigned char * _msg_dec,
+                     unsigned char * _msg_enc);
+void fec_ldpc_decode(fec _q,
+                     unsigned int _dec_msg_len,
+                     unsigned char * _msg_enc,
+                     unsigned char * _msg_dec);
+void fec_ldpc_decode_soft(fec _q,
+                          unsigned int _dec_msg_len,
+                          unsigned char * _msg_enc,
+                          unsigned char * _msg_dec);
+
+// compute encoded message length for LDPC codes
+//  _dec_msg_len    :   decoded message length (bytes)
+//  _k              :   data bytes per full-length code word
+//  _p              :   parity bytes per code word
+unsigned int fec_ldpc_get_enc_msg_len(unsigned int _dec_msg_len,
+                                      unsigned int _k,
+                                      unsigned int _p);
+
+// CRC-aided polar codes
+fec fec_polar_create(fec_scheme _fs);
+void fec_polar_destroy(fec _q);
+void fec_polar_setlength(fec _q,
+                         unsigned int _dec_msg_len);
+void fec_polar_encode(fec _q,
+                      unsigned int _dec_msg_len,
+                      unsigned char * _msg_dec,
+                      unsigned char * _msg_enc);
+void fec_polar_decode(fec _q,
+                      unsigned int _dec_msg_len,
+                      unsigned char * _msg_enc,
+                      unsigned char * _msg_dec);
+void fec_polar_decode_soft(fec _q,
+                           unsigned int _dec_msg_len,
+                           unsigned char * _msg_enc,
+                           unsigned char * _msg_dec);
+
+// maximum number of data bytes per polar block for rate _num/_den
+unsigned int fec_polar_get_max_block_len(unsigned int _num,
+                                         unsigned int _den);
+
+// number of encoded bytes of a polar block of _dec_block_len data bytes
+unsigned int fec_polar_get_enc_block_len(unsigned int _dec_block_len,
+                                         unsigned int _num,
+                                         unsigned int _den);
+
+// compute encoded message length for polar codes
+//  _dec_msg_len    :   decoded message length (bytes)
+//  _num            :   rate numerator
+//  _den            :   rate denominator
+unsigned int fec_polar_get_enc_msg_len(unsigned int _dec_msg_len,
+                                       unsigned int _num,
+                                       unsigned int _den);
+
+// native Reed-Solomon codec over GF(2^8), used when libfec is unavailable
+typedef struct fec_rscodec_s * fec_rscodec;
+
+// create Reed-Solomon codec object
+//  _gfpoly     :   field generator polynomial, e.g. 0x11d
+//  _fcr        :   first consecutive root of code generator (index form)
+//  _prim       :   primitive element generating the roots (index form)
+//  _nroots     :   number of roots (parity symbols), 0 < _nroots < 255
+//  _pad        :   number of implicit leading zeros (shortened code)
+fec_rscodec fec_rscodec_create(unsigned int _gfpoly,
+                               unsigned int _fcr,
+                               unsigned int _prim,
+                               unsigned int _nroots,
+                               unsigned int _pad);
+void fec_rscodec_destroy(fec_rscodec _q);
+
+// set number of implicit leading zeros (shortened code) in place
+void fec_rscodec_set_pad(fec_rscodec  _q,
+                         unsigned int _pad);
+
+// compute parity symbols of a single block
+//  _q          :   codec object
+//  _data       :   data symbols [size: 255-_nroots-_pad x 1]
+//  _parity     :   parity symbols [size: _nroots x 1]
+void fec_rscodec_encode(fec_rscodec     _q,
+                        unsigned char * _data,
+                        unsigned char * _parity);
+
+// decode single block (data followed by parity) in place, returning the
+// number of corrected symbols or -1 if the block is uncorrectable
+int fec_rscodec_decode(fec_rscodec     _q,
+                       unsigned char * _block);
+
+// decode a batch of blocks in place, computing the syndromes of several
+// blocks at once; returns the number of uncorrectable blocks
+//  _q          :   codec object
+//  _blocks     :   blocks, each 255-_pad symbols long
+//  _num_blocks :   number of blocks
+//  _stride     :   distance between the start of each block
+//  _num_errors :   corrected symbols (or -1) per block, ignored if NULL
+unsigned int fec_rscodec_decode_batch(fec_rscodec     _q,
+                                      unsigned char * _blocks,
+                                      unsigned int    _num_blocks,
+                                      unsigned int    _stride,
+                                      int *           _num_errors);
+
 // phi(x) = -logf( tanhf( x/2 ) )
 float sumproduct_phi(float _x);
 
@@ -602,31 +823,122 @@ int fec_sumproduct(unsigned int    _m,
                    unsigned int    _max_steps);
 
 // sum-product algorithm, returns 1 if parity checks, 0 otherwise
-//  _m      :   rows
-//  _n      :   cols
-//  _H      :   sparse binary parity check matrix [size: _m x _n]
-//  _c_hat  :   estimated transmitted signal [size: _n x 1]
+//  _m          :   rows
+//  _n          :   cols
+//  _row_ptr    :   start of each row's edges in _col_idx [size: _m+1 x 1]
+//  _col_idx    :   column of each non-zero entry of H
+//  _c_hat      :   estimated transmitted signal [size: _n x 1]
 //
 // internal state arrays
-//  _Lq     :   [size: _m x _n]
-//  _Lr     :   [size: _m x _n]
+//  _Lq     :   variable-to-check messages [size: num_edges x 1]
+//  _Lr     :   check-to-variable messages [size: num_edges x 1]
 //  _Lc     :   [size: _n x 1]
 //  _LQ     :   [size: _n x 1]
-//  _parity :   _H * _c_hat [size: _m x 1]
 int fec_sumproduct_step(unsigned int    _m,
                         unsigned int    _n,
-                        smatrixb        _H,
+                        unsigned int *  _row_ptr,
+                        unsigned int *  _col_idx,
                         unsigned char * _c_hat,
                         float *         _Lq,
                         float *         _Lr,
                         float *         _Lc,
-                        float *         _LQ,
-                        unsigned char * _parity);
+                        float *         _LQ);
+
+// layered normalized min-sum LDPC decoder over a compressed parity-check
+// matrix; quasi-cyclic codes process whole base rows in vector lanes
+typedef struct fec_minsum_s * fec_minsum;
+
+// create decoder for arbitrary sparse parity-check matrix
+fec_minsum fec_minsum_create(smatrixb _H);
+
+// create decoder for quasi-cyclic code from its base matrix
+//  _Z          :   circulant size
+//  _mb         :   base matrix rows
+//  _nb         :   base matrix columns
+//  _base       :   circulant shifts, -1 for all-zero blocks [size: _mb x _nb]
+fec_minsum fec_minsum_create_qc(unsigned int      _Z,
+                                unsigned int      _mb,
+                                unsigned int      _nb,
+                                const short int * _base);
+void fec_minsum_destroy(fec_minsum _q);
+
+// get number of code bits, number of iterations run by last decode
+unsigned int fec_minsum_get_n(fec_minsum _q);
+unsigned int fec_minsum_get_num_iterations(fec_minsum _q);
+
+// decode block, stopping early once all parity checks are satisfied;
+// returns 1 if parity checks, 0 otherwise
+//  _q              :   decoder object
+//  _llr            :   channel LLRs, positive favoring 0 [size: n x 1]
+//  _max_iterations :   maximum number of iterations
+//  _c_hat          :   decoded code word bits [size: n x 1]
+int fec_minsum_decode(fec_minsum      _q,
+                      short int *     _llr,
+                      unsigned int    _max_iterations,
+                      unsigned char * _c_hat);
+
+// decode block with the generic row-by-row schedule, ignoring any
+// quasi-cyclic structure (same result, used for testing)
+int fec_minsum_decode_csr(fec_minsum      _q,
+                          short int *     _llr,
+                          unsigned int    _max_iterations,
+                          unsigned char * _c_hat);
+
+// CRC-aided polar code with fast simplified successive-cancellation list
+// decoder (rate-0, rate-1, repetition and single parity-check nodes)
+typedef struct fec_polarcode_s * fec_polarcode;
+
+// create polar code
+//  _E          :   number of code bits, 8 <= _E <= 1024, _E%8 == 0
+//  _k          :   number of data bits, _k%8 == 0
+//  _crc        :   CRC appended to data and used for path selection
+//  _list_size  :   decoder list size, 0 < _list_size <= 32
+fec_polarcode fec_polarcode_create(unsigned int _E,
+                                   unsigned int _k,
+                                   crc_scheme   _crc,
+                                   unsigned int _list_size);
+void fec_polarcode_destroy(fec_polarcode _q);
+
+// re-construct code in place for new lengths; the mother code length
+// of _E may not exceed that of the length given at creation
+void fec_polarcode_set_length(fec_polarcode _q,
+                              unsigned int  _E,
+                              unsigned int  _k);
+
+// get number of code bits, information bits (data and CRC)
+unsigned int fec_polarcode_get_n(fec_polarcode _q);
+unsigned int fec_polarcode_get_k(fec_polarcode _q);
+
+// encode data bytes, appending CRC
+//  _q      :   polar code
+//  _msg    :   data bytes [size: _k/8 x 1]
+//  _enc    :   code bytes [size: _E/8 x 1]
+void fec_polarcode_encode(fec_polarcode         _q,
+                          const unsigned char * _msg,
+                          unsigned char *       _enc);
+
+// decode data bytes; returns 1 if CRC of selected path checks, 0 otherwise
+//  _q      :   polar code
+//  _llr    :   channel LLRs, positive favoring 0 [size: _E x 1]
+//  _msg    :   decoded data bytes [size: _k/8 x 1]
+int fec_polarcode_decode(fec_polarcode     _q,
+                         const short int * _llr,
+                         unsigned char *   _msg);
 
 //
 // packetizer
 //
 
+// get the longest encoded message memory has been reserved for
+unsigned int packetizer_get_max_enc_msg_len(packetizer _p);
+
+// get the fec schemes for which objects exist in any stage, returning
+// their number
+//  _p      :   packetizer object
+//  _fec    :   output schemes [size: LIQUID_FEC_NUM_SCHEMES x 1]
+unsigned int packetizer_get_fec_pool(packetizer   _p,
+                                     fec_scheme * _fec);
+
 // fec/interleaver plan
 struct fecintlv_plan {
     unsigned int dec_msg_len;
@@ -636,6 +948,10 @@ struct fecintlv_plan {
     fec_scheme fs;
     fec f;
 
+    // fec codecs created so far, indexed by scheme (f is one of these);
+    // kept so that switching schemes back and forth does not allocate
+    fec fec_pool[LIQUID_FEC_NUM_SCHEMES];
+
     // interleaver
     interleaver q;
 };
@@ -653,10 +969,21 @@ struct packetizer_s {
     struct fecintlv_plan * plan;
     unsigned int plan_len;
 
-    // buffers (ping-pong)
+    // buffers (ping-pong), each holding soft bits for batch_len packets;
+    // allocated for 8*buffer_len bytes and only ever grown
     unsigned int buffer_len;
     unsigned char * buffer_0;
     unsigned char * buffer_1;
+
+    // largest message and encoded packet lengths memory has been
+    // reserved for
+    unsigned int max_msg_len;
+    unsigned int max_packet_len;
+
+    // batch processing
+    unsigned int batch_len;     // number of packets per pass of each stage
+    unsigned int num_threads;   // number of threads for batch processing
+    packetizer * workers;       // packetizers for additional threads
 };
 
 
@@ -1082,6 +1409,129 @@ void bpacketsync_decode_payload(bpacketsync _q);
 void bpacketsync_reconfig(bpacketsync _q);
 
 
+//
+// qpacketmodem
+//
+
+// get the longest frame (symbols) memory has been reserved for
+unsigned int qpacketmodem_get_max_frame_len(qpacketmodem _q);
+
+
+//
+// qdetector
+//
+
+// start aligning signal detected externally (e.g. by qdetectorbank_cccf)
+//  _q      :   detector object
+//  _offset :   coarse carrier offset (FFT bins of this detector)
+void qdetector_cccf_start_align(qdetector_cccf _q,
+                                int            _offset);
+
+
+//
+// framedecq : frame payload decoder queue
+//
+
+// payload decoder type
+typedef enum {
+    FRAMEDECQ_DECODER_NONE=0,       // no decoding (e.g. invalid header)
+    FRAMEDECQ_DECODER_PACKETIZER,   // packetizer on encoded (soft) bytes
+    FRAMEDECQ_DECODER_QPACKETMODEM, // qpacketmodem on received symbols
+} framedecq_decoder;
+
+// frame decoding job
+typedef struct {
+    // decoder configuration
+    framedecq_decoder decoder;      // decoder type
+    int               soft;         // soft decoding?
+    unsigned int      dec_len;      // decoded payload length (bytes)
+    crc_scheme        check;        // data validity check
+    fec_scheme        fec0;         // forward error-correction (inner)
+    fec_scheme        fec1;         // forward error-correction (outer)
+    modulation_scheme ms;           // modulation scheme (qpacketmodem only)
+
+    // received frame
+    unsigned char *   header;       // decoded header
+    unsigned int      header_len;   // decoded header length
+    int               header_valid; // header valid?
+    float complex *   syms;         // received payload symbols
+    unsigned int      num_syms;     // number of received payload symbols
+    unsigned char *   enc;          // encoded payload (packetizer only)
+    unsigned int      enc_len;      // encoded payload length
+    framesyncstats_s  stats;        // frame statistics
+
+    // decoder output
+    unsigned char *   dec;          // decoded payload [size: dec_len x 1]
+    int               valid;        // payload valid?
+
+    // internal
+    int               state;        // job state
+    double            t_submit;     // time of submission [s]
+    double            t_start;      // time decoding started [s]
+    double            t_done;       // time decoding finished [s]
+    unsigned int      header_cap;   // allocated length of header
+    unsigned int      syms_cap;     // allocated length of syms
+    unsigned int      enc_cap;      // allocated length of enc
+    unsigned int      dec_cap;      // allocated length of dec
+} framedecq_job_s;
+
+typedef struct framedecq_s * framedecq;
+
+// create frame decoder queue
+//  _num_workers    :   number of worker threads, _num_workers > 0
+//  _capacity       :   maximum number of frames in flight, _capacity > 0
+//  _callback       :   callback invoked for each decoded frame
+//  _userdata       :   user-defined data object passed to callback
+//  _framedatastats :   payload statistics updated on delivery (can be NULL)
+framedecq framedecq_create(unsigned int       _num_workers,
+                           unsigned int       _capacity,
+                           framesync_callback _callback,
+                           void *             _userdata,
+                           framedatastats_s * _framedatastats);
+
+// destroy frame decoder queue, discarding undelivered frames
+void framedecq_destroy(framedecq _q);
+
+// get free job slot at end of queue; if the queue is full this waits for
+// the oldest frame to be decoded and delivers it
+framedecq_job_s * framedecq_get_slot(framedecq _q);
+
+// copy frame data into job
+void framedecq_job_set_header(framedecq_job_s * _job,
+                              unsigned char *   _header,
+                              unsigned int      _header_len,
+                              int               _header_valid);
+void framedecq_job_set_syms(framedecq_job_s * _job,
+                            float complex *   _syms,
+                            unsigned int      _num_syms);
+void framedecq_job_set_enc(framedecq_job_s * _job,
+                           unsigned char *   _enc,
+                           unsigned int      _enc_len);
+
+// submit job at end of queue (previously retrieved from framedecq_get_slot)
+void framedecq_submit(framedecq _q);
+
+// get oldest job if it has been decoded, NULL if queue is empty or if not
+// blocking and oldest job is still being decoded
+framedecq_job_s * framedecq_head(framedecq _q,
+                                 int       _block);
+
+// release oldest job (after its results have been delivered)
+void framedecq_pop(framedecq _q);
+
+// deliver decoded frames in order of submission, invoking callback
+//  _q      :   frame decoder queue
+//  _block  :   wait for pending frames to finish decoding?
+//  _max    :   maximum number of frames to deliver (0: no limit)
+unsigned int framedecq_deliver(framedecq    _q,
+                               int          _block,
+                               unsigned int _max);
+
+// reset/get queue statistics
+void             framedecq_reset_stats(framedecq _q);
+framedecqstats_s framedecq_get_stats  (framedecq _q);
+
+
 // 
 // flexframe
 //
@@ -1288,6 +1738,10 @@ MODEM() MODEM(_create_arb128opt)(void);                         \
 MODEM() MODEM(_create_arb256opt)(void);                         \
 MODEM() MODEM(_create_arb64vt)(void);                           \
                                                                 \
+/* Build nearest-symbol search grid and soft-demodulation */   \
+/* neighbors of arbitrary modem constellation             */   \
+void MODEM(_arb_init_index)(MODEM() _q);                        \
+                                                                \
 /* Scale arbitrary modem energy to unity */                     \
 void MODEM(_arb_scale)(MODEM() _q);                             \
                                                                 \
@@ -1338,6 +1792,77 @@ void MODEM(_demodulate_soft_arb)( MODEM()         _q,           \
                                   TC              _x,           \
                                   unsigned int *  _sym_out,     \
                                   unsigned char * _soft_bits);  \
+void MODEM(_demodulate_soft_qam)( MODEM()         _q,           \
+                                  TC              _x,           \
+                                  unsigned int *  _sym_out,     \
+                                  unsigned char * _soft_bits);  \
+void MODEM(_demodulate_soft_sqam32)(MODEM()         _q,         \
+                                    TC              _x,         \
+                                    unsigned int *  _sym_out,   \
+                                    unsigned char * _soft_bits);\
+void MODEM(_demodulate_soft_sqam128)(MODEM()         _q,        \
+                                     TC              _x,        \
+                                     unsigned int *  _sym_out,  \
+                                     unsigned char * _soft_bits);\
+                                                                \
+/* soft bits of Gray-coded amplitude levels on one axis     */  \
+/* (simplified max-log likelihood ratios)                   */  \
+/*  _v          :   input value                             */  \
+/*  _m          :   bits per axis                           */  \
+/*  _ref        :   array of thresholds                     */  \
+/*  _c          :   soft-bit scaling                        */  \
+/*  _soft_bits  :   soft bit output [size: _m x 1]          */  \
+void MODEM(_demodulate_soft_pam)(T               _v,            \
+                                 unsigned int    _m,            \
+                                 T *             _ref,          \
+                                 T               _c,            \
+                                 unsigned char * _soft_bits);   \
+                                                                \
+/* soft bits of 'square' QAM from sub-map of first quadrant */  \
+void MODEM(_demodulate_soft_sqam)(MODEM()         _q,           \
+                                  TC              _x,           \
+                                  unsigned int    _s,           \
+                                  TC *            _map,         \
+                                  unsigned char * _soft_bits);  \
+                                                                \
+/* block demodulate routines */                                 \
+void MODEM(_demodulate_block_qam)(MODEM()         _q,           \
+                                  const TC *      _x,           \
+                                  unsigned int    _n,           \
+                                  unsigned char * _s);          \
+void MODEM(_demodulate_block_psk)(MODEM()         _q,           \
+                                  const TC *      _x,           \
+                                  unsigned int    _n,           \
+                                  unsigned char * _s);          \
+void MODEM(_demodulate_block_apsk)(MODEM()         _q,          \
+                                   const TC *      _x,          \
+                                   unsigned int    _n,          \
+                                   unsigned char * _s);         \
+void MODEM(_demodulate_soft_block_bpsk)(MODEM()         _q,     \
+                                        const TC *      _x,     \
+                                        unsigned int    _n,     \
+                                        unsigned char * _s,     \
+                                        unsigned char * _soft); \
+void MODEM(_demodulate_soft_block_qpsk)(MODEM()         _q,     \
+                                        const TC *      _x,     \
+                                        unsigned int    _n,     \
+                                        unsigned char * _s,     \
+                                        unsigned char * _soft); \
+void MODEM(_demodulate_soft_block_qam)(MODEM()         _q,      \
+                                       const TC *      _x,      \
+                                       unsigned int    _n,      \
+                                       unsigned char * _soft);  \
+                                                                \
+/* four-quadrant arctangent from polynomial approximation   */  \
+/* (|error| < 1e-5 radians), shared by block demodulators   */  \
+T MODEM(_atan2)(T _y, T _x);                                    \
+                                                                \
+/* four-quadrant arctangent from odd polynomial on [0,1],   */  \
+/* a*(c[0] + c[1]*a^2 + ... + c[n-1]*a^(2n-2))              */  \
+T MODEM(_atan2_poly)(T            _y,                           \
+                     T            _x,                           \
+                     const T *    _c,                           \
+                     unsigned int _n);                          \
                                                                 \
 /* generate soft demodulation look-up table */                  \
 void MODEM(_demodsoft_gentab)(MODEM()      _q,                  \
@@ -1350,6 +1875,14 @@ void MODEM(_demodulate_soft_table)(MODEM()         _q,          \
                                    unsigned int *  _sym_out,    \
                                    unsigned char * _soft_bits); \
                                                                 \
+/* soft bits from nearest-neighbors look-up table given the */  \
+/* hard decision _s and its re-modulated sample _x_hat      */  \
+void MODEM(_demodulate_soft_table_llr)(MODEM()         _q,      \
+                                       TC              _r,      \
+                                       unsigned int    _s,      \
+                                       TC              _x_hat,  \
+                                       unsigned char * _soft);  \
+                                                                \
 /* Demodulate a linear symbol constellation using dynamic   */  \
 /* threshold calculation                                    */  \
 /*  _v      :   input value             */                      \
@@ -1455,6 +1988,11 @@ void ofdmframe_init_S1(unsigned char * _p,
 void ofdmframegen_gensymbol(ofdmframegen    _q,
                             float complex * _buffer);
 
+// generate symbol (add cyclic prefix) and overlap with external post-fix
+void ofdmframegen_gensymbol_overlap(ofdmframegen    _q,
+                                    float complex * _postfix,
+                                    float complex * _buffer);
+
 void ofdmframesync_cpcorrelate(ofdmframesync _q);
 void ofdmframesync_findrxypeak(ofdmframesync _q);
 void ofdmframesync_rxpayload(ofdmframesync _q);
@@ -1505,16 +2043,31 @@ void ofdmframesync_rxsymbol(ofdmframesync _q);
 //
 
 
-// Numerically-controlled oscillator, floating point phase precision
+// Numerically-controlled oscillator, fixed-point phase accumulator
 #define LIQUID_NCO_DEFINE_INTERNAL_API(NCO,T,TC)                \
                                                                 \
-/* constrain phase/frequency to be in [-pi,pi)          */      \
-void NCO(_constrain_phase)(NCO() _q);                           \
-void NCO(_constrain_frequency)(NCO() _q);                       \
+/* convert phase/frequency between radians and fixed-   */      \
+/* point (2^32 = 2 pi); radians are in [-pi,pi)         */      \
+uint32_t NCO(_constrain)(T _theta);                             \
+T NCO(_fixed_to_float)(uint32_t _theta);                        \
                                                                 \
 /* compute trigonometric functions for nco/vco type     */      \
 void NCO(_compute_sincos_nco)(NCO() _q);                        \
 void NCO(_compute_sincos_vco)(NCO() _q);                        \
+void NCO(_compute_sincos_interp)(NCO() _q);                     \
+                                                                \
+/* sin, cos of arbitrary fixed-point phase (no state)   */      \
+void NCO(_sincos_fixed)(NCO()    _q,                            \
+                        uint32_t _theta,                        \
+                        T *      _s,                            \
+                        T *      _c);                           \
+                                                                \
+/* rotate input array up (_down=0) or down, stepping    */      \
+void NCO(_mix_block)(NCO()        _q,                           \
+                     TC *         _x,                           \
+                     TC *         _y,                           \
+                     unsigned int _n,                           \
+                     int          _down);                       \
                                                                 \
 /* reset internal phase-locked loop filter              */      \
 void NCO(_pll_reset)(NCO() _q);                                 \
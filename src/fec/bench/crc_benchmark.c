@@ -76,3 +76,8 @@ void benchmark_crc_crc16_n256       CRC_BENCH_API(LIQUID_CRC_16,        256)
 void benchmark_crc_crc24_n256       CRC_BENCH_API(LIQUID_CRC_24,        256)
 void benchmark_crc_crc32_n256       CRC_BENCH_API(LIQUID_CRC_32,        256)
 
+
+void benchmark_crc_crc8_n1024       CRC_BENCH_API(LIQUID_CRC_8,         1024)
+void benchmark_crc_crc16_n1024      CRC_BENCH_API(LIQUID_CRC_16,        1024)
+void benchmark_crc_crc24_n1024      CRC_BENCH_API(LIQUID_CRC_24,        1024)
+void benchmark_crc_crc32_n1024      CRC_BENCH_API(LIQUID_CRC_32,        1024)
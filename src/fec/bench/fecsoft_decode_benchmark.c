@@ -48,32 +48,6 @@ void fecsoft_decode_bench(
     unsigned int _n,
     void * _opts)
 {
-#if !LIBFEC_ENABLED
-    if ( _fs == LIQUID_FEC_CONV_V27    ||
-         _fs == LIQUID_FEC_CONV_V29    ||
-         _fs == LIQUID_FEC_CONV_V39    ||
-         _fs == LIQUID_FEC_CONV_V615   ||
-         _fs == LIQUID_FEC_CONV_V27P23 ||
-         _fs == LIQUID_FEC_CONV_V27P34 ||
-         _fs == LIQUID_FEC_CONV_V27P45 ||
-         _fs == LIQUID_FEC_CONV_V27P56 ||
-         _fs == LIQUID_FEC_CONV_V27P67 ||
-         _fs == LIQUID_FEC_CONV_V27P78 ||
-         _fs == LIQUID_FEC_CONV_V29P23 ||
-         _fs == LIQUID_FEC_CONV_V29P34 ||
-         _fs == LIQUID_FEC_CONV_V29P45 ||
-         _fs == LIQUID_FEC_CONV_V29P56 ||
-         _fs == LIQUID_FEC_CONV_V29P67 ||
-         _fs == LIQUID_FEC_CONV_V29P78 ||
-         _fs == LIQUID_FEC_RS_M8)
-    {
-        fprintf(stderr,"warning: convolutional, Reed-Solomon codes unavailable (install libfec)\n");
-        getrusage(RUSAGE_SELF, _start);
-        memmove((void*)_finish,(void*)_start,sizeof(struct rusage));
-        return;
-    }
-#endif
-
     // normalize number of iterations
     *_num_iterations /= _n;
 
@@ -107,6 +81,14 @@ void fecsoft_decode_bench(
     case LIQUID_FEC_RS_M8:
         *_num_iterations *= 1;
         break;
+    case LIQUID_FEC_LDPC_R12:
+    case LIQUID_FEC_LDPC_R34:
+        *_num_iterations /= 50;
+        break;
+    case LIQUID_FEC_POLAR_R12:
+    case LIQUID_FEC_POLAR_R34:
+        *_num_iterations /= 50;
+        break;
     default:;
     }
     if (*_num_iterations < 1) *_num_iterations = 1;
@@ -186,5 +168,17 @@ void benchmark_fecsoft_dec_conv29p56_n64  FECSOFT_DECODE_BENCH_API(LIQUID_FEC_CO
 void benchmark_fecsoft_dec_conv29p67_n64  FECSOFT_DECODE_BENCH_API(LIQUID_FEC_CONV_V29P67,64, NULL)
 void benchmark_fecsoft_dec_conv29p78_n64  FECSOFT_DECODE_BENCH_API(LIQUID_FEC_CONV_V29P78,64, NULL)
 
+// long messages (sliding-window traceback)
+void benchmark_fecsoft_dec_conv27_n1024   FECSOFT_DECODE_BENCH_API(LIQUID_FEC_CONV_V27,   1024, NULL)
+void benchmark_fecsoft_dec_conv29_n1024   FECSOFT_DECODE_BENCH_API(LIQUID_FEC_CONV_V29,   1024, NULL)
+void benchmark_fecsoft_dec_conv27p78_n1024 FECSOFT_DECODE_BENCH_API(LIQUID_FEC_CONV_V27P78,1024, NULL)
+
 void benchmark_fecsoft_dec_rs8_n64        FECSOFT_DECODE_BENCH_API(LIQUID_FEC_RS_M8,      64, NULL)
 
+void benchmark_fecsoft_dec_ldpc12_n64     FECSOFT_DECODE_BENCH_API(LIQUID_FEC_LDPC_R12,   64, NULL)
+void benchmark_fecsoft_dec_ldpc34_n64     FECSOFT_DECODE_BENCH_API(LIQUID_FEC_LDPC_R34,   64, NULL)
+void benchmark_fecsoft_dec_ldpc12_n1024   FECSOFT_DECODE_BENCH_API(LIQUID_FEC_LDPC_R12,   1024, NULL)
+void benchmark_fecsoft_dec_polar12_n64    FECSOFT_DECODE_BENCH_API(LIQUID_FEC_POLAR_R12,  64, NULL)
+void benchmark_fecsoft_dec_polar34_n64    FECSOFT_DECODE_BENCH_API(LIQUID_FEC_POLAR_R34,  64, NULL)
+void benchmark_fecsoft_dec_polar12_n1024  FECSOFT_DECODE_BENCH_API(LIQUID_FEC_POLAR_R12,  1024, NULL)
+
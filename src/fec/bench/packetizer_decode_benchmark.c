@@ -52,6 +52,8 @@ void packetizer_decode_bench(struct rusage *     _start,
     // TODO: adjust iterations based on encoder types
     *_num_iterations *= 1000;
     *_num_iterations /= 221 + 1.6125*msg_dec_len;
+    if (_fec0 != LIQUID_FEC_NONE || _fec1 != LIQUID_FEC_NONE)
+        *_num_iterations /= 20;
 
     unsigned char msg_rec[msg_enc_len];
     unsigned char msg_dec[msg_dec_len];
@@ -82,6 +84,57 @@ void packetizer_decode_bench(struct rusage *     _start,
 }
 
 
+#define PACKETIZER_DECODE_BATCH_BENCH_API(N, CRC, FEC0, FEC1) \
+(   struct rusage *_start,                              \
+    struct rusage *_finish,                             \
+    unsigned long int *_num_iterations)                 \
+{ packetizer_decode_batch_bench(_start, _finish, _num_iterations, N, CRC, FEC0, FEC1); }
+
+// Helper function: decode batches of packets, counting each packet as
+// an iteration
+void packetizer_decode_batch_bench(struct rusage *     _start,
+                                   struct rusage *     _finish,
+                                   unsigned long int * _num_iterations,
+                                   unsigned int        _n,
+                                   crc_scheme          _crc,
+                                   fec_scheme          _fec0,
+                                   fec_scheme          _fec1)
+{
+    unsigned int num_packets = 64;
+    unsigned int msg_dec_len = _n;
+    unsigned int msg_enc_len = packetizer_compute_enc_msg_len(_n,_crc,_fec0,_fec1);
+
+    // adjust number of iterations (same scale as packetizer_decode_bench)
+    *_num_iterations *= 1000;
+    *_num_iterations /= 221 + 1.6125*msg_dec_len;
+    if (_fec0 != LIQUID_FEC_NONE || _fec1 != LIQUID_FEC_NONE)
+        *_num_iterations /= 20;
+    *_num_iterations = (*_num_iterations + num_packets - 1) / num_packets;
+
+    unsigned char * msg_rec = (unsigned char*) malloc(num_packets*msg_enc_len*sizeof(unsigned char));
+    unsigned char * msg_dec = (unsigned char*) malloc(num_packets*msg_dec_len*sizeof(unsigned char));
+    int valid[num_packets];
+
+    // initialize data
+    unsigned long int i;
+    for (i=0; i<num_packets*msg_enc_len; i++) msg_rec[i] = rand() & 0xff;
+
+    // create packet generator
+    packetizer q = packetizer_create(msg_dec_len, _crc, _fec0, _fec1);
+
+    // start trials
+    getrusage(RUSAGE_SELF, _start);
+    for (i=0; i<(*_num_iterations); i++)
+        packetizer_decode_batch(q, num_packets, msg_rec, msg_dec, valid);
+    getrusage(RUSAGE_SELF, _finish);
+    *_num_iterations *= num_packets;
+
+    // clean up allocated objects
+    packetizer_destroy(q);
+    free(msg_rec);
+    free(msg_dec);
+}
+
 //
 // BENCHMARKS
 //
@@ -93,3 +146,11 @@ void benchmark_packetizer_n256  PACKETIZER_DECODE_BENCH_API(256,  LIQUID_CRC_NON
 void benchmark_packetizer_n512  PACKETIZER_DECODE_BENCH_API(512,  LIQUID_CRC_NONE, LIQUID_FEC_NONE, LIQUID_FEC_NONE)
 void benchmark_packetizer_n1024 PACKETIZER_DECODE_BENCH_API(1024, LIQUID_CRC_NONE, LIQUID_FEC_NONE, LIQUID_FEC_NONE)
 
+// with inner and outer codes (exercises interleavers)
+void benchmark_packetizer_n64_h128_h84   PACKETIZER_DECODE_BENCH_API(64,   LIQUID_CRC_32, LIQUID_FEC_HAMMING128, LIQUID_FEC_HAMMING84)
+void benchmark_packetizer_n256_h128_h84  PACKETIZER_DECODE_BENCH_API(256,  LIQUID_CRC_32, LIQUID_FEC_HAMMING128, LIQUID_FEC_HAMMING84)
+void benchmark_packetizer_n1024_h128_h84 PACKETIZER_DECODE_BENCH_API(1024, LIQUID_CRC_32, LIQUID_FEC_HAMMING128, LIQUID_FEC_HAMMING84)
+
+// batches of 64 packets (cycles per packet)
+void benchmark_packetizer_batch_n16          PACKETIZER_DECODE_BATCH_BENCH_API(16,   LIQUID_CRC_NONE, LIQUID_FEC_NONE,       LIQUID_FEC_NONE)
+void benchmark_packetizer_batch_n64_h128_h84 PACKETIZER_DECODE_BATCH_BENCH_API(64,   LIQUID_CRC_32,   LIQUID_FEC_HAMMING128, LIQUID_FEC_HAMMING84)
@@ -30,6 +30,16 @@
 
 #include "liquid.internal.h"
 
+// carry-less multiply folding, selected at run time
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    HAVE_EMMINTRIN_H && HAVE_WMMINTRIN_H && !defined(LIQUID_SIMDOVERRIDE)
+#  define LIQUID_CRC_CLMUL 1
+#  include <emmintrin.h>
+#  include <wmmintrin.h>
+#else
+#  define LIQUID_CRC_CLMUL 0
+#endif
+
 
 // object-independent methods
 
@@ -108,19 +118,73 @@ unsigned int crc_get_length(crc_scheme _scheme)
 unsigned int crc_generate_key(crc_scheme      _scheme,
                               unsigned char * _msg,
                               unsigned int    _n)
+{
+    unsigned int key = crc_init_key(_scheme);
+    key = crc_update_key(_scheme, key, _msg, _n);
+    return crc_finalize_key(_scheme, key);
+}
+
+// initialize incremental key computation
+unsigned int crc_init_key(crc_scheme _scheme)
 {
     switch (_scheme) {
     case LIQUID_CRC_UNKNOWN:
-        fprintf(stderr,"error: crc_generate_key(), cannot generate key with CRC type \"UNKNOWN\"\n");
+        fprintf(stderr,"error: crc_init_key(), cannot generate key with CRC type \"UNKNOWN\"\n");
         exit(-1);
     case LIQUID_CRC_NONE:      return 0;
-    case LIQUID_CRC_CHECKSUM:  return checksum_generate_key(_msg, _n);
-    case LIQUID_CRC_8:         return crc8_generate_key(_msg, _n);
-    case LIQUID_CRC_16:        return crc16_generate_key(_msg, _n);
-    case LIQUID_CRC_24:        return crc24_generate_key(_msg, _n);
-    case LIQUID_CRC_32:        return crc32_generate_key(_msg, _n);
+    case LIQUID_CRC_CHECKSUM:  return 0;
+    case LIQUID_CRC_8:
+    case LIQUID_CRC_16:
+    case LIQUID_CRC_24:
+    case LIQUID_CRC_32:        return 0xffffffff;
     default:
-        fprintf(stderr,"error: crc_generate_key(), unknown/unsupported scheme: %d\n", _scheme);
+        fprintf(stderr,"error: crc_init_key(), unknown/unsupported scheme: %d\n", _scheme);
+        exit(1);
+    }
+
+    return 0;
+}
+
+// update incremental key computation with next segment of message
+unsigned int crc_update_key(crc_scheme            _scheme,
+                            unsigned int          _key,
+                            const unsigned char * _msg,
+                            unsigned int          _n)
+{
+    switch (_scheme) {
+    case LIQUID_CRC_UNKNOWN:
+        fprintf(stderr,"error: crc_update_key(), cannot generate key with CRC type \"UNKNOWN\"\n");
+        exit(-1);
+    case LIQUID_CRC_NONE:      return 0;
+    case LIQUID_CRC_CHECKSUM:  return checksum_update_key(_key, _msg, _n);
+    case LIQUID_CRC_8:         return crc_update_slice8(crc8_gentab,  _key, _msg, _n);
+    case LIQUID_CRC_16:        return crc_update_slice8(crc16_gentab, _key, _msg, _n);
+    case LIQUID_CRC_24:        return crc_update_fold(crc24_gentab, crc24_fold_gentab, _key, _msg, _n);
+    case LIQUID_CRC_32:        return crc_update_fold(crc32_gentab, crc32_fold_gentab, _key, _msg, _n);
+    default:
+        fprintf(stderr,"error: crc_update_key(), unknown/unsupported scheme: %d\n", _scheme);
+        exit(1);
+    }
+
+    return 0;
+}
+
+// finalize incremental key computation, returning key
+unsigned int crc_finalize_key(crc_scheme   _scheme,
+                              unsigned int _key)
+{
+    switch (_scheme) {
+    case LIQUID_CRC_UNKNOWN:
+        fprintf(stderr,"error: crc_finalize_key(), cannot generate key with CRC type \"UNKNOWN\"\n");
+        exit(-1);
+    case LIQUID_CRC_NONE:      return 0;
+    case LIQUID_CRC_CHECKSUM:  return (~_key + 1) & 0xff;
+    case LIQUID_CRC_8:         return (~_key) & 0xff;
+    case LIQUID_CRC_16:        return (~_key) & 0xffff;
+    case LIQUID_CRC_24:        return (~_key) & 0xffffff;
+    case LIQUID_CRC_32:        return (~_key) & 0xffffffff;
+    default:
+        fprintf(stderr,"error: crc_finalize_key(), unknown/unsupported scheme: %d\n", _scheme);
         exit(1);
     }
 
@@ -225,139 +289,191 @@ unsigned int crc_sizeof_key(crc_scheme _scheme)
 unsigned int checksum_generate_key(unsigned char *_data,
                                    unsigned int _n)
 {
-    unsigned int i, sum=0;
-    for (i=0; i<_n; i++)
-        sum += (unsigned int) (_data[i]);
-    //sum &= 0x00ff;
+    return crc_finalize_key(LIQUID_CRC_CHECKSUM,
+                            checksum_update_key(0, _data, _n));
+}
 
-    // mask and convert to 2's complement
-    unsigned char key = ~(sum&0x00ff) + 1;
+// update running 8-bit sum
+unsigned int checksum_update_key(unsigned int          _key,
+                                 const unsigned char * _msg,
+                                 unsigned int          _n)
+{
+    unsigned int i;
+    for (i=0; i<_n; i++)
+        _key += (unsigned int) (_msg[i]);
 
-    return key;
+    return _key & 0xff;
 }
 
 
-// 
-// CRC-8
 //
-
-// generate 8-bit cyclic redundancy check key.
+// cyclic redundancy check
 //
-// slow method, operates one bit at a time
-// algorithm from: http://www.hackersdelight.org/crc.pdf
+// All keys are reflected (least-significant bit first) with all bits of
+// a 32-bit register set initially and inverted at the end; for keys
+// shorter than 32 bits the upper bits of the register shift into the key
+// over the first few bytes, as in the original bit-serial algorithm
+// (algorithm from: http://www.hackersdelight.org/crc.pdf). The register is
+// updated eight bytes at a time using eight lookup tables, one for each
+// byte position (slicing-by-8). CRC-24 and CRC-32 additionally fold long
+// messages sixteen bytes at a time using the carry-less multiply
+// instruction when the processor supports it; the tables then finish
+// the remaining bytes.
 //
-//  _msg    :   input data message [size: _n x 1]
-//  _n      :   input data message size
-unsigned int crc8_generate_key(unsigned char *_msg,
-                               unsigned int _n)
+
+// minimum message length for carry-less multiply folding (at least 64)
+#define CRC_FOLD_MIN_LEN    (64)
+
+// update key one byte at a time
+//  _tab    :   slicing tables for this scheme
+//  _key    :   running (reflected) key
+//  _msg    :   input message segment [size: _n x 1]
+//  _n      :   input message segment size
+unsigned int crc_update_bytes(const unsigned int    _tab[8][256],
+                              unsigned int          _key,
+                              const unsigned char * _msg,
+                              unsigned int          _n)
 {
-    unsigned int i, j, b, mask, key8=~0;
-    unsigned int poly = liquid_reverse_byte_gentab[CRC8_POLY];
-    for (i=0; i<_n; i++) {
-        b = _msg[i];
-        key8 ^= b;
-        for (j=0; j<8; j++) {
-            mask = -(key8 & 1);
-            key8 = (key8>>1) ^ (poly & mask);
-        }
-    }
-    return (~key8) & 0xff;
+    unsigned int i;
+    for (i=0; i<_n; i++)
+        _key = (_key >> 8) ^ _tab[0][(_key ^ _msg[i]) & 0xff];
+    return _key;
 }
 
-
-// 
-// CRC-16
-//
-
-// generate 16-bit cyclic redundancy check key.
-//
-// slow method, operates one bit at a time
-// algorithm from: http://www.hackersdelight.org/crc.pdf
-//
-//  _msg    :   input data message [size: _n x 1]
-//  _n      :   input data message size
-unsigned int crc16_generate_key(unsigned char *_msg,
-                                unsigned int _n)
+// update key eight bytes at a time; because the key is reflected the
+// register lines up with the first four bytes of each eight-byte word
+unsigned int crc_update_slice8(const unsigned int    _tab[8][256],
+                               unsigned int          _key,
+                               const unsigned char * _msg,
+                               unsigned int          _n)
 {
-    unsigned int i, j, b, mask, key16=~0;
-    unsigned int poly = liquid_reverse_uint16(CRC16_POLY);
-    for (i=0; i<_n; i++) {
-        b = _msg[i];
-        key16 ^= b;
-        for (j=0; j<8; j++) {
-            mask = -(key16 & 1);
-            key16 = (key16>>1) ^ (poly & mask);
-        }
+    while (_n >= 8) {
+        unsigned int lo = ( (unsigned int)_msg[0]        |
+                           ((unsigned int)_msg[1] <<  8) |
+                           ((unsigned int)_msg[2] << 16) |
+                           ((unsigned int)_msg[3] << 24) ) ^ _key;
+        unsigned int hi =   (unsigned int)_msg[4]        |
+                           ((unsigned int)_msg[5] <<  8) |
+                           ((unsigned int)_msg[6] << 16) |
+                           ((unsigned int)_msg[7] << 24);
+        _key = _tab[7][ lo        & 0xff] ^ _tab[6][(lo >>  8) & 0xff] ^
+               _tab[5][(lo >> 16) & 0xff] ^ _tab[4][ lo >> 24        ] ^
+               _tab[3][ hi        & 0xff] ^ _tab[2][(hi >>  8) & 0xff] ^
+               _tab[1][(hi >> 16) & 0xff] ^ _tab[0][ hi >> 24        ];
+        _msg += 8;
+        _n   -= 8;
     }
-    return (~key16) & 0xffff;
-}
 
+    return crc_update_bytes(_tab, _key, _msg, _n);
+}
 
-// 
-// CRC-24
-//
+#if LIQUID_CRC_CLMUL
+// fold 128-bit remainder _x onto the next block _b; the low half of the
+// (reflected) remainder holds the high-order coefficients
+static inline __attribute__((target("sse2,pclmul")))
+__m128i crc_fold_block(__m128i _x,
+                       __m128i _k,
+                       __m128i _b)
+{
+    __m128i hi = _mm_clmulepi64_si128(_x, _k, 0x00);
+    __m128i lo = _mm_clmulepi64_si128(_x, _k, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(hi, lo), _b);
+}
 
-// generate 24-bit cyclic redundancy check key.
-//
-// slow method, operates one bit at a time
-// algorithm from: http://www.hackersdelight.org/crc.pdf
-//
-//  _msg    :   input data message [size: _n x 1]
-//  _n      :   input data message size
-unsigned int crc24_generate_key(unsigned char *_msg,
-                                unsigned int _n)
+// update key by folding 64 bytes at a time with carry-less multiplies;
+// requires _n >= 64
+//  _tab    :   slicing tables for this scheme
+//  _fold   :   folding constants for this scheme
+__attribute__((target("sse2,pclmul")))
+static unsigned int crc_update_clmul(const unsigned int       _tab[8][256],
+                                     const unsigned long long _fold[4],
+                                     unsigned int             _key,
+                                     const unsigned char *    _msg,
+                                     unsigned int             _n)
 {
-    unsigned int i, j, b, mask, key24=~0;
-    unsigned int poly = liquid_reverse_uint24(CRC24_POLY);
-    for (i=0; i<_n; i++) {
-        b = _msg[i];
-        key24 ^= b;
-        for (j=0; j<8; j++) {
-            mask = -(key24 & 1);
-            key24 = (key24>>1) ^ (poly & mask);
-        }
+    // initial key is added to the first bits of the message
+    const __m128i * m = (const __m128i*) _msg;
+    __m128i x0 = _mm_xor_si128(_mm_loadu_si128(m), _mm_cvtsi32_si128((int)_key));
+    __m128i x1 = _mm_loadu_si128(m+1);
+    __m128i x2 = _mm_loadu_si128(m+2);
+    __m128i x3 = _mm_loadu_si128(m+3);
+    m  += 4;
+    _n -= 64;
+
+    // fold four independent remainders by 64 bytes
+    __m128i k = _mm_set_epi64x((long long)_fold[1], (long long)_fold[0]);
+    while (_n >= 64) {
+        x0 = crc_fold_block(x0, k, _mm_loadu_si128(m));
+        x1 = crc_fold_block(x1, k, _mm_loadu_si128(m+1));
+        x2 = crc_fold_block(x2, k, _mm_loadu_si128(m+2));
+        x3 = crc_fold_block(x3, k, _mm_loadu_si128(m+3));
+        m  += 4;
+        _n -= 64;
     }
-    return (~key24) & 0xffffff;
-}
 
+    // combine remainders and fold remaining blocks by 16 bytes
+    k  = _mm_set_epi64x((long long)_fold[3], (long long)_fold[2]);
+    x0 = crc_fold_block(x0, k, x1);
+    x0 = crc_fold_block(x0, k, x2);
+    x0 = crc_fold_block(x0, k, x3);
+    while (_n >= 16) {
+        x0 = crc_fold_block(x0, k, _mm_loadu_si128(m));
+        m++;
+        _n -= 16;
+    }
 
-// 
-// CRC-32
-//
+    // reduce remainder and tail with tables
+    unsigned char r[16];
+    _mm_storeu_si128((__m128i*)r, x0);
+    _key = crc_update_slice8(_tab, 0, r, 16);
+    return crc_update_slice8(_tab, _key, (const unsigned char*)m, _n);
+}
+#endif
 
-// generate 32-bit cyclic redundancy check key.
-//
-// slow method, operates one bit at a time
-// algorithm from: http://www.hackersdelight.org/crc.pdf
-//
+// update key, folding long messages with carry-less multiplies when the
+// processor supports it
+//  _tab    :   slicing tables for this scheme
+//  _fold   :   folding constants x^d mod P for d = 575, 511, 191, 127
+//              (reflected, 64-bit)
+unsigned int crc_update_fold(const unsigned int       _tab[8][256],
+                             const unsigned long long _fold[4],
+                             unsigned int             _key,
+                             const unsigned char *    _msg,
+                             unsigned int             _n)
+{
+#if LIQUID_CRC_CLMUL
+    if (_n >= CRC_FOLD_MIN_LEN && __builtin_cpu_supports("pclmul"))
+        return crc_update_clmul(_tab, _fold, _key, _msg, _n);
+#endif
+    return crc_update_slice8(_tab, _key, _msg, _n);
+}
+
+// generate 8-bit cyclic redundancy check key
 //  _msg    :   input data message [size: _n x 1]
 //  _n      :   input data message size
-unsigned int crc32_generate_key(unsigned char *_msg,
+unsigned int crc8_generate_key(unsigned char *_msg,
+                               unsigned int _n)
+{
+    return crc_generate_key(LIQUID_CRC_8, _msg, _n);
+}
+
+// generate 16-bit cyclic redundancy check key
+unsigned int crc16_generate_key(unsigned char *_msg,
                                 unsigned int _n)
 {
-    unsigned int i, j, b, mask, key32=~0;
-    unsigned int poly = liquid_reverse_uint32(CRC32_POLY);
-    for (i=0; i<_n; i++) {
-        b = _msg[i];
-        key32 ^= b;
-        for (j=0; j<8; j++) {
-            mask = -(key32 & 1);
-            key32 = (key32>>1) ^ (poly & mask);
-        }
-    }
-    return (~key32) & 0xffffffff;
+    return crc_generate_key(LIQUID_CRC_16, _msg, _n);
 }
 
-#if 0
-void crc32_generate_key(unsigned char *_msg,
-                        unsigned int _n,
-                        unsigned char *_key)
+// generate 24-bit cyclic redundancy check key
+unsigned int crc24_generate_key(unsigned char *_msg,
+                                unsigned int _n)
 {
-    unsigned int key32 = crc32_generate_key32(_msg,_n);
-    _key[0] = (key32 & 0xFF000000) >> 24;
-    _key[1] = (key32 & 0x00FF0000) >> 16;
-    _key[2] = (key32 & 0x0000FF00) >> 8;
-    _key[3] = (key32 & 0x000000FF);
+    return crc_generate_key(LIQUID_CRC_24, _msg, _n);
 }
-#endif
 
+// generate 32-bit cyclic redundancy check key
+unsigned int crc32_generate_key(unsigned char *_msg,
+                                unsigned int _n)
+{
+    return crc_generate_key(LIQUID_CRC_32, _msg, _n);
+}
@@ -61,7 +61,11 @@ const char * fec_scheme_str[LIQUID_FEC_NUM_SCHEMES][2] = {
     {"v29p56",      "convolutional r5/6 K=9 (punctured)"},
     {"v29p67",      "convolutional r6/7 K=9 (punctured)"},
     {"v29p78",      "convolutional r7/8 K=9 (punctured)"},
-    {"rs8",         "Reed-Solomon, 223/255"}
+    {"rs8",         "Reed-Solomon, 223/255"},
+    {"ldpc12",      "QC-LDPC r1/2 (1024,512)"},
+    {"ldpc34",      "QC-LDPC r3/4 (1024,768)"},
+    {"polar12",     "polar r1/2 (CRC-aided, N<=1024)"},
+    {"polar34",     "polar r3/4 (CRC-aided, N<=1024)"}
 };
 
 // Print compact list of existing and available fec schemes
@@ -73,10 +77,6 @@ void liquid_print_fec_schemes()
     // print all available MOD schemes
     printf("          ");
     for (i=0; i<LIQUID_FEC_NUM_SCHEMES; i++) {
-#if !LIBFEC_ENABLED
-        if ( fec_scheme_is_convolutional(i) || fec_scheme_is_reedsolomon(i) )
-            continue;
-#endif
         printf("%s", fec_scheme_str[i][0]);
 
         if (i != LIQUID_FEC_NUM_SCHEMES-1)
@@ -174,6 +174,31 @@ int fec_scheme_is_reedsolomon(fec_scheme _scheme)
     return 0;
 }
 
+// is scheme low-density parity-check?
+int fec_scheme_is_ldpc(fec_scheme _scheme)
+{
+    switch (_scheme) {
+    // quasi-cyclic LDPC codes
+    case LIQUID_FEC_LDPC_R12:
+    case LIQUID_FEC_LDPC_R34:
+        return 1;
+    default:;
+    }
+    return 0;
+}
+
+// is scheme polar?
+int fec_scheme_is_polar(fec_scheme _scheme)
+{
+    switch (_scheme) {
+    case LIQUID_FEC_POLAR_R12:
+    case LIQUID_FEC_POLAR_R34:
+        return 1;
+    default:;
+    }
+    return 0;
+}
+
 // is scheme Hamming?
 int fec_scheme_is_hamming(fec_scheme _scheme)
 {
@@ -220,7 +245,6 @@ unsigned int fec_get_enc_msg_length(fec_scheme _scheme,
     case LIQUID_FEC_SECDED3932:     return _msg_len + _msg_len/4 + ((_msg_len%4) ? 1 : 0);
     case LIQUID_FEC_SECDED7264:     return _msg_len + _msg_len/8 + ((_msg_len%8) ? 1 : 0);
 
-#if LIBFEC_ENABLED
     // convolutional codes
     case LIQUID_FEC_CONV_V27:       return 2*_msg_len + 2;  // (K-1)/r=12, round up to 2 bytes
     case LIQUID_FEC_CONV_V29:       return 2*_msg_len + 2;  // (K-1)/r=16, 2 bytes
@@ -242,32 +266,14 @@ unsigned int fec_get_enc_msg_length(fec_scheme _scheme,
 
     // Reed-Solomon codes
     case LIQUID_FEC_RS_M8:          return fec_rs_get_enc_msg_len(_msg_len,32,255,223);
-#else
-    case LIQUID_FEC_CONV_V27:
-    case LIQUID_FEC_CONV_V29:
-    case LIQUID_FEC_CONV_V39:
-    case LIQUID_FEC_CONV_V615:
-
-    case LIQUID_FEC_CONV_V27P23:
-    case LIQUID_FEC_CONV_V27P34:
-    case LIQUID_FEC_CONV_V27P45:
-    case LIQUID_FEC_CONV_V27P56:
-    case LIQUID_FEC_CONV_V27P67:
-    case LIQUID_FEC_CONV_V27P78:
 
-    case LIQUID_FEC_CONV_V29P23:
-    case LIQUID_FEC_CONV_V29P34:
-    case LIQUID_FEC_CONV_V29P45:
-    case LIQUID_FEC_CONV_V29P56:
-    case LIQUID_FEC_CONV_V29P67:
-    case LIQUID_FEC_CONV_V29P78:
-        fprintf(stderr, "error: fec_get_enc_msg_length(), convolutional codes unavailable (install libfec)\n");
-        exit(-1);
+    // LDPC codes
+    case LIQUID_FEC_LDPC_R12:       return fec_ldpc_get_enc_msg_len(_msg_len,64,64);
+    case LIQUID_FEC_LDPC_R34:       return fec_ldpc_get_enc_msg_len(_msg_len,96,32);
 
-    case LIQUID_FEC_RS_M8:
-        fprintf(stderr, "error: fec_get_enc_msg_length(), Reed-Solomon codes unavailable (install libfec)\n");
-        exit(-1);
-#endif
+    // polar codes
+    case LIQUID_FEC_POLAR_R12:      return fec_polar_get_enc_msg_len(_msg_len,1,2);
+    case LIQUID_FEC_POLAR_R34:      return fec_polar_get_enc_msg_len(_msg_len,3,4);
     default:
         printf("error: fec_get_enc_msg_length(), unknown/unsupported scheme: %d\n", _scheme);
         exit(-1);
@@ -396,6 +402,47 @@ unsigned int fec_rs_get_enc_msg_len(unsigned int _dec_msg_len,
     return enc_msg_len;
 }
 
+// compute encoded message length for LDPC codes; the message is split
+// into blocks exactly as with Reed-Solomon codes, and each (shortened)
+// block carries its data bytes followed by all of the parity bytes
+//  _dec_msg_len    :   decoded message length (bytes)
+//  _k              :   data bytes per full-length code word
+//  _p              :   parity bytes per code word
+unsigned int fec_ldpc_get_enc_msg_len(unsigned int _dec_msg_len,
+                                      unsigned int _k,
+                                      unsigned int _p)
+{
+    // validate input
+    if (_dec_msg_len == 0) {
+        fprintf(stderr,"error: fec_ldpc_get_enc_msg_len(), _dec_msg_len must be greater than 0\n");
+        exit(1);
+    }
+
+    return fec_rs_get_enc_msg_len(_dec_msg_len, _p, _k+_p, _k);
+}
+
+// compute encoded message length for polar codes; the message is split
+// into blocks as with Reed-Solomon codes, and each block (with its CRC)
+// is encoded at rate _num/_den
+//  _dec_msg_len    :   decoded message length (bytes)
+//  _num            :   rate numerator
+//  _den            :   rate denominator
+unsigned int fec_polar_get_enc_msg_len(unsigned int _dec_msg_len,
+                                       unsigned int _num,
+                                       unsigned int _den)
+{
+    // validate input
+    if (_dec_msg_len == 0) {
+        fprintf(stderr,"error: fec_polar_get_enc_msg_len(), _dec_msg_len must be greater than 0\n");
+        exit(1);
+    }
+
+    unsigned int kk = fec_polar_get_max_block_len(_num, _den);
+    unsigned int num_blocks    = (_dec_msg_len + kk - 1) / kk;
+    unsigned int dec_block_len = (_dec_msg_len + num_blocks - 1) / num_blocks;
+    return num_blocks * fec_polar_get_enc_block_len(dec_block_len, _num, _den);
+}
+
 
 // get the theoretical rate of a particular forward error-
 // correction scheme (object-independent method)
@@ -415,7 +462,6 @@ float fec_get_rate(fec_scheme _scheme)
     case LIQUID_FEC_SECDED7264:     return 8./9.;
 
     // convolutional codes
-#if LIBFEC_ENABLED
     case LIQUID_FEC_CONV_V27:       return 1./2.;
     case LIQUID_FEC_CONV_V29:       return 1./2.;
     case LIQUID_FEC_CONV_V39:       return 1./3.;
@@ -435,32 +481,14 @@ float fec_get_rate(fec_scheme _scheme)
 
     // Reed-Solomon codes
     case LIQUID_FEC_RS_M8:          return 223./255.;
-#else
-    case LIQUID_FEC_CONV_V27:
-    case LIQUID_FEC_CONV_V29:
-    case LIQUID_FEC_CONV_V39:
-    case LIQUID_FEC_CONV_V615:
 
-    case LIQUID_FEC_CONV_V27P23:
-    case LIQUID_FEC_CONV_V27P34:
-    case LIQUID_FEC_CONV_V27P45:
-    case LIQUID_FEC_CONV_V27P56:
-    case LIQUID_FEC_CONV_V27P67:
-    case LIQUID_FEC_CONV_V27P78:
-
-    case LIQUID_FEC_CONV_V29P23:
-    case LIQUID_FEC_CONV_V29P34:
-    case LIQUID_FEC_CONV_V29P45:
-    case LIQUID_FEC_CONV_V29P56:
-    case LIQUID_FEC_CONV_V29P67:
-    case LIQUID_FEC_CONV_V29P78:
-        fprintf(stderr,"error: fec_get_rate(), convolutional codes unavailable (install libfec)\n");
-        exit(-1);
+    // LDPC codes
+    case LIQUID_FEC_LDPC_R12:       return 1./2.;
+    case LIQUID_FEC_LDPC_R34:       return 3./4.;
 
-    case LIQUID_FEC_RS_M8:
-        fprintf(stderr,"error: fec_get_rate(), Reed-Solomon codes unavailable (install libfec)\n");
-        exit(-1);
-#endif
+    // polar codes
+    case LIQUID_FEC_POLAR_R12:      return 1./2.;
+    case LIQUID_FEC_POLAR_R34:      return 3./4.;
 
     default:
         printf("error: fec_get_rate(), unknown/unsupported scheme: %d\n", _scheme);
@@ -503,7 +531,6 @@ fec fec_create(fec_scheme _scheme, void *_opts)
         return fec_secded7264_create(_opts);
 
     // convolutional codes
-#if LIBFEC_ENABLED
     case LIQUID_FEC_CONV_V27:
     case LIQUID_FEC_CONV_V29:
     case LIQUID_FEC_CONV_V39:
@@ -529,32 +556,16 @@ fec fec_create(fec_scheme _scheme, void *_opts)
     // Reed-Solomon codes
     case LIQUID_FEC_RS_M8:
         return fec_rs_create(_scheme);
-#else
-    case LIQUID_FEC_CONV_V27:
-    case LIQUID_FEC_CONV_V29:
-    case LIQUID_FEC_CONV_V39:
-    case LIQUID_FEC_CONV_V615:
 
-    case LIQUID_FEC_CONV_V27P23:
-    case LIQUID_FEC_CONV_V27P34:
-    case LIQUID_FEC_CONV_V27P45:
-    case LIQUID_FEC_CONV_V27P56:
-    case LIQUID_FEC_CONV_V27P67:
-    case LIQUID_FEC_CONV_V27P78:
+    // LDPC codes
+    case LIQUID_FEC_LDPC_R12:
+    case LIQUID_FEC_LDPC_R34:
+        return fec_ldpc_create(_scheme);
 
-    case LIQUID_FEC_CONV_V29P23:
-    case LIQUID_FEC_CONV_V29P34:
-    case LIQUID_FEC_CONV_V29P45:
-    case LIQUID_FEC_CONV_V29P56:
-    case LIQUID_FEC_CONV_V29P67:
-    case LIQUID_FEC_CONV_V29P78:
-        fprintf(stderr,"error: fec_create(), convolutional codes unavailable (install libfec)\n");
-        exit(-1);
-
-    case LIQUID_FEC_RS_M8:
-        fprintf(stderr,"error: fec_create(), Reed-Solomon codes unavailable (install libfec)\n");
-        exit(-1);
-#endif
+    // polar codes
+    case LIQUID_FEC_POLAR_R12:
+    case LIQUID_FEC_POLAR_R34:
+        return fec_polar_create(_scheme);
 
     default:
         printf("error: fec_create(), unknown/unsupported scheme: %d\n", _scheme);
@@ -626,7 +637,6 @@ void fec_destroy(fec _q)
         return;
 
     // convolutional codes
-#if LIBFEC_ENABLED
     case LIQUID_FEC_CONV_V27:
     case LIQUID_FEC_CONV_V29:
     case LIQUID_FEC_CONV_V39:
@@ -655,32 +665,18 @@ void fec_destroy(fec _q)
     case LIQUID_FEC_RS_M8:
         fec_rs_destroy(_q);
         return;
-#else
-    case LIQUID_FEC_CONV_V27:
-    case LIQUID_FEC_CONV_V29:
-    case LIQUID_FEC_CONV_V39:
-    case LIQUID_FEC_CONV_V615:
-
-    case LIQUID_FEC_CONV_V27P23:
-    case LIQUID_FEC_CONV_V27P34:
-    case LIQUID_FEC_CONV_V27P45:
-    case LIQUID_FEC_CONV_V27P56:
-    case LIQUID_FEC_CONV_V27P67:
-    case LIQUID_FEC_CONV_V27P78:
 
-    case LIQUID_FEC_CONV_V29P23:
-    case LIQUID_FEC_CONV_V29P34:
-    case LIQUID_FEC_CONV_V29P45:
-    case LIQUID_FEC_CONV_V29P56:
-    case LIQUID_FEC_CONV_V29P67:
-    case LIQUID_FEC_CONV_V29P78:
-        fprintf(stderr,"error: fec_destroy(), convolutional codes unavailable (install libfec)\n");
-        exit(-1);
+    // LDPC codes
+    case LIQUID_FEC_LDPC_R12:
+    case LIQUID_FEC_LDPC_R34:
+        fec_ldpc_destroy(_q);
+        return;
 
-    case LIQUID_FEC_RS_M8:
-        fprintf(stderr,"error: fec_destroy(), Reed-Solomon codes unavailable (install libfec)\n");
-        exit(-1);
-#endif
+    // polar codes
+    case LIQUID_FEC_POLAR_R12:
+    case LIQUID_FEC_POLAR_R34:
+        fec_polar_destroy(_q);
+        return;
 
     default:
         printf("error: fec_destroy(), unknown/unsupported scheme: %d\n", _q->scheme);
@@ -696,6 +692,24 @@ void fec_print(fec _q)
         _q->rate);
 }
 
+// pre-allocate internal memory of fec object for messages of up to
+// _dec_msg_len bytes so that subsequent shorter messages do not allocate
+void fec_reserve(fec          _q,
+                 unsigned int _dec_msg_len)
+{
+    if (_dec_msg_len == 0)
+        return;
+
+    if (fec_scheme_is_punctured(_q->scheme))
+        fec_conv_punctured_setlength(_q, _dec_msg_len);
+    else if (fec_scheme_is_convolutional(_q->scheme))
+        fec_conv_setlength(_q, _dec_msg_len);
+    else if (fec_scheme_is_reedsolomon(_q->scheme))
+        fec_rs_setlength(_q, _dec_msg_len);
+    else if (fec_scheme_is_polar(_q->scheme))
+        fec_polar_setlength(_q, _dec_msg_len);
+}
+
 // encode a block of data using a fec scheme
 //  _q              :   fec object
 //  _dec_msg_len    :   decoded message length
@@ -34,6 +34,7 @@
 
 #if LIBFEC_ENABLED
 #include "fec.h"
+#endif
 
 fec fec_conv_create(fec_scheme _fs)
 {
@@ -59,16 +60,26 @@ fec fec_conv_create(fec_scheme _fs)
     // convolutional-specific decoding
     q->num_dec_bytes = 0;
     q->enc_bits = NULL;
+    q->enc_bits_cap = 0;
     q->vp = NULL;
 
+#if !LIBFEC_ENABLED
+    // native decoder does not depend upon the message length
+    q->viterbi = fec_viterbi_create(q->K, q->R, q->poly, 1, NULL);
+#endif
+
     return q;
 }
 
 void fec_conv_destroy(fec _q)
 {
     // delete viterbi decoder
+#if LIBFEC_ENABLED
     if (_q->vp != NULL)
         _q->delete_viterbi(_q->vp);
+#else
+    fec_viterbi_destroy(_q->viterbi);
+#endif
 
     if (_q->enc_bits != NULL)
         free(_q->enc_bits);
@@ -100,7 +111,7 @@ void fec_conv_encode(fec _q,
 
             // compute parity bits for each polynomial
             for (r=0; r<_q->R; r++) {
-                byte_out = (byte_out<<1) | parity(sr & _q->poly[r]);
+                byte_out = (byte_out<<1) | liquid_count_ones_mod2_uint32(sr & _q->poly[r]);
                 _msg_enc[n/8] = byte_out;
                 n++;
             }
@@ -114,7 +125,7 @@ void fec_conv_encode(fec _q,
 
         // compute parity bits for each polynomial
         for (r=0; r<_q->R; r++) {
-            byte_out = (byte_out<<1) | parity(sr & _q->poly[r]);
+            byte_out = (byte_out<<1) | liquid_count_ones_mod2_uint32(sr & _q->poly[r]);
             _msg_enc[n/8] = byte_out;
             n++;
         }
@@ -177,6 +188,7 @@ void fec_conv_decode_soft(fec _q,
     // re-allocate resources if necessary
     fec_conv_setlength(_q, _dec_msg_len);
 
+#if LIBFEC_ENABLED
     // copy soft input bits
     unsigned int k;
     for (k=0; k<8*_q->num_enc_bytes; k++)
@@ -184,6 +196,10 @@ void fec_conv_decode_soft(fec _q,
 
     // run internal decoder
     fec_conv_decode(_q, _msg_dec);
+#else
+    // native decoder operates on soft bits directly
+    fec_viterbi_decode(_q->viterbi, _msg_enc, 8*_q->num_dec_bytes, _msg_dec);
+#endif
 }
 
 //unsigned int
@@ -191,9 +207,13 @@ void fec_conv_decode(fec _q,
                      unsigned char *_msg_dec)
 {
     // run decoder
+#if LIBFEC_ENABLED
     _q->init_viterbi(_q->vp,0);
     _q->update_viterbi_blk(_q->vp, _q->enc_bits, 8*_q->num_dec_bytes+_q->K-1);
     _q->chainback_viterbi(_q->vp, _msg_dec, 8*_q->num_dec_bytes, 0);
+#else
+    fec_viterbi_decode(_q->viterbi, _q->enc_bits, 8*_q->num_dec_bytes, _msg_dec);
+#endif
 
 #if VERBOSE_FEC_CONV
     for (i=0; i<_dec_msg_len; i++)
@@ -220,14 +240,21 @@ void fec_conv_setlength(fec _q, unsigned int _dec_msg_len)
     _q->num_enc_bytes = fec_get_enc_msg_length(_q->scheme,
                                                _dec_msg_len);
 
+#if LIBFEC_ENABLED
     // delete old decoder if necessary
     if (_q->vp != NULL)
         _q->delete_viterbi(_q->vp);
 
-    // re-create / re-allocate memory buffers
+    // re-create decoder
     _q->vp = _q->create_viterbi(8*_q->num_dec_bytes);
-    _q->enc_bits = (unsigned char*) realloc(_q->enc_bits,
-                                            _q->num_enc_bytes*8*sizeof(unsigned char));
+#endif
+
+    // re-allocate memory buffers (only ever grown)
+    if (_q->num_enc_bytes*8 > _q->enc_bits_cap) {
+        _q->enc_bits_cap = _q->num_enc_bytes*8;
+        _q->enc_bits = (unsigned char*) realloc(_q->enc_bits,
+                                                _q->enc_bits_cap*sizeof(unsigned char));
+    }
 }
 
 // 
@@ -239,11 +266,13 @@ void fec_conv_init_v27(fec _q)
     _q->R=2;
     _q->K=7;
     _q->poly = fec_conv27_poly;
+#if LIBFEC_ENABLED
     _q->create_viterbi = create_viterbi27;
     _q->init_viterbi = init_viterbi27;
     _q->update_viterbi_blk = update_viterbi27_blk;
     _q->chainback_viterbi = chainback_viterbi27;
     _q->delete_viterbi = delete_viterbi27;
+#endif
 }
 
 void fec_conv_init_v29(fec _q)
@@ -251,11 +280,13 @@ void fec_conv_init_v29(fec _q)
     _q->R=2;
     _q->K=9;
     _q->poly = fec_conv29_poly;
+#if LIBFEC_ENABLED
     _q->create_viterbi = create_viterbi29;
     _q->init_viterbi = init_viterbi29;
     _q->update_viterbi_blk = update_viterbi29_blk;
     _q->chainback_viterbi = chainback_viterbi29;
     _q->delete_viterbi = delete_viterbi29;
+#endif
 }
 
 void fec_conv_init_v39(fec _q)
@@ -263,11 +294,13 @@ void fec_conv_init_v39(fec _q)
     _q->R=3;
     _q->K=9;
     _q->poly = fec_conv39_poly;
+#if LIBFEC_ENABLED
     _q->create_viterbi = create_viterbi39;
     _q->init_viterbi = init_viterbi39;
     _q->update_viterbi_blk = update_viterbi39_blk;
     _q->chainback_viterbi = chainback_viterbi39;
     _q->delete_viterbi = delete_viterbi39;
+#endif
 }
 
 void fec_conv_init_v615(fec _q)
@@ -275,25 +308,12 @@ void fec_conv_init_v615(fec _q)
     _q->R=6;
     _q->K=15;
     _q->poly = fec_conv615_poly;
+#if LIBFEC_ENABLED
     _q->create_viterbi = create_viterbi615;
     _q->init_viterbi = init_viterbi615;
     _q->update_viterbi_blk = update_viterbi615_blk;
     _q->chainback_viterbi = chainback_viterbi615;
     _q->delete_viterbi = delete_viterbi615;
+#endif
 }
 
-
-
-#else   // LIBFEC_ENABLED
-
-fec fec_conv_create(fec_scheme _fs)
-{
-    return NULL;
-}
-
-void fec_conv_destroy(fec _q)
-{
-}
-
-#endif  // LIBFEC_ENABLED
-
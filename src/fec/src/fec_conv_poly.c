@@ -48,10 +48,23 @@ int fec_conv615_poly[6] = {V615POLYA,
 
 #else
 
-int fec_conv27_poly[2]  = {0,0};
-int fec_conv29_poly[2]  = {0,0};
-int fec_conv39_poly[3]  = {0,0,0};
-int fec_conv615_poly[6] = {0,0,0,0,0,0};
+// same polynomials as libfec
+int fec_conv27_poly[2]  = {0x6d,
+                           0x4f};
+
+int fec_conv29_poly[2]  = {0x1af,
+                           0x11d};
+
+int fec_conv39_poly[3]  = {0x1ed,
+                           0x19b,
+                           0x127};
+
+int fec_conv615_poly[6] = {042631,
+                           047245,
+                           056507,
+                           073363,
+                           077267,
+                           064537};
 
 #endif
 
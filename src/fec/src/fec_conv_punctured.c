@@ -34,6 +34,7 @@
 
 #if LIBFEC_ENABLED
 #include "fec.h"
+#endif
 
 fec fec_conv_punctured_create(fec_scheme _fs)
 {
@@ -68,16 +69,26 @@ fec fec_conv_punctured_create(fec_scheme _fs)
     // convolutional-specific decoding
     q->num_dec_bytes = 0;
     q->enc_bits = NULL;
+    q->enc_bits_cap = 0;
     q->vp = NULL;
 
+#if !LIBFEC_ENABLED
+    // native decoder skips punctured symbols in its branch metrics
+    q->viterbi = fec_viterbi_create(q->K, q->R, q->poly, q->P, q->puncturing_matrix);
+#endif
+
     return q;
 }
 
 void fec_conv_punctured_destroy(fec _q)
 {
     // delete viterbi decoder
+#if LIBFEC_ENABLED
     if (_q->vp != NULL)
         _q->delete_viterbi(_q->vp);
+#else
+    fec_viterbi_destroy(_q->viterbi);
+#endif
 
     if (_q->enc_bits != NULL)
         free(_q->enc_bits);
@@ -112,7 +123,7 @@ void fec_conv_punctured_encode(fec _q,
             for (r=0; r<_q->R; r++) {
                 // enable output determined by puncturing matrix
                 if (_q->puncturing_matrix[r*(_q->P)+p]) {
-                    byte_out = (byte_out<<1) | parity(sr & _q->poly[r]);
+                    byte_out = (byte_out<<1) | liquid_count_ones_mod2_uint32(sr & _q->poly[r]);
                     _msg_enc[n/8] = byte_out;
                     n++;
                 } else {
@@ -134,7 +145,7 @@ void fec_conv_punctured_encode(fec _q,
         // compute parity bits for each polynomial
         for (r=0; r<_q->R; r++) {
             if (_q->puncturing_matrix[r*(_q->P)+p]) {
-                byte_out = (byte_out<<1) | parity(sr & _q->poly[r]);
+                byte_out = (byte_out<<1) | liquid_count_ones_mod2_uint32(sr & _q->poly[r]);
                 _msg_enc[n/8] = byte_out;
                 n++;
             }
@@ -166,6 +177,18 @@ void fec_conv_punctured_decode_hard(fec _q,
     // re-allocate resources if necessary
     fec_conv_punctured_setlength(_q, _dec_msg_len);
 
+#if !LIBFEC_ENABLED
+    // unpack bytes and convert to soft bits; the native decoder
+    // accounts for punctured symbols itself
+    unsigned int k;
+    unsigned int num_written;
+    liquid_unpack_bytes(_msg_enc, _q->num_enc_bytes,
+                        _q->enc_bits, 8*_q->num_enc_bytes,
+                        &num_written);
+    for (k=0; k<8*_q->num_enc_bytes; k++)
+        _q->enc_bits[k] = _q->enc_bits[k] ? LIQUID_SOFTBIT_1 : LIQUID_SOFTBIT_0;
+    fec_viterbi_decode(_q->viterbi, _q->enc_bits, 8*_q->num_dec_bytes, _msg_dec);
+#else
     // unpack bytes, adding erasures at punctured indices
     unsigned int num_dec_bits = _q->num_dec_bytes * 8 + _q->K - 1;
     unsigned int num_enc_bits = num_dec_bits * _q->R;
@@ -218,6 +241,7 @@ void fec_conv_punctured_decode_hard(fec _q,
         printf("%.2x ", _msg_dec[ii]);
     printf("\n");
 #endif
+#endif
 }
 
 //unsigned int
@@ -229,6 +253,10 @@ void fec_conv_punctured_decode_soft(fec _q,
     // re-allocate resources if necessary
     fec_conv_punctured_setlength(_q, _dec_msg_len);
 
+#if !LIBFEC_ENABLED
+    // native decoder operates on punctured soft bits directly
+    fec_viterbi_decode(_q->viterbi, _msg_enc, 8*_q->num_dec_bytes, _msg_dec);
+#else
     // unpack bytes, adding erasures at punctured indices
     unsigned int num_dec_bits = _q->num_dec_bytes * 8 + _q->K - 1;
     unsigned int num_enc_bits = num_dec_bits * _q->R;
@@ -271,6 +299,7 @@ void fec_conv_punctured_decode_soft(fec _q,
         printf("%.2x ", _msg_dec[ii]);
     printf("\n");
 #endif
+#endif
 }
 
 void fec_conv_punctured_setlength(fec _q, unsigned int _dec_msg_len)
@@ -287,29 +316,38 @@ void fec_conv_punctured_setlength(fec _q, unsigned int _dec_msg_len)
     _q->num_enc_bytes = fec_get_enc_msg_length(_q->scheme,
                                                _dec_msg_len);
 
+#if LIBFEC_ENABLED
     // puncturing: need to expand to full length (decoder
     //             injects erasures at punctured values)
-    unsigned int num_dec_bits = 8*_q->num_dec_bytes;
-    unsigned int n = num_dec_bits + _q->K - 1;
-    unsigned int num_enc_bits = n*(_q->R);
+    unsigned int num_enc_bits = (8*_q->num_dec_bytes + _q->K - 1)*(_q->R);
+#else
+    // puncturing: native decoder skips punctured values
+    unsigned int num_enc_bits = 8*_q->num_enc_bytes;
+#endif
 #if VERBOSE_FEC_CONV_PUNCTURED
     printf("(re)creating viterbi decoder, %u frame bytes\n", num_dec_bytes);
     printf("  num decoded bytes         :   %u\n", _q->num_dec_bytes);
     printf("  num encoded bytes         :   %u\n", _q->num_enc_bytes);
-    printf("  num decoded bits          :   %u\n", num_dec_bits);
-    printf("  num decoded bits (padded) :   %u\n", n);
-    printf("  num encoded bits (full)   :   %u\n", num_enc_bits);
+    printf("  num decoded bits          :   %u\n", 8*_q->num_dec_bytes);
+    printf("  num decoded bits (padded) :   %u\n", 8*_q->num_dec_bytes + _q->K - 1);
+    printf("  num encoded bits          :   %u\n", num_enc_bits);
 #endif
 
+#if LIBFEC_ENABLED
     // delete old decoder if necessary
     if (_q->vp != NULL)
         _q->delete_viterbi(_q->vp);
 
-    // re-create / re-allocate memory buffers
+    // re-create decoder
     _q->vp = _q->create_viterbi(8*_q->num_dec_bytes);
-    _q->enc_bits = (unsigned char*) realloc(_q->enc_bits,
-                                            num_enc_bits*sizeof(unsigned char));
+#endif
 
+    // re-allocate memory buffers (only ever grown)
+    if (num_enc_bits > _q->enc_bits_cap) {
+        _q->enc_bits_cap = num_enc_bits;
+        _q->enc_bits = (unsigned char*) realloc(_q->enc_bits,
+                                                _q->enc_bits_cap*sizeof(unsigned char));
+    }
 }
 
 // 
@@ -426,33 +464,3 @@ void fec_conv_init_v29p78(fec _q)
     _q->P = 7;
     _q->puncturing_matrix = fec_conv29p78_matrix;
 }
-
-
-#else   // LIBFEC_ENABLED
-
-fec fec_conv_punctured_create(fec_scheme _fs)
-{
-    return NULL;
-}
-
-void fec_conv_punctured_destroy(fec _q)
-{
-}
-
-void fec_conv_punctured_encode(fec _q,
-                               unsigned int _dec_msg_len,
-                               unsigned char *_msg_dec,
-                               unsigned char *_msg_enc)
-{
-}
-
-//unsigned int
-void fec_conv_punctured_decode(fec _q,
-                               unsigned int _dec_msg_len,
-                               unsigned char *_msg_enc,
-                               unsigned char *_msg_dec)
-{
-}
-
-#endif  // LIBFEC_ENABLED
-
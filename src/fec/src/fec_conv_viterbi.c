@@ -0,0 +1,533 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+//
+// native soft-decision Viterbi decoder for convolutional codes
+//
+// All of liquid's code polynomials have both their first and last taps
+// set, so the four branches of a butterfly carry only two (complementary)
+// code words and a single branch metric is needed per butterfly. The
+// add-compare-select (ACS) operation is computed over sixteen butterflies
+// at a time: rate 1/2 codes (including all punctured codes) keep 8-bit
+// saturating path metrics with soft bits quantized to six bits, while
+// lower-rate codes keep 16-bit path metrics with full 8-bit soft bits.
+// Punctured symbols are skipped in the branch metric rather than being
+// replaced by erasures, and survivors are traced back over a sliding
+// window so memory does not grow with the message length.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "liquid.internal.h"
+
+#if HAVE_EMMINTRIN_H && defined __SSE2__
+#include <emmintrin.h>  // SSE2
+#define FEC_VITERBI_USE_SSE2 1
+#else
+#define FEC_VITERBI_USE_SSE2 0
+#endif
+
+// 16-bit metrics: initial metric of states other than zero, and the
+// value of the smallest metric above which all are renormalized
+#define FEC_VITERBI_METRIC16_INIT   (4096)
+#define FEC_VITERBI_METRIC16_RENORM (4096)
+
+// 8-bit metrics: soft bit quantization shift and initial metric of
+// states other than zero; these are renormalized at every step so the
+// best path sits at zero and only poor paths ever saturate
+#define FEC_VITERBI_METRIC8_SHIFT   (2)
+#define FEC_VITERBI_METRIC8_INIT    (128)
+
+// maximum number of generator polynomials
+#define FEC_VITERBI_MAX_R           (8)
+
+// number of decoded bits released by each traceback
+#define FEC_VITERBI_CHUNK           (256)
+
+struct fec_viterbi_s {
+    unsigned int K;             // constraint length
+    unsigned int R;             // inverse rate (number of polynomials)
+    unsigned int P;             // puncturing period
+    unsigned char * present;    // puncturing pattern [size: R x P]
+
+    unsigned int num_states;    // number of states, 2^(K-1)
+    unsigned int num_bfly;      // number of butterflies, num_states/2
+    unsigned int num_words;     // decision words per step, num_bfly/16
+
+    int narrow;                 // use 8-bit path metrics?
+    int16_t * tab16;            // branch code words, 16-bit [size: R x num_bfly]
+    uint8_t * tab8;             // branch code words, 8-bit [size: R x num_bfly]
+    void * metric0;             // path metrics (old)
+    void * metric1;             // path metrics (new)
+
+    uint32_t * dec;             // survivor decisions [size: W x num_words]
+    unsigned int L;             // traceback depth
+    unsigned int W;             // decision window length, L + chunk
+};
+
+// run one add-compare-select step with 16-bit path metrics
+//  _q      :   decoder object
+//  _sym    :   received soft bits for this step [size: _nr x 1]
+//  _tab    :   code word table indices matching _sym [size: _nr x 1]
+//  _nr     :   number of (unpunctured) symbols this step
+//  _dec    :   output decisions [size: num_words x 1]
+void fec_viterbi_acs16(fec_viterbi     _q,
+                       unsigned char * _sym,
+                       unsigned int *  _tab,
+                       unsigned int    _nr,
+                       uint32_t *      _dec);
+
+// run one add-compare-select step with 8-bit path metrics
+void fec_viterbi_acs8(fec_viterbi     _q,
+                      unsigned char * _sym,
+                      unsigned int *  _tab,
+                      unsigned int    _nr,
+                      uint32_t *      _dec);
+
+// find state with the smallest path metric
+unsigned int fec_viterbi_argmin(fec_viterbi _q);
+
+// trace survivors back from state _s at step _t over _num_skip steps
+// without output, then over _num_out steps writing decoded bits
+void fec_viterbi_traceback(fec_viterbi     _q,
+                           unsigned int    _t,
+                           unsigned int    _s,
+                           unsigned int    _num_skip,
+                           unsigned int    _num_out,
+                           unsigned int    _n,
+                           unsigned char * _msg_dec);
+
+// create Viterbi decoder object
+fec_viterbi fec_viterbi_create(unsigned int _K,
+                               unsigned int _R,
+                               int *        _poly,
+                               unsigned int _P,
+                               int *        _pmatrix)
+{
+    // validate input
+    if (_K < 6 || _K > 16) {
+        fprintf(stderr,"error: fec_viterbi_create(), constraint length must be in [6,16]\n");
+        exit(1);
+    } else if (_R == 0 || _R > FEC_VITERBI_MAX_R || (_K+1)*255*_R + FEC_VITERBI_METRIC16_RENORM > 0x7fff) {
+        fprintf(stderr,"error: fec_viterbi_create(), rate 1/%u unsupported with K=%u\n", _R, _K);
+        exit(1);
+    } else if (_P == 0) {
+        fprintf(stderr,"error: fec_viterbi_create(), puncturing period must be greater than zero\n");
+        exit(1);
+    }
+
+    fec_viterbi q = (fec_viterbi) malloc(sizeof(struct fec_viterbi_s));
+    q->K = _K;
+    q->R = _R;
+    q->P = _P;
+
+    q->num_states = 1 << (q->K-1);
+    q->num_bfly   = q->num_states / 2;
+    q->num_words  = q->num_bfly / 16;
+
+    // puncturing pattern
+    unsigned int r, p, i;
+    q->present = (unsigned char*) malloc(q->R*q->P*sizeof(unsigned char));
+    for (r=0; r<q->R; r++) {
+        for (p=0; p<q->P; p++)
+            q->present[r*q->P+p] = _pmatrix == NULL ? 1 : (_pmatrix[r*q->P+p] != 0);
+    }
+
+    // code word tables: output of polynomial r with old state i and
+    // input bit zero; the remaining branches are complements of these
+    unsigned int mask = (1 << q->K) - 1;
+    q->tab16 = (int16_t*) malloc(q->R*q->num_bfly*sizeof(int16_t));
+    q->tab8  = (uint8_t*) malloc(q->R*q->num_bfly*sizeof(uint8_t));
+    for (r=0; r<q->R; r++) {
+        unsigned int poly = (unsigned int)_poly[r] & mask;
+        if ( (poly & 1) == 0 || ((poly >> (q->K-1)) & 1) == 0 ) {
+            fprintf(stderr,"error: fec_viterbi_create(), polynomial 0x%x must have first and last taps set\n", poly);
+            exit(1);
+        }
+        for (i=0; i<q->num_bfly; i++) {
+            int c = liquid_count_ones_mod2_uint32(poly & (i<<1));
+            q->tab16[r*q->num_bfly + i] = c ? 255 : 0;
+            q->tab8 [r*q->num_bfly + i] = c ? (255 >> FEC_VITERBI_METRIC8_SHIFT) : 0;
+        }
+    }
+
+    // path metrics: 8-bit metrics leave enough headroom for two
+    // quantized soft bits per step (rate 1/2 codes)
+    q->narrow  = (q->R == 2);
+    q->metric0 = malloc(q->num_states*sizeof(int16_t));
+    q->metric1 = malloc(q->num_states*sizeof(int16_t));
+
+    // traceback depth: grows with the puncturing period since
+    // punctured codes need longer survivors to merge
+    q->L = (q->K-1) * (8 + 4*(q->P-1));
+    q->W = q->L + FEC_VITERBI_CHUNK;
+    q->dec = (uint32_t*) malloc(q->W*q->num_words*sizeof(uint32_t));
+
+    return q;
+}
+
+// destroy Viterbi decoder object
+void fec_viterbi_destroy(fec_viterbi _q)
+{
+    free(_q->present);
+    free(_q->tab16);
+    free(_q->tab8);
+    free(_q->metric0);
+    free(_q->metric1);
+    free(_q->dec);
+    free(_q);
+}
+
+// decode block of soft bits
+//  _q          :   decoder object
+//  _sym        :   soft bits, punctured symbols omitted
+//  _n          :   number of decoded bits (excluding K-1 tail bits)
+//  _msg_dec    :   decoded message [size: ceil(_n/8) x 1]
+unsigned int fec_viterbi_decode(fec_viterbi     _q,
+                                unsigned char * _sym,
+                                unsigned int    _n,
+                                unsigned char * _msg_dec)
+{
+    unsigned int i;
+    unsigned int num_steps = _n + _q->K - 1;
+
+    // initialize metrics: encoder starts in state zero
+    if (_q->narrow) {
+        uint8_t * m = (uint8_t*) _q->metric0;
+        memset(m, FEC_VITERBI_METRIC8_INIT, _q->num_states);
+        m[0] = 0;
+    } else {
+        int16_t * m = (int16_t*) _q->metric0;
+        for (i=1; i<_q->num_states; i++)
+            m[i] = FEC_VITERBI_METRIC16_INIT;
+        m[0] = 0;
+    }
+
+    memset(_msg_dec, 0x00, (_n+7)/8);
+
+    unsigned char sym[FEC_VITERBI_MAX_R];
+    unsigned int  tab[FEC_VITERBI_MAX_R];
+    unsigned int  n = 0;        // input symbol index
+    unsigned int  p = 0;        // puncturing column index
+    unsigned int  w = 0;        // decision window index, t mod W
+    unsigned int  t_out = 0;    // first step not yet decoded
+    unsigned int  t, r;
+    for (t=0; t<num_steps; t++) {
+        // gather unpunctured symbols for this step
+        unsigned int nr = 0;
+        for (r=0; r<_q->R; r++) {
+            if (_q->present[r*_q->P + p]) {
+                sym[nr] = _sym[n++];
+                tab[nr] = r*_q->num_bfly;
+                nr++;
+            }
+        }
+        p = (p+1 == _q->P) ? 0 : p+1;
+
+        if (_q->narrow)
+            fec_viterbi_acs8 (_q, sym, tab, nr, _q->dec + w*_q->num_words);
+        else
+            fec_viterbi_acs16(_q, sym, tab, nr, _q->dec + w*_q->num_words);
+        w = (w+1 == _q->W) ? 0 : w+1;
+
+        // release a chunk of bits once the window is full
+        if (t + 1 - t_out == _q->W) {
+            fec_viterbi_traceback(_q, t, fec_viterbi_argmin(_q), _q->L, FEC_VITERBI_CHUNK, _n, _msg_dec);
+            t_out += FEC_VITERBI_CHUNK;
+        }
+    }
+
+    // flush: tail bits return the encoder to state zero
+    fec_viterbi_traceback(_q, num_steps-1, 0, 0, num_steps - t_out, _n, _msg_dec);
+
+    // return number of input symbols consumed
+    return n;
+}
+
+void fec_viterbi_acs16(fec_viterbi     _q,
+                       unsigned char * _sym,
+                       unsigned int *  _tab,
+                       unsigned int    _nr,
+                       uint32_t *      _dec)
+{
+    unsigned int H = _q->num_bfly;
+    int16_t * m_old = (int16_t*) _q->metric0;
+    int16_t * m_new = (int16_t*) _q->metric1;
+    int16_t   mt = 255*_nr;     // sum of complementary branch metrics
+    unsigned int g, r, i;
+    int16_t m_min;
+
+#if FEC_VITERBI_USE_SSE2
+    __m128i vsym[FEC_VITERBI_MAX_R];
+    for (r=0; r<_nr; r++)
+        vsym[r] = _mm_set1_epi16(_sym[r]);
+    __m128i vmt  = _mm_set1_epi16(mt);
+    __m128i vmin = _mm_set1_epi16(0x7fff);
+
+    for (g=0; g<_q->num_words; g++) {
+        uint32_t word = 0;
+        unsigned int h;
+        for (h=0; h<2; h++) {
+            i = 16*g + 8*h;
+
+            // branch metric for eight butterflies
+            __m128i bm = _mm_setzero_si128();
+            for (r=0; r<_nr; r++) {
+                __m128i c = _mm_loadu_si128((__m128i*)(_q->tab16 + _tab[r] + i));
+                bm = _mm_add_epi16(bm, _mm_xor_si128(vsym[r], c));
+            }
+            __m128i bmc = _mm_sub_epi16(vmt, bm);
+
+            __m128i a = _mm_loadu_si128((__m128i*)(m_old + i));
+            __m128i c = _mm_loadu_si128((__m128i*)(m_old + i + H));
+
+            // input bit 0 (even states) and 1 (odd states)
+            __m128i m00 = _mm_add_epi16(a, bm);
+            __m128i m01 = _mm_add_epi16(c, bmc);
+            __m128i m10 = _mm_add_epi16(a, bmc);
+            __m128i m11 = _mm_add_epi16(c, bm);
+            __m128i d   = _mm_packs_epi16(_mm_cmpgt_epi16(m00, m01),
+                                          _mm_cmpgt_epi16(m10, m11));
+            __m128i n0  = _mm_min_epi16(m00, m01);
+            __m128i n1  = _mm_min_epi16(m10, m11);
+
+            _mm_storeu_si128((__m128i*)(m_new + 2*i    ), _mm_unpacklo_epi16(n0, n1));
+            _mm_storeu_si128((__m128i*)(m_new + 2*i + 8), _mm_unpackhi_epi16(n0, n1));
+
+            // decisions: even states in low half-word, odd in high
+            uint32_t mask = _mm_movemask_epi8(d);
+            word |= ((mask & 0xff) << (8*h)) | ((mask >> 8) << (16 + 8*h));
+
+            vmin = _mm_min_epi16(vmin, _mm_min_epi16(n0, n1));
+        }
+        _dec[g] = word;
+    }
+
+    // horizontal minimum
+    vmin = _mm_min_epi16(vmin, _mm_shuffle_epi32(vmin, _MM_SHUFFLE(1,0,3,2)));
+    vmin = _mm_min_epi16(vmin, _mm_shuffle_epi32(vmin, _MM_SHUFFLE(2,3,0,1)));
+    vmin = _mm_min_epi16(vmin, _mm_shufflelo_epi16(vmin, _MM_SHUFFLE(2,3,0,1)));
+    m_min = (int16_t) _mm_cvtsi128_si32(vmin);
+#else
+    m_min = 0x7fff;
+    for (g=0; g<_q->num_words; g++) {
+        uint32_t word = 0;
+        unsigned int k;
+        for (k=0; k<16; k++) {
+            i = 16*g + k;
+
+            // branch metric
+            int16_t bm = 0;
+            for (r=0; r<_nr; r++)
+                bm += _sym[r] ^ _q->tab16[_tab[r] + i];
+            int16_t bmc = mt - bm;
+
+            int16_t a = m_old[i];
+            int16_t c = m_old[i+H];
+
+            // input bit 0 (even states) and 1 (odd states)
+            int16_t m00 = a + bm;
+            int16_t m01 = c + bmc;
+            int16_t m10 = a + bmc;
+            int16_t m11 = c + bm;
+            m_new[2*i  ] = m01 < m00 ? m01 : m00;
+            m_new[2*i+1] = m11 < m10 ? m11 : m10;
+            word |= (uint32_t)(m01 < m00) << k;
+            word |= (uint32_t)(m11 < m10) << (16+k);
+
+            if (m_new[2*i  ] < m_min) m_min = m_new[2*i  ];
+            if (m_new[2*i+1] < m_min) m_min = m_new[2*i+1];
+        }
+        _dec[g] = word;
+    }
+#endif
+
+    // keep metrics well within range of 16-bit integers
+    if (m_min >= FEC_VITERBI_METRIC16_RENORM) {
+        for (i=0; i<_q->num_states; i++)
+            m_new[i] -= m_min;
+    }
+
+    // swap metric buffers
+    _q->metric0 = m_new;
+    _q->metric1 = m_old;
+}
+
+void fec_viterbi_acs8(fec_viterbi     _q,
+                      unsigned char * _sym,
+                      unsigned int *  _tab,
+                      unsigned int    _nr,
+                      uint32_t *      _dec)
+{
+    unsigned int H = _q->num_bfly;
+    uint8_t * m_old = (uint8_t*) _q->metric0;
+    uint8_t * m_new = (uint8_t*) _q->metric1;
+    uint8_t   mt = (255 >> FEC_VITERBI_METRIC8_SHIFT)*_nr;
+    unsigned int g, r, i;
+    uint8_t m_min;
+
+#if FEC_VITERBI_USE_SSE2
+    __m128i vsym[FEC_VITERBI_MAX_R];
+    for (r=0; r<_nr; r++)
+        vsym[r] = _mm_set1_epi8(_sym[r] >> FEC_VITERBI_METRIC8_SHIFT);
+    __m128i vmt  = _mm_set1_epi8(mt);
+    __m128i vmin = _mm_set1_epi8((char)0xff);
+
+    for (g=0; g<_q->num_words; g++) {
+        i = 16*g;
+
+        // branch metric for sixteen butterflies
+        __m128i bm = _mm_setzero_si128();
+        for (r=0; r<_nr; r++) {
+            __m128i c = _mm_loadu_si128((__m128i*)(_q->tab8 + _tab[r] + i));
+            bm = _mm_add_epi8(bm, _mm_xor_si128(vsym[r], c));
+        }
+        __m128i bmc = _mm_sub_epi8(vmt, bm);
+
+        __m128i a = _mm_loadu_si128((__m128i*)(m_old + i));
+        __m128i c = _mm_loadu_si128((__m128i*)(m_old + i + H));
+
+        // input bit 0 (even states) and 1 (odd states), saturating
+        __m128i m00 = _mm_adds_epu8(a, bm);
+        __m128i m01 = _mm_adds_epu8(c, bmc);
+        __m128i m10 = _mm_adds_epu8(a, bmc);
+        __m128i m11 = _mm_adds_epu8(c, bm);
+        __m128i n0  = _mm_min_epu8(m00, m01);
+        __m128i n1  = _mm_min_epu8(m10, m11);
+
+        _mm_storeu_si128((__m128i*)(m_new + 2*i     ), _mm_unpacklo_epi8(n0, n1));
+        _mm_storeu_si128((__m128i*)(m_new + 2*i + 16), _mm_unpackhi_epi8(n0, n1));
+
+        // decision is set where the metric from the lower state was not kept
+        uint32_t d0 = _mm_movemask_epi8(_mm_cmpeq_epi8(n0, m00)) ^ 0xffff;
+        uint32_t d1 = _mm_movemask_epi8(_mm_cmpeq_epi8(n1, m10)) ^ 0xffff;
+        _dec[g] = d0 | (d1 << 16);
+
+        vmin = _mm_min_epu8(vmin, _mm_min_epu8(n0, n1));
+    }
+
+    // horizontal minimum
+    vmin = _mm_min_epu8(vmin, _mm_shuffle_epi32(vmin, _MM_SHUFFLE(1,0,3,2)));
+    vmin = _mm_min_epu8(vmin, _mm_shuffle_epi32(vmin, _MM_SHUFFLE(2,3,0,1)));
+    vmin = _mm_min_epu8(vmin, _mm_shufflelo_epi16(vmin, _MM_SHUFFLE(2,3,0,1)));
+    vmin = _mm_min_epu8(vmin, _mm_srli_epi16(vmin, 8));
+    m_min = (uint8_t) _mm_cvtsi128_si32(vmin);
+
+    // renormalize
+    if (m_min > 0) {
+        vmin = _mm_set1_epi8(m_min);
+        for (i=0; i<_q->num_states; i+=16) {
+            __m128i v = _mm_loadu_si128((__m128i*)(m_new + i));
+            _mm_storeu_si128((__m128i*)(m_new + i), _mm_subs_epu8(v, vmin));
+        }
+    }
+#else
+    m_min = 0xff;
+    for (g=0; g<_q->num_words; g++) {
+        uint32_t word = 0;
+        unsigned int k;
+        for (k=0; k<16; k++) {
+            i = 16*g + k;
+
+            // branch metric
+            uint8_t bm = 0;
+            for (r=0; r<_nr; r++)
+                bm += (_sym[r] >> FEC_VITERBI_METRIC8_SHIFT) ^ _q->tab8[_tab[r] + i];
+            uint8_t bmc = mt - bm;
+
+            unsigned int a = m_old[i];
+            unsigned int c = m_old[i+H];
+
+            // input bit 0 (even states) and 1 (odd states), saturating
+            unsigned int m00 = a + bm;  if (m00 > 255) m00 = 255;
+            unsigned int m01 = c + bmc; if (m01 > 255) m01 = 255;
+            unsigned int m10 = a + bmc; if (m10 > 255) m10 = 255;
+            unsigned int m11 = c + bm;  if (m11 > 255) m11 = 255;
+            m_new[2*i  ] = m01 < m00 ? m01 : m00;
+            m_new[2*i+1] = m11 < m10 ? m11 : m10;
+            word |= (uint32_t)(m01 < m00) << k;
+            word |= (uint32_t)(m11 < m10) << (16+k);
+
+            if (m_new[2*i  ] < m_min) m_min = m_new[2*i  ];
+            if (m_new[2*i+1] < m_min) m_min = m_new[2*i+1];
+        }
+        _dec[g] = word;
+    }
+
+    // renormalize
+    if (m_min > 0) {
+        for (i=0; i<_q->num_states; i++)
+            m_new[i] -= m_min;
+    }
+#endif
+
+    // swap metric buffers
+    _q->metric0 = m_new;
+    _q->metric1 = m_old;
+}
+
+unsigned int fec_viterbi_argmin(fec_viterbi _q)
+{
+    unsigned int i;
+    unsigned int s = 0;
+    if (_q->narrow) {
+        uint8_t * m = (uint8_t*) _q->metric0;
+        for (i=1; i<_q->num_states; i++)
+            s = m[i] < m[s] ? i : s;
+    } else {
+        int16_t * m = (int16_t*) _q->metric0;
+        for (i=1; i<_q->num_states; i++)
+            s = m[i] < m[s] ? i : s;
+    }
+    return s;
+}
+
+void fec_viterbi_traceback(fec_viterbi     _q,
+                           unsigned int    _t,
+                           unsigned int    _s,
+                           unsigned int    _num_skip,
+                           unsigned int    _num_out,
+                           unsigned int    _n,
+                           unsigned char * _msg_dec)
+{
+    unsigned int H = _q->num_bfly;
+    unsigned int t = _t;
+    unsigned int s = _s;
+    unsigned int w = _t % _q->W;    // decision window index
+    unsigned int i;
+    for (i=0; i<_num_skip + _num_out; i++) {
+        unsigned int b = s & 1;     // input bit at this step
+        unsigned int j = s >> 1;    // butterfly index
+
+        // write decoded bit
+        if (i >= _num_skip && t < _n)
+            _msg_dec[t/8] |= b << (7 - (t%8));
+
+        // select predecessor
+        uint32_t word = _q->dec[w*_q->num_words + j/16];
+        s = j + ((word >> ((b << 4) | (j & 15))) & 1)*H;
+        t--;
+        w = (w == 0) ? _q->W-1 : w-1;
+    }
+}
@@ -35,6 +35,22 @@
 #include "liquid.internal.h"
 
 #define DEBUG_FEC_GOLAY2412 0
+#define FEC_GOLAY2412_GENTAB    1   // use look-up tables for encoding/decoding?
+
+#if FEC_GOLAY2412_GENTAB
+// encode 12-bit symbol: exclusive or of codewords for upper and lower
+// 6-bit halves
+#define golay2412_enc_tab(m) (golay2412_enc_gentab[0][(m)      & 0x3f] ^ \
+                              golay2412_enc_gentab[1][(m) >> 6 & 0x3f])
+
+// decode 24-bit symbol: syndrome from each received byte, then message
+// bits corrected according to syndrome (same result as the algebraic
+// decoder, fec_golay2412_decode_symbol(), for every received symbol)
+#define golay2412_dec_tab(v) (((v) ^ golay2412_dec_gentab[                  \
+                                    golay2412_syndrome_gentab[0][(v)       & 0xff] ^ \
+                                    golay2412_syndrome_gentab[1][(v) >>  8 & 0xff] ^ \
+                                    golay2412_syndrome_gentab[2][(v) >> 16 & 0xff] ]) & 0x0fff)
+#endif
 
 // P matrix [12 x 12]
 unsigned int golay2412_P[12] = {
@@ -288,8 +304,13 @@ void fec_golay2412_encode(fec _q,
         m1 = ((s1 << 8) & 0x0f00) | ((s2     ) & 0x00ff);
 
         // encode each 12-bit symbol into a 24-bit symbol
+#if FEC_GOLAY2412_GENTAB
+        v0 = golay2412_enc_tab(m0);
+        v1 = golay2412_enc_tab(m1);
+#else
         v0 = fec_golay2412_encode_symbol(m0);
         v1 = fec_golay2412_encode_symbol(m1);
+#endif
 
         // unpack two 24-bit symbols into six 8-bit bytes
         // retaining order of bits in output
@@ -312,7 +333,11 @@ void fec_golay2412_encode(fec _q,
         m0 = s0;
 
         // encode into 24-bit symbol
+#if FEC_GOLAY2412_GENTAB
+        v0 = golay2412_enc_tab(m0);
+#else
         v0 = fec_golay2412_encode_symbol(m0);
+#endif
 
         // unpack one 24-bit symbol into three 8-bit bytes, and
         // append to output array
@@ -363,8 +388,13 @@ void fec_golay2412_decode(fec _q,
         v1 = ((r3 << 16) & 0xff0000) | ((r4 <<  8) & 0x00ff00) | ((r5 << 0) & 0x0000ff);
 
         // decode each symbol into a 12-bit symbol
+#if FEC_GOLAY2412_GENTAB
+        m0_hat = golay2412_dec_tab(v0);
+        m1_hat = golay2412_dec_tab(v1);
+#else
         m0_hat = fec_golay2412_decode_symbol(v0);
         m1_hat = fec_golay2412_decode_symbol(v1);
+#endif
 
         // unpack two 12-bit symbols into three 8-bit bytes
         _msg_dec[i+0] = ((m0_hat >> 4) & 0xff);
@@ -385,7 +415,11 @@ void fec_golay2412_decode(fec _q,
         v0 = ((r0 << 16) & 0xff0000) | ((r1 <<  8) & 0x00ff00) | ((r2     ) & 0x0000ff);
 
         // decode into a 12-bit symbol
+#if FEC_GOLAY2412_GENTAB
+        m0_hat = golay2412_dec_tab(v0);
+#else
         m0_hat = fec_golay2412_decode_symbol(v0);
+#endif
 
         // retain last 8 bits of 12-bit symbol
         _msg_dec[i] = m0_hat & 0xff;
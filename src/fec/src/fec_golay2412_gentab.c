@@ -0,0 +1,677 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+//
+// Golay(24,12) encoding/decoding tables (auto-generated)
+//
+//  golay2412_enc_gentab[k][m]      : codeword for 6-bit message chunk m
+//                                    shifted left by 6*k bits
+//  golay2412_syndrome_gentab[k][b] : syndrome contribution of received
+//                                    byte b shifted left by 8*k bits
+//  golay2412_dec_gentab[s]         : message-bit correction (low 12 bits
+//                                    of estimated error vector) for
+//                                    syndrome s
+//
+
+#include "liquid.internal.h"
+
+const unsigned int golay2412_enc_gentab[2][64] = {
+  {
+    0x000000, 0xffe001, 0x477002, 0xb89003, 0xa3b004, 0x5c5005, 0xe4c006, 0x1b2007,
+    0xd1d008, 0x2e3009, 0x96a00a, 0x69400b, 0x72600c, 0x8d800d, 0x35100e, 0xcaf00f,
+    0x68f010, 0x971011, 0x2f8012, 0xd06013, 0xcb4014, 0x34a015, 0x8c3016, 0x73d017,
+    0xb92018, 0x46c019, 0xfe501a, 0x01b01b, 0x1a901c, 0xe5701d, 0x5de01e, 0xa2001f,
+    0xb47020, 0x4b9021, 0xf30022, 0x0ce023, 0x17c024, 0xe82025, 0x50b026, 0xaf5027,
+    0x65a028, 0x9a4029, 0x22d02a, 0xdd302b, 0xc6102c, 0x39f02d, 0x81602e, 0x7e802f,
+    0xdc8030, 0x236031, 0x9bf032, 0x641033, 0x7f3034, 0x80d035, 0x384036, 0xc7a037,
+    0x0d5038, 0xf2b039, 0x4a203a, 0xb5c03b, 0xaee03c, 0x51003d, 0xe9903e, 0x16703f
+  },
+  {
+    0x000000, 0xda3040, 0xed1080, 0x3720c0, 0x769100, 0xaca140, 0x9b8180, 0x41b1c0,
+    0x3b5200, 0xe16240, 0xd64280, 0x0c72c0, 0x4dc300, 0x97f340, 0xa0d380, 0x7ae3c0,
+    0x1db400, 0xc78440, 0xf0a480, 0x2a94c0, 0x6b2500, 0xb11540, 0x863580, 0x5c05c0,
+    0x26e600, 0xfcd640, 0xcbf680, 0x11c6c0, 0x507700, 0x8a4740, 0xbd6780, 0x6757c0,
+    0x8ed800, 0x54e840, 0x63c880, 0xb9f8c0, 0xf84900, 0x227940, 0x155980, 0xcf69c0,
+    0xb58a00, 0x6fba40, 0x589a80, 0x82aac0, 0xc31b00, 0x192b40, 0x2e0b80, 0xf43bc0,
+    0x936c00, 0x495c40, 0x7e7c80, 0xa44cc0, 0xe5fd00, 0x3fcd40, 0x08ed80, 0xd2ddc0,
+    0xa83e00, 0x720e40, 0x452e80, 0x9f1ec0, 0xdeaf00, 0x049f40, 0x33bf80, 0xe98fc0
+  }};
+
+const unsigned short int golay2412_syndrome_gentab[3][256] = {
+  {
+    0x0000, 0x0ffe, 0x0477, 0x0b89, 0x0a3b, 0x05c5, 0x0e4c, 0x01b2,
+    0x0d1d, 0x02e3, 0x096a, 0x0694, 0x0726, 0x08d8, 0x0351, 0x0caf,
+    0x068f, 0x0971, 0x02f8, 0x0d06, 0x0cb4, 0x034a, 0x08c3, 0x073d,
+    0x0b92, 0x046c, 0x0fe5, 0x001b, 0x01a9, 0x0e57, 0x05de, 0x0a20,
+    0x0b47, 0x04b9, 0x0f30, 0x00ce, 0x017c, 0x0e82, 0x050b, 0x0af5,
+    0x065a, 0x09a4, 0x022d, 0x0dd3, 0x0c61, 0x039f, 0x0816, 0x07e8,
+    0x0dc8, 0x0236, 0x09bf, 0x0641, 0x07f3, 0x080d, 0x0384, 0x0c7a,
+    0x00d5, 0x0f2b, 0x04a2, 0x0b5c, 0x0aee, 0x0510, 0x0e99, 0x0167,
+    0x0da3, 0x025d, 0x09d4, 0x062a, 0x0798, 0x0866, 0x03ef, 0x0c11,
+    0x00be, 0x0f40, 0x04c9, 0x0b37, 0x0a85, 0x057b, 0x0ef2, 0x010c,
+    0x0b2c, 0x04d2, 0x0f5b, 0x00a5, 0x0117, 0x0ee9, 0x0560, 0x0a9e,
+    0x0631, 0x09cf, 0x0246, 0x0db8, 0x0c0a, 0x03f4, 0x087d, 0x0783,
+    0x06e4, 0x091a, 0x0293, 0x0d6d, 0x0cdf, 0x0321, 0x08a8, 0x0756,
+    0x0bf9, 0x0407, 0x0f8e, 0x0070, 0x01c2, 0x0e3c, 0x05b5, 0x0a4b,
+    0x006b, 0x0f95, 0x041c, 0x0be2, 0x0a50, 0x05ae, 0x0e27, 0x01d9,
+    0x0d76, 0x0288, 0x0901, 0x06ff, 0x074d, 0x08b3, 0x033a, 0x0cc4,
+    0x0ed1, 0x012f, 0x0aa6, 0x0558, 0x04ea, 0x0b14, 0x009d, 0x0f63,
+    0x03cc, 0x0c32, 0x07bb, 0x0845, 0x09f7, 0x0609, 0x0d80, 0x027e,
+    0x085e, 0x07a0, 0x0c29, 0x03d7, 0x0265, 0x0d9b, 0x0612, 0x09ec,
+    0x0543, 0x0abd, 0x0134, 0x0eca, 0x0f78, 0x0086, 0x0b0f, 0x04f1,
+    0x0596, 0x0a68, 0x01e1, 0x0e1f, 0x0fad, 0x0053, 0x0bda, 0x0424,
+    0x088b, 0x0775, 0x0cfc, 0x0302, 0x02b0, 0x0d4e, 0x06c7, 0x0939,
+    0x0319, 0x0ce7, 0x076e, 0x0890, 0x0922, 0x06dc, 0x0d55, 0x02ab,
+    0x0e04, 0x01fa, 0x0a73, 0x058d, 0x043f, 0x0bc1, 0x0048, 0x0fb6,
+    0x0372, 0x0c8c, 0x0705, 0x08fb, 0x0949, 0x06b7, 0x0d3e, 0x02c0,
+    0x0e6f, 0x0191, 0x0a18, 0x05e6, 0x0454, 0x0baa, 0x0023, 0x0fdd,
+    0x05fd, 0x0a03, 0x018a, 0x0e74, 0x0fc6, 0x0038, 0x0bb1, 0x044f,
+    0x08e0, 0x071e, 0x0c97, 0x0369, 0x02db, 0x0d25, 0x06ac, 0x0952,
+    0x0835, 0x07cb, 0x0c42, 0x03bc, 0x020e, 0x0df0, 0x0679, 0x0987,
+    0x0528, 0x0ad6, 0x015f, 0x0ea1, 0x0f13, 0x00ed, 0x0b64, 0x049a,
+    0x0eba, 0x0144, 0x0acd, 0x0533, 0x0481, 0x0b7f, 0x00f6, 0x0f08,
+    0x03a7, 0x0c59, 0x07d0, 0x082e, 0x099c, 0x0662, 0x0deb, 0x0215
+  },
+  {
+    0x0000, 0x0769, 0x03b5, 0x04dc, 0x01db, 0x06b2, 0x026e, 0x0507,
+    0x08ed, 0x0f84, 0x0b58, 0x0c31, 0x0936, 0x0e5f, 0x0a83, 0x0dea,
+    0x0001, 0x0768, 0x03b4, 0x04dd, 0x01da, 0x06b3, 0x026f, 0x0506,
+    0x08ec, 0x0f85, 0x0b59, 0x0c30, 0x0937, 0x0e5e, 0x0a82, 0x0deb,
+    0x0002, 0x076b, 0x03b7, 0x04de, 0x01d9, 0x06b0, 0x026c, 0x0505,
+    0x08ef, 0x0f86, 0x0b5a, 0x0c33, 0x0934, 0x0e5d, 0x0a81, 0x0de8,
+    0x0003, 0x076a, 0x03b6, 0x04df, 0x01d8, 0x06b1, 0x026d, 0x0504,
+    0x08ee, 0x0f87, 0x0b5b, 0x0c32, 0x0935, 0x0e5c, 0x0a80, 0x0de9,
+    0x0004, 0x076d, 0x03b1, 0x04d8, 0x01df, 0x06b6, 0x026a, 0x0503,
+    0x08e9, 0x0f80, 0x0b5c, 0x0c35, 0x0932, 0x0e5b, 0x0a87, 0x0dee,
+    0x0005, 0x076c, 0x03b0, 0x04d9, 0x01de, 0x06b7, 0x026b, 0x0502,
+    0x08e8, 0x0f81, 0x0b5d, 0x0c34, 0x0933, 0x0e5a, 0x0a86, 0x0def,
+    0x0006, 0x076f, 0x03b3, 0x04da, 0x01dd, 0x06b4, 0x0268, 0x0501,
+    0x08eb, 0x0f82, 0x0b5e, 0x0c37, 0x0930, 0x0e59, 0x0a85, 0x0dec,
+    0x0007, 0x076e, 0x03b2, 0x04db, 0x01dc, 0x06b5, 0x0269, 0x0500,
+    0x08ea, 0x0f83, 0x0b5f, 0x0c36, 0x0931, 0x0e58, 0x0a84, 0x0ded,
+    0x0008, 0x0761, 0x03bd, 0x04d4, 0x01d3, 0x06ba, 0x0266, 0x050f,
+    0x08e5, 0x0f8c, 0x0b50, 0x0c39, 0x093e, 0x0e57, 0x0a8b, 0x0de2,
+    0x0009, 0x0760, 0x03bc, 0x04d5, 0x01d2, 0x06bb, 0x0267, 0x050e,
+    0x08e4, 0x0f8d, 0x0b51, 0x0c38, 0x093f, 0x0e56, 0x0a8a, 0x0de3,
+    0x000a, 0x0763, 0x03bf, 0x04d6, 0x01d1, 0x06b8, 0x0264, 0x050d,
+    0x08e7, 0x0f8e, 0x0b52, 0x0c3b, 0x093c, 0x0e55, 0x0a89, 0x0de0,
+    0x000b, 0x0762, 0x03be, 0x04d7, 0x01d0, 0x06b9, 0x0265, 0x050c,
+    0x08e6, 0x0f8f, 0x0b53, 0x0c3a, 0x093d, 0x0e54, 0x0a88, 0x0de1,
+    0x000c, 0x0765, 0x03b9, 0x04d0, 0x01d7, 0x06be, 0x0262, 0x050b,
+    0x08e1, 0x0f88, 0x0b54, 0x0c3d, 0x093a, 0x0e53, 0x0a8f, 0x0de6,
+    0x000d, 0x0764, 0x03b8, 0x04d1, 0x01d6, 0x06bf, 0x0263, 0x050a,
+    0x08e0, 0x0f89, 0x0b55, 0x0c3c, 0x093b, 0x0e52, 0x0a8e, 0x0de7,
+    0x000e, 0x0767, 0x03bb, 0x04d2, 0x01d5, 0x06bc, 0x0260, 0x0509,
+    0x08e3, 0x0f8a, 0x0b56, 0x0c3f, 0x0938, 0x0e51, 0x0a8d, 0x0de4,
+    0x000f, 0x0766, 0x03ba, 0x04d3, 0x01d4, 0x06bd, 0x0261, 0x0508,
+    0x08e2, 0x0f8b, 0x0b57, 0x0c3e, 0x0939, 0x0e50, 0x0a8c, 0x0de5
+  },
+  {
+    0x0000, 0x0010, 0x0020, 0x0030, 0x0040, 0x0050, 0x0060, 0x0070,
+    0x0080, 0x0090, 0x00a0, 0x00b0, 0x00c0, 0x00d0, 0x00e0, 0x00f0,
+    0x0100, 0x0110, 0x0120, 0x0130, 0x0140, 0x0150, 0x0160, 0x0170,
+    0x0180, 0x0190, 0x01a0, 0x01b0, 0x01c0, 0x01d0, 0x01e0, 0x01f0,
+    0x0200, 0x0210, 0x0220, 0x0230, 0x0240, 0x0250, 0x0260, 0x0270,
+    0x0280, 0x0290, 0x02a0, 0x02b0, 0x02c0, 0x02d0, 0x02e0, 0x02f0,
+    0x0300, 0x0310, 0x0320, 0x0330, 0x0340, 0x0350, 0x0360, 0x0370,
+    0x0380, 0x0390, 0x03a0, 0x03b0, 0x03c0, 0x03d0, 0x03e0, 0x03f0,
+    0x0400, 0x0410, 0x0420, 0x0430, 0x0440, 0x0450, 0x0460, 0x0470,
+    0x0480, 0x0490, 0x04a0, 0x04b0, 0x04c0, 0x04d0, 0x04e0, 0x04f0,
+    0x0500, 0x0510, 0x0520, 0x0530, 0x0540, 0x0550, 0x0560, 0x0570,
+    0x0580, 0x0590, 0x05a0, 0x05b0, 0x05c0, 0x05d0, 0x05e0, 0x05f0,
+    0x0600, 0x0610, 0x0620, 0x0630, 0x0640, 0x0650, 0x0660, 0x0670,
+    0x0680, 0x0690, 0x06a0, 0x06b0, 0x06c0, 0x06d0, 0x06e0, 0x06f0,
+    0x0700, 0x0710, 0x0720, 0x0730, 0x0740, 0x0750, 0x0760, 0x0770,
+    0x0780, 0x0790, 0x07a0, 0x07b0, 0x07c0, 0x07d0, 0x07e0, 0x07f0,
+    0x0800, 0x0810, 0x0820, 0x0830, 0x0840, 0x0850, 0x0860, 0x0870,
+    0x0880, 0x0890, 0x08a0, 0x08b0, 0x08c0, 0x08d0, 0x08e0, 0x08f0,
+    0x0900, 0x0910, 0x0920, 0x0930, 0x0940, 0x0950, 0x0960, 0x0970,
+    0x0980, 0x0990, 0x09a0, 0x09b0, 0x09c0, 0x09d0, 0x09e0, 0x09f0,
+    0x0a00, 0x0a10, 0x0a20, 0x0a30, 0x0a40, 0x0a50, 0x0a60, 0x0a70,
+    0x0a80, 0x0a90, 0x0aa0, 0x0ab0, 0x0ac0, 0x0ad0, 0x0ae0, 0x0af0,
+    0x0b00, 0x0b10, 0x0b20, 0x0b30, 0x0b40, 0x0b50, 0x0b60, 0x0b70,
+    0x0b80, 0x0b90, 0x0ba0, 0x0bb0, 0x0bc0, 0x0bd0, 0x0be0, 0x0bf0,
+    0x0c00, 0x0c10, 0x0c20, 0x0c30, 0x0c40, 0x0c50, 0x0c60, 0x0c70,
+    0x0c80, 0x0c90, 0x0ca0, 0x0cb0, 0x0cc0, 0x0cd0, 0x0ce0, 0x0cf0,
+    0x0d00, 0x0d10, 0x0d20, 0x0d30, 0x0d40, 0x0d50, 0x0d60, 0x0d70,
+    0x0d80, 0x0d90, 0x0da0, 0x0db0, 0x0dc0, 0x0dd0, 0x0de0, 0x0df0,
+    0x0e00, 0x0e10, 0x0e20, 0x0e30, 0x0e40, 0x0e50, 0x0e60, 0x0e70,
+    0x0e80, 0x0e90, 0x0ea0, 0x0eb0, 0x0ec0, 0x0ed0, 0x0ee0, 0x0ef0,
+    0x0f00, 0x0f10, 0x0f20, 0x0f30, 0x0f40, 0x0f50, 0x0f60, 0x0f70,
+    0x0f80, 0x0f90, 0x0fa0, 0x0fb0, 0x0fc0, 0x0fd0, 0x0fe0, 0x0ff0
+  }};
+
+const unsigned short int golay2412_dec_gentab[4096] = {
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0a20,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0081,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0002,
+    0x0000, 0x0000, 0x0000, 0x0004, 0x0000, 0x0510, 0x0048, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x010c,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0002,
+    0x0000, 0x0000, 0x0000, 0x0400, 0x0000, 0x0041, 0x0090, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0002,
+    0x0000, 0x0000, 0x0000, 0x0070, 0x0000, 0x0800, 0x0600, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0002, 0x0000, 0x0002, 0x0002, 0x0002,
+    0x0000, 0x0288, 0x0901, 0x0000, 0x0024, 0x0000, 0x0000, 0x0002,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0101,
+    0x0000, 0x0000, 0x0000, 0x0400, 0x0000, 0x0086, 0x0048, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0424,
+    0x0000, 0x0000, 0x0000, 0x0302, 0x0000, 0x0800, 0x0048, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0890, 0x0000, 0x0200, 0x0048, 0x0000,
+    0x0000, 0x0021, 0x0048, 0x0000, 0x0048, 0x0000, 0x0048, 0x0048,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x02c0,
+    0x0000, 0x0000, 0x0000, 0x0400, 0x0000, 0x0800, 0x0023, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0400, 0x0000, 0x0038, 0x0804, 0x0000,
+    0x0000, 0x0400, 0x0400, 0x0400, 0x0300, 0x0000, 0x0000, 0x0400,
+    0x0000, 0x0000, 0x0000, 0x0009, 0x0000, 0x0800, 0x0110, 0x0000,
+    0x0000, 0x0800, 0x0084, 0x0000, 0x0800, 0x0800, 0x0000, 0x0800,
+    0x0000, 0x0144, 0x0220, 0x0000, 0x0481, 0x0000, 0x0000, 0x0002,
+    0x0012, 0x0000, 0x0000, 0x0400, 0x0000, 0x0800, 0x0048, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0081,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0054,
+    0x0000, 0x0000, 0x0000, 0x0400, 0x0000, 0x0008, 0x0102, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0081,
+    0x0000, 0x0000, 0x0000, 0x0081, 0x0000, 0x0081, 0x0081, 0x0081,
+    0x0000, 0x0000, 0x0000, 0x0128, 0x0000, 0x0200, 0x0c00, 0x0000,
+    0x0000, 0x0842, 0x0210, 0x0000, 0x0024, 0x0000, 0x0000, 0x0081,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0020,
+    0x0000, 0x0000, 0x0000, 0x0400, 0x0000, 0x0212, 0x0840, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0400, 0x0000, 0x0980, 0x0209, 0x0000,
+    0x0000, 0x0400, 0x0400, 0x0400, 0x0024, 0x0000, 0x0000, 0x0400,
+    0x0000, 0x0000, 0x0000, 0x0a04, 0x0000, 0x0448, 0x0110, 0x0000,
+    0x0000, 0x0100, 0x000a, 0x0000, 0x0024, 0x0000, 0x0000, 0x0081,
+    0x0000, 0x0011, 0x00c0, 0x0000, 0x0024, 0x0000, 0x0000, 0x0002,
+    0x0024, 0x0000, 0x0000, 0x0400, 0x0024, 0x0024, 0x0024, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x080a,
+    0x0000, 0x0000, 0x0000, 0x0400, 0x0000, 0x0160, 0x0204, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0400, 0x0000, 0x0200, 0x00a0, 0x0000,
+    0x0000, 0x0400, 0x0400, 0x0400, 0x0811, 0x0000, 0x0000, 0x0400,
+    0x0000, 0x0000, 0x0000, 0x0040, 0x0000, 0x0200, 0x0110, 0x0000,
+    0x0000, 0x001c, 0x0820, 0x0000, 0x0402, 0x0000, 0x0000, 0x0081,
+    0x0000, 0x0200, 0x0007, 0x0000, 0x0200, 0x0200, 0x0000, 0x0200,
+    0x0180, 0x0000, 0x0000, 0x0400, 0x0000, 0x0200, 0x0048, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0400, 0x0000, 0x0005, 0x0110, 0x0000,
+    0x0000, 0x0400, 0x0400, 0x0400, 0x0088, 0x0000, 0x0000, 0x0400,
+    0x0000, 0x0400, 0x0400, 0x0400, 0x0042, 0x0000, 0x0000, 0x0400,
+    0x0400, 0x0400, 0x0400, 0x0400, 0x0000, 0x0400, 0x0400, 0x0400,
+    0x0000, 0x00a2, 0x0110, 0x0000, 0x0110, 0x0000, 0x0110, 0x0110,
+    0x0241, 0x0000, 0x0000, 0x0400, 0x0000, 0x0800, 0x0110, 0x0000,
+    0x0808, 0x0000, 0x0000, 0x0400, 0x0000, 0x0200, 0x0110, 0x0000,
+    0x0000, 0x0400, 0x0400, 0x0400, 0x0024, 0x0000, 0x0000, 0x0400,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0488,
+    0x0000, 0x0000, 0x0000, 0x0004, 0x0000, 0x0041, 0x0102, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0940,
+    0x0000, 0x0000, 0x0000, 0x0004, 0x0000, 0x002a, 0x0600, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0004, 0x0000, 0x0200, 0x0031, 0x0000,
+    0x0000, 0x0004, 0x0004, 0x0004, 0x0880, 0x0000, 0x0000, 0x0004,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0020,
+    0x0000, 0x0000, 0x0000, 0x0882, 0x0000, 0x0041, 0x0600, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0310, 0x0000, 0x0041, 0x0804, 0x0000,
+    0x0000, 0x0041, 0x0028, 0x0000, 0x0041, 0x0041, 0x0000, 0x0041,
+    0x0000, 0x0000, 0x0000, 0x0009, 0x0000, 0x0094, 0x0600, 0x0000,
+    0x0000, 0x0100, 0x0600, 0x0000, 0x0600, 0x0000, 0x0600, 0x0600,
+    0x0000, 0x0c20, 0x00c0, 0x0000, 0x0108, 0x0000, 0x0000, 0x0002,
+    0x0012, 0x0000, 0x0000, 0x0004, 0x0000, 0x0041, 0x0600, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0000, 0x0000, 0x0010, 0x0000, 0x0010, 0x0010, 0x0010,
+    0x0000, 0x0000, 0x0000, 0x0062, 0x0000, 0x0200, 0x0804, 0x0000,
+    0x0000, 0x0908, 0x0281, 0x0000, 0x0420, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0000, 0x0000, 0x0009, 0x0000, 0x0200, 0x0082, 0x0000,
+    0x0000, 0x04c0, 0x0820, 0x0000, 0x0105, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0200, 0x0500, 0x0000, 0x0200, 0x0200, 0x0000, 0x0200,
+    0x0012, 0x0000, 0x0000, 0x0004, 0x0000, 0x0200, 0x0048, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0009, 0x0000, 0x0502, 0x0804, 0x0000,
+    0x0000, 0x0224, 0x0140, 0x0000, 0x0088, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0080, 0x0804, 0x0000, 0x0804, 0x0000, 0x0804, 0x0804,
+    0x0012, 0x0000, 0x0000, 0x0400, 0x0000, 0x0041, 0x0804, 0x0000,
+    0x0000, 0x0009, 0x0009, 0x0009, 0x0060, 0x0000, 0x0000, 0x0009,
+    0x0012, 0x0000, 0x0000, 0x0009, 0x0000, 0x0800, 0x0600, 0x0000,
+    0x0012, 0x0000, 0x0000, 0x0009, 0x0000, 0x0200, 0x0804, 0x0000,
+    0x0012, 0x0012, 0x0012, 0x0000, 0x0012, 0x0000, 0x0000, 0x01a0,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0020,
+    0x0000, 0x0000, 0x0000, 0x0248, 0x0000, 0x0c04, 0x0102, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0801, 0x0000, 0x0200, 0x0102, 0x0000,
+    0x0000, 0x00b0, 0x0102, 0x0000, 0x0102, 0x0000, 0x0102, 0x0102,
+    0x0000, 0x0000, 0x0000, 0x0412, 0x0000, 0x0200, 0x000c, 0x0000,
+    0x0000, 0x0100, 0x0820, 0x0000, 0x0050, 0x0000, 0x0000, 0x0081,
+    0x0000, 0x0200, 0x00c0, 0x0000, 0x0200, 0x0200, 0x0000, 0x0200,
+    0x0409, 0x0000, 0x0000, 0x0004, 0x0000, 0x0200, 0x0102, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0020, 0x0000, 0x0020, 0x0020, 0x0020,
+    0x0000, 0x0100, 0x0015, 0x0000, 0x0088, 0x0000, 0x0000, 0x0020,
+    0x0000, 0x000e, 0x00c0, 0x0000, 0x0410, 0x0000, 0x0000, 0x0020,
+    0x0a00, 0x0000, 0x0000, 0x0400, 0x0000, 0x0041, 0x0102, 0x0000,
+    0x0000, 0x0100, 0x00c0, 0x0000, 0x0803, 0x0000, 0x0000, 0x0020,
+    0x0100, 0x0100, 0x0000, 0x0100, 0x0000, 0x0100, 0x0600, 0x0000,
+    0x00c0, 0x0000, 0x00c0, 0x00c0, 0x0000, 0x0200, 0x00c0, 0x0000,
+    0x0000, 0x0100, 0x00c0, 0x0000, 0x0024, 0x0000, 0x0000, 0x0818,
+    0x0000, 0x0000, 0x0000, 0x0184, 0x0000, 0x0200, 0x0441, 0x0000,
+    0x0000, 0x0003, 0x0820, 0x0000, 0x0088, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0200, 0x0018, 0x0000, 0x0200, 0x0200, 0x0000, 0x0200,
+    0x0044, 0x0000, 0x0000, 0x0400, 0x0000, 0x0200, 0x0102, 0x0000,
+    0x0000, 0x0200, 0x0820, 0x0000, 0x0200, 0x0200, 0x0000, 0x0200,
+    0x0820, 0x0000, 0x0820, 0x0820, 0x0000, 0x0200, 0x0820, 0x0000,
+    0x0200, 0x0200, 0x0000, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200,
+    0x0000, 0x0200, 0x0820, 0x0000, 0x0200, 0x0200, 0x0000, 0x0200,
+    0x0000, 0x0850, 0x0202, 0x0000, 0x0088, 0x0000, 0x0000, 0x0020,
+    0x0088, 0x0000, 0x0000, 0x0400, 0x0088, 0x0088, 0x0088, 0x0000,
+    0x0121, 0x0000, 0x0000, 0x0400, 0x0000, 0x0200, 0x0804, 0x0000,
+    0x0000, 0x0400, 0x0400, 0x0400, 0x0088, 0x0000, 0x0000, 0x0400,
+    0x0404, 0x0000, 0x0000, 0x0009, 0x0000, 0x0200, 0x0110, 0x0000,
+    0x0000, 0x0100, 0x0820, 0x0000, 0x0088, 0x0000, 0x0000, 0x0046,
+    0x0000, 0x0200, 0x00c0, 0x0000, 0x0200, 0x0200, 0x0000, 0x0200,
+    0x0012, 0x0000, 0x0000, 0x0400, 0x0000, 0x0200, 0x0001, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0002,
+    0x0000, 0x0000, 0x0000, 0x01c0, 0x0000, 0x0008, 0x0405, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0002,
+    0x0000, 0x0000, 0x0000, 0x0c08, 0x0000, 0x0244, 0x0120, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0002, 0x0000, 0x0002, 0x0002, 0x0002,
+    0x0000, 0x0021, 0x0210, 0x0000, 0x0880, 0x0000, 0x0000, 0x0002,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0002,
+    0x0000, 0x0000, 0x0000, 0x0201, 0x0000, 0x04a0, 0x0840, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0002, 0x0000, 0x0002, 0x0002, 0x0002,
+    0x0000, 0x0814, 0x0028, 0x0000, 0x0300, 0x0000, 0x0000, 0x0002,
+    0x0000, 0x0000, 0x0000, 0x0002, 0x0000, 0x0002, 0x0002, 0x0002,
+    0x0000, 0x0100, 0x0084, 0x0000, 0x0019, 0x0000, 0x0000, 0x0002,
+    0x0000, 0x0002, 0x0002, 0x0002, 0x0002, 0x0002, 0x0002, 0x0002,
+    0x0440, 0x0000, 0x0000, 0x0002, 0x0000, 0x0002, 0x0002, 0x0002,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0000, 0x0000, 0x0010, 0x0000, 0x0010, 0x0010, 0x0010,
+    0x0000, 0x0000, 0x0000, 0x020c, 0x0000, 0x0c40, 0x00a0, 0x0000,
+    0x0000, 0x0021, 0x0802, 0x0000, 0x0300, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0000, 0x0000, 0x0040, 0x0000, 0x0188, 0x0a01, 0x0000,
+    0x0000, 0x0021, 0x0084, 0x0000, 0x0402, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0021, 0x0500, 0x0000, 0x0014, 0x0000, 0x0000, 0x0002,
+    0x0021, 0x0021, 0x0000, 0x0021, 0x0000, 0x0021, 0x0048, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0920, 0x0000, 0x0005, 0x0408, 0x0000,
+    0x0000, 0x004a, 0x0084, 0x0000, 0x0300, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0080, 0x0051, 0x0000, 0x0300, 0x0000, 0x0000, 0x0002,
+    0x0300, 0x0000, 0x0000, 0x0400, 0x0300, 0x0300, 0x0300, 0x0000,
+    0x0000, 0x0610, 0x0084, 0x0000, 0x0060, 0x0000, 0x0000, 0x0002,
+    0x0084, 0x0000, 0x0084, 0x0084, 0x0000, 0x0800, 0x0084, 0x0000,
+    0x0808, 0x0000, 0x0000, 0x0002, 0x0000, 0x0002, 0x0002, 0x0002,
+    0x0000, 0x0021, 0x0084, 0x0000, 0x0300, 0x0000, 0x0000, 0x0002,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0700,
+    0x0000, 0x0000, 0x0000, 0x0026, 0x0000, 0x0008, 0x0840, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0801, 0x0000, 0x0008, 0x00a0, 0x0000,
+    0x0000, 0x0008, 0x0210, 0x0000, 0x0008, 0x0008, 0x0000, 0x0008,
+    0x0000, 0x0000, 0x0000, 0x0040, 0x0000, 0x0830, 0x000c, 0x0000,
+    0x0000, 0x0100, 0x0210, 0x0000, 0x0402, 0x0000, 0x0000, 0x0081,
+    0x0000, 0x0484, 0x0210, 0x0000, 0x0141, 0x0000, 0x0000, 0x0002,
+    0x0210, 0x0000, 0x0210, 0x0210, 0x0000, 0x0008, 0x0210, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0098, 0x0000, 0x0005, 0x0840, 0x0000,
+    0x0000, 0x0100, 0x0840, 0x0000, 0x0840, 0x0000, 0x0840, 0x0840,
+    0x0000, 0x0260, 0x0104, 0x0000, 0x0410, 0x0000, 0x0000, 0x0002,
+    0x0083, 0x0000, 0x0000, 0x0400, 0x0000, 0x0008, 0x0840, 0x0000,
+    0x0000, 0x0100, 0x0421, 0x0000, 0x0280, 0x0000, 0x0000, 0x0002,
+    0x0100, 0x0100, 0x0000, 0x0100, 0x0000, 0x0100, 0x0840, 0x0000,
+    0x0808, 0x0000, 0x0000, 0x0002, 0x0000, 0x0002, 0x0002, 0x0002,
+    0x0000, 0x0100, 0x0210, 0x0000, 0x0024, 0x0000, 0x0000, 0x0002,
+    0x0000, 0x0000, 0x0000, 0x0040, 0x0000, 0x0005, 0x00a0, 0x0000,
+    0x0000, 0x0a80, 0x0109, 0x0000, 0x0402, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0112, 0x00a0, 0x0000, 0x00a0, 0x0000, 0x00a0, 0x00a0,
+    0x0044, 0x0000, 0x0000, 0x0400, 0x0000, 0x0008, 0x00a0, 0x0000,
+    0x0000, 0x0040, 0x0040, 0x0040, 0x0402, 0x0000, 0x0000, 0x0040,
+    0x0402, 0x0000, 0x0000, 0x0040, 0x0402, 0x0402, 0x0402, 0x0000,
+    0x0808, 0x0000, 0x0000, 0x0040, 0x0000, 0x0200, 0x00a0, 0x0000,
+    0x0000, 0x0021, 0x0210, 0x0000, 0x0402, 0x0000, 0x0000, 0x0904,
+    0x0000, 0x0005, 0x0202, 0x0000, 0x0005, 0x0005, 0x0000, 0x0005,
+    0x0030, 0x0000, 0x0000, 0x0400, 0x0000, 0x0005, 0x0840, 0x0000,
+    0x0808, 0x0000, 0x0000, 0x0400, 0x0000, 0x0005, 0x00a0, 0x0000,
+    0x0000, 0x0400, 0x0400, 0x0400, 0x0300, 0x0000, 0x0000, 0x0400,
+    0x0808, 0x0000, 0x0000, 0x0040, 0x0000, 0x0005, 0x0110, 0x0000,
+    0x0000, 0x0100, 0x0084, 0x0000, 0x0402, 0x0000, 0x0000, 0x0228,
+    0x0808, 0x0808, 0x0808, 0x0000, 0x0808, 0x0000, 0x0000, 0x0002,
+    0x0808, 0x0000, 0x0000, 0x0400, 0x0000, 0x00d0, 0x0001, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0000, 0x0000, 0x0010, 0x0000, 0x0010, 0x0010, 0x0010,
+    0x0000, 0x0000, 0x0000, 0x0801, 0x0000, 0x0124, 0x0240, 0x0000,
+    0x0000, 0x0602, 0x0028, 0x0000, 0x0880, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0000, 0x0000, 0x02a0, 0x0000, 0x0401, 0x000c, 0x0000,
+    0x0000, 0x0100, 0x0043, 0x0000, 0x0880, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0058, 0x0500, 0x0000, 0x0880, 0x0000, 0x0000, 0x0002,
+    0x0880, 0x0000, 0x0000, 0x0004, 0x0880, 0x0880, 0x0880, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0444, 0x0000, 0x0a08, 0x0181, 0x0000,
+    0x0000, 0x0100, 0x0028, 0x0000, 0x0006, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0080, 0x0028, 0x0000, 0x0410, 0x0000, 0x0000, 0x0002,
+    0x0028, 0x0000, 0x0028, 0x0028, 0x0000, 0x0041, 0x0028, 0x0000,
+    0x0000, 0x0100, 0x0810, 0x0000, 0x0060, 0x0000, 0x0000, 0x0002,
+    0x0100, 0x0100, 0x0000, 0x0100, 0x0000, 0x0100, 0x0600, 0x0000,
+    0x0205, 0x0000, 0x0000, 0x0002, 0x0000, 0x0002, 0x0002, 0x0002,
+    0x0000, 0x0100, 0x0028, 0x0000, 0x0880, 0x0000, 0x0000, 0x0002,
+    0x0000, 0x0000, 0x0000, 0x0010, 0x0000, 0x0010, 0x0010, 0x0010,
+    0x0000, 0x0010, 0x0010, 0x0010, 0x0010, 0x0010, 0x0010, 0x0010,
+    0x0000, 0x0080, 0x0500, 0x0000, 0x000b, 0x0000, 0x0000, 0x0010,
+    0x0044, 0x0000, 0x0000, 0x0010, 0x0000, 0x0010, 0x0010, 0x0010,
+    0x0000, 0x0806, 0x0500, 0x0000, 0x0060, 0x0000, 0x0000, 0x0010,
+    0x0208, 0x0000, 0x0000, 0x0010, 0x0000, 0x0010, 0x0010, 0x0010,
+    0x0500, 0x0000, 0x0500, 0x0500, 0x0000, 0x0200, 0x0500, 0x0000,
+    0x0000, 0x0021, 0x0500, 0x0000, 0x0880, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0080, 0x0202, 0x0000, 0x0060, 0x0000, 0x0000, 0x0010,
+    0x0c01, 0x0000, 0x0000, 0x0010, 0x0000, 0x0010, 0x0010, 0x0010,
+    0x0080, 0x0080, 0x0000, 0x0080, 0x0000, 0x0080, 0x0804, 0x0000,
+    0x0000, 0x0080, 0x0028, 0x0000, 0x0300, 0x0000, 0x0000, 0x0010,
+    0x0060, 0x0000, 0x0000, 0x0009, 0x0060, 0x0060, 0x0060, 0x0000,
+    0x0000, 0x0100, 0x0084, 0x0000, 0x0060, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0080, 0x0500, 0x0000, 0x0060, 0x0000, 0x0000, 0x0002,
+    0x0012, 0x0000, 0x0000, 0x0a40, 0x0000, 0x040c, 0x0001, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0801, 0x0000, 0x00c2, 0x000c, 0x0000,
+    0x0000, 0x0100, 0x0480, 0x0000, 0x0221, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0801, 0x0801, 0x0801, 0x0410, 0x0000, 0x0000, 0x0801,
+    0x0044, 0x0000, 0x0000, 0x0801, 0x0000, 0x0008, 0x0102, 0x0000,
+    0x0000, 0x0100, 0x000c, 0x0000, 0x000c, 0x0000, 0x000c, 0x000c,
+    0x0100, 0x0100, 0x0000, 0x0100, 0x0000, 0x0100, 0x000c, 0x0000,
+    0x0022, 0x0000, 0x0000, 0x0801, 0x0000, 0x0200, 0x000c, 0x0000,
+    0x0000, 0x0100, 0x0210, 0x0000, 0x0880, 0x0000, 0x0000, 0x0460,
+    0x0000, 0x0100, 0x0202, 0x0000, 0x0410, 0x0000, 0x0000, 0x0020,
+    0x0100, 0x0100, 0x0000, 0x0100, 0x0000, 0x0100, 0x0840, 0x0000,
+    0x0410, 0x0000, 0x0000, 0x0801, 0x0410, 0x0410, 0x0410, 0x0000,
+    0x0000, 0x0100, 0x0028, 0x0000, 0x0410, 0x0000, 0x0000, 0x0284,
+    0x0100, 0x0100, 0x0000, 0x0100, 0x0000, 0x0100, 0x000c, 0x0000,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0000, 0x0100,
+    0x0000, 0x0100, 0x00c0, 0x0000, 0x0410, 0x0000, 0x0000, 0x0002,
+    0x0100, 0x0100, 0x0000, 0x0100, 0x0000, 0x0100, 0x0001, 0x0000,
+    0x0000, 0x0428, 0x0202, 0x0000, 0x0900, 0x0000, 0x0000, 0x0010,
+    0x0044, 0x0000, 0x0000, 0x0010, 0x0000, 0x0010, 0x0010, 0x0010,
+    0x0044, 0x0000, 0x0000, 0x0801, 0x0000, 0x0200, 0x00a0, 0x0000,
+    0x0044, 0x0044, 0x0044, 0x0000, 0x0044, 0x0000, 0x0000, 0x0010,
+    0x0091, 0x0000, 0x0000, 0x0040, 0x0000, 0x0200, 0x000c, 0x0000,
+    0x0000, 0x0100, 0x0820, 0x0000, 0x0402, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0200, 0x0500, 0x0000, 0x0200, 0x0200, 0x0000, 0x0200,
+    0x0044, 0x0000, 0x0000, 0x008a, 0x0000, 0x0200, 0x0001, 0x0000,
+    0x0202, 0x0000, 0x0202, 0x0202, 0x0000, 0x0005, 0x0202, 0x0000,
+    0x0000, 0x0100, 0x0202, 0x0000, 0x0088, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0080, 0x0202, 0x0000, 0x0410, 0x0000, 0x0000, 0x0148,
+    0x0044, 0x0000, 0x0000, 0x0400, 0x0000, 0x0822, 0x0001, 0x0000,
+    0x0000, 0x0100, 0x0202, 0x0000, 0x0060, 0x0000, 0x0000, 0x0c80,
+    0x0100, 0x0100, 0x0000, 0x0100, 0x0000, 0x0100, 0x0001, 0x0000,
+    0x0808, 0x0000, 0x0000, 0x0034, 0x0000, 0x0200, 0x0001, 0x0000,
+    0x0000, 0x0100, 0x0001, 0x0000, 0x0001, 0x0000, 0x0001, 0x0001,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0442,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0101,
+    0x0000, 0x0000, 0x0000, 0x0004, 0x0000, 0x0008, 0x0090, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0218,
+    0x0000, 0x0000, 0x0000, 0x0004, 0x0000, 0x0800, 0x0120, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0004, 0x0000, 0x00e0, 0x0c00, 0x0000,
+    0x0000, 0x0004, 0x0004, 0x0004, 0x0203, 0x0000, 0x0000, 0x0004,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0020,
+    0x0000, 0x0000, 0x0000, 0x0201, 0x0000, 0x0800, 0x0090, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0848, 0x0000, 0x0604, 0x0090, 0x0000,
+    0x0000, 0x0122, 0x0090, 0x0000, 0x0090, 0x0000, 0x0090, 0x0090,
+    0x0000, 0x0000, 0x0000, 0x0580, 0x0000, 0x0800, 0x0045, 0x0000,
+    0x0000, 0x0800, 0x000a, 0x0000, 0x0800, 0x0800, 0x0000, 0x0800,
+    0x0000, 0x0011, 0x0220, 0x0000, 0x0108, 0x0000, 0x0000, 0x0002,
+    0x0440, 0x0000, 0x0000, 0x0004, 0x0000, 0x0800, 0x0090, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0101,
+    0x0000, 0x0000, 0x0000, 0x00a8, 0x0000, 0x0800, 0x0204, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0101, 0x0000, 0x0101, 0x0101, 0x0101,
+    0x0000, 0x0250, 0x0802, 0x0000, 0x0420, 0x0000, 0x0000, 0x0101,
+    0x0000, 0x0000, 0x0000, 0x0040, 0x0000, 0x0800, 0x0082, 0x0000,
+    0x0000, 0x0800, 0x0411, 0x0000, 0x0800, 0x0800, 0x0000, 0x0800,
+    0x0000, 0x040a, 0x0220, 0x0000, 0x0014, 0x0000, 0x0000, 0x0101,
+    0x0180, 0x0000, 0x0000, 0x0004, 0x0000, 0x0800, 0x0048, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0016, 0x0000, 0x0800, 0x0408, 0x0000,
+    0x0000, 0x0800, 0x0140, 0x0000, 0x0800, 0x0800, 0x0000, 0x0800,
+    0x0000, 0x0080, 0x0220, 0x0000, 0x0042, 0x0000, 0x0000, 0x0101,
+    0x000d, 0x0000, 0x0000, 0x0400, 0x0000, 0x0800, 0x0090, 0x0000,
+    0x0000, 0x0800, 0x0220, 0x0000, 0x0800, 0x0800, 0x0000, 0x0800,
+    0x0800, 0x0800, 0x0000, 0x0800, 0x0800, 0x0800, 0x0800, 0x0800,
+    0x0220, 0x0000, 0x0220, 0x0220, 0x0000, 0x0800, 0x0220, 0x0000,
+    0x0000, 0x0800, 0x0220, 0x0000, 0x0800, 0x0800, 0x0000, 0x0800,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0020,
+    0x0000, 0x0000, 0x0000, 0x0910, 0x0000, 0x0008, 0x0204, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0282, 0x0000, 0x0008, 0x0c00, 0x0000,
+    0x0000, 0x0008, 0x0061, 0x0000, 0x0008, 0x0008, 0x0000, 0x0008,
+    0x0000, 0x0000, 0x0000, 0x0040, 0x0000, 0x0106, 0x0c00, 0x0000,
+    0x0000, 0x0620, 0x000a, 0x0000, 0x0050, 0x0000, 0x0000, 0x0081,
+    0x0000, 0x0011, 0x0c00, 0x0000, 0x0c00, 0x0000, 0x0c00, 0x0c00,
+    0x0180, 0x0000, 0x0000, 0x0004, 0x0000, 0x0008, 0x0c00, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0020, 0x0000, 0x0020, 0x0020, 0x0020,
+    0x0000, 0x00c4, 0x000a, 0x0000, 0x0501, 0x0000, 0x0000, 0x0020,
+    0x0000, 0x0011, 0x0104, 0x0000, 0x0042, 0x0000, 0x0000, 0x0020,
+    0x0a00, 0x0000, 0x0000, 0x0400, 0x0000, 0x0008, 0x0090, 0x0000,
+    0x0000, 0x0011, 0x000a, 0x0000, 0x0280, 0x0000, 0x0000, 0x0020,
+    0x000a, 0x0000, 0x000a, 0x000a, 0x0000, 0x0800, 0x000a, 0x0000,
+    0x0011, 0x0011, 0x0000, 0x0011, 0x0000, 0x0011, 0x0c00, 0x0000,
+    0x0000, 0x0011, 0x000a, 0x0000, 0x0024, 0x0000, 0x0000, 0x0340,
+    0x0000, 0x0000, 0x0000, 0x0040, 0x0000, 0x0490, 0x0204, 0x0000,
+    0x0000, 0x0003, 0x0204, 0x0000, 0x0204, 0x0000, 0x0204, 0x0204,
+    0x0000, 0x0824, 0x0018, 0x0000, 0x0042, 0x0000, 0x0000, 0x0101,
+    0x0180, 0x0000, 0x0000, 0x0400, 0x0000, 0x0008, 0x0204, 0x0000,
+    0x0000, 0x0040, 0x0040, 0x0040, 0x0029, 0x0000, 0x0000, 0x0040,
+    0x0180, 0x0000, 0x0000, 0x0040, 0x0000, 0x0800, 0x0204, 0x0000,
+    0x0180, 0x0000, 0x0000, 0x0040, 0x0000, 0x0200, 0x0c00, 0x0000,
+    0x0180, 0x0180, 0x0180, 0x0000, 0x0180, 0x0000, 0x0000, 0x0032,
+    0x0000, 0x0308, 0x0881, 0x0000, 0x0042, 0x0000, 0x0000, 0x0020,
+    0x0030, 0x0000, 0x0000, 0x0400, 0x0000, 0x0800, 0x0204, 0x0000,
+    0x0042, 0x0000, 0x0000, 0x0400, 0x0042, 0x0042, 0x0042, 0x0000,
+    0x0000, 0x0400, 0x0400, 0x0400, 0x0042, 0x0000, 0x0000, 0x0400,
+    0x0404, 0x0000, 0x0000, 0x0040, 0x0000, 0x0800, 0x0110, 0x0000,
+    0x0000, 0x0800, 0x000a, 0x0000, 0x0800, 0x0800, 0x0000, 0x0800,
+    0x0000, 0x0011, 0x0220, 0x0000, 0x0042, 0x0000, 0x0000, 0x008c,
+    0x0180, 0x0000, 0x0000, 0x0400, 0x0000, 0x0800, 0x0001, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0020,
+    0x0000, 0x0000, 0x0000, 0x0004, 0x0000, 0x0380, 0x0809, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0004, 0x0000, 0x0812, 0x0240, 0x0000,
+    0x0000, 0x0004, 0x0004, 0x0004, 0x0420, 0x0000, 0x0000, 0x0004,
+    0x0000, 0x0000, 0x0000, 0x0004, 0x0000, 0x0401, 0x0082, 0x0000,
+    0x0000, 0x0004, 0x0004, 0x0004, 0x0050, 0x0000, 0x0000, 0x0004,
+    0x0000, 0x0004, 0x0004, 0x0004, 0x0108, 0x0000, 0x0000, 0x0004,
+    0x0004, 0x0004, 0x0004, 0x0004, 0x0000, 0x0004, 0x0004, 0x0004,
+    0x0000, 0x0000, 0x0000, 0x0020, 0x0000, 0x0020, 0x0020, 0x0020,
+    0x0000, 0x0418, 0x0140, 0x0000, 0x0006, 0x0000, 0x0000, 0x0020,
+    0x0000, 0x0080, 0x0403, 0x0000, 0x0108, 0x0000, 0x0000, 0x0020,
+    0x0a00, 0x0000, 0x0000, 0x0004, 0x0000, 0x0041, 0x0090, 0x0000,
+    0x0000, 0x0242, 0x0810, 0x0000, 0x0108, 0x0000, 0x0000, 0x0020,
+    0x00a1, 0x0000, 0x0000, 0x0004, 0x0000, 0x0800, 0x0600, 0x0000,
+    0x0108, 0x0000, 0x0000, 0x0004, 0x0108, 0x0108, 0x0108, 0x0000,
+    0x0000, 0x0004, 0x0004, 0x0004, 0x0108, 0x0000, 0x0000, 0x0004,
+    0x0000, 0x0000, 0x0000, 0x0e00, 0x0000, 0x004c, 0x0082, 0x0000,
+    0x0000, 0x0003, 0x0140, 0x0000, 0x0420, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0080, 0x0018, 0x0000, 0x0420, 0x0000, 0x0000, 0x0101,
+    0x0420, 0x0000, 0x0000, 0x0004, 0x0420, 0x0420, 0x0420, 0x0000,
+    0x0000, 0x0130, 0x0082, 0x0000, 0x0082, 0x0000, 0x0082, 0x0082,
+    0x0208, 0x0000, 0x0000, 0x0004, 0x0000, 0x0800, 0x0082, 0x0000,
+    0x0841, 0x0000, 0x0000, 0x0004, 0x0000, 0x0200, 0x0082, 0x0000,
+    0x0000, 0x0004, 0x0004, 0x0004, 0x0420, 0x0000, 0x0000, 0x0004,
+    0x0000, 0x0080, 0x0140, 0x0000, 0x0211, 0x0000, 0x0000, 0x0020,
+    0x0140, 0x0000, 0x0140, 0x0140, 0x0000, 0x0800, 0x0140, 0x0000,
+    0x0080, 0x0080, 0x0000, 0x0080, 0x0000, 0x0080, 0x0804, 0x0000,
+    0x0000, 0x0080, 0x0140, 0x0000, 0x0420, 0x0000, 0x0000, 0x020a,
+    0x0404, 0x0000, 0x0000, 0x0009, 0x0000, 0x0800, 0x0082, 0x0000,
+    0x0000, 0x0800, 0x0140, 0x0000, 0x0800, 0x0800, 0x0000, 0x0800,
+    0x0000, 0x0080, 0x0220, 0x0000, 0x0108, 0x0000, 0x0000, 0x0450,
+    0x0012, 0x0000, 0x0000, 0x0004, 0x0000, 0x0800, 0x0001, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0020, 0x0000, 0x0020, 0x0020, 0x0020,
+    0x0000, 0x0003, 0x0480, 0x0000, 0x0050, 0x0000, 0x0000, 0x0020,
+    0x0000, 0x0540, 0x0018, 0x0000, 0x0085, 0x0000, 0x0000, 0x0020,
+    0x0a00, 0x0000, 0x0000, 0x0004, 0x0000, 0x0008, 0x0102, 0x0000,
+    0x0000, 0x0888, 0x0301, 0x0000, 0x0050, 0x0000, 0x0000, 0x0020,
+    0x0050, 0x0000, 0x0000, 0x0004, 0x0050, 0x0050, 0x0050, 0x0000,
+    0x0022, 0x0000, 0x0000, 0x0004, 0x0000, 0x0200, 0x0c00, 0x0000,
+    0x0000, 0x0004, 0x0004, 0x0004, 0x0050, 0x0000, 0x0000, 0x0004,
+    0x0000, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    0x0a00, 0x0000, 0x0000, 0x0020, 0x0000, 0x0020, 0x0020, 0x0020,
+    0x0a00, 0x0000, 0x0000, 0x0020, 0x0000, 0x0020, 0x0020, 0x0020,
+    0x0a00, 0x0a00, 0x0a00, 0x0000, 0x0a00, 0x0000, 0x0000, 0x0020,
+    0x0404, 0x0000, 0x0000, 0x0020, 0x0000, 0x0020, 0x0020, 0x0020,
+    0x0000, 0x0100, 0x000a, 0x0000, 0x0050, 0x0000, 0x0000, 0x0020,
+    0x0000, 0x0011, 0x00c0, 0x0000, 0x0108, 0x0000, 0x0000, 0x0020,
+    0x0a00, 0x0000, 0x0000, 0x0004, 0x0000, 0x0482, 0x0001, 0x0000,
+    0x0000, 0x0003, 0x0018, 0x0000, 0x0900, 0x0000, 0x0000, 0x0020,
+    0x0003, 0x0003, 0x0000, 0x0003, 0x0000, 0x0003, 0x0204, 0x0000,
+    0x0018, 0x0000, 0x0018, 0x0018, 0x0000, 0x0200, 0x0018, 0x0000,
+    0x0000, 0x0003, 0x0018, 0x0000, 0x0420, 0x0000, 0x0000, 0x08c0,
+    0x0404, 0x0000, 0x0000, 0x0040, 0x0000, 0x0200, 0x0082, 0x0000,
+    0x0000, 0x0003, 0x0820, 0x0000, 0x0050, 0x0000, 0x0000, 0x0508,
+    0x0000, 0x0200, 0x0018, 0x0000, 0x0200, 0x0200, 0x0000, 0x0200,
+    0x0180, 0x0000, 0x0000, 0x0004, 0x0000, 0x0200, 0x0001, 0x0000,
+    0x0404, 0x0000, 0x0000, 0x0020, 0x0000, 0x0020, 0x0020, 0x0020,
+    0x0000, 0x0003, 0x0140, 0x0000, 0x0088, 0x0000, 0x0000, 0x0020,
+    0x0000, 0x0080, 0x0018, 0x0000, 0x0042, 0x0000, 0x0000, 0x0020,
+    0x0a00, 0x0000, 0x0000, 0x0400, 0x0000, 0x0114, 0x0001, 0x0000,
+    0x0404, 0x0404, 0x0404, 0x0000, 0x0404, 0x0000, 0x0000, 0x0020,
+    0x0404, 0x0000, 0x0000, 0x0290, 0x0000, 0x0800, 0x0001, 0x0000,
+    0x0404, 0x0000, 0x0000, 0x0902, 0x0000, 0x0200, 0x0001, 0x0000,
+    0x0000, 0x0068, 0x0001, 0x0000, 0x0001, 0x0000, 0x0001, 0x0001,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0884,
+    0x0000, 0x0000, 0x0000, 0x0201, 0x0000, 0x0008, 0x0120, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0430, 0x0000, 0x0008, 0x0240, 0x0000,
+    0x0000, 0x0008, 0x0802, 0x0000, 0x0008, 0x0008, 0x0000, 0x0008,
+    0x0000, 0x0000, 0x0000, 0x0040, 0x0000, 0x0401, 0x0120, 0x0000,
+    0x0000, 0x0092, 0x0120, 0x0000, 0x0120, 0x0000, 0x0120, 0x0120,
+    0x0000, 0x0b00, 0x0089, 0x0000, 0x0014, 0x0000, 0x0000, 0x0002,
+    0x0440, 0x0000, 0x0000, 0x0004, 0x0000, 0x0008, 0x0120, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0201, 0x0000, 0x0150, 0x0408, 0x0000,
+    0x0000, 0x0201, 0x0201, 0x0201, 0x0006, 0x0000, 0x0000, 0x0201,
+    0x0000, 0x0080, 0x0104, 0x0000, 0x0821, 0x0000, 0x0000, 0x0002,
+    0x0440, 0x0000, 0x0000, 0x0201, 0x0000, 0x0008, 0x0090, 0x0000,
+    0x0000, 0x002c, 0x0810, 0x0000, 0x0280, 0x0000, 0x0000, 0x0002,
+    0x0440, 0x0000, 0x0000, 0x0201, 0x0000, 0x0800, 0x0120, 0x0000,
+    0x0440, 0x0000, 0x0000, 0x0002, 0x0000, 0x0002, 0x0002, 0x0002,
+    0x0440, 0x0440, 0x0440, 0x0000, 0x0440, 0x0000, 0x0000, 0x0002,
+    0x0000, 0x0000, 0x0000, 0x0040, 0x0000, 0x0222, 0x0408, 0x0000,
+    0x0000, 0x0504, 0x0802, 0x0000, 0x00c1, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0080, 0x0802, 0x0000, 0x0014, 0x0000, 0x0000, 0x0101,
+    0x0802, 0x0000, 0x0802, 0x0802, 0x0000, 0x0008, 0x0802, 0x0000,
+    0x0000, 0x0040, 0x0040, 0x0040, 0x0014, 0x0000, 0x0000, 0x0040,
+    0x0208, 0x0000, 0x0000, 0x0040, 0x0000, 0x0800, 0x0120, 0x0000,
+    0x0014, 0x0000, 0x0000, 0x0040, 0x0014, 0x0014, 0x0014, 0x0000,
+    0x0000, 0x0021, 0x0802, 0x0000, 0x0014, 0x0000, 0x0000, 0x0680,
+    0x0000, 0x0080, 0x0408, 0x0000, 0x0408, 0x0000, 0x0408, 0x0408,
+    0x0030, 0x0000, 0x0000, 0x0201, 0x0000, 0x0800, 0x0408, 0x0000,
+    0x0080, 0x0080, 0x0000, 0x0080, 0x0000, 0x0080, 0x0408, 0x0000,
+    0x0000, 0x0080, 0x0802, 0x0000, 0x0300, 0x0000, 0x0000, 0x0064,
+    0x0103, 0x0000, 0x0000, 0x0040, 0x0000, 0x0800, 0x0408, 0x0000,
+    0x0000, 0x0800, 0x0084, 0x0000, 0x0800, 0x0800, 0x0000, 0x0800,
+    0x0000, 0x0080, 0x0220, 0x0000, 0x0014, 0x0000, 0x0000, 0x0002,
+    0x0440, 0x0000, 0x0000, 0x0118, 0x0000, 0x0800, 0x0001, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0040, 0x0000, 0x0008, 0x0013, 0x0000,
+    0x0000, 0x0008, 0x0480, 0x0000, 0x0008, 0x0008, 0x0000, 0x0008,
+    0x0000, 0x0008, 0x0104, 0x0000, 0x0008, 0x0008, 0x0000, 0x0008,
+    0x0008, 0x0008, 0x0000, 0x0008, 0x0008, 0x0008, 0x0008, 0x0008,
+    0x0000, 0x0040, 0x0040, 0x0040, 0x0280, 0x0000, 0x0000, 0x0040,
+    0x0805, 0x0000, 0x0000, 0x0040, 0x0000, 0x0008, 0x0120, 0x0000,
+    0x0022, 0x0000, 0x0000, 0x0040, 0x0000, 0x0008, 0x0c00, 0x0000,
+    0x0000, 0x0008, 0x0210, 0x0000, 0x0008, 0x0008, 0x0000, 0x0008,
+    0x0000, 0x0c02, 0x0104, 0x0000, 0x0280, 0x0000, 0x0000, 0x0020,
+    0x0030, 0x0000, 0x0000, 0x0201, 0x0000, 0x0008, 0x0840, 0x0000,
+    0x0104, 0x0000, 0x0104, 0x0104, 0x0000, 0x0008, 0x0104, 0x0000,
+    0x0000, 0x0008, 0x0104, 0x0000, 0x0008, 0x0008, 0x0000, 0x0008,
+    0x0280, 0x0000, 0x0000, 0x0040, 0x0280, 0x0280, 0x0280, 0x0000,
+    0x0000, 0x0100, 0x000a, 0x0000, 0x0280, 0x0000, 0x0000, 0x0414,
+    0x0000, 0x0011, 0x0104, 0x0000, 0x0280, 0x0000, 0x0000, 0x0002,
+    0x0440, 0x0000, 0x0000, 0x08a0, 0x0000, 0x0008, 0x0001, 0x0000,
+    0x0000, 0x0040, 0x0040, 0x0040, 0x0900, 0x0000, 0x0000, 0x0040,
+    0x0030, 0x0000, 0x0000, 0x0040, 0x0000, 0x0008, 0x0204, 0x0000,
+    0x0601, 0x0000, 0x0000, 0x0040, 0x0000, 0x0008, 0x00a0, 0x0000,
+    0x0000, 0x0008, 0x0802, 0x0000, 0x0008, 0x0008, 0x0000, 0x0008,
+    0x0040, 0x0040, 0x0040, 0x0040, 0x0000, 0x0040, 0x0040, 0x0040,
+    0x0000, 0x0040, 0x0040, 0x0040, 0x0402, 0x0000, 0x0000, 0x0040,
+    0x0000, 0x0040, 0x0040, 0x0040, 0x0014, 0x0000, 0x0000, 0x0040,
+    0x0180, 0x0000, 0x0000, 0x0040, 0x0000, 0x0008, 0x0001, 0x0000,
+    0x0030, 0x0000, 0x0000, 0x0040, 0x0000, 0x0005, 0x0408, 0x0000,
+    0x0030, 0x0030, 0x0030, 0x0000, 0x0030, 0x0000, 0x0000, 0x0182,
+    0x0000, 0x0080, 0x0104, 0x0000, 0x0042, 0x0000, 0x0000, 0x0a10,
+    0x0030, 0x0000, 0x0000, 0x0400, 0x0000, 0x0008, 0x0001, 0x0000,
+    0x0000, 0x0040, 0x0040, 0x0040, 0x0280, 0x0000, 0x0000, 0x0040,
+    0x0030, 0x0000, 0x0000, 0x0040, 0x0000, 0x0800, 0x0001, 0x0000,
+    0x0808, 0x0000, 0x0000, 0x0040, 0x0000, 0x0520, 0x0001, 0x0000,
+    0x0000, 0x0206, 0x0001, 0x0000, 0x0001, 0x0000, 0x0001, 0x0001,
+    0x0000, 0x0000, 0x0000, 0x010a, 0x0000, 0x0401, 0x0240, 0x0000,
+    0x0000, 0x0860, 0x0480, 0x0000, 0x0006, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0080, 0x0240, 0x0000, 0x0240, 0x0000, 0x0240, 0x0240,
+    0x0111, 0x0000, 0x0000, 0x0004, 0x0000, 0x0008, 0x0240, 0x0000,
+    0x0000, 0x0401, 0x0810, 0x0000, 0x0401, 0x0401, 0x0000, 0x0401,
+    0x0208, 0x0000, 0x0000, 0x0004, 0x0000, 0x0401, 0x0120, 0x0000,
+    0x0022, 0x0000, 0x0000, 0x0004, 0x0000, 0x0401, 0x0240, 0x0000,
+    0x0000, 0x0004, 0x0004, 0x0004, 0x0880, 0x0000, 0x0000, 0x0004,
+    0x0000, 0x0080, 0x0810, 0x0000, 0x0006, 0x0000, 0x0000, 0x0020,
+    0x0006, 0x0000, 0x0000, 0x0201, 0x0006, 0x0006, 0x0006, 0x0000,
+    0x0080, 0x0080, 0x0000, 0x0080, 0x0000, 0x0080, 0x0240, 0x0000,
+    0x0000, 0x0080, 0x0028, 0x0000, 0x0006, 0x0000, 0x0000, 0x0d00,
+    0x0810, 0x0000, 0x0810, 0x0810, 0x0000, 0x0401, 0x0810, 0x0000,
+    0x0000, 0x0100, 0x0810, 0x0000, 0x0006, 0x0000, 0x0000, 0x00c8,
+    0x0000, 0x0080, 0x0810, 0x0000, 0x0108, 0x0000, 0x0000, 0x0002,
+    0x0440, 0x0000, 0x0000, 0x0004, 0x0000, 0x0230, 0x0001, 0x0000,
+    0x0000, 0x0080, 0x0025, 0x0000, 0x0900, 0x0000, 0x0000, 0x0010,
+    0x0208, 0x0000, 0x0000, 0x0010, 0x0000, 0x0010, 0x0010, 0x0010,
+    0x0080, 0x0080, 0x0000, 0x0080, 0x0000, 0x0080, 0x0240, 0x0000,
+    0x0000, 0x0080, 0x0802, 0x0000, 0x0420, 0x0000, 0x0000, 0x0010,
+    0x0208, 0x0000, 0x0000, 0x0040, 0x0000, 0x0401, 0x0082, 0x0000,
+    0x0208, 0x0208, 0x0208, 0x0000, 0x0208, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0080, 0x0500, 0x0000, 0x0014, 0x0000, 0x0000, 0x0828,
+    0x0208, 0x0000, 0x0000, 0x0004, 0x0000, 0x0142, 0x0001, 0x0000,
+    0x0080, 0x0080, 0x0000, 0x0080, 0x0000, 0x0080, 0x0408, 0x0000,
+    0x0000, 0x0080, 0x0140, 0x0000, 0x0006, 0x0000, 0x0000, 0x0010,
+    0x0080, 0x0080, 0x0080, 0x0080, 0x0080, 0x0080, 0x0000, 0x0080,
+    0x0080, 0x0080, 0x0000, 0x0080, 0x0000, 0x0080, 0x0001, 0x0000,
+    0x0000, 0x0080, 0x0810, 0x0000, 0x0060, 0x0000, 0x0000, 0x0304,
+    0x0208, 0x0000, 0x0000, 0x0422, 0x0000, 0x0800, 0x0001, 0x0000,
+    0x0080, 0x0080, 0x0000, 0x0080, 0x0000, 0x0080, 0x0001, 0x0000,
+    0x0000, 0x0080, 0x0001, 0x0000, 0x0001, 0x0000, 0x0001, 0x0001,
+    0x0000, 0x0214, 0x0480, 0x0000, 0x0900, 0x0000, 0x0000, 0x0020,
+    0x0480, 0x0000, 0x0480, 0x0480, 0x0000, 0x0008, 0x0480, 0x0000,
+    0x0022, 0x0000, 0x0000, 0x0801, 0x0000, 0x0008, 0x0240, 0x0000,
+    0x0000, 0x0008, 0x0480, 0x0000, 0x0008, 0x0008, 0x0000, 0x0008,
+    0x0022, 0x0000, 0x0000, 0x0040, 0x0000, 0x0401, 0x000c, 0x0000,
+    0x0000, 0x0100, 0x0480, 0x0000, 0x0050, 0x0000, 0x0000, 0x0a02,
+    0x0022, 0x0022, 0x0022, 0x0000, 0x0022, 0x0000, 0x0000, 0x0190,
+    0x0022, 0x0000, 0x0000, 0x0004, 0x0000, 0x0008, 0x0001, 0x0000,
+    0x0049, 0x0000, 0x0000, 0x0020, 0x0000, 0x0020, 0x0020, 0x0020,
+    0x0000, 0x0100, 0x0480, 0x0000, 0x0006, 0x0000, 0x0000, 0x0020,
+    0x0000, 0x0080, 0x0104, 0x0000, 0x0410, 0x0000, 0x0000, 0x0020,
+    0x0a00, 0x0000, 0x0000, 0x0052, 0x0000, 0x0008, 0x0001, 0x0000,
+    0x0000, 0x0100, 0x0810, 0x0000, 0x0280, 0x0000, 0x0000, 0x0020,
+    0x0100, 0x0100, 0x0000, 0x0100, 0x0000, 0x0100, 0x0001, 0x0000,
+    0x0022, 0x0000, 0x0000, 0x0608, 0x0000, 0x0844, 0x0001, 0x0000,
+    0x0000, 0x0100, 0x0001, 0x0000, 0x0001, 0x0000, 0x0001, 0x0001,
+    0x0900, 0x0000, 0x0000, 0x0040, 0x0900, 0x0900, 0x0900, 0x0000,
+    0x0000, 0x0003, 0x0480, 0x0000, 0x0900, 0x0000, 0x0000, 0x0010,
+    0x0000, 0x0080, 0x0018, 0x0000, 0x0900, 0x0000, 0x0000, 0x0406,
+    0x0044, 0x0000, 0x0000, 0x0320, 0x0000, 0x0008, 0x0001, 0x0000,
+    0x0000, 0x0040, 0x0040, 0x0040, 0x0900, 0x0000, 0x0000, 0x0040,
+    0x0208, 0x0000, 0x0000, 0x0040, 0x0000, 0x00a4, 0x0001, 0x0000,
+    0x0022, 0x0000, 0x0000, 0x0040, 0x0000, 0x0200, 0x0001, 0x0000,
+    0x0000, 0x0c10, 0x0001, 0x0000, 0x0001, 0x0000, 0x0001, 0x0001,
+    0x0000, 0x0080, 0x0202, 0x0000, 0x0900, 0x0000, 0x0000, 0x0020,
+    0x0030, 0x0000, 0x0000, 0x080c, 0x0000, 0x0640, 0x0001, 0x0000,
+    0x0080, 0x0080, 0x0000, 0x0080, 0x0000, 0x0080, 0x0001, 0x0000,
+    0x0000, 0x0080, 0x0001, 0x0000, 0x0001, 0x0000, 0x0001, 0x0001,
+    0x0404, 0x0000, 0x0000, 0x0040, 0x0000, 0x001a, 0x0001, 0x0000,
+    0x0000, 0x0100, 0x0001, 0x0000, 0x0001, 0x0000, 0x0001, 0x0001,
+    0x0000, 0x0080, 0x0001, 0x0000, 0x0001, 0x0000, 0x0001, 0x0001,
+    0x0001, 0x0000, 0x0001, 0x0001, 0x0001, 0x0001, 0x0001, 0x0001
+};
+
@@ -37,8 +37,16 @@
 
 #include "liquid.internal.h"
 
+#if HAVE_TMMINTRIN_H && defined __SSSE3__
+#include <tmmintrin.h>  // SSSE3
+#define FEC_HAMMING128_USE_SSSE3 1
+#else
+#define FEC_HAMMING128_USE_SSSE3 0
+#endif
+
 #define DEBUG_FEC_HAMMING128        0   // debugging flag
 #define FEC_HAMMING128_ENC_GENTAB   1   // use look-up table for encoding?
+#define FEC_HAMMING128_DEC_GENTAB   1   // use look-up table for decoding?
 
 // parity bit coverage mask for encoder (collapsed version of figure
 // above, stripping out parity bits P1, P2, P4, P8 and only including
@@ -62,6 +70,14 @@
 #define HAMMING128_S4   0x01e1  // .... 0001 1110 0001
 #define HAMMING128_S8   0x001f  // .... 0000 0001 1111
 
+// parity bits (P1,P2,P4,P8) of the lower and upper data nibbles; the
+// code is linear, so the parity of an 8-bit symbol is the exclusive or
+// of the two (used by the soft decoder)
+static const unsigned char hamming128_parity_lo[16] = {
+    0x0, 0x3, 0xd, 0xe, 0x5, 0x6, 0x8, 0xb, 0x9, 0xa, 0x4, 0x7, 0xc, 0xf, 0x1, 0x2};
+static const unsigned char hamming128_parity_hi[16] = {
+    0x0, 0xe, 0x6, 0x8, 0xa, 0x4, 0xc, 0x2, 0xc, 0x2, 0xa, 0x4, 0x6, 0x8, 0x0, 0xe};
+
 unsigned int fec_hamming128_encode_symbol(unsigned int _sym_dec)
 {
     // validate input
@@ -255,8 +271,13 @@ void fec_hamming128_decode(fec _q,
         m1 = ((r1 << 8) & 0x0f00) | ((r2     ) & 0x00ff);
 
         // decode each symbol into an 8-bit byte
+#if FEC_HAMMING128_DEC_GENTAB
+        _msg_dec[i+0] = hamming128_dec_gentab[m0];
+        _msg_dec[i+1] = hamming128_dec_gentab[m1];
+#else
         _msg_dec[i+0] = fec_hamming128_decode_symbol(m0);
         _msg_dec[i+1] = fec_hamming128_decode_symbol(m1);
+#endif
 
         j += 3;
     }
@@ -272,7 +293,11 @@ void fec_hamming128_decode(fec _q,
         m0 = ((r0 << 4) & 0x0ff0) | ((r1 >> 4) & 0x000f);
 
         // decode symbol into an 8-bit byte
+#if FEC_HAMMING128_DEC_GENTAB
+        _msg_dec[i++] = hamming128_dec_gentab[m0];
+#else
         _msg_dec[i++] = fec_hamming128_decode_symbol(m0);
+#endif
 
         j += 2;
     }
@@ -307,15 +332,8 @@ void fec_hamming128_decode_soft(fec _q,
 
     //unsigned char num_errors=0;
     for (i=0; i<_dec_msg_len; i++) {
-#if 0
-        // use true ML soft decoding: about 1.45 dB improvement in Eb/N_0 for a BER of 10^-5
-        // with a decoding complexity of 1.43M cycles/trial (64-byte block)
+        // true ML soft decoding: about 1.45 dB improvement in Eb/N_0 for a BER of 10^-5
         s = fecsoft_hamming128_decode(&_msg_enc[k]);
-#else
-        // use n-3 nearest neighbors: about 0.54 dB improvement in Eb/N_0 for a BER of 10^-5
-        // with a decoding complexity of 124k cycles/trial (64-byte block)
-        s = fecsoft_hamming128_decode_n3(&_msg_enc[k]);
-#endif
         k += 12;
 
         _msg_dec[i] = (unsigned char)(s & 0xff);
@@ -331,136 +349,154 @@ void fec_hamming128_decode_soft(fec _q,
 // internal methods
 //
 
-// soft decoding of one symbol
-// NOTE : because this method compares the received symbol to every
-//        possible (256) encoded symbols, it is painfully slow to
-//        run.
-unsigned int fecsoft_hamming128_decode(unsigned char * _soft_bits)
+#if !FEC_HAMMING128_USE_SSSE3
+// compute distance from four soft bits (most significant first) to
+// every 4-bit pattern
+static void fecsoft_hamming128_nibble(unsigned char _s0,
+                                      unsigned char _s1,
+                                      unsigned char _s2,
+                                      unsigned char _s3,
+                                      short int *   _d)
 {
-    // find symbol with minimum distance from all 2^8 possible
-    unsigned int d;             // distance metric
-    unsigned int dmin = 0;      // minimum distance
-    unsigned int s_hat = 0;     // estimated transmitted symbol
-    unsigned int c;             // encoded symbol
-
-    unsigned int s;
-    for (s=0; s<256; s++) {
-        // encode symbol
-#if FEC_HAMMING128_ENC_GENTAB
-        c = hamming128_enc_gentab[s];
-#else
-        c = fec_hamming128_encode_symbol(s);
-#endif
-
-        // compute distance metric
-        d = 0;
-        d += (c & 0x0800) ? 255 - _soft_bits[ 0] : _soft_bits[ 0];
-        d += (c & 0x0400) ? 255 - _soft_bits[ 1] : _soft_bits[ 1];
-        d += (c & 0x0200) ? 255 - _soft_bits[ 2] : _soft_bits[ 2];
-        d += (c & 0x0100) ? 255 - _soft_bits[ 3] : _soft_bits[ 3];
-        d += (c & 0x0080) ? 255 - _soft_bits[ 4] : _soft_bits[ 4];
-        d += (c & 0x0040) ? 255 - _soft_bits[ 5] : _soft_bits[ 5];
-        d += (c & 0x0020) ? 255 - _soft_bits[ 6] : _soft_bits[ 6];
-        d += (c & 0x0010) ? 255 - _soft_bits[ 7] : _soft_bits[ 7];
-        d += (c & 0x0008) ? 255 - _soft_bits[ 8] : _soft_bits[ 8];
-        d += (c & 0x0004) ? 255 - _soft_bits[ 9] : _soft_bits[ 9];
-        d += (c & 0x0002) ? 255 - _soft_bits[10] : _soft_bits[10];
-        d += (c & 0x0001) ? 255 - _soft_bits[11] : _soft_bits[11];
-
-        if (d < dmin || s==0) {
-            s_hat = s;
-            dmin = d;
-        }
+    // change in distance when setting each bit, indexed by bit value
+    short int e[9];
+    e[8] = 255 - 2*_s0;
+    e[4] = 255 - 2*_s1;
+    e[2] = 255 - 2*_s2;
+    e[1] = 255 - 2*_s3;
+
+    // all bits cleared, then set one more bit than a previous pattern
+    _d[0] = _s0 + _s1 + _s2 + _s3;
+    unsigned int x;
+    for (x=1; x<16; x++) {
+        unsigned int b = x & (~x + 1);  // least-significant bit set
+        _d[x] = _d[x ^ b] + e[b];
     }
-    return s_hat;
 }
+#endif
 
-// soft decoding of one symbol using nearest neighbors
-unsigned int fecsoft_hamming128_decode_n3(unsigned char * _soft_bits)
+#if FEC_HAMMING128_USE_SSSE3
+// compute distance from four soft bits to every 4-bit pattern, with
+// patterns 0-7 in the first register and 8-15 in the second
+static void fecsoft_hamming128_nibble_ssse3(unsigned char _s0,
+                                            unsigned char _s1,
+                                            unsigned char _s2,
+                                            unsigned char _s3,
+                                            __m128i *     _d0,
+                                            __m128i *     _d1)
 {
-    // find symbol with minimum distance from 17 nearest neighbors
-    unsigned int d;             // distance metric
-    unsigned int dmin = 0;      // minimum distance
-    unsigned int s_hat = 0;     // estimated transmitted symbol
-    unsigned int c;             // encoded symbol
-
-    // compute hard-decoded symbol
-    c = 0x0000;
-    c |= (_soft_bits[ 0] > 127) ? 0x0800 : 0;
-    c |= (_soft_bits[ 1] > 127) ? 0x0400 : 0;
-    c |= (_soft_bits[ 2] > 127) ? 0x0200 : 0;
-    c |= (_soft_bits[ 3] > 127) ? 0x0100 : 0;
-    c |= (_soft_bits[ 4] > 127) ? 0x0080 : 0;
-    c |= (_soft_bits[ 5] > 127) ? 0x0040 : 0;
-    c |= (_soft_bits[ 6] > 127) ? 0x0020 : 0;
-    c |= (_soft_bits[ 7] > 127) ? 0x0010 : 0;
-    c |= (_soft_bits[ 8] > 127) ? 0x0008 : 0;
-    c |= (_soft_bits[ 9] > 127) ? 0x0004 : 0;
-    c |= (_soft_bits[10] > 127) ? 0x0002 : 0;
-    c |= (_soft_bits[11] > 127) ? 0x0001 : 0;
-
-    // decode symbol
-    s_hat = fec_hamming128_decode_symbol(c);
-
-    // re-encode and compute distance
-#if FEC_HAMMING128_ENC_GENTAB
-    c = hamming128_enc_gentab[s_hat];
-#else
-    c = fec_hamming128_encode_symbol(s_hat);
+    // bits 2,1,0 of the pattern in each lane: flip soft bit if set
+    const __m128i m2 = _mm_set_epi16(0xff,0xff,0xff,0xff,   0,   0,   0,   0);
+    const __m128i m1 = _mm_set_epi16(0xff,0xff,   0,   0,0xff,0xff,   0,   0);
+    const __m128i m0 = _mm_set_epi16(0xff,   0,0xff,   0,0xff,   0,0xff,   0);
+    __m128i r = _mm_add_epi16(_mm_xor_si128(_mm_set1_epi16(_s1), m2),
+                              _mm_xor_si128(_mm_set1_epi16(_s2), m1));
+    r = _mm_add_epi16(r, _mm_xor_si128(_mm_set1_epi16(_s3), m0));
+
+    // bit 3 distinguishes the two registers
+    *_d0 = _mm_add_epi16(r, _mm_set1_epi16(_s0));
+    *_d1 = _mm_add_epi16(r, _mm_set1_epi16(255 - _s0));
+}
 #endif
 
-    // compute distance metric
-    d = 0;
-    d += (c & 0x0800) ? 255 - _soft_bits[ 0] : _soft_bits[ 0];
-    d += (c & 0x0400) ? 255 - _soft_bits[ 1] : _soft_bits[ 1];
-    d += (c & 0x0200) ? 255 - _soft_bits[ 2] : _soft_bits[ 2];
-    d += (c & 0x0100) ? 255 - _soft_bits[ 3] : _soft_bits[ 3];
-    d += (c & 0x0080) ? 255 - _soft_bits[ 4] : _soft_bits[ 4];
-    d += (c & 0x0040) ? 255 - _soft_bits[ 5] : _soft_bits[ 5];
-    d += (c & 0x0020) ? 255 - _soft_bits[ 6] : _soft_bits[ 6];
-    d += (c & 0x0010) ? 255 - _soft_bits[ 7] : _soft_bits[ 7];
-    d += (c & 0x0008) ? 255 - _soft_bits[ 8] : _soft_bits[ 8];
-    d += (c & 0x0004) ? 255 - _soft_bits[ 9] : _soft_bits[ 9];
-    d += (c & 0x0002) ? 255 - _soft_bits[10] : _soft_bits[10];
-    d += (c & 0x0001) ? 255 - _soft_bits[11] : _soft_bits[11];
-
-    dmin = d;
-
-    // search over 17 nearest neighbors
-    unsigned int s;
-    unsigned int i;
-    for (i=0; i<17; i++) {
-        // use look-up table for nearest neighbors
-        s = fecsoft_hamming128_n3[s_hat][i];
+// soft decoding of one symbol
+//
+// Finds the minimum distance over all 256 codewords (true ML). The
+// distance splits into independent terms for the upper data nibble,
+// the lower data nibble and the parity nibble, each of which is read
+// from a 16-entry table; the search then runs over the upper nibble
+// with all 16 values of the lower nibble in parallel.
+unsigned int fecsoft_hamming128_decode(unsigned char * _soft_bits)
+{
+    unsigned int h;             // upper data nibble
+
+    // distance tables for data bits 8,7,6,5 at positions 3,5,6,7 (dh),
+    // data bits 4,3,2,1 at positions 9,10,11,12 (dl), and parity bits
+    // P1,P2,P4,P8 at positions 1,2,4,8 (dp)
+#if FEC_HAMMING128_USE_SSSE3
+    __m128i dh0, dh1, dl0, dl1, dp0, dp1;
+    fecsoft_hamming128_nibble_ssse3(_soft_bits[2], _soft_bits[4], _soft_bits[ 5], _soft_bits[ 6], &dh0, &dh1);
+    fecsoft_hamming128_nibble_ssse3(_soft_bits[8], _soft_bits[9], _soft_bits[10], _soft_bits[11], &dl0, &dl1);
+    fecsoft_hamming128_nibble_ssse3(_soft_bits[0], _soft_bits[1], _soft_bits[ 3], _soft_bits[ 7], &dp0, &dp1);
+
+    short int dh[16];
+    _mm_storeu_si128((__m128i*)&dh[0], dh0);
+    _mm_storeu_si128((__m128i*)&dh[8], dh1);
+
+    // split parity distances (at most 4*255) into bytes for shuffling
+    const __m128i mask = _mm_set1_epi16(0x00ff);
+    __m128i vp_lo = _mm_packus_epi16(_mm_and_si128(dp0, mask), _mm_and_si128(dp1, mask));
+    __m128i vp_hi = _mm_packus_epi16(_mm_srli_epi16(dp0, 8),   _mm_srli_epi16(dp1, 8));
+    __m128i vpar  = _mm_loadu_si128((__m128i*)hamming128_parity_lo);
+
+    // per-lane minimum distance and upper nibble achieving it
+    __m128i dmin0 = _mm_set1_epi16(0x7fff);
+    __m128i dmin1 = _mm_set1_epi16(0x7fff);
+    __m128i hmin0 = _mm_setzero_si128();
+    __m128i hmin1 = _mm_setzero_si128();
+    for (h=0; h<16; h++) {
+        // parity distance for all lower nibbles
+        __m128i idx = _mm_xor_si128(vpar, _mm_set1_epi8(hamming128_parity_hi[h]));
+        __m128i plo = _mm_shuffle_epi8(vp_lo, idx);
+        __m128i phi = _mm_shuffle_epi8(vp_hi, idx);
+
+        // total distance
+        __m128i vh = _mm_set1_epi16(dh[h]);
+        __m128i d0 = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(plo,phi), dl0), vh);
+        __m128i d1 = _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(plo,phi), dl1), vh);
+
+        // retain strictly smaller distances (lowest index on ties)
+        __m128i vi = _mm_set1_epi16(h);
+        __m128i m0 = _mm_cmplt_epi16(d0, dmin0);
+        __m128i m1 = _mm_cmplt_epi16(d1, dmin1);
+        dmin0 = _mm_min_epi16(d0, dmin0);
+        dmin1 = _mm_min_epi16(d1, dmin1);
+        hmin0 = _mm_or_si128(_mm_and_si128(m0, vi), _mm_andnot_si128(m0, hmin0));
+        hmin1 = _mm_or_si128(_mm_and_si128(m1, vi), _mm_andnot_si128(m1, hmin1));
+    }
 
-        // encode symbol
-#if FEC_HAMMING128_ENC_GENTAB
-        c = hamming128_enc_gentab[s];
+    // minimum distance across lanes
+    __m128i m = _mm_min_epi16(dmin0, dmin1);
+    m = _mm_min_epi16(m, _mm_srli_si128(m, 8));
+    m = _mm_min_epi16(m, _mm_srli_si128(m, 4));
+    m = _mm_min_epi16(m, _mm_srli_si128(m, 2));
+    m = _mm_set1_epi16( (short)_mm_extract_epi16(m, 0) );
+
+    // lowest symbol achieving minimum distance
+    const __m128i none = _mm_set1_epi16(0x7fff);
+    __m128i s0 = _mm_or_si128(_mm_slli_epi16(hmin0, 4), _mm_set_epi16( 7, 6, 5, 4, 3, 2, 1, 0));
+    __m128i s1 = _mm_or_si128(_mm_slli_epi16(hmin1, 4), _mm_set_epi16(15,14,13,12,11,10, 9, 8));
+    s0 = _mm_or_si128(s0, _mm_andnot_si128(_mm_cmpeq_epi16(dmin0, m), none));
+    s1 = _mm_or_si128(s1, _mm_andnot_si128(_mm_cmpeq_epi16(dmin1, m), none));
+    __m128i s = _mm_min_epi16(s0, s1);
+    s = _mm_min_epi16(s, _mm_srli_si128(s, 8));
+    s = _mm_min_epi16(s, _mm_srli_si128(s, 4));
+    s = _mm_min_epi16(s, _mm_srli_si128(s, 2));
+    return _mm_extract_epi16(s, 0);
 #else
-        c = fec_hamming128_encode_symbol(s);
-#endif
-
-        // compute distance metric
-        d = 0;
-        d += (c & 0x0800) ? 255 - _soft_bits[ 0] : _soft_bits[ 0];
-        d += (c & 0x0400) ? 255 - _soft_bits[ 1] : _soft_bits[ 1];
-        d += (c & 0x0200) ? 255 - _soft_bits[ 2] : _soft_bits[ 2];
-        d += (c & 0x0100) ? 255 - _soft_bits[ 3] : _soft_bits[ 3];
-        d += (c & 0x0080) ? 255 - _soft_bits[ 4] : _soft_bits[ 4];
-        d += (c & 0x0040) ? 255 - _soft_bits[ 5] : _soft_bits[ 5];
-        d += (c & 0x0020) ? 255 - _soft_bits[ 6] : _soft_bits[ 6];
-        d += (c & 0x0010) ? 255 - _soft_bits[ 7] : _soft_bits[ 7];
-        d += (c & 0x0008) ? 255 - _soft_bits[ 8] : _soft_bits[ 8];
-        d += (c & 0x0004) ? 255 - _soft_bits[ 9] : _soft_bits[ 9];
-        d += (c & 0x0002) ? 255 - _soft_bits[10] : _soft_bits[10];
-        d += (c & 0x0001) ? 255 - _soft_bits[11] : _soft_bits[11];
-
-        if (d < dmin) {
-            s_hat = s;
-            dmin = d;
+    short int dh[16];
+    short int dl[16];
+    short int dp[16];
+    fecsoft_hamming128_nibble(_soft_bits[2], _soft_bits[4], _soft_bits[ 5], _soft_bits[ 6], dh);
+    fecsoft_hamming128_nibble(_soft_bits[8], _soft_bits[9], _soft_bits[10], _soft_bits[11], dl);
+    fecsoft_hamming128_nibble(_soft_bits[0], _soft_bits[1], _soft_bits[ 3], _soft_bits[ 7], dp);
+
+    unsigned int l;             // lower data nibble
+    unsigned int d;             // distance metric
+    unsigned int dmin = 0;      // minimum distance
+    unsigned int s_hat = 0;     // estimated transmitted symbol
+    for (h=0; h<16; h++) {
+        for (l=0; l<16; l++) {
+            // compute distance metric
+            d = dh[h] + dl[l] + dp[hamming128_parity_hi[h] ^ hamming128_parity_lo[l]];
+
+            if (d < dmin || (h==0 && l==0)) {
+                s_hat = (h << 4) | l;
+                dmin = d;
+            }
         }
     }
-
     return s_hat;
+#endif
 }
 
@@ -59,262 +59,263 @@ unsigned short int hamming128_enc_gentab[256] = {
     0x0fe0, 0x0ef1, 0x03f2, 0x02e3, 0x0bf4, 0x0ae5, 0x07e6, 0x06f7, 
     0x07f8, 0x06e9, 0x0bea, 0x0afb, 0x03ec, 0x02fd, 0x0ffe, 0x0eef};
 
-// nearest neighbors with Hamming distance 3 (for soft decoding)
-unsigned char fecsoft_hamming128_n3[256][17] = {
-    {0x01, 0x04, 0x06, 0x08, 0x0a, 0x13, 0x20, 0x25, 0x30, 0x40, 0x49, 0x50, 0x80, 0x82, 0x8c, 0x90, 0xe0},
-    {0x00, 0x05, 0x07, 0x09, 0x0b, 0x12, 0x21, 0x24, 0x31, 0x41, 0x48, 0x51, 0x81, 0x83, 0x8d, 0x91, 0xe1},
-    {0x03, 0x04, 0x06, 0x08, 0x0a, 0x11, 0x22, 0x27, 0x32, 0x42, 0x4b, 0x52, 0x80, 0x82, 0x8e, 0x92, 0xe2},
-    {0x02, 0x05, 0x07, 0x09, 0x0b, 0x10, 0x23, 0x26, 0x33, 0x43, 0x4a, 0x53, 0x81, 0x83, 0x8f, 0x93, 0xe3},
-    {0x00, 0x02, 0x05, 0x0c, 0x0e, 0x17, 0x21, 0x24, 0x34, 0x44, 0x4d, 0x54, 0x84, 0x86, 0x88, 0x94, 0xe4},
-    {0x01, 0x03, 0x04, 0x0d, 0x0f, 0x16, 0x20, 0x25, 0x35, 0x45, 0x4c, 0x55, 0x85, 0x87, 0x89, 0x95, 0xe5},
-    {0x00, 0x02, 0x07, 0x0c, 0x0e, 0x15, 0x23, 0x26, 0x36, 0x46, 0x4f, 0x56, 0x84, 0x86, 0x8a, 0x96, 0xe6},
-    {0x01, 0x03, 0x06, 0x0d, 0x0f, 0x14, 0x22, 0x27, 0x37, 0x47, 0x4e, 0x57, 0x85, 0x87, 0x8b, 0x97, 0xe7},
-    {0x00, 0x02, 0x09, 0x0c, 0x0e, 0x1b, 0x28, 0x2d, 0x38, 0x41, 0x48, 0x58, 0x84, 0x88, 0x8a, 0x98, 0xe8},
-    {0x01, 0x03, 0x08, 0x0d, 0x0f, 0x1a, 0x29, 0x2c, 0x39, 0x40, 0x49, 0x59, 0x85, 0x89, 0x8b, 0x99, 0xe9},
-    {0x00, 0x02, 0x0b, 0x0c, 0x0e, 0x19, 0x2a, 0x2f, 0x3a, 0x43, 0x4a, 0x5a, 0x86, 0x88, 0x8a, 0x9a, 0xea},
-    {0x01, 0x03, 0x0a, 0x0d, 0x0f, 0x18, 0x2b, 0x2e, 0x3b, 0x42, 0x4b, 0x5b, 0x87, 0x89, 0x8b, 0x9b, 0xeb},
-    {0x04, 0x06, 0x08, 0x0a, 0x0d, 0x1f, 0x29, 0x2c, 0x3c, 0x45, 0x4c, 0x5c, 0x80, 0x8c, 0x8e, 0x9c, 0xec},
-    {0x05, 0x07, 0x09, 0x0b, 0x0c, 0x1e, 0x28, 0x2d, 0x3d, 0x44, 0x4d, 0x5d, 0x81, 0x8d, 0x8f, 0x9d, 0xed},
-    {0x04, 0x06, 0x08, 0x0a, 0x0f, 0x1d, 0x2b, 0x2e, 0x3e, 0x47, 0x4e, 0x5e, 0x82, 0x8c, 0x8e, 0x9e, 0xee},
-    {0x05, 0x07, 0x09, 0x0b, 0x0e, 0x1c, 0x2a, 0x2f, 0x3f, 0x46, 0x4f, 0x5f, 0x83, 0x8d, 0x8f, 0x9f, 0xef},
-    {0x03, 0x11, 0x14, 0x16, 0x18, 0x1a, 0x20, 0x30, 0x35, 0x40, 0x50, 0x59, 0x80, 0x90, 0x92, 0x9c, 0xf0},
-    {0x02, 0x10, 0x15, 0x17, 0x19, 0x1b, 0x21, 0x31, 0x34, 0x41, 0x51, 0x58, 0x81, 0x91, 0x93, 0x9d, 0xf1},
-    {0x01, 0x13, 0x14, 0x16, 0x18, 0x1a, 0x22, 0x32, 0x37, 0x42, 0x52, 0x5b, 0x82, 0x90, 0x92, 0x9e, 0xf2},
-    {0x00, 0x12, 0x15, 0x17, 0x19, 0x1b, 0x23, 0x33, 0x36, 0x43, 0x53, 0x5a, 0x83, 0x91, 0x93, 0x9f, 0xf3},
-    {0x07, 0x10, 0x12, 0x15, 0x1c, 0x1e, 0x24, 0x31, 0x34, 0x44, 0x54, 0x5d, 0x84, 0x94, 0x96, 0x98, 0xf4},
-    {0x06, 0x11, 0x13, 0x14, 0x1d, 0x1f, 0x25, 0x30, 0x35, 0x45, 0x55, 0x5c, 0x85, 0x95, 0x97, 0x99, 0xf5},
-    {0x05, 0x10, 0x12, 0x17, 0x1c, 0x1e, 0x26, 0x33, 0x36, 0x46, 0x56, 0x5f, 0x86, 0x94, 0x96, 0x9a, 0xf6},
-    {0x04, 0x11, 0x13, 0x16, 0x1d, 0x1f, 0x27, 0x32, 0x37, 0x47, 0x57, 0x5e, 0x87, 0x95, 0x97, 0x9b, 0xf7},
-    {0x0b, 0x10, 0x12, 0x19, 0x1c, 0x1e, 0x28, 0x38, 0x3d, 0x48, 0x51, 0x58, 0x88, 0x94, 0x98, 0x9a, 0xf8},
-    {0x0a, 0x11, 0x13, 0x18, 0x1d, 0x1f, 0x29, 0x39, 0x3c, 0x49, 0x50, 0x59, 0x89, 0x95, 0x99, 0x9b, 0xf9},
-    {0x09, 0x10, 0x12, 0x1b, 0x1c, 0x1e, 0x2a, 0x3a, 0x3f, 0x4a, 0x53, 0x5a, 0x8a, 0x96, 0x98, 0x9a, 0xfa},
-    {0x08, 0x11, 0x13, 0x1a, 0x1d, 0x1f, 0x2b, 0x3b, 0x3e, 0x4b, 0x52, 0x5b, 0x8b, 0x97, 0x99, 0x9b, 0xfb},
-    {0x0f, 0x14, 0x16, 0x18, 0x1a, 0x1d, 0x2c, 0x39, 0x3c, 0x4c, 0x55, 0x5c, 0x8c, 0x90, 0x9c, 0x9e, 0xfc},
-    {0x0e, 0x15, 0x17, 0x19, 0x1b, 0x1c, 0x2d, 0x38, 0x3d, 0x4d, 0x54, 0x5d, 0x8d, 0x91, 0x9d, 0x9f, 0xfd},
-    {0x0d, 0x14, 0x16, 0x18, 0x1a, 0x1f, 0x2e, 0x3b, 0x3e, 0x4e, 0x57, 0x5e, 0x8e, 0x92, 0x9c, 0x9e, 0xfe},
-    {0x0c, 0x15, 0x17, 0x19, 0x1b, 0x1e, 0x2f, 0x3a, 0x3f, 0x4f, 0x56, 0x5f, 0x8f, 0x93, 0x9d, 0x9f, 0xff},
-    {0x00, 0x05, 0x10, 0x21, 0x24, 0x26, 0x28, 0x2a, 0x33, 0x60, 0x69, 0x70, 0xa0, 0xa2, 0xac, 0xb0, 0xc0},
-    {0x01, 0x04, 0x11, 0x20, 0x25, 0x27, 0x29, 0x2b, 0x32, 0x61, 0x68, 0x71, 0xa1, 0xa3, 0xad, 0xb1, 0xc1},
-    {0x02, 0x07, 0x12, 0x23, 0x24, 0x26, 0x28, 0x2a, 0x31, 0x62, 0x6b, 0x72, 0xa0, 0xa2, 0xae, 0xb2, 0xc2},
-    {0x03, 0x06, 0x13, 0x22, 0x25, 0x27, 0x29, 0x2b, 0x30, 0x63, 0x6a, 0x73, 0xa1, 0xa3, 0xaf, 0xb3, 0xc3},
-    {0x01, 0x04, 0x14, 0x20, 0x22, 0x25, 0x2c, 0x2e, 0x37, 0x64, 0x6d, 0x74, 0xa4, 0xa6, 0xa8, 0xb4, 0xc4},
-    {0x00, 0x05, 0x15, 0x21, 0x23, 0x24, 0x2d, 0x2f, 0x36, 0x65, 0x6c, 0x75, 0xa5, 0xa7, 0xa9, 0xb5, 0xc5},
-    {0x03, 0x06, 0x16, 0x20, 0x22, 0x27, 0x2c, 0x2e, 0x35, 0x66, 0x6f, 0x76, 0xa4, 0xa6, 0xaa, 0xb6, 0xc6},
-    {0x02, 0x07, 0x17, 0x21, 0x23, 0x26, 0x2d, 0x2f, 0x34, 0x67, 0x6e, 0x77, 0xa5, 0xa7, 0xab, 0xb7, 0xc7},
-    {0x08, 0x0d, 0x18, 0x20, 0x22, 0x29, 0x2c, 0x2e, 0x3b, 0x61, 0x68, 0x78, 0xa4, 0xa8, 0xaa, 0xb8, 0xc8},
-    {0x09, 0x0c, 0x19, 0x21, 0x23, 0x28, 0x2d, 0x2f, 0x3a, 0x60, 0x69, 0x79, 0xa5, 0xa9, 0xab, 0xb9, 0xc9},
-    {0x0a, 0x0f, 0x1a, 0x20, 0x22, 0x2b, 0x2c, 0x2e, 0x39, 0x63, 0x6a, 0x7a, 0xa6, 0xa8, 0xaa, 0xba, 0xca},
-    {0x0b, 0x0e, 0x1b, 0x21, 0x23, 0x2a, 0x2d, 0x2f, 0x38, 0x62, 0x6b, 0x7b, 0xa7, 0xa9, 0xab, 0xbb, 0xcb},
-    {0x09, 0x0c, 0x1c, 0x24, 0x26, 0x28, 0x2a, 0x2d, 0x3f, 0x65, 0x6c, 0x7c, 0xa0, 0xac, 0xae, 0xbc, 0xcc},
-    {0x08, 0x0d, 0x1d, 0x25, 0x27, 0x29, 0x2b, 0x2c, 0x3e, 0x64, 0x6d, 0x7d, 0xa1, 0xad, 0xaf, 0xbd, 0xcd},
-    {0x0b, 0x0e, 0x1e, 0x24, 0x26, 0x28, 0x2a, 0x2f, 0x3d, 0x67, 0x6e, 0x7e, 0xa2, 0xac, 0xae, 0xbe, 0xce},
-    {0x0a, 0x0f, 0x1f, 0x25, 0x27, 0x29, 0x2b, 0x2e, 0x3c, 0x66, 0x6f, 0x7f, 0xa3, 0xad, 0xaf, 0xbf, 0xcf},
-    {0x00, 0x10, 0x15, 0x23, 0x31, 0x34, 0x36, 0x38, 0x3a, 0x60, 0x70, 0x79, 0xa0, 0xb0, 0xb2, 0xbc, 0xd0},
-    {0x01, 0x11, 0x14, 0x22, 0x30, 0x35, 0x37, 0x39, 0x3b, 0x61, 0x71, 0x78, 0xa1, 0xb1, 0xb3, 0xbd, 0xd1},
-    {0x02, 0x12, 0x17, 0x21, 0x33, 0x34, 0x36, 0x38, 0x3a, 0x62, 0x72, 0x7b, 0xa2, 0xb0, 0xb2, 0xbe, 0xd2},
-    {0x03, 0x13, 0x16, 0x20, 0x32, 0x35, 0x37, 0x39, 0x3b, 0x63, 0x73, 0x7a, 0xa3, 0xb1, 0xb3, 0xbf, 0xd3},
-    {0x04, 0x11, 0x14, 0x27, 0x30, 0x32, 0x35, 0x3c, 0x3e, 0x64, 0x74, 0x7d, 0xa4, 0xb4, 0xb6, 0xb8, 0xd4},
-    {0x05, 0x10, 0x15, 0x26, 0x31, 0x33, 0x34, 0x3d, 0x3f, 0x65, 0x75, 0x7c, 0xa5, 0xb5, 0xb7, 0xb9, 0xd5},
-    {0x06, 0x13, 0x16, 0x25, 0x30, 0x32, 0x37, 0x3c, 0x3e, 0x66, 0x76, 0x7f, 0xa6, 0xb4, 0xb6, 0xba, 0xd6},
-    {0x07, 0x12, 0x17, 0x24, 0x31, 0x33, 0x36, 0x3d, 0x3f, 0x67, 0x77, 0x7e, 0xa7, 0xb5, 0xb7, 0xbb, 0xd7},
-    {0x08, 0x18, 0x1d, 0x2b, 0x30, 0x32, 0x39, 0x3c, 0x3e, 0x68, 0x71, 0x78, 0xa8, 0xb4, 0xb8, 0xba, 0xd8},
-    {0x09, 0x19, 0x1c, 0x2a, 0x31, 0x33, 0x38, 0x3d, 0x3f, 0x69, 0x70, 0x79, 0xa9, 0xb5, 0xb9, 0xbb, 0xd9},
-    {0x0a, 0x1a, 0x1f, 0x29, 0x30, 0x32, 0x3b, 0x3c, 0x3e, 0x6a, 0x73, 0x7a, 0xaa, 0xb6, 0xb8, 0xba, 0xda},
-    {0x0b, 0x1b, 0x1e, 0x28, 0x31, 0x33, 0x3a, 0x3d, 0x3f, 0x6b, 0x72, 0x7b, 0xab, 0xb7, 0xb9, 0xbb, 0xdb},
-    {0x0c, 0x19, 0x1c, 0x2f, 0x34, 0x36, 0x38, 0x3a, 0x3d, 0x6c, 0x75, 0x7c, 0xac, 0xb0, 0xbc, 0xbe, 0xdc},
-    {0x0d, 0x18, 0x1d, 0x2e, 0x35, 0x37, 0x39, 0x3b, 0x3c, 0x6d, 0x74, 0x7d, 0xad, 0xb1, 0xbd, 0xbf, 0xdd},
-    {0x0e, 0x1b, 0x1e, 0x2d, 0x34, 0x36, 0x38, 0x3a, 0x3f, 0x6e, 0x77, 0x7e, 0xae, 0xb2, 0xbc, 0xbe, 0xde},
-    {0x0f, 0x1a, 0x1f, 0x2c, 0x35, 0x37, 0x39, 0x3b, 0x3e, 0x6f, 0x76, 0x7f, 0xaf, 0xb3, 0xbd, 0xbf, 0xdf},
-    {0x00, 0x09, 0x10, 0x41, 0x44, 0x46, 0x48, 0x4a, 0x53, 0x60, 0x65, 0x70, 0xa0, 0xc0, 0xc2, 0xcc, 0xd0},
-    {0x01, 0x08, 0x11, 0x40, 0x45, 0x47, 0x49, 0x4b, 0x52, 0x61, 0x64, 0x71, 0xa1, 0xc1, 0xc3, 0xcd, 0xd1},
-    {0x02, 0x0b, 0x12, 0x43, 0x44, 0x46, 0x48, 0x4a, 0x51, 0x62, 0x67, 0x72, 0xa2, 0xc0, 0xc2, 0xce, 0xd2},
-    {0x03, 0x0a, 0x13, 0x42, 0x45, 0x47, 0x49, 0x4b, 0x50, 0x63, 0x66, 0x73, 0xa3, 0xc1, 0xc3, 0xcf, 0xd3},
-    {0x04, 0x0d, 0x14, 0x40, 0x42, 0x45, 0x4c, 0x4e, 0x57, 0x61, 0x64, 0x74, 0xa4, 0xc4, 0xc6, 0xc8, 0xd4},
-    {0x05, 0x0c, 0x15, 0x41, 0x43, 0x44, 0x4d, 0x4f, 0x56, 0x60, 0x65, 0x75, 0xa5, 0xc5, 0xc7, 0xc9, 0xd5},
-    {0x06, 0x0f, 0x16, 0x40, 0x42, 0x47, 0x4c, 0x4e, 0x55, 0x63, 0x66, 0x76, 0xa6, 0xc4, 0xc6, 0xca, 0xd6},
-    {0x07, 0x0e, 0x17, 0x41, 0x43, 0x46, 0x4d, 0x4f, 0x54, 0x62, 0x67, 0x77, 0xa7, 0xc5, 0xc7, 0xcb, 0xd7},
-    {0x01, 0x08, 0x18, 0x40, 0x42, 0x49, 0x4c, 0x4e, 0x5b, 0x68, 0x6d, 0x78, 0xa8, 0xc4, 0xc8, 0xca, 0xd8},
-    {0x00, 0x09, 0x19, 0x41, 0x43, 0x48, 0x4d, 0x4f, 0x5a, 0x69, 0x6c, 0x79, 0xa9, 0xc5, 0xc9, 0xcb, 0xd9},
-    {0x03, 0x0a, 0x1a, 0x40, 0x42, 0x4b, 0x4c, 0x4e, 0x59, 0x6a, 0x6f, 0x7a, 0xaa, 0xc6, 0xc8, 0xca, 0xda},
-    {0x02, 0x0b, 0x1b, 0x41, 0x43, 0x4a, 0x4d, 0x4f, 0x58, 0x6b, 0x6e, 0x7b, 0xab, 0xc7, 0xc9, 0xcb, 0xdb},
-    {0x05, 0x0c, 0x1c, 0x44, 0x46, 0x48, 0x4a, 0x4d, 0x5f, 0x69, 0x6c, 0x7c, 0xac, 0xc0, 0xcc, 0xce, 0xdc},
-    {0x04, 0x0d, 0x1d, 0x45, 0x47, 0x49, 0x4b, 0x4c, 0x5e, 0x68, 0x6d, 0x7d, 0xad, 0xc1, 0xcd, 0xcf, 0xdd},
-    {0x07, 0x0e, 0x1e, 0x44, 0x46, 0x48, 0x4a, 0x4f, 0x5d, 0x6b, 0x6e, 0x7e, 0xae, 0xc2, 0xcc, 0xce, 0xde},
-    {0x06, 0x0f, 0x1f, 0x45, 0x47, 0x49, 0x4b, 0x4e, 0x5c, 0x6a, 0x6f, 0x7f, 0xaf, 0xc3, 0xcd, 0xcf, 0xdf},
-    {0x00, 0x10, 0x19, 0x43, 0x51, 0x54, 0x56, 0x58, 0x5a, 0x60, 0x70, 0x75, 0xb0, 0xc0, 0xd0, 0xd2, 0xdc},
-    {0x01, 0x11, 0x18, 0x42, 0x50, 0x55, 0x57, 0x59, 0x5b, 0x61, 0x71, 0x74, 0xb1, 0xc1, 0xd1, 0xd3, 0xdd},
-    {0x02, 0x12, 0x1b, 0x41, 0x53, 0x54, 0x56, 0x58, 0x5a, 0x62, 0x72, 0x77, 0xb2, 0xc2, 0xd0, 0xd2, 0xde},
-    {0x03, 0x13, 0x1a, 0x40, 0x52, 0x55, 0x57, 0x59, 0x5b, 0x63, 0x73, 0x76, 0xb3, 0xc3, 0xd1, 0xd3, 0xdf},
-    {0x04, 0x14, 0x1d, 0x47, 0x50, 0x52, 0x55, 0x5c, 0x5e, 0x64, 0x71, 0x74, 0xb4, 0xc4, 0xd4, 0xd6, 0xd8},
-    {0x05, 0x15, 0x1c, 0x46, 0x51, 0x53, 0x54, 0x5d, 0x5f, 0x65, 0x70, 0x75, 0xb5, 0xc5, 0xd5, 0xd7, 0xd9},
-    {0x06, 0x16, 0x1f, 0x45, 0x50, 0x52, 0x57, 0x5c, 0x5e, 0x66, 0x73, 0x76, 0xb6, 0xc6, 0xd4, 0xd6, 0xda},
-    {0x07, 0x17, 0x1e, 0x44, 0x51, 0x53, 0x56, 0x5d, 0x5f, 0x67, 0x72, 0x77, 0xb7, 0xc7, 0xd5, 0xd7, 0xdb},
-    {0x08, 0x11, 0x18, 0x4b, 0x50, 0x52, 0x59, 0x5c, 0x5e, 0x68, 0x78, 0x7d, 0xb8, 0xc8, 0xd4, 0xd8, 0xda},
-    {0x09, 0x10, 0x19, 0x4a, 0x51, 0x53, 0x58, 0x5d, 0x5f, 0x69, 0x79, 0x7c, 0xb9, 0xc9, 0xd5, 0xd9, 0xdb},
-    {0x0a, 0x13, 0x1a, 0x49, 0x50, 0x52, 0x5b, 0x5c, 0x5e, 0x6a, 0x7a, 0x7f, 0xba, 0xca, 0xd6, 0xd8, 0xda},
-    {0x0b, 0x12, 0x1b, 0x48, 0x51, 0x53, 0x5a, 0x5d, 0x5f, 0x6b, 0x7b, 0x7e, 0xbb, 0xcb, 0xd7, 0xd9, 0xdb},
-    {0x0c, 0x15, 0x1c, 0x4f, 0x54, 0x56, 0x58, 0x5a, 0x5d, 0x6c, 0x79, 0x7c, 0xbc, 0xcc, 0xd0, 0xdc, 0xde},
-    {0x0d, 0x14, 0x1d, 0x4e, 0x55, 0x57, 0x59, 0x5b, 0x5c, 0x6d, 0x78, 0x7d, 0xbd, 0xcd, 0xd1, 0xdd, 0xdf},
-    {0x0e, 0x17, 0x1e, 0x4d, 0x54, 0x56, 0x58, 0x5a, 0x5f, 0x6e, 0x7b, 0x7e, 0xbe, 0xce, 0xd2, 0xdc, 0xde},
-    {0x0f, 0x16, 0x1f, 0x4c, 0x55, 0x57, 0x59, 0x5b, 0x5e, 0x6f, 0x7a, 0x7f, 0xbf, 0xcf, 0xd3, 0xdd, 0xdf},
-    {0x20, 0x29, 0x30, 0x40, 0x45, 0x50, 0x61, 0x64, 0x66, 0x68, 0x6a, 0x73, 0x80, 0xe0, 0xe2, 0xec, 0xf0},
-    {0x21, 0x28, 0x31, 0x41, 0x44, 0x51, 0x60, 0x65, 0x67, 0x69, 0x6b, 0x72, 0x81, 0xe1, 0xe3, 0xed, 0xf1},
-    {0x22, 0x2b, 0x32, 0x42, 0x47, 0x52, 0x63, 0x64, 0x66, 0x68, 0x6a, 0x71, 0x82, 0xe0, 0xe2, 0xee, 0xf2},
-    {0x23, 0x2a, 0x33, 0x43, 0x46, 0x53, 0x62, 0x65, 0x67, 0x69, 0x6b, 0x70, 0x83, 0xe1, 0xe3, 0xef, 0xf3},
-    {0x24, 0x2d, 0x34, 0x41, 0x44, 0x54, 0x60, 0x62, 0x65, 0x6c, 0x6e, 0x77, 0x84, 0xe4, 0xe6, 0xe8, 0xf4},
-    {0x25, 0x2c, 0x35, 0x40, 0x45, 0x55, 0x61, 0x63, 0x64, 0x6d, 0x6f, 0x76, 0x85, 0xe5, 0xe7, 0xe9, 0xf5},
-    {0x26, 0x2f, 0x36, 0x43, 0x46, 0x56, 0x60, 0x62, 0x67, 0x6c, 0x6e, 0x75, 0x86, 0xe4, 0xe6, 0xea, 0xf6},
-    {0x27, 0x2e, 0x37, 0x42, 0x47, 0x57, 0x61, 0x63, 0x66, 0x6d, 0x6f, 0x74, 0x87, 0xe5, 0xe7, 0xeb, 0xf7},
-    {0x21, 0x28, 0x38, 0x48, 0x4d, 0x58, 0x60, 0x62, 0x69, 0x6c, 0x6e, 0x7b, 0x88, 0xe4, 0xe8, 0xea, 0xf8},
-    {0x20, 0x29, 0x39, 0x49, 0x4c, 0x59, 0x61, 0x63, 0x68, 0x6d, 0x6f, 0x7a, 0x89, 0xe5, 0xe9, 0xeb, 0xf9},
-    {0x23, 0x2a, 0x3a, 0x4a, 0x4f, 0x5a, 0x60, 0x62, 0x6b, 0x6c, 0x6e, 0x79, 0x8a, 0xe6, 0xe8, 0xea, 0xfa},
-    {0x22, 0x2b, 0x3b, 0x4b, 0x4e, 0x5b, 0x61, 0x63, 0x6a, 0x6d, 0x6f, 0x78, 0x8b, 0xe7, 0xe9, 0xeb, 0xfb},
-    {0x25, 0x2c, 0x3c, 0x49, 0x4c, 0x5c, 0x64, 0x66, 0x68, 0x6a, 0x6d, 0x7f, 0x8c, 0xe0, 0xec, 0xee, 0xfc},
-    {0x24, 0x2d, 0x3d, 0x48, 0x4d, 0x5d, 0x65, 0x67, 0x69, 0x6b, 0x6c, 0x7e, 0x8d, 0xe1, 0xed, 0xef, 0xfd},
-    {0x27, 0x2e, 0x3e, 0x4b, 0x4e, 0x5e, 0x64, 0x66, 0x68, 0x6a, 0x6f, 0x7d, 0x8e, 0xe2, 0xec, 0xee, 0xfe},
-    {0x26, 0x2f, 0x3f, 0x4a, 0x4f, 0x5f, 0x65, 0x67, 0x69, 0x6b, 0x6e, 0x7c, 0x8f, 0xe3, 0xed, 0xef, 0xff},
-    {0x20, 0x30, 0x39, 0x40, 0x50, 0x55, 0x63, 0x71, 0x74, 0x76, 0x78, 0x7a, 0x90, 0xe0, 0xf0, 0xf2, 0xfc},
-    {0x21, 0x31, 0x38, 0x41, 0x51, 0x54, 0x62, 0x70, 0x75, 0x77, 0x79, 0x7b, 0x91, 0xe1, 0xf1, 0xf3, 0xfd},
-    {0x22, 0x32, 0x3b, 0x42, 0x52, 0x57, 0x61, 0x73, 0x74, 0x76, 0x78, 0x7a, 0x92, 0xe2, 0xf0, 0xf2, 0xfe},
-    {0x23, 0x33, 0x3a, 0x43, 0x53, 0x56, 0x60, 0x72, 0x75, 0x77, 0x79, 0x7b, 0x93, 0xe3, 0xf1, 0xf3, 0xff},
-    {0x24, 0x34, 0x3d, 0x44, 0x51, 0x54, 0x67, 0x70, 0x72, 0x75, 0x7c, 0x7e, 0x94, 0xe4, 0xf4, 0xf6, 0xf8},
-    {0x25, 0x35, 0x3c, 0x45, 0x50, 0x55, 0x66, 0x71, 0x73, 0x74, 0x7d, 0x7f, 0x95, 0xe5, 0xf5, 0xf7, 0xf9},
-    {0x26, 0x36, 0x3f, 0x46, 0x53, 0x56, 0x65, 0x70, 0x72, 0x77, 0x7c, 0x7e, 0x96, 0xe6, 0xf4, 0xf6, 0xfa},
-    {0x27, 0x37, 0x3e, 0x47, 0x52, 0x57, 0x64, 0x71, 0x73, 0x76, 0x7d, 0x7f, 0x97, 0xe7, 0xf5, 0xf7, 0xfb},
-    {0x28, 0x31, 0x38, 0x48, 0x58, 0x5d, 0x6b, 0x70, 0x72, 0x79, 0x7c, 0x7e, 0x98, 0xe8, 0xf4, 0xf8, 0xfa},
-    {0x29, 0x30, 0x39, 0x49, 0x59, 0x5c, 0x6a, 0x71, 0x73, 0x78, 0x7d, 0x7f, 0x99, 0xe9, 0xf5, 0xf9, 0xfb},
-    {0x2a, 0x33, 0x3a, 0x4a, 0x5a, 0x5f, 0x69, 0x70, 0x72, 0x7b, 0x7c, 0x7e, 0x9a, 0xea, 0xf6, 0xf8, 0xfa},
-    {0x2b, 0x32, 0x3b, 0x4b, 0x5b, 0x5e, 0x68, 0x71, 0x73, 0x7a, 0x7d, 0x7f, 0x9b, 0xeb, 0xf7, 0xf9, 0xfb},
-    {0x2c, 0x35, 0x3c, 0x4c, 0x59, 0x5c, 0x6f, 0x74, 0x76, 0x78, 0x7a, 0x7d, 0x9c, 0xec, 0xf0, 0xfc, 0xfe},
-    {0x2d, 0x34, 0x3d, 0x4d, 0x58, 0x5d, 0x6e, 0x75, 0x77, 0x79, 0x7b, 0x7c, 0x9d, 0xed, 0xf1, 0xfd, 0xff},
-    {0x2e, 0x37, 0x3e, 0x4e, 0x5b, 0x5e, 0x6d, 0x74, 0x76, 0x78, 0x7a, 0x7f, 0x9e, 0xee, 0xf2, 0xfc, 0xfe},
-    {0x2f, 0x36, 0x3f, 0x4f, 0x5a, 0x5f, 0x6c, 0x75, 0x77, 0x79, 0x7b, 0x7e, 0x9f, 0xef, 0xf3, 0xfd, 0xff},
-    {0x00, 0x02, 0x0c, 0x10, 0x60, 0x81, 0x84, 0x86, 0x88, 0x8a, 0x93, 0xa0, 0xa5, 0xb0, 0xc0, 0xc9, 0xd0},
-    {0x01, 0x03, 0x0d, 0x11, 0x61, 0x80, 0x85, 0x87, 0x89, 0x8b, 0x92, 0xa1, 0xa4, 0xb1, 0xc1, 0xc8, 0xd1},
-    {0x00, 0x02, 0x0e, 0x12, 0x62, 0x83, 0x84, 0x86, 0x88, 0x8a, 0x91, 0xa2, 0xa7, 0xb2, 0xc2, 0xcb, 0xd2},
-    {0x01, 0x03, 0x0f, 0x13, 0x63, 0x82, 0x85, 0x87, 0x89, 0x8b, 0x90, 0xa3, 0xa6, 0xb3, 0xc3, 0xca, 0xd3},
-    {0x04, 0x06, 0x08, 0x14, 0x64, 0x80, 0x82, 0x85, 0x8c, 0x8e, 0x97, 0xa1, 0xa4, 0xb4, 0xc4, 0xcd, 0xd4},
-    {0x05, 0x07, 0x09, 0x15, 0x65, 0x81, 0x83, 0x84, 0x8d, 0x8f, 0x96, 0xa0, 0xa5, 0xb5, 0xc5, 0xcc, 0xd5},
-    {0x04, 0x06, 0x0a, 0x16, 0x66, 0x80, 0x82, 0x87, 0x8c, 0x8e, 0x95, 0xa3, 0xa6, 0xb6, 0xc6, 0xcf, 0xd6},
-    {0x05, 0x07, 0x0b, 0x17, 0x67, 0x81, 0x83, 0x86, 0x8d, 0x8f, 0x94, 0xa2, 0xa7, 0xb7, 0xc7, 0xce, 0xd7},
-    {0x04, 0x08, 0x0a, 0x18, 0x68, 0x80, 0x82, 0x89, 0x8c, 0x8e, 0x9b, 0xa8, 0xad, 0xb8, 0xc1, 0xc8, 0xd8},
-    {0x05, 0x09, 0x0b, 0x19, 0x69, 0x81, 0x83, 0x88, 0x8d, 0x8f, 0x9a, 0xa9, 0xac, 0xb9, 0xc0, 0xc9, 0xd9},
-    {0x06, 0x08, 0x0a, 0x1a, 0x6a, 0x80, 0x82, 0x8b, 0x8c, 0x8e, 0x99, 0xaa, 0xaf, 0xba, 0xc3, 0xca, 0xda},
-    {0x07, 0x09, 0x0b, 0x1b, 0x6b, 0x81, 0x83, 0x8a, 0x8d, 0x8f, 0x98, 0xab, 0xae, 0xbb, 0xc2, 0xcb, 0xdb},
-    {0x00, 0x0c, 0x0e, 0x1c, 0x6c, 0x84, 0x86, 0x88, 0x8a, 0x8d, 0x9f, 0xa9, 0xac, 0xbc, 0xc5, 0xcc, 0xdc},
-    {0x01, 0x0d, 0x0f, 0x1d, 0x6d, 0x85, 0x87, 0x89, 0x8b, 0x8c, 0x9e, 0xa8, 0xad, 0xbd, 0xc4, 0xcd, 0xdd},
-    {0x02, 0x0c, 0x0e, 0x1e, 0x6e, 0x84, 0x86, 0x88, 0x8a, 0x8f, 0x9d, 0xab, 0xae, 0xbe, 0xc7, 0xce, 0xde},
-    {0x03, 0x0d, 0x0f, 0x1f, 0x6f, 0x85, 0x87, 0x89, 0x8b, 0x8e, 0x9c, 0xaa, 0xaf, 0xbf, 0xc6, 0xcf, 0xdf},
-    {0x00, 0x10, 0x12, 0x1c, 0x70, 0x83, 0x91, 0x94, 0x96, 0x98, 0x9a, 0xa0, 0xb0, 0xb5, 0xc0, 0xd0, 0xd9},
-    {0x01, 0x11, 0x13, 0x1d, 0x71, 0x82, 0x90, 0x95, 0x97, 0x99, 0x9b, 0xa1, 0xb1, 0xb4, 0xc1, 0xd1, 0xd8},
-    {0x02, 0x10, 0x12, 0x1e, 0x72, 0x81, 0x93, 0x94, 0x96, 0x98, 0x9a, 0xa2, 0xb2, 0xb7, 0xc2, 0xd2, 0xdb},
-    {0x03, 0x11, 0x13, 0x1f, 0x73, 0x80, 0x92, 0x95, 0x97, 0x99, 0x9b, 0xa3, 0xb3, 0xb6, 0xc3, 0xd3, 0xda},
-    {0x04, 0x14, 0x16, 0x18, 0x74, 0x87, 0x90, 0x92, 0x95, 0x9c, 0x9e, 0xa4, 0xb1, 0xb4, 0xc4, 0xd4, 0xdd},
-    {0x05, 0x15, 0x17, 0x19, 0x75, 0x86, 0x91, 0x93, 0x94, 0x9d, 0x9f, 0xa5, 0xb0, 0xb5, 0xc5, 0xd5, 0xdc},
-    {0x06, 0x14, 0x16, 0x1a, 0x76, 0x85, 0x90, 0x92, 0x97, 0x9c, 0x9e, 0xa6, 0xb3, 0xb6, 0xc6, 0xd6, 0xdf},
-    {0x07, 0x15, 0x17, 0x1b, 0x77, 0x84, 0x91, 0x93, 0x96, 0x9d, 0x9f, 0xa7, 0xb2, 0xb7, 0xc7, 0xd7, 0xde},
-    {0x08, 0x14, 0x18, 0x1a, 0x78, 0x8b, 0x90, 0x92, 0x99, 0x9c, 0x9e, 0xa8, 0xb8, 0xbd, 0xc8, 0xd1, 0xd8},
-    {0x09, 0x15, 0x19, 0x1b, 0x79, 0x8a, 0x91, 0x93, 0x98, 0x9d, 0x9f, 0xa9, 0xb9, 0xbc, 0xc9, 0xd0, 0xd9},
-    {0x0a, 0x16, 0x18, 0x1a, 0x7a, 0x89, 0x90, 0x92, 0x9b, 0x9c, 0x9e, 0xaa, 0xba, 0xbf, 0xca, 0xd3, 0xda},
-    {0x0b, 0x17, 0x19, 0x1b, 0x7b, 0x88, 0x91, 0x93, 0x9a, 0x9d, 0x9f, 0xab, 0xbb, 0xbe, 0xcb, 0xd2, 0xdb},
-    {0x0c, 0x10, 0x1c, 0x1e, 0x7c, 0x8f, 0x94, 0x96, 0x98, 0x9a, 0x9d, 0xac, 0xb9, 0xbc, 0xcc, 0xd5, 0xdc},
-    {0x0d, 0x11, 0x1d, 0x1f, 0x7d, 0x8e, 0x95, 0x97, 0x99, 0x9b, 0x9c, 0xad, 0xb8, 0xbd, 0xcd, 0xd4, 0xdd},
-    {0x0e, 0x12, 0x1c, 0x1e, 0x7e, 0x8d, 0x94, 0x96, 0x98, 0x9a, 0x9f, 0xae, 0xbb, 0xbe, 0xce, 0xd7, 0xde},
-    {0x0f, 0x13, 0x1d, 0x1f, 0x7f, 0x8c, 0x95, 0x97, 0x99, 0x9b, 0x9e, 0xaf, 0xba, 0xbf, 0xcf, 0xd6, 0xdf},
-    {0x20, 0x22, 0x2c, 0x30, 0x40, 0x80, 0x85, 0x90, 0xa1, 0xa4, 0xa6, 0xa8, 0xaa, 0xb3, 0xe0, 0xe9, 0xf0},
-    {0x21, 0x23, 0x2d, 0x31, 0x41, 0x81, 0x84, 0x91, 0xa0, 0xa5, 0xa7, 0xa9, 0xab, 0xb2, 0xe1, 0xe8, 0xf1},
-    {0x20, 0x22, 0x2e, 0x32, 0x42, 0x82, 0x87, 0x92, 0xa3, 0xa4, 0xa6, 0xa8, 0xaa, 0xb1, 0xe2, 0xeb, 0xf2},
-    {0x21, 0x23, 0x2f, 0x33, 0x43, 0x83, 0x86, 0x93, 0xa2, 0xa5, 0xa7, 0xa9, 0xab, 0xb0, 0xe3, 0xea, 0xf3},
-    {0x24, 0x26, 0x28, 0x34, 0x44, 0x81, 0x84, 0x94, 0xa0, 0xa2, 0xa5, 0xac, 0xae, 0xb7, 0xe4, 0xed, 0xf4},
-    {0x25, 0x27, 0x29, 0x35, 0x45, 0x80, 0x85, 0x95, 0xa1, 0xa3, 0xa4, 0xad, 0xaf, 0xb6, 0xe5, 0xec, 0xf5},
-    {0x24, 0x26, 0x2a, 0x36, 0x46, 0x83, 0x86, 0x96, 0xa0, 0xa2, 0xa7, 0xac, 0xae, 0xb5, 0xe6, 0xef, 0xf6},
-    {0x25, 0x27, 0x2b, 0x37, 0x47, 0x82, 0x87, 0x97, 0xa1, 0xa3, 0xa6, 0xad, 0xaf, 0xb4, 0xe7, 0xee, 0xf7},
-    {0x24, 0x28, 0x2a, 0x38, 0x48, 0x88, 0x8d, 0x98, 0xa0, 0xa2, 0xa9, 0xac, 0xae, 0xbb, 0xe1, 0xe8, 0xf8},
-    {0x25, 0x29, 0x2b, 0x39, 0x49, 0x89, 0x8c, 0x99, 0xa1, 0xa3, 0xa8, 0xad, 0xaf, 0xba, 0xe0, 0xe9, 0xf9},
-    {0x26, 0x28, 0x2a, 0x3a, 0x4a, 0x8a, 0x8f, 0x9a, 0xa0, 0xa2, 0xab, 0xac, 0xae, 0xb9, 0xe3, 0xea, 0xfa},
-    {0x27, 0x29, 0x2b, 0x3b, 0x4b, 0x8b, 0x8e, 0x9b, 0xa1, 0xa3, 0xaa, 0xad, 0xaf, 0xb8, 0xe2, 0xeb, 0xfb},
-    {0x20, 0x2c, 0x2e, 0x3c, 0x4c, 0x89, 0x8c, 0x9c, 0xa4, 0xa6, 0xa8, 0xaa, 0xad, 0xbf, 0xe5, 0xec, 0xfc},
-    {0x21, 0x2d, 0x2f, 0x3d, 0x4d, 0x88, 0x8d, 0x9d, 0xa5, 0xa7, 0xa9, 0xab, 0xac, 0xbe, 0xe4, 0xed, 0xfd},
-    {0x22, 0x2c, 0x2e, 0x3e, 0x4e, 0x8b, 0x8e, 0x9e, 0xa4, 0xa6, 0xa8, 0xaa, 0xaf, 0xbd, 0xe7, 0xee, 0xfe},
-    {0x23, 0x2d, 0x2f, 0x3f, 0x4f, 0x8a, 0x8f, 0x9f, 0xa5, 0xa7, 0xa9, 0xab, 0xae, 0xbc, 0xe6, 0xef, 0xff},
-    {0x20, 0x30, 0x32, 0x3c, 0x50, 0x80, 0x90, 0x95, 0xa3, 0xb1, 0xb4, 0xb6, 0xb8, 0xba, 0xe0, 0xf0, 0xf9},
-    {0x21, 0x31, 0x33, 0x3d, 0x51, 0x81, 0x91, 0x94, 0xa2, 0xb0, 0xb5, 0xb7, 0xb9, 0xbb, 0xe1, 0xf1, 0xf8},
-    {0x22, 0x30, 0x32, 0x3e, 0x52, 0x82, 0x92, 0x97, 0xa1, 0xb3, 0xb4, 0xb6, 0xb8, 0xba, 0xe2, 0xf2, 0xfb},
-    {0x23, 0x31, 0x33, 0x3f, 0x53, 0x83, 0x93, 0x96, 0xa0, 0xb2, 0xb5, 0xb7, 0xb9, 0xbb, 0xe3, 0xf3, 0xfa},
-    {0x24, 0x34, 0x36, 0x38, 0x54, 0x84, 0x91, 0x94, 0xa7, 0xb0, 0xb2, 0xb5, 0xbc, 0xbe, 0xe4, 0xf4, 0xfd},
-    {0x25, 0x35, 0x37, 0x39, 0x55, 0x85, 0x90, 0x95, 0xa6, 0xb1, 0xb3, 0xb4, 0xbd, 0xbf, 0xe5, 0xf5, 0xfc},
-    {0x26, 0x34, 0x36, 0x3a, 0x56, 0x86, 0x93, 0x96, 0xa5, 0xb0, 0xb2, 0xb7, 0xbc, 0xbe, 0xe6, 0xf6, 0xff},
-    {0x27, 0x35, 0x37, 0x3b, 0x57, 0x87, 0x92, 0x97, 0xa4, 0xb1, 0xb3, 0xb6, 0xbd, 0xbf, 0xe7, 0xf7, 0xfe},
-    {0x28, 0x34, 0x38, 0x3a, 0x58, 0x88, 0x98, 0x9d, 0xab, 0xb0, 0xb2, 0xb9, 0xbc, 0xbe, 0xe8, 0xf1, 0xf8},
-    {0x29, 0x35, 0x39, 0x3b, 0x59, 0x89, 0x99, 0x9c, 0xaa, 0xb1, 0xb3, 0xb8, 0xbd, 0xbf, 0xe9, 0xf0, 0xf9},
-    {0x2a, 0x36, 0x38, 0x3a, 0x5a, 0x8a, 0x9a, 0x9f, 0xa9, 0xb0, 0xb2, 0xbb, 0xbc, 0xbe, 0xea, 0xf3, 0xfa},
-    {0x2b, 0x37, 0x39, 0x3b, 0x5b, 0x8b, 0x9b, 0x9e, 0xa8, 0xb1, 0xb3, 0xba, 0xbd, 0xbf, 0xeb, 0xf2, 0xfb},
-    {0x2c, 0x30, 0x3c, 0x3e, 0x5c, 0x8c, 0x99, 0x9c, 0xaf, 0xb4, 0xb6, 0xb8, 0xba, 0xbd, 0xec, 0xf5, 0xfc},
-    {0x2d, 0x31, 0x3d, 0x3f, 0x5d, 0x8d, 0x98, 0x9d, 0xae, 0xb5, 0xb7, 0xb9, 0xbb, 0xbc, 0xed, 0xf4, 0xfd},
-    {0x2e, 0x32, 0x3c, 0x3e, 0x5e, 0x8e, 0x9b, 0x9e, 0xad, 0xb4, 0xb6, 0xb8, 0xba, 0xbf, 0xee, 0xf7, 0xfe},
-    {0x2f, 0x33, 0x3d, 0x3f, 0x5f, 0x8f, 0x9a, 0x9f, 0xac, 0xb5, 0xb7, 0xb9, 0xbb, 0xbe, 0xef, 0xf6, 0xff},
-    {0x20, 0x40, 0x42, 0x4c, 0x50, 0x80, 0x89, 0x90, 0xc1, 0xc4, 0xc6, 0xc8, 0xca, 0xd3, 0xe0, 0xe5, 0xf0},
-    {0x21, 0x41, 0x43, 0x4d, 0x51, 0x81, 0x88, 0x91, 0xc0, 0xc5, 0xc7, 0xc9, 0xcb, 0xd2, 0xe1, 0xe4, 0xf1},
-    {0x22, 0x40, 0x42, 0x4e, 0x52, 0x82, 0x8b, 0x92, 0xc3, 0xc4, 0xc6, 0xc8, 0xca, 0xd1, 0xe2, 0xe7, 0xf2},
-    {0x23, 0x41, 0x43, 0x4f, 0x53, 0x83, 0x8a, 0x93, 0xc2, 0xc5, 0xc7, 0xc9, 0xcb, 0xd0, 0xe3, 0xe6, 0xf3},
-    {0x24, 0x44, 0x46, 0x48, 0x54, 0x84, 0x8d, 0x94, 0xc0, 0xc2, 0xc5, 0xcc, 0xce, 0xd7, 0xe1, 0xe4, 0xf4},
-    {0x25, 0x45, 0x47, 0x49, 0x55, 0x85, 0x8c, 0x95, 0xc1, 0xc3, 0xc4, 0xcd, 0xcf, 0xd6, 0xe0, 0xe5, 0xf5},
-    {0x26, 0x44, 0x46, 0x4a, 0x56, 0x86, 0x8f, 0x96, 0xc0, 0xc2, 0xc7, 0xcc, 0xce, 0xd5, 0xe3, 0xe6, 0xf6},
-    {0x27, 0x45, 0x47, 0x4b, 0x57, 0x87, 0x8e, 0x97, 0xc1, 0xc3, 0xc6, 0xcd, 0xcf, 0xd4, 0xe2, 0xe7, 0xf7},
-    {0x28, 0x44, 0x48, 0x4a, 0x58, 0x81, 0x88, 0x98, 0xc0, 0xc2, 0xc9, 0xcc, 0xce, 0xdb, 0xe8, 0xed, 0xf8},
-    {0x29, 0x45, 0x49, 0x4b, 0x59, 0x80, 0x89, 0x99, 0xc1, 0xc3, 0xc8, 0xcd, 0xcf, 0xda, 0xe9, 0xec, 0xf9},
-    {0x2a, 0x46, 0x48, 0x4a, 0x5a, 0x83, 0x8a, 0x9a, 0xc0, 0xc2, 0xcb, 0xcc, 0xce, 0xd9, 0xea, 0xef, 0xfa},
-    {0x2b, 0x47, 0x49, 0x4b, 0x5b, 0x82, 0x8b, 0x9b, 0xc1, 0xc3, 0xca, 0xcd, 0xcf, 0xd8, 0xeb, 0xee, 0xfb},
-    {0x2c, 0x40, 0x4c, 0x4e, 0x5c, 0x85, 0x8c, 0x9c, 0xc4, 0xc6, 0xc8, 0xca, 0xcd, 0xdf, 0xe9, 0xec, 0xfc},
-    {0x2d, 0x41, 0x4d, 0x4f, 0x5d, 0x84, 0x8d, 0x9d, 0xc5, 0xc7, 0xc9, 0xcb, 0xcc, 0xde, 0xe8, 0xed, 0xfd},
-    {0x2e, 0x42, 0x4c, 0x4e, 0x5e, 0x87, 0x8e, 0x9e, 0xc4, 0xc6, 0xc8, 0xca, 0xcf, 0xdd, 0xeb, 0xee, 0xfe},
-    {0x2f, 0x43, 0x4d, 0x4f, 0x5f, 0x86, 0x8f, 0x9f, 0xc5, 0xc7, 0xc9, 0xcb, 0xce, 0xdc, 0xea, 0xef, 0xff},
-    {0x30, 0x40, 0x50, 0x52, 0x5c, 0x80, 0x90, 0x99, 0xc3, 0xd1, 0xd4, 0xd6, 0xd8, 0xda, 0xe0, 0xf0, 0xf5},
-    {0x31, 0x41, 0x51, 0x53, 0x5d, 0x81, 0x91, 0x98, 0xc2, 0xd0, 0xd5, 0xd7, 0xd9, 0xdb, 0xe1, 0xf1, 0xf4},
-    {0x32, 0x42, 0x50, 0x52, 0x5e, 0x82, 0x92, 0x9b, 0xc1, 0xd3, 0xd4, 0xd6, 0xd8, 0xda, 0xe2, 0xf2, 0xf7},
-    {0x33, 0x43, 0x51, 0x53, 0x5f, 0x83, 0x93, 0x9a, 0xc0, 0xd2, 0xd5, 0xd7, 0xd9, 0xdb, 0xe3, 0xf3, 0xf6},
-    {0x34, 0x44, 0x54, 0x56, 0x58, 0x84, 0x94, 0x9d, 0xc7, 0xd0, 0xd2, 0xd5, 0xdc, 0xde, 0xe4, 0xf1, 0xf4},
-    {0x35, 0x45, 0x55, 0x57, 0x59, 0x85, 0x95, 0x9c, 0xc6, 0xd1, 0xd3, 0xd4, 0xdd, 0xdf, 0xe5, 0xf0, 0xf5},
-    {0x36, 0x46, 0x54, 0x56, 0x5a, 0x86, 0x96, 0x9f, 0xc5, 0xd0, 0xd2, 0xd7, 0xdc, 0xde, 0xe6, 0xf3, 0xf6},
-    {0x37, 0x47, 0x55, 0x57, 0x5b, 0x87, 0x97, 0x9e, 0xc4, 0xd1, 0xd3, 0xd6, 0xdd, 0xdf, 0xe7, 0xf2, 0xf7},
-    {0x38, 0x48, 0x54, 0x58, 0x5a, 0x88, 0x91, 0x98, 0xcb, 0xd0, 0xd2, 0xd9, 0xdc, 0xde, 0xe8, 0xf8, 0xfd},
-    {0x39, 0x49, 0x55, 0x59, 0x5b, 0x89, 0x90, 0x99, 0xca, 0xd1, 0xd3, 0xd8, 0xdd, 0xdf, 0xe9, 0xf9, 0xfc},
-    {0x3a, 0x4a, 0x56, 0x58, 0x5a, 0x8a, 0x93, 0x9a, 0xc9, 0xd0, 0xd2, 0xdb, 0xdc, 0xde, 0xea, 0xfa, 0xff},
-    {0x3b, 0x4b, 0x57, 0x59, 0x5b, 0x8b, 0x92, 0x9b, 0xc8, 0xd1, 0xd3, 0xda, 0xdd, 0xdf, 0xeb, 0xfb, 0xfe},
-    {0x3c, 0x4c, 0x50, 0x5c, 0x5e, 0x8c, 0x95, 0x9c, 0xcf, 0xd4, 0xd6, 0xd8, 0xda, 0xdd, 0xec, 0xf9, 0xfc},
-    {0x3d, 0x4d, 0x51, 0x5d, 0x5f, 0x8d, 0x94, 0x9d, 0xce, 0xd5, 0xd7, 0xd9, 0xdb, 0xdc, 0xed, 0xf8, 0xfd},
-    {0x3e, 0x4e, 0x52, 0x5c, 0x5e, 0x8e, 0x97, 0x9e, 0xcd, 0xd4, 0xd6, 0xd8, 0xda, 0xdf, 0xee, 0xfb, 0xfe},
-    {0x3f, 0x4f, 0x53, 0x5d, 0x5f, 0x8f, 0x96, 0x9f, 0xcc, 0xd5, 0xd7, 0xd9, 0xdb, 0xde, 0xef, 0xfa, 0xff},
-    {0x00, 0x60, 0x62, 0x6c, 0x70, 0xa0, 0xa9, 0xb0, 0xc0, 0xc5, 0xd0, 0xe1, 0xe4, 0xe6, 0xe8, 0xea, 0xf3},
-    {0x01, 0x61, 0x63, 0x6d, 0x71, 0xa1, 0xa8, 0xb1, 0xc1, 0xc4, 0xd1, 0xe0, 0xe5, 0xe7, 0xe9, 0xeb, 0xf2},
-    {0x02, 0x60, 0x62, 0x6e, 0x72, 0xa2, 0xab, 0xb2, 0xc2, 0xc7, 0xd2, 0xe3, 0xe4, 0xe6, 0xe8, 0xea, 0xf1},
-    {0x03, 0x61, 0x63, 0x6f, 0x73, 0xa3, 0xaa, 0xb3, 0xc3, 0xc6, 0xd3, 0xe2, 0xe5, 0xe7, 0xe9, 0xeb, 0xf0},
-    {0x04, 0x64, 0x66, 0x68, 0x74, 0xa4, 0xad, 0xb4, 0xc1, 0xc4, 0xd4, 0xe0, 0xe2, 0xe5, 0xec, 0xee, 0xf7},
-    {0x05, 0x65, 0x67, 0x69, 0x75, 0xa5, 0xac, 0xb5, 0xc0, 0xc5, 0xd5, 0xe1, 0xe3, 0xe4, 0xed, 0xef, 0xf6},
-    {0x06, 0x64, 0x66, 0x6a, 0x76, 0xa6, 0xaf, 0xb6, 0xc3, 0xc6, 0xd6, 0xe0, 0xe2, 0xe7, 0xec, 0xee, 0xf5},
-    {0x07, 0x65, 0x67, 0x6b, 0x77, 0xa7, 0xae, 0xb7, 0xc2, 0xc7, 0xd7, 0xe1, 0xe3, 0xe6, 0xed, 0xef, 0xf4},
-    {0x08, 0x64, 0x68, 0x6a, 0x78, 0xa1, 0xa8, 0xb8, 0xc8, 0xcd, 0xd8, 0xe0, 0xe2, 0xe9, 0xec, 0xee, 0xfb},
-    {0x09, 0x65, 0x69, 0x6b, 0x79, 0xa0, 0xa9, 0xb9, 0xc9, 0xcc, 0xd9, 0xe1, 0xe3, 0xe8, 0xed, 0xef, 0xfa},
-    {0x0a, 0x66, 0x68, 0x6a, 0x7a, 0xa3, 0xaa, 0xba, 0xca, 0xcf, 0xda, 0xe0, 0xe2, 0xeb, 0xec, 0xee, 0xf9},
-    {0x0b, 0x67, 0x69, 0x6b, 0x7b, 0xa2, 0xab, 0xbb, 0xcb, 0xce, 0xdb, 0xe1, 0xe3, 0xea, 0xed, 0xef, 0xf8},
-    {0x0c, 0x60, 0x6c, 0x6e, 0x7c, 0xa5, 0xac, 0xbc, 0xc9, 0xcc, 0xdc, 0xe4, 0xe6, 0xe8, 0xea, 0xed, 0xff},
-    {0x0d, 0x61, 0x6d, 0x6f, 0x7d, 0xa4, 0xad, 0xbd, 0xc8, 0xcd, 0xdd, 0xe5, 0xe7, 0xe9, 0xeb, 0xec, 0xfe},
-    {0x0e, 0x62, 0x6c, 0x6e, 0x7e, 0xa7, 0xae, 0xbe, 0xcb, 0xce, 0xde, 0xe4, 0xe6, 0xe8, 0xea, 0xef, 0xfd},
-    {0x0f, 0x63, 0x6d, 0x6f, 0x7f, 0xa6, 0xaf, 0xbf, 0xca, 0xcf, 0xdf, 0xe5, 0xe7, 0xe9, 0xeb, 0xee, 0xfc},
-    {0x10, 0x60, 0x70, 0x72, 0x7c, 0xa0, 0xb0, 0xb9, 0xc0, 0xd0, 0xd5, 0xe3, 0xf1, 0xf4, 0xf6, 0xf8, 0xfa},
-    {0x11, 0x61, 0x71, 0x73, 0x7d, 0xa1, 0xb1, 0xb8, 0xc1, 0xd1, 0xd4, 0xe2, 0xf0, 0xf5, 0xf7, 0xf9, 0xfb},
-    {0x12, 0x62, 0x70, 0x72, 0x7e, 0xa2, 0xb2, 0xbb, 0xc2, 0xd2, 0xd7, 0xe1, 0xf3, 0xf4, 0xf6, 0xf8, 0xfa},
-    {0x13, 0x63, 0x71, 0x73, 0x7f, 0xa3, 0xb3, 0xba, 0xc3, 0xd3, 0xd6, 0xe0, 0xf2, 0xf5, 0xf7, 0xf9, 0xfb},
-    {0x14, 0x64, 0x74, 0x76, 0x78, 0xa4, 0xb4, 0xbd, 0xc4, 0xd1, 0xd4, 0xe7, 0xf0, 0xf2, 0xf5, 0xfc, 0xfe},
-    {0x15, 0x65, 0x75, 0x77, 0x79, 0xa5, 0xb5, 0xbc, 0xc5, 0xd0, 0xd5, 0xe6, 0xf1, 0xf3, 0xf4, 0xfd, 0xff},
-    {0x16, 0x66, 0x74, 0x76, 0x7a, 0xa6, 0xb6, 0xbf, 0xc6, 0xd3, 0xd6, 0xe5, 0xf0, 0xf2, 0xf7, 0xfc, 0xfe},
-    {0x17, 0x67, 0x75, 0x77, 0x7b, 0xa7, 0xb7, 0xbe, 0xc7, 0xd2, 0xd7, 0xe4, 0xf1, 0xf3, 0xf6, 0xfd, 0xff},
-    {0x18, 0x68, 0x74, 0x78, 0x7a, 0xa8, 0xb1, 0xb8, 0xc8, 0xd8, 0xdd, 0xeb, 0xf0, 0xf2, 0xf9, 0xfc, 0xfe},
-    {0x19, 0x69, 0x75, 0x79, 0x7b, 0xa9, 0xb0, 0xb9, 0xc9, 0xd9, 0xdc, 0xea, 0xf1, 0xf3, 0xf8, 0xfd, 0xff},
-    {0x1a, 0x6a, 0x76, 0x78, 0x7a, 0xaa, 0xb3, 0xba, 0xca, 0xda, 0xdf, 0xe9, 0xf0, 0xf2, 0xfb, 0xfc, 0xfe},
-    {0x1b, 0x6b, 0x77, 0x79, 0x7b, 0xab, 0xb2, 0xbb, 0xcb, 0xdb, 0xde, 0xe8, 0xf1, 0xf3, 0xfa, 0xfd, 0xff},
-    {0x1c, 0x6c, 0x70, 0x7c, 0x7e, 0xac, 0xb5, 0xbc, 0xcc, 0xd9, 0xdc, 0xef, 0xf4, 0xf6, 0xf8, 0xfa, 0xfd},
-    {0x1d, 0x6d, 0x71, 0x7d, 0x7f, 0xad, 0xb4, 0xbd, 0xcd, 0xd8, 0xdd, 0xee, 0xf5, 0xf7, 0xf9, 0xfb, 0xfc},
-    {0x1e, 0x6e, 0x72, 0x7c, 0x7e, 0xae, 0xb7, 0xbe, 0xce, 0xdb, 0xde, 0xed, 0xf4, 0xf6, 0xf8, 0xfa, 0xff},
-    {0x1f, 0x6f, 0x73, 0x7d, 0x7f, 0xaf, 0xb6, 0xbf, 0xcf, 0xda, 0xdf, 0xec, 0xf5, 0xf7, 0xf9, 0xfb, 0xfe}};
+// decoding table: 12-bit received symbol to 8-bit hard-decision output
+const unsigned char hamming128_dec_gentab[4096] = {
+    0x00, 0x00, 0x00, 0x13, 0x00, 0x25, 0x06, 0x07, 0x00, 0x49, 0x0a, 0x0b, 0x8c, 0x0d, 0x0e, 0x0f,
+    0x00, 0x01, 0x82, 0x03, 0x04, 0x05, 0x0e, 0x47, 0x08, 0x09, 0x0e, 0x2b, 0x0e, 0x1d, 0x0e, 0x0e,
+    0x00, 0x13, 0x13, 0x13, 0x14, 0x15, 0x36, 0x13, 0x18, 0x19, 0x5a, 0x13, 0x1c, 0x1d, 0x1e, 0x9f,
+    0x10, 0x91, 0x12, 0x13, 0x54, 0x1d, 0x16, 0x17, 0x38, 0x1d, 0x1a, 0x1b, 0x1d, 0x1d, 0x0e, 0x1d,
+    0x00, 0x25, 0x22, 0x23, 0x25, 0x25, 0x36, 0x25, 0x28, 0xa9, 0x2a, 0x2b, 0x6c, 0x25, 0x2e, 0x2f,
+    0x20, 0x21, 0x62, 0x2b, 0x24, 0x25, 0x26, 0xa7, 0x38, 0x2b, 0x2b, 0x2b, 0x2c, 0x2d, 0x0e, 0x2b,
+    0x30, 0x31, 0x36, 0x13, 0x36, 0x25, 0x36, 0x36, 0x38, 0x39, 0xba, 0x3b, 0x3c, 0x3d, 0x36, 0x7f,
+    0x38, 0x71, 0x32, 0x33, 0xb4, 0x35, 0x36, 0x37, 0x38, 0x38, 0x38, 0x2b, 0x38, 0x1d, 0x3e, 0x3f,
+    0x00, 0x49, 0x42, 0x43, 0x44, 0xc5, 0x46, 0x47, 0x49, 0x49, 0x5a, 0x49, 0x6c, 0x49, 0x4e, 0x4f,
+    0x40, 0x41, 0x62, 0x47, 0x54, 0x47, 0x47, 0x47, 0x48, 0x49, 0x4a, 0xcb, 0x4c, 0x4d, 0x0e, 0x47,
+    0x50, 0x51, 0x5a, 0x13, 0x54, 0x55, 0xd6, 0x57, 0x5a, 0x49, 0x5a, 0x5a, 0x5c, 0x5d, 0x5a, 0x7f,
+    0x54, 0x71, 0x52, 0x53, 0x54, 0x54, 0x54, 0x47, 0xd8, 0x59, 0x5a, 0x5b, 0x54, 0x1d, 0x5e, 0x5f,
+    0xe0, 0x61, 0x62, 0x63, 0x6c, 0x25, 0x66, 0x67, 0x6c, 0x49, 0x6a, 0x6b, 0x6c, 0x6c, 0x6c, 0x7f,
+    0x62, 0x71, 0x62, 0x62, 0x64, 0x65, 0x62, 0x47, 0x68, 0x69, 0x62, 0x2b, 0x6c, 0x6d, 0xee, 0x6f,
+    0x70, 0x71, 0x72, 0xf3, 0x74, 0x75, 0x36, 0x7f, 0x78, 0x79, 0x5a, 0x7f, 0x6c, 0x7f, 0x7f, 0x7f,
+    0x71, 0x71, 0x62, 0x71, 0x54, 0x71, 0x76, 0x77, 0x38, 0x71, 0x7a, 0x7b, 0x7c, 0xfd, 0x7e, 0x7f,
+    0x00, 0x01, 0x02, 0x83, 0x04, 0x05, 0x46, 0x0f, 0x08, 0x09, 0x2a, 0x0f, 0x1c, 0x0f, 0x0f, 0x0f,
+    0x01, 0x01, 0x12, 0x01, 0x24, 0x01, 0x06, 0x07, 0x48, 0x01, 0x0a, 0x0b, 0x0c, 0x8d, 0x0e, 0x0f,
+    0x90, 0x11, 0x12, 0x13, 0x1c, 0x55, 0x16, 0x17, 0x1c, 0x39, 0x1a, 0x1b, 0x1c, 0x1c, 0x1c, 0x0f,
+    0x12, 0x01, 0x12, 0x12, 0x14, 0x15, 0x12, 0x37, 0x18, 0x19, 0x12, 0x5b, 0x1c, 0x1d, 0x9e, 0x1f,
+    0x20, 0x21, 0x2a, 0x63, 0x24, 0x25, 0xa6, 0x27, 0x2a, 0x39, 0x2a, 0x2a, 0x2c, 0x2d, 0x2a, 0x0f,
+    0x24, 0x01, 0x22, 0x23, 0x24, 0x24, 0x24, 0x37, 0xa8, 0x29, 0x2a, 0x2b, 0x24, 0x6d, 0x2e, 0x2f,
+    0x70, 0x39, 0x32, 0x33, 0x34, 0xb5, 0x36, 0x37, 0x39, 0x39, 0x2a, 0x39, 0x1c, 0x39, 0x3e, 0x3f,
+    0x30, 0x31, 0x12, 0x37, 0x24, 0x37, 0x37, 0x37, 0x38, 0x39, 0x3a, 0xbb, 0x3c, 0x3d, 0x7e, 0x37,
+    0x40, 0x41, 0x46, 0x63, 0x46, 0x55, 0x46, 0x46, 0x48, 0x49, 0xca, 0x4b, 0x4c, 0x4d, 0x46, 0x0f,
+    0x48, 0x01, 0x42, 0x43, 0xc4, 0x45, 0x46, 0x47, 0x48, 0x48, 0x48, 0x5b, 0x48, 0x6d, 0x4e, 0x4f,
+    0x70, 0x55, 0x52, 0x53, 0x55, 0x55, 0x46, 0x55, 0x58, 0xd9, 0x5a, 0x5b, 0x1c, 0x55, 0x5e, 0x5f,
+    0x50, 0x51, 0x12, 0x5b, 0x54, 0x55, 0x56, 0xd7, 0x48, 0x5b, 0x5b, 0x5b, 0x5c, 0x5d, 0x7e, 0x5b,
+    0x70, 0x63, 0x63, 0x63, 0x64, 0x65, 0x46, 0x63, 0x68, 0x69, 0x2a, 0x63, 0x6c, 0x6d, 0x6e, 0xef,
+    0x60, 0xe1, 0x62, 0x63, 0x24, 0x6d, 0x66, 0x67, 0x48, 0x6d, 0x6a, 0x6b, 0x6d, 0x6d, 0x7e, 0x6d,
+    0x70, 0x70, 0x70, 0x63, 0x70, 0x55, 0x76, 0x77, 0x70, 0x39, 0x7a, 0x7b, 0xfc, 0x7d, 0x7e, 0x7f,
+    0x70, 0x71, 0xf2, 0x73, 0x74, 0x75, 0x7e, 0x37, 0x78, 0x79, 0x7e, 0x5b, 0x7e, 0x6d, 0x7e, 0x7e,
+    0x00, 0x81, 0x82, 0x83, 0x8c, 0xc5, 0x86, 0x87, 0x8c, 0xa9, 0x8a, 0x8b, 0x8c, 0x8c, 0x8c, 0x9f,
+    0x82, 0x91, 0x82, 0x82, 0x84, 0x85, 0x82, 0xa7, 0x88, 0x89, 0x82, 0xcb, 0x8c, 0x8d, 0x0e, 0x8f,
+    0x90, 0x91, 0x92, 0x13, 0x94, 0x95, 0xd6, 0x9f, 0x98, 0x99, 0xba, 0x9f, 0x8c, 0x9f, 0x9f, 0x9f,
+    0x91, 0x91, 0x82, 0x91, 0xb4, 0x91, 0x96, 0x97, 0xd8, 0x91, 0x9a, 0x9b, 0x9c, 0x1d, 0x9e, 0x9f,
+    0xe0, 0xa9, 0xa2, 0xa3, 0xa4, 0x25, 0xa6, 0xa7, 0xa9, 0xa9, 0xba, 0xa9, 0x8c, 0xa9, 0xae, 0xaf,
+    0xa0, 0xa1, 0x82, 0xa7, 0xb4, 0xa7, 0xa7, 0xa7, 0xa8, 0xa9, 0xaa, 0x2b, 0xac, 0xad, 0xee, 0xa7,
+    0xb0, 0xb1, 0xba, 0xf3, 0xb4, 0xb5, 0x36, 0xb7, 0xba, 0xa9, 0xba, 0xba, 0xbc, 0xbd, 0xba, 0x9f,
+    0xb4, 0x91, 0xb2, 0xb3, 0xb4, 0xb4, 0xb4, 0xa7, 0x38, 0xb9, 0xba, 0xbb, 0xb4, 0xfd, 0xbe, 0xbf,
+    0xe0, 0xc5, 0xc2, 0xc3, 0xc5, 0xc5, 0xd6, 0xc5, 0xc8, 0x49, 0xca, 0xcb, 0x8c, 0xc5, 0xce, 0xcf,
+    0xc0, 0xc1, 0x82, 0xcb, 0xc4, 0xc5, 0xc6, 0x47, 0xd8, 0xcb, 0xcb, 0xcb, 0xcc, 0xcd, 0xee, 0xcb,
+    0xd0, 0xd1, 0xd6, 0xf3, 0xd6, 0xc5, 0xd6, 0xd6, 0xd8, 0xd9, 0x5a, 0xdb, 0xdc, 0xdd, 0xd6, 0x9f,
+    0xd8, 0x91, 0xd2, 0xd3, 0x54, 0xd5, 0xd6, 0xd7, 0xd8, 0xd8, 0xd8, 0xcb, 0xd8, 0xfd, 0xde, 0xdf,
+    0xe0, 0xe0, 0xe0, 0xf3, 0xe0, 0xc5, 0xe6, 0xe7, 0xe0, 0xa9, 0xea, 0xeb, 0x6c, 0xed, 0xee, 0xef,
+    0xe0, 0xe1, 0x62, 0xe3, 0xe4, 0xe5, 0xee, 0xa7, 0xe8, 0xe9, 0xee, 0xcb, 0xee, 0xfd, 0xee, 0xee,
+    0xe0, 0xf3, 0xf3, 0xf3, 0xf4, 0xf5, 0xd6, 0xf3, 0xf8, 0xf9, 0xba, 0xf3, 0xfc, 0xfd, 0xfe, 0x7f,
+    0xf0, 0x71, 0xf2, 0xf3, 0xb4, 0xfd, 0xf6, 0xf7, 0xd8, 0xfd, 0xfa, 0xfb, 0xfd, 0xfd, 0xee, 0xfd,
+    0x90, 0x83, 0x83, 0x83, 0x84, 0x85, 0xa6, 0x83, 0x88, 0x89, 0xca, 0x83, 0x8c, 0x8d, 0x8e, 0x0f,
+    0x80, 0x01, 0x82, 0x83, 0xc4, 0x8d, 0x86, 0x87, 0xa8, 0x8d, 0x8a, 0x8b, 0x8d, 0x8d, 0x9e, 0x8d,
+    0x90, 0x90, 0x90, 0x83, 0x90, 0xb5, 0x96, 0x97, 0x90, 0xd9, 0x9a, 0x9b, 0x1c, 0x9d, 0x9e, 0x9f,
+    0x90, 0x91, 0x12, 0x93, 0x94, 0x95, 0x9e, 0xd7, 0x98, 0x99, 0x9e, 0xbb, 0x9e, 0x8d, 0x9e, 0x9e,
+    0xa0, 0xa1, 0xa6, 0x83, 0xa6, 0xb5, 0xa6, 0xa6, 0xa8, 0xa9, 0x2a, 0xab, 0xac, 0xad, 0xa6, 0xef,
+    0xa8, 0xe1, 0xa2, 0xa3, 0x24, 0xa5, 0xa6, 0xa7, 0xa8, 0xa8, 0xa8, 0xbb, 0xa8, 0x8d, 0xae, 0xaf,
+    0x90, 0xb5, 0xb2, 0xb3, 0xb5, 0xb5, 0xa6, 0xb5, 0xb8, 0x39, 0xba, 0xbb, 0xfc, 0xb5, 0xbe, 0xbf,
+    0xb0, 0xb1, 0xf2, 0xbb, 0xb4, 0xb5, 0xb6, 0x37, 0xa8, 0xbb, 0xbb, 0xbb, 0xbc, 0xbd, 0x9e, 0xbb,
+    0xc0, 0xc1, 0xca, 0x83, 0xc4, 0xc5, 0x46, 0xc7, 0xca, 0xd9, 0xca, 0xca, 0xcc, 0xcd, 0xca, 0xef,
+    0xc4, 0xe1, 0xc2, 0xc3, 0xc4, 0xc4, 0xc4, 0xd7, 0x48, 0xc9, 0xca, 0xcb, 0xc4, 0x8d, 0xce, 0xcf,
+    0x90, 0xd9, 0xd2, 0xd3, 0xd4, 0x55, 0xd6, 0xd7, 0xd9, 0xd9, 0xca, 0xd9, 0xfc, 0xd9, 0xde, 0xdf,
+    0xd0, 0xd1, 0xf2, 0xd7, 0xc4, 0xd7, 0xd7, 0xd7, 0xd8, 0xd9, 0xda, 0x5b, 0xdc, 0xdd, 0x9e, 0xd7,
+    0xe0, 0xe1, 0xe2, 0x63, 0xe4, 0xe5, 0xa6, 0xef, 0xe8, 0xe9, 0xca, 0xef, 0xfc, 0xef, 0xef, 0xef,
+    0xe1, 0xe1, 0xf2, 0xe1, 0xc4, 0xe1, 0xe6, 0xe7, 0xa8, 0xe1, 0xea, 0xeb, 0xec, 0x6d, 0xee, 0xef,
+    0x70, 0xf1, 0xf2, 0xf3, 0xfc, 0xb5, 0xf6, 0xf7, 0xfc, 0xd9, 0xfa, 0xfb, 0xfc, 0xfc, 0xfc, 0xef,
+    0xf2, 0xe1, 0xf2, 0xf2, 0xf4, 0xf5, 0xf2, 0xd7, 0xf8, 0xf9, 0xf2, 0xbb, 0xfc, 0xfd, 0x7e, 0xff,
+    0x00, 0x01, 0x0a, 0x43, 0x04, 0x05, 0x86, 0x07, 0x0a, 0x19, 0x0a, 0x0a, 0x0c, 0x0d, 0x0a, 0x2f,
+    0x04, 0x21, 0x02, 0x03, 0x04, 0x04, 0x04, 0x17, 0x88, 0x09, 0x0a, 0x0b, 0x04, 0x4d, 0x0e, 0x0f,
+    0x50, 0x19, 0x12, 0x13, 0x14, 0x95, 0x16, 0x17, 0x19, 0x19, 0x0a, 0x19, 0x3c, 0x19, 0x1e, 0x1f,
+    0x10, 0x11, 0x32, 0x17, 0x04, 0x17, 0x17, 0x17, 0x18, 0x19, 0x1a, 0x9b, 0x1c, 0x1d, 0x5e, 0x17,
+    0x20, 0x21, 0x22, 0xa3, 0x24, 0x25, 0x66, 0x2f, 0x28, 0x29, 0x0a, 0x2f, 0x3c, 0x2f, 0x2f, 0x2f,
+    0x21, 0x21, 0x32, 0x21, 0x04, 0x21, 0x26, 0x27, 0x68, 0x21, 0x2a, 0x2b, 0x2c, 0xad, 0x2e, 0x2f,
+    0xb0, 0x31, 0x32, 0x33, 0x3c, 0x75, 0x36, 0x37, 0x3c, 0x19, 0x3a, 0x3b, 0x3c, 0x3c, 0x3c, 0x2f,
+    0x32, 0x21, 0x32, 0x32, 0x34, 0x35, 0x32, 0x17, 0x38, 0x39, 0x32, 0x7b, 0x3c, 0x3d, 0xbe, 0x3f,
+    0x50, 0x43, 0x43, 0x43, 0x44, 0x45, 0x66, 0x43, 0x48, 0x49, 0x0a, 0x43, 0x4c, 0x4d, 0x4e, 0xcf,
+    0x40, 0xc1, 0x42, 0x43, 0x04, 0x4d, 0x46, 0x47, 0x68, 0x4d, 0x4a, 0x4b, 0x4d, 0x4d, 0x5e, 0x4d,
+    0x50, 0x50, 0x50, 0x43, 0x50, 0x75, 0x56, 0x57, 0x50, 0x19, 0x5a, 0x5b, 0xdc, 0x5d, 0x5e, 0x5f,
+    0x50, 0x51, 0xd2, 0x53, 0x54, 0x55, 0x5e, 0x17, 0x58, 0x59, 0x5e, 0x7b, 0x5e, 0x4d, 0x5e, 0x5e,
+    0x60, 0x61, 0x66, 0x43, 0x66, 0x75, 0x66, 0x66, 0x68, 0x69, 0xea, 0x6b, 0x6c, 0x6d, 0x66, 0x2f,
+    0x68, 0x21, 0x62, 0x63, 0xe4, 0x65, 0x66, 0x67, 0x68, 0x68, 0x68, 0x7b, 0x68, 0x4d, 0x6e, 0x6f,
+    0x50, 0x75, 0x72, 0x73, 0x75, 0x75, 0x66, 0x75, 0x78, 0xf9, 0x7a, 0x7b, 0x3c, 0x75, 0x7e, 0x7f,
+    0x70, 0x71, 0x32, 0x7b, 0x74, 0x75, 0x76, 0xf7, 0x68, 0x7b, 0x7b, 0x7b, 0x7c, 0x7d, 0x5e, 0x7b,
+    0x20, 0x05, 0x02, 0x03, 0x05, 0x05, 0x16, 0x05, 0x08, 0x89, 0x0a, 0x0b, 0x4c, 0x05, 0x0e, 0x0f,
+    0x00, 0x01, 0x42, 0x0b, 0x04, 0x05, 0x06, 0x87, 0x18, 0x0b, 0x0b, 0x0b, 0x0c, 0x0d, 0x2e, 0x0b,
+    0x10, 0x11, 0x16, 0x33, 0x16, 0x05, 0x16, 0x16, 0x18, 0x19, 0x9a, 0x1b, 0x1c, 0x1d, 0x16, 0x5f,
+    0x18, 0x51, 0x12, 0x13, 0x94, 0x15, 0x16, 0x17, 0x18, 0x18, 0x18, 0x0b, 0x18, 0x3d, 0x1e, 0x1f,
+    0x20, 0x20, 0x20, 0x33, 0x20, 0x05, 0x26, 0x27, 0x20, 0x69, 0x2a, 0x2b, 0xac, 0x2d, 0x2e, 0x2f,
+    0x20, 0x21, 0xa2, 0x23, 0x24, 0x25, 0x2e, 0x67, 0x28, 0x29, 0x2e, 0x0b, 0x2e, 0x3d, 0x2e, 0x2e,
+    0x20, 0x33, 0x33, 0x33, 0x34, 0x35, 0x16, 0x33, 0x38, 0x39, 0x7a, 0x33, 0x3c, 0x3d, 0x3e, 0xbf,
+    0x30, 0xb1, 0x32, 0x33, 0x74, 0x3d, 0x36, 0x37, 0x18, 0x3d, 0x3a, 0x3b, 0x3d, 0x3d, 0x2e, 0x3d,
+    0xc0, 0x41, 0x42, 0x43, 0x4c, 0x05, 0x46, 0x47, 0x4c, 0x69, 0x4a, 0x4b, 0x4c, 0x4c, 0x4c, 0x5f,
+    0x42, 0x51, 0x42, 0x42, 0x44, 0x45, 0x42, 0x67, 0x48, 0x49, 0x42, 0x0b, 0x4c, 0x4d, 0xce, 0x4f,
+    0x50, 0x51, 0x52, 0xd3, 0x54, 0x55, 0x16, 0x5f, 0x58, 0x59, 0x7a, 0x5f, 0x4c, 0x5f, 0x5f, 0x5f,
+    0x51, 0x51, 0x42, 0x51, 0x74, 0x51, 0x56, 0x57, 0x18, 0x51, 0x5a, 0x5b, 0x5c, 0xdd, 0x5e, 0x5f,
+    0x20, 0x69, 0x62, 0x63, 0x64, 0xe5, 0x66, 0x67, 0x69, 0x69, 0x7a, 0x69, 0x4c, 0x69, 0x6e, 0x6f,
+    0x60, 0x61, 0x42, 0x67, 0x74, 0x67, 0x67, 0x67, 0x68, 0x69, 0x6a, 0xeb, 0x6c, 0x6d, 0x2e, 0x67,
+    0x70, 0x71, 0x7a, 0x33, 0x74, 0x75, 0xf6, 0x77, 0x7a, 0x69, 0x7a, 0x7a, 0x7c, 0x7d, 0x7a, 0x5f,
+    0x74, 0x51, 0x72, 0x73, 0x74, 0x74, 0x74, 0x67, 0xf8, 0x79, 0x7a, 0x7b, 0x74, 0x3d, 0x7e, 0x7f,
+    0x80, 0x81, 0x86, 0xa3, 0x86, 0x95, 0x86, 0x86, 0x88, 0x89, 0x0a, 0x8b, 0x8c, 0x8d, 0x86, 0xcf,
+    0x88, 0xc1, 0x82, 0x83, 0x04, 0x85, 0x86, 0x87, 0x88, 0x88, 0x88, 0x9b, 0x88, 0xad, 0x8e, 0x8f,
+    0xb0, 0x95, 0x92, 0x93, 0x95, 0x95, 0x86, 0x95, 0x98, 0x19, 0x9a, 0x9b, 0xdc, 0x95, 0x9e, 0x9f,
+    0x90, 0x91, 0xd2, 0x9b, 0x94, 0x95, 0x96, 0x17, 0x88, 0x9b, 0x9b, 0x9b, 0x9c, 0x9d, 0xbe, 0x9b,
+    0xb0, 0xa3, 0xa3, 0xa3, 0xa4, 0xa5, 0x86, 0xa3, 0xa8, 0xa9, 0xea, 0xa3, 0xac, 0xad, 0xae, 0x2f,
+    0xa0, 0x21, 0xa2, 0xa3, 0xe4, 0xad, 0xa6, 0xa7, 0x88, 0xad, 0xaa, 0xab, 0xad, 0xad, 0xbe, 0xad,
+    0xb0, 0xb0, 0xb0, 0xa3, 0xb0, 0x95, 0xb6, 0xb7, 0xb0, 0xf9, 0xba, 0xbb, 0x3c, 0xbd, 0xbe, 0xbf,
+    0xb0, 0xb1, 0x32, 0xb3, 0xb4, 0xb5, 0xbe, 0xf7, 0xb8, 0xb9, 0xbe, 0x9b, 0xbe, 0xad, 0xbe, 0xbe,
+    0xc0, 0xc1, 0xc2, 0x43, 0xc4, 0xc5, 0x86, 0xcf, 0xc8, 0xc9, 0xea, 0xcf, 0xdc, 0xcf, 0xcf, 0xcf,
+    0xc1, 0xc1, 0xd2, 0xc1, 0xe4, 0xc1, 0xc6, 0xc7, 0x88, 0xc1, 0xca, 0xcb, 0xcc, 0x4d, 0xce, 0xcf,
+    0x50, 0xd1, 0xd2, 0xd3, 0xdc, 0x95, 0xd6, 0xd7, 0xdc, 0xf9, 0xda, 0xdb, 0xdc, 0xdc, 0xdc, 0xcf,
+    0xd2, 0xc1, 0xd2, 0xd2, 0xd4, 0xd5, 0xd2, 0xf7, 0xd8, 0xd9, 0xd2, 0x9b, 0xdc, 0xdd, 0x5e, 0xdf,
+    0xe0, 0xe1, 0xea, 0xa3, 0xe4, 0xe5, 0x66, 0xe7, 0xea, 0xf9, 0xea, 0xea, 0xec, 0xed, 0xea, 0xcf,
+    0xe4, 0xc1, 0xe2, 0xe3, 0xe4, 0xe4, 0xe4, 0xf7, 0x68, 0xe9, 0xea, 0xeb, 0xe4, 0xad, 0xee, 0xef,
+    0xb0, 0xf9, 0xf2, 0xf3, 0xf4, 0x75, 0xf6, 0xf7, 0xf9, 0xf9, 0xea, 0xf9, 0xdc, 0xf9, 0xfe, 0xff,
+    0xf0, 0xf1, 0xd2, 0xf7, 0xe4, 0xf7, 0xf7, 0xf7, 0xf8, 0xf9, 0xfa, 0x7b, 0xfc, 0xfd, 0xbe, 0xf7,
+    0xc0, 0x89, 0x82, 0x83, 0x84, 0x05, 0x86, 0x87, 0x89, 0x89, 0x9a, 0x89, 0xac, 0x89, 0x8e, 0x8f,
+    0x80, 0x81, 0xa2, 0x87, 0x94, 0x87, 0x87, 0x87, 0x88, 0x89, 0x8a, 0x0b, 0x8c, 0x8d, 0xce, 0x87,
+    0x90, 0x91, 0x9a, 0xd3, 0x94, 0x95, 0x16, 0x97, 0x9a, 0x89, 0x9a, 0x9a, 0x9c, 0x9d, 0x9a, 0xbf,
+    0x94, 0xb1, 0x92, 0x93, 0x94, 0x94, 0x94, 0x87, 0x18, 0x99, 0x9a, 0x9b, 0x94, 0xdd, 0x9e, 0x9f,
+    0x20, 0xa1, 0xa2, 0xa3, 0xac, 0xe5, 0xa6, 0xa7, 0xac, 0x89, 0xaa, 0xab, 0xac, 0xac, 0xac, 0xbf,
+    0xa2, 0xb1, 0xa2, 0xa2, 0xa4, 0xa5, 0xa2, 0x87, 0xa8, 0xa9, 0xa2, 0xeb, 0xac, 0xad, 0x2e, 0xaf,
+    0xb0, 0xb1, 0xb2, 0x33, 0xb4, 0xb5, 0xf6, 0xbf, 0xb8, 0xb9, 0x9a, 0xbf, 0xac, 0xbf, 0xbf, 0xbf,
+    0xb1, 0xb1, 0xa2, 0xb1, 0x94, 0xb1, 0xb6, 0xb7, 0xf8, 0xb1, 0xba, 0xbb, 0xbc, 0x3d, 0xbe, 0xbf,
+    0xc0, 0xc0, 0xc0, 0xd3, 0xc0, 0xe5, 0xc6, 0xc7, 0xc0, 0x89, 0xca, 0xcb, 0x4c, 0xcd, 0xce, 0xcf,
+    0xc0, 0xc1, 0x42, 0xc3, 0xc4, 0xc5, 0xce, 0x87, 0xc8, 0xc9, 0xce, 0xeb, 0xce, 0xdd, 0xce, 0xce,
+    0xc0, 0xd3, 0xd3, 0xd3, 0xd4, 0xd5, 0xf6, 0xd3, 0xd8, 0xd9, 0x9a, 0xd3, 0xdc, 0xdd, 0xde, 0x5f,
+    0xd0, 0x51, 0xd2, 0xd3, 0x94, 0xdd, 0xd6, 0xd7, 0xf8, 0xdd, 0xda, 0xdb, 0xdd, 0xdd, 0xce, 0xdd,
+    0xc0, 0xe5, 0xe2, 0xe3, 0xe5, 0xe5, 0xf6, 0xe5, 0xe8, 0x69, 0xea, 0xeb, 0xac, 0xe5, 0xee, 0xef,
+    0xe0, 0xe1, 0xa2, 0xeb, 0xe4, 0xe5, 0xe6, 0x67, 0xf8, 0xeb, 0xeb, 0xeb, 0xec, 0xed, 0xce, 0xeb,
+    0xf0, 0xf1, 0xf6, 0xd3, 0xf6, 0xe5, 0xf6, 0xf6, 0xf8, 0xf9, 0x7a, 0xfb, 0xfc, 0xfd, 0xf6, 0xbf,
+    0xf8, 0xb1, 0xf2, 0xf3, 0x74, 0xf5, 0xf6, 0xf7, 0xf8, 0xf8, 0xf8, 0xeb, 0xf8, 0xdd, 0xfe, 0xff,
+    0x00, 0x01, 0x06, 0x23, 0x06, 0x15, 0x06, 0x06, 0x08, 0x09, 0x8a, 0x0b, 0x0c, 0x0d, 0x06, 0x4f,
+    0x08, 0x41, 0x02, 0x03, 0x84, 0x05, 0x06, 0x07, 0x08, 0x08, 0x08, 0x1b, 0x08, 0x2d, 0x0e, 0x0f,
+    0x30, 0x15, 0x12, 0x13, 0x15, 0x15, 0x06, 0x15, 0x18, 0x99, 0x1a, 0x1b, 0x5c, 0x15, 0x1e, 0x1f,
+    0x10, 0x11, 0x52, 0x1b, 0x14, 0x15, 0x16, 0x97, 0x08, 0x1b, 0x1b, 0x1b, 0x1c, 0x1d, 0x3e, 0x1b,
+    0x30, 0x23, 0x23, 0x23, 0x24, 0x25, 0x06, 0x23, 0x28, 0x29, 0x6a, 0x23, 0x2c, 0x2d, 0x2e, 0xaf,
+    0x20, 0xa1, 0x22, 0x23, 0x64, 0x2d, 0x26, 0x27, 0x08, 0x2d, 0x2a, 0x2b, 0x2d, 0x2d, 0x3e, 0x2d,
+    0x30, 0x30, 0x30, 0x23, 0x30, 0x15, 0x36, 0x37, 0x30, 0x79, 0x3a, 0x3b, 0xbc, 0x3d, 0x3e, 0x3f,
+    0x30, 0x31, 0xb2, 0x33, 0x34, 0x35, 0x3e, 0x77, 0x38, 0x39, 0x3e, 0x1b, 0x3e, 0x2d, 0x3e, 0x3e,
+    0x40, 0x41, 0x42, 0xc3, 0x44, 0x45, 0x06, 0x4f, 0x48, 0x49, 0x6a, 0x4f, 0x5c, 0x4f, 0x4f, 0x4f,
+    0x41, 0x41, 0x52, 0x41, 0x64, 0x41, 0x46, 0x47, 0x08, 0x41, 0x4a, 0x4b, 0x4c, 0xcd, 0x4e, 0x4f,
+    0xd0, 0x51, 0x52, 0x53, 0x5c, 0x15, 0x56, 0x57, 0x5c, 0x79, 0x5a, 0x5b, 0x5c, 0x5c, 0x5c, 0x4f,
+    0x52, 0x41, 0x52, 0x52, 0x54, 0x55, 0x52, 0x77, 0x58, 0x59, 0x52, 0x1b, 0x5c, 0x5d, 0xde, 0x5f,
+    0x60, 0x61, 0x6a, 0x23, 0x64, 0x65, 0xe6, 0x67, 0x6a, 0x79, 0x6a, 0x6a, 0x6c, 0x6d, 0x6a, 0x4f,
+    0x64, 0x41, 0x62, 0x63, 0x64, 0x64, 0x64, 0x77, 0xe8, 0x69, 0x6a, 0x6b, 0x64, 0x2d, 0x6e, 0x6f,
+    0x30, 0x79, 0x72, 0x73, 0x74, 0xf5, 0x76, 0x77, 0x79, 0x79, 0x6a, 0x79, 0x5c, 0x79, 0x7e, 0x7f,
+    0x70, 0x71, 0x52, 0x77, 0x64, 0x77, 0x77, 0x77, 0x78, 0x79, 0x7a, 0xfb, 0x7c, 0x7d, 0x3e, 0x77,
+    0x40, 0x09, 0x02, 0x03, 0x04, 0x85, 0x06, 0x07, 0x09, 0x09, 0x1a, 0x09, 0x2c, 0x09, 0x0e, 0x0f,
+    0x00, 0x01, 0x22, 0x07, 0x14, 0x07, 0x07, 0x07, 0x08, 0x09, 0x0a, 0x8b, 0x0c, 0x0d, 0x4e, 0x07,
+    0x10, 0x11, 0x1a, 0x53, 0x14, 0x15, 0x96, 0x17, 0x1a, 0x09, 0x1a, 0x1a, 0x1c, 0x1d, 0x1a, 0x3f,
+    0x14, 0x31, 0x12, 0x13, 0x14, 0x14, 0x14, 0x07, 0x98, 0x19, 0x1a, 0x1b, 0x14, 0x5d, 0x1e, 0x1f,
+    0xa0, 0x21, 0x22, 0x23, 0x2c, 0x65, 0x26, 0x27, 0x2c, 0x09, 0x2a, 0x2b, 0x2c, 0x2c, 0x2c, 0x3f,
+    0x22, 0x31, 0x22, 0x22, 0x24, 0x25, 0x22, 0x07, 0x28, 0x29, 0x22, 0x6b, 0x2c, 0x2d, 0xae, 0x2f,
+    0x30, 0x31, 0x32, 0xb3, 0x34, 0x35, 0x76, 0x3f, 0x38, 0x39, 0x1a, 0x3f, 0x2c, 0x3f, 0x3f, 0x3f,
+    0x31, 0x31, 0x22, 0x31, 0x14, 0x31, 0x36, 0x37, 0x78, 0x31, 0x3a, 0x3b, 0x3c, 0xbd, 0x3e, 0x3f,
+    0x40, 0x40, 0x40, 0x53, 0x40, 0x65, 0x46, 0x47, 0x40, 0x09, 0x4a, 0x4b, 0xcc, 0x4d, 0x4e, 0x4f,
+    0x40, 0x41, 0xc2, 0x43, 0x44, 0x45, 0x4e, 0x07, 0x48, 0x49, 0x4e, 0x6b, 0x4e, 0x5d, 0x4e, 0x4e,
+    0x40, 0x53, 0x53, 0x53, 0x54, 0x55, 0x76, 0x53, 0x58, 0x59, 0x1a, 0x53, 0x5c, 0x5d, 0x5e, 0xdf,
+    0x50, 0xd1, 0x52, 0x53, 0x14, 0x5d, 0x56, 0x57, 0x78, 0x5d, 0x5a, 0x5b, 0x5d, 0x5d, 0x4e, 0x5d,
+    0x40, 0x65, 0x62, 0x63, 0x65, 0x65, 0x76, 0x65, 0x68, 0xe9, 0x6a, 0x6b, 0x2c, 0x65, 0x6e, 0x6f,
+    0x60, 0x61, 0x22, 0x6b, 0x64, 0x65, 0x66, 0xe7, 0x78, 0x6b, 0x6b, 0x6b, 0x6c, 0x6d, 0x4e, 0x6b,
+    0x70, 0x71, 0x76, 0x53, 0x76, 0x65, 0x76, 0x76, 0x78, 0x79, 0xfa, 0x7b, 0x7c, 0x7d, 0x76, 0x3f,
+    0x78, 0x31, 0x72, 0x73, 0xf4, 0x75, 0x76, 0x77, 0x78, 0x78, 0x78, 0x6b, 0x78, 0x5d, 0x7e, 0x7f,
+    0x80, 0x81, 0x8a, 0xc3, 0x84, 0x85, 0x06, 0x87, 0x8a, 0x99, 0x8a, 0x8a, 0x8c, 0x8d, 0x8a, 0xaf,
+    0x84, 0xa1, 0x82, 0x83, 0x84, 0x84, 0x84, 0x97, 0x08, 0x89, 0x8a, 0x8b, 0x84, 0xcd, 0x8e, 0x8f,
+    0xd0, 0x99, 0x92, 0x93, 0x94, 0x15, 0x96, 0x97, 0x99, 0x99, 0x8a, 0x99, 0xbc, 0x99, 0x9e, 0x9f,
+    0x90, 0x91, 0xb2, 0x97, 0x84, 0x97, 0x97, 0x97, 0x98, 0x99, 0x9a, 0x1b, 0x9c, 0x9d, 0xde, 0x97,
+    0xa0, 0xa1, 0xa2, 0x23, 0xa4, 0xa5, 0xe6, 0xaf, 0xa8, 0xa9, 0x8a, 0xaf, 0xbc, 0xaf, 0xaf, 0xaf,
+    0xa1, 0xa1, 0xb2, 0xa1, 0x84, 0xa1, 0xa6, 0xa7, 0xe8, 0xa1, 0xaa, 0xab, 0xac, 0x2d, 0xae, 0xaf,
+    0x30, 0xb1, 0xb2, 0xb3, 0xbc, 0xf5, 0xb6, 0xb7, 0xbc, 0x99, 0xba, 0xbb, 0xbc, 0xbc, 0xbc, 0xaf,
+    0xb2, 0xa1, 0xb2, 0xb2, 0xb4, 0xb5, 0xb2, 0x97, 0xb8, 0xb9, 0xb2, 0xfb, 0xbc, 0xbd, 0x3e, 0xbf,
+    0xd0, 0xc3, 0xc3, 0xc3, 0xc4, 0xc5, 0xe6, 0xc3, 0xc8, 0xc9, 0x8a, 0xc3, 0xcc, 0xcd, 0xce, 0x4f,
+    0xc0, 0x41, 0xc2, 0xc3, 0x84, 0xcd, 0xc6, 0xc7, 0xe8, 0xcd, 0xca, 0xcb, 0xcd, 0xcd, 0xde, 0xcd,
+    0xd0, 0xd0, 0xd0, 0xc3, 0xd0, 0xf5, 0xd6, 0xd7, 0xd0, 0x99, 0xda, 0xdb, 0x5c, 0xdd, 0xde, 0xdf,
+    0xd0, 0xd1, 0x52, 0xd3, 0xd4, 0xd5, 0xde, 0x97, 0xd8, 0xd9, 0xde, 0xfb, 0xde, 0xcd, 0xde, 0xde,
+    0xe0, 0xe1, 0xe6, 0xc3, 0xe6, 0xf5, 0xe6, 0xe6, 0xe8, 0xe9, 0x6a, 0xeb, 0xec, 0xed, 0xe6, 0xaf,
+    0xe8, 0xa1, 0xe2, 0xe3, 0x64, 0xe5, 0xe6, 0xe7, 0xe8, 0xe8, 0xe8, 0xfb, 0xe8, 0xcd, 0xee, 0xef,
+    0xd0, 0xf5, 0xf2, 0xf3, 0xf5, 0xf5, 0xe6, 0xf5, 0xf8, 0x79, 0xfa, 0xfb, 0xbc, 0xf5, 0xfe, 0xff,
+    0xf0, 0xf1, 0xb2, 0xfb, 0xf4, 0xf5, 0xf6, 0x77, 0xe8, 0xfb, 0xfb, 0xfb, 0xfc, 0xfd, 0xde, 0xfb,
+    0xa0, 0x85, 0x82, 0x83, 0x85, 0x85, 0x96, 0x85, 0x88, 0x09, 0x8a, 0x8b, 0xcc, 0x85, 0x8e, 0x8f,
+    0x80, 0x81, 0xc2, 0x8b, 0x84, 0x85, 0x86, 0x07, 0x98, 0x8b, 0x8b, 0x8b, 0x8c, 0x8d, 0xae, 0x8b,
+    0x90, 0x91, 0x96, 0xb3, 0x96, 0x85, 0x96, 0x96, 0x98, 0x99, 0x1a, 0x9b, 0x9c, 0x9d, 0x96, 0xdf,
+    0x98, 0xd1, 0x92, 0x93, 0x14, 0x95, 0x96, 0x97, 0x98, 0x98, 0x98, 0x8b, 0x98, 0xbd, 0x9e, 0x9f,
+    0xa0, 0xa0, 0xa0, 0xb3, 0xa0, 0x85, 0xa6, 0xa7, 0xa0, 0xe9, 0xaa, 0xab, 0x2c, 0xad, 0xae, 0xaf,
+    0xa0, 0xa1, 0x22, 0xa3, 0xa4, 0xa5, 0xae, 0xe7, 0xa8, 0xa9, 0xae, 0x8b, 0xae, 0xbd, 0xae, 0xae,
+    0xa0, 0xb3, 0xb3, 0xb3, 0xb4, 0xb5, 0x96, 0xb3, 0xb8, 0xb9, 0xfa, 0xb3, 0xbc, 0xbd, 0xbe, 0x3f,
+    0xb0, 0x31, 0xb2, 0xb3, 0xf4, 0xbd, 0xb6, 0xb7, 0x98, 0xbd, 0xba, 0xbb, 0xbd, 0xbd, 0xae, 0xbd,
+    0x40, 0xc1, 0xc2, 0xc3, 0xcc, 0x85, 0xc6, 0xc7, 0xcc, 0xe9, 0xca, 0xcb, 0xcc, 0xcc, 0xcc, 0xdf,
+    0xc2, 0xd1, 0xc2, 0xc2, 0xc4, 0xc5, 0xc2, 0xe7, 0xc8, 0xc9, 0xc2, 0x8b, 0xcc, 0xcd, 0x4e, 0xcf,
+    0xd0, 0xd1, 0xd2, 0x53, 0xd4, 0xd5, 0x96, 0xdf, 0xd8, 0xd9, 0xfa, 0xdf, 0xcc, 0xdf, 0xdf, 0xdf,
+    0xd1, 0xd1, 0xc2, 0xd1, 0xf4, 0xd1, 0xd6, 0xd7, 0x98, 0xd1, 0xda, 0xdb, 0xdc, 0x5d, 0xde, 0xdf,
+    0xa0, 0xe9, 0xe2, 0xe3, 0xe4, 0x65, 0xe6, 0xe7, 0xe9, 0xe9, 0xfa, 0xe9, 0xcc, 0xe9, 0xee, 0xef,
+    0xe0, 0xe1, 0xc2, 0xe7, 0xf4, 0xe7, 0xe7, 0xe7, 0xe8, 0xe9, 0xea, 0x6b, 0xec, 0xed, 0xae, 0xe7,
+    0xf0, 0xf1, 0xfa, 0xb3, 0xf4, 0xf5, 0x76, 0xf7, 0xfa, 0xe9, 0xfa, 0xfa, 0xfc, 0xfd, 0xfa, 0xdf,
+    0xf4, 0xd1, 0xf2, 0xf3, 0xf4, 0xf4, 0xf4, 0xe7, 0x78, 0xf9, 0xfa, 0xfb, 0xf4, 0xbd, 0xfe, 0xff,
+    0x80, 0x01, 0x02, 0x03, 0x0c, 0x45, 0x06, 0x07, 0x0c, 0x29, 0x0a, 0x0b, 0x0c, 0x0c, 0x0c, 0x1f,
+    0x02, 0x11, 0x02, 0x02, 0x04, 0x05, 0x02, 0x27, 0x08, 0x09, 0x02, 0x4b, 0x0c, 0x0d, 0x8e, 0x0f,
+    0x10, 0x11, 0x12, 0x93, 0x14, 0x15, 0x56, 0x1f, 0x18, 0x19, 0x3a, 0x1f, 0x0c, 0x1f, 0x1f, 0x1f,
+    0x11, 0x11, 0x02, 0x11, 0x34, 0x11, 0x16, 0x17, 0x58, 0x11, 0x1a, 0x1b, 0x1c, 0x9d, 0x1e, 0x1f,
+    0x60, 0x29, 0x22, 0x23, 0x24, 0xa5, 0x26, 0x27, 0x29, 0x29, 0x3a, 0x29, 0x0c, 0x29, 0x2e, 0x2f,
+    0x20, 0x21, 0x02, 0x27, 0x34, 0x27, 0x27, 0x27, 0x28, 0x29, 0x2a, 0xab, 0x2c, 0x2d, 0x6e, 0x27,
+    0x30, 0x31, 0x3a, 0x73, 0x34, 0x35, 0xb6, 0x37, 0x3a, 0x29, 0x3a, 0x3a, 0x3c, 0x3d, 0x3a, 0x1f,
+    0x34, 0x11, 0x32, 0x33, 0x34, 0x34, 0x34, 0x27, 0xb8, 0x39, 0x3a, 0x3b, 0x34, 0x7d, 0x3e, 0x3f,
+    0x60, 0x45, 0x42, 0x43, 0x45, 0x45, 0x56, 0x45, 0x48, 0xc9, 0x4a, 0x4b, 0x0c, 0x45, 0x4e, 0x4f,
+    0x40, 0x41, 0x02, 0x4b, 0x44, 0x45, 0x46, 0xc7, 0x58, 0x4b, 0x4b, 0x4b, 0x4c, 0x4d, 0x6e, 0x4b,
+    0x50, 0x51, 0x56, 0x73, 0x56, 0x45, 0x56, 0x56, 0x58, 0x59, 0xda, 0x5b, 0x5c, 0x5d, 0x56, 0x1f,
+    0x58, 0x11, 0x52, 0x53, 0xd4, 0x55, 0x56, 0x57, 0x58, 0x58, 0x58, 0x4b, 0x58, 0x7d, 0x5e, 0x5f,
+    0x60, 0x60, 0x60, 0x73, 0x60, 0x45, 0x66, 0x67, 0x60, 0x29, 0x6a, 0x6b, 0xec, 0x6d, 0x6e, 0x6f,
+    0x60, 0x61, 0xe2, 0x63, 0x64, 0x65, 0x6e, 0x27, 0x68, 0x69, 0x6e, 0x4b, 0x6e, 0x7d, 0x6e, 0x6e,
+    0x60, 0x73, 0x73, 0x73, 0x74, 0x75, 0x56, 0x73, 0x78, 0x79, 0x3a, 0x73, 0x7c, 0x7d, 0x7e, 0xff,
+    0x70, 0xf1, 0x72, 0x73, 0x34, 0x7d, 0x76, 0x77, 0x58, 0x7d, 0x7a, 0x7b, 0x7d, 0x7d, 0x6e, 0x7d,
+    0x10, 0x03, 0x03, 0x03, 0x04, 0x05, 0x26, 0x03, 0x08, 0x09, 0x4a, 0x03, 0x0c, 0x0d, 0x0e, 0x8f,
+    0x00, 0x81, 0x02, 0x03, 0x44, 0x0d, 0x06, 0x07, 0x28, 0x0d, 0x0a, 0x0b, 0x0d, 0x0d, 0x1e, 0x0d,
+    0x10, 0x10, 0x10, 0x03, 0x10, 0x35, 0x16, 0x17, 0x10, 0x59, 0x1a, 0x1b, 0x9c, 0x1d, 0x1e, 0x1f,
+    0x10, 0x11, 0x92, 0x13, 0x14, 0x15, 0x1e, 0x57, 0x18, 0x19, 0x1e, 0x3b, 0x1e, 0x0d, 0x1e, 0x1e,
+    0x20, 0x21, 0x26, 0x03, 0x26, 0x35, 0x26, 0x26, 0x28, 0x29, 0xaa, 0x2b, 0x2c, 0x2d, 0x26, 0x6f,
+    0x28, 0x61, 0x22, 0x23, 0xa4, 0x25, 0x26, 0x27, 0x28, 0x28, 0x28, 0x3b, 0x28, 0x0d, 0x2e, 0x2f,
+    0x10, 0x35, 0x32, 0x33, 0x35, 0x35, 0x26, 0x35, 0x38, 0xb9, 0x3a, 0x3b, 0x7c, 0x35, 0x3e, 0x3f,
+    0x30, 0x31, 0x72, 0x3b, 0x34, 0x35, 0x36, 0xb7, 0x28, 0x3b, 0x3b, 0x3b, 0x3c, 0x3d, 0x1e, 0x3b,
+    0x40, 0x41, 0x4a, 0x03, 0x44, 0x45, 0xc6, 0x47, 0x4a, 0x59, 0x4a, 0x4a, 0x4c, 0x4d, 0x4a, 0x6f,
+    0x44, 0x61, 0x42, 0x43, 0x44, 0x44, 0x44, 0x57, 0xc8, 0x49, 0x4a, 0x4b, 0x44, 0x0d, 0x4e, 0x4f,
+    0x10, 0x59, 0x52, 0x53, 0x54, 0xd5, 0x56, 0x57, 0x59, 0x59, 0x4a, 0x59, 0x7c, 0x59, 0x5e, 0x5f,
+    0x50, 0x51, 0x72, 0x57, 0x44, 0x57, 0x57, 0x57, 0x58, 0x59, 0x5a, 0xdb, 0x5c, 0x5d, 0x1e, 0x57,
+    0x60, 0x61, 0x62, 0xe3, 0x64, 0x65, 0x26, 0x6f, 0x68, 0x69, 0x4a, 0x6f, 0x7c, 0x6f, 0x6f, 0x6f,
+    0x61, 0x61, 0x72, 0x61, 0x44, 0x61, 0x66, 0x67, 0x28, 0x61, 0x6a, 0x6b, 0x6c, 0xed, 0x6e, 0x6f,
+    0xf0, 0x71, 0x72, 0x73, 0x7c, 0x35, 0x76, 0x77, 0x7c, 0x59, 0x7a, 0x7b, 0x7c, 0x7c, 0x7c, 0x6f,
+    0x72, 0x61, 0x72, 0x72, 0x74, 0x75, 0x72, 0x57, 0x78, 0x79, 0x72, 0x3b, 0x7c, 0x7d, 0xfe, 0x7f,
+    0x80, 0x80, 0x80, 0x93, 0x80, 0xa5, 0x86, 0x87, 0x80, 0xc9, 0x8a, 0x8b, 0x0c, 0x8d, 0x8e, 0x8f,
+    0x80, 0x81, 0x02, 0x83, 0x84, 0x85, 0x8e, 0xc7, 0x88, 0x89, 0x8e, 0xab, 0x8e, 0x9d, 0x8e, 0x8e,
+    0x80, 0x93, 0x93, 0x93, 0x94, 0x95, 0xb6, 0x93, 0x98, 0x99, 0xda, 0x93, 0x9c, 0x9d, 0x9e, 0x1f,
+    0x90, 0x11, 0x92, 0x93, 0xd4, 0x9d, 0x96, 0x97, 0xb8, 0x9d, 0x9a, 0x9b, 0x9d, 0x9d, 0x8e, 0x9d,
+    0x80, 0xa5, 0xa2, 0xa3, 0xa5, 0xa5, 0xb6, 0xa5, 0xa8, 0x29, 0xaa, 0xab, 0xec, 0xa5, 0xae, 0xaf,
+    0xa0, 0xa1, 0xe2, 0xab, 0xa4, 0xa5, 0xa6, 0x27, 0xb8, 0xab, 0xab, 0xab, 0xac, 0xad, 0x8e, 0xab,
+    0xb0, 0xb1, 0xb6, 0x93, 0xb6, 0xa5, 0xb6, 0xb6, 0xb8, 0xb9, 0x3a, 0xbb, 0xbc, 0xbd, 0xb6, 0xff,
+    0xb8, 0xf1, 0xb2, 0xb3, 0x34, 0xb5, 0xb6, 0xb7, 0xb8, 0xb8, 0xb8, 0xab, 0xb8, 0x9d, 0xbe, 0xbf,
+    0x80, 0xc9, 0xc2, 0xc3, 0xc4, 0x45, 0xc6, 0xc7, 0xc9, 0xc9, 0xda, 0xc9, 0xec, 0xc9, 0xce, 0xcf,
+    0xc0, 0xc1, 0xe2, 0xc7, 0xd4, 0xc7, 0xc7, 0xc7, 0xc8, 0xc9, 0xca, 0x4b, 0xcc, 0xcd, 0x8e, 0xc7,
+    0xd0, 0xd1, 0xda, 0x93, 0xd4, 0xd5, 0x56, 0xd7, 0xda, 0xc9, 0xda, 0xda, 0xdc, 0xdd, 0xda, 0xff,
+    0xd4, 0xf1, 0xd2, 0xd3, 0xd4, 0xd4, 0xd4, 0xc7, 0x58, 0xd9, 0xda, 0xdb, 0xd4, 0x9d, 0xde, 0xdf,
+    0x60, 0xe1, 0xe2, 0xe3, 0xec, 0xa5, 0xe6, 0xe7, 0xec, 0xc9, 0xea, 0xeb, 0xec, 0xec, 0xec, 0xff,
+    0xe2, 0xf1, 0xe2, 0xe2, 0xe4, 0xe5, 0xe2, 0xc7, 0xe8, 0xe9, 0xe2, 0xab, 0xec, 0xed, 0x6e, 0xef,
+    0xf0, 0xf1, 0xf2, 0x73, 0xf4, 0xf5, 0xb6, 0xff, 0xf8, 0xf9, 0xda, 0xff, 0xec, 0xff, 0xff, 0xff,
+    0xf1, 0xf1, 0xe2, 0xf1, 0xd4, 0xf1, 0xf6, 0xf7, 0xb8, 0xf1, 0xfa, 0xfb, 0xfc, 0x7d, 0xfe, 0xff,
+    0x80, 0x81, 0x82, 0x03, 0x84, 0x85, 0xc6, 0x8f, 0x88, 0x89, 0xaa, 0x8f, 0x9c, 0x8f, 0x8f, 0x8f,
+    0x81, 0x81, 0x92, 0x81, 0xa4, 0x81, 0x86, 0x87, 0xc8, 0x81, 0x8a, 0x8b, 0x8c, 0x0d, 0x8e, 0x8f,
+    0x10, 0x91, 0x92, 0x93, 0x9c, 0xd5, 0x96, 0x97, 0x9c, 0xb9, 0x9a, 0x9b, 0x9c, 0x9c, 0x9c, 0x8f,
+    0x92, 0x81, 0x92, 0x92, 0x94, 0x95, 0x92, 0xb7, 0x98, 0x99, 0x92, 0xdb, 0x9c, 0x9d, 0x1e, 0x9f,
+    0xa0, 0xa1, 0xaa, 0xe3, 0xa4, 0xa5, 0x26, 0xa7, 0xaa, 0xb9, 0xaa, 0xaa, 0xac, 0xad, 0xaa, 0x8f,
+    0xa4, 0x81, 0xa2, 0xa3, 0xa4, 0xa4, 0xa4, 0xb7, 0x28, 0xa9, 0xaa, 0xab, 0xa4, 0xed, 0xae, 0xaf,
+    0xf0, 0xb9, 0xb2, 0xb3, 0xb4, 0x35, 0xb6, 0xb7, 0xb9, 0xb9, 0xaa, 0xb9, 0x9c, 0xb9, 0xbe, 0xbf,
+    0xb0, 0xb1, 0x92, 0xb7, 0xa4, 0xb7, 0xb7, 0xb7, 0xb8, 0xb9, 0xba, 0x3b, 0xbc, 0xbd, 0xfe, 0xb7,
+    0xc0, 0xc1, 0xc6, 0xe3, 0xc6, 0xd5, 0xc6, 0xc6, 0xc8, 0xc9, 0x4a, 0xcb, 0xcc, 0xcd, 0xc6, 0x8f,
+    0xc8, 0x81, 0xc2, 0xc3, 0x44, 0xc5, 0xc6, 0xc7, 0xc8, 0xc8, 0xc8, 0xdb, 0xc8, 0xed, 0xce, 0xcf,
+    0xf0, 0xd5, 0xd2, 0xd3, 0xd5, 0xd5, 0xc6, 0xd5, 0xd8, 0x59, 0xda, 0xdb, 0x9c, 0xd5, 0xde, 0xdf,
+    0xd0, 0xd1, 0x92, 0xdb, 0xd4, 0xd5, 0xd6, 0x57, 0xc8, 0xdb, 0xdb, 0xdb, 0xdc, 0xdd, 0xfe, 0xdb,
+    0xf0, 0xe3, 0xe3, 0xe3, 0xe4, 0xe5, 0xc6, 0xe3, 0xe8, 0xe9, 0xaa, 0xe3, 0xec, 0xed, 0xee, 0x6f,
+    0xe0, 0x61, 0xe2, 0xe3, 0xa4, 0xed, 0xe6, 0xe7, 0xc8, 0xed, 0xea, 0xeb, 0xed, 0xed, 0xfe, 0xed,
+    0xf0, 0xf0, 0xf0, 0xe3, 0xf0, 0xd5, 0xf6, 0xf7, 0xf0, 0xb9, 0xfa, 0xfb, 0x7c, 0xfd, 0xfe, 0xff,
+    0xf0, 0xf1, 0x72, 0xf3, 0xf4, 0xf5, 0xfe, 0xb7, 0xf8, 0xf9, 0xfe, 0xdb, 0xfe, 0xed, 0xfe, 0xfe
+};
 
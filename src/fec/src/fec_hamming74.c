@@ -35,6 +35,26 @@ unsigned char hamming74_enc_gentab[16] = {
     0x00, 0x69, 0x2a, 0x43, 0x4c, 0x25, 0x66, 0x0f,
     0x70, 0x19, 0x5a, 0x33, 0x3c, 0x55, 0x16, 0x7f};
 
+// soft decoder look-up table: codewords with bits expanded to bytes
+// (last byte is padding)
+static const unsigned char hamming74_soft_gentab[16][8] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    {0xff, 0xff, 0x00, 0xff, 0x00, 0x00, 0xff, 0x00},
+    {0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0x00},
+    {0xff, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x00},
+    {0xff, 0x00, 0x00, 0xff, 0xff, 0x00, 0x00, 0x00},
+    {0x00, 0xff, 0x00, 0x00, 0xff, 0x00, 0xff, 0x00},
+    {0xff, 0xff, 0x00, 0x00, 0xff, 0xff, 0x00, 0x00},
+    {0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0x00},
+    {0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00},
+    {0x00, 0x00, 0xff, 0xff, 0x00, 0x00, 0xff, 0x00},
+    {0xff, 0x00, 0xff, 0xff, 0x00, 0xff, 0x00, 0x00},
+    {0x00, 0xff, 0xff, 0x00, 0x00, 0xff, 0xff, 0x00},
+    {0x00, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00},
+    {0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00},
+    {0x00, 0x00, 0xff, 0x00, 0xff, 0xff, 0x00, 0x00},
+    {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00}};
+
 // decoder look-up table
 unsigned char hamming74_dec_gentab[128] = {
     0x00, 0x00, 0x00, 0x03, 0x00, 0x05, 0x0e, 0x07,
@@ -202,30 +222,5 @@ void fec_hamming74_decode_soft(fec _q,
 unsigned char fecsoft_hamming74_decode(unsigned char * _soft_bits)
 {
     // find symbol with minimum distance from all 2^4 possible
-    unsigned int d;             // distance metric
-    unsigned int dmin = 0;      // minimum distance
-    unsigned char s_hat = 0;    // estimated transmitted symbol
-    unsigned char c;            // encoded symbol
-
-    unsigned char s;
-    for (s=0; s<16; s++) {
-        // encode symbol
-        c = hamming74_enc_gentab[s];
-
-        // compute distance metric
-        d = 0;
-        d += (c & 0x40) ? 255 - _soft_bits[0] : _soft_bits[0];
-        d += (c & 0x20) ? 255 - _soft_bits[1] : _soft_bits[1];
-        d += (c & 0x10) ? 255 - _soft_bits[2] : _soft_bits[2];
-        d += (c & 0x08) ? 255 - _soft_bits[3] : _soft_bits[3];
-        d += (c & 0x04) ? 255 - _soft_bits[4] : _soft_bits[4];
-        d += (c & 0x02) ? 255 - _soft_bits[5] : _soft_bits[5];
-        d += (c & 0x01) ? 255 - _soft_bits[6] : _soft_bits[6];
-
-        if (d < dmin || s==0) {
-            s_hat = s;
-            dmin = d;
-        }
-    }
-    return s_hat;
+    return (unsigned char) fecsoft_ml16_decode(_soft_bits, 7, &hamming74_soft_gentab[0][0]);
 }
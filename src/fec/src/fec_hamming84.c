@@ -35,6 +35,25 @@ unsigned char hamming84_enc_gentab[16] = {
     0x00, 0xd2, 0x55, 0x87, 0x99, 0x4b, 0xcc, 0x1e,
     0xe1, 0x33, 0xb4, 0x66, 0x78, 0xaa, 0x2d, 0xff};
 
+// soft decoder look-up table: codewords with bits expanded to bytes
+static const unsigned char hamming84_soft_gentab[16][8] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    {0xff, 0xff, 0x00, 0xff, 0x00, 0x00, 0xff, 0x00},
+    {0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff},
+    {0xff, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff},
+    {0xff, 0x00, 0x00, 0xff, 0xff, 0x00, 0x00, 0xff},
+    {0x00, 0xff, 0x00, 0x00, 0xff, 0x00, 0xff, 0xff},
+    {0xff, 0xff, 0x00, 0x00, 0xff, 0xff, 0x00, 0x00},
+    {0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0x00},
+    {0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0xff},
+    {0x00, 0x00, 0xff, 0xff, 0x00, 0x00, 0xff, 0xff},
+    {0xff, 0x00, 0xff, 0xff, 0x00, 0xff, 0x00, 0x00},
+    {0x00, 0xff, 0xff, 0x00, 0x00, 0xff, 0xff, 0x00},
+    {0x00, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00},
+    {0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00},
+    {0x00, 0x00, 0xff, 0x00, 0xff, 0xff, 0x00, 0xff},
+    {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}};
+
 // decoder look-up table
 unsigned char hamming84_dec_gentab[256] = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x03,
@@ -190,31 +209,5 @@ void fec_hamming84_decode_soft(fec _q,
 unsigned char fecsoft_hamming84_decode(unsigned char * _soft_bits)
 {
     // find symbol with minimum distance from all 2^4 possible
-    unsigned int d;             // distance metric
-    unsigned int dmin = 0;      // minimum distance
-    unsigned char s_hat = 0;    // estimated transmitted symbol
-    unsigned char c;            // encoded symbol
-
-    unsigned char s;
-    for (s=0; s<16; s++) {
-        // encode symbol
-        c = hamming84_enc_gentab[s];
-
-        // compute distance metric
-        d = 0;
-        d += (c & 0x80) ? 255 - _soft_bits[0] : _soft_bits[0];
-        d += (c & 0x40) ? 255 - _soft_bits[1] : _soft_bits[1];
-        d += (c & 0x20) ? 255 - _soft_bits[2] : _soft_bits[2];
-        d += (c & 0x10) ? 255 - _soft_bits[3] : _soft_bits[3];
-        d += (c & 0x08) ? 255 - _soft_bits[4] : _soft_bits[4];
-        d += (c & 0x04) ? 255 - _soft_bits[5] : _soft_bits[5];
-        d += (c & 0x02) ? 255 - _soft_bits[6] : _soft_bits[6];
-        d += (c & 0x01) ? 255 - _soft_bits[7] : _soft_bits[7];
-
-        if (d < dmin || s==0) {
-            s_hat = s;
-            dmin = d;
-        }
-    }
-    return s_hat;
+    return (unsigned char) fecsoft_ml16_decode(_soft_bits, 8, &hamming84_soft_gentab[0][0]);
 }
@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+//
+// quasi-cyclic low-density parity-check (LDPC) codes
+//
+// Each code is defined by a base matrix of circulant shifts (-1 for an
+// all-zero block); adding a code only requires its base matrix and an
+// entry in the fec_scheme list. The last mb columns of the base matrix
+// must form a dual-diagonal staircase of identity blocks so that parity
+// is computed by accumulating the layer syndromes of the data. Messages
+// are split into blocks as with Reed-Solomon codes: unused data bits of
+// a shortened block are known zeros which are not transmitted.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "liquid.internal.h"
+
+#define FEC_LDPC_MAX_ITERATIONS (25)    // maximum decoder iterations
+#define FEC_LDPC_LLR_HARD       (127)   // LLR magnitude of hard decisions
+#define FEC_LDPC_LLR_KNOWN      (8192)  // LLR of shortened (zero) bits
+
+// r1/2, n=1024, k=512: Z=32, 16 x 32 base matrix, no cycles of length
+// four or six between circulants
+static const short int fec_ldpc_base_r12[16*32] = {
+     -1, -1, 16, -1, -1, 12, -1, -1, -1, -1, -1, -1, -1, -1,  4, -1,  0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+     -1, -1, -1,  0, -1, -1, 15, -1, -1, -1, -1, -1, -1, -1, -1, 31,  0,  0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      5, -1, -1, -1, -1, -1, 20, -1, -1, -1, -1, -1, -1, -1, -1, 11, -1,  0,  0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+     -1, -1, -1, -1,  1, -1, -1, 21, -1, -1, -1, -1, -1, -1, -1,  6, -1, -1,  0,  0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+     -1, 26, -1, -1, -1, -1, -1,  6, -1, -1, -1, -1, -1,  8, -1, -1, -1, -1, -1,  0,  0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+     -1, -1, -1,  0, -1, -1, 27, -1, -1, -1, -1, -1, 22, -1, -1, -1, -1, -1, -1, -1,  0,  0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+     -1, -1, 15, -1, -1, -1, -1, -1, -1,  7, -1, -1, 16, -1, -1, -1, -1, -1, -1, -1, -1,  0,  0, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+     26, -1, -1, -1, -1, -1, -1, -1, -1, -1, 20, -1, -1, -1, 13, -1, -1, -1, -1, -1, -1, -1,  0,  0, -1, -1, -1, -1, -1, -1, -1, -1,
+     -1,  9, -1, -1, -1, -1, -1, -1, -1, 30, -1, -1, -1, -1, 10, -1, -1, -1, -1, -1, -1, -1, -1,  0,  0, -1, -1, -1, -1, -1, -1, -1,
+     -1, -1, -1, -1, 10,  7, -1, -1, -1, -1, -1, -1,  5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,  0, -1, -1, -1, -1, -1, -1,
+     -1, -1, -1, -1, 17, -1, -1, -1, -1, 25, 30, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,  0, -1, -1, -1, -1, -1,
+     -1, -1, -1, 30, -1, -1, -1, -1,  0, -1, -1,  3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,  0, -1, -1, -1, -1,
+     -1, -1, -1, -1, -1, 12, -1,  1, -1, -1, -1, -1, -1, 17, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,  0, -1, -1, -1,
+     -1, -1, 11, -1, -1, -1, -1, -1, 13, -1, -1, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,  0, -1, -1,
+     -1, 28, -1, -1, -1, -1, -1, -1, -1, -1, 19, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,  0, -1,
+     20, -1, -1, -1, -1, -1, -1, -1,  4, -1, -1, -1, -1, 19, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,  0
+};
+
+// r3/4, n=1024, k=768: Z=32, 8 x 32 base matrix, no cycles of length four
+static const short int fec_ldpc_base_r34[8*32] = {
+      4, -1, 25, -1, -1, -1, -1, 30, 14, -1, -1, -1, 30, 28, -1, -1, -1,  9, -1, 31, -1,  4, -1, -1,  0, -1, -1, -1, -1, -1, -1, -1,
+     -1, 21, -1,  4, -1, -1, -1, 26, 13, -1,  6, -1, -1, 11, -1, -1, -1, 26, -1, 21, -1, -1, -1,  9,  0,  0, -1, -1, -1, -1, -1, -1,
+     -1, -1, 26, -1, 26, 29, -1, -1, -1, -1, 25, 10, -1, -1, 31, -1, -1, -1, 23, -1,  8, -1, -1, 14, -1,  0,  0, -1, -1, -1, -1, -1,
+      3, -1, -1, 11, -1, -1, 17, -1, 24, -1, -1, -1, 22, -1, -1, 24, 21, -1, -1, -1, -1, 15,  8, -1, -1, -1,  0,  0, -1, -1, -1, -1,
+     -1, -1, 20, -1, 19, -1, 23, -1, -1, 31, -1, -1, -1, 17, 22, -1, 23, -1, 26, -1, -1, -1, 18, -1, -1, -1, -1,  0,  0, -1, -1, -1,
+     -1, 21, -1, -1, -1,  1, -1, 15, -1, -1, 22,  8, -1, -1, -1, 18, -1, -1, 28, -1, 30, -1, -1, 16, -1, -1, -1, -1,  0,  0, -1, -1,
+     -1,  7, -1,  2, -1, 24, -1, -1, -1, 30, -1, 29, -1, -1, -1, 29, 27, -1, -1, -1, 25, 15, -1, -1, -1, -1, -1, -1, -1,  0,  0, -1,
+     13, -1, -1, -1,  3, -1, 20, -1, -1, 24, -1, -1,  9, -1,  5, -1, -1, 17, -1, 22, -1, -1, 13, -1, -1, -1, -1, -1, -1, -1,  0,  0
+};
+
+// compute parity bits of code word from its data bits
+void fec_ldpc_encode_parity(fec _q);
+
+// decode one block from LLRs already loaded into ldpc_llr
+//  _q          :   fec object
+//  _block_size :   number of message bytes in this block
+//  _msg_dec    :   decoded message bytes [size: _block_size x 1]
+void fec_ldpc_decode_block(fec             _q,
+                           unsigned int    _block_size,
+                           unsigned char * _msg_dec);
+
+// create LDPC codec object
+fec fec_ldpc_create(fec_scheme _fs)
+{
+    fec q = (fec) malloc(sizeof(struct fec_s));
+
+    q->scheme = _fs;
+    q->rate = fec_get_rate(q->scheme);
+
+    q->encode_func      = &fec_ldpc_encode;
+    q->decode_func      = &fec_ldpc_decode;
+    q->decode_soft_func = &fec_ldpc_decode_soft;
+
+    switch (q->scheme) {
+    case LIQUID_FEC_LDPC_R12:
+        q->ldpc_Z    = 32;
+        q->ldpc_mb   = 16;
+        q->ldpc_nb   = 32;
+        q->ldpc_base = fec_ldpc_base_r12;
+        break;
+    case LIQUID_FEC_LDPC_R34:
+        q->ldpc_Z    = 32;
+        q->ldpc_mb   = 8;
+        q->ldpc_nb   = 32;
+        q->ldpc_base = fec_ldpc_base_r34;
+        break;
+    default:
+        fprintf(stderr,"error: fec_ldpc_create(), invalid type\n");
+        exit(1);
+    }
+
+    // validate dual-diagonal parity part of base matrix
+    unsigned int mb = q->ldpc_mb;
+    unsigned int kb = q->ldpc_nb - q->ldpc_mb;
+    unsigned int i;
+    unsigned int j;
+    for (i=0; i<mb; i++) {
+        for (j=0; j<mb; j++) {
+            short int expected = (j == i || j+1 == i) ? 0 : -1;
+            if (q->ldpc_base[i*q->ldpc_nb + kb + j] != expected) {
+                fprintf(stderr,"error: fec_ldpc_create(), parity part of base matrix must be dual-diagonal\n");
+                exit(1);
+            }
+        }
+    }
+
+    // create decoder and code word buffers
+    unsigned int n = q->ldpc_nb * q->ldpc_Z;
+    q->ldpc = fec_minsum_create_qc(q->ldpc_Z, q->ldpc_mb, q->ldpc_nb, q->ldpc_base);
+    q->ldpc_bits = (unsigned char*) malloc(n*sizeof(unsigned char));
+    q->ldpc_llr  = (short int*)     malloc(n*sizeof(short int));
+
+    // lengths
+    q->num_dec_bytes = 0;
+    q->num_enc_bytes = 0;
+
+    return q;
+}
+
+// destroy LDPC codec object
+void fec_ldpc_destroy(fec _q)
+{
+    fec_minsum_destroy(_q->ldpc);
+    free(_q->ldpc_bits);
+    free(_q->ldpc_llr);
+    free(_q);
+}
+
+// encode message, appending parity bytes to each block
+void fec_ldpc_encode(fec _q,
+                     unsigned int _dec_msg_len,
+                     unsigned char *_msg_dec,
+                     unsigned char *_msg_enc)
+{
+    // re-allocate resources if necessary
+    fec_ldpc_setlength(_q, _dec_msg_len);
+
+    unsigned int k = (_q->ldpc_nb - _q->ldpc_mb) * _q->ldpc_Z;
+    unsigned int p = _q->ldpc_mb * _q->ldpc_Z;
+    unsigned int i;
+    unsigned int j;
+    unsigned int n0=0;  // input index
+    unsigned int n1=0;  // output index
+    unsigned int block_size = _q->dec_block_len;
+    for (i=0; i<_q->num_blocks; i++) {
+
+        // the last block is smaller by the residual block length
+        if (i == _q->num_blocks-1)
+            block_size -= _q->res_block_len;
+
+        // unpack data bits; residual and shortened bits are zero
+        memset(_q->ldpc_bits, 0x00, k*sizeof(unsigned char));
+        for (j=0; j<8*block_size; j++)
+            _q->ldpc_bits[j] = (_msg_dec[n0 + j/8] >> (7 - (j%8))) & 1;
+
+        fec_ldpc_encode_parity(_q);
+
+        // copy data, then pack parity bits
+        memmove(&_msg_enc[n1], &_msg_dec[n0], block_size*sizeof(unsigned char));
+        memset(&_msg_enc[n1+block_size], 0x00, (_q->dec_block_len-block_size)*sizeof(unsigned char));
+        unsigned char * parity = &_msg_enc[n1 + _q->dec_block_len];
+        memset(parity, 0x00, (p/8)*sizeof(unsigned char));
+        for (j=0; j<p; j++)
+            parity[j/8] |= _q->ldpc_bits[k+j] << (7 - (j%8));
+
+        // increment counters
+        n0 += block_size;
+        n1 += _q->enc_block_len;
+    }
+}
+
+// decode message (hard decisions)
+void fec_ldpc_decode(fec _q,
+                     unsigned int _dec_msg_len,
+                     unsigned char *_msg_enc,
+                     unsigned char *_msg_dec)
+{
+    // re-allocate resources if necessary
+    fec_ldpc_setlength(_q, _dec_msg_len);
+
+    unsigned int k = (_q->ldpc_nb - _q->ldpc_mb) * _q->ldpc_Z;
+    unsigned int p = _q->ldpc_mb * _q->ldpc_Z;
+    unsigned int i;
+    unsigned int j;
+    unsigned int n0=0;
+    unsigned int n1=0;
+    unsigned int block_size = _q->dec_block_len;
+    for (i=0; i<_q->num_blocks; i++) {
+        if (i == _q->num_blocks-1)
+            block_size -= _q->res_block_len;
+
+        // received bits; unused data bits are known zeros
+        short int * llr = _q->ldpc_llr;
+        for (j=0; j<k; j++) {
+            if (j < 8*block_size) {
+                unsigned int bit = (_msg_enc[n0 + j/8] >> (7 - (j%8))) & 1;
+                llr[j] = bit ? -FEC_LDPC_LLR_HARD : FEC_LDPC_LLR_HARD;
+            } else {
+                llr[j] = FEC_LDPC_LLR_KNOWN;
+            }
+        }
+        unsigned char * parity = &_msg_enc[n0 + _q->dec_block_len];
+        for (j=0; j<p; j++) {
+            unsigned int bit = (parity[j/8] >> (7 - (j%8))) & 1;
+            llr[k+j] = bit ? -FEC_LDPC_LLR_HARD : FEC_LDPC_LLR_HARD;
+        }
+
+        fec_ldpc_decode_block(_q, block_size, &_msg_dec[n1]);
+
+        n0 += _q->enc_block_len;
+        n1 += block_size;
+    }
+}
+
+// decode message (soft bits)
+void fec_ldpc_decode_soft(fec _q,
+                          unsigned int _dec_msg_len,
+                          unsigned char *_msg_enc,
+                          unsigned char *_msg_dec)
+{
+    // re-allocate resources if necessary
+    fec_ldpc_setlength(_q, _dec_msg_len);
+
+    unsigned int k = (_q->ldpc_nb - _q->ldpc_mb) * _q->ldpc_Z;
+    unsigned int p = _q->ldpc_mb * _q->ldpc_Z;
+    unsigned int i;
+    unsigned int j;
+    unsigned int n0=0;
+    unsigned int n1=0;
+    unsigned int block_size = _q->dec_block_len;
+    for (i=0; i<_q->num_blocks; i++) {
+        if (i == _q->num_blocks-1)
+            block_size -= _q->res_block_len;
+
+        // soft bits map linearly onto LLRs; unused data bits are known zeros
+        short int * llr = _q->ldpc_llr;
+        unsigned char * sym = &_msg_enc[8*n0];
+        for (j=0; j<k; j++)
+            llr[j] = j < 8*block_size ? LIQUID_SOFTBIT_ERASURE - (int)sym[j] : FEC_LDPC_LLR_KNOWN;
+        sym = &_msg_enc[8*(n0 + _q->dec_block_len)];
+        for (j=0; j<p; j++)
+            llr[k+j] = LIQUID_SOFTBIT_ERASURE - (int)sym[j];
+
+        fec_ldpc_decode_block(_q, block_size, &_msg_dec[n1]);
+
+        n0 += _q->enc_block_len;
+        n1 += block_size;
+    }
+}
+
+// Set dec_msg_len, re-allocating resources as necessary; the message is
+// divided into blocks as with fec_rs_setlength(), with kk the number of
+// data bytes and nroots the number of parity bytes per code word.
+void fec_ldpc_setlength(fec _q,
+                        unsigned int _dec_msg_len)
+{
+    // validate input
+    if (_dec_msg_len == 0) {
+        fprintf(stderr,"error: fec_ldpc_setlength(), input length must be > 0\n");
+        exit(1);
+    }
+
+    // return if length has not changed
+    if (_dec_msg_len == _q->num_dec_bytes)
+        return;
+
+    unsigned int kk = (_q->ldpc_nb - _q->ldpc_mb) * _q->ldpc_Z / 8;
+    unsigned int nroots = _q->ldpc_mb * _q->ldpc_Z / 8;
+
+    _q->num_dec_bytes = _dec_msg_len;
+    _q->num_blocks    = (_dec_msg_len + kk - 1) / kk;
+    _q->dec_block_len = (_dec_msg_len + _q->num_blocks - 1) / _q->num_blocks;
+    _q->enc_block_len = _q->dec_block_len + nroots;
+    _q->res_block_len = _q->num_blocks*_q->dec_block_len - _dec_msg_len;
+    _q->num_enc_bytes = _q->enc_block_len * _q->num_blocks;
+}
+
+//
+// internal methods
+//
+
+// compute parity bits of code word from its data bits
+void fec_ldpc_encode_parity(fec _q)
+{
+    unsigned int Z  = _q->ldpc_Z;
+    unsigned int mb = _q->ldpc_mb;
+    unsigned int nb = _q->ldpc_nb;
+    unsigned int kb = nb - mb;
+    unsigned char * p = &_q->ldpc_bits[kb*Z];
+    unsigned int i;
+    unsigned int j;
+    unsigned int r;
+    for (i=0; i<mb; i++) {
+        // staircase: parity block i accumulates the previous block
+        for (r=0; r<Z; r++)
+            p[i*Z + r] = i > 0 ? p[(i-1)*Z + r] : 0;
+
+        // add syndrome of data circulants in this layer
+        for (j=0; j<kb; j++) {
+            int s = _q->ldpc_base[i*nb + j];
+            if (s < 0)
+                continue;
+            unsigned char * d = &_q->ldpc_bits[j*Z];
+            for (r=0; r<Z-s; r++)
+                p[i*Z + r] ^= d[r + s];
+            for ( ; r<Z; r++)
+                p[i*Z + r] ^= d[r + s - Z];
+        }
+    }
+}
+
+// decode one block from LLRs already loaded into ldpc_llr
+void fec_ldpc_decode_block(fec             _q,
+                           unsigned int    _block_size,
+                           unsigned char * _msg_dec)
+{
+    // run decoder; data bits are taken as-is if parity does not check
+    fec_minsum_decode(_q->ldpc, _q->ldpc_llr, FEC_LDPC_MAX_ITERATIONS, _q->ldpc_bits);
+
+    unsigned int j;
+    memset(_msg_dec, 0x00, _block_size*sizeof(unsigned char));
+    for (j=0; j<8*_block_size; j++)
+        _msg_dec[j/8] |= _q->ldpc_bits[j] << (7 - (j%8));
+}
@@ -0,0 +1,449 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+//
+// layered normalized min-sum LDPC decoder
+//
+// The parity-check matrix is kept in compressed row (CSR) form and only
+// its non-zero entries carry check-to-variable messages, so memory and
+// time scale with the number of edges rather than with m*n. Rows are
+// processed one at a time (layered schedule), each immediately updating
+// the posterior log-likelihood ratios of its variables, and decoding
+// stops as soon as all parity checks are satisfied. Messages are 16-bit
+// fixed point and scaled by 3/4 (normalized min-sum).
+//
+// Quasi-cyclic codes are described by a base matrix of circulant shifts.
+// The Z rows expanded from one base row touch disjoint variables, so a
+// whole base row is processed at once with the Z rows in vector lanes:
+// the posteriors of each circulant are rotated into a contiguous buffer
+// and the min-sum update runs over eight rows at a time (SSE2). Because
+// the rows of a layer are independent, this gives exactly the same
+// result as processing them one at a time.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "liquid.internal.h"
+
+#if HAVE_EMMINTRIN_H && defined __SSE2__
+#include <emmintrin.h>  // SSE2
+#define FEC_MINSUM_USE_SSE2 1
+#else
+#define FEC_MINSUM_USE_SSE2 0
+#endif
+
+#define FEC_MINSUM_MAX  (32767) // largest message magnitude
+
+struct fec_minsum_s {
+    unsigned int m;             // number of parity checks (rows)
+    unsigned int n;             // number of code bits (columns)
+    unsigned int num_edges;     // number of non-zero entries in H
+    unsigned int * row_ptr;     // start of each row's edges [size: m+1 x 1]
+    unsigned int * col_idx;     // column of each edge [size: num_edges x 1]
+    unsigned int max_weight;    // maximum row weight
+
+    // quasi-cyclic structure (Z > 0)
+    unsigned int Z;             // circulant size
+    unsigned int mb;            // base matrix rows
+    unsigned int * layer_ptr;   // start of each base row's edges [size: mb+1 x 1]
+    unsigned int * layer_col;   // base column of each base edge
+    unsigned int * layer_shift; // circulant shift of each base edge
+
+    int16_t * L;                // posterior LLRs [size: n x 1]
+    int16_t * R;                // check-to-variable messages [size: num_edges x 1]
+    int16_t * T;                // variable-to-check messages [size: max_weight x max(Z,1)]
+    unsigned int num_iterations;// iterations run by last decode
+};
+
+// allocate message memory once the matrix structure is known
+void fec_minsum_alloc(fec_minsum _q);
+
+// run one layered iteration over all rows (generic matrix)
+void fec_minsum_iterate_csr(fec_minsum _q);
+
+// run one layered iteration over all base rows (quasi-cyclic matrix)
+void fec_minsum_iterate_qc(fec_minsum _q);
+
+// check all parity equations against hard decisions of posteriors
+int fec_minsum_check(fec_minsum _q);
+
+// create decoder for arbitrary sparse parity-check matrix
+fec_minsum fec_minsum_create(smatrixb _H)
+{
+    fec_minsum q = (fec_minsum) malloc(sizeof(struct fec_minsum_s));
+    smatrixb_size(_H, &q->m, &q->n);
+    if (q->m == 0 || q->n == 0) {
+        fprintf(stderr,"error: fec_minsum_create(), matrix dimensions cannot be zero\n");
+        exit(1);
+    }
+
+    // compress rows (the matrix is scanned once, at creation)
+    unsigned int i;
+    unsigned int j;
+    q->row_ptr = (unsigned int*) malloc((q->m+1)*sizeof(unsigned int));
+    q->num_edges = 0;
+    for (i=0; i<q->m; i++) {
+        for (j=0; j<q->n; j++)
+            q->num_edges += smatrixb_get(_H,i,j) ? 1 : 0;
+    }
+    q->col_idx = (unsigned int*) malloc(q->num_edges*sizeof(unsigned int));
+    unsigned int e = 0;
+    for (i=0; i<q->m; i++) {
+        q->row_ptr[i] = e;
+        for (j=0; j<q->n; j++) {
+            if (smatrixb_get(_H,i,j))
+                q->col_idx[e++] = j;
+        }
+    }
+    q->row_ptr[q->m] = e;
+
+    // no quasi-cyclic structure
+    q->Z           = 0;
+    q->mb          = 0;
+    q->layer_ptr   = NULL;
+    q->layer_col   = NULL;
+    q->layer_shift = NULL;
+
+    fec_minsum_alloc(q);
+    return q;
+}
+
+// create decoder for quasi-cyclic code from its base matrix
+fec_minsum fec_minsum_create_qc(unsigned int      _Z,
+                                unsigned int      _mb,
+                                unsigned int      _nb,
+                                const short int * _base)
+{
+    if (_Z == 0 || _mb == 0 || _nb == 0) {
+        fprintf(stderr,"error: fec_minsum_create_qc(), dimensions cannot be zero\n");
+        exit(1);
+    }
+
+    fec_minsum q = (fec_minsum) malloc(sizeof(struct fec_minsum_s));
+    q->Z  = _Z;
+    q->mb = _mb;
+    q->m  = _mb*_Z;
+    q->n  = _nb*_Z;
+
+    // compress base matrix
+    unsigned int i;
+    unsigned int j;
+    unsigned int r;
+    unsigned int num_base_edges = 0;
+    for (i=0; i<_mb*_nb; i++) {
+        if (_base[i] >= (int)_Z) {
+            fprintf(stderr,"error: fec_minsum_create_qc(), shift %d exceeds circulant size %u\n", _base[i], _Z);
+            exit(1);
+        }
+        num_base_edges += _base[i] >= 0 ? 1 : 0;
+    }
+    q->layer_ptr   = (unsigned int*) malloc((_mb+1)*sizeof(unsigned int));
+    q->layer_col   = (unsigned int*) malloc(num_base_edges*sizeof(unsigned int));
+    q->layer_shift = (unsigned int*) malloc(num_base_edges*sizeof(unsigned int));
+    unsigned int e = 0;
+    for (i=0; i<_mb; i++) {
+        q->layer_ptr[i] = e;
+        for (j=0; j<_nb; j++) {
+            if (_base[i*_nb + j] < 0)
+                continue;
+            q->layer_col[e]   = j;
+            q->layer_shift[e] = _base[i*_nb + j];
+            e++;
+        }
+    }
+    q->layer_ptr[_mb] = e;
+
+    // expand into compressed rows: row r of base row i connects to
+    // column c*Z + (r + s) mod Z for each circulant (c,s)
+    q->num_edges = num_base_edges*_Z;
+    q->row_ptr = (unsigned int*) malloc((q->m+1)*sizeof(unsigned int));
+    q->col_idx = (unsigned int*) malloc(q->num_edges*sizeof(unsigned int));
+    unsigned int k = 0;
+    for (i=0; i<_mb; i++) {
+        for (r=0; r<_Z; r++) {
+            q->row_ptr[i*_Z + r] = k;
+            for (e=q->layer_ptr[i]; e<q->layer_ptr[i+1]; e++)
+                q->col_idx[k++] = q->layer_col[e]*_Z + (r + q->layer_shift[e]) % _Z;
+        }
+    }
+    q->row_ptr[q->m] = k;
+
+    fec_minsum_alloc(q);
+    return q;
+}
+
+// destroy decoder object
+void fec_minsum_destroy(fec_minsum _q)
+{
+    free(_q->row_ptr);
+    free(_q->col_idx);
+    free(_q->layer_ptr);
+    free(_q->layer_col);
+    free(_q->layer_shift);
+    free(_q->L);
+    free(_q->R);
+    free(_q->T);
+    free(_q);
+}
+
+// get number of code bits (columns)
+unsigned int fec_minsum_get_n(fec_minsum _q)
+{
+    return _q->n;
+}
+
+// get number of iterations run by the last decode
+unsigned int fec_minsum_get_num_iterations(fec_minsum _q)
+{
+    return _q->num_iterations;
+}
+
+// decode block
+int fec_minsum_decode(fec_minsum      _q,
+                      short int *     _llr,
+                      unsigned int    _max_iterations,
+                      unsigned char * _c_hat)
+{
+    unsigned int i;
+
+    // initialize posteriors with channel values and clear messages
+    for (i=0; i<_q->n; i++)
+        _q->L[i] = _llr[i];
+    memset(_q->R, 0x00, _q->num_edges*sizeof(int16_t));
+
+    int parity_pass = fec_minsum_check(_q);
+    _q->num_iterations = 0;
+    while (!parity_pass && _q->num_iterations < _max_iterations) {
+        if (_q->Z > 0)
+            fec_minsum_iterate_qc(_q);
+        else
+            fec_minsum_iterate_csr(_q);
+
+        _q->num_iterations++;
+        parity_pass = fec_minsum_check(_q);
+    }
+
+    // hard decision
+    for (i=0; i<_q->n; i++)
+        _c_hat[i] = _q->L[i] < 0 ? 1 : 0;
+
+    return parity_pass;
+}
+
+// decode block using the generic (compressed row) schedule, ignoring any
+// quasi-cyclic structure
+int fec_minsum_decode_csr(fec_minsum      _q,
+                          short int *     _llr,
+                          unsigned int    _max_iterations,
+                          unsigned char * _c_hat)
+{
+    unsigned int Z = _q->Z;
+    _q->Z = 0;
+    int parity_pass = fec_minsum_decode(_q, _llr, _max_iterations, _c_hat);
+    _q->Z = Z;
+    return parity_pass;
+}
+
+//
+// internal methods
+//
+
+// allocate message memory once the matrix structure is known
+void fec_minsum_alloc(fec_minsum _q)
+{
+    unsigned int i;
+    _q->max_weight = 0;
+    for (i=0; i<_q->m; i++) {
+        unsigned int w = _q->row_ptr[i+1] - _q->row_ptr[i];
+        _q->max_weight = w > _q->max_weight ? w : _q->max_weight;
+    }
+
+    unsigned int lanes = _q->Z > 0 ? _q->Z : 1;
+    _q->L = (int16_t*) malloc(_q->n*sizeof(int16_t));
+    _q->R = (int16_t*) malloc(_q->num_edges*sizeof(int16_t));
+    _q->T = (int16_t*) malloc(_q->max_weight*lanes*sizeof(int16_t));
+    _q->num_iterations = 0;
+}
+
+// saturate to message range
+static inline int16_t fec_minsum_sat(int _x)
+{
+    if (_x >  FEC_MINSUM_MAX) return  FEC_MINSUM_MAX;
+    if (_x < -FEC_MINSUM_MAX) return -FEC_MINSUM_MAX;
+    return (int16_t)_x;
+}
+
+// run one layered iteration over all rows (generic matrix)
+void fec_minsum_iterate_csr(fec_minsum _q)
+{
+    unsigned int i;
+    unsigned int e;
+    int16_t * T = _q->T;
+    for (i=0; i<_q->m; i++) {
+        unsigned int e0 = _q->row_ptr[i];
+        unsigned int d  = _q->row_ptr[i+1] - e0;
+        int16_t * R = &_q->R[e0];
+        unsigned int * col = &_q->col_idx[e0];
+
+        // variable-to-check messages; two smallest magnitudes and sign
+        int16_t min1 = FEC_MINSUM_MAX;
+        int16_t min2 = FEC_MINSUM_MAX;
+        unsigned int idx = 0;
+        int16_t sgn = 0;
+        for (e=0; e<d; e++) {
+            T[e] = fec_minsum_sat(_q->L[col[e]] - R[e]);
+            int16_t a = T[e] < 0 ? -T[e] : T[e];
+            if (a < min1)
+                idx = e;
+            int16_t b = a > min1 ? a : min1;
+            min2 = b < min2 ? b : min2;
+            min1 = a < min1 ? a : min1;
+            sgn ^= T[e];
+        }
+
+        // scaled check-to-variable messages and posterior update
+        int16_t m1 = min1 - (min1 >> 2);
+        int16_t m2 = min2 - (min2 >> 2);
+        for (e=0; e<d; e++) {
+            int16_t mag = e == idx ? m2 : m1;
+            R[e] = (sgn ^ T[e]) < 0 ? -mag : mag;
+            _q->L[col[e]] = fec_minsum_sat(T[e] + R[e]);
+        }
+    }
+}
+
+// run one layered iteration over all base rows (quasi-cyclic matrix)
+void fec_minsum_iterate_qc(fec_minsum _q)
+{
+    unsigned int Z = _q->Z;
+    unsigned int i;
+    unsigned int e;
+    unsigned int r;
+    for (i=0; i<_q->mb; i++) {
+        unsigned int e0 = _q->layer_ptr[i];
+        unsigned int d  = _q->layer_ptr[i+1] - e0;
+
+        // rotate posteriors of each circulant so that lane r holds the
+        // variable connected to row r of this layer
+        for (e=0; e<d; e++) {
+            int16_t * L = &_q->L[_q->layer_col[e0+e]*Z];
+            unsigned int s = _q->layer_shift[e0+e];
+            memmove(&_q->T[e*Z],       &L[s], (Z-s)*sizeof(int16_t));
+            memmove(&_q->T[e*Z + Z-s], L,     s*sizeof(int16_t));
+        }
+
+        // min-sum update of all Z rows
+        r = 0;
+#if FEC_MINSUM_USE_SSE2
+        if ((Z % 8) == 0) {
+            __m128i vmax = _mm_set1_epi16(FEC_MINSUM_MAX);
+            __m128i zero = _mm_setzero_si128();
+            for ( ; r<Z; r+=8) {
+                __m128i min1 = vmax;
+                __m128i min2 = vmax;
+                __m128i idx  = zero;
+                __m128i sgn  = zero;
+                for (e=0; e<d; e++) {
+                    __m128i * t = (__m128i*)&_q->T[e*Z + r];
+                    __m128i * R = (__m128i*)&_q->R[(e0+e)*Z + r];
+                    __m128i v = _mm_subs_epi16(_mm_loadu_si128(t), _mm_loadu_si128(R));
+                    v = _mm_max_epi16(v, _mm_sub_epi16(zero, vmax));
+                    _mm_storeu_si128(t, v);
+
+                    __m128i a  = _mm_max_epi16(v, _mm_sub_epi16(zero, v));
+                    __m128i lt = _mm_cmplt_epi16(a, min1);
+                    idx  = _mm_or_si128(_mm_and_si128(lt, _mm_set1_epi16(e)), _mm_andnot_si128(lt, idx));
+                    min2 = _mm_min_epi16(min2, _mm_max_epi16(a, min1));
+                    min1 = _mm_min_epi16(min1, a);
+                    sgn  = _mm_xor_si128(sgn, v);
+                }
+                __m128i m1 = _mm_sub_epi16(min1, _mm_srai_epi16(min1, 2));
+                __m128i m2 = _mm_sub_epi16(min2, _mm_srai_epi16(min2, 2));
+                for (e=0; e<d; e++) {
+                    __m128i * t = (__m128i*)&_q->T[e*Z + r];
+                    __m128i * R = (__m128i*)&_q->R[(e0+e)*Z + r];
+                    __m128i v   = _mm_loadu_si128(t);
+                    __m128i eq  = _mm_cmpeq_epi16(idx, _mm_set1_epi16(e));
+                    __m128i mag = _mm_or_si128(_mm_and_si128(eq, m2), _mm_andnot_si128(eq, m1));
+                    __m128i neg = _mm_srai_epi16(_mm_xor_si128(sgn, v), 15);
+                    __m128i rn  = _mm_sub_epi16(_mm_xor_si128(mag, neg), neg);
+                    _mm_storeu_si128(R, rn);
+                    v = _mm_adds_epi16(v, rn);
+                    v = _mm_max_epi16(v, _mm_sub_epi16(zero, vmax));
+                    _mm_storeu_si128(t, v);
+                }
+            }
+        }
+#endif
+        for ( ; r<Z; r++) {
+            int16_t min1 = FEC_MINSUM_MAX;
+            int16_t min2 = FEC_MINSUM_MAX;
+            unsigned int idx = 0;
+            int16_t sgn = 0;
+            for (e=0; e<d; e++) {
+                int16_t * t = &_q->T[e*Z + r];
+                *t = fec_minsum_sat(*t - _q->R[(e0+e)*Z + r]);
+                int16_t a = *t < 0 ? -*t : *t;
+                if (a < min1)
+                    idx = e;
+                int16_t b = a > min1 ? a : min1;
+                min2 = b < min2 ? b : min2;
+                min1 = a < min1 ? a : min1;
+                sgn ^= *t;
+            }
+            int16_t m1 = min1 - (min1 >> 2);
+            int16_t m2 = min2 - (min2 >> 2);
+            for (e=0; e<d; e++) {
+                int16_t * t = &_q->T[e*Z + r];
+                int16_t mag = e == idx ? m2 : m1;
+                int16_t rn  = (sgn ^ *t) < 0 ? -mag : mag;
+                _q->R[(e0+e)*Z + r] = rn;
+                *t = fec_minsum_sat(*t + rn);
+            }
+        }
+
+        // rotate updated posteriors back
+        for (e=0; e<d; e++) {
+            int16_t * L = &_q->L[_q->layer_col[e0+e]*Z];
+            unsigned int s = _q->layer_shift[e0+e];
+            memmove(&L[s], &_q->T[e*Z],       (Z-s)*sizeof(int16_t));
+            memmove(L,     &_q->T[e*Z + Z-s], s*sizeof(int16_t));
+        }
+    }
+}
+
+// check all parity equations against hard decisions of posteriors
+int fec_minsum_check(fec_minsum _q)
+{
+    unsigned int i;
+    unsigned int e;
+    for (i=0; i<_q->m; i++) {
+        int16_t p = 0;
+        for (e=_q->row_ptr[i]; e<_q->row_ptr[i+1]; e++)
+            p ^= _q->L[_q->col_idx[e]];
+        if (p < 0)
+            return 0;
+    }
+    return 1;
+}
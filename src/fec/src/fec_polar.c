@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+//
+// CRC-aided polar codes
+//
+// Messages are split into blocks as with Reed-Solomon codes, but rather
+// than shortening a fixed code word the polar code is constructed for the
+// block length itself: each block of d data bytes carries a CRC-16 and is
+// encoded into ceil((d+2)/R) bytes, at most 1024 bits. Residual bytes of
+// the last block are encoded as zeros.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "liquid.internal.h"
+
+#define FEC_POLAR_LIST_SIZE     (8)             // decoder list size
+#define FEC_POLAR_CRC           (LIQUID_CRC_16) // path selection CRC
+#define FEC_POLAR_LLR_HARD      (127)           // LLR magnitude of hard decisions
+
+// decode one block from LLRs already loaded into polar_llr
+//  _q          :   fec object
+//  _block_size :   number of message bytes in this block
+//  _msg_dec    :   decoded message bytes [size: _block_size x 1]
+void fec_polar_decode_block(fec             _q,
+                            unsigned int    _block_size,
+                            unsigned char * _msg_dec);
+
+// create polar codec object
+fec fec_polar_create(fec_scheme _fs)
+{
+    fec q = (fec) malloc(sizeof(struct fec_s));
+
+    q->scheme = _fs;
+    q->rate = fec_get_rate(q->scheme);
+
+    q->encode_func      = &fec_polar_encode;
+    q->decode_func      = &fec_polar_decode;
+    q->decode_soft_func = &fec_polar_decode_soft;
+
+    switch (q->scheme) {
+    case LIQUID_FEC_POLAR_R12: q->polar_num = 1; q->polar_den = 2; break;
+    case LIQUID_FEC_POLAR_R34: q->polar_num = 3; q->polar_den = 4; break;
+    default:
+        fprintf(stderr,"error: fec_polar_create(), invalid type\n");
+        exit(1);
+    }
+
+    // code and buffers are allocated for the longest block; the code is
+    // re-constructed in place once the message length is known
+    unsigned int kk = fec_polar_get_max_block_len(q->polar_num, q->polar_den);
+    q->polar     = fec_polarcode_create(1024, 8*kk, FEC_POLAR_CRC, FEC_POLAR_LIST_SIZE);
+    q->polar_llr = (short int*)     malloc(1024*sizeof(short int));
+    q->polar_buf = (unsigned char*) malloc(kk*sizeof(unsigned char));
+
+    // lengths
+    q->num_dec_bytes = 0;
+    q->num_enc_bytes = 0;
+
+    return q;
+}
+
+// destroy polar codec object
+void fec_polar_destroy(fec _q)
+{
+    fec_polarcode_destroy(_q->polar);
+    free(_q->polar_llr);
+    free(_q->polar_buf);
+    free(_q);
+}
+
+// encode message block by block
+void fec_polar_encode(fec _q,
+                      unsigned int _dec_msg_len,
+                      unsigned char *_msg_dec,
+                      unsigned char *_msg_enc)
+{
+    // re-allocate resources if necessary
+    fec_polar_setlength(_q, _dec_msg_len);
+
+    unsigned int i;
+    unsigned int n0=0;  // input index
+    unsigned int n1=0;  // output index
+    unsigned int block_size = _q->dec_block_len;
+    for (i=0; i<_q->num_blocks; i++) {
+
+        // the last block is smaller by the residual block length
+        if (i == _q->num_blocks-1)
+            block_size -= _q->res_block_len;
+
+        memmove(_q->polar_buf, &_msg_dec[n0], block_size*sizeof(unsigned char));
+        memset(&_q->polar_buf[block_size], 0x00, (_q->dec_block_len-block_size)*sizeof(unsigned char));
+        fec_polarcode_encode(_q->polar, _q->polar_buf, &_msg_enc[n1]);
+
+        // increment counters
+        n0 += block_size;
+        n1 += _q->enc_block_len;
+    }
+}
+
+// decode message (hard decisions)
+void fec_polar_decode(fec _q,
+                      unsigned int _dec_msg_len,
+                      unsigned char *_msg_enc,
+                      unsigned char *_msg_dec)
+{
+    // re-allocate resources if necessary
+    fec_polar_setlength(_q, _dec_msg_len);
+
+    unsigned int i;
+    unsigned int j;
+    unsigned int n0=0;
+    unsigned int n1=0;
+    unsigned int block_size = _q->dec_block_len;
+    for (i=0; i<_q->num_blocks; i++) {
+        if (i == _q->num_blocks-1)
+            block_size -= _q->res_block_len;
+
+        for (j=0; j<8*_q->enc_block_len; j++) {
+            unsigned int bit = (_msg_enc[n0 + j/8] >> (7 - (j%8))) & 1;
+            _q->polar_llr[j] = bit ? -FEC_POLAR_LLR_HARD : FEC_POLAR_LLR_HARD;
+        }
+
+        fec_polar_decode_block(_q, block_size, &_msg_dec[n1]);
+
+        n0 += _q->enc_block_len;
+        n1 += block_size;
+    }
+}
+
+// decode message (soft bits)
+void fec_polar_decode_soft(fec _q,
+                           unsigned int _dec_msg_len,
+                           unsigned char *_msg_enc,
+                           unsigned char *_msg_dec)
+{
+    // re-allocate resources if necessary
+    fec_polar_setlength(_q, _dec_msg_len);
+
+    unsigned int i;
+    unsigned int j;
+    unsigned int n0=0;
+    unsigned int n1=0;
+    unsigned int block_size = _q->dec_block_len;
+    for (i=0; i<_q->num_blocks; i++) {
+        if (i == _q->num_blocks-1)
+            block_size -= _q->res_block_len;
+
+        // soft bits map linearly onto LLRs
+        unsigned char * sym = &_msg_enc[8*n0];
+        for (j=0; j<8*_q->enc_block_len; j++)
+            _q->polar_llr[j] = LIQUID_SOFTBIT_ERASURE - (int)sym[j];
+
+        fec_polar_decode_block(_q, block_size, &_msg_dec[n1]);
+
+        n0 += _q->enc_block_len;
+        n1 += block_size;
+    }
+}
+
+// Set dec_msg_len; the message is divided into blocks as with
+// fec_rs_setlength() and the code is re-constructed for the resulting
+// block length (without allocating memory).
+void fec_polar_setlength(fec _q,
+                         unsigned int _dec_msg_len)
+{
+    // validate input
+    if (_dec_msg_len == 0) {
+        fprintf(stderr,"error: fec_polar_setlength(), input length must be > 0\n");
+        exit(1);
+    }
+
+    // return if length has not changed
+    if (_dec_msg_len == _q->num_dec_bytes)
+        return;
+
+    unsigned int kk = fec_polar_get_max_block_len(_q->polar_num, _q->polar_den);
+
+    _q->num_dec_bytes = _dec_msg_len;
+    _q->num_blocks    = (_dec_msg_len + kk - 1) / kk;
+    _q->dec_block_len = (_dec_msg_len + _q->num_blocks - 1) / _q->num_blocks;
+    _q->enc_block_len = fec_polar_get_enc_block_len(_q->dec_block_len, _q->polar_num, _q->polar_den);
+    _q->res_block_len = _q->num_blocks*_q->dec_block_len - _dec_msg_len;
+    _q->num_enc_bytes = _q->enc_block_len * _q->num_blocks;
+
+    // re-construct code for new block length
+    fec_polarcode_set_length(_q->polar, 8*_q->enc_block_len, 8*_q->dec_block_len);
+}
+
+// maximum number of data bytes per block for rate _num/_den, such that
+// the block with its CRC fits into 1024 code bits
+unsigned int fec_polar_get_max_block_len(unsigned int _num,
+                                         unsigned int _den)
+{
+    return (128*_num)/_den - crc_get_length(FEC_POLAR_CRC);
+}
+
+// number of encoded bytes of a block of _dec_block_len data bytes
+unsigned int fec_polar_get_enc_block_len(unsigned int _dec_block_len,
+                                         unsigned int _num,
+                                         unsigned int _den)
+{
+    unsigned int k = _dec_block_len + crc_get_length(FEC_POLAR_CRC);
+    return (k*_den + _num - 1) / _num;
+}
+
+//
+// internal methods
+//
+
+// decode one block from LLRs already loaded into polar_llr
+void fec_polar_decode_block(fec             _q,
+                            unsigned int    _block_size,
+                            unsigned char * _msg_dec)
+{
+    // data bytes of the most likely path are taken if no CRC checks
+    fec_polarcode_decode(_q->polar, _q->polar_llr, _q->polar_buf);
+    memmove(_msg_dec, _q->polar_buf, _block_size*sizeof(unsigned char));
+}
@@ -0,0 +1,936 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+//
+// CRC-aided polar codes with a fast simplified successive-cancellation
+// list (fast-SSCL) decoder
+//
+// The mother code of N=2^n bits is x = u G_N, where G_N is the n-fold
+// Kronecker power of [1 0; 1 1] (no bit reversal). It is shortened to E
+// bits by freezing u_i = 0 for all i >= E, which forces x_i = 0 at those
+// positions so they are not transmitted. Of the remaining positions, the
+// K most reliable (polarization weight) carry the data bits followed by a
+// CRC, which selects the decoded path from the surviving list.
+//
+// The decoder walks the code tree, computing LLRs of each child with the
+// f (min-sum) and g kernels over 16-bit fixed point, eight at a time with
+// SSE2. Sub-trees which are entirely frozen (rate-0), entirely
+// information (rate-1), a repetition code (REP) or a single parity-check
+// code (SPC) are decoded directly at their root rather than bit by bit,
+// forking only on their least reliable bits. The LLR and partial-sum
+// arrays of each level are shared between paths with reference counts
+// and only copied when a path writes to a shared array.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "liquid.internal.h"
+
+#if HAVE_EMMINTRIN_H && defined __SSE2__
+#include <emmintrin.h>  // SSE2
+#define FEC_POLARCODE_USE_SSE2 1
+#else
+#define FEC_POLARCODE_USE_SSE2 0
+#endif
+
+#define FEC_POLARCODE_LLR_MAX   (32767)     // LLR of known (shortened) bits
+
+// node types
+enum {
+    FEC_POLARCODE_NODE_SPLIT=0, // decode children
+    FEC_POLARCODE_NODE_RATE0,   // all bits frozen
+    FEC_POLARCODE_NODE_RATE1,   // no bits frozen
+    FEC_POLARCODE_NODE_REP,     // all bits frozen but the last (repetition)
+    FEC_POLARCODE_NODE_SPC,     // only the first bit frozen (single parity-check)
+};
+
+struct fec_polarcode_s {
+    unsigned int    n;          // log2 of mother code length
+    unsigned int    N;          // mother code length
+    unsigned int    E;          // number of transmitted code bits
+    unsigned int    K;          // number of information bits (data and CRC)
+    unsigned int    k;          // number of data bits
+    crc_scheme      crc;        // CRC for path selection
+    unsigned int    crc_len;    // CRC length (bytes)
+    unsigned int    L;          // list size
+    unsigned int    n_max;      // log2 of mother code length allocated for
+    unsigned int    N_max;      // mother code length allocated for
+
+    unsigned char * frozen;     // frozen bit flags [size: N x 1]
+    unsigned int *  info;       // information bit positions, ascending [size: K x 1]
+    unsigned char * node;       // node types in heap order (root is 1) [size: 2N x 1]
+    unsigned char * u;          // bit buffer [size: N x 1]
+    unsigned char * msg;        // packed data and CRC [size: K/8 x 1]
+
+    // decoder state: array s of level t (2^t values) starts at (L+s)<<t
+    short int *     llr;        // channel LLRs, shortened bits known [size: N x 1]
+    short int *     alpha;      // LLR arrays of levels 0..n-1 [size: 2LN x 1]
+    unsigned char * beta;       // partial sum arrays of levels 0..n [size: 2LN x 1]
+    unsigned char * alpha_ref;  // reference count of each array [size: (n+1)L x 1]
+    unsigned char * beta_ref;   // reference count of each array [size: (n+1)L x 1]
+    unsigned int *  alpha_idx;  // array used by path at level [size: L(n+1) x 1]
+    unsigned int *  beta_idx;   // array used by path at level [size: L(n+1) x 1]
+    int *           pm;         // path metrics (penalties) [size: L x 1]
+    unsigned int    num_paths;  // number of active paths
+    unsigned int *  pos;        // least reliable positions of node [size: L x L]
+    unsigned int *  flips;      // positions flipped by path (bit mask) [size: L x 1]
+    int *           metric;     // metrics of path extensions [size: 2L x 1]
+    unsigned char * keep;       // selected path extensions [size: 2L x 1]
+    unsigned char * choice;     // extension taken by each path [size: L x 1]
+};
+
+// determine node types of code tree
+void fec_polarcode_init_nodes(fec_polarcode _q);
+
+// decode node (heap index _id) at level _t for all paths
+void fec_polarcode_decode_node(fec_polarcode _q,
+                               unsigned int  _id,
+                               unsigned int  _t);
+
+// compute x = u G_N in place
+void fec_polarcode_transform(unsigned char * _x,
+                             unsigned int    _N);
+
+// create polar code
+//  _E          :   number of code bits, 8 <= _E <= 1024, _E%8 == 0
+//  _k          :   number of data bits, _k%8 == 0
+//  _crc        :   CRC appended to data and used for path selection
+//  _list_size  :   decoder list size, 0 < _list_size <= 32
+fec_polarcode fec_polarcode_create(unsigned int _E,
+                                   unsigned int _k,
+                                   crc_scheme   _crc,
+                                   unsigned int _list_size)
+{
+    // validate input
+    if (_E < 8 || _E > 1024 || (_E % 8) != 0) {
+        fprintf(stderr,"error: fec_polarcode_create(), code length must be a multiple of 8 in [8,1024]\n");
+        exit(1);
+    } else if (_list_size == 0 || _list_size > 32) {
+        fprintf(stderr,"error: fec_polarcode_create(), list size must be in [1,32]\n");
+        exit(1);
+    }
+
+    fec_polarcode q = (fec_polarcode) malloc(sizeof(struct fec_polarcode_s));
+    q->crc      = _crc;
+    q->crc_len  = crc_get_length(_crc);
+    q->L        = _list_size;
+
+    // mother code length of the longest code this object can hold
+    q->n_max = 0;
+    q->N_max = 1;
+    while (q->N_max < _E) {
+        q->n_max++;
+        q->N_max <<= 1;
+    }
+
+    // buffers
+    unsigned int N = q->N_max;
+    unsigned int L = q->L;
+    unsigned int r = q->n_max + 1;
+    q->frozen    = (unsigned char*)  malloc(N*sizeof(unsigned char));
+    q->info      = (unsigned int*)   malloc(N*sizeof(unsigned int));
+    q->node      = (unsigned char*)  malloc(2*N*sizeof(unsigned char));
+    q->u         = (unsigned char*)  malloc(N*sizeof(unsigned char));
+    q->msg       = (unsigned char*)  malloc((N/8)*sizeof(unsigned char));
+    q->llr       = (short int*)      malloc(N*sizeof(short int));
+    q->alpha     = (short int*)      malloc(2*L*N*sizeof(short int));
+    q->beta      = (unsigned char*)  malloc(2*L*N*sizeof(unsigned char));
+    q->alpha_ref = (unsigned char*)  malloc(r*L*sizeof(unsigned char));
+    q->beta_ref  = (unsigned char*)  malloc(r*L*sizeof(unsigned char));
+    q->alpha_idx = (unsigned int*)   malloc(L*r*sizeof(unsigned int));
+    q->beta_idx  = (unsigned int*)   malloc(L*r*sizeof(unsigned int));
+    q->pm        = (int*)            malloc(L*sizeof(int));
+    q->pos       = (unsigned int*)   malloc(L*L*sizeof(unsigned int));
+    q->flips     = (unsigned int*)   malloc(L*sizeof(unsigned int));
+    q->metric    = (int*)            malloc(2*L*sizeof(int));
+    q->keep      = (unsigned char*)  malloc(2*L*sizeof(unsigned char));
+    q->choice    = (unsigned char*)  malloc(L*sizeof(unsigned char));
+
+    // construct code
+    fec_polarcode_set_length(q, _E, _k);
+
+    return q;
+}
+
+// re-construct code for new lengths without re-allocating memory
+//  _E          :   number of code bits, _E%8 == 0, not exceeding the mother
+//                  code length of the object as created
+//  _k          :   number of data bits, _k%8 == 0
+void fec_polarcode_set_length(fec_polarcode _q,
+                              unsigned int  _E,
+                              unsigned int  _k)
+{
+    // validate input
+    if (_E < 8 || _E > _q->N_max || (_E % 8) != 0) {
+        fprintf(stderr,"error: fec_polarcode_set_length(), code length must be a multiple of 8 in [8,%u]\n", _q->N_max);
+        exit(1);
+    } else if ((_k % 8) != 0) {
+        fprintf(stderr,"error: fec_polarcode_set_length(), number of data bits must be a multiple of 8\n");
+        exit(1);
+    } else if (_k + 8*_q->crc_len == 0 || _k + 8*_q->crc_len > _E) {
+        fprintf(stderr,"error: fec_polarcode_set_length(), number of information bits must be in [1,%u]\n", _E);
+        exit(1);
+    }
+
+    _q->E = _E;
+    _q->k = _k;
+    _q->K = _k + 8*_q->crc_len;
+
+    // mother code length
+    _q->n = 0;
+    _q->N = 1;
+    while (_q->N < _q->E) {
+        _q->n++;
+        _q->N <<= 1;
+    }
+
+    // polarization weight of each transmitted position: sum of 2^(j/4) over
+    // the bits j set in its index; shortened positions are never selected
+    float w[_q->N];
+    unsigned int order[_q->N];
+    unsigned int i;
+    unsigned int j;
+    for (i=0; i<_q->E; i++) {
+        w[i] = 0.0f;
+        for (j=0; j<_q->n; j++)
+            w[i] += ((i >> j) & 1) ? powf(2.0f, 0.25f*j) : 0.0f;
+        order[i] = i;
+    }
+
+    // sort by decreasing weight (insertion sort is stable: ties go to
+    // lower index first)
+    for (i=1; i<_q->E; i++) {
+        unsigned int v = order[i];
+        for (j=i; j>0 && w[order[j-1]] < w[v]; j--)
+            order[j] = order[j-1];
+        order[j] = v;
+    }
+
+    // freeze all but the K most reliable positions
+    memset(_q->frozen, 1, _q->N*sizeof(unsigned char));
+    for (i=0; i<_q->K; i++)
+        _q->frozen[order[i]] = 0;
+    for (i=0, j=0; i<_q->N; i++) {
+        if (!_q->frozen[i])
+            _q->info[j++] = i;
+    }
+
+    fec_polarcode_init_nodes(_q);
+}
+
+// destroy polar code
+void fec_polarcode_destroy(fec_polarcode _q)
+{
+    free(_q->frozen);
+    free(_q->info);
+    free(_q->node);
+    free(_q->u);
+    free(_q->msg);
+    free(_q->llr);
+    free(_q->alpha);
+    free(_q->beta);
+    free(_q->alpha_ref);
+    free(_q->beta_ref);
+    free(_q->alpha_idx);
+    free(_q->beta_idx);
+    free(_q->pm);
+    free(_q->pos);
+    free(_q->flips);
+    free(_q->metric);
+    free(_q->keep);
+    free(_q->choice);
+    free(_q);
+}
+
+// get number of transmitted code bits, information bits (data and CRC)
+unsigned int fec_polarcode_get_n(fec_polarcode _q) { return _q->E; }
+unsigned int fec_polarcode_get_k(fec_polarcode _q) { return _q->K; }
+
+// encode data bytes, appending CRC
+//  _q      :   polar code
+//  _msg    :   data bytes [size: k/8 x 1]
+//  _enc    :   code bytes [size: E/8 x 1]
+void fec_polarcode_encode(fec_polarcode         _q,
+                          const unsigned char * _msg,
+                          unsigned char *       _enc)
+{
+    // data followed by key
+    unsigned int nb = _q->k / 8;
+    memmove(_q->msg, _msg, nb*sizeof(unsigned char));
+    unsigned int key = crc_generate_key(_q->crc, _q->msg, nb);
+    unsigned int i;
+    for (i=0; i<_q->crc_len; i++)
+        _q->msg[nb + _q->crc_len - i - 1] = (key >> (8*i)) & 0xff;
+
+    // place information bits and transform
+    memset(_q->u, 0x00, _q->N*sizeof(unsigned char));
+    for (i=0; i<_q->K; i++)
+        _q->u[_q->info[i]] = (_q->msg[i/8] >> (7 - (i%8))) & 1;
+    fec_polarcode_transform(_q->u, _q->N);
+
+    // pack transmitted bits
+    memset(_enc, 0x00, (_q->E/8)*sizeof(unsigned char));
+    for (i=0; i<_q->E; i++)
+        _enc[i/8] |= _q->u[i] << (7 - (i%8));
+}
+
+//
+// fixed-point kernels
+//
+
+// magnitude, saturated (-32768 maps to 32767)
+static inline int fec_polarcode_abs(int _a)
+{
+    return _a < 0 ? (_a == -32768 ? 32767 : -_a) : _a;
+}
+
+// saturate to 16 bits
+static inline short int fec_polarcode_sat(int _a)
+{
+    return _a > 32767 ? 32767 : (_a < -32768 ? -32768 : _a);
+}
+
+// f : _c[i] = sign(_a[i]) sign(_b[i]) min(|_a[i]|,|_b[i]|)
+static void fec_polarcode_f(short int *       _c,
+                            const short int * _a,
+                            const short int * _b,
+                            unsigned int      _h)
+{
+    unsigned int i = 0;
+#if FEC_POLARCODE_USE_SSE2
+    __m128i z = _mm_setzero_si128();
+    for ( ; i+8<=_h; i+=8) {
+        __m128i a = _mm_loadu_si128((const __m128i*)&_a[i]);
+        __m128i b = _mm_loadu_si128((const __m128i*)&_b[i]);
+        __m128i m = _mm_min_epi16(_mm_max_epi16(a, _mm_subs_epi16(z,a)),
+                                  _mm_max_epi16(b, _mm_subs_epi16(z,b)));
+        __m128i s = _mm_srai_epi16(_mm_xor_si128(a,b), 15);
+        __m128i c = _mm_or_si128(_mm_andnot_si128(s, m),
+                                 _mm_and_si128(s, _mm_sub_epi16(z,m)));
+        _mm_storeu_si128((__m128i*)&_c[i], c);
+    }
+#endif
+    for ( ; i<_h; i++) {
+        int a = fec_polarcode_abs(_a[i]);
+        int b = fec_polarcode_abs(_b[i]);
+        int m = a < b ? a : b;
+        _c[i] = (_a[i] ^ _b[i]) < 0 ? -m : m;
+    }
+}
+
+// g : _c[i] = _b[i] + (1 - 2 _u[i]) _a[i]
+static void fec_polarcode_g(short int *           _c,
+                            const short int *     _a,
+                            const short int *     _b,
+                            const unsigned char * _u,
+                            unsigned int          _h)
+{
+    unsigned int i = 0;
+#if FEC_POLARCODE_USE_SSE2
+    __m128i z = _mm_setzero_si128();
+    for ( ; i+8<=_h; i+=8) {
+        __m128i a = _mm_loadu_si128((const __m128i*)&_a[i]);
+        __m128i b = _mm_loadu_si128((const __m128i*)&_b[i]);
+        __m128i u = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)&_u[i]), z);
+        __m128i s = _mm_cmpgt_epi16(u, z);
+        a = _mm_or_si128(_mm_andnot_si128(s, a),
+                         _mm_and_si128(s, _mm_subs_epi16(z,a)));
+        _mm_storeu_si128((__m128i*)&_c[i], _mm_adds_epi16(b, a));
+    }
+#endif
+    for ( ; i<_h; i++) {
+        int a = _u[i] ? fec_polarcode_sat(-(int)_a[i]) : _a[i];
+        _c[i] = fec_polarcode_sat(_b[i] + a);
+    }
+}
+
+// sums of negative (_s0, as magnitude) and positive (_s1) values of _a
+static void fec_polarcode_sums(const short int * _a,
+                               unsigned int      _n,
+                               int *             _s0,
+                               int *             _s1)
+{
+    int s0 = 0;
+    int s1 = 0;
+    unsigned int i = 0;
+#if FEC_POLARCODE_USE_SSE2
+    if (_n >= 8) {
+        __m128i z   = _mm_setzero_si128();
+        __m128i one = _mm_set1_epi16(1);
+        __m128i v0  = z;
+        __m128i v1  = z;
+        for ( ; i+8<=_n; i+=8) {
+            __m128i a = _mm_loadu_si128((const __m128i*)&_a[i]);
+            v0 = _mm_sub_epi32(v0, _mm_madd_epi16(_mm_min_epi16(a,z), one));
+            v1 = _mm_add_epi32(v1, _mm_madd_epi16(_mm_max_epi16(a,z), one));
+        }
+        int t[4];
+        _mm_storeu_si128((__m128i*)t, v0);
+        s0 = t[0] + t[1] + t[2] + t[3];
+        _mm_storeu_si128((__m128i*)t, v1);
+        s1 = t[0] + t[1] + t[2] + t[3];
+    }
+#endif
+    for ( ; i<_n; i++) {
+        if (_a[i] < 0) s0 -= _a[i];
+        else           s1 += _a[i];
+    }
+    *_s0 = s0;
+    *_s1 = s1;
+}
+
+// hard decisions _b[i] = _a[i] < 0, returning their parity
+static unsigned int fec_polarcode_hard(unsigned char *   _b,
+                                       const short int * _a,
+                                       unsigned int      _n)
+{
+    unsigned int parity = 0;
+    unsigned int i = 0;
+#if FEC_POLARCODE_USE_SSE2
+    __m128i one = _mm_set1_epi8(1);
+    for ( ; i+16<=_n; i+=16) {
+        __m128i s = _mm_packs_epi16(_mm_loadu_si128((const __m128i*)&_a[i]),
+                                    _mm_loadu_si128((const __m128i*)&_a[i+8]));
+        _mm_storeu_si128((__m128i*)&_b[i], _mm_and_si128(_mm_cmplt_epi8(s, _mm_setzero_si128()), one));
+        parity ^= __builtin_popcount(_mm_movemask_epi8(s));
+    }
+#endif
+    for ( ; i<_n; i++) {
+        _b[i] = _a[i] < 0;
+        parity ^= _b[i];
+    }
+    return parity & 1;
+}
+
+// combine partial sums of children: [_x ^ _r, _r], _x holds left child
+static void fec_polarcode_combine(unsigned char *       _x,
+                                  const unsigned char * _r,
+                                  unsigned int          _h)
+{
+    unsigned int i = 0;
+#if FEC_POLARCODE_USE_SSE2
+    for ( ; i+16<=_h; i+=16) {
+        __m128i r = _mm_loadu_si128((const __m128i*)&_r[i]);
+        __m128i x = _mm_loadu_si128((const __m128i*)&_x[i]);
+        _mm_storeu_si128((__m128i*)&_x[i],    _mm_xor_si128(x,r));
+        _mm_storeu_si128((__m128i*)&_x[_h+i], r);
+    }
+#endif
+    for ( ; i<_h; i++) {
+        _x[i]   ^= _r[i];
+        _x[_h+i] = _r[i];
+    }
+}
+
+//
+// path management
+//
+
+// LLR array of path _l at level _t (read)
+static inline short int * fec_polarcode_alpha(fec_polarcode _q,
+                                              unsigned int  _l,
+                                              unsigned int  _t)
+{
+    if (_t == _q->n)
+        return _q->llr;
+    return _q->alpha + ((_q->L + _q->alpha_idx[_l*(_q->n+1) + _t]) << _t);
+}
+
+// partial sum array of path _l at level _t (read)
+static inline unsigned char * fec_polarcode_beta(fec_polarcode _q,
+                                                 unsigned int  _l,
+                                                 unsigned int  _t)
+{
+    return _q->beta + ((_q->L + _q->beta_idx[_l*(_q->n+1) + _t]) << _t);
+}
+
+// get array of level for writing, detaching it from other paths first
+//  _ref    :   reference counts of level
+//  _idx    :   array index of path
+static inline int fec_polarcode_detach(unsigned char * _ref,
+                                       unsigned int *  _idx)
+{
+    if (_ref[*_idx] < 2)
+        return 0;
+
+    // a free array always exists: at most L arrays are referenced and
+    // this one is referenced at least twice
+    unsigned int s = 0;
+    while (_ref[s] != 0)
+        s++;
+    _ref[*_idx]--;
+    _ref[s] = 1;
+    *_idx = s;
+    return 1;
+}
+
+// LLR array of path _l at level _t < n (write; contents are overwritten)
+static short int * fec_polarcode_alpha_w(fec_polarcode _q,
+                                         unsigned int  _l,
+                                         unsigned int  _t)
+{
+    fec_polarcode_detach(&_q->alpha_ref[_t*_q->L], &_q->alpha_idx[_l*(_q->n+1) + _t]);
+    return fec_polarcode_alpha(_q, _l, _t);
+}
+
+// partial sum array of path _l at level _t (write); contents are kept if
+// _copy is set
+static unsigned char * fec_polarcode_beta_w(fec_polarcode _q,
+                                            unsigned int  _l,
+                                            unsigned int  _t,
+                                            int           _copy)
+{
+    unsigned int * idx = &_q->beta_idx[_l*(_q->n+1) + _t];
+    unsigned int s = *idx;
+    if (fec_polarcode_detach(&_q->beta_ref[_t*_q->L], idx) && _copy)
+        memmove(fec_polarcode_beta(_q, _l, _t), _q->beta + ((_q->L + s) << _t), 1<<_t);
+    return fec_polarcode_beta(_q, _l, _t);
+}
+
+// duplicate path _l, returning index of new path
+static unsigned int fec_polarcode_clone(fec_polarcode _q,
+                                        unsigned int  _l)
+{
+    unsigned int m = _q->num_paths++;
+    unsigned int r = _q->n + 1;
+    unsigned int t;
+    memmove(&_q->alpha_idx[m*r], &_q->alpha_idx[_l*r], r*sizeof(unsigned int));
+    memmove(&_q->beta_idx [m*r], &_q->beta_idx [_l*r], r*sizeof(unsigned int));
+    for (t=0; t<_q->n; t++)
+        _q->alpha_ref[t*_q->L + _q->alpha_idx[m*r + t]]++;
+    for (t=0; t<=_q->n; t++)
+        _q->beta_ref [t*_q->L + _q->beta_idx [m*r + t]]++;
+    _q->pm[m]    = _q->pm[_l];
+    _q->flips[m] = _q->flips[_l];
+    memmove(&_q->pos[m*_q->L], &_q->pos[_l*_q->L], _q->L*sizeof(unsigned int));
+    return m;
+}
+
+// remove path _l, moving the last path into its place
+static void fec_polarcode_kill(fec_polarcode _q,
+                               unsigned int  _l)
+{
+    unsigned int r = _q->n + 1;
+    unsigned int t;
+    for (t=0; t<_q->n; t++)
+        _q->alpha_ref[t*_q->L + _q->alpha_idx[_l*r + t]]--;
+    for (t=0; t<=_q->n; t++)
+        _q->beta_ref [t*_q->L + _q->beta_idx [_l*r + t]]--;
+
+    unsigned int m = --_q->num_paths;
+    if (m == _l)
+        return;
+    memmove(&_q->alpha_idx[_l*r], &_q->alpha_idx[m*r], r*sizeof(unsigned int));
+    memmove(&_q->beta_idx [_l*r], &_q->beta_idx [m*r], r*sizeof(unsigned int));
+    _q->pm[_l]    = _q->pm[m];
+    _q->flips[_l] = _q->flips[m];
+    memmove(&_q->pos[_l*_q->L], &_q->pos[m*_q->L], _q->L*sizeof(unsigned int));
+}
+
+// keep the (up to) L best of the two extensions of every path, given
+// their metrics in _q->metric[2l+c]; afterwards path l takes extension
+// _q->choice[l] and its metric
+static void fec_polarcode_prune(fec_polarcode _q)
+{
+    unsigned int P = _q->num_paths;
+    unsigned int M = 2*P;
+    unsigned int i;
+    unsigned int j;
+
+    // keep every path unchanged if no second extension beats any first
+    // one (common once the list is full)
+    if (P == _q->L) {
+        int max0 = _q->metric[0];
+        int min1 = _q->metric[1];
+        for (i=1; i<P; i++) {
+            max0 = _q->metric[2*i  ] > max0 ? _q->metric[2*i  ] : max0;
+            min1 = _q->metric[2*i+1] < min1 ? _q->metric[2*i+1] : min1;
+        }
+        if (max0 <= min1) {
+            for (i=0; i<P; i++) {
+                _q->choice[i] = 0;
+                _q->pm[i]     = _q->metric[2*i];
+            }
+            return;
+        }
+    }
+
+    // select extensions with the L smallest metrics
+    if (M <= _q->L) {
+        memset(_q->keep, 1, M*sizeof(unsigned char));
+    } else {
+        unsigned int order[M];
+        for (i=0; i<M; i++) {
+            unsigned int v = i;
+            for (j=i; j>0 && _q->metric[order[j-1]] > _q->metric[v]; j--)
+                order[j] = order[j-1];
+            order[j] = v;
+        }
+        memset(_q->keep, 0, M*sizeof(unsigned char));
+        for (i=0; i<_q->L; i++)
+            _q->keep[order[i]] = 1;
+    }
+
+    // remove paths without surviving extensions (downwards, so that the
+    // path moved into a hole has already been visited)
+    unsigned int l;
+    for (l=P; l>0; l--) {
+        if (_q->keep[2*(l-1)] || _q->keep[2*(l-1)+1])
+            continue;
+        unsigned int m = _q->num_paths - 1;
+        fec_polarcode_kill(_q, l-1);
+        _q->keep  [2*(l-1)  ] = _q->keep  [2*m  ];
+        _q->keep  [2*(l-1)+1] = _q->keep  [2*m+1];
+        _q->metric[2*(l-1)  ] = _q->metric[2*m  ];
+        _q->metric[2*(l-1)+1] = _q->metric[2*m+1];
+    }
+
+    // duplicate paths with both extensions surviving
+    P = _q->num_paths;
+    for (l=0; l<P; l++) {
+        if (_q->keep[2*l] && _q->keep[2*l+1]) {
+            unsigned int m = fec_polarcode_clone(_q, l);
+            _q->choice[m] = 1;
+            _q->pm[m]     = _q->metric[2*l+1];
+            _q->choice[l] = 0;
+            _q->pm[l]     = _q->metric[2*l];
+        } else {
+            unsigned int c = _q->keep[2*l+1];
+            _q->choice[l] = c;
+            _q->pm[l]     = _q->metric[2*l+c];
+        }
+    }
+}
+
+// find the _m least reliable positions of _a (ascending magnitude)
+static void fec_polarcode_least_reliable(const short int * _a,
+                                         unsigned int      _n,
+                                         unsigned int *    _pos,
+                                         unsigned int      _m)
+{
+    if (_m == 0)
+        return;
+
+    int v[_m];              // magnitudes of list entries
+    unsigned int num = 0;   // number of list entries
+    unsigned int i = 0;
+    while (i < _n) {
+        // once the list is full, skip blocks with no smaller magnitude
+        unsigned int n = _n;
+#if FEC_POLARCODE_USE_SSE2
+        if (num == _m && i+8 <= _n) {
+            __m128i a = _mm_loadu_si128((const __m128i*)&_a[i]);
+            __m128i x = _mm_max_epi16(a, _mm_subs_epi16(_mm_setzero_si128(), a));
+            if (_mm_movemask_epi8(_mm_cmplt_epi16(x, _mm_set1_epi16(v[_m-1]))) == 0) {
+                i += 8;
+                continue;
+            }
+            n = i + 8;
+        }
+#endif
+        for ( ; i<n; i++) {
+            int x = fec_polarcode_abs(_a[i]);
+            if (num == _m && x >= v[_m-1])
+                continue;
+
+            // insert into sorted list, dropping the largest if full
+            unsigned int j = num < _m ? num++ : num-1;
+            for ( ; j>0 && v[j-1] > x; j--) {
+                _pos[j] = _pos[j-1];
+                v[j]    = v[j-1];
+            }
+            _pos[j] = i;
+            v[j]    = x;
+        }
+    }
+}
+
+// find the _m least reliable positions of the LLRs of path _l at level
+// _t, reusing those of an earlier path with the same LLRs
+static void fec_polarcode_find_least_reliable(fec_polarcode _q,
+                                              unsigned int  _l,
+                                              unsigned int  _t,
+                                              unsigned int  _m)
+{
+    const short int * a = fec_polarcode_alpha(_q, _l, _t);
+    unsigned int l;
+    for (l=0; l<_l; l++) {
+        if (fec_polarcode_alpha(_q, l, _t) == a) {
+            memmove(&_q->pos[_l*_q->L], &_q->pos[l*_q->L], _m*sizeof(unsigned int));
+            return;
+        }
+    }
+    fec_polarcode_least_reliable(a, 1<<_t, &_q->pos[_l*_q->L], _m);
+}
+
+// flip the bits of each path selected by its fork steps
+static void fec_polarcode_apply_flips(fec_polarcode _q,
+                                      unsigned int  _t)
+{
+    unsigned int l;
+    for (l=0; l<_q->num_paths; l++) {
+        unsigned int f = _q->flips[l];
+        if (f == 0)
+            continue;
+        unsigned char * b = fec_polarcode_beta_w(_q, l, _t, 1);
+        unsigned int j;
+        for (j=0; f; j++, f>>=1)
+            b[_q->pos[l*_q->L+j]] ^= f & 1;
+    }
+}
+
+//
+// decoding
+//
+
+// decode LLRs of code bits
+//  _q      :   polar code
+//  _llr    :   LLRs of transmitted code bits, positive favoring 0 [size: E x 1]
+//  _msg    :   decoded data bytes [size: k/8 x 1]
+// returns 1 if the CRC of the selected path checks, 0 otherwise
+int fec_polarcode_decode(fec_polarcode     _q,
+                         const short int * _llr,
+                         unsigned char *   _msg)
+{
+    unsigned int i;
+    unsigned int l;
+
+    // channel LLRs; shortened bits are known zeros
+    memmove(_q->llr, _llr, _q->E*sizeof(short int));
+    for (i=_q->E; i<_q->N; i++)
+        _q->llr[i] = FEC_POLARCODE_LLR_MAX;
+
+    // single path using the first array of each level
+    unsigned int r = _q->n + 1;
+    memset(_q->alpha_ref, 0, r*_q->L*sizeof(unsigned char));
+    memset(_q->beta_ref,  0, r*_q->L*sizeof(unsigned char));
+    for (i=0; i<r; i++) {
+        _q->alpha_ref[i*_q->L] = 1;
+        _q->beta_ref [i*_q->L] = 1;
+        _q->alpha_idx[i] = 0;
+        _q->beta_idx [i] = 0;
+    }
+    _q->pm[0] = 0;
+    _q->num_paths = 1;
+
+    fec_polarcode_decode_node(_q, 1, _q->n);
+
+    // try paths in order of increasing metric until the CRC checks
+    unsigned int P = _q->num_paths;
+    unsigned int order[P];
+    for (l=0; l<P; l++) {
+        unsigned int j;
+        for (j=l; j>0 && _q->pm[order[j-1]] > _q->pm[l]; j--)
+            order[j] = order[j-1];
+        order[j] = l;
+    }
+    unsigned int nb = _q->k / 8;
+    for (l=0; l<P; l++) {
+        // recover information bits: u = x G_N
+        memmove(_q->u, fec_polarcode_beta(_q, order[l], _q->n), _q->N*sizeof(unsigned char));
+        fec_polarcode_transform(_q->u, _q->N);
+        memset(_q->msg, 0x00, (_q->K/8)*sizeof(unsigned char));
+        for (i=0; i<_q->K; i++)
+            _q->msg[i/8] |= _q->u[_q->info[i]] << (7 - (i%8));
+
+        unsigned int key = 0;
+        for (i=0; i<_q->crc_len; i++)
+            key = (key << 8) | _q->msg[nb+i];
+        if (crc_generate_key(_q->crc, _q->msg, nb) == key) {
+            memmove(_msg, _q->msg, nb*sizeof(unsigned char));
+            return 1;
+        }
+
+        // keep most likely path if none checks
+        if (l == 0)
+            memmove(_msg, _q->msg, nb*sizeof(unsigned char));
+    }
+    return 0;
+}
+
+// decode node (heap index _id) at level _t for all paths
+void fec_polarcode_decode_node(fec_polarcode _q,
+                               unsigned int  _id,
+                               unsigned int  _t)
+{
+    unsigned int nv = 1 << _t;
+    unsigned int h  = nv >> 1;
+    unsigned int j;
+    unsigned int l;
+    unsigned int m;
+
+    switch (_q->node[_id]) {
+    case FEC_POLARCODE_NODE_SPLIT:
+        // left child
+        for (l=0; l<_q->num_paths; l++) {
+            const short int * a = fec_polarcode_alpha(_q, l, _t);
+            fec_polarcode_f(fec_polarcode_alpha_w(_q, l, _t-1), a, a+h, h);
+        }
+        fec_polarcode_decode_node(_q, 2*_id, _t-1);
+
+        // right child
+        for (l=0; l<_q->num_paths; l++) {
+            unsigned char * b = fec_polarcode_beta_w(_q, l, _t, 0);
+            memmove(b, fec_polarcode_beta(_q, l, _t-1), h*sizeof(unsigned char));
+            const short int * a = fec_polarcode_alpha(_q, l, _t);
+            fec_polarcode_g(fec_polarcode_alpha_w(_q, l, _t-1), a, a+h, b, h);
+        }
+        fec_polarcode_decode_node(_q, 2*_id+1, _t-1);
+
+        // combine
+        for (l=0; l<_q->num_paths; l++) {
+            unsigned char * b = fec_polarcode_beta_w(_q, l, _t, 1);
+            fec_polarcode_combine(b, fec_polarcode_beta(_q, l, _t-1), h);
+        }
+        break;
+
+    case FEC_POLARCODE_NODE_RATE0:
+        // all zeros; penalize bits which disagree
+        for (l=0; l<_q->num_paths; l++) {
+            int s0, s1;
+            fec_polarcode_sums(fec_polarcode_alpha(_q, l, _t), nv, &s0, &s1);
+            _q->pm[l] += s0;
+            memset(fec_polarcode_beta_w(_q, l, _t, 0), 0, nv*sizeof(unsigned char));
+        }
+        break;
+
+    case FEC_POLARCODE_NODE_REP:
+        // all zeros or all ones
+        for (l=0; l<_q->num_paths; l++) {
+            int s0, s1;
+            fec_polarcode_sums(fec_polarcode_alpha(_q, l, _t), nv, &s0, &s1);
+            _q->metric[2*l  ] = _q->pm[l] + s0;
+            _q->metric[2*l+1] = _q->pm[l] + s1;
+        }
+        fec_polarcode_prune(_q);
+        for (l=0; l<_q->num_paths; l++)
+            memset(fec_polarcode_beta_w(_q, l, _t, 0), _q->choice[l], nv*sizeof(unsigned char));
+        break;
+
+    case FEC_POLARCODE_NODE_RATE1:
+        // hard decisions, then fork on the L-1 least reliable bits
+        m = nv < _q->L-1 ? nv : _q->L-1;
+        for (l=0; l<_q->num_paths; l++) {
+            const short int * a = fec_polarcode_alpha(_q, l, _t);
+            fec_polarcode_hard(fec_polarcode_beta_w(_q, l, _t, 0), a, nv);
+            fec_polarcode_find_least_reliable(_q, l, _t, m);
+            _q->flips[l] = 0;
+        }
+        for (j=0; j<m; j++) {
+            for (l=0; l<_q->num_paths; l++) {
+                const short int * a = fec_polarcode_alpha(_q, l, _t);
+                _q->metric[2*l  ] = _q->pm[l];
+                _q->metric[2*l+1] = _q->pm[l] + fec_polarcode_abs(a[_q->pos[l*_q->L+j]]);
+            }
+            fec_polarcode_prune(_q);
+            for (l=0; l<_q->num_paths; l++)
+                _q->flips[l] ^= _q->choice[l] << j;
+        }
+        fec_polarcode_apply_flips(_q, _t);
+        break;
+
+    case FEC_POLARCODE_NODE_SPC:
+        // hard decisions with even parity (flipping the least reliable bit
+        // if necessary), then fork on the next least reliable bits, each
+        // flipped along with the least reliable bit to keep parity
+        m = nv < _q->L ? nv : _q->L;
+        for (l=0; l<_q->num_paths; l++) {
+            const short int * a = fec_polarcode_alpha(_q, l, _t);
+            unsigned int parity = fec_polarcode_hard(fec_polarcode_beta_w(_q, l, _t, 0), a, nv);
+            unsigned int * pos = &_q->pos[l*_q->L];
+            fec_polarcode_find_least_reliable(_q, l, _t, m);
+            _q->flips[l] = parity;
+            if (parity)
+                _q->pm[l] += fec_polarcode_abs(a[pos[0]]);
+        }
+        for (j=1; j<m; j++) {
+            for (l=0; l<_q->num_paths; l++) {
+                const short int * a = fec_polarcode_alpha(_q, l, _t);
+                int d0 = fec_polarcode_abs(a[_q->pos[l*_q->L]]);
+                int dj = fec_polarcode_abs(a[_q->pos[l*_q->L+j]]);
+                _q->metric[2*l  ] = _q->pm[l];
+                _q->metric[2*l+1] = _q->pm[l] + dj + ((_q->flips[l] & 1) ? -d0 : d0);
+            }
+            fec_polarcode_prune(_q);
+            for (l=0; l<_q->num_paths; l++)
+                _q->flips[l] ^= _q->choice[l] ? (1 | (1 << j)) : 0;
+        }
+        fec_polarcode_apply_flips(_q, _t);
+        break;
+
+    default:
+        fprintf(stderr,"error: fec_polarcode_decode_node(), invalid node type\n");
+        exit(1);
+    }
+}
+
+//
+// internal methods
+//
+
+// determine node types of code tree
+void fec_polarcode_init_nodes(fec_polarcode _q)
+{
+    unsigned int id;
+    for (id=2*_q->N-1; id>0; id--) {
+        // node covers bits [i0, i0+nv)
+        unsigned int t = 0;
+        while ((id << t) < _q->N)
+            t++;
+        unsigned int nv = 1 << t;
+        unsigned int i0 = (id << t) - _q->N;
+
+        unsigned int num_frozen = 0;
+        unsigned int i;
+        for (i=0; i<nv; i++)
+            num_frozen += _q->frozen[i0+i];
+
+        if (num_frozen == nv)
+            _q->node[id] = FEC_POLARCODE_NODE_RATE0;
+        else if (num_frozen == 0)
+            _q->node[id] = FEC_POLARCODE_NODE_RATE1;
+        else if (num_frozen == nv-1 && !_q->frozen[i0+nv-1])
+            _q->node[id] = FEC_POLARCODE_NODE_REP;
+        else if (num_frozen == 1 && _q->frozen[i0])
+            _q->node[id] = FEC_POLARCODE_NODE_SPC;
+        else
+            _q->node[id] = FEC_POLARCODE_NODE_SPLIT;
+    }
+}
+
+// compute x = u G_N in place (G_N is its own inverse)
+void fec_polarcode_transform(unsigned char * _x,
+                             unsigned int    _N)
+{
+    unsigned int h;
+    unsigned int i;
+    unsigned int j;
+    for (h=1; h<_N; h<<=1) {
+        for (i=0; i<_N; i+=2*h) {
+            for (j=0; j<h; j++)
+                _x[i+j] ^= _x[i+h+j];
+        }
+    }
+}
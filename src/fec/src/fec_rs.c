@@ -35,6 +35,7 @@
 
 #if LIBFEC_ENABLED
 #include "fec.h"
+#endif
 
 fec fec_rs_create(fec_scheme _fs)
 {
@@ -61,9 +62,11 @@ fec fec_rs_create(fec_scheme _fs)
     // lengths
     q->num_dec_bytes = 0;
     q->rs = NULL;
+    q->rscodec = NULL;
 
     // allocate memory for arrays
-    q->tblock   = (unsigned char*) malloc(q->nn*sizeof(unsigned char));
+    q->tblock_cap = q->nn;
+    q->tblock   = (unsigned char*) malloc(q->tblock_cap*sizeof(unsigned char));
     q->errlocs  = (int *) malloc(q->nn*sizeof(int));
     q->derrlocs = (int *) malloc(q->nn*sizeof(int));
 
@@ -73,9 +76,14 @@ fec fec_rs_create(fec_scheme _fs)
 void fec_rs_destroy(fec _q)
 {
     // delete internal Reed-Solomon decoder object
+#if LIBFEC_ENABLED
     if (_q->rs != NULL) {
         free_rs_char(_q->rs);
     }
+#else
+    if (_q->rscodec != NULL)
+        fec_rscodec_destroy(_q->rscodec);
+#endif
 
     // delete internal memory arrays
     free(_q->tblock);
@@ -117,7 +125,11 @@ void fec_rs_encode(fec _q,
         // necessary as these bits are going to be thrown away anyway
 
         // encode data, appending parity bits to end of sequence
+#if LIBFEC_ENABLED
         encode_rs_char(_q->rs, _q->tblock, &_q->tblock[_q->dec_block_len]);
+#else
+        fec_rscodec_encode(_q->rscodec, _q->tblock, &_q->tblock[_q->dec_block_len]);
+#endif
 
         // copy result to output
         memmove(&_msg_enc[n1], _q->tblock, _q->enc_block_len*sizeof(unsigned char));
@@ -156,6 +168,24 @@ void fec_rs_decode(fec _q,
     unsigned int n0=0;
     unsigned int n1=0;
     unsigned int block_size = _q->dec_block_len;
+#if !LIBFEC_ENABLED
+    // decode all blocks at once on a copy of the input
+    memmove(_q->tblock, _msg_enc, _q->num_enc_bytes*sizeof(unsigned char));
+    fec_rscodec_decode_batch(_q->rscodec, _q->tblock, _q->num_blocks, _q->enc_block_len, NULL);
+
+    for (i=0; i<_q->num_blocks; i++) {
+        // the last block is smaller by the residual block length
+        if (i == _q->num_blocks-1)
+            block_size -= _q->res_block_len;
+
+        // copy result
+        memmove(&_msg_dec[n1], &_q->tblock[n0], block_size*sizeof(unsigned char));
+
+        // increment counters
+        n0 += _q->enc_block_len;
+        n1 += block_size;
+    }
+#else
     //int derrors; // number of decoder errors
     for (i=0; i<_q->num_blocks; i++) {
 
@@ -180,6 +210,7 @@ void fec_rs_decode(fec _q,
         n0 += _q->enc_block_len;
         n1 += block_size;
     }
+#endif
 
     // sanity check
     assert( n0 == _q->num_enc_bytes );
@@ -260,6 +291,7 @@ void fec_rs_setlength(fec _q,
     printf("enc_msg_len     :   %u\n", _q->num_enc_bytes);
 #endif
 
+#if LIBFEC_ENABLED
     // delete old decoder if necessary
     if (_q->rs != NULL)
         free_rs_char(_q->rs);
@@ -271,6 +303,26 @@ void fec_rs_setlength(fec _q,
                           _q->prim,
                           _q->nroots,
                           _q->pad);
+#else
+    // native codec (8-bit symbols only); only the padding depends on the
+    // message length
+    if (_q->rscodec == NULL) {
+        _q->rscodec = fec_rscodec_create(_q->genpoly,
+                                         _q->fcs,
+                                         _q->prim,
+                                         _q->nroots,
+                                         _q->pad);
+    } else {
+        fec_rscodec_set_pad(_q->rscodec, _q->pad);
+    }
+
+    // the decoder works on a copy of the entire encoded message; the
+    // buffer is only ever grown
+    if (_q->num_enc_bytes > _q->tblock_cap) {
+        _q->tblock_cap = _q->num_enc_bytes;
+        _q->tblock = (unsigned char*) realloc(_q->tblock, _q->tblock_cap*sizeof(unsigned char));
+    }
+#endif
 }
 
 // 
@@ -285,32 +337,3 @@ void fec_rs_init_p8(fec _q)
     _q->prim = 1;
     _q->nroots = 32;
 }
-
-#else   // LIBFEC_ENABLED
-
-fec fec_rs_create(fec_scheme _fs)
-{
-    return NULL;
-}
-
-void fec_rs_destroy(fec _q)
-{
-}
-
-void fec_rs_encode(fec _q,
-                   unsigned int _dec_msg_len,
-                   unsigned char *_msg_dec,
-                   unsigned char *_msg_enc)
-{
-}
-
-//unsigned int
-void fec_rs_decode(fec _q,
-                   unsigned int _dec_msg_len,
-                   unsigned char *_msg_enc,
-                   unsigned char *_msg_dec)
-{
-}
-
-#endif  // LIBFEC_ENABLED
-
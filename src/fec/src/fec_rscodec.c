@@ -0,0 +1,550 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+//
+// native table-driven Reed-Solomon codec over GF(2^8)
+//
+// Blocks follow libfec's conventions: systematic code words with the
+// parity symbols appended, the first symbol holding the highest-order
+// coefficient, and shortened codes implicitly padded with leading zeros.
+// The encoder uses a table of feedback products so each data symbol costs
+// a shift and an exclusive-or of the parity register. The decoder
+// evaluates syndromes, then runs Berlekamp-Massey, a Chien search and
+// Forney's algorithm only for blocks which are in error. When decoding a
+// batch, the syndromes of sixteen blocks are computed together: each
+// block occupies one byte lane, and multiplication by a root of the code
+// generator is a pair of 16-entry (nibble) table lookups with pshufb.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "liquid.internal.h"
+
+#if HAVE_TMMINTRIN_H && defined __SSSE3__
+#include <tmmintrin.h>  // SSSE3
+#define FEC_RSCODEC_USE_SSSE3 1
+#else
+#define FEC_RSCODEC_USE_SSSE3 0
+#endif
+
+#define FEC_RSCODEC_NN  (255)   // full block length
+#define FEC_RSCODEC_A0  (255)   // log of zero (index form)
+
+struct fec_rscodec_s {
+    unsigned int nroots;        // number of roots (parity symbols)
+    unsigned int fcr;           // first consecutive root (index form)
+    unsigned int prim;          // primitive element (index form)
+    unsigned int iprim;         // prim-th root of 1 (index form)
+    unsigned int pad;           // number of implicit leading zeros
+    unsigned int n;             // block length, 255 - pad
+
+    unsigned char alpha_to[256];// antilog table
+    unsigned char index_of[256];// log table
+    unsigned char * roots;      // roots of code generator (index form) [size: nroots x 1]
+    unsigned char * enc_tab;    // feedback products [size: 256 x nroots]
+
+    // syndrome evaluation; roots padded to a multiple of four for batches
+    unsigned int nroots4;       // padded number of roots
+    unsigned char * mul_tab;    // nibble products by each root [size: nroots4 x 32]
+    unsigned char * tr;         // transposed symbols [size: n x 16]
+    unsigned char * syn;        // syndromes [size: nroots4 x 16]
+};
+
+// reduce index modulo 255
+static inline unsigned int fec_rscodec_modnn(unsigned int _x)
+{
+    while (_x >= FEC_RSCODEC_NN) {
+        _x -= FEC_RSCODEC_NN;
+        _x = (_x >> 8) + (_x & FEC_RSCODEC_NN);
+    }
+    return _x;
+}
+
+// multiply two field elements (poly form)
+static inline unsigned char fec_rscodec_mul(fec_rscodec   _q,
+                                            unsigned char _a,
+                                            unsigned char _b)
+{
+    if (_a == 0 || _b == 0)
+        return 0;
+    return _q->alpha_to[fec_rscodec_modnn(_q->index_of[_a] + _q->index_of[_b])];
+}
+
+// compute syndromes of a single block, returning nonzero if any are
+// nonzero (block in error)
+//  _q      :   codec object
+//  _block  :   received block [size: n x 1]
+//  _s      :   syndromes, poly form [size: nroots x 1]
+int fec_rscodec_syndromes(fec_rscodec     _q,
+                          unsigned char * _block,
+                          unsigned char * _s);
+
+#if FEC_RSCODEC_USE_SSSE3
+// compute syndromes of the sixteen transposed blocks in the batch buffer,
+// returning a bit mask of the blocks which are in error
+unsigned int fec_rscodec_syndromes_x16(fec_rscodec _q);
+#endif
+
+// correct block in error given its syndromes (poly form), returning the
+// number of corrected symbols or -1 if the block is uncorrectable (in
+// which case the block is left untouched)
+int fec_rscodec_correct(fec_rscodec     _q,
+                        unsigned char * _block,
+                        unsigned char * _s);
+
+// create Reed-Solomon codec object
+fec_rscodec fec_rscodec_create(unsigned int _gfpoly,
+                               unsigned int _fcr,
+                               unsigned int _prim,
+                               unsigned int _nroots,
+                               unsigned int _pad)
+{
+    // validate input
+    if (_gfpoly < 0x100 || _gfpoly > 0x1ff) {
+        fprintf(stderr,"error: fec_rscodec_create(), field polynomial must have degree 8\n");
+        exit(1);
+    } else if (_fcr >= FEC_RSCODEC_NN) {
+        fprintf(stderr,"error: fec_rscodec_create(), first consecutive root must be less than 255\n");
+        exit(1);
+    } else if (_prim == 0 || _prim >= FEC_RSCODEC_NN) {
+        fprintf(stderr,"error: fec_rscodec_create(), primitive element must be in [1,254]\n");
+        exit(1);
+    } else if (_nroots == 0 || _nroots >= FEC_RSCODEC_NN) {
+        fprintf(stderr,"error: fec_rscodec_create(), number of roots must be in [1,254]\n");
+        exit(1);
+    } else if (_pad >= FEC_RSCODEC_NN - _nroots) {
+        fprintf(stderr,"error: fec_rscodec_create(), padding leaves no data symbols\n");
+        exit(1);
+    }
+
+    fec_rscodec q = (fec_rscodec) malloc(sizeof(struct fec_rscodec_s));
+    q->fcr    = _fcr;
+    q->prim   = _prim;
+    q->nroots = _nroots;
+    q->pad    = _pad;
+    q->n      = FEC_RSCODEC_NN - _pad;
+
+    // generate log/antilog tables
+    unsigned int i;
+    unsigned int j;
+    unsigned int sr = 1;
+    unsigned int order = 0;
+    q->index_of[0] = FEC_RSCODEC_A0;
+    q->alpha_to[FEC_RSCODEC_A0] = 0;
+    for (i=0; i<FEC_RSCODEC_NN; i++) {
+        q->index_of[sr] = i;
+        q->alpha_to[i]  = sr;
+        sr <<= 1;
+        if (sr & 0x100)
+            sr ^= _gfpoly;
+        sr &= 0xff;
+        if (sr == 1 && order == 0)
+            order = i+1;
+    }
+    if (order != FEC_RSCODEC_NN) {
+        fprintf(stderr,"error: fec_rscodec_create(), field polynomial 0x%x is not primitive\n", _gfpoly);
+        exit(1);
+    }
+
+    // find prim-th root of 1, used in Chien search
+    unsigned int iprim;
+    for (iprim=1; (iprim % _prim) != 0; iprim += FEC_RSCODEC_NN);
+    q->iprim = iprim / _prim;
+
+    // roots of the code generator
+    q->roots = (unsigned char*) malloc(_nroots*sizeof(unsigned char));
+    for (i=0; i<_nroots; i++)
+        q->roots[i] = ((_fcr + i)*_prim) % FEC_RSCODEC_NN;
+
+    // form code generator polynomial (poly form), g[_nroots] = 1
+    unsigned char g[_nroots+1];
+    g[0] = 1;
+    for (i=0; i<_nroots; i++) {
+        g[i+1] = 1;
+        for (j=i; j>0; j--)
+            g[j] = g[j-1] ^ fec_rscodec_mul(q, g[j], q->alpha_to[q->roots[i]]);
+        g[0] = fec_rscodec_mul(q, g[0], q->alpha_to[q->roots[i]]);
+    }
+
+    // feedback products: parity register after shifting in feedback f
+    q->enc_tab = (unsigned char*) malloc(256*_nroots*sizeof(unsigned char));
+    for (i=0; i<256; i++) {
+        for (j=0; j<_nroots; j++)
+            q->enc_tab[i*_nroots + j] = fec_rscodec_mul(q, i, g[_nroots-1-j]);
+    }
+
+    // nibble product tables for syndrome evaluation; padded roots have
+    // zero-valued tables and are never read back
+    q->nroots4 = 4*((_nroots + 3)/4);
+    q->mul_tab = (unsigned char*) calloc(32*q->nroots4, sizeof(unsigned char));
+    for (i=0; i<_nroots; i++) {
+        unsigned char a = q->alpha_to[q->roots[i]];
+        for (j=0; j<16; j++) {
+            q->mul_tab[32*i +      j] = fec_rscodec_mul(q, j,      a);
+            q->mul_tab[32*i + 16 + j] = fec_rscodec_mul(q, j << 4, a);
+        }
+    }
+    // transposed batch buffer sized for the unshortened block so the
+    // padding can change without re-allocating
+    q->tr  = (unsigned char*) malloc(16*FEC_RSCODEC_NN*sizeof(unsigned char));
+    q->syn = (unsigned char*) malloc(16*q->nroots4*sizeof(unsigned char));
+
+    return q;
+}
+
+// destroy Reed-Solomon codec object
+void fec_rscodec_destroy(fec_rscodec _q)
+{
+    free(_q->roots);
+    free(_q->enc_tab);
+    free(_q->mul_tab);
+    free(_q->tr);
+    free(_q->syn);
+    free(_q);
+}
+
+// set number of implicit leading zeros (shortened code) in place
+void fec_rscodec_set_pad(fec_rscodec  _q,
+                         unsigned int _pad)
+{
+    if (_pad >= FEC_RSCODEC_NN - _q->nroots) {
+        fprintf(stderr,"error: fec_rscodec_set_pad(), padding leaves no data symbols\n");
+        exit(1);
+    }
+    _q->pad = _pad;
+    _q->n   = FEC_RSCODEC_NN - _pad;
+}
+
+// compute parity symbols of a single block
+void fec_rscodec_encode(fec_rscodec     _q,
+                        unsigned char * _data,
+                        unsigned char * _parity)
+{
+    unsigned int nr = _q->nroots;
+    unsigned int i;
+    unsigned int j;
+
+    memset(_parity, 0x00, nr*sizeof(unsigned char));
+    for (i=0; i<_q->n - nr; i++) {
+        unsigned char * p = &_q->enc_tab[(_data[i] ^ _parity[0])*nr];
+        for (j=0; j<nr-1; j++)
+            _parity[j] = _parity[j+1] ^ p[j];
+        _parity[nr-1] = p[nr-1];
+    }
+}
+
+// decode single block in place
+int fec_rscodec_decode(fec_rscodec     _q,
+                       unsigned char * _block)
+{
+    unsigned char s[_q->nroots];
+    if (!fec_rscodec_syndromes(_q, _block, s))
+        return 0;
+
+    return fec_rscodec_correct(_q, _block, s);
+}
+
+// decode a batch of blocks in place
+unsigned int fec_rscodec_decode_batch(fec_rscodec     _q,
+                                      unsigned char * _blocks,
+                                      unsigned int    _num_blocks,
+                                      unsigned int    _stride,
+                                      int *           _num_errors)
+{
+    unsigned int num_failed = 0;
+    unsigned int k;
+    int rc;
+#if FEC_RSCODEC_USE_SSSE3
+    unsigned int i;
+    unsigned int j;
+    unsigned char s[_q->nroots];
+    unsigned int b0;
+    for (b0=0; b0<_num_blocks; b0+=16) {
+        unsigned int nb = _num_blocks - b0 < 16 ? _num_blocks - b0 : 16;
+
+        // a lone block is faster to evaluate on its own
+        if (nb == 1) {
+            rc = fec_rscodec_decode(_q, &_blocks[b0*_stride]);
+            num_failed += rc < 0 ? 1 : 0;
+            if (_num_errors != NULL)
+                _num_errors[b0] = rc;
+            break;
+        }
+
+        // transpose blocks so that each occupies a byte lane
+        if (nb < 16)
+            memset(_q->tr, 0x00, 16*_q->n*sizeof(unsigned char));
+        for (k=0; k<nb; k++) {
+            unsigned char * b = &_blocks[(b0+k)*_stride];
+            for (i=0; i<_q->n; i++)
+                _q->tr[16*i + k] = b[i];
+        }
+
+        // correct only those blocks in error
+        unsigned int mask = fec_rscodec_syndromes_x16(_q);
+        for (k=0; k<nb; k++) {
+            rc = 0;
+            if ( (mask >> k) & 1 ) {
+                for (j=0; j<_q->nroots; j++)
+                    s[j] = _q->syn[16*j + k];
+                rc = fec_rscodec_correct(_q, &_blocks[(b0+k)*_stride], s);
+            }
+
+            num_failed += rc < 0 ? 1 : 0;
+            if (_num_errors != NULL)
+                _num_errors[b0+k] = rc;
+        }
+    }
+#else
+    for (k=0; k<_num_blocks; k++) {
+        rc = fec_rscodec_decode(_q, &_blocks[k*_stride]);
+
+        num_failed += rc < 0 ? 1 : 0;
+        if (_num_errors != NULL)
+            _num_errors[k] = rc;
+    }
+#endif
+    return num_failed;
+}
+
+//
+// internal methods
+//
+
+// compute syndromes of a single block
+int fec_rscodec_syndromes(fec_rscodec     _q,
+                          unsigned char * _block,
+                          unsigned char * _s)
+{
+    unsigned int nr = _q->nroots;
+    unsigned int i;
+    unsigned int j;
+
+    // evaluate block at each root of the generator with Horner's method,
+    // multiplying by the root with its nibble product tables
+    memset(_s, 0x00, nr*sizeof(unsigned char));
+    for (i=0; i<_q->n; i++) {
+        for (j=0; j<nr; j++) {
+            unsigned char * tab = &_q->mul_tab[32*j];
+            _s[j] = _block[i] ^ tab[_s[j] & 0x0f] ^ tab[16 + (_s[j] >> 4)];
+        }
+    }
+
+    unsigned char syn_error = 0;
+    for (j=0; j<nr; j++)
+        syn_error |= _s[j];
+    return syn_error != 0;
+}
+
+#if FEC_RSCODEC_USE_SSSE3
+// compute syndromes of sixteen transposed blocks
+unsigned int fec_rscodec_syndromes_x16(fec_rscodec _q)
+{
+    unsigned int i;
+    unsigned int j;
+    unsigned int k;
+    __m128i nib = _mm_set1_epi8(0x0f);
+
+    // evaluate four roots at a time to hide the latency of each step
+    for (j=0; j<_q->nroots4; j+=4) {
+        __m128i lo[4];
+        __m128i hi[4];
+        __m128i s[4];
+        for (k=0; k<4; k++) {
+            lo[k] = _mm_loadu_si128((__m128i*)&_q->mul_tab[32*(j+k)]);
+            hi[k] = _mm_loadu_si128((__m128i*)&_q->mul_tab[32*(j+k)+16]);
+            s[k]  = _mm_setzero_si128();
+        }
+
+        for (i=0; i<_q->n; i++) {
+            __m128i v = _mm_loadu_si128((__m128i*)&_q->tr[16*i]);
+            for (k=0; k<4; k++) {
+                // s = s*alpha^root + v
+                __m128i pl = _mm_shuffle_epi8(lo[k], _mm_and_si128(s[k], nib));
+                __m128i ph = _mm_shuffle_epi8(hi[k], _mm_and_si128(_mm_srli_epi16(s[k],4), nib));
+                s[k] = _mm_xor_si128(v, _mm_xor_si128(pl, ph));
+            }
+        }
+
+        for (k=0; k<4; k++)
+            _mm_storeu_si128((__m128i*)&_q->syn[16*(j+k)], s[k]);
+    }
+
+    // flag blocks with any nonzero syndrome
+    unsigned int mask = 0;
+    for (j=0; j<_q->nroots; j++) {
+        for (k=0; k<16; k++)
+            mask |= _q->syn[16*j + k] ? 1 << k : 0;
+    }
+    return mask;
+}
+#endif
+
+// correct block in error given its syndromes
+int fec_rscodec_correct(fec_rscodec     _q,
+                        unsigned char * _block,
+                        unsigned char * _s)
+{
+    unsigned int nr = _q->nroots;
+    unsigned char * alpha_to = _q->alpha_to;
+    unsigned char * index_of = _q->index_of;
+    unsigned char lambda[nr+1]; // error locator polynomial
+    unsigned char b[nr+1];      // shifted previous locator
+    unsigned char t[nr+1];      // temporary locator
+    unsigned char omega[nr+1];  // error evaluator polynomial
+    unsigned char reg[nr+1];    // Chien search registers
+    unsigned char s[nr];        // syndromes (index form)
+    unsigned int root[nr];      // roots of locator (index form)
+    unsigned int loc[nr];       // error locations
+    unsigned char err[nr];      // error values
+    unsigned int i;
+    int j;
+
+    for (i=0; i<nr; i++)
+        s[i] = index_of[_s[i]];
+
+    // Berlekamp-Massey: find error locator polynomial lambda(x)
+    memset(lambda, 0x00, (nr+1)*sizeof(unsigned char));
+    lambda[0] = 1;
+    for (i=0; i<nr+1; i++)
+        b[i] = index_of[lambda[i]];
+
+    unsigned int r;
+    unsigned int el = 0;
+    for (r=1; r<=nr; r++) {
+        // discrepancy at step r (poly form)
+        unsigned char discr_r = 0;
+        for (i=0; i<r; i++) {
+            if (lambda[i] != 0 && s[r-i-1] != FEC_RSCODEC_A0)
+                discr_r ^= alpha_to[fec_rscodec_modnn(index_of[lambda[i]] + s[r-i-1])];
+        }
+        discr_r = index_of[discr_r];
+
+        if (discr_r == FEC_RSCODEC_A0) {
+            // b(x) <- x*b(x)
+            memmove(&b[1], b, nr*sizeof(unsigned char));
+            b[0] = FEC_RSCODEC_A0;
+            continue;
+        }
+
+        // t(x) <- lambda(x) - discr_r*x*b(x)
+        t[0] = lambda[0];
+        for (i=0; i<nr; i++) {
+            t[i+1] = lambda[i+1] ^ (b[i] == FEC_RSCODEC_A0 ? 0 :
+                     alpha_to[fec_rscodec_modnn(discr_r + b[i])]);
+        }
+
+        if (2*el <= r-1) {
+            // b(x) <- lambda(x) / discr_r
+            el = r - el;
+            for (i=0; i<=nr; i++) {
+                b[i] = lambda[i] == 0 ? FEC_RSCODEC_A0 :
+                       fec_rscodec_modnn(index_of[lambda[i]] - discr_r + FEC_RSCODEC_NN);
+            }
+        } else {
+            // b(x) <- x*b(x)
+            memmove(&b[1], b, nr*sizeof(unsigned char));
+            b[0] = FEC_RSCODEC_A0;
+        }
+        memmove(lambda, t, (nr+1)*sizeof(unsigned char));
+    }
+
+    // convert lambda to index form and find its degree
+    unsigned int deg_lambda = 0;
+    for (i=0; i<nr+1; i++) {
+        lambda[i] = index_of[lambda[i]];
+        if (lambda[i] != FEC_RSCODEC_A0)
+            deg_lambda = i;
+    }
+    if (deg_lambda == 0 || 2*deg_lambda > nr)
+        return -1;
+
+    // Chien search: find roots of lambda(x)
+    memmove(&reg[1], &lambda[1], nr*sizeof(unsigned char));
+    unsigned int count = 0;
+    unsigned int k;
+    for (i=1, k=_q->iprim-1; i<=FEC_RSCODEC_NN; i++, k=fec_rscodec_modnn(k+_q->iprim)) {
+        unsigned char q = 1; // lambda[0] is always 0 (index form)
+        for (j=deg_lambda; j>0; j--) {
+            if (reg[j] != FEC_RSCODEC_A0) {
+                reg[j] = fec_rscodec_modnn(reg[j] + j);
+                q ^= alpha_to[reg[j]];
+            }
+        }
+        if (q != 0)
+            continue;
+
+        // errors within the implicit padding cannot be corrected
+        if (k < _q->pad)
+            return -1;
+
+        root[count] = i;
+        loc[count]  = k - _q->pad;
+        if (++count == deg_lambda)
+            break;
+    }
+    if (count != deg_lambda)
+        return -1;
+
+    // error evaluator omega(x) = s(x)*lambda(x) mod x^nroots (index form)
+    int deg_omega = deg_lambda - 1;
+    for (j=0; j<=deg_omega; j++) {
+        unsigned char tmp = 0;
+        for (i=0; i<=(unsigned int)j; i++) {
+            if (s[j-i] != FEC_RSCODEC_A0 && lambda[i] != FEC_RSCODEC_A0)
+                tmp ^= alpha_to[fec_rscodec_modnn(s[j-i] + lambda[i])];
+        }
+        omega[j] = index_of[tmp];
+    }
+
+    // Forney: error value at each location is
+    //   omega(1/X) * (1/X)^(fcr-1) / lambda'(1/X)
+    for (k=0; k<count; k++) {
+        unsigned char num1 = 0;
+        for (j=deg_omega; j>=0; j--) {
+            if (omega[j] != FEC_RSCODEC_A0)
+                num1 ^= alpha_to[fec_rscodec_modnn(omega[j] + j*root[k])];
+        }
+        unsigned char num2 = alpha_to[fec_rscodec_modnn(root[k]*(_q->fcr + FEC_RSCODEC_NN - 1) + FEC_RSCODEC_NN)];
+
+        // odd-power terms of lambda form its formal derivative
+        unsigned char den = 0;
+        unsigned int deg_max = deg_lambda < nr ? deg_lambda : nr-1;
+        for (j=deg_max & ~1; j>=0; j-=2) {
+            if (lambda[j+1] != FEC_RSCODEC_A0)
+                den ^= alpha_to[fec_rscodec_modnn(lambda[j+1] + j*root[k])];
+        }
+        if (den == 0)
+            return -1;
+
+        err[k] = num1 == 0 ? 0 :
+            alpha_to[fec_rscodec_modnn(index_of[num1] + index_of[num2] + FEC_RSCODEC_NN - index_of[den])];
+    }
+
+    // apply corrections only once the block is known to be correctable
+    for (k=0; k<count; k++)
+        _block[loc[k]] ^= err[k];
+
+    return (int)count;
+}
@@ -36,6 +36,7 @@
 #include "liquid.internal.h"
 
 #define DEBUG_FEC_SECDED2216 0
+#define FEC_SECDED2216_GENTAB   1   // use look-up tables for parity/syndrome?
 
 // P matrix [6 x 16 bits], [6 x 2 bytes]
 //  1001 1001 0011 1100 :
@@ -64,6 +65,11 @@ unsigned char secded2216_syndrome_w1[22] = {
 // compute parity on 16-bit input
 unsigned char fec_secded2216_compute_parity(unsigned char * _m)
 {
+#if FEC_SECDED2216_GENTAB
+    // combine (mod 2) parity contributions of each message byte
+    return secded2216_parity_gentab[0][_m[0]] ^
+           secded2216_parity_gentab[1][_m[1]];
+#else
     // compute encoded/transmitted message: v = m*G
     unsigned char parity = 0x00;
 
@@ -79,11 +85,16 @@ unsigned char fec_secded2216_compute_parity(unsigned char * _m)
     }
 
     return parity;
+#endif
 }
 
 // compute syndrome on 22-bit input
 unsigned char fec_secded2216_compute_syndrome(unsigned char * _v)
 {
+#if FEC_SECDED2216_GENTAB
+    // syndrome is parity of received message plus received parity bits
+    return fec_secded2216_compute_parity(&_v[1]) ^ (_v[0] & 0x3f);
+#else
     // TODO : unwrap this loop
     unsigned int i;
     unsigned char syndrome = 0x00;
@@ -99,6 +110,7 @@ unsigned char fec_secded2216_compute_syndrome(unsigned char * _v)
     }
 
     return syndrome;
+#endif
 }
 
 // encode symbol
@@ -177,6 +189,17 @@ int fec_secded2216_estimate_ehat(unsigned char * _sym_enc,
         // vector of weight one
 
         unsigned int n;
+#if FEC_SECDED2216_GENTAB
+        // look up error location (stored as one plus location)
+        n = secded2216_ehat_gentab[s];
+        if (n) {
+            // single error detected at location 'n-1'
+            div_t d = div(n-1,8);
+            _e_hat[3-d.quot-1] = 1 << d.rem;
+
+            return 1;
+        }
+#else
         // estimate error location
         for (n=0; n<22; n++) {
             if (s == secded2216_syndrome_w1[n]) {
@@ -187,6 +210,7 @@ int fec_secded2216_estimate_ehat(unsigned char * _sym_enc,
                 return 1;
             }
         }
+#endif
 
     }
 
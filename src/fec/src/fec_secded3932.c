@@ -36,6 +36,7 @@
 #include "liquid.internal.h"
 
 #define DEBUG_FEC_SECDED3932 0
+#define FEC_SECDED3932_GENTAB   1   // use look-up tables for parity/syndrome?
 
 // P matrix [7 x 32 bits], [7 x 4 bytes]
 //  1000 1010 1000 0010 0000 1111 0001 1011
@@ -71,6 +72,13 @@ unsigned char secded3932_syndrome_w1[39] = {
 // compute parity on 32-bit input
 unsigned char fec_secded3932_compute_parity(unsigned char * _m)
 {
+#if FEC_SECDED3932_GENTAB
+    // combine (mod 2) parity contributions of each message byte
+    return secded3932_parity_gentab[0][_m[0]] ^
+           secded3932_parity_gentab[1][_m[1]] ^
+           secded3932_parity_gentab[2][_m[2]] ^
+           secded3932_parity_gentab[3][_m[3]];
+#else
     // compute encoded/transmitted message: v = m*G
     unsigned char parity = 0x00;
 
@@ -88,11 +96,16 @@ unsigned char fec_secded3932_compute_parity(unsigned char * _m)
     }
 
     return parity;
+#endif
 }
 
 // compute syndrome on 39-bit input
 unsigned char fec_secded3932_compute_syndrome(unsigned char * _v)
 {
+#if FEC_SECDED3932_GENTAB
+    // syndrome is parity of received message plus received parity bits
+    return fec_secded3932_compute_parity(&_v[1]) ^ (_v[0] & 0x7f);
+#else
     // TODO : unwrap this loop
     unsigned int i;
     unsigned char syndrome = 0x00;
@@ -110,6 +123,7 @@ unsigned char fec_secded3932_compute_syndrome(unsigned char * _v)
     }
 
     return syndrome;
+#endif
 }
 
 // encode symbol
@@ -193,6 +207,17 @@ int fec_secded3932_estimate_ehat(unsigned char * _sym_enc,
         // vector of weight one
 
         unsigned int n;
+#if FEC_SECDED3932_GENTAB
+        // look up error location (stored as one plus location)
+        n = secded3932_ehat_gentab[s];
+        if (n) {
+            // single error detected at location 'n-1'
+            div_t d = div(n-1,8);
+            _e_hat[5-d.quot-1] = 1 << d.rem;
+
+            return 1;
+        }
+#else
         // estimate error location
         for (n=0; n<39; n++) {
             if (s == secded3932_syndrome_w1[n]) {
@@ -203,6 +228,7 @@ int fec_secded3932_estimate_ehat(unsigned char * _sym_enc,
                 return 1;
             }
         }
+#endif
 
     }
 
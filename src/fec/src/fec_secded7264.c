@@ -36,6 +36,7 @@
 #include "liquid.internal.h"
 
 #define DEBUG_FEC_SECDED7264 0
+#define FEC_SECDED7264_GENTAB   1   // use look-up tables for parity/syndrome?
 
 // P matrix [8 x 64]
 //  11111111 00001111 00001111 00001100 01101000 10001000 10001000 10000000 : 
@@ -72,6 +73,17 @@ unsigned char secded7264_syndrome_w1[72] = {
 // compute parity byte on 64-byte input
 unsigned char fec_secded7264_compute_parity(unsigned char * _v)
 {
+#if FEC_SECDED7264_GENTAB
+    // combine (mod 2) parity contributions of each message byte
+    return secded7264_parity_gentab[0][_v[0]] ^
+           secded7264_parity_gentab[1][_v[1]] ^
+           secded7264_parity_gentab[2][_v[2]] ^
+           secded7264_parity_gentab[3][_v[3]] ^
+           secded7264_parity_gentab[4][_v[4]] ^
+           secded7264_parity_gentab[5][_v[5]] ^
+           secded7264_parity_gentab[6][_v[6]] ^
+           secded7264_parity_gentab[7][_v[7]];
+#else
     // compute parity byte on message
     unsigned int i;
     unsigned char parity = 0x00;
@@ -92,11 +104,16 @@ unsigned char fec_secded7264_compute_parity(unsigned char * _v)
 
     // return parity byte
     return parity;
+#endif
 }
 
 // compute syndrome on 72-bit input
 unsigned char fec_secded7264_compute_syndrome(unsigned char * _v)
 {
+#if FEC_SECDED7264_GENTAB
+    // syndrome is parity of received message plus received parity bits
+    return fec_secded7264_compute_parity(&_v[1]) ^ _v[0];
+#else
     // TODO : unwrap this loop
     unsigned int i;
     unsigned char syndrome = 0x00;
@@ -119,6 +136,7 @@ unsigned char fec_secded7264_compute_syndrome(unsigned char * _v)
     }
 
     return syndrome;
+#endif
 }
 
 void fec_secded7264_encode_symbol(unsigned char * _sym_dec,
@@ -196,6 +214,17 @@ int fec_secded7264_estimate_ehat(unsigned char * _sym_enc,
         // vector of weight one
 
         unsigned int n;
+#if FEC_SECDED7264_GENTAB
+        // look up error location (stored as one plus location)
+        n = secded7264_ehat_gentab[s];
+        if (n) {
+            // single error detected at location 'n-1'
+            div_t d = div(n-1,8);
+            _e_hat[9-d.quot-1] = 1 << d.rem;
+
+            return 1;
+        }
+#else
         // estimate error location
         for (n=0; n<72; n++) {
             if (s == secded7264_syndrome_w1[n]) {
@@ -206,6 +235,7 @@ int fec_secded7264_estimate_ehat(unsigned char * _sym_enc,
                 return 1;
             }
         }
+#endif
 
     }
 
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+//
+// maximum-likelihood soft decoding of short block codes
+//
+// The distance between the received soft bits and a codeword whose bits
+// are expanded to 0x00/0xff bytes is exactly the sum of absolute
+// differences of the two byte vectors, so a single SAD instruction
+// compares the received symbol against two codewords at once.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "liquid.internal.h"
+
+#if HAVE_EMMINTRIN_H && defined __SSE2__
+#include <emmintrin.h>  // SSE2
+#define FEC_SOFT_ML_USE_SSE2 1
+#else
+#define FEC_SOFT_ML_USE_SSE2 0
+#endif
+
+// maximum-likelihood soft decoding of a code with 16 codewords
+unsigned int fecsoft_ml16_decode(unsigned char       * _soft_bits,
+                                 unsigned int          _n,
+                                 const unsigned char * _cw_bytes)
+{
+#if FEC_SOFT_ML_USE_SSE2
+    // received soft bits in both halves of register; fewer than eight
+    // bits are gathered with two overlapping 4-byte reads so as to not
+    // read past the end of the input, and are padded with zeros
+    __m128i r;
+    if (_n == 8) {
+        r = _mm_loadl_epi64((const __m128i*)_soft_bits);
+    } else {
+        int r0 = 0, r1 = 0;
+        memcpy(&r0, _soft_bits,      4);
+        memcpy(&r1, _soft_bits+_n-4, 4);
+        r = _mm_or_si128(_mm_cvtsi32_si128(r0),
+                         _mm_slli_epi64(_mm_cvtsi32_si128(r1), 8*(_n-4)));
+    }
+    r = _mm_unpacklo_epi64(r, r);
+
+    // distances to codewords (2k, 2k+1), one per 64-bit lane
+    const __m128i * c = (const __m128i*)_cw_bytes;
+    __m128i d0 = _mm_sad_epu8(r, _mm_loadu_si128(c+0));
+    __m128i d1 = _mm_sad_epu8(r, _mm_loadu_si128(c+1));
+    __m128i d2 = _mm_sad_epu8(r, _mm_loadu_si128(c+2));
+    __m128i d3 = _mm_sad_epu8(r, _mm_loadu_si128(c+3));
+    __m128i d4 = _mm_sad_epu8(r, _mm_loadu_si128(c+4));
+    __m128i d5 = _mm_sad_epu8(r, _mm_loadu_si128(c+5));
+    __m128i d6 = _mm_sad_epu8(r, _mm_loadu_si128(c+6));
+    __m128i d7 = _mm_sad_epu8(r, _mm_loadu_si128(c+7));
+
+    // pack distances (at most 8*255) into 16-bit lanes in codeword order
+    __m128i lo = _mm_packs_epi32(_mm_packs_epi32(d0,d1), _mm_packs_epi32(d2,d3));
+    __m128i hi = _mm_packs_epi32(_mm_packs_epi32(d4,d5), _mm_packs_epi32(d6,d7));
+
+    // minimum distance across all lanes
+    __m128i m = _mm_min_epi16(lo, hi);
+    m = _mm_min_epi16(m, _mm_srli_si128(m, 8));
+    m = _mm_min_epi16(m, _mm_srli_si128(m, 4));
+    m = _mm_min_epi16(m, _mm_srli_si128(m, 2));
+    m = _mm_set1_epi16( (short)_mm_extract_epi16(m, 0) );
+
+    // first codeword achieving minimum distance
+    unsigned int mask = _mm_movemask_epi8( _mm_packs_epi16(_mm_cmpeq_epi16(lo, m),
+                                                           _mm_cmpeq_epi16(hi, m)) );
+    unsigned int s_hat = 0;
+    while ( !(mask & 1) ) {
+        mask >>= 1;
+        s_hat++;
+    }
+    return s_hat;
+#else
+    // find symbol with minimum distance from all 16 codewords
+    unsigned int d;             // distance metric
+    unsigned int dmin = 0;      // minimum distance
+    unsigned int s_hat = 0;     // estimated transmitted symbol
+    unsigned int s;
+    unsigned int i;
+    for (s=0; s<16; s++) {
+        d = 0;
+        for (i=0; i<_n; i++)
+            d += abs( (int)_soft_bits[i] - (int)_cw_bytes[8*s+i] );
+
+        if (d < dmin || s==0) {
+            s_hat = s;
+            dmin = d;
+        }
+    }
+    return s_hat;
+#endif
+}
+
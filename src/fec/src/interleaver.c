@@ -33,62 +33,76 @@
 
 #include "liquid.internal.h"
 
+// gathers with AVX2, selected at run time
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    HAVE_IMMINTRIN_H && !defined(LIQUID_SIMDOVERRIDE)
+#  define LIQUID_INTERLEAVER_AVX2 1
+#  include <immintrin.h>
+#else
+#  define LIQUID_INTERLEAVER_AVX2 0
+#endif
+
 // 
 // internal methods
 //
 
-// permute one iteration
-void interleaver_permute(unsigned char * _x,
-                         unsigned int    _n,
-                         unsigned int    _M,
-                         unsigned int    _N);
-
-// permute one iteration (soft bit input)
-void interleaver_permute_soft(unsigned char * _x,
-                              unsigned int    _n,
-                              unsigned int    _M,
-                              unsigned int    _N);
-
-// permute one iteration with mask
-void interleaver_permute_mask(unsigned char * _x,
-                              unsigned int    _n,
-                              unsigned int    _M,
-                              unsigned int    _N,
-                              unsigned char   _mask);
-
-// permute one iteration (soft bit input) with mask
-void interleaver_permute_mask_soft(unsigned char * _x,
-                                   unsigned int    _n,
-                                   unsigned int    _M,
-                                   unsigned int    _N,
-                                   unsigned char   _mask);
-
+// permute one iteration of soft bit indices, swapping those matching
+// the mask (0xff swaps entire bytes)
+void interleaver_permute_index(unsigned int * _p,
+                               unsigned int   _n,
+                               unsigned int   _M,
+                               unsigned int   _N,
+                               unsigned char  _mask);
+
+// compile composite permutation of all iterations into gather tables
+void interleaver_compile(interleaver _q);
+
+// gather bytes/soft bits according to table
+void interleaver_gather(const unsigned int *  _p,
+                        unsigned int          _n,
+                        const unsigned char * _x,
+                        unsigned char *       _y);
+void interleaver_gather_soft(const unsigned int *  _p,
+                             unsigned int          _n,
+                             const unsigned char * _x,
+                             unsigned char *       _y);
 
 // structured interleaver object
 struct interleaver_s {
     unsigned int n;     // number of bytes
+    unsigned int n_max; // number of bytes allocated for
 
     unsigned int M;     // row dimension
     unsigned int N;     // col dimension
 
     // interleaving depth (number of permutations)
     unsigned int depth;
+
+    // composite permutation of all iterations: soft bit k of the output
+    // is soft bit p[k] of the input; permutations never move a bit to
+    // a different position within its byte, so byte i of the hard
+    // output takes bit k (MSB first) from byte p[8*i+k]/8 of the input
+    unsigned int * p_enc;   // encoder gather table [size: 8n x 1]
+    unsigned int * p_dec;   // decoder gather table [size: 8n x 1]
+
+    // copy of input (padded for gathers, and allowing in-place operation)
+    unsigned char * buffer; // [size: 8n+4 x 1]
 };
 
 // create interleaver of length _n input/output bytes
 interleaver interleaver_create(unsigned int _n)
 {
     interleaver q = (interleaver) malloc(sizeof(struct interleaver_s));
-    q->n = _n;
+    q->n_max = _n;
 
     // set internal properties
     q->depth = 4;   // default depth to maximum 
 
-    // compute block dimensions
-    q->M = 1 + (unsigned int) floorf(sqrtf(q->n));
-
-    q->N = q->n / q->M;
-    while (q->n >= (q->M*q->N)) q->N++;  // ensures M*N >= n
+    // allocate and compile gather tables
+    q->p_enc  = (unsigned int *)  malloc(8*q->n_max*sizeof(unsigned int));
+    q->p_dec  = (unsigned int *)  malloc(8*q->n_max*sizeof(unsigned int));
+    q->buffer = (unsigned char *) calloc(8*q->n_max+4, sizeof(unsigned char));
+    interleaver_set_length(q, _n);
 
     return q;
 }
@@ -96,6 +110,11 @@ interleaver interleaver_create(unsigned int _n)
 // destroy interleaver object
 void interleaver_destroy(interleaver _q)
 {
+    // free gather tables and buffer
+    free(_q->p_enc);
+    free(_q->p_dec);
+    free(_q->buffer);
+
     // free main object memory
     free(_q);
 }
@@ -114,6 +133,38 @@ void interleaver_set_depth(interleaver  _q,
                            unsigned int _depth)
 {
     _q->depth = _depth;
+
+    // re-compile gather tables
+    interleaver_compile(_q);
+}
+
+// set length (number of input/output bytes), re-compiling gather tables;
+// memory is only re-allocated if the length exceeds all previous lengths
+void interleaver_set_length(interleaver  _q,
+                            unsigned int _n)
+{
+    if (_n > _q->n_max) {
+        _q->n_max  = _n;
+        _q->p_enc  = (unsigned int *)  realloc(_q->p_enc,  8*_n*sizeof(unsigned int));
+        _q->p_dec  = (unsigned int *)  realloc(_q->p_dec,  8*_n*sizeof(unsigned int));
+        _q->buffer = (unsigned char *) realloc(_q->buffer, (8*_n+4)*sizeof(unsigned char));
+        memset(_q->buffer, 0x00, (8*_n+4)*sizeof(unsigned char));
+    }
+    _q->n = _n;
+
+    // compute block dimensions
+    _q->M = 1 + (unsigned int) floorf(sqrtf(_q->n));
+
+    _q->N = _q->n / _q->M;
+    while (_q->n >= (_q->M*_q->N)) _q->N++;  // ensures M*N >= n
+
+    interleaver_compile(_q);
+}
+
+// get length (number of input/output bytes)
+unsigned int interleaver_get_length(interleaver _q)
+{
+    return _q->n;
 }
 
 // execute forward interleaver (encoder)
@@ -124,13 +175,15 @@ void interleaver_encode(interleaver _q,
                         unsigned char * _msg_dec,
                         unsigned char * _msg_enc)
 {
-    // copy data to output
-    memmove(_msg_enc, _msg_dec, _q->n);
+    // no permutation: copy data to output
+    if (_q->depth == 0) {
+        memmove(_msg_enc, _msg_dec, _q->n);
+        return;
+    }
 
-    if (_q->depth > 0) interleaver_permute(_msg_enc, _q->n, _q->M, _q->N);
-    if (_q->depth > 1) interleaver_permute_mask(_msg_enc, _q->n, _q->M, _q->N+2, 0x0f);
-    if (_q->depth > 2) interleaver_permute_mask(_msg_enc, _q->n, _q->M, _q->N+4, 0x55);
-    if (_q->depth > 3) interleaver_permute_mask(_msg_enc, _q->n, _q->M, _q->N+8, 0x33);
+    // copy data to buffer and gather into output
+    memmove(_q->buffer, _msg_dec, _q->n);
+    interleaver_gather(_q->p_enc, _q->n, _q->buffer, _msg_enc);
 }
 
 // execute forward interleaver (encoder) on soft bits
@@ -141,13 +194,19 @@ void interleaver_encode_soft(interleaver _q,
                              unsigned char * _msg_dec,
                              unsigned char * _msg_enc)
 {
-    // copy data to output
-    memmove(_msg_enc, _msg_dec, 8*_q->n);
+    // no permutation: copy data to output
+    if (_q->depth == 0) {
+        memmove(_msg_enc, _msg_dec, 8*_q->n);
+        return;
+    }
 
-    if (_q->depth > 0) interleaver_permute_soft(_msg_enc, _q->n, _q->M, _q->N);
-    if (_q->depth > 1) interleaver_permute_mask_soft(_msg_enc, _q->n, _q->M, _q->N+2, 0x0f);
-    if (_q->depth > 2) interleaver_permute_mask_soft(_msg_enc, _q->n, _q->M, _q->N+4, 0x55);
-    if (_q->depth > 3) interleaver_permute_mask_soft(_msg_enc, _q->n, _q->M, _q->N+8, 0x33);
+    // operating in place: copy data to buffer first
+    const unsigned char * x = _msg_dec;
+    if (_msg_dec == _msg_enc) {
+        memmove(_q->buffer, _msg_dec, 8*_q->n);
+        x = _q->buffer;
+    }
+    interleaver_gather_soft(_q->p_enc, _q->n, x, _msg_enc);
 }
 
 // execute reverse interleaver (decoder)
@@ -158,13 +217,15 @@ void interleaver_decode(interleaver _q,
                         unsigned char * _msg_enc,
                         unsigned char * _msg_dec)
 {
-    // copy data to output
-    memmove(_msg_dec, _msg_enc, _q->n);
+    // no permutation: copy data to output
+    if (_q->depth == 0) {
+        memmove(_msg_dec, _msg_enc, _q->n);
+        return;
+    }
 
-    if (_q->depth > 3) interleaver_permute_mask(_msg_dec, _q->n, _q->M, _q->N+8, 0x33);
-    if (_q->depth > 2) interleaver_permute_mask(_msg_dec, _q->n, _q->M, _q->N+4, 0x55);
-    if (_q->depth > 1) interleaver_permute_mask(_msg_dec, _q->n, _q->M, _q->N+2, 0x0f);
-    if (_q->depth > 0) interleaver_permute(_msg_dec, _q->n, _q->M, _q->N);
+    // copy data to buffer and gather into output
+    memmove(_q->buffer, _msg_enc, _q->n);
+    interleaver_gather(_q->p_dec, _q->n, _q->buffer, _msg_dec);
 }
 
 // execute reverse interleaver (decoder) on soft bits
@@ -175,31 +236,40 @@ void interleaver_decode_soft(interleaver _q,
                              unsigned char * _msg_enc,
                              unsigned char * _msg_dec)
 {
-    // copy data to output
-    memmove(_msg_dec, _msg_enc, 8*_q->n);
+    // no permutation: copy data to output
+    if (_q->depth == 0) {
+        memmove(_msg_dec, _msg_enc, 8*_q->n);
+        return;
+    }
 
-    if (_q->depth > 3) interleaver_permute_mask_soft(_msg_dec, _q->n, _q->M, _q->N+8, 0x33);
-    if (_q->depth > 2) interleaver_permute_mask_soft(_msg_dec, _q->n, _q->M, _q->N+4, 0x55);
-    if (_q->depth > 1) interleaver_permute_mask_soft(_msg_dec, _q->n, _q->M, _q->N+2, 0x0f);
-    if (_q->depth > 0) interleaver_permute_soft(_msg_dec, _q->n, _q->M, _q->N);
+    // operating in place: copy data to buffer first
+    const unsigned char * x = _msg_enc;
+    if (_msg_enc == _msg_dec) {
+        memmove(_q->buffer, _msg_enc, 8*_q->n);
+        x = _q->buffer;
+    }
+    interleaver_gather_soft(_q->p_dec, _q->n, x, _msg_dec);
 }
 
 // 
 // internal permutation methods
 //
 
-// permute one iteration
-void interleaver_permute(unsigned char * _x,
-                         unsigned int    _n,
-                         unsigned int    _M,
-                         unsigned int    _N)
+// permute one iteration of soft bit indices, swapping those matching
+// the mask (0xff swaps entire bytes)
+void interleaver_permute_index(unsigned int * _p,
+                               unsigned int   _n,
+                               unsigned int   _M,
+                               unsigned int   _N,
+                               unsigned char  _mask)
 {
     unsigned int i;
     unsigned int j;
+    unsigned int k;
     unsigned int m=0;
     unsigned int n=_n/3;
     unsigned int n2=_n/2;
-    unsigned char tmp;
+    unsigned int tmp;
     for (i=0; i<n2; i++) {
         //j = m*N + n; // input
         do {
@@ -211,112 +281,99 @@ void interleaver_permute(unsigned char * _x,
             }
         } while (j>=n2);
 
-        // swap indices
-        tmp = _x[2*j+1];
-        _x[2*j+1] = _x[2*i+0];
-        _x[2*i+0] = tmp;
+        // swap bits matching the mask
+        for (k=0; k<8; k++) {
+            if ( (_mask >> (8-k-1)) & 0x01 ) {
+                tmp = _p[8*(2*j+1)+k];
+                _p[8*(2*j+1)+k] = _p[8*(2*i+0)+k];
+                _p[8*(2*i+0)+k] = tmp;
+            }
+        }
     }
 }
 
-// permute one iteration (soft bit input)
-void interleaver_permute_soft(unsigned char * _x,
-                              unsigned int    _n,
-                              unsigned int    _M,
-                              unsigned int    _N)
+// compile composite permutation of all iterations into gather tables
+void interleaver_compile(interleaver _q)
 {
+    unsigned int n8 = 8*_q->n;
+    unsigned int k;
+
+    // move soft bit indices through each iteration, starting from the
+    // identity permutation
+    for (k=0; k<n8; k++)
+        _q->p_enc[k] = k;
+
+    if (_q->depth > 0) interleaver_permute_index(_q->p_enc, _q->n, _q->M, _q->N,   0xff);
+    if (_q->depth > 1) interleaver_permute_index(_q->p_enc, _q->n, _q->M, _q->N+2, 0x0f);
+    if (_q->depth > 2) interleaver_permute_index(_q->p_enc, _q->n, _q->M, _q->N+4, 0x55);
+    if (_q->depth > 3) interleaver_permute_index(_q->p_enc, _q->n, _q->M, _q->N+8, 0x33);
+
+    // decoder applies the inverse permutation
+    for (k=0; k<n8; k++)
+        _q->p_dec[ _q->p_enc[k] ] = k;
+}
+
+#if LIQUID_INTERLEAVER_AVX2
+// gather bytes using AVX2: lane k tests bit k of its source byte, and
+// the comparison mask collects all eight bits at once
+__attribute__((target("avx2")))
+static void interleaver_gather_avx2(const unsigned int *  _p,
+                                    unsigned int          _n,
+                                    const unsigned char * _x,
+                                    unsigned char *       _y)
+{
+    // table is ordered most-significant bit first; reverse lanes
+    const __m256i rev  = _mm256_set_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i bits = _mm256_set_epi32(0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
     unsigned int i;
-    unsigned int j;
-    unsigned int m=0;
-    unsigned int n=_n/3;
-    unsigned int n2=_n/2;
-    unsigned char tmp[8];
-    for (i=0; i<n2; i++) {
-        //j = m*N + n; // input
-        do {
-            j = m*_N + n; // output
-            m++;
-            if (m == _M) {
-                n = (n+1) % (_N);
-                m=0;
-            }
-        } while (j>=n2);
-    
-        // swap soft bits at indices
-        memmove( tmp,            &_x[8*(2*j+1)], 8);
-        memmove( &_x[8*(2*j+1)], &_x[8*(2*i+0)], 8);
-        memmove( &_x[8*(2*i+0)], tmp,            8);
+    for (i=0; i<_n; i++) {
+        // source byte indices
+        __m256i idx = _mm256_loadu_si256((const __m256i*)&_p[8*i]);
+        idx = _mm256_permutevar8x32_epi32(_mm256_srli_epi32(idx, 3), rev);
+
+        // gather 32-bit words starting at each source byte (input is
+        // padded) and test bit in lowest byte
+        __m256i v = _mm256_i32gather_epi32((const int*)_x, idx, 1);
+        v = _mm256_cmpeq_epi32(_mm256_and_si256(v, bits), bits);
+        _y[i] = (unsigned char) _mm256_movemask_ps(_mm256_castsi256_ps(v));
     }
-    //printf("\n");
 }
+#endif
 
-
-// permute one iteration with mask
-void interleaver_permute_mask(unsigned char * _x,
-                              unsigned int    _n,
-                              unsigned int    _M,
-                              unsigned int    _N,
-                              unsigned char   _mask)
+// gather bytes according to table
+void interleaver_gather(const unsigned int *  _p,
+                        unsigned int          _n,
+                        const unsigned char * _x,
+                        unsigned char *       _y)
 {
+#if LIQUID_INTERLEAVER_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        interleaver_gather_avx2(_p, _n, _x, _y);
+        return;
+    }
+#endif
     unsigned int i;
-    unsigned int j;
-    unsigned int m=0;
-    unsigned int n=_n/3;
-    unsigned int n2=_n/2;
-    unsigned char tmp0;
-    unsigned char tmp1;
-    for (i=0; i<n2; i++) {
-        //j = m*N + n; // input
-        do {
-            j = m*_N + n; // output
-            m++;
-            if (m == _M) {
-                n = (n+1) % (_N);
-                m=0;
-            }
-        } while (j>=n2);
-
-        // swap indices, applying mask
-        tmp0 = (_x[2*i+0] & (~_mask)) | (_x[2*j+1] & ( _mask));
-        tmp1 = (_x[2*i+0] & ( _mask)) | (_x[2*j+1] & (~_mask));
-        _x[2*i+0] = tmp0;
-        _x[2*j+1] = tmp1;
+    for (i=0; i<_n; i++) {
+        const unsigned int * p = &_p[8*i];
+        _y[i] = (_x[p[0] >> 3] & 0x80) |
+                (_x[p[1] >> 3] & 0x40) |
+                (_x[p[2] >> 3] & 0x20) |
+                (_x[p[3] >> 3] & 0x10) |
+                (_x[p[4] >> 3] & 0x08) |
+                (_x[p[5] >> 3] & 0x04) |
+                (_x[p[6] >> 3] & 0x02) |
+                (_x[p[7] >> 3] & 0x01);
     }
 }
 
-// permute one iteration (soft bit input)
-void interleaver_permute_mask_soft(unsigned char * _x,
-                                   unsigned int    _n,
-                                   unsigned int    _M,
-                                   unsigned int    _N,
-                                   unsigned char   _mask)
+// gather soft bits according to table
+void interleaver_gather_soft(const unsigned int *  _p,
+                             unsigned int          _n,
+                             const unsigned char * _x,
+                             unsigned char *       _y)
 {
-    unsigned int i;
-    unsigned int j;
     unsigned int k;
-    unsigned int m=0;
-    unsigned int n=_n/3;
-    unsigned int n2=_n/2;
-    unsigned char tmp;
-    for (i=0; i<n2; i++) {
-        //j = m*N + n; // input
-        do {
-            j = m*_N + n; // output
-            m++;
-            if (m == _M) {
-                n = (n+1) % (_N);
-                m=0;
-            }
-        } while (j>=n2);
-
-        // swap bits matching the mask
-        for (k=0; k<8; k++) {
-            if ( (_mask >> (8-k-1)) & 0x01 ) {
-                tmp = _x[8*(2*j+1)+k];
-                _x[8*(2*j+1)+k] = _x[8*(2*i+0)+k];
-                _x[8*(2*i+0)+k] = tmp;
-            }
-        }
-    }
-    //printf("\n");
+    for (k=0; k<8*_n; k++)
+        _y[k] = _x[_p[k]];
 }
 
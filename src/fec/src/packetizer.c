@@ -30,9 +30,83 @@
 
 #include "liquid.internal.h"
 
+#if LIQUID_PTHREADS_ENABLED
+#   include <pthread.h>
+#endif
+
 // reallocate memory for buffers
 void packetizer_realloc_buffers(packetizer _p, unsigned int _len);
 
+// longest key of any error-detection scheme
+unsigned int packetizer_max_crc_length();
+
+// set message length and schemes in place
+void packetizer_configure(packetizer   _p,
+                          unsigned int _n,
+                          int          _crc,
+                          int          _fec0,
+                          int          _fec1);
+
+// The data validity check is computed in blocks while the message is
+// copied and (un)whitened so that each block is touched while still in
+// cache; the block length must be a multiple of four to keep the phase of
+// the whitening mask.
+#define PACKETIZER_CHECK_BLOCK_LEN  (256)
+
+// Batches are processed one stage (de-interleaving, decoding, validity
+// check) at a time across a block of packets held in the shared internal
+// buffers. The number of packets per block is set so that a buffer of soft
+// bits stays near this size (bytes); hard-decision blocks hold eight
+// times as many packets.
+#define PACKETIZER_BATCH_BUFFER_LEN (16384)
+#define PACKETIZER_BATCH_MAX        (32)
+
+// batch operations
+enum {
+    PACKETIZER_BATCH_ENCODE=0,
+    PACKETIZER_BATCH_DECODE,
+    PACKETIZER_BATCH_DECODE_SOFT,
+};
+
+// copy message to buffer, append key and whiten
+void packetizer_encode_check(packetizer            _p,
+                             const unsigned char * _msg,
+                             unsigned char *       _buf);
+
+// remove whitening from buffer, copy message out and validate key
+int packetizer_decode_check(packetizer      _p,
+                            unsigned char * _buf,
+                            unsigned char * _msg);
+
+// encode block of packets through internal buffers
+void packetizer_encode_block(packetizer            _p,
+                             unsigned int          _num,
+                             const unsigned char * _msg,
+                             unsigned char *       _pkt);
+
+// decode block of packets through internal buffers, return number valid
+unsigned int packetizer_decode_block(packetizer            _p,
+                                     unsigned int          _num,
+                                     const unsigned char * _pkt,
+                                     unsigned char *       _msg,
+                                     int *                 _valid);
+
+// decode block of packets (soft bits) through internal buffers, return
+// number valid
+unsigned int packetizer_decode_soft_block(packetizer            _p,
+                                          unsigned int          _num,
+                                          const unsigned char * _pkt,
+                                          unsigned char *       _msg,
+                                          int *                 _valid);
+
+// run batch operation, splitting packets across threads
+unsigned int packetizer_batch(packetizer            _p,
+                              int                   _op,
+                              unsigned int          _num,
+                              const unsigned char * _in,
+                              unsigned char *       _out,
+                              int *                 _valid);
+
 // computes the number of encoded bytes after packetizing
 //
 //  _n      :   number of uncoded input bytes
@@ -97,45 +171,31 @@ packetizer packetizer_create(unsigned int _n,
 {
     packetizer p = (packetizer) malloc(sizeof(struct packetizer_s));
 
-    p->msg_len      = _n;
-    p->packet_len   = packetizer_compute_enc_msg_len(_n, _crc, _fec0, _fec1);
-    p->check        = _crc;
-    p->crc_length   = crc_get_length(p->check);
+    p->num_threads = 1;
+    p->workers     = NULL;
+    p->max_msg_len = 0;
+    p->max_packet_len = 0;
 
-    // allocate memory for buffers (scale by 8 for soft decoding)
-    p->buffer_len = p->packet_len;
-    p->buffer_0 = (unsigned char*) malloc(8*p->buffer_len);
-    p->buffer_1 = (unsigned char*) malloc(8*p->buffer_len);
+    // buffers are allocated once the configuration is known
+    p->buffer_len = 0;
+    p->buffer_0   = NULL;
+    p->buffer_1   = NULL;
 
-    // create plan
+    // create plan; fec and interleaver objects are created on demand
     p->plan_len = 2;
     p->plan = (struct fecintlv_plan*) malloc((p->plan_len)*sizeof(struct fecintlv_plan));
-
-    // set schemes
     unsigned int i;
-    unsigned int n0 = _n + p->crc_length;
+    unsigned int j;
     for (i=0; i<p->plan_len; i++) {
-        // set schemes
-        p->plan[i].fs = (i==0) ? _fec0 : _fec1;
-
-        // compute lengths
-        p->plan[i].dec_msg_len = n0;
-        p->plan[i].enc_msg_len = fec_get_enc_msg_length(p->plan[i].fs,
-                                                        p->plan[i].dec_msg_len);
-
-        // create objects
-        p->plan[i].f = fec_create(p->plan[i].fs, NULL);
-        p->plan[i].q = interleaver_create(p->plan[i].enc_msg_len);
-
-        // set interleaver depth to zero if no error correction scheme
-        // is applied to this plan
-        if (p->plan[i].fs == LIQUID_FEC_NONE)
-            interleaver_set_depth(p->plan[i].q, 0);
-
-        // update length
-        n0 = p->plan[i].enc_msg_len;
+        p->plan[i].fs = LIQUID_FEC_UNKNOWN;
+        p->plan[i].f  = NULL;
+        p->plan[i].q  = NULL;
+        for (j=0; j<LIQUID_FEC_NUM_SCHEMES; j++)
+            p->plan[i].fec_pool[j] = NULL;
     }
 
+    packetizer_configure(p, _n, _crc, _fec0, _fec1);
+
     return p;
 }
 
@@ -167,10 +227,100 @@ packetizer packetizer_recreate(packetizer _p,
         return _p;
     }
 
-    // something has changed; destroy old object and create new one
-    // TODO : rather than completely destroying object, only change values that are necessary
-    packetizer_destroy(_p);
-    return packetizer_create(_n,_crc,_fec0,_fec1);
+    // something has changed; reconfigure object in place
+    packetizer_configure(_p, _n, _crc, _fec0, _fec1);
+
+    // reconfigure packetizers for additional threads
+    unsigned int i;
+    for (i=0; i+1<_p->num_threads; i++)
+        packetizer_configure(_p->workers[i], _n, _crc, _fec0, _fec1);
+
+    return _p;
+}
+
+// pre-allocate memory for messages of up to _n bytes with any
+// error-detection scheme, the current error-correction schemes and those
+// in _fec (in either stage)
+void packetizer_reserve(packetizer         _p,
+                        unsigned int       _n,
+                        const fec_scheme * _fec,
+                        unsigned int       _num_fec)
+{
+    if (_n > _p->max_msg_len)
+        _p->max_msg_len = _n;
+
+    // create fec objects for requested schemes in each stage
+    unsigned int i;
+    unsigned int j;
+    for (j=0; j<_num_fec; j++) {
+        if ((unsigned int)_fec[j] >= LIQUID_FEC_NUM_SCHEMES) {
+            fprintf(stderr,"error: packetizer_reserve(), invalid fec scheme %d\n", (int)_fec[j]);
+            exit(1);
+        }
+        for (i=0; i<_p->plan_len; i++) {
+            if (_p->plan[i].fec_pool[_fec[j]] == NULL)
+                _p->plan[i].fec_pool[_fec[j]] = fec_create(_fec[j], NULL);
+        }
+    }
+
+    // every fec object of a stage and its interleaver are sized for the
+    // longest input to the stage
+    int fs;
+    unsigned int n0 = _p->max_msg_len + packetizer_max_crc_length();
+    for (i=0; i<_p->plan_len; i++) {
+        unsigned int n1 = 0;
+        for (fs=LIQUID_FEC_NONE; fs<LIQUID_FEC_NUM_SCHEMES; fs++) {
+            if (_p->plan[i].fec_pool[fs] == NULL)
+                continue;
+            fec_reserve(_p->plan[i].fec_pool[fs], n0);
+            if (fec_get_enc_msg_length(fs, n0) > n1)
+                n1 = fec_get_enc_msg_length(fs, n0);
+        }
+        n0 = n1;
+        if (n0 > interleaver_get_length(_p->plan[i].q)) {
+            interleaver_set_length(_p->plan[i].q, n0);
+            interleaver_set_length(_p->plan[i].q, _p->plan[i].enc_msg_len);
+        }
+    }
+    if (n0 > _p->max_packet_len)
+        _p->max_packet_len = n0;
+
+    // buffers: a block holds up to PACKETIZER_BATCH_BUFFER_LEN/8 bytes of
+    // packets unless a single packet is longer
+    unsigned int len = PACKETIZER_BATCH_BUFFER_LEN / 8;
+    if (len > PACKETIZER_BATCH_MAX*_p->max_packet_len) len = PACKETIZER_BATCH_MAX*_p->max_packet_len;
+    if (len < _p->max_packet_len)                      len = _p->max_packet_len;
+    packetizer_realloc_buffers(_p, len);
+
+    // packetizers for additional threads
+    for (i=0; i+1<_p->num_threads; i++)
+        packetizer_reserve(_p->workers[i], _p->max_msg_len, _fec, _num_fec);
+}
+
+// get the longest encoded message memory has been reserved for
+unsigned int packetizer_get_max_enc_msg_len(packetizer _p)
+{
+    return _p->max_packet_len;
+}
+
+// get the fec schemes for which objects exist in any stage
+//  _p      :   packetizer object
+//  _fec    :   output schemes [size: LIQUID_FEC_NUM_SCHEMES x 1]
+unsigned int packetizer_get_fec_pool(packetizer   _p,
+                                     fec_scheme * _fec)
+{
+    unsigned int num_fec = 0;
+    unsigned int i;
+    int fs;
+    for (fs=LIQUID_FEC_NONE; fs<LIQUID_FEC_NUM_SCHEMES; fs++) {
+        for (i=0; i<_p->plan_len; i++) {
+            if (_p->plan[i].fec_pool[fs] != NULL) {
+                _fec[num_fec++] = fs;
+                break;
+            }
+        }
+    }
+    return num_fec;
 }
 
 // destroy packetizer object
@@ -178,14 +328,23 @@ void packetizer_destroy(packetizer _p)
 {
     // free fec, interleaver objects
     unsigned int i;
+    unsigned int j;
     for (i=0; i<_p->plan_len; i++) {
-        fec_destroy(_p->plan[i].f);
+        for (j=0; j<LIQUID_FEC_NUM_SCHEMES; j++) {
+            if (_p->plan[i].fec_pool[j] != NULL)
+                fec_destroy(_p->plan[i].fec_pool[j]);
+        }
         interleaver_destroy(_p->plan[i].q);
     };
 
     // free plan
     free(_p->plan);
 
+    // destroy packetizers for additional threads
+    for (i=0; i+1<_p->num_threads; i++)
+        packetizer_destroy(_p->workers[i]);
+    free(_p->workers);
+
     // free buffers
     free(_p->buffer_0);
     free(_p->buffer_1);
@@ -239,6 +398,52 @@ fec_scheme packetizer_get_fec1(packetizer _p)
     return _p->plan[1].fs;
 }
 
+// get number of threads used for batch processing
+unsigned int packetizer_get_num_threads(packetizer _p)
+{
+    return _p->num_threads;
+}
+
+// set number of threads used for batch processing
+//  _p      :   packetizer object
+//  _n      :   number of threads, _n > 0
+void packetizer_set_num_threads(packetizer   _p,
+                                unsigned int _n)
+{
+    if (_n == 0) {
+        fprintf(stderr,"error: packetizer_set_num_threads(), number of threads must be greater than zero\n");
+        exit(1);
+    }
+#if !LIQUID_PTHREADS_ENABLED
+    // no thread support: process batches in calling thread
+    _n = 1;
+#endif
+
+    // destroy old packetizers for additional threads
+    unsigned int i;
+    for (i=0; i+1<_p->num_threads; i++)
+        packetizer_destroy(_p->workers[i]);
+    free(_p->workers);
+    _p->workers = NULL;
+
+    // each additional thread gets its own fec/interleaver objects and buffers
+    _p->num_threads = _n;
+    if (_n > 1) {
+        _p->workers = (packetizer*) malloc((_n-1)*sizeof(packetizer));
+        for (i=0; i<_n-1; i++) {
+            _p->workers[i] = packetizer_create(_p->msg_len,
+                                               _p->check,
+                                               _p->plan[0].fs,
+                                               _p->plan[1].fs);
+            if (_p->max_msg_len > 0) {
+                fec_scheme fec[LIQUID_FEC_NUM_SCHEMES];
+                unsigned int num_fec = packetizer_get_fec_pool(_p, fec);
+                packetizer_reserve(_p->workers[i], _p->max_msg_len, fec, num_fec);
+            }
+        }
+    }
+}
+
 // Execute the packetizer on an input message
 //
 //  _p      :   packetizer object
@@ -248,46 +453,7 @@ void packetizer_encode(packetizer            _p,
                        const unsigned char * _msg,
                        unsigned char *       _pkt)
 {
-    unsigned int i;
-
-    // copy input message to internal buffer[0] (or initialize to zeros)
-    if (_msg != NULL) {
-        // copy user-defined input
-        memmove(_p->buffer_0, _msg, _p->msg_len);
-    } else {
-        // initialize with zeros
-        memset(_p->buffer_0, 0x00, _p->msg_len);
-    }
-
-    // compute crc, append to buffer
-    unsigned int key = crc_generate_key(_p->check, _p->buffer_0, _p->msg_len);
-    for (i=0; i<_p->crc_length; i++) {
-        // append byte to buffer
-        _p->buffer_0[_p->msg_len+_p->crc_length-i-1] = key & 0xff;
-
-        // shift key by 8 bits
-        key >>= 8;
-    }
-
-    // whiten input sequence
-    scramble_data(_p->buffer_0, _p->msg_len + _p->crc_length);
-
-    // execute fec/interleaver plans
-    for (i=0; i<_p->plan_len; i++) {
-        // run the encoder: buffer[0] > buffer[1]
-        fec_encode(_p->plan[i].f,
-                   _p->plan[i].dec_msg_len,
-                   _p->buffer_0,
-                   _p->buffer_1);
-
-        // run the interleaver: buffer[1] > buffer[0]
-        interleaver_encode(_p->plan[i].q,
-                           _p->buffer_1,
-                           _p->buffer_0);
-    }
-
-    // copy result to output
-    memmove(_pkt, _p->buffer_0, _p->packet_len);
+    packetizer_encode_block(_p, 1, _msg, _pkt);
 }
 
 // Execute the packetizer to decode an input message, return validity
@@ -300,123 +466,507 @@ int packetizer_decode(packetizer            _p,
                       const unsigned char * _pkt,
                       unsigned char *       _msg)
 {
-    // copy coded message to internal buffer[0]
-    memmove(_p->buffer_0, _pkt, _p->packet_len);
+    return packetizer_decode_block(_p, 1, _pkt, _msg, NULL);
+}
+
+// Execute the packetizer to decode an input message, return validity
+// check of resulting data
+//
+//  _p      :   packetizer object
+//  _pkt    :   input message (coded soft bits)
+//  _msg    :   decoded output message
+int packetizer_decode_soft(packetizer            _p,
+                           const unsigned char * _pkt,
+                           unsigned char *       _msg)
+{
+    return packetizer_decode_soft_block(_p, 1, _pkt, _msg, NULL);
+}
+
+// Execute the packetizer on a batch of input messages
+//
+//  _p      :   packetizer object
+//  _num    :   number of messages
+//  _msg    :   input messages (uncoded bytes), [size: _num*dec_msg_len x 1]
+//  _pkt    :   encoded output messages, [size: _num*enc_msg_len x 1]
+void packetizer_encode_batch(packetizer            _p,
+                             unsigned int          _num,
+                             const unsigned char * _msg,
+                             unsigned char *       _pkt)
+{
+    packetizer_batch(_p, PACKETIZER_BATCH_ENCODE, _num, _msg, _pkt, NULL);
+}
+
+// Execute the packetizer to decode a batch of input messages, returning
+// the number of messages which passed the validity check
+//
+//  _p      :   packetizer object
+//  _num    :   number of messages
+//  _pkt    :   input messages (coded bytes), [size: _num*enc_msg_len x 1]
+//  _msg    :   decoded output messages, [size: _num*dec_msg_len x 1]
+//  _valid  :   validity of each decoded message, [size: _num x 1] (can be NULL)
+unsigned int packetizer_decode_batch(packetizer            _p,
+                                     unsigned int          _num,
+                                     const unsigned char * _pkt,
+                                     unsigned char *       _msg,
+                                     int *                 _valid)
+{
+    return packetizer_batch(_p, PACKETIZER_BATCH_DECODE, _num, _pkt, _msg, _valid);
+}
+
+// Execute the packetizer to decode a batch of input messages (soft bits),
+// returning the number of messages which passed the validity check
+//
+//  _p      :   packetizer object
+//  _num    :   number of messages
+//  _pkt    :   input messages (coded soft bits), [size: 8*_num*enc_msg_len x 1]
+//  _msg    :   decoded output messages, [size: _num*dec_msg_len x 1]
+//  _valid  :   validity of each decoded message, [size: _num x 1] (can be NULL)
+unsigned int packetizer_decode_soft_batch(packetizer            _p,
+                                          unsigned int          _num,
+                                          const unsigned char * _pkt,
+                                          unsigned char *       _msg,
+                                          int *                 _valid)
+{
+    return packetizer_batch(_p, PACKETIZER_BATCH_DECODE_SOFT, _num, _pkt, _msg, _valid);
+}
+
+// encode block of packets through internal buffers
+//  _p      :   packetizer object
+//  _num    :   number of packets, _num <= 8*batch_len
+//  _msg    :   input messages (NULL for all zeros)
+//  _pkt    :   encoded output messages
+void packetizer_encode_block(packetizer            _p,
+                             unsigned int          _num,
+                             const unsigned char * _msg,
+                             unsigned char *       _pkt)
+{
+    unsigned int n = _p->packet_len;    // buffer stride
+    unsigned int i;
+    unsigned int j;
+
+    // copy input messages, append key and whiten
+    for (j=0; j<_num; j++)
+        packetizer_encode_check(_p, _msg == NULL ? NULL : &_msg[j*_p->msg_len], &_p->buffer_0[j*n]);
 
     // execute fec/interleaver plans
+    for (i=0; i<_p->plan_len; i++) {
+        // run the encoder: buffer[0] > buffer[1]
+        for (j=0; j<_num; j++) {
+            fec_encode(_p->plan[i].f,
+                       _p->plan[i].dec_msg_len,
+                       &_p->buffer_0[j*n],
+                       &_p->buffer_1[j*n]);
+        }
+
+        // run the interleaver: buffer[1] > buffer[0] (output on last plan)
+        int last = (i == _p->plan_len-1);
+        for (j=0; j<_num; j++) {
+            interleaver_encode(_p->plan[i].q,
+                               &_p->buffer_1[j*n],
+                               last ? &_pkt[j*n] : &_p->buffer_0[j*n]);
+        }
+    }
+}
+
+// decode block of packets through internal buffers, return number valid
+//  _p      :   packetizer object
+//  _num    :   number of packets, _num <= 8*batch_len
+//  _pkt    :   input messages (coded bytes)
+//  _msg    :   decoded output messages
+//  _valid  :   validity of each decoded message (can be NULL)
+unsigned int packetizer_decode_block(packetizer            _p,
+                                     unsigned int          _num,
+                                     const unsigned char * _pkt,
+                                     unsigned char *       _msg,
+                                     int *                 _valid)
+{
+    unsigned int n = _p->packet_len;    // buffer stride
     unsigned int i;
+    unsigned int j;
+
+    // execute fec/interleaver plans; the first de-interleaver reads the
+    // input messages directly
+    unsigned char * x = (unsigned char*) _pkt;
     for (i=_p->plan_len; i>0; i--) {
         // run the de-interleaver: buffer[0] > buffer[1]
-        interleaver_decode(_p->plan[i-1].q,
-                           _p->buffer_0,
-                           _p->buffer_1);
+        for (j=0; j<_num; j++) {
+            interleaver_decode(_p->plan[i-1].q,
+                               &x[j*n],
+                               &_p->buffer_1[j*n]);
+        }
 
         // run the decoder: buffer[1] > buffer[0]
-        fec_decode(_p->plan[i-1].f,
-                   _p->plan[i-1].dec_msg_len,
-                   _p->buffer_1,
-                   _p->buffer_0);
+        for (j=0; j<_num; j++) {
+            fec_decode(_p->plan[i-1].f,
+                       _p->plan[i-1].dec_msg_len,
+                       &_p->buffer_1[j*n],
+                       &_p->buffer_0[j*n]);
+        }
+        x = _p->buffer_0;
     }
 
-    // remove sequence whitening
-    unscramble_data(_p->buffer_0, _p->msg_len + _p->crc_length);
-
-    // strip crc, validate message
-    unsigned int key = 0;
-    for (i=0; i<_p->crc_length; i++) {
-        key <<= 8;
-
-        key |= _p->buffer_0[_p->msg_len+i];
+    // remove sequence whitening, strip crc, and validate messages
+    unsigned int num_valid = 0;
+    for (j=0; j<_num; j++) {
+        int valid = packetizer_decode_check(_p, &_p->buffer_0[j*n], &_msg[j*_p->msg_len]);
+        if (_valid != NULL)
+            _valid[j] = valid;
+        num_valid += valid;
     }
-
-    // copy result to output
-    memmove(_msg, _p->buffer_0, _p->msg_len);
-
-    // return crc validity
-    return crc_validate_message(_p->check,
-                                _p->buffer_0,
-                                _p->msg_len,
-                                key);
+    return num_valid;
 }
 
-// Execute the packetizer to decode an input message, return validity
-// check of resulting data
-//
+// decode block of packets (soft bits) through internal buffers, return
+// number valid
 //  _p      :   packetizer object
-//  _pkt    :   input message (coded soft bits)
-//  _msg    :   decoded output message
-int packetizer_decode_soft(packetizer            _p,
-                           const unsigned char * _pkt,
-                           unsigned char *       _msg)
+//  _num    :   number of packets, _num <= batch_len
+//  _pkt    :   input messages (coded soft bits)
+//  _msg    :   decoded output messages
+//  _valid  :   validity of each decoded message (can be NULL)
+unsigned int packetizer_decode_soft_block(packetizer            _p,
+                                          unsigned int          _num,
+                                          const unsigned char * _pkt,
+                                          unsigned char *       _msg,
+                                          int *                 _valid)
 {
-    // copy coded message to internal buffer[0]
-    memmove(_p->buffer_0, _pkt, 8*_p->packet_len);
+    unsigned int n = 8*_p->packet_len;  // buffer stride
+    unsigned int j;
 
     // 
     // decode outer level using soft decoding
     //
 
-    // run the de-interleaver: buffer[0] > buffer[1]
-    interleaver_decode_soft(_p->plan[1].q,
-                            _p->buffer_0,
-                            _p->buffer_1);
+    // run the de-interleaver: input > buffer[1]
+    for (j=0; j<_num; j++) {
+        interleaver_decode_soft(_p->plan[1].q,
+                                (unsigned char*) &_pkt[j*n],
+                                &_p->buffer_1[j*n]);
+    }
 
     // run the decoder: buffer[1] > buffer[0]
-    fec_decode_soft(_p->plan[1].f,
-                    _p->plan[1].dec_msg_len,
-                    _p->buffer_1,
-                    _p->buffer_0);
+    for (j=0; j<_num; j++) {
+        fec_decode_soft(_p->plan[1].f,
+                        _p->plan[1].dec_msg_len,
+                        &_p->buffer_1[j*n],
+                        &_p->buffer_0[j*n]);
+    }
 
     // 
     // decode inner level using hard decoding
     //
 
     // run the de-interleaver: buffer[0] > buffer[1]
-    interleaver_decode(_p->plan[0].q,
-                       _p->buffer_0,
-                       _p->buffer_1);
+    for (j=0; j<_num; j++) {
+        interleaver_decode(_p->plan[0].q,
+                           &_p->buffer_0[j*n],
+                           &_p->buffer_1[j*n]);
+    }
 
     // run the decoder: buffer[1] > buffer[0]
-    fec_decode(_p->plan[0].f,
-               _p->plan[0].dec_msg_len,
-               _p->buffer_1,
-               _p->buffer_0);
+    for (j=0; j<_num; j++) {
+        fec_decode(_p->plan[0].f,
+                   _p->plan[0].dec_msg_len,
+                   &_p->buffer_1[j*n],
+                   &_p->buffer_0[j*n]);
+    }
+
+    // remove sequence whitening, strip crc, and validate messages
+    unsigned int num_valid = 0;
+    for (j=0; j<_num; j++) {
+        int valid = packetizer_decode_check(_p, &_p->buffer_0[j*n], &_msg[j*_p->msg_len]);
+        if (_valid != NULL)
+            _valid[j] = valid;
+        num_valid += valid;
+    }
+    return num_valid;
+}
 
-    // remove sequence whitening
-    unscramble_data(_p->buffer_0, _p->msg_len + _p->crc_length);
+// batch job for a single thread
+struct packetizer_batch_s {
+    packetizer              p;          // packetizer object for this thread
+    int                     op;         // batch operation
+    unsigned int            num;        // number of packets
+    const unsigned char *   in;         // input messages
+    unsigned char *         out;        // output messages
+    int *                   valid;      // validity of decoded messages
+    unsigned int            num_valid;  // number of valid decoded messages
+#if LIQUID_PTHREADS_ENABLED
+    pthread_t               thread;
+#endif
+};
+
+// run batch job in blocks of packets
+static void * packetizer_batch_run(void * _context)
+{
+    struct packetizer_batch_s * b = (struct packetizer_batch_s*) _context;
+    packetizer p = b->p;
+
+    // input/output strides and packets per block
+    unsigned int n_in  = b->op == PACKETIZER_BATCH_ENCODE ? p->msg_len : p->packet_len;
+    unsigned int n_out = b->op == PACKETIZER_BATCH_ENCODE ? p->packet_len : p->msg_len;
+    unsigned int block = 8*p->batch_len;
+    if (b->op == PACKETIZER_BATCH_DECODE_SOFT) {
+        n_in *= 8;
+        block = p->batch_len;
+    }
 
-    // strip crc, validate message
-    unsigned int key = 0;
     unsigned int i;
-    for (i=0; i<_p->crc_length; i++) {
-        key <<= 8;
+    b->num_valid = 0;
+    for (i=0; i<b->num; i+=block) {
+        unsigned int num = b->num - i < block ? b->num - i : block;
+        const unsigned char * in = b->in == NULL ? NULL : &b->in[i*n_in];
+        unsigned char * out = &b->out[i*n_out];
+        int * valid = b->valid == NULL ? NULL : &b->valid[i];
+        switch (b->op) {
+        case PACKETIZER_BATCH_ENCODE:
+            packetizer_encode_block(p, num, in, out);
+            break;
+        case PACKETIZER_BATCH_DECODE:
+            b->num_valid += packetizer_decode_block(p, num, in, out, valid);
+            break;
+        case PACKETIZER_BATCH_DECODE_SOFT:
+            b->num_valid += packetizer_decode_soft_block(p, num, in, out, valid);
+            break;
+        }
+    }
+    return NULL;
+}
 
-        key |= _p->buffer_0[_p->msg_len+i];
+// run batch operation, splitting packets across threads
+//  _p      :   packetizer object
+//  _op     :   batch operation
+//  _num    :   number of packets
+//  _in     :   input messages
+//  _out    :   output messages
+//  _valid  :   validity of each decoded message (can be NULL)
+unsigned int packetizer_batch(packetizer            _p,
+                              int                   _op,
+                              unsigned int          _num,
+                              const unsigned char * _in,
+                              unsigned char *       _out,
+                              int *                 _valid)
+{
+    // number of threads (each gets a contiguous range of packets)
+    unsigned int num_threads = _p->num_threads < _num ? _p->num_threads : _num;
+    if (num_threads < 1)
+        num_threads = 1;
+
+    unsigned int n_in  = _op == PACKETIZER_BATCH_ENCODE ? _p->msg_len : _p->packet_len;
+    unsigned int n_out = _op == PACKETIZER_BATCH_ENCODE ? _p->packet_len : _p->msg_len;
+    if (_op == PACKETIZER_BATCH_DECODE_SOFT)
+        n_in *= 8;
+
+    struct packetizer_batch_s b[num_threads];
+    unsigned int i;
+    for (i=0; i<num_threads; i++) {
+        unsigned int i0 = (i  )*_num / num_threads;
+        unsigned int i1 = (i+1)*_num / num_threads;
+        b[i].p     = i==0 ? _p : _p->workers[i-1];
+        b[i].op    = _op;
+        b[i].num   = i1 - i0;
+        b[i].in    = _in == NULL ? NULL : &_in[i0*n_in];
+        b[i].out   = &_out[i0*n_out];
+        b[i].valid = _valid == NULL ? NULL : &_valid[i0];
     }
 
-    // copy result to output
-    memmove(_msg, _p->buffer_0, _p->msg_len);
+#if LIQUID_PTHREADS_ENABLED
+    // run additional threads, then first range in calling thread
+    for (i=1; i<num_threads; i++) {
+        if (pthread_create(&b[i].thread, NULL, packetizer_batch_run, &b[i]) != 0) {
+            fprintf(stderr,"error: packetizer_batch(), could not create thread\n");
+            exit(1);
+        }
+    }
+    packetizer_batch_run(&b[0]);
+    for (i=1; i<num_threads; i++)
+        pthread_join(b[i].thread, NULL);
+#else
+    for (i=0; i<num_threads; i++)
+        packetizer_batch_run(&b[i]);
+#endif
+
+    unsigned int num_valid = 0;
+    for (i=0; i<num_threads; i++)
+        num_valid += b[i].num_valid;
+    return num_valid;
+}
+
+// copy message to buffer, append key and whiten
+//  _p      :   packetizer object
+//  _msg    :   input message (NULL for all zeros)
+//  _buf    :   output buffer
+void packetizer_encode_check(packetizer            _p,
+                             const unsigned char * _msg,
+                             unsigned char *       _buf)
+{
+    unsigned char * buf = _buf;
+    unsigned int key = crc_init_key(_p->check);
+    unsigned int i = 0;
+    unsigned int n = _p->msg_len;
+    while (1) {
+        unsigned int len = n - i < PACKETIZER_CHECK_BLOCK_LEN ? n - i : PACKETIZER_CHECK_BLOCK_LEN;
+
+        // copy user-defined input (or initialize to zeros)
+        if (_msg != NULL)
+            memmove(&buf[i], &_msg[i], len);
+        else
+            memset(&buf[i], 0x00, len);
+        key = crc_update_key(_p->check, key, &buf[i], len);
+
+        // last block: whiten along with key
+        if (i + len == n)
+            break;
+
+        scramble_data(&buf[i], len);
+        i += len;
+    }
+
+    // append key to buffer
+    key = crc_finalize_key(_p->check, key);
+    unsigned int j;
+    for (j=0; j<_p->crc_length; j++)
+        buf[n + _p->crc_length - j - 1] = (key >> (8*j)) & 0xff;
+
+    // whiten last block and key
+    scramble_data(&buf[i], n + _p->crc_length - i);
+}
+
+// remove whitening from buffer, copy message out and validate key
+//  _p      :   packetizer object
+//  _buf    :   input buffer (decoded, whitened message and key)
+//  _msg    :   decoded output message
+int packetizer_decode_check(packetizer      _p,
+                            unsigned char * _buf,
+                            unsigned char * _msg)
+{
+    unsigned char * buf = _buf;
+    unsigned int key = crc_init_key(_p->check);
+    unsigned int i = 0;
+    unsigned int n = _p->msg_len;
+    while (1) {
+        unsigned int len = n - i < PACKETIZER_CHECK_BLOCK_LEN ? n - i : PACKETIZER_CHECK_BLOCK_LEN;
+
+        // last block: remove whitening along with key
+        unsigned int last = (i + len == n);
+        unscramble_data(&buf[i], last ? len + _p->crc_length : len);
+
+        key = crc_update_key(_p->check, key, &buf[i], len);
+        memmove(&_msg[i], &buf[i], len);
+
+        if (last)
+            break;
+        i += len;
+    }
 
-    // return crc validity
-    return crc_validate_message(_p->check,
-                                _p->buffer_0,
-                                _p->msg_len,
-                                key);
+    // strip crc, validate message
+    unsigned int key_rx = 0;
+    unsigned int j;
+    for (j=0; j<_p->crc_length; j++)
+        key_rx = (key_rx << 8) | buf[n+j];
+
+    return crc_finalize_key(_p->check, key) == key_rx;
 }
 
 void packetizer_set_scheme(packetizer _p, int _fec0, int _fec1)
 {
-    //
+    packetizer_recreate(_p, _p->msg_len, _p->check, _fec0, _fec1);
 }
 
 // 
 // internal methods
 //
 
+// grow buffers to hold at least _len bytes of packets (scaled by 8 for
+// soft decoding); buffers are never shrunk
 void packetizer_realloc_buffers(packetizer _p, unsigned int _len)
 {
+    if (_len <= _p->buffer_len && _p->buffer_0 != NULL)
+        return;
+
+    // contents need not be preserved
+    free(_p->buffer_0);
+    free(_p->buffer_1);
     _p->buffer_len = _len;
-    _p->buffer_0 = (unsigned char*) realloc(_p->buffer_0, _p->buffer_len);
-    _p->buffer_1 = (unsigned char*) realloc(_p->buffer_1, _p->buffer_len);
+    _p->buffer_0 = (unsigned char*) malloc(8*_p->buffer_len);
+    _p->buffer_1 = (unsigned char*) malloc(8*_p->buffer_len);
+}
+
+// longest key of any error-detection scheme
+unsigned int packetizer_max_crc_length()
+{
+    unsigned int n = 0;
+    int c;
+    for (c=LIQUID_CRC_NONE; c<LIQUID_CRC_NUM_SCHEMES; c++)
+        n = crc_get_length(c) > n ? crc_get_length(c) : n;
+    return n;
+}
+
+// set message length and schemes, creating fec objects and growing
+// memory only as necessary
+void packetizer_configure(packetizer   _p,
+                          unsigned int _n,
+                          int          _crc,
+                          int          _fec0,
+                          int          _fec1)
+{
+    _p->msg_len      = _n;
+    _p->packet_len   = packetizer_compute_enc_msg_len(_n, _crc, _fec0, _fec1);
+    _p->check        = _crc;
+    _p->crc_length   = crc_get_length(_p->check);
+
+    // number of packets per block for batch processing
+    _p->batch_len = PACKETIZER_BATCH_BUFFER_LEN / (8*_p->packet_len);
+    if (_p->batch_len < 1)                    _p->batch_len = 1;
+    if (_p->batch_len > PACKETIZER_BATCH_MAX) _p->batch_len = PACKETIZER_BATCH_MAX;
+
+    // grow buffers if necessary
+    packetizer_realloc_buffers(_p, _p->batch_len * _p->packet_len);
+
+    // set schemes
+    unsigned int i;
+    unsigned int n0 = _n + _p->crc_length;
+    unsigned int m0 = _p->max_msg_len + _p->crc_length;
+    for (i=0; i<_p->plan_len; i++) {
+        fec_scheme fs = (i==0) ? _fec0 : _fec1;
+        if ((unsigned int)fs >= LIQUID_FEC_NUM_SCHEMES) {
+            fprintf(stderr,"error: packetizer_configure(), invalid fec scheme %d\n", (int)fs);
+            exit(1);
+        }
+
+        // get codec for scheme, creating (and reserving memory for) it
+        // the first time it is used
+        if (_p->plan[i].fec_pool[fs] == NULL) {
+            _p->plan[i].fec_pool[fs] = fec_create(fs, NULL);
+            if (_p->max_msg_len > 0)
+                fec_reserve(_p->plan[i].fec_pool[fs], m0);
+        }
+        if (_p->max_msg_len > 0)
+            m0 = fec_get_enc_msg_length(fs, m0);
+
+        // set interleaver depth to zero if no error correction scheme
+        // is applied to this plan
+        int depth_changed = (_p->plan[i].fs == LIQUID_FEC_NONE) != (fs == LIQUID_FEC_NONE);
+        _p->plan[i].fs = fs;
+        _p->plan[i].f  = _p->plan[i].fec_pool[fs];
+
+        // compute lengths
+        _p->plan[i].dec_msg_len = n0;
+        _p->plan[i].enc_msg_len = fec_get_enc_msg_length(fs, n0);
+
+        // create or resize interleaver
+        if (_p->plan[i].q == NULL) {
+            _p->plan[i].q = interleaver_create(_p->plan[i].enc_msg_len);
+            if (fs == LIQUID_FEC_NONE)
+                interleaver_set_depth(_p->plan[i].q, 0);
+        } else {
+            if (depth_changed)
+                interleaver_set_depth(_p->plan[i].q, fs == LIQUID_FEC_NONE ? 0 : 4);
+            if (interleaver_get_length(_p->plan[i].q) != _p->plan[i].enc_msg_len)
+                interleaver_set_length(_p->plan[i].q, _p->plan[i].enc_msg_len);
+        }
+
+        // update length
+        n0 = _p->plan[i].enc_msg_len;
+    }
 }
 
@@ -60,15 +60,34 @@ int fec_sumproduct(unsigned int    _m,
         exit(1);
     }
 
+    unsigned int i;
+    unsigned int j;
+
+    // compress rows of parity check matrix into edge list; messages are
+    // only kept for non-zero entries
+    unsigned int row_ptr[_m+1];
+    unsigned int num_edges = 0;
+    for (j=0; j<_m; j++) {
+        for (i=0; i<_n; i++)
+            num_edges += smatrixb_get(_H,j,i) ? 1 : 0;
+    }
+    unsigned int * col_idx = (unsigned int*) malloc(num_edges*sizeof(unsigned int));
+    unsigned int e = 0;
+    for (j=0; j<_m; j++) {
+        row_ptr[j] = e;
+        for (i=0; i<_n; i++) {
+            if (smatrixb_get(_H,j,i))
+                col_idx[e++] = i;
+        }
+    }
+    row_ptr[_m] = e;
+
     // internal variables
     unsigned int num_iterations = 0;
-    float Lq[_m*_n];
-    float Lr[_m*_n];
+    float * Lq = (float*) malloc(num_edges*sizeof(float));
+    float * Lr = (float*) malloc(num_edges*sizeof(float));
     float Lc[_n];
     float LQ[_n];
-    unsigned char parity[_m];
-    unsigned int i;
-    unsigned int j;
     int parity_pass;
     int continue_running = 1;
 
@@ -77,11 +96,8 @@ int fec_sumproduct(unsigned int    _m,
         Lc[i] = _LLR[i];
         //Lc[i] = 2.0f * _y[i] / (sigma*sigma);
 
-    for (j=0; j<_m; j++) {
-        for (i=0; i<_n; i++) {
-            Lq[j*_n+i] = smatrixb_get(_H,j,i) ? Lc[i] : 0.0f;
-        }
-    }
+    for (e=0; e<num_edges; e++)
+        Lq[e] = Lc[col_idx[e]];
 
 #if DEBUG_SUMPRODUCT
     // print Lc
@@ -97,8 +113,7 @@ int fec_sumproduct(unsigned int    _m,
 #endif
 
         // step sum-product algorithm
-        //parity_pass = fec_sumproduct_step(_H,_m,_n,_c_hat,Lq,Lr,Lc,LQ,parity);
-        parity_pass = fec_sumproduct_step(_m,_n,_H,_c_hat,Lq,Lr,Lc,LQ,parity);
+        parity_pass = fec_sumproduct_step(_m,_n,row_ptr,col_idx,_c_hat,Lq,Lr,Lc,LQ);
 
         // update...
         num_iterations++;
@@ -106,94 +121,69 @@ int fec_sumproduct(unsigned int    _m,
             continue_running = 0;
     }
 
+    free(col_idx);
+    free(Lq);
+    free(Lr);
+
     return parity_pass;
 }
 
 // sum-product algorithm, returns 1 if parity checks, 0 otherwise
-//  _m      :   rows
-//  _n      :   cols
-//  _H      :   sparse binary parity check matrix [size: _m x _n]
-//  _c_hat  :   estimated transmitted signal [size: _n x 1]
+//  _m          :   rows
+//  _n          :   cols
+//  _row_ptr    :   start of each row's edges in _col_idx [size: _m+1 x 1]
+//  _col_idx    :   column of each non-zero entry of H
+//  _c_hat      :   estimated transmitted signal [size: _n x 1]
 //
 // internal state arrays
-//  _Lq     :   [size: _m x _n]
-//  _Lr     :   [size: _m x _n]
+//  _Lq     :   variable-to-check messages [size: num_edges x 1]
+//  _Lr     :   check-to-variable messages [size: num_edges x 1]
 //  _Lc     :   [size: _n x 1]
 //  _LQ     :   [size: _n x 1]
-//  _parity :   _H * _c_hat [size: _m x 1]
 int fec_sumproduct_step(unsigned int    _m,
                         unsigned int    _n,
-                        smatrixb        _H,
+                        unsigned int *  _row_ptr,
+                        unsigned int *  _col_idx,
                         unsigned char * _c_hat,
                         float *         _Lq,
                         float *         _Lr,
                         float *         _Lc,
-                        float *         _LQ,
-                        unsigned char * _parity)
+                        float *         _LQ)
 {
     unsigned int i;
     unsigned int j;
-    unsigned int ip;
-    unsigned int jp;
+    unsigned int e;
+    unsigned int ep;
     float alpha_prod;
     float phi_sum;
     int parity_pass;
 
-    // compute Lr
-    for (i=0; i<_n; i++) {
-        for (j=0; j<_m; j++) {
+    // compute Lr from all other edges in each row
+    for (j=0; j<_m; j++) {
+        for (e=_row_ptr[j]; e<_row_ptr[j+1]; e++) {
             alpha_prod = 1.0f;
             phi_sum    = 0.0f;
-            for (ip=0; ip<_n; ip++) {
-                //if (_H[j*_n+ip]==1 && i != ip) {
-                if (smatrixb_get(_H,j,ip)==1 && i != ip) {
-                    float alpha = _Lq[j*_n+ip] > 0.0f ? 1.0f : -1.0f;
-                    float beta  = fabsf(_Lq[j*_n+ip]);
-                    phi_sum += sumproduct_phi(beta);
-                    alpha_prod *= alpha;
-                }
-            }
-            _Lr[j*_n+i] = alpha_prod * sumproduct_phi(phi_sum);
-        }
-    }
-
-#if DEBUG_SUMPRODUCT
-    // print Lq
-    matrixf_print(_Lq,_m,_n);
-
-    // print Lr
-    matrixf_print(_Lr,_m,_n);
-#endif
-
-    // compute next iteration of Lq
-    for (i=0; i<_n; i++) {
-        for (j=0; j<_m; j++) {
-            // initialize with LLR
-            _Lq[j*_n+i] = _Lc[i];
-
-            for (jp=0; jp<_m; jp++) {
-                //if (_H[jp*_n+i]==1 && j != jp)
-                if (smatrixb_get(_H,jp,i)==1 && j != jp)
-                    _Lq[j*_n+i] += _Lr[jp*_n+i];
+            for (ep=_row_ptr[j]; ep<_row_ptr[j+1]; ep++) {
+                if (ep == e)
+                    continue;
+                float alpha = _Lq[ep] > 0.0f ? 1.0f : -1.0f;
+                float beta  = fabsf(_Lq[ep]);
+                phi_sum += sumproduct_phi(beta);
+                alpha_prod *= alpha;
             }
+            _Lr[e] = alpha_prod * sumproduct_phi(phi_sum);
         }
     }
 
-#if DEBUG_SUMPRODUCT
-    // print Lq
-    matrixf_print(_Lq,_m,_n);
-#endif
-
     // compute LQ
-    for (i=0; i<_n; i++) {
+    for (i=0; i<_n; i++)
         _LQ[i] = _Lc[i];  // initialize with LLR value
+    for (e=0; e<_row_ptr[_m]; e++)
+        _LQ[_col_idx[e]] += _Lr[e];
 
-        for (j=0; j<_m; j++) {
-            //if (_H[j*_n+i]==1)
-            if (smatrixb_get(_H,j,i)==1)
-                _LQ[i] += _Lr[j*_n+i];
-        }
-    }
+    // compute next iteration of Lq from all other edges in each column
+    for (e=0; e<_row_ptr[_m]; e++)
+        _Lq[e] = _LQ[_col_idx[e]] - _Lr[e];
 
 #if DEBUG_SUMPRODUCT
     // print LQ
@@ -204,13 +194,13 @@ int fec_sumproduct_step(unsigned int    _m,
     for (i=0; i<_n; i++)
         _c_hat[i] = _LQ[i] < 0.0f ? 1 : 0;
 
-    // compute parity check: p = H*c_hat
-    smatrixb_vmul(_H, _c_hat, _parity);
-
-    // check parity
+    // check parity: p = H*c_hat
     parity_pass = 1;
     for (j=0; j<_m; j++) {
-        if (_parity[j]) parity_pass = 0;
+        unsigned char parity = 0;
+        for (e=_row_ptr[j]; e<_row_ptr[j+1]; e++)
+            parity ^= _c_hat[_col_idx[e]];
+        if (parity) parity_pass = 0;
     }
 
 #if DEBUG_SUMPRODUCT
@@ -220,15 +210,8 @@ int fec_sumproduct_step(unsigned int    _m,
         printf(" %1u", _c_hat[i]);
     printf(" ],  ");
 
-    // print parity
-    printf("parity = [");
-    for (j=0; j<_m; j++)
-        printf(" %1u", _parity[j]);
-    printf(" ],  ");
-
     printf(" (%s)\n", parity_pass ? "pass" : "FAIL");
 #endif
 
     return parity_pass;
 }
-
@@ -20,10 +20,11 @@
  * THE SOFTWARE.
  */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "autotest/autotest.h"
-#include "liquid.h"
+#include "liquid.internal.h"
 
 //
 // AUTOTEST: reverse byte
@@ -120,3 +121,88 @@ void autotest_crc24()    { validate_crc(LIQUID_CRC_24,          64); }
 void autotest_crc32()    { validate_crc(LIQUID_CRC_32,          64); }
 
 
+
+//
+// AUTOTEST : check values for the standard test message
+//
+void autotest_crc_check_values()
+{
+    unsigned char msg[9] = {'1','2','3','4','5','6','7','8','9'};
+    CONTEND_EQUALITY(crc_generate_key(LIQUID_CRC_CHECKSUM, msg, 9), 0x23);
+    CONTEND_EQUALITY(crc_generate_key(LIQUID_CRC_8,        msg, 9), 0x23);
+    CONTEND_EQUALITY(crc_generate_key(LIQUID_CRC_16,       msg, 9), 0xb4d3);
+    CONTEND_EQUALITY(crc_generate_key(LIQUID_CRC_24,       msg, 9), 0x062bb3);
+    CONTEND_EQUALITY(crc_generate_key(LIQUID_CRC_32,       msg, 9), 0xcbf43926);
+}
+
+// bit-serial reference for reflected keys with 32-bit all-ones register
+//  _poly   :   reflected generator polynomial
+//  _mask   :   key mask
+unsigned int crc_autotest_bitwise(unsigned int    _poly,
+                                  unsigned int    _mask,
+                                  unsigned char * _msg,
+                                  unsigned int    _n)
+{
+    unsigned int i, j, key=~0;
+    for (i=0; i<_n; i++) {
+        key ^= _msg[i];
+        for (j=0; j<8; j++)
+            key = (key >> 1) ^ (_poly & -(key & 1));
+    }
+    return (~key) & _mask;
+}
+
+//
+// AUTOTEST : table-driven (and folded, if supported) keys match the
+//            bit-serial algorithm for lengths spanning all code paths
+//
+void autotest_crc_bitwise()
+{
+    unsigned int n = 600;
+    unsigned char msg[n];
+    unsigned int i;
+    for (i=0; i<n; i++)
+        msg[i] = rand() & 0xff;
+
+    for (i=0; i<=n; i+=(i < 160 ? 1 : 37)) {
+        CONTEND_EQUALITY(crc_generate_key(LIQUID_CRC_8,  msg, i),
+                         crc_autotest_bitwise(liquid_reverse_byte(CRC8_POLY), 0xff, msg, i));
+        CONTEND_EQUALITY(crc_generate_key(LIQUID_CRC_16, msg, i),
+                         crc_autotest_bitwise(liquid_reverse_uint16(CRC16_POLY), 0xffff, msg, i));
+        CONTEND_EQUALITY(crc_generate_key(LIQUID_CRC_24, msg, i),
+                         crc_autotest_bitwise(liquid_reverse_uint24(CRC24_POLY), 0xffffff, msg, i));
+        CONTEND_EQUALITY(crc_generate_key(LIQUID_CRC_32, msg, i),
+                         crc_autotest_bitwise(liquid_reverse_uint32(CRC32_POLY), 0xffffffff, msg, i));
+    }
+}
+
+// 
+// autotest helper function: compute key incrementally over segments of
+// varying length and compare to key over whole message
+//
+void validate_crc_stream(crc_scheme   _check,
+                         unsigned int _n)
+{
+    unsigned char msg[_n];
+    unsigned int i;
+    for (i=0; i<_n; i++)
+        msg[i] = rand() & 0xff;
+
+    unsigned int key = crc_init_key(_check);
+    unsigned int len = 0;
+    for (i=0; i<_n; i+=len) {
+        len = 1 + (i % 157);
+        if (i + len > _n)
+            len = _n - i;
+        key = crc_update_key(_check, key, &msg[i], len);
+    }
+    key = crc_finalize_key(_check, key);
+
+    CONTEND_EQUALITY(key, crc_generate_key(_check, msg, _n));
+}
+
+void autotest_crc_stream_checksum() { validate_crc_stream(LIQUID_CRC_CHECKSUM, 1000); }
+void autotest_crc_stream_crc8()     { validate_crc_stream(LIQUID_CRC_8,        1000); }
+void autotest_crc_stream_crc16()    { validate_crc_stream(LIQUID_CRC_16,       1000); }
+void autotest_crc_stream_crc24()    { validate_crc_stream(LIQUID_CRC_24,       1000); }
+void autotest_crc_stream_crc32()    { validate_crc_stream(LIQUID_CRC_32,       1000); }
@@ -105,3 +105,49 @@ void autotest_golay2412_codec()
     }
 }
 
+//
+// AUTOTEST: Golay(24,12) block codec against symbol codec for every
+// message and for random received symbols (including uncorrectable
+// error patterns)
+//
+void autotest_golay2412_block()
+{
+    fec q = fec_create(LIQUID_FEC_GOLAY2412, NULL);
+
+    unsigned char msg_dec[3];   // two 12-bit symbols
+    unsigned char msg_enc[6];   // two 24-bit symbols
+    unsigned int i;
+    for (i=0; i<4096; i++) {
+        // encode message [i, ~i]
+        unsigned int m0 = i;
+        unsigned int m1 = ~i & 0xfff;
+        msg_dec[0] = (m0 >> 4) & 0xff;
+        msg_dec[1] = ((m0 << 4) & 0xf0) | ((m1 >> 8) & 0x0f);
+        msg_dec[2] = m1 & 0xff;
+        fec_encode(q, 3, msg_dec, msg_enc);
+
+        unsigned int v0 = (msg_enc[0] << 16) | (msg_enc[1] << 8) | msg_enc[2];
+        unsigned int v1 = (msg_enc[3] << 16) | (msg_enc[4] << 8) | msg_enc[5];
+        CONTEND_EQUALITY(v0, fec_golay2412_encode_symbol(m0));
+        CONTEND_EQUALITY(v1, fec_golay2412_encode_symbol(m1));
+
+        // decode random received symbols
+        v0 = ((rand() & 0xfff) << 12) | (rand() & 0xfff);
+        v1 = ((rand() & 0xfff) << 12) | (rand() & 0xfff);
+        msg_enc[0] = (v0 >> 16) & 0xff;
+        msg_enc[1] = (v0 >>  8) & 0xff;
+        msg_enc[2] = (v0      ) & 0xff;
+        msg_enc[3] = (v1 >> 16) & 0xff;
+        msg_enc[4] = (v1 >>  8) & 0xff;
+        msg_enc[5] = (v1      ) & 0xff;
+        fec_decode(q, 3, msg_enc, msg_dec);
+
+        m0 = (msg_dec[0] << 4) | (msg_dec[1] >> 4);
+        m1 = ((msg_dec[1] & 0x0f) << 8) | msg_dec[2];
+        CONTEND_EQUALITY(m0, fec_golay2412_decode_symbol(v0));
+        CONTEND_EQUALITY(m1, fec_golay2412_decode_symbol(v1));
+    }
+
+    fec_destroy(q);
+}
+
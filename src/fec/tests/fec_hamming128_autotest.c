@@ -103,3 +103,56 @@ void autotest_hamming128_codec_soft()
     }
 }
 
+//
+// AUTOTEST: Hamming (12,8) block decoder against symbol decoder for
+// every received symbol
+//
+void autotest_hamming128_block()
+{
+    fec q = fec_create(LIQUID_FEC_HAMMING128, NULL);
+
+    unsigned char msg_enc[2];   // one 12-bit symbol, zero padded
+    unsigned char msg_dec[1];
+    unsigned int r;
+    for (r=0; r<4096; r++) {
+        msg_enc[0] = (r >> 4) & 0xff;
+        msg_enc[1] = (r << 4) & 0xf0;
+        fec_decode(q, 1, msg_enc, msg_dec);
+        CONTEND_EQUALITY(msg_dec[0], fec_hamming128_decode_symbol(r));
+    }
+
+    fec_destroy(q);
+}
+
+//
+// AUTOTEST: Hamming (12,8) soft decoding is maximum likelihood,
+// resolving ties to the lowest symbol
+//
+void autotest_hamming128_codec_soft_ml()
+{
+    // soft bit values with frequent ties in distance
+    unsigned char v[5] = {0, 64, 127, 191, 255};
+    unsigned char c_soft[12];
+    unsigned int t;
+    unsigned int i;
+    for (t=0; t<2000; t++) {
+        for (i=0; i<12; i++)
+            c_soft[i] = (t < 1000) ? v[rand() % 5] : rand() & 0xff;
+
+        // exhaustive search
+        unsigned int s, s_ml = 0, dmin = 0;
+        for (s=0; s<256; s++) {
+            unsigned int c = hamming128_enc_gentab[s];
+            unsigned int d = 0;
+            for (i=0; i<12; i++)
+                d += ( (c >> (11-i)) & 1 ) ? 255 - c_soft[i] : c_soft[i];
+            if (d < dmin || s==0) {
+                s_ml = s;
+                dmin = d;
+            }
+        }
+
+        CONTEND_EQUALITY(fecsoft_hamming128_decode(c_soft), s_ml);
+    }
+}
+
@@ -20,6 +20,7 @@
  * THE SOFTWARE.
  */
 
+#include <stdlib.h>
 #include "autotest/autotest.h"
 #include "liquid.internal.h"
 
@@ -99,3 +100,35 @@ void autotest_hamming84_codec_soft()
     }
 }
 
+//
+// AUTOTEST: Hamming (8,4) soft decoding is maximum likelihood,
+// resolving ties to the lowest symbol
+//
+void autotest_hamming84_codec_soft_ml()
+{
+    // soft bit values with frequent ties in distance
+    unsigned char v[5] = {0, 64, 127, 191, 255};
+    unsigned char c_soft[8];
+    unsigned int t;
+    unsigned int i;
+    for (t=0; t<2000; t++) {
+        for (i=0; i<8; i++)
+            c_soft[i] = (t < 1000) ? v[rand() % 5] : rand() & 0xff;
+
+        // exhaustive search
+        unsigned int s, s_ml = 0, dmin = 0;
+        for (s=0; s<16; s++) {
+            unsigned int c = hamming84_enc_gentab[s];
+            unsigned int d = 0;
+            for (i=0; i<8; i++)
+                d += ( (c >> (7-i)) & 1 ) ? 255 - c_soft[i] : c_soft[i];
+            if (d < dmin || s==0) {
+                s_ml = s;
+                dmin = d;
+            }
+        }
+
+        CONTEND_EQUALITY(fecsoft_hamming84_decode(c_soft), s_ml);
+    }
+}
+
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "autotest/autotest.h"
+#include "liquid.internal.h"
+
+// small (8,4) code from sandbox/fec_sumproduct_test.c
+static unsigned char ldpc_test_H[32] = {
+    1, 1, 1, 0, 0, 0, 0, 0,
+    0, 0, 0, 1, 1, 1, 0, 0,
+    1, 0, 0, 1, 0, 0, 1, 0,
+    0, 1, 0, 0, 1, 0, 0, 1};
+
+//
+// AUTOTEST: sum-product and min-sum decoders correct the same received
+//           word of a small code (two bits in error)
+//
+void autotest_ldpc_minsum_small()
+{
+    unsigned char c[8] = {1, 0, 1, 0, 1, 1, 1, 1};
+    float y[8] = {0.2, 0.2, -0.9, 0.6, 0.5, -1.1, -0.4, -1.2};
+    smatrixb H = smatrixb_create_array(ldpc_test_H, 4, 8);
+
+    float LLR[8];
+    short int llr[8];
+    unsigned int i;
+    for (i=0; i<8; i++) {
+        LLR[i] = 4.0f*y[i];
+        llr[i] = (short int)(64.0f*y[i]);
+    }
+
+    // sum-product algorithm
+    unsigned char c_hat[8];
+    CONTEND_EQUALITY( fec_sumproduct(4, 8, H, LLR, c_hat, 10), 1 );
+    CONTEND_SAME_DATA( c_hat, c, 8 );
+
+    // min-sum decoder
+    fec_minsum q = fec_minsum_create(H);
+    CONTEND_EQUALITY( fec_minsum_get_n(q), 8 );
+    memset(c_hat, 0x00, sizeof(c_hat));
+    CONTEND_EQUALITY( fec_minsum_decode(q, llr, 10, c_hat), 1 );
+    CONTEND_SAME_DATA( c_hat, c, 8 );
+
+    fec_minsum_destroy(q);
+    smatrixb_destroy(H);
+}
+
+//
+// AUTOTEST: quasi-cyclic (vector) schedule gives the same result as the
+//           generic row-by-row schedule, including on failures
+//
+void autotest_ldpc_minsum_qc_csr()
+{
+    fec q = fec_create(LIQUID_FEC_LDPC_R12, NULL);
+    unsigned int n = fec_minsum_get_n(q->ldpc);
+    CONTEND_EQUALITY( n, 1024 );
+
+    short int     llr_qc[n], llr_csr[n];
+    unsigned char c_qc[n],   c_csr[n];
+    unsigned int i, t;
+    for (t=0; t<20; t++) {
+        // random LLRs with a bias towards zero to exercise both outcomes
+        for (i=0; i<n; i++)
+            llr_qc[i] = llr_csr[i] = (short int)(rand() % 256) - 100 + 2*t;
+        int rc_qc  = fec_minsum_decode    (q->ldpc, llr_qc,  8, c_qc);
+        unsigned int it_qc = fec_minsum_get_num_iterations(q->ldpc);
+        int rc_csr = fec_minsum_decode_csr(q->ldpc, llr_csr, 8, c_csr);
+        unsigned int it_csr = fec_minsum_get_num_iterations(q->ldpc);
+
+        CONTEND_EQUALITY( rc_qc, rc_csr );
+        CONTEND_EQUALITY( it_qc, it_csr );
+        CONTEND_SAME_DATA( c_qc, c_csr, n );
+    }
+    fec_destroy(q);
+}
+
+// Test hard-decision decoding of multi-block message with bit errors
+// spread over every code word
+//  _fs         :   coding scheme
+//  _n          :   message length (bytes)
+//  _num_errors :   bit errors per encoded block
+void ldpc_test_bit_errors(fec_scheme   _fs,
+                          unsigned int _n,
+                          unsigned int _num_errors)
+{
+    fec q = fec_create(_fs, NULL);
+    unsigned int n_enc = fec_get_enc_msg_length(_fs, _n);
+    unsigned char msg[_n], msg_enc[n_enc], msg_dec[_n];
+
+    unsigned int i;
+    for (i=0; i<_n; i++)
+        msg[i] = rand() & 0xff;
+    fec_encode(q, _n, msg, msg_enc);
+
+    // flip bits in every encoded block
+    unsigned int b;
+    for (b=0; b<q->num_blocks; b++) {
+        for (i=0; i<_num_errors; i++) {
+            unsigned int k = rand() % (8*q->enc_block_len);
+            msg_enc[b*q->enc_block_len + k/8] ^= 0x80 >> (k%8);
+        }
+    }
+    fec_decode(q, _n, msg_enc, msg_dec);
+    CONTEND_SAME_DATA( msg, msg_dec, _n );
+
+    fec_destroy(q);
+}
+
+void autotest_ldpc_r12_bit_errors() { ldpc_test_bit_errors(LIQUID_FEC_LDPC_R12, 1000,  6); }
+void autotest_ldpc_r34_bit_errors() { ldpc_test_bit_errors(LIQUID_FEC_LDPC_R34, 1000,  6); }
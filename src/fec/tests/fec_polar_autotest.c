@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "autotest/autotest.h"
+#include "liquid.internal.h"
+
+// Test polar code over an AWGN channel, returning number of blocks decoded
+//  _E          :   code bits
+//  _k          :   data bits
+//  _list_size  :   decoder list size
+//  _sigma      :   noise standard deviation (unit-amplitude BPSK)
+//  _num_trials :   number of blocks
+unsigned int polarcode_test_awgn(unsigned int _E,
+                                 unsigned int _k,
+                                 unsigned int _list_size,
+                                 float        _sigma,
+                                 unsigned int _num_trials)
+{
+    fec_polarcode q = fec_polarcode_create(_E, _k, LIQUID_CRC_16, _list_size);
+    CONTEND_EQUALITY( fec_polarcode_get_n(q), _E );
+    CONTEND_EQUALITY( fec_polarcode_get_k(q), _k + 16 );
+
+    unsigned char msg[_k/8], msg_enc[_E/8], msg_dec[_k/8];
+    short int llr[_E];
+    unsigned int num_decoded = 0;
+    unsigned int i, t;
+    for (t=0; t<_num_trials; t++) {
+        for (i=0; i<_k/8; i++)
+            msg[i] = rand() & 0xff;
+        fec_polarcode_encode(q, msg, msg_enc);
+
+        // BPSK over AWGN, LLRs scaled to 16 per unit amplitude
+        for (i=0; i<_E; i++) {
+            float y  = ((msg_enc[i/8] >> (7-(i%8))) & 1 ? -1.0f : 1.0f) + _sigma*randnf();
+            llr[i] = (short int)(16.0f*y);
+        }
+        int crc_pass = fec_polarcode_decode(q, llr, msg_dec);
+        if (memcmp(msg, msg_dec, _k/8) == 0) {
+            CONTEND_EQUALITY( crc_pass, 1 );
+            num_decoded++;
+        }
+    }
+    fec_polarcode_destroy(q);
+    return num_decoded;
+}
+
+//
+// AUTOTEST: noiseless round trip for power-of-two and shortened lengths,
+//           exercising every node type
+//
+void autotest_polarcode_noiseless()
+{
+    CONTEND_EQUALITY( polarcode_test_awgn(  48,   8, 8, 0.0f, 10), 10 );
+    CONTEND_EQUALITY( polarcode_test_awgn( 256, 112, 8, 0.0f, 10), 10 );
+    CONTEND_EQUALITY( polarcode_test_awgn( 408, 184, 1, 0.0f, 10), 10 );
+    CONTEND_EQUALITY( polarcode_test_awgn(1024, 496, 8, 0.0f, 10), 10 );
+    CONTEND_EQUALITY( polarcode_test_awgn( 768, 560, 4, 0.0f, 10), 10 );
+}
+
+//
+// AUTOTEST: list decoding with CRC selection decodes more blocks than
+//           successive cancellation alone
+//
+void autotest_polarcode_list_gain()
+{
+    unsigned int num_sc   = polarcode_test_awgn(512, 240, 1, 0.80f, 100);
+    unsigned int num_list = polarcode_test_awgn(512, 240, 8, 0.80f, 100);
+    if (liquid_autotest_verbose)
+        printf("polar (512,256) : SC %3u/100, SCL-8 %3u/100\n", num_sc, num_list);
+    CONTEND_GREATER_THAN( num_list, num_sc );
+    CONTEND_GREATER_THAN( num_list, 90 );
+}
+
+// Test hard-decision decoding of multi-block message with bit errors
+// spread over every code word
+//  _fs         :   coding scheme
+//  _n          :   message length (bytes)
+//  _num_errors :   bit errors per encoded block
+void polar_test_bit_errors(fec_scheme   _fs,
+                           unsigned int _n,
+                           unsigned int _num_errors)
+{
+    fec q = fec_create(_fs, NULL);
+    unsigned int n_enc = fec_get_enc_msg_length(_fs, _n);
+    unsigned char msg[_n], msg_enc[n_enc], msg_dec[_n];
+
+    unsigned int i;
+    for (i=0; i<_n; i++)
+        msg[i] = rand() & 0xff;
+    fec_encode(q, _n, msg, msg_enc);
+    CONTEND_EQUALITY( q->enc_block_len*q->num_blocks, n_enc );
+
+    // flip bits in every encoded block
+    unsigned int b;
+    for (b=0; b<q->num_blocks; b++) {
+        for (i=0; i<_num_errors; i++) {
+            unsigned int k = rand() % (8*q->enc_block_len);
+            msg_enc[b*q->enc_block_len + k/8] ^= 0x80 >> (k%8);
+        }
+    }
+    fec_decode(q, _n, msg_enc, msg_dec);
+    CONTEND_SAME_DATA( msg, msg_dec, _n );
+
+    fec_destroy(q);
+}
+
+void autotest_polar_r12_bit_errors() { polar_test_bit_errors(LIQUID_FEC_POLAR_R12, 1000, 8); }
+void autotest_polar_r34_bit_errors() { polar_test_bit_errors(LIQUID_FEC_POLAR_R34, 1000, 2); }
@@ -31,11 +31,6 @@
 //
 void autotest_reedsolomon_223_255()
 {
-#if !LIBFEC_ENABLED
-    printf("warning: Reed-Solomon codes unavailable\n");
-    return;
-#endif
-
     unsigned int dec_msg_len = 223;
 
     // compute and test encoded message length
@@ -83,3 +78,89 @@ void autotest_reedsolomon_223_255()
     fec_destroy(q);
 }
 
+
+// multi-block message with the maximum number of symbol errors in
+// each block
+void autotest_reedsolomon_multiblock()
+{
+    unsigned int dec_msg_len = 1024;    // five shortened blocks
+    unsigned int enc_msg_len = fec_get_enc_msg_length(LIQUID_FEC_RS_M8,dec_msg_len);
+    CONTEND_EQUALITY( enc_msg_len, 5*237 );
+
+    unsigned char msg_org[dec_msg_len]; // original message
+    unsigned char msg_enc[enc_msg_len]; // encoded message
+    unsigned char msg_dec[dec_msg_len]; // decoded message
+
+    // initialize original message (local generator keeps rand() untouched)
+    unsigned int i;
+    for (i=0; i<dec_msg_len; i++)
+        msg_org[i] = rand() & 0xff;
+
+    fec q = fec_create(LIQUID_FEC_RS_M8,NULL);
+    fec_encode(q, dec_msg_len, msg_org, msg_enc);
+
+    // corrupt 16 symbols in each 237-symbol block, including parity
+    unsigned int b;
+    for (b=0; b<5; b++) {
+        for (i=0; i<16; i++)
+            msg_enc[237*b + 15*i] ^= 0x80 | (b + i);
+    }
+
+    fec_decode(q, dec_msg_len, msg_enc, msg_dec);
+    CONTEND_SAME_DATA(msg_org, msg_dec, dec_msg_len);
+
+    fec_destroy(q);
+}
+
+// batch decoding: corrected symbol counts and uncorrectable blocks
+void autotest_reedsolomon_batch()
+{
+    unsigned int pad        = 100;          // shortened code
+    unsigned int n          = 255 - pad;    // block length
+    unsigned int k          = n - 32;       // data symbols per block
+    unsigned int num_blocks = 17;           // full batch plus a lone block
+
+    fec_rscodec q = fec_rscodec_create(0x11d, 1, 1, 32, pad);
+
+    unsigned char blocks_org[num_blocks*n];
+    unsigned char blocks_rx [num_blocks*n];
+    unsigned char block_one [n];
+    int num_errors[num_blocks];
+
+    unsigned int b;
+    unsigned int i;
+    for (b=0; b<num_blocks; b++) {
+        unsigned char * block = &blocks_org[b*n];
+        for (i=0; i<k; i++)
+            block[i] = rand() & 0xff;
+        fec_rscodec_encode(q, block, &block[k]);
+    }
+    memmove(blocks_rx, blocks_org, num_blocks*n*sizeof(unsigned char));
+
+    // block b has (b % 17) errors; block 5 additionally exceeds the
+    // correction capability of the code
+    for (b=0; b<num_blocks; b++) {
+        unsigned int num_sym = b == 5 ? 24 : b % 17;
+        for (i=0; i<num_sym; i++)
+            blocks_rx[b*n + (7*i + b) % n] ^= 1 + ((b*31 + i) % 255);
+    }
+
+    // decode single block for comparison
+    memmove(block_one, &blocks_rx[3*n], n*sizeof(unsigned char));
+    CONTEND_EQUALITY( fec_rscodec_decode(q, block_one), 3 );
+
+    unsigned int num_failed = fec_rscodec_decode_batch(q, blocks_rx, num_blocks, n, num_errors);
+    CONTEND_EQUALITY( num_failed, 1 );
+    for (b=0; b<num_blocks; b++) {
+        if (b == 5) {
+            CONTEND_EQUALITY( num_errors[b], -1 );
+            continue;
+        }
+        CONTEND_EQUALITY( num_errors[b], (int)(b % 17) );
+        CONTEND_SAME_DATA( &blocks_rx[b*n], &blocks_org[b*n], n );
+    }
+    CONTEND_SAME_DATA( block_one, &blocks_org[3*n], n );
+
+    fec_rscodec_destroy(q);
+}
+
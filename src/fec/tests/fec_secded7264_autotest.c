@@ -177,3 +177,28 @@ void autotest_secded7264_codec_e2()
     }
 }
 
+//
+// AUTOTEST: SEC-DEC (72,64) parity against parity matrix
+//
+void autotest_secded7264_parity()
+{
+    unsigned char m[8];
+    unsigned int t;
+    unsigned int i;
+    unsigned int j;
+    for (t=0; t<1000; t++) {
+        for (i=0; i<8; i++)
+            m[i] = rand() & 0xff;
+
+        // parity bit i is inner product of message with row i of P
+        unsigned char parity = 0x00;
+        for (i=0; i<8; i++) {
+            unsigned int p = 0;
+            for (j=0; j<8; j++)
+                p += liquid_c_ones[ secded7264_P[8*i+j] & m[j] ];
+            parity = (parity << 1) | (p & 0x01);
+        }
+
+        CONTEND_EQUALITY(fec_secded7264_compute_parity(m), parity);
+    }
+}
@@ -31,30 +31,6 @@ void fec_test_soft_codec(fec_scheme _fs,
                          unsigned int _n,
                          void * _opts)
 {
-#if !LIBFEC_ENABLED
-    if ( _fs == LIQUID_FEC_CONV_V27    ||
-         _fs == LIQUID_FEC_CONV_V29    ||
-         _fs == LIQUID_FEC_CONV_V39    ||
-         _fs == LIQUID_FEC_CONV_V615   ||
-         _fs == LIQUID_FEC_CONV_V27P23 ||
-         _fs == LIQUID_FEC_CONV_V27P34 ||
-         _fs == LIQUID_FEC_CONV_V27P45 ||
-         _fs == LIQUID_FEC_CONV_V27P56 ||
-         _fs == LIQUID_FEC_CONV_V27P67 ||
-         _fs == LIQUID_FEC_CONV_V27P78 ||
-         _fs == LIQUID_FEC_CONV_V29P23 ||
-         _fs == LIQUID_FEC_CONV_V29P34 ||
-         _fs == LIQUID_FEC_CONV_V29P45 ||
-         _fs == LIQUID_FEC_CONV_V29P56 ||
-         _fs == LIQUID_FEC_CONV_V29P67 ||
-         _fs == LIQUID_FEC_CONV_V29P78 ||
-         _fs == LIQUID_FEC_RS_M8)
-    {
-        AUTOTEST_WARN("convolutional, Reed-Solomon codes unavailable (install libfec)\n");
-        return;
-    }
-#endif
-
     // generate fec object
     fec q = fec_create(_fs,_opts);
 
@@ -100,6 +76,50 @@ void fec_test_soft_codec(fec_scheme _fs,
     fec_destroy(q);
 }
 
+// Test soft-decoding of a long message with bounded noise on every soft
+// bit (helper function to keep code base small)
+//  _fs     :   coding scheme
+//  _n      :   message length (bytes)
+//  _amp    :   peak noise amplitude on soft bits
+void fec_test_soft_codec_noise(fec_scheme   _fs,
+                               unsigned int _n,
+                               unsigned int _amp)
+{
+    // generate fec object
+    fec q = fec_create(_fs,NULL);
+
+    // create arrays
+    unsigned int n_enc = fec_get_enc_msg_length(_fs,_n);
+    unsigned char msg[_n];              // original message
+    unsigned char msg_enc[n_enc];       // encoded message
+    unsigned char msg_soft[8*n_enc];    // encoded message (soft bits)
+    unsigned char msg_dec[_n];          // decoded message
+
+    // initialize message
+    unsigned int i;
+    for (i=0; i<_n; i++)
+        msg[i] = rand() & 0xff;
+
+    // encode message
+    fec_encode(q, _n, msg, msg_enc);
+
+    // convert to soft bits and add uniform noise
+    for (i=0; i<8*n_enc; i++) {
+        int v = ((msg_enc[i/8] >> (7-(i%8))) & 1) ? 255 : 0;
+        v += (int)(rand() % (2*_amp+1)) - (int)_amp;
+        msg_soft[i] = v < 0 ? 0 : (v > 255 ? 255 : v);
+    }
+
+    // decode message
+    fec_decode_soft(q, _n, msg_soft, msg_dec);
+
+    // validate output
+    CONTEND_SAME_DATA(msg,msg_dec,_n);
+
+    // clean up objects
+    fec_destroy(q);
+}
+
 // 
 // AUTOTESTS: basic encode/decode functionality
 //
@@ -134,7 +154,27 @@ void autotest_fecsoft_v29p56() { fec_test_soft_codec(LIQUID_FEC_CONV_V29P56, 64,
 void autotest_fecsoft_v29p67() { fec_test_soft_codec(LIQUID_FEC_CONV_V29P67, 64, NULL); }
 void autotest_fecsoft_v29p78() { fec_test_soft_codec(LIQUID_FEC_CONV_V29P78, 64, NULL); }
 
+// convolutional codes, long noisy messages
+void autotest_fecsoft_v27_noise()    { fec_test_soft_codec_noise(LIQUID_FEC_CONV_V27,    1024, 140); }
+void autotest_fecsoft_v29_noise()    { fec_test_soft_codec_noise(LIQUID_FEC_CONV_V29,    1024, 150); }
+void autotest_fecsoft_v39_noise()    { fec_test_soft_codec_noise(LIQUID_FEC_CONV_V39,    1024, 160); }
+void autotest_fecsoft_v615_noise()   { fec_test_soft_codec_noise(LIQUID_FEC_CONV_V615,    256, 200); }
+void autotest_fecsoft_v27p34_noise() { fec_test_soft_codec_noise(LIQUID_FEC_CONV_V27P34, 1024, 120); }
+void autotest_fecsoft_v29p78_noise() { fec_test_soft_codec_noise(LIQUID_FEC_CONV_V29P78, 1024, 120); }
+
 // Reed-Solomon block codes
 void autotest_fecsoft_rs8()    { fec_test_soft_codec(LIQUID_FEC_RS_M8,       64, NULL); }
 
+// quasi-cyclic LDPC codes
+void autotest_fecsoft_ldpc12() { fec_test_soft_codec(LIQUID_FEC_LDPC_R12,    64, NULL); }
+void autotest_fecsoft_ldpc34() { fec_test_soft_codec(LIQUID_FEC_LDPC_R34,    64, NULL); }
+void autotest_fecsoft_ldpc12_noise() { fec_test_soft_codec_noise(LIQUID_FEC_LDPC_R12, 1024, 150); }
+void autotest_fecsoft_ldpc34_noise() { fec_test_soft_codec_noise(LIQUID_FEC_LDPC_R34, 1024, 130); }
+
+// CRC-aided polar codes
+void autotest_fecsoft_polar12() { fec_test_soft_codec(LIQUID_FEC_POLAR_R12,  64, NULL); }
+void autotest_fecsoft_polar34() { fec_test_soft_codec(LIQUID_FEC_POLAR_R34,  64, NULL); }
+void autotest_fecsoft_polar12_noise() { fec_test_soft_codec_noise(LIQUID_FEC_POLAR_R12, 1024, 160); }
+void autotest_fecsoft_polar34_noise() { fec_test_soft_codec_noise(LIQUID_FEC_POLAR_R34, 1024, 130); }
+
 
@@ -85,3 +85,80 @@ void autotest_interleaver_soft_16()     { interleaver_test_soft(16  ); }
 void autotest_interleaver_soft_64()     { interleaver_test_soft(64  ); }
 void autotest_interleaver_soft_256()    { interleaver_test_soft(256 ); }
 
+
+// 
+// AUTOTESTS: soft bit interleaver matches hard interleaver, for every
+// depth and also when operating in place
+//
+void interleaver_test_hard_soft(unsigned int _n)
+{
+    unsigned int i;
+    unsigned int depth;
+    unsigned char x[_n];
+    unsigned char y[_n];
+    unsigned char y_soft[8*_n];
+
+    for (i=0; i<_n; i++)
+        x[i] = rand() & 0xFF;
+
+    // create interleaver object
+    interleaver q = interleaver_create(_n);
+
+    for (depth=0; depth<=4; depth++) {
+        interleaver_set_depth(q, depth);
+
+        // hard interleaver
+        interleaver_encode(q,x,y);
+
+        // soft interleaver, in place
+        for (i=0; i<8*_n; i++)
+            y_soft[i] = ((x[i/8] >> (7-(i%8))) & 1) ? 255 : 0;
+        interleaver_encode_soft(q,y_soft,y_soft);
+        for (i=0; i<8*_n; i++)
+            CONTEND_EQUALITY(y_soft[i], ((y[i/8] >> (7-(i%8))) & 1) ? 255 : 0);
+
+        // hard de-interleaver, in place
+        interleaver_decode(q,y,y);
+        CONTEND_SAME_DATA(x, y, _n);
+    }
+
+    // destroy interleaver object
+    interleaver_destroy(q);
+}
+
+void autotest_interleaver_hard_soft_13()    { interleaver_test_hard_soft(13  ); }
+void autotest_interleaver_hard_soft_64()    { interleaver_test_hard_soft(64  ); }
+void autotest_interleaver_hard_soft_255()   { interleaver_test_hard_soft(255 ); }
+
+
+// changing length in place must give the same permutation as an
+// interleaver created with that length
+void autotest_interleaver_set_length()
+{
+    unsigned int lengths[6] = {64, 13, 255, 1, 100, 255};
+    unsigned char x[255];
+    unsigned char y[255];
+    unsigned char y_ref[255];
+    unsigned int i;
+    unsigned int t;
+
+    interleaver q = interleaver_create(lengths[0]);
+    for (t=0; t<6; t++) {
+        unsigned int n = lengths[t];
+        interleaver_set_length(q, n);
+        CONTEND_EQUALITY(interleaver_get_length(q), n);
+
+        for (i=0; i<n; i++)
+            x[i] = rand() & 0xff;
+
+        interleaver q_ref = interleaver_create(n);
+        interleaver_encode(q,     x, y);
+        interleaver_encode(q_ref, x, y_ref);
+        CONTEND_SAME_DATA(y, y_ref, n);
+
+        interleaver_decode(q, y, y);
+        CONTEND_SAME_DATA(x, y, n);
+        interleaver_destroy(q_ref);
+    }
+    interleaver_destroy(q);
+}
@@ -20,6 +20,9 @@
  * THE SOFTWARE.
  */
 
+#include <stdlib.h>
+#include <string.h>
+
 #include "autotest/autotest.h"
 #include "liquid.h"
 
@@ -64,4 +67,186 @@ void packetizer_test_codec(unsigned int _n,
 void autotest_packetizer_n16_0_0()  { packetizer_test_codec(16, LIQUID_CRC_32, LIQUID_FEC_NONE, LIQUID_FEC_NONE);       }
 void autotest_packetizer_n16_0_1()  { packetizer_test_codec(16, LIQUID_CRC_32, LIQUID_FEC_NONE, LIQUID_FEC_REP3);       }
 void autotest_packetizer_n16_0_2()  { packetizer_test_codec(16, LIQUID_CRC_32, LIQUID_FEC_NONE, LIQUID_FEC_HAMMING74);  }
+void autotest_packetizer_n16_0_3()  { packetizer_test_codec(16, LIQUID_CRC_32, LIQUID_FEC_NONE, LIQUID_FEC_POLAR_R12);  }
+
+
+// Help function: long uncoded packet spanning several check blocks; the
+// packet must be the whitened message with its key appended, and any
+// corrupted byte must fail the check
+void packetizer_test_check(unsigned int _n,
+                           crc_scheme   _crc)
+{
+    unsigned int crc_len = crc_get_length(_crc);
+    unsigned char msg_tx[_n];
+    unsigned char msg_rx[_n];
+    unsigned char packet[_n + crc_len];
+    unsigned char expected[_n + crc_len];
+
+    packetizer p = packetizer_create(_n,_crc,LIQUID_FEC_NONE,LIQUID_FEC_NONE);
+    CONTEND_EQUALITY(packetizer_get_enc_msg_len(p), _n + crc_len);
+
+    unsigned int i;
+    for (i=0; i<_n; i++)
+        msg_tx[i] = (7*i + 3) & 0xff;
+
+    // encoded packet
+    packetizer_encode(p, msg_tx, packet);
+    memmove(expected, msg_tx, _n);
+    crc_append_key(_crc, expected, _n);
+    scramble_data(expected, _n + crc_len);
+    CONTEND_SAME_DATA(packet, expected, _n + crc_len);
+
+    // decode
+    CONTEND_EQUALITY(packetizer_decode(p, packet, msg_rx), 1);
+    CONTEND_SAME_DATA(msg_tx, msg_rx, _n);
+
+    // corrupt a byte in the last block, then a byte of the key
+    packet[_n-1] ^= 0x10;
+    CONTEND_EQUALITY(packetizer_decode(p, packet, msg_rx), 0);
+    packet[_n-1] ^= 0x10;
+    packet[_n] ^= 0x01;
+    CONTEND_EQUALITY(packetizer_decode(p, packet, msg_rx), 0);
+
+    packetizer_destroy(p);
+}
+
+void autotest_packetizer_check_crc8()   { packetizer_test_check(517,  LIQUID_CRC_8);  }
+void autotest_packetizer_check_crc16()  { packetizer_test_check(1000, LIQUID_CRC_16); }
+void autotest_packetizer_check_crc24()  { packetizer_test_check(1001, LIQUID_CRC_24); }
+void autotest_packetizer_check_crc32()  { packetizer_test_check(1023, LIQUID_CRC_32); }
 
+// Help function: batch encoding/decoding must match packet-by-packet
+// processing exactly (including the output of packets which fail the
+// check) and report the validity of each packet
+void packetizer_test_batch(unsigned int _n,
+                           crc_scheme   _crc,
+                           fec_scheme   _fec0,
+                           fec_scheme   _fec1,
+                           unsigned int _num_threads)
+{
+    unsigned int num_packets = 37;
+    unsigned int i;
+    unsigned int j;
+
+    packetizer p0 = packetizer_create(_n,_crc,_fec0,_fec1);   // batch
+    packetizer p1 = packetizer_create(_n,_crc,_fec0,_fec1);   // reference
+    packetizer_set_num_threads(p0, _num_threads);
+    unsigned int k = packetizer_get_enc_msg_len(p0);
+
+    unsigned char * msg_tx  = (unsigned char*) malloc(num_packets*_n*sizeof(unsigned char));
+    unsigned char * msg_rx  = (unsigned char*) malloc(num_packets*_n*sizeof(unsigned char));
+    unsigned char * msg_ref = (unsigned char*) malloc(_n*sizeof(unsigned char));
+    unsigned char * pkt     = (unsigned char*) malloc(num_packets*k*sizeof(unsigned char));
+    unsigned char * pkt_ref = (unsigned char*) malloc(k*sizeof(unsigned char));
+    unsigned char * soft    = (unsigned char*) malloc(8*num_packets*k*sizeof(unsigned char));
+    int valid[num_packets];
+    for (i=0; i<num_packets*_n; i++)
+        msg_tx[i] = (13*i + 5*(i/_n) + 1) & 0xff;
+
+    // encode
+    packetizer_encode_batch(p0, num_packets, msg_tx, pkt);
+    for (j=0; j<num_packets; j++) {
+        packetizer_encode(p1, &msg_tx[j*_n], pkt_ref);
+        CONTEND_SAME_DATA(&pkt[j*k], pkt_ref, k);
+    }
+
+    // corrupt every fifth packet beyond repair
+    unsigned int num_valid = 0;
+    for (j=0; j<num_packets; j++) {
+        if ((j % 5) == 2) {
+            for (i=0; i<k; i++)
+                pkt[j*k+i] ^= (37*i + 11) & 0xff;
+        } else {
+            num_valid++;
+        }
+    }
+
+    // hard-decision decoding
+    for (j=0; j<num_packets; j++)
+        valid[j] = -1;
+    CONTEND_EQUALITY(packetizer_decode_batch(p0, num_packets, pkt, msg_rx, valid), num_valid);
+    for (j=0; j<num_packets; j++) {
+        int valid_ref = packetizer_decode(p1, &pkt[j*k], msg_ref);
+        CONTEND_EQUALITY(valid[j], valid_ref);
+        CONTEND_EQUALITY(valid[j], (j % 5) == 2 ? 0 : 1);
+        CONTEND_SAME_DATA(&msg_rx[j*_n], msg_ref, _n);
+    }
+
+    // soft-decision decoding
+    for (i=0; i<num_packets*k; i++) {
+        for (j=0; j<8; j++)
+            soft[8*i+j] = (pkt[i] >> (7-j)) & 1 ? LIQUID_SOFTBIT_1 : LIQUID_SOFTBIT_0;
+    }
+    for (j=0; j<num_packets; j++)
+        valid[j] = -1;
+    CONTEND_EQUALITY(packetizer_decode_soft_batch(p0, num_packets, soft, msg_rx, valid), num_valid);
+    for (j=0; j<num_packets; j++) {
+        int valid_ref = packetizer_decode_soft(p1, &soft[8*j*k], msg_ref);
+        CONTEND_EQUALITY(valid[j], valid_ref);
+        CONTEND_EQUALITY(valid[j], (j % 5) == 2 ? 0 : 1);
+        CONTEND_SAME_DATA(&msg_rx[j*_n], msg_ref, _n);
+    }
+
+    packetizer_destroy(p0);
+    packetizer_destroy(p1);
+    free(msg_tx);
+    free(msg_rx);
+    free(msg_ref);
+    free(pkt);
+    free(pkt_ref);
+    free(soft);
+}
+
+void autotest_packetizer_batch_none()   { packetizer_test_batch(16,   LIQUID_CRC_32, LIQUID_FEC_NONE,       LIQUID_FEC_NONE,      1); }
+void autotest_packetizer_batch_h128()   { packetizer_test_batch(100,  LIQUID_CRC_32, LIQUID_FEC_HAMMING128, LIQUID_FEC_HAMMING84, 1); }
+void autotest_packetizer_batch_golay()  { packetizer_test_batch(57,   LIQUID_CRC_16, LIQUID_FEC_GOLAY2412,  LIQUID_FEC_REP3,      3); }
+void autotest_packetizer_batch_secded() { packetizer_test_batch(700,  LIQUID_CRC_32, LIQUID_FEC_SECDED7264, LIQUID_FEC_HAMMING74, 4); }
+void autotest_packetizer_batch_rs8()    { packetizer_test_batch(1000, LIQUID_CRC_24, LIQUID_FEC_NONE,       LIQUID_FEC_RS_M8,     2); }
+void autotest_packetizer_batch_polar()  { packetizer_test_batch(200,  LIQUID_CRC_32, LIQUID_FEC_POLAR_R34,  LIQUID_FEC_NONE,      2); }
+
+// re-create packetizer with varying lengths and schemes after reserving
+// memory; object must be reconfigured in place and match a packetizer
+// created for each configuration
+void autotest_packetizer_reserve()
+{
+    unsigned int n_max = 300;
+    fec_scheme fec0[4] = {LIQUID_FEC_CONV_V27,  LIQUID_FEC_NONE,      LIQUID_FEC_POLAR_R12, LIQUID_FEC_HAMMING128};
+    fec_scheme fec1[4] = {LIQUID_FEC_RS_M8,     LIQUID_FEC_REP3,      LIQUID_FEC_NONE,      LIQUID_FEC_CONV_V29P23};
+
+    packetizer p = packetizer_create(n_max, LIQUID_CRC_32, fec0[0], fec1[0]);
+    packetizer_reserve(p, n_max, fec0, 4);
+    packetizer_reserve(p, n_max, fec1, 4);
+
+    unsigned char msg_tx [n_max];
+    unsigned char msg_rx [n_max];
+    unsigned char pkt    [8*n_max];
+    unsigned char pkt_ref[8*n_max];
+    unsigned int i;
+    unsigned int t;
+    for (t=0; t<40; t++) {
+        unsigned int n = 1 + (37*t + 11) % n_max;
+        unsigned int s = (t/3) % 4;
+        crc_scheme crc = (t % 2) ? LIQUID_CRC_16 : LIQUID_CRC_32;
+
+        packetizer q = packetizer_recreate(p, n, crc, fec0[s], fec1[s]);
+        CONTEND_EQUALITY(q == p, 1);
+        CONTEND_EQUALITY(packetizer_get_dec_msg_len(p), n);
+
+        // compare against new object
+        packetizer p_ref = packetizer_create(n, crc, fec0[s], fec1[s]);
+        unsigned int k = packetizer_get_enc_msg_len(p_ref);
+        CONTEND_EQUALITY(packetizer_get_enc_msg_len(p), k);
+
+        for (i=0; i<n; i++)
+            msg_tx[i] = rand() & 0xff;
+        packetizer_encode(p,     msg_tx, pkt);
+        packetizer_encode(p_ref, msg_tx, pkt_ref);
+        CONTEND_SAME_DATA(pkt, pkt_ref, k);
+
+        CONTEND_EQUALITY(packetizer_decode(p, pkt, msg_rx), 1);
+        CONTEND_SAME_DATA(msg_tx, msg_rx, n);
+        packetizer_destroy(p_ref);
+    }
+
+    packetizer_destroy(p);
+}
@@ -101,3 +101,45 @@ void benchmark_framesync64(
     framesync64_destroy(fs);
 }
 
+
+// Helper function to keep code base small
+//  _gate   :   enable energy gate on frame detector?
+void framesync64_idle_bench(struct rusage *     _start,
+                            struct rusage *     _finish,
+                            unsigned long int * _num_iterations,
+                            int                 _gate)
+{
+    *_num_iterations /= 128;
+    unsigned long int i;
+
+    // create framesync64 object
+    framesync64 fs = framesync64_create(NULL,NULL);
+    if (_gate)
+        framesync64_set_seek_gate(fs, 1e-3f, 3.0f);
+
+    // idle channel (noise only)
+    unsigned int buf_len = LIQUID_FRAME64_LEN;
+    float complex buf[buf_len];
+    for (i=0; i<buf_len; i++)
+        buf[i] = 0.1f*(randnf() + _Complex_I*randnf()) * M_SQRT1_2;
+
+    // 
+    // start trials
+    //
+    getrusage(RUSAGE_SELF, _start);
+    for (i=0; i<(*_num_iterations); i++) {
+        framesync64_execute(fs, buf, buf_len);
+    }
+    getrusage(RUSAGE_SELF, _finish);
+
+    framesync64_destroy(fs);
+}
+
+#define FRAMESYNC64_IDLE_BENCH_API(GATE)        \
+(   struct rusage *_start,                      \
+    struct rusage *_finish,                     \
+    unsigned long int *_num_iterations)         \
+{ framesync64_idle_bench(_start, _finish, _num_iterations, GATE); }
+
+void benchmark_framesync64_idle         FRAMESYNC64_IDLE_BENCH_API(0);
+void benchmark_framesync64_idle_gate    FRAMESYNC64_IDLE_BENCH_API(1);
@@ -43,8 +43,41 @@
 #define FLEXFRAMESYNC_ENABLE_EQ     0
 
 // push samples through detection stage
-void flexframesync_execute_seekpn(flexframesync _q,
-                                  float complex _x);
+unsigned int flexframesync_execute_seekpn(flexframesync   _q,
+                                          float complex * _x,
+                                          unsigned int    _n);
+
+// receive frame samples until frame is complete
+//  _q      :   frame synchronizer object
+//  _x      :   input samples [size: _n x 1]
+//  _n      :   number of input samples
+//  returns number of samples consumed
+unsigned int flexframesync_execute_frame(flexframesync   _q,
+                                         float complex * _x,
+                                         unsigned int    _n);
+
+// detector bank receiver: configure synchronizer upon detection and
+// receive frame from aligned and subsequent samples until complete
+int flexframesync_qdetectorbank_receiver(float complex *             _x,
+                                         unsigned int                _n,
+                                         qdetectorbank_detection_s * _detection,
+                                         void *                      _userdata);
+
+// configure receiver from detection estimates and run aligned samples
+//  _q      :   frame synchronizer object
+//  _x      :   aligned samples, starting at preamble [size: _n x 1]
+//  _n      :   number of samples
+//  _tau    :   fractional timing offset estimate
+//  _gamma  :   channel gain estimate
+//  _dphi   :   carrier frequency offset estimate
+//  _phi    :   carrier phase offset estimate
+void flexframesync_acquire(flexframesync   _q,
+                           float complex * _x,
+                           unsigned int    _n,
+                           float           _tau,
+                           float           _gamma,
+                           float           _dphi,
+                           float           _phi);
 
 // step receiver mixer, matched filter, decimator
 //  _q      :   frame synchronizer
@@ -69,6 +102,9 @@ void flexframesync_execute_rxheader(flexframesync _q,
 void flexframesync_execute_rxpayload(flexframesync _q,
                                      float complex _x);
 
+// submit frame to asynchronous payload decoder queue
+void flexframesync_submit(flexframesync _q);
+
 static flexframegenprops_s flexframesyncprops_header_default = {
    FLEXFRAME_H_CRC,
    FLEXFRAME_H_FEC0,
@@ -128,11 +164,14 @@ struct flexframesync_s {
     modem           payload_demod;      // payload demod (for phase recovery only)
     float complex * payload_sym;        // payload symbols (received)
     unsigned int    payload_sym_len;    // payload symbols (length)
+    unsigned int    payload_sym_cap;    // payload symbols (allocated length)
     qpacketmodem    payload_decoder;    // payload demodulator/decoder
     unsigned char * payload_dec;        // payload data (bytes)
     unsigned int    payload_dec_len;    // payload data (length)
+    unsigned int    payload_dec_cap;    // payload data (allocated length)
     int             payload_valid;      // payload CRC flag
-    
+    framedecq       decq;               // asynchronous payload decoder queue
+
     // status variables
     unsigned int    preamble_counter;   // counter: num of p/n syms received
     unsigned int    symbol_counter;     // counter: num of symbols received
@@ -222,9 +261,12 @@ flexframesync flexframesync_create(framesync_callback _callback,
     q->payload_sym_len = qpacketmodem_get_frame_len(q->payload_decoder);
 
     // allocate memory for payload symbols and recovered data bytes
-    q->payload_sym = (float complex*) malloc(q->payload_sym_len*sizeof(float complex));
-    q->payload_dec = (unsigned char*) malloc(q->payload_dec_len*sizeof(unsigned char));
+    q->payload_sym_cap = q->payload_sym_len;
+    q->payload_dec_cap = q->payload_dec_len;
+    q->payload_sym = (float complex*) malloc(q->payload_sym_cap*sizeof(float complex));
+    q->payload_dec = (unsigned char*) malloc(q->payload_dec_cap*sizeof(unsigned char));
     q->payload_soft = 0;
+    q->decq = NULL;
 
     // reset global data counters
     flexframesync_reset_framedatastats(q);
@@ -265,6 +307,8 @@ void flexframesync_destroy(flexframesync _q)
     qpacketmodem_destroy  (_q->header_decoder);   // header demodulator/decoder
     modem_destroy         (_q->payload_demod);    // payload demodulator (for PLL)
     qpacketmodem_destroy  (_q->payload_decoder);  // payload demodulator/decoder
+    if (_q->decq != NULL)
+        framedecq_destroy (_q->decq);             // payload decoder queue
     qdetector_cccf_destroy(_q->detector);         // frame detector
     firpfb_crcf_destroy   (_q->mf);               // matched filter
     nco_crcf_destroy      (_q->mixer);            // oscillator (coarse)
@@ -282,6 +326,10 @@ void flexframesync_print(flexframesync _q)
 {
     printf("flexframesync:\n");
     framedatastats_print(&_q->framedatastats);
+    if (_q->decq != NULL) {
+        framedecqstats_s stats = framedecq_get_stats(_q->decq);
+        framedecqstats_print(&stats);
+    }
 }
 
 // reset frame synchronizer object
@@ -351,6 +399,53 @@ void flexframesync_decode_payload_soft(flexframesync _q,
     _q->payload_soft = _soft;
 }
 
+// pre-allocate memory for payloads of up to _max_payload_len bytes with
+// any error-detection scheme, the current and listed error-correction
+// schemes, and the current modulation scheme
+void flexframesync_reserve(flexframesync      _q,
+                           unsigned int       _max_payload_len,
+                           const fec_scheme * _fec,
+                           unsigned int       _num_fec)
+{
+    // payload demodulator/decoder
+    qpacketmodem_reserve(_q->payload_decoder, _max_payload_len, _fec, _num_fec);
+
+    // payload buffers
+    unsigned int sym_len = qpacketmodem_get_max_frame_len(_q->payload_decoder);
+    if (sym_len > _q->payload_sym_cap) {
+        _q->payload_sym_cap = sym_len;
+        _q->payload_sym = (float complex*) realloc(_q->payload_sym, (_q->payload_sym_cap)*sizeof(float complex));
+    }
+    if (_max_payload_len > _q->payload_dec_cap) {
+        _q->payload_dec_cap = _max_payload_len;
+        _q->payload_dec = (unsigned char*) realloc(_q->payload_dec, (_q->payload_dec_cap)*sizeof(unsigned char));
+    }
+}
+
+// enable or disable asynchronous decoding of payload
+void flexframesync_decode_payload_async(flexframesync _q,
+                                        unsigned int  _num_workers)
+{
+    // deliver pending frames and destroy existing queue
+    if (_q->decq != NULL) {
+        framedecq_deliver(_q->decq, 1, 0);
+        framedecq_destroy(_q->decq);
+        _q->decq = NULL;
+    }
+
+    if (_num_workers > 0)
+        _q->decq = framedecq_create(_num_workers, 4*_num_workers,
+                                    _q->callback, _q->userdata,
+                                    &_q->framedatastats);
+}
+
+// wait for pending frames to be decoded and invoke their callbacks
+void flexframesync_flush(flexframesync _q)
+{
+    if (_q->decq != NULL)
+        framedecq_deliver(_q->decq, 1, 0);
+}
+
 int flexframesync_set_header_props(flexframesync          _q,
                                    flexframegenprops_s * _props)
 {
@@ -379,6 +474,36 @@ int flexframesync_set_header_props(flexframesync          _q,
     return 0;
 }
 
+// set energy gate of frame detector to skip correlation on idle channel
+//  _q          :   frame synchronizer object
+//  _pmiss      :   bound on probability of missing preamble at _snr_min (0: disable)
+//  _snr_min    :   minimum signal-to-noise ratio of preamble [dB]
+void flexframesync_set_seek_gate(flexframesync _q,
+                                 float         _pmiss,
+                                 float         _snr_min)
+{
+    qdetector_cccf_set_gate(_q->detector, _pmiss, _snr_min);
+}
+
+// get number of windows rejected by energy gate while seeking preamble
+unsigned int flexframesync_get_seek_num_gated(flexframesync _q)
+{
+    return qdetector_cccf_get_num_gated(_q->detector);
+}
+
+// attach frame synchronizer to detector bank as receiver; synchronizers
+// with the same preamble share a single correlation in the bank
+//  _q      :   frame synchronizer object
+//  _bank   :   detector bank
+void flexframesync_attach_qdetectorbank(flexframesync      _q,
+                                        qdetectorbank_cccf _bank)
+{
+    unsigned int id = qdetectorbank_cccf_add_template(_bank,
+                        (float complex*) qdetector_cccf_get_sequence(_q->detector),
+                        qdetector_cccf_get_seq_len(_q->detector));
+    qdetectorbank_cccf_add_receiver(_bank, id, flexframesync_qdetectorbank_receiver, (void*)_q);
+}
+
 // execute frame synchronizer
 //  _q  :   frame synchronizer object
 //  _x  :   input sample array [size: _n x 1]
@@ -387,19 +512,75 @@ void flexframesync_execute(flexframesync   _q,
                            float complex * _x,
                            unsigned int    _n)
 {
-    unsigned int i;
-    for (i=0; i<_n; i++) {
+    unsigned int i = 0;
+    while (i < _n) {
+        unsigned int num_read;
+        if (_q->state == FLEXFRAMESYNC_STATE_DETECTFRAME) {
+            // detect frame (look for p/n sequence), consuming block of samples
+            num_read = flexframesync_execute_seekpn(_q, &_x[i], _n - i);
+        } else {
+            // receive frame until complete
+            num_read = flexframesync_execute_frame(_q, &_x[i], _n - i);
+        }
 #if DEBUG_FLEXFRAMESYNC
         // write samples to debug buffer
         // NOTE: the debug_qdetector_flush prevents samples from being written twice
-        if (_q->debug_enabled && !_q->debug_qdetector_flush)
-            windowcf_push(_q->debug_x, _x[i]);
+        if (_q->debug_enabled && !_q->debug_qdetector_flush) {
+            unsigned int j;
+            for (j=0; j<num_read; j++)
+                windowcf_push(_q->debug_x, _x[i+j]);
+        }
 #endif
+        i += num_read;
+    }
+
+    // deliver frames which have finished decoding
+    if (_q->decq != NULL)
+        framedecq_deliver(_q->decq, 0, 0);
+}
+
+// 
+// internal methods
+//
+
+// execute synchronizer, seeking p/n sequence
+//  _q      :   frame synchronizer object
+//  _x      :   input samples [size: _n x 1]
+//  _n      :   number of input samples
+//  returns number of samples consumed
+unsigned int flexframesync_execute_seekpn(flexframesync   _q,
+                                          float complex * _x,
+                                          unsigned int    _n)
+{
+    // push block through pre-demod synchronizer, stopping at detection
+    unsigned int num_read = 0;
+    float complex * v = qdetector_cccf_execute_block(_q->detector, _x, _n, &num_read);
+
+    // check if frame has been detected
+    if (v == NULL)
+        return num_read;
+
+    // configure receiver from estimates and run buffered samples
+    flexframesync_acquire(_q, v, qdetector_cccf_get_buf_len(_q->detector),
+                          qdetector_cccf_get_tau  (_q->detector),
+                          qdetector_cccf_get_gamma(_q->detector),
+                          qdetector_cccf_get_dphi (_q->detector),
+                          qdetector_cccf_get_phi  (_q->detector));
+    return num_read;
+}
+
+// receive frame samples until frame is complete
+//  _q      :   frame synchronizer object
+//  _x      :   input samples [size: _n x 1]
+//  _n      :   number of input samples
+//  returns number of samples consumed
+unsigned int flexframesync_execute_frame(flexframesync   _q,
+                                         float complex * _x,
+                                         unsigned int    _n)
+{
+    unsigned int i;
+    for (i=0; i<_n && _q->state != FLEXFRAMESYNC_STATE_DETECTFRAME; i++) {
         switch (_q->state) {
-        case FLEXFRAMESYNC_STATE_DETECTFRAME:
-            // detect frame (look for p/n sequence)
-            flexframesync_execute_seekpn(_q, _x[i]);
-            break;
         case FLEXFRAMESYNC_STATE_RXPREAMBLE:
             // receive p/n sequence symbols
             flexframesync_execute_rxpreamble(_q, _x[i]);
@@ -417,31 +598,56 @@ void flexframesync_execute(flexframesync   _q,
             exit(1);
         }
     }
+    return i;
 }
 
-// 
-// internal methods
-//
-
-// execute synchronizer, seeking p/n sequence
-//  _q      :   frame synchronizer object
-//  _x      :   input sample
-//  _sym    :   demodulated symbol
-void flexframesync_execute_seekpn(flexframesync _q,
-                                  float complex _x)
+// detector bank receiver: configure synchronizer upon detection and
+// receive frame from aligned and subsequent samples until complete
+int flexframesync_qdetectorbank_receiver(float complex *             _x,
+                                         unsigned int                _n,
+                                         qdetectorbank_detection_s * _detection,
+                                         void *                      _userdata)
 {
-    // push through pre-demod synchronizer
-    float complex * v = qdetector_cccf_execute(_q->detector, _x);
+    flexframesync q = (flexframesync) _userdata;
 
-    // check if frame has been detected
-    if (v == NULL)
-        return;
+    // configure synchronizer from estimates
+    if (_detection != NULL) {
+        flexframesync_acquire(q, _x, 0, _detection->tau, _detection->gamma,
+                              _detection->dphi, _detection->phi);
+    }
 
-    // get estimates
-    _q->tau_hat   = qdetector_cccf_get_tau  (_q->detector);
-    _q->gamma_hat = qdetector_cccf_get_gamma(_q->detector);
-    _q->dphi_hat  = qdetector_cccf_get_dphi (_q->detector);
-    _q->phi_hat   = qdetector_cccf_get_phi  (_q->detector);
+    // receive frame
+    flexframesync_execute_frame(q, _x, _n);
+
+    // deliver frames which have finished decoding
+    if (q->decq != NULL)
+        framedecq_deliver(q->decq, 0, 0);
+
+    // request further samples while frame is open
+    return q->state == FLEXFRAMESYNC_STATE_DETECTFRAME ? 0 : 1;
+}
+
+// configure receiver from detection estimates and run aligned samples
+//  _q      :   frame synchronizer object
+//  _x      :   aligned samples, starting at preamble [size: _n x 1]
+//  _n      :   number of samples
+//  _tau    :   fractional timing offset estimate
+//  _gamma  :   channel gain estimate
+//  _dphi   :   carrier frequency offset estimate
+//  _phi    :   carrier phase offset estimate
+void flexframesync_acquire(flexframesync   _q,
+                           float complex * _x,
+                           unsigned int    _n,
+                           float           _tau,
+                           float           _gamma,
+                           float           _dphi,
+                           float           _phi)
+{
+    // set estimates
+    _q->tau_hat   = _tau;
+    _q->gamma_hat = _gamma;
+    _q->dphi_hat  = _dphi;
+    _q->phi_hat   = _phi;
 
 #if DEBUG_FLEXFRAMESYNC_PRINT
     printf("***** frame detected! tau-hat:%8.4f, dphi-hat:%8.4f, gamma:%8.2f dB\n",
@@ -471,9 +677,8 @@ void flexframesync_execute_seekpn(flexframesync _q,
     // the debug_qdetector_flush prevents samples from being written twice
     _q->debug_qdetector_flush = 1;
 #endif
-    // run buffered samples through synchronizer
-    unsigned int buf_len = qdetector_cccf_get_buf_len(_q->detector);
-    flexframesync_execute(_q, v, buf_len);
+    // run aligned samples through synchronizer
+    flexframesync_execute(_q, _x, _n);
 #if DEBUG_FLEXFRAMESYNC
     _q->debug_qdetector_flush = 0;
 #endif
@@ -610,14 +815,19 @@ void flexframesync_execute_rxheader(flexframesync _q,
                 _q->framesyncstats.fec0          = LIQUID_FEC_UNKNOWN;
                 _q->framesyncstats.fec1          = LIQUID_FEC_UNKNOWN;
 
-                // invoke callback method
-                _q->callback(_q->header_dec,
-                             _q->header_valid,
-                             NULL,  // payload
-                             0,     // payload length
-                             0,     // payload valid,
-                             _q->framesyncstats,
-                             _q->userdata);
+                if (_q->decq != NULL) {
+                    // queue behind pending frames to preserve ordering
+                    flexframesync_submit(_q);
+                } else {
+                    // invoke callback method
+                    _q->callback(_q->header_dec,
+                                 _q->header_valid,
+                                 NULL,  // payload
+                                 0,     // payload length
+                                 0,     // payload valid,
+                                 _q->framesyncstats,
+                                 _q->userdata);
+                }
             }
 
             // reset frame synchronizer
@@ -709,9 +919,15 @@ void flexframesync_decode_header(flexframesync _q)
     // set length appropriately
     _q->payload_sym_len = qpacketmodem_get_frame_len(_q->payload_decoder);
 
-    // re-allocate buffers accordingly
-    _q->payload_sym = (float complex*) realloc(_q->payload_sym, (_q->payload_sym_len)*sizeof(float complex));
-    _q->payload_dec = (unsigned char*) realloc(_q->payload_dec, (_q->payload_dec_len)*sizeof(unsigned char));
+    // grow buffers if necessary (payload decoder is reconfigured in place)
+    if (_q->payload_sym_len > _q->payload_sym_cap) {
+        _q->payload_sym_cap = _q->payload_sym_len;
+        _q->payload_sym = (float complex*) realloc(_q->payload_sym, (_q->payload_sym_cap)*sizeof(float complex));
+    }
+    if (_q->payload_dec_len > _q->payload_dec_cap) {
+        _q->payload_dec_cap = _q->payload_dec_len;
+        _q->payload_dec = (unsigned char*) realloc(_q->payload_dec, (_q->payload_dec_cap)*sizeof(unsigned char));
+    }
 
     if (_q->payload_sym == NULL || _q->payload_dec == NULL) {
         fprintf(stderr,"error: flexframesync_decode_header(), could not re-allocate payload arrays\n");
@@ -769,7 +985,28 @@ void flexframesync_execute_rxpayload(flexframesync _q,
         // increment counter
         _q->symbol_counter++;
 
-        if (_q->symbol_counter == _q->payload_sym_len) {
+        if (_q->symbol_counter == _q->payload_sym_len &&
+            _q->decq != NULL)
+        {
+            // hand off payload to decoder queue
+            _q->framedatastats.num_frames_detected++;
+            _q->framedatastats.num_headers_valid++;
+
+            int ms = qpacketmodem_get_modscheme(_q->payload_decoder);
+            _q->framesyncstats.evm           = 10*log10f(_q->framesyncstats.evm / (float)_q->payload_sym_len);
+            _q->framesyncstats.rssi          = 20*log10f(_q->gamma_hat);
+            _q->framesyncstats.cfo           = nco_crcf_get_frequency(_q->mixer);
+            _q->framesyncstats.mod_scheme    = ms;
+            _q->framesyncstats.mod_bps       = modulation_types[ms].bps;
+            _q->framesyncstats.check         = qpacketmodem_get_crc(_q->payload_decoder);
+            _q->framesyncstats.fec0          = qpacketmodem_get_fec0(_q->payload_decoder);
+            _q->framesyncstats.fec1          = qpacketmodem_get_fec1(_q->payload_decoder);
+            flexframesync_submit(_q);
+
+            // reset frame synchronizer
+            flexframesync_reset(_q);
+            return;
+        } else if (_q->symbol_counter == _q->payload_sym_len) {
             // decode payload
             if (_q->payload_soft) {
                 _q->payload_valid = qpacketmodem_decode_soft(_q->payload_decoder,
@@ -819,6 +1056,39 @@ void flexframesync_execute_rxpayload(flexframesync _q,
     }
 }
 
+// submit frame to asynchronous payload decoder queue; the header and frame
+// statistics are taken from the object, and the payload symbols are copied
+// only if the header is valid
+void flexframesync_submit(flexframesync _q)
+{
+    framedecq_job_s * job = framedecq_get_slot(_q->decq);
+    framedecq_job_set_header(job, _q->header_dec, _q->header_dec_len, _q->header_valid);
+    job->stats = _q->framesyncstats;
+    if (_q->header_valid) {
+        job->decoder = FRAMEDECQ_DECODER_QPACKETMODEM;
+        job->soft    = _q->payload_soft;
+        job->dec_len = _q->payload_dec_len;
+        job->check   = qpacketmodem_get_crc      (_q->payload_decoder);
+        job->fec0    = qpacketmodem_get_fec0     (_q->payload_decoder);
+        job->fec1    = qpacketmodem_get_fec1     (_q->payload_decoder);
+        job->ms      = qpacketmodem_get_modscheme(_q->payload_decoder);
+        framedecq_job_set_syms(job, _q->payload_sym, _q->payload_sym_len);
+    }
+    framedecq_submit(_q->decq);
+}
+
+// retrieve asynchronous payload decoder statistics
+framedecqstats_s flexframesync_get_framedecqstats(flexframesync _q)
+{
+    framedecqstats_s stats;
+    if (_q->decq != NULL) {
+        stats = framedecq_get_stats(_q->decq);
+    } else {
+        memset(&stats, 0x00, sizeof(framedecqstats_s));
+    }
+    return stats;
+}
+
 // reset frame data statistics
 void flexframesync_reset_framedatastats(flexframesync _q)
 {
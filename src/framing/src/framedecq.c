@@ -0,0 +1,502 @@
+/*
+ * Copyright (c) 2007 - 2016 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+//
+// framedecq.c
+//
+// Frame payload decoder queue: off-loads payload decoding (demodulation,
+// de-interleaving, forward error-correction, validity check) of received
+// frames to a pool of worker threads while preserving frame order.
+//
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "liquid.internal.h"
+
+#if LIQUID_PTHREADS_ENABLED
+#   include <pthread.h>
+#endif
+
+// job states
+enum {
+    FRAMEDECQ_JOB_FREE=0,   // slot available
+    FRAMEDECQ_JOB_QUEUED,   // waiting for worker
+    FRAMEDECQ_JOB_BUSY,     // decoding in progress
+    FRAMEDECQ_JOB_DONE,     // decoded, waiting for delivery
+};
+
+// per-worker decoder objects
+struct framedecq_worker_s {
+    framedecq       q;          // parent object
+    packetizer      p;          // packet decoder
+    qpacketmodem    m;          // packet demodulator/decoder
+#if LIQUID_PTHREADS_ENABLED
+    pthread_t       thread;     // worker thread
+#endif
+};
+
+struct framedecq_s {
+    framesync_callback  callback;       // user-defined callback function
+    void *              userdata;       // user-defined data structure
+    framedatastats_s *  framedatastats; // frame data statistics (optional)
+
+    unsigned int        num_workers;    // number of worker threads
+    unsigned int        capacity;       // number of job slots
+    framedecq_job_s *   jobs;           // job slots (circular)
+    unsigned int        head;           // oldest job (next to be delivered)
+    unsigned int        num_pending;    // number of occupied slots
+    struct framedecq_worker_s * workers;
+
+    // statistics
+    unsigned int        max_pending;    // peak number of occupied slots
+    unsigned long int   num_decoded;    // number of jobs delivered
+    double              latency_sum;    // accumulated decoding latency [s]
+    double              latency_max;    // maximum decoding latency [s]
+    double              delivery_sum;   // accumulated submission-to-delivery time [s]
+    double              delivery_max;   // maximum submission-to-delivery time [s]
+
+#if LIQUID_PTHREADS_ENABLED
+    pthread_mutex_t     mutex;          // protects job states, counters
+    pthread_cond_t      cv_queued;      // signaled when job is queued
+    pthread_cond_t      cv_done;        // signaled when job is decoded
+    int                 shutdown;       // flag to terminate workers
+#endif
+};
+
+// get monotonic time stamp [s]
+static double framedecq_time()
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + 1e-9*(double)t.tv_nsec;
+}
+
+// run decoder on job, time-stamping start and end of decoding
+static void framedecq_decode(struct framedecq_worker_s * _w,
+                             framedecq_job_s *           _job)
+{
+    _job->t_start = framedecq_time();
+    switch (_job->decoder) {
+    case FRAMEDECQ_DECODER_NONE:
+        _job->valid = 0;
+        break;
+    case FRAMEDECQ_DECODER_PACKETIZER:
+        _w->p = packetizer_recreate(_w->p, _job->dec_len, _job->check, _job->fec0, _job->fec1);
+        _job->valid = _job->soft ? packetizer_decode_soft(_w->p, _job->enc, _job->dec)
+                                 : packetizer_decode     (_w->p, _job->enc, _job->dec);
+        break;
+    case FRAMEDECQ_DECODER_QPACKETMODEM:
+        qpacketmodem_configure(_w->m, _job->dec_len, _job->check, _job->fec0, _job->fec1, _job->ms);
+        _job->valid = _job->soft ? qpacketmodem_decode_soft(_w->m, _job->syms, _job->dec)
+                                 : qpacketmodem_decode     (_w->m, _job->syms, _job->dec);
+        break;
+    default:
+        fprintf(stderr,"error: framedecq_decode(), unknown/unsupported decoder\n");
+        exit(1);
+    }
+    _job->t_done = framedecq_time();
+}
+
+#if LIQUID_PTHREADS_ENABLED
+// worker thread: decode queued jobs in order of submission
+static void * framedecq_worker_run(void * _context)
+{
+    struct framedecq_worker_s * w = (struct framedecq_worker_s*) _context;
+    framedecq q = w->q;
+
+    pthread_mutex_lock(&q->mutex);
+    while (1) {
+        // find oldest queued job
+        framedecq_job_s * job = NULL;
+        unsigned int i;
+        for (i=0; i<q->num_pending; i++) {
+            framedecq_job_s * j = &q->jobs[(q->head + i) % q->capacity];
+            if (j->state == FRAMEDECQ_JOB_QUEUED) {
+                job = j;
+                break;
+            }
+        }
+
+        if (job == NULL) {
+            if (q->shutdown)
+                break;
+            pthread_cond_wait(&q->cv_queued, &q->mutex);
+            continue;
+        }
+
+        // decode outside of lock
+        job->state = FRAMEDECQ_JOB_BUSY;
+        pthread_mutex_unlock(&q->mutex);
+        framedecq_decode(w, job);
+        pthread_mutex_lock(&q->mutex);
+
+        job->state = FRAMEDECQ_JOB_DONE;
+        pthread_cond_broadcast(&q->cv_done);
+    }
+    pthread_mutex_unlock(&q->mutex);
+    return NULL;
+}
+#endif
+
+// create frame decoder queue
+//  _num_workers    :   number of worker threads, _num_workers > 0
+//  _capacity       :   maximum number of frames in flight, _capacity > 0
+//  _callback       :   callback invoked for each decoded frame
+//  _userdata       :   user-defined data object passed to callback
+//  _framedatastats :   payload statistics updated on delivery (can be NULL)
+framedecq framedecq_create(unsigned int       _num_workers,
+                           unsigned int       _capacity,
+                           framesync_callback _callback,
+                           void *             _userdata,
+                           framedatastats_s * _framedatastats)
+{
+    // validate input
+    if (_num_workers == 0) {
+        fprintf(stderr,"error: framedecq_create(), number of workers must be greater than zero\n");
+        exit(1);
+    } else if (_capacity == 0) {
+        fprintf(stderr,"error: framedecq_create(), capacity must be greater than zero\n");
+        exit(1);
+    }
+
+    framedecq q = (framedecq) malloc(sizeof(struct framedecq_s));
+    q->callback       = _callback;
+    q->userdata       = _userdata;
+    q->framedatastats = _framedatastats;
+#if LIQUID_PTHREADS_ENABLED
+    q->num_workers = _num_workers;
+#else
+    // no thread support: decode in calling thread upon submission
+    q->num_workers = 1;
+#endif
+    q->capacity    = _capacity;
+    q->jobs        = (framedecq_job_s*) calloc(q->capacity, sizeof(framedecq_job_s));
+    q->head        = 0;
+    q->num_pending = 0;
+
+    // create worker decoders
+    q->workers = (struct framedecq_worker_s*) malloc(q->num_workers*sizeof(struct framedecq_worker_s));
+    unsigned int i;
+    for (i=0; i<q->num_workers; i++) {
+        q->workers[i].q = q;
+        q->workers[i].p = packetizer_create(1, LIQUID_CRC_NONE, LIQUID_FEC_NONE, LIQUID_FEC_NONE);
+        q->workers[i].m = qpacketmodem_create();
+    }
+
+    framedecq_reset_stats(q);
+
+#if LIQUID_PTHREADS_ENABLED
+    pthread_mutex_init(&q->mutex,     NULL);
+    pthread_cond_init (&q->cv_queued, NULL);
+    pthread_cond_init (&q->cv_done,   NULL);
+    q->shutdown = 0;
+    for (i=0; i<q->num_workers; i++) {
+        if (pthread_create(&q->workers[i].thread, NULL, framedecq_worker_run, &q->workers[i]) != 0) {
+            fprintf(stderr,"error: framedecq_create(), could not create worker thread\n");
+            exit(1);
+        }
+    }
+#endif
+
+    return q;
+}
+
+// destroy frame decoder queue, discarding undelivered frames
+void framedecq_destroy(framedecq _q)
+{
+    unsigned int i;
+#if LIQUID_PTHREADS_ENABLED
+    // terminate workers once all queued jobs have been decoded
+    pthread_mutex_lock(&_q->mutex);
+    _q->shutdown = 1;
+    pthread_cond_broadcast(&_q->cv_queued);
+    pthread_mutex_unlock(&_q->mutex);
+    for (i=0; i<_q->num_workers; i++)
+        pthread_join(_q->workers[i].thread, NULL);
+
+    pthread_mutex_destroy(&_q->mutex);
+    pthread_cond_destroy (&_q->cv_queued);
+    pthread_cond_destroy (&_q->cv_done);
+#endif
+
+    // destroy worker decoders
+    for (i=0; i<_q->num_workers; i++) {
+        packetizer_destroy  (_q->workers[i].p);
+        qpacketmodem_destroy(_q->workers[i].m);
+    }
+    free(_q->workers);
+
+    // free job buffers
+    for (i=0; i<_q->capacity; i++) {
+        free(_q->jobs[i].header);
+        free(_q->jobs[i].syms);
+        free(_q->jobs[i].enc);
+        free(_q->jobs[i].dec);
+    }
+    free(_q->jobs);
+
+    free(_q);
+}
+
+// get free job slot at end of queue; if the queue is full this waits for
+// the oldest frame to be decoded and delivers it
+framedecq_job_s * framedecq_get_slot(framedecq _q)
+{
+    // only the calling thread modifies the number of pending jobs
+    while (_q->num_pending == _q->capacity)
+        framedecq_deliver(_q, 1, 1);
+
+    framedecq_job_s * job = &_q->jobs[(_q->head + _q->num_pending) % _q->capacity];
+    job->decoder = FRAMEDECQ_DECODER_NONE;
+    job->soft    = 0;
+    job->valid   = 0;
+    return job;
+}
+
+// copy header into job
+void framedecq_job_set_header(framedecq_job_s * _job,
+                              unsigned char *   _header,
+                              unsigned int      _header_len,
+                              int               _header_valid)
+{
+    if (_header_len > _job->header_cap) {
+        _job->header     = (unsigned char*) realloc(_job->header, _header_len*sizeof(unsigned char));
+        _job->header_cap = _header_len;
+    }
+    memmove(_job->header, _header, _header_len*sizeof(unsigned char));
+    _job->header_len   = _header_len;
+    _job->header_valid = _header_valid;
+}
+
+// copy received symbols into job
+void framedecq_job_set_syms(framedecq_job_s * _job,
+                            float complex *   _syms,
+                            unsigned int      _num_syms)
+{
+    if (_num_syms > _job->syms_cap) {
+        _job->syms     = (float complex*) realloc(_job->syms, _num_syms*sizeof(float complex));
+        _job->syms_cap = _num_syms;
+    }
+    memmove(_job->syms, _syms, _num_syms*sizeof(float complex));
+    _job->num_syms = _num_syms;
+}
+
+// copy encoded payload (packed bytes or soft bits) into job
+void framedecq_job_set_enc(framedecq_job_s * _job,
+                           unsigned char *   _enc,
+                           unsigned int      _enc_len)
+{
+    if (_enc_len > _job->enc_cap) {
+        _job->enc     = (unsigned char*) realloc(_job->enc, _enc_len*sizeof(unsigned char));
+        _job->enc_cap = _enc_len;
+    }
+    memmove(_job->enc, _enc, _enc_len*sizeof(unsigned char));
+    _job->enc_len = _enc_len;
+}
+
+// submit job at end of queue (previously retrieved from framedecq_get_slot)
+void framedecq_submit(framedecq _q)
+{
+    framedecq_job_s * job = &_q->jobs[(_q->head + _q->num_pending) % _q->capacity];
+
+    // allocate memory for decoded payload
+    if (job->decoder != FRAMEDECQ_DECODER_NONE && job->dec_len > job->dec_cap) {
+        job->dec     = (unsigned char*) realloc(job->dec, job->dec_len*sizeof(unsigned char));
+        job->dec_cap = job->dec_len;
+    }
+    job->t_submit = framedecq_time();
+    job->t_start  = job->t_submit;
+    job->t_done   = job->t_submit;
+
+#if LIQUID_PTHREADS_ENABLED
+    pthread_mutex_lock(&_q->mutex);
+    if (job->decoder == FRAMEDECQ_DECODER_NONE) {
+        job->state = FRAMEDECQ_JOB_DONE;
+    } else {
+        job->state = FRAMEDECQ_JOB_QUEUED;
+        pthread_cond_signal(&_q->cv_queued);
+    }
+    _q->num_pending++;
+    if (_q->num_pending > _q->max_pending)
+        _q->max_pending = _q->num_pending;
+    pthread_mutex_unlock(&_q->mutex);
+#else
+    framedecq_decode(&_q->workers[0], job);
+    job->state = FRAMEDECQ_JOB_DONE;
+    _q->num_pending++;
+    if (_q->num_pending > _q->max_pending)
+        _q->max_pending = _q->num_pending;
+#endif
+}
+
+// get oldest job if it has been decoded
+//  _q      :   frame decoder queue
+//  _block  :   wait for oldest job to finish decoding?
+// returns NULL if queue is empty, or if not blocking and oldest job is
+// still being decoded
+framedecq_job_s * framedecq_head(framedecq _q,
+                                 int       _block)
+{
+    framedecq_job_s * job = NULL;
+#if LIQUID_PTHREADS_ENABLED
+    pthread_mutex_lock(&_q->mutex);
+    while (_q->num_pending > 0) {
+        if (_q->jobs[_q->head].state == FRAMEDECQ_JOB_DONE) {
+            job = &_q->jobs[_q->head];
+            break;
+        } else if (!_block) {
+            break;
+        }
+        pthread_cond_wait(&_q->cv_done, &_q->mutex);
+    }
+    pthread_mutex_unlock(&_q->mutex);
+#else
+    if (_q->num_pending > 0)
+        job = &_q->jobs[_q->head];
+#endif
+    return job;
+}
+
+// deliver decoded frames in order of submission, invoking callback
+//  _q      :   frame decoder queue
+//  _block  :   wait for pending frames to finish decoding?
+//  _max    :   maximum number of frames to deliver (0: no limit)
+unsigned int framedecq_deliver(framedecq    _q,
+                               int          _block,
+                               unsigned int _max)
+{
+    unsigned int num_delivered = 0;
+    framedecq_job_s * job;
+    while ( (_max == 0 || num_delivered < _max) &&
+            (job = framedecq_head(_q, _block)) != NULL)
+    {
+        int decoded = job->decoder != FRAMEDECQ_DECODER_NONE;
+        if (decoded) {
+            // update statistics
+            if (_q->framedatastats != NULL) {
+                _q->framedatastats->num_payloads_valid += job->valid;
+                _q->framedatastats->num_bytes_received += job->dec_len;
+            }
+
+            job->stats.framesyms     = job->syms;
+            job->stats.num_framesyms = job->num_syms;
+        }
+
+        // invoke callback method
+        if (_q->callback != NULL) {
+            _q->callback(job->header,
+                         job->header_valid,
+                         decoded ? job->dec     : NULL,
+                         decoded ? job->dec_len : 0,
+                         job->valid,
+                         job->stats,
+                         _q->userdata);
+        }
+
+        // release job
+        framedecq_pop(_q);
+        num_delivered++;
+    }
+    return num_delivered;
+}
+
+// release oldest job (after its results have been delivered)
+void framedecq_pop(framedecq _q)
+{
+#if LIQUID_PTHREADS_ENABLED
+    pthread_mutex_lock(&_q->mutex);
+#endif
+    if (_q->num_pending > 0) {
+        framedecq_job_s * job = &_q->jobs[_q->head];
+
+        // update latency statistics: time spent decoding, and time from
+        // submission until delivery (includes queueing and polling)
+        double latency  = job->t_done - job->t_start;
+        double delivery = framedecq_time() - job->t_submit;
+        _q->latency_sum  += latency;
+        _q->delivery_sum += delivery;
+        if (latency > _q->latency_max)
+            _q->latency_max = latency;
+        if (delivery > _q->delivery_max)
+            _q->delivery_max = delivery;
+        _q->num_decoded++;
+
+        job->state = FRAMEDECQ_JOB_FREE;
+        _q->head = (_q->head + 1) % _q->capacity;
+        _q->num_pending--;
+    }
+#if LIQUID_PTHREADS_ENABLED
+    pthread_mutex_unlock(&_q->mutex);
+#endif
+}
+
+// reset statistics
+void framedecq_reset_stats(framedecq _q)
+{
+    _q->max_pending = 0;
+    _q->num_decoded = 0;
+    _q->latency_sum  = 0.0;
+    _q->latency_max  = 0.0;
+    _q->delivery_sum = 0.0;
+    _q->delivery_max = 0.0;
+}
+
+// get queue statistics
+framedecqstats_s framedecq_get_stats(framedecq _q)
+{
+    framedecqstats_s stats;
+#if LIQUID_PTHREADS_ENABLED
+    pthread_mutex_lock(&_q->mutex);
+#endif
+    stats.num_workers = _q->num_workers;
+    stats.capacity    = _q->capacity;
+    stats.num_pending = _q->num_pending;
+    stats.max_pending = _q->max_pending;
+    stats.num_decoded = _q->num_decoded;
+    stats.latency_avg = _q->num_decoded > 0 ? (float)(_q->latency_sum / (double)_q->num_decoded) : 0.0f;
+    stats.latency_max = (float)_q->latency_max;
+    stats.delivery_avg = _q->num_decoded > 0 ? (float)(_q->delivery_sum / (double)_q->num_decoded) : 0.0f;
+    stats.delivery_max = (float)_q->delivery_max;
+#if LIQUID_PTHREADS_ENABLED
+    pthread_mutex_unlock(&_q->mutex);
+#endif
+    return stats;
+}
+
+// print framedecqstats object
+void framedecqstats_print(framedecqstats_s * _stats)
+{
+    if (_stats == NULL)
+        return;
+
+    printf("  decoder workers   : %u\n", _stats->num_workers);
+    printf("  queue depth       : %u (peak %u, capacity %u)\n",
+            _stats->num_pending, _stats->max_pending, _stats->capacity);
+    printf("  frames decoded    : %lu\n", _stats->num_decoded);
+    printf("  decode latency    : %.3f ms (avg), %.3f ms (max)\n",
+            1e3f*_stats->latency_avg, 1e3f*_stats->latency_max);
+    printf("  delivery latency  : %.3f ms (avg), %.3f ms (max)\n",
+            1e3f*_stats->delivery_avg, 1e3f*_stats->delivery_max);
+}
@@ -43,8 +43,41 @@
 #define FRAMESYNC64_ENABLE_EQ       0
 
 // push samples through detection stage
-void framesync64_execute_seekpn(framesync64   _q,
-                                float complex _x);
+unsigned int framesync64_execute_seekpn(framesync64     _q,
+                                        float complex * _x,
+                                        unsigned int    _n);
+
+// receive frame samples until frame is complete
+//  _q      :   frame synchronizer object
+//  _x      :   input samples [size: _n x 1]
+//  _n      :   number of input samples
+//  returns number of samples consumed
+unsigned int framesync64_execute_frame(framesync64     _q,
+                                       float complex * _x,
+                                       unsigned int    _n);
+
+// detector bank receiver: configure synchronizer upon detection and
+// receive frame from aligned and subsequent samples until complete
+int framesync64_qdetectorbank_receiver(float complex *             _x,
+                                       unsigned int                _n,
+                                       qdetectorbank_detection_s * _detection,
+                                       void *                      _userdata);
+
+// configure receiver from detection estimates and run aligned samples
+//  _q      :   frame synchronizer object
+//  _x      :   aligned samples, starting at preamble [size: _n x 1]
+//  _n      :   number of samples
+//  _tau    :   fractional timing offset estimate
+//  _gamma  :   channel gain estimate
+//  _dphi   :   carrier frequency offset estimate
+//  _phi    :   carrier phase offset estimate
+void framesync64_acquire(framesync64     _q,
+                         float complex * _x,
+                         unsigned int    _n,
+                         float           _tau,
+                         float           _gamma,
+                         float           _dphi,
+                         float           _phi);
 
 // step receiver mixer, matched filter, decimator
 //  _q      :   frame synchronizer
@@ -234,6 +267,36 @@ void framesync64_reset(framesync64 _q)
     _q->framestats.evm = 0.0f;
 }
 
+// set energy gate of frame detector to skip correlation on idle channel
+//  _q          :   frame synchronizer object
+//  _pmiss      :   bound on probability of missing preamble at _snr_min (0: disable)
+//  _snr_min    :   minimum signal-to-noise ratio of preamble [dB]
+void framesync64_set_seek_gate(framesync64 _q,
+                               float       _pmiss,
+                               float       _snr_min)
+{
+    qdetector_cccf_set_gate(_q->detector, _pmiss, _snr_min);
+}
+
+// get number of windows rejected by energy gate while seeking preamble
+unsigned int framesync64_get_seek_num_gated(framesync64 _q)
+{
+    return qdetector_cccf_get_num_gated(_q->detector);
+}
+
+// attach frame synchronizer to detector bank as receiver; synchronizers
+// with the same preamble share a single correlation in the bank
+//  _q      :   frame synchronizer object
+//  _bank   :   detector bank
+void framesync64_attach_qdetectorbank(framesync64        _q,
+                                      qdetectorbank_cccf _bank)
+{
+    unsigned int id = qdetectorbank_cccf_add_template(_bank,
+                        (float complex*) qdetector_cccf_get_sequence(_q->detector),
+                        qdetector_cccf_get_seq_len(_q->detector));
+    qdetectorbank_cccf_add_receiver(_bank, id, framesync64_qdetectorbank_receiver, (void*)_q);
+}
+
 // execute frame synchronizer
 //  _q     :   frame synchronizer object
 //  _x      :   input sample array [size: _n x 1]
@@ -242,17 +305,69 @@ void framesync64_execute(framesync64     _q,
                          float complex * _x,
                          unsigned int    _n)
 {
-    unsigned int i;
-    for (i=0; i<_n; i++) {
+    unsigned int i = 0;
+    while (i < _n) {
+        unsigned int num_read;
+        if (_q->state == FRAMESYNC64_STATE_DETECTFRAME) {
+            // detect frame (look for p/n sequence), consuming block of samples
+            num_read = framesync64_execute_seekpn(_q, &_x[i], _n - i);
+        } else {
+            // receive frame until complete
+            num_read = framesync64_execute_frame(_q, &_x[i], _n - i);
+        }
 #if DEBUG_FRAMESYNC64
-        if (_q->debug_enabled)
-            windowcf_push(_q->debug_x, _x[i]);
+        if (_q->debug_enabled) {
+            unsigned int j;
+            for (j=0; j<num_read; j++)
+                windowcf_push(_q->debug_x, _x[i+j]);
+        }
 #endif
+        i += num_read;
+    }
+}
+
+// 
+// internal methods
+//
+
+// execute synchronizer, seeking p/n sequence
+//  _q      :   frame synchronizer object
+//  _x      :   input samples [size: _n x 1]
+//  _n      :   number of input samples
+//  returns number of samples consumed
+unsigned int framesync64_execute_seekpn(framesync64     _q,
+                                        float complex * _x,
+                                        unsigned int    _n)
+{
+    // push block through pre-demod synchronizer, stopping at detection
+    unsigned int num_read = 0;
+    float complex * v = qdetector_cccf_execute_block(_q->detector, _x, _n, &num_read);
+
+    // check if frame has been detected
+    if (v != NULL) {
+        // configure receiver from estimates and run buffered samples
+        framesync64_acquire(_q, v, qdetector_cccf_get_buf_len(_q->detector),
+                            qdetector_cccf_get_tau  (_q->detector),
+                            qdetector_cccf_get_gamma(_q->detector),
+                            qdetector_cccf_get_dphi (_q->detector),
+                            qdetector_cccf_get_phi  (_q->detector));
+    }
+
+    return num_read;
+}
+
+// receive frame samples until frame is complete
+//  _q      :   frame synchronizer object
+//  _x      :   input samples [size: _n x 1]
+//  _n      :   number of input samples
+//  returns number of samples consumed
+unsigned int framesync64_execute_frame(framesync64     _q,
+                                       float complex * _x,
+                                       unsigned int    _n)
+{
+    unsigned int i;
+    for (i=0; i<_n && _q->state != FRAMESYNC64_STATE_DETECTFRAME; i++) {
         switch (_q->state) {
-        case FRAMESYNC64_STATE_DETECTFRAME:
-            // detect frame (look for p/n sequence)
-            framesync64_execute_seekpn(_q, _x[i]);
-            break;
         case FRAMESYNC64_STATE_RXPREAMBLE:
             // receive p/n sequence symbols
             framesync64_execute_rxpreamble(_q, _x[i]);
@@ -266,58 +381,79 @@ void framesync64_execute(framesync64     _q,
             exit(1);
         }
     }
+    return i;
 }
 
-// 
-// internal methods
-//
-
-// execute synchronizer, seeking p/n sequence
-//  _q     :   frame synchronizer object
-//  _x      :   input sample
-//  _sym    :   demodulated symbol
-void framesync64_execute_seekpn(framesync64   _q,
-                                float complex _x)
+// detector bank receiver: configure synchronizer upon detection and
+// receive frame from aligned and subsequent samples until complete
+int framesync64_qdetectorbank_receiver(float complex *             _x,
+                                       unsigned int                _n,
+                                       qdetectorbank_detection_s * _detection,
+                                       void *                      _userdata)
 {
-    // push through pre-demod synchronizer
-    float complex * v = qdetector_cccf_execute(_q->detector, _x);
+    framesync64 q = (framesync64) _userdata;
 
-    // check if frame has been detected
-    if (v != NULL) {
-        // get estimates
-        _q->tau_hat   = qdetector_cccf_get_tau  (_q->detector);
-        _q->gamma_hat = qdetector_cccf_get_gamma(_q->detector);
-        _q->dphi_hat  = qdetector_cccf_get_dphi (_q->detector);
-        _q->phi_hat   = qdetector_cccf_get_phi  (_q->detector);
+    // configure synchronizer from estimates
+    if (_detection != NULL) {
+        framesync64_acquire(q, _x, 0, _detection->tau, _detection->gamma,
+                            _detection->dphi, _detection->phi);
+    }
+
+    // receive frame
+    framesync64_execute_frame(q, _x, _n);
+
+    // request further samples while frame is open
+    return q->state == FRAMESYNC64_STATE_DETECTFRAME ? 0 : 1;
+}
+
+// configure receiver from detection estimates and run aligned samples
+//  _q      :   frame synchronizer object
+//  _x      :   aligned samples, starting at preamble [size: _n x 1]
+//  _n      :   number of samples
+//  _tau    :   fractional timing offset estimate
+//  _gamma  :   channel gain estimate
+//  _dphi   :   carrier frequency offset estimate
+//  _phi    :   carrier phase offset estimate
+void framesync64_acquire(framesync64     _q,
+                         float complex * _x,
+                         unsigned int    _n,
+                         float           _tau,
+                         float           _gamma,
+                         float           _dphi,
+                         float           _phi)
+{
+    // set estimates
+    _q->tau_hat   = _tau;
+    _q->gamma_hat = _gamma;
+    _q->dphi_hat  = _dphi;
+    _q->phi_hat   = _phi;
 
 #if DEBUG_FRAMESYNC64_PRINT
-        printf("***** frame detected! tau-hat:%8.4f, dphi-hat:%8.4f, gamma:%8.2f dB\n",
-                _q->tau_hat, _q->dphi_hat, 20*log10f(_q->gamma_hat));
+    printf("***** frame detected! tau-hat:%8.4f, dphi-hat:%8.4f, gamma:%8.2f dB\n",
+            _q->tau_hat, _q->dphi_hat, 20*log10f(_q->gamma_hat));
 #endif
 
-        // set appropriate filterbank index
-        if (_q->tau_hat > 0) {
-            _q->pfb_index = (unsigned int)(      _q->tau_hat  * _q->npfb) % _q->npfb;
-            _q->mf_counter = 0;
-        } else {
-            _q->pfb_index = (unsigned int)((1.0f+_q->tau_hat) * _q->npfb) % _q->npfb;
-            _q->mf_counter = 1;
-        }
-        
-        // output filter scale
-        firpfb_crcf_set_scale(_q->mf, 0.5f / _q->gamma_hat);
+    // set appropriate filterbank index
+    if (_q->tau_hat > 0) {
+        _q->pfb_index = (unsigned int)(      _q->tau_hat  * _q->npfb) % _q->npfb;
+        _q->mf_counter = 0;
+    } else {
+        _q->pfb_index = (unsigned int)((1.0f+_q->tau_hat) * _q->npfb) % _q->npfb;
+        _q->mf_counter = 1;
+    }
+    
+    // output filter scale
+    firpfb_crcf_set_scale(_q->mf, 0.5f / _q->gamma_hat);
 
-        // set frequency/phase of mixer
-        nco_crcf_set_frequency(_q->mixer, _q->dphi_hat);
-        nco_crcf_set_phase    (_q->mixer, _q->phi_hat );
+    // set frequency/phase of mixer
+    nco_crcf_set_frequency(_q->mixer, _q->dphi_hat);
+    nco_crcf_set_phase    (_q->mixer, _q->phi_hat );
 
-        // update state
-        _q->state = FRAMESYNC64_STATE_RXPREAMBLE;
+    // update state
+    _q->state = FRAMESYNC64_STATE_RXPREAMBLE;
 
-        // run buffered samples through synchronizer
-        unsigned int buf_len = qdetector_cccf_get_buf_len(_q->detector);
-        framesync64_execute(_q, v, buf_len);
-    }
+    // run aligned samples through synchronizer
+    framesync64_execute(_q, _x, _n);
 }
 
 // step receiver mixer, matched filter, decimator
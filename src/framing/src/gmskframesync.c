@@ -72,6 +72,9 @@ void gmskframesync_execute_rxpayload(  gmskframesync _q, float complex _x);
 // decode header
 void gmskframesync_decode_header(gmskframesync _q);
 
+// submit frame to asynchronous payload decoder queue
+void gmskframesync_submit(gmskframesync _q);
+
 // gmskframesync object structure
 struct gmskframesync_s {
 #if GMSKFRAMESYNC_PREFILTER
@@ -130,9 +133,12 @@ struct gmskframesync_s {
     unsigned int payload_dec_len;   // payload length (num un-encoded bytes)
     unsigned char * payload_enc;    // payload data (encoded bytes)
     unsigned char * payload_dec;    // payload data (encoded bytes)
+    unsigned int payload_enc_cap;   // allocated length of payload_enc
+    unsigned int payload_dec_cap;   // allocated length of payload_dec
     packetizer p_payload;           // payload packetizer
     int payload_valid;              // did payload pass crc?
-    
+    framedecq decq;                 // asynchronous payload decoder queue
+
     // status variables
     enum {
         STATE_DETECTFRAME=0,        // detect frame (seek p/n sequence)
@@ -233,8 +239,10 @@ gmskframesync gmskframesync_create(framesync_callback _callback,
                                      q->fec0,
                                      q->fec1);
     q->payload_enc_len = packetizer_get_enc_msg_len(q->p_payload);
-    q->payload_dec = (unsigned char*) malloc(q->payload_dec_len*sizeof(unsigned char));
-    q->payload_enc = (unsigned char*) malloc(q->payload_enc_len*sizeof(unsigned char));
+    q->payload_dec_cap = q->payload_dec_len;
+    q->payload_enc_cap = q->payload_enc_len;
+    q->payload_dec = (unsigned char*) malloc(q->payload_dec_cap*sizeof(unsigned char));
+    q->payload_enc = (unsigned char*) malloc(q->payload_enc_cap*sizeof(unsigned char));
 
 #if DEBUG_GMSKFRAMESYNC
     // debugging structures
@@ -246,6 +254,9 @@ gmskframesync gmskframesync_create(framesync_callback _callback,
     q->debug_framesyms       = NULL;
 #endif
 
+    // asynchronous payload decoding disabled by default
+    q->decq = NULL;
+
     // reset synchronizer
     gmskframesync_reset(q);
 
@@ -291,6 +302,8 @@ void gmskframesync_destroy(gmskframesync _q)
     packetizer_destroy(_q->p_payload);
     free(_q->payload_enc);
     free(_q->payload_dec);
+    if (_q->decq != NULL)
+        framedecq_destroy(_q->decq);
 
     // free main object memory
     free(_q);
@@ -300,6 +313,33 @@ void gmskframesync_destroy(gmskframesync _q)
 void gmskframesync_print(gmskframesync _q)
 {
     printf("gmskframesync:\n");
+    if (_q->decq != NULL) {
+        framedecqstats_s stats = framedecq_get_stats(_q->decq);
+        framedecqstats_print(&stats);
+    }
+}
+
+// pre-allocate memory for payloads of up to _max_payload_len bytes with
+// any error-detection scheme and the current and listed error-correction
+// schemes
+void gmskframesync_reserve(gmskframesync      _q,
+                           unsigned int       _max_payload_len,
+                           const fec_scheme * _fec,
+                           unsigned int       _num_fec)
+{
+    // payload packetizer
+    packetizer_reserve(_q->p_payload, _max_payload_len, _fec, _num_fec);
+
+    // payload buffers
+    unsigned int enc_len = packetizer_get_max_enc_msg_len(_q->p_payload);
+    if (enc_len > _q->payload_enc_cap) {
+        _q->payload_enc_cap = enc_len;
+        _q->payload_enc = (unsigned char*) realloc(_q->payload_enc, _q->payload_enc_cap*sizeof(unsigned char));
+    }
+    if (_max_payload_len > _q->payload_dec_cap) {
+        _q->payload_dec_cap = _max_payload_len;
+        _q->payload_dec = (unsigned char*) realloc(_q->payload_dec, _q->payload_dec_cap*sizeof(unsigned char));
+    }
 }
 
 void gmskframesync_set_header_len(gmskframesync _q,
@@ -326,6 +366,42 @@ void gmskframesync_set_header_len(gmskframesync _q,
     _q->header_mod = (unsigned char*)realloc(_q->header_mod, _q->header_mod_len*sizeof(unsigned char));
 }
 
+// enable or disable asynchronous decoding of payload
+void gmskframesync_decode_payload_async(gmskframesync _q,
+                                        unsigned int  _num_workers)
+{
+    // deliver pending frames and destroy existing queue
+    if (_q->decq != NULL) {
+        framedecq_deliver(_q->decq, 1, 0);
+        framedecq_destroy(_q->decq);
+        _q->decq = NULL;
+    }
+
+    if (_num_workers > 0) {
+        _q->decq = framedecq_create(_num_workers, 4*_num_workers,
+                                    _q->callback, _q->userdata, NULL);
+    }
+}
+
+// wait for pending frames to be decoded and invoke their callbacks
+void gmskframesync_flush(gmskframesync _q)
+{
+    if (_q->decq != NULL)
+        framedecq_deliver(_q->decq, 1, 0);
+}
+
+// asynchronous payload decoder statistics
+framedecqstats_s gmskframesync_get_framedecqstats(gmskframesync _q)
+{
+    framedecqstats_s stats;
+    if (_q->decq != NULL) {
+        stats = framedecq_get_stats(_q->decq);
+    } else {
+        memset(&stats, 0x00, sizeof(framedecqstats_s));
+    }
+    return stats;
+}
+
 // reset frame synchronizer object
 void gmskframesync_reset(gmskframesync _q)
 {
@@ -412,6 +488,10 @@ void gmskframesync_execute(gmskframesync   _q,
         gmskframesync_execute_sample(_q, xf);
 
     }
+
+    // deliver frames which have finished decoding
+    if (_q->decq != NULL)
+        framedecq_deliver(_q->decq, 0, 0);
 }
 
 // 
@@ -674,14 +754,19 @@ void gmskframesync_execute_rxheader(gmskframesync _q,
                 _q->framestats.fec0          = LIQUID_FEC_UNKNOWN;
                 _q->framestats.fec1          = LIQUID_FEC_UNKNOWN;
 
-                // invoke callback method
-                _q->callback(_q->header_dec,
-                             _q->header_valid,
-                             NULL,
-                             0,
-                             0,
-                             _q->framestats,
-                             _q->userdata);
+                if (_q->decq != NULL) {
+                    // queue behind pending frames to preserve ordering
+                    gmskframesync_submit(_q);
+                } else {
+                    // invoke callback method
+                    _q->callback(_q->header_dec,
+                                 _q->header_valid,
+                                 NULL,
+                                 0,
+                                 0,
+                                 _q->framestats,
+                                 _q->userdata);
+                }
 
                 gmskframesync_reset(_q);
             }
@@ -728,7 +813,26 @@ void gmskframesync_execute_rxpayload(gmskframesync _q,
         // increment counter
         _q->payload_counter++;
 
-        if (_q->payload_counter == 8*_q->payload_enc_len) {
+        if (_q->payload_counter == 8*_q->payload_enc_len &&
+            _q->decq != NULL)
+        {
+            // hand off payload to decoder queue
+            if (_q->callback != NULL) {
+                _q->framestats.rssi          = 20*log10f(_q->gamma_hat);
+                _q->framestats.evm           = 0.0f;
+                _q->framestats.framesyms     = NULL;
+                _q->framestats.num_framesyms = 0;
+                _q->framestats.mod_scheme    = LIQUID_MODEM_UNKNOWN;
+                _q->framestats.mod_bps       = 1;
+                _q->framestats.check         = _q->check;
+                _q->framestats.fec0          = _q->fec0;
+                _q->framestats.fec1          = _q->fec1;
+                gmskframesync_submit(_q);
+            }
+
+            // reset frame synchronizer
+            gmskframesync_reset(_q);
+        } else if (_q->payload_counter == 8*_q->payload_enc_len) {
             // decode payload
             _q->payload_valid = packetizer_decode(_q->p_payload,
                                                   _q->payload_enc,
@@ -763,6 +867,26 @@ void gmskframesync_execute_rxpayload(gmskframesync _q,
     }
 }
 
+// submit frame to asynchronous payload decoder queue; the header and frame
+// statistics are taken from the object, and the encoded payload is copied
+// only if the header is valid
+void gmskframesync_submit(gmskframesync _q)
+{
+    framedecq_job_s * job = framedecq_get_slot(_q->decq);
+    framedecq_job_set_header(job, _q->header_dec, GMSKFRAME_H_DEC + _q->header_user_len, _q->header_valid);
+    job->stats = _q->framestats;
+    job->num_syms = 0;
+    if (_q->header_valid) {
+        job->decoder = FRAMEDECQ_DECODER_PACKETIZER;
+        job->dec_len = _q->payload_dec_len;
+        job->check   = _q->check;
+        job->fec0    = _q->fec0;
+        job->fec1    = _q->fec1;
+        framedecq_job_set_enc(job, _q->payload_enc, _q->payload_enc_len);
+    }
+    framedecq_submit(_q->decq);
+}
+
 // decode header and re-configure payload decoder
 void gmskframesync_decode_header(gmskframesync _q)
 {
@@ -853,9 +977,15 @@ void gmskframesync_decode_header(gmskframesync _q)
         printf("      * payload encoded :   %u bytes\n", _q->payload_enc_len);
 #endif
 
-        // re-allocate buffers accordingly
-        _q->payload_enc = (unsigned char*) realloc(_q->payload_enc, _q->payload_enc_len*sizeof(unsigned char));
-        _q->payload_dec = (unsigned char*) realloc(_q->payload_dec, _q->payload_dec_len*sizeof(unsigned char));
+        // grow buffers if necessary (packetizer is reconfigured in place)
+        if (_q->payload_enc_len > _q->payload_enc_cap) {
+            _q->payload_enc_cap = _q->payload_enc_len;
+            _q->payload_enc = (unsigned char*) realloc(_q->payload_enc, _q->payload_enc_cap*sizeof(unsigned char));
+        }
+        if (_q->payload_dec_len > _q->payload_dec_cap) {
+            _q->payload_dec_cap = _q->payload_dec_len;
+            _q->payload_dec = (unsigned char*) realloc(_q->payload_dec, _q->payload_dec_cap*sizeof(unsigned char));
+        }
     }
     //
 }
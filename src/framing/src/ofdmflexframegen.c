@@ -45,15 +45,15 @@ void ofdmflexframegen_encode_header(ofdmflexframegen _q);
 // modulate header
 void ofdmflexframegen_modulate_header(ofdmflexframegen _q);
 
-// generate samples of assembled frame (internally)
-void ofdmflexframegen_gen_symbol (ofdmflexframegen _q); // (generic)
-void ofdmflexframegen_gen_S0a    (ofdmflexframegen _q); // generate S0 symbol (first)
-void ofdmflexframegen_gen_S0b    (ofdmflexframegen _q); // generate S0 symbol (second)
-void ofdmflexframegen_gen_S1     (ofdmflexframegen _q); // generate S1 symbol
-void ofdmflexframegen_gen_header (ofdmflexframegen _q); // generate header symbol
-void ofdmflexframegen_gen_payload(ofdmflexframegen _q); // generate payload symbol
-void ofdmflexframegen_gen_tail   (ofdmflexframegen _q); // generate tail symbol
-void ofdmflexframegen_gen_zeros  (ofdmflexframegen _q); // generate zeros
+// generate samples of assembled frame into buffer [size: M+cp_len x 1]
+void ofdmflexframegen_gen_symbol (ofdmflexframegen _q, float complex * _buf); // (generic)
+void ofdmflexframegen_gen_S0a    (ofdmflexframegen _q, float complex * _buf); // generate S0 symbol (first)
+void ofdmflexframegen_gen_S0b    (ofdmflexframegen _q, float complex * _buf); // generate S0 symbol (second)
+void ofdmflexframegen_gen_S1     (ofdmflexframegen _q, float complex * _buf); // generate S1 symbol
+void ofdmflexframegen_gen_header (ofdmflexframegen _q, float complex * _buf); // generate header symbol
+void ofdmflexframegen_gen_payload(ofdmflexframegen _q, float complex * _buf); // generate payload symbol
+void ofdmflexframegen_gen_tail   (ofdmflexframegen _q, float complex * _buf); // generate tail symbol
+void ofdmflexframegen_gen_zeros  (ofdmflexframegen _q, float complex * _buf); // generate zeros
 
 // default ofdmflexframegen properties
 static ofdmflexframegenprops_s ofdmflexframegenprops_default = {
@@ -482,7 +482,7 @@ int ofdmflexframegen_write(ofdmflexframegen _q,
     unsigned int i;
     for (i=0; i<_buf_len; i++) {
         if (_q->buf_index >= _q->frame_len) {
-            ofdmflexframegen_gen_symbol(_q);
+            ofdmflexframegen_gen_symbol(_q, _q->buf_tx);
             _q->buf_index = 0;
         }
 
@@ -492,6 +492,28 @@ int ofdmflexframegen_write(ofdmflexframegen _q,
     return _q->frame_complete;
 }
 
+// write OFDM symbols of assembled frame directly to output buffer
+//  _q              :   OFDM frame generator object
+//  _buf            :   output buffer [size: _num_symbols*(M+cp_len) x 1]
+//  _num_symbols    :   number of OFDM symbols to write
+int ofdmflexframegen_write_symbols(ofdmflexframegen _q,
+                                   float complex *  _buf,
+                                   unsigned int     _num_symbols)
+{
+    // symbols are generated in place and cannot be interleaved with a
+    // partially-read internal buffer from ofdmflexframegen_write()
+    if (_q->buf_index < _q->frame_len) {
+        fprintf(stderr,"error: ofdmflexframegen_write_symbols(), internal buffer not aligned to symbol boundary\n");
+        exit(1);
+    }
+
+    unsigned int i;
+    for (i=0; i<_num_symbols; i++)
+        ofdmflexframegen_gen_symbol(_q, &_buf[i*_q->frame_len]);
+
+    return _q->frame_complete;
+}
+
 
 //
 // internal
@@ -588,20 +610,21 @@ void ofdmflexframegen_modulate_header(ofdmflexframegen _q)
                         &num_written);
 }
 
-// generate transmit samples (fill internal buffer)
-void ofdmflexframegen_gen_symbol(ofdmflexframegen _q)
+// generate transmit samples (fill buffer with one OFDM symbol)
+void ofdmflexframegen_gen_symbol(ofdmflexframegen _q,
+                                 float complex * _buf)
 {
     // increment symbol counter
     _q->symbol_number++;
 
     switch (_q->state) {
-    case OFDMFLEXFRAMEGEN_STATE_S0a:     ofdmflexframegen_gen_S0a    (_q); break;
-    case OFDMFLEXFRAMEGEN_STATE_S0b:     ofdmflexframegen_gen_S0b    (_q); break;
-    case OFDMFLEXFRAMEGEN_STATE_S1:      ofdmflexframegen_gen_S1     (_q); break;
-    case OFDMFLEXFRAMEGEN_STATE_HEADER:  ofdmflexframegen_gen_header (_q); break;
-    case OFDMFLEXFRAMEGEN_STATE_PAYLOAD: ofdmflexframegen_gen_payload(_q); break;
-    case OFDMFLEXFRAMEGEN_STATE_TAIL:    ofdmflexframegen_gen_tail   (_q); break;
-    case OFDMFLEXFRAMEGEN_STATE_ZEROS:   ofdmflexframegen_gen_zeros  (_q); break;
+    case OFDMFLEXFRAMEGEN_STATE_S0a:     ofdmflexframegen_gen_S0a    (_q, _buf); break;
+    case OFDMFLEXFRAMEGEN_STATE_S0b:     ofdmflexframegen_gen_S0b    (_q, _buf); break;
+    case OFDMFLEXFRAMEGEN_STATE_S1:      ofdmflexframegen_gen_S1     (_q, _buf); break;
+    case OFDMFLEXFRAMEGEN_STATE_HEADER:  ofdmflexframegen_gen_header (_q, _buf); break;
+    case OFDMFLEXFRAMEGEN_STATE_PAYLOAD: ofdmflexframegen_gen_payload(_q, _buf); break;
+    case OFDMFLEXFRAMEGEN_STATE_TAIL:    ofdmflexframegen_gen_tail   (_q, _buf); break;
+    case OFDMFLEXFRAMEGEN_STATE_ZEROS:   ofdmflexframegen_gen_zeros  (_q, _buf); break;
     default:
         fprintf(stderr,"error: ofdmflexframegen_writesymbol(), unknown/unsupported internal state\n");
         exit(1);
@@ -609,42 +632,45 @@ void ofdmflexframegen_gen_symbol(ofdmflexframegen _q)
 }
 
 // write first S0 symbol
-void ofdmflexframegen_gen_S0a(ofdmflexframegen _q)
+void ofdmflexframegen_gen_S0a(ofdmflexframegen _q,
+                              float complex * _buf)
 {
 #if DEBUG_OFDMFLEXFRAMEGEN
     printf("writing S0[a] symbol\n");
 #endif
 
     // write S0 symbol into front of buffer
-    ofdmframegen_write_S0a(_q->fg, _q->buf_tx);
+    ofdmframegen_write_S0a(_q->fg, _buf);
 
     // update state
     _q->state = OFDMFLEXFRAMEGEN_STATE_S0b;
 }
 
 // write second S0 symbol
-void ofdmflexframegen_gen_S0b(ofdmflexframegen _q)
+void ofdmflexframegen_gen_S0b(ofdmflexframegen _q,
+                              float complex * _buf)
 {
 #if DEBUG_OFDMFLEXFRAMEGEN
     printf("writing S0[b] symbol\n");
 #endif
 
     // write S0 symbol into front of buffer
-    ofdmframegen_write_S0b(_q->fg, _q->buf_tx);
+    ofdmframegen_write_S0b(_q->fg, _buf);
 
     // update state
     _q->state = OFDMFLEXFRAMEGEN_STATE_S1;
 }
 
 // write S1 symbol
-void ofdmflexframegen_gen_S1(ofdmflexframegen _q)
+void ofdmflexframegen_gen_S1(ofdmflexframegen _q,
+                             float complex * _buf)
 {
 #if DEBUG_OFDMFLEXFRAMEGEN
     printf("writing S1 symbol\n");
 #endif
 
     // write S1 symbol into end of buffer
-    ofdmframegen_write_S1(_q->fg, _q->buf_tx);
+    ofdmframegen_write_S1(_q->fg, _buf);
 
     // update state
     _q->symbol_number = 0;
@@ -652,7 +678,8 @@ void ofdmflexframegen_gen_S1(ofdmflexframegen _q)
 }
 
 // write header symbol
-void ofdmflexframegen_gen_header(ofdmflexframegen _q)
+void ofdmflexframegen_gen_header(ofdmflexframegen _q,
+                                 float complex * _buf)
 {
 #if DEBUG_OFDMFLEXFRAMEGEN
     printf("writing header symbol\n");
@@ -685,7 +712,7 @@ void ofdmflexframegen_gen_header(ofdmflexframegen _q)
     }
 
     // write symbol
-    ofdmframegen_writesymbol(_q->fg, _q->X, _q->buf_tx);
+    ofdmframegen_writesymbol(_q->fg, _q->X, _buf);
 
     // check state
     if (_q->symbol_number == _q->num_symbols_header) {
@@ -695,7 +722,8 @@ void ofdmflexframegen_gen_header(ofdmflexframegen _q)
 }
 
 // write payload symbol
-void ofdmflexframegen_gen_payload(ofdmflexframegen _q)
+void ofdmflexframegen_gen_payload(ofdmflexframegen _q,
+                                  float complex * _buf)
 {
 #if DEBUG_OFDMFLEXFRAMEGEN
     printf("writing payload symbol\n");
@@ -727,7 +755,7 @@ void ofdmflexframegen_gen_payload(ofdmflexframegen _q)
     }
 
     // write symbol
-    ofdmframegen_writesymbol(_q->fg, _q->X, _q->buf_tx);
+    ofdmframegen_writesymbol(_q->fg, _q->X, _buf);
 
     // check to see if this is the last symbol in the payload
     if (_q->symbol_number == _q->num_symbols_payload)
@@ -735,7 +763,8 @@ void ofdmflexframegen_gen_payload(ofdmflexframegen _q)
 }
 
 // generate buffer of zeros
-void ofdmflexframegen_gen_tail(ofdmflexframegen _q)
+void ofdmflexframegen_gen_tail(ofdmflexframegen _q,
+                               float complex * _buf)
 {
 #if DEBUG_OFDMFLEXFRAMEGEN
     printf("writing tail\n");
@@ -743,10 +772,10 @@ void ofdmflexframegen_gen_tail(ofdmflexframegen _q)
     // initialize buffer with zeros
     unsigned int i;
     for (i=0; i<_q->frame_len; i++)
-        _q->buf_tx[i] = 0.0f;
+        _buf[i] = 0.0f;
 
     // write taper_len samples to buffer
-    ofdmframegen_writetail(_q->fg, _q->buf_tx);
+    ofdmframegen_writetail(_q->fg, _buf);
 
     // mark frame as complete
     _q->frame_complete = 1;
@@ -755,13 +784,14 @@ void ofdmflexframegen_gen_tail(ofdmflexframegen _q)
 }
 
 // generate buffer of zeros
-void ofdmflexframegen_gen_zeros(ofdmflexframegen _q)
+void ofdmflexframegen_gen_zeros(ofdmflexframegen _q,
+                                float complex * _buf)
 {
 #if DEBUG_OFDMFLEXFRAMEGEN
     printf("writing zeros\n");
 #endif
     unsigned int i;
     for (i=0; i<_q->frame_len; i++)
-        _q->buf_tx[i] = 0.0f;
+        _buf[i] = 0.0f;
 }
 
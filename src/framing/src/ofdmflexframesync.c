@@ -59,6 +59,9 @@ void ofdmflexframesync_decode_header(ofdmflexframesync _q);
 void ofdmflexframesync_rxpayload(ofdmflexframesync _q,
                                 float complex * _X);
 
+// submit frame to asynchronous payload decoder queue
+void ofdmflexframesync_submit(ofdmflexframesync _q);
+
 static ofdmflexframegenprops_s ofdmflexframesyncprops_header_default = {
     OFDMFLEXFRAME_H_CRC,
     OFDMFLEXFRAME_H_FEC0,
@@ -110,8 +113,12 @@ struct ofdmflexframesync_s {
     unsigned char * payload_dec;        // payload data (decoded bytes)
     unsigned int payload_enc_len;       // length of encoded payload
     unsigned int payload_mod_len;       // number of payload modem symbols
+    unsigned int payload_enc_cap;       // allocated length of payload_enc
+    unsigned int payload_dec_cap;       // allocated length of payload_dec
+    unsigned int payload_syms_cap;      // allocated length of payload_syms
     int payload_valid;                  // valid payload flag
     float complex * payload_syms;       // received payload symbols
+    framedecq decq;                     // asynchronous payload decoder queue
 
     // callback
     framesync_callback callback;        // user-defined callback function
@@ -207,10 +214,14 @@ ofdmflexframesync ofdmflexframesync_create(unsigned int       _M,
     q->payload_soft = 0;
     q->p_payload   = packetizer_create(q->payload_len, q->check, q->fec0, q->fec1);
     q->payload_enc_len = packetizer_get_enc_msg_len(q->p_payload);
-    q->payload_enc = (unsigned char*) malloc(q->payload_enc_len*sizeof(unsigned char));
-    q->payload_dec = (unsigned char*) malloc(q->payload_len*sizeof(unsigned char));
-    q->payload_syms = (float complex *) malloc(q->payload_len*sizeof(float complex));
+    q->payload_enc_cap  = q->payload_enc_len;
+    q->payload_dec_cap  = q->payload_len;
+    q->payload_syms_cap = q->payload_len;
+    q->payload_enc = (unsigned char*) malloc(q->payload_enc_cap*sizeof(unsigned char));
+    q->payload_dec = (unsigned char*) malloc(q->payload_dec_cap*sizeof(unsigned char));
+    q->payload_syms = (float complex *) malloc(q->payload_syms_cap*sizeof(float complex));
     q->payload_mod_len = 0;
+    q->decq = NULL;
 
     // reset state
     ofdmflexframesync_reset(q);
@@ -227,6 +238,8 @@ void ofdmflexframesync_destroy(ofdmflexframesync _q)
     modem_destroy(_q->mod_header);
     packetizer_destroy(_q->p_payload);
     modem_destroy(_q->mod_payload);
+    if (_q->decq != NULL)
+        framedecq_destroy(_q->decq);
 
     // free internal buffers/arrays
     free(_q->p);
@@ -250,6 +263,10 @@ void ofdmflexframesync_print(ofdmflexframesync _q)
     printf("      * data            :   %-u\n", _q->M_data);
     printf("    cyclic prefix len   :   %-u\n", _q->cp_len);
     printf("    taper len           :   %-u\n", _q->taper_len);
+    if (_q->decq != NULL) {
+        framedecqstats_s stats = framedecq_get_stats(_q->decq);
+        framedecqstats_print(&stats);
+    }
 }
 
 void ofdmflexframesync_set_header_len(ofdmflexframesync _q,
@@ -296,6 +313,58 @@ void ofdmflexframesync_decode_payload_soft(ofdmflexframesync _q,
     _q->payload_soft = _soft;
 }
 
+// pre-allocate memory for payloads of up to _max_payload_len bytes with
+// any error-detection scheme, the current and listed error-correction
+// schemes, and the current modulation scheme
+void ofdmflexframesync_reserve(ofdmflexframesync  _q,
+                               unsigned int       _max_payload_len,
+                               const fec_scheme * _fec,
+                               unsigned int       _num_fec)
+{
+    // payload packetizer
+    packetizer_reserve(_q->p_payload, _max_payload_len, _fec, _num_fec);
+
+    // payload buffers (soft decoding holds bps bytes per symbol)
+    unsigned int enc_len = packetizer_get_max_enc_msg_len(_q->p_payload);
+    unsigned int mod_len = (8*enc_len + _q->bps_payload - 1) / _q->bps_payload;
+    if (_q->bps_payload*mod_len > _q->payload_enc_cap) {
+        _q->payload_enc_cap = _q->bps_payload*mod_len;
+        _q->payload_enc = (unsigned char*) realloc(_q->payload_enc, _q->payload_enc_cap*sizeof(unsigned char));
+    }
+    if (_max_payload_len > _q->payload_dec_cap) {
+        _q->payload_dec_cap = _max_payload_len;
+        _q->payload_dec = (unsigned char*) realloc(_q->payload_dec, _q->payload_dec_cap*sizeof(unsigned char));
+    }
+    if (mod_len > _q->payload_syms_cap) {
+        _q->payload_syms_cap = mod_len;
+        _q->payload_syms = (float complex*) realloc(_q->payload_syms, _q->payload_syms_cap*sizeof(float complex));
+    }
+}
+
+// enable or disable asynchronous decoding of payload
+void ofdmflexframesync_decode_payload_async(ofdmflexframesync _q,
+                                            unsigned int      _num_workers)
+{
+    // deliver pending frames and destroy existing queue
+    if (_q->decq != NULL) {
+        framedecq_deliver(_q->decq, 1, 0);
+        framedecq_destroy(_q->decq);
+        _q->decq = NULL;
+    }
+
+    if (_num_workers > 0) {
+        _q->decq = framedecq_create(_num_workers, 4*_num_workers,
+                                    _q->callback, _q->userdata, NULL);
+    }
+}
+
+// wait for pending frames to be decoded and invoke their callbacks
+void ofdmflexframesync_flush(ofdmflexframesync _q)
+{
+    if (_q->decq != NULL)
+        framedecq_deliver(_q->decq, 1, 0);
+}
+
 void ofdmflexframesync_set_header_props(ofdmflexframesync _q,
                                         ofdmflexframegenprops_s * _props)
 {
@@ -356,6 +425,10 @@ void ofdmflexframesync_execute(ofdmflexframesync _q,
 {
     // push samples through ofdmframesync object
     ofdmframesync_execute(_q->fs, _x, _n);
+
+    // deliver frames which have finished decoding
+    if (_q->decq != NULL)
+        framedecq_deliver(_q->decq, 0, 0);
 }
 
 // 
@@ -374,6 +447,18 @@ float ofdmflexframesync_get_cfo(ofdmflexframesync _q)
     return ofdmframesync_get_cfo(_q->fs);
 }
 
+// asynchronous payload decoder statistics
+framedecqstats_s ofdmflexframesync_get_framedecqstats(ofdmflexframesync _q)
+{
+    framedecqstats_s stats;
+    if (_q->decq != NULL) {
+        stats = framedecq_get_stats(_q->decq);
+    } else {
+        memset(&stats, 0x00, sizeof(framedecqstats_s));
+    }
+    return stats;
+}
+
 // 
 // debugging methods
 //
@@ -498,14 +583,19 @@ void ofdmflexframesync_rxheader(ofdmflexframesync _q,
                     _q->framestats.fec0             = LIQUID_FEC_UNKNOWN;
                     _q->framestats.fec1             = LIQUID_FEC_UNKNOWN;
 
-                    // invoke callback method
-                    _q->callback(_q->header,
-                                 _q->header_valid,
-                                 NULL,
-                                 0,
-                                 0,
-                                 _q->framestats,
-                                 _q->userdata);
+                    if (_q->decq != NULL) {
+                        // queue behind pending frames to preserve ordering
+                        ofdmflexframesync_submit(_q);
+                    } else {
+                        // invoke callback method
+                        _q->callback(_q->header,
+                                     _q->header_valid,
+                                     NULL,
+                                     0,
+                                     0,
+                                     _q->framestats,
+                                     _q->userdata);
+                    }
 
                     ofdmflexframesync_reset(_q);
                 }
@@ -659,10 +749,19 @@ void ofdmflexframesync_decode_header(ofdmflexframesync _q)
         printf("      * payload encoded :   %u bytes\n", _q->payload_enc_len);
 #endif
 
-        // re-allocate buffers accordingly
-        _q->payload_enc = (unsigned char*) realloc(_q->payload_enc, _q->payload_enc_len*sizeof(unsigned char));
-        _q->payload_dec = (unsigned char*) realloc(_q->payload_dec, _q->payload_len*sizeof(unsigned char));
-        _q->payload_syms = (float complex*) realloc(_q->payload_syms, _q->payload_mod_len*sizeof(float complex));
+        // grow buffers if necessary (packetizer is reconfigured in place)
+        if (_q->payload_enc_len > _q->payload_enc_cap) {
+            _q->payload_enc_cap = _q->payload_enc_len;
+            _q->payload_enc = (unsigned char*) realloc(_q->payload_enc, _q->payload_enc_cap*sizeof(unsigned char));
+        }
+        if (_q->payload_len > _q->payload_dec_cap) {
+            _q->payload_dec_cap = _q->payload_len;
+            _q->payload_dec = (unsigned char*) realloc(_q->payload_dec, _q->payload_dec_cap*sizeof(unsigned char));
+        }
+        if (_q->payload_mod_len > _q->payload_syms_cap) {
+            _q->payload_syms_cap = _q->payload_mod_len;
+            _q->payload_syms = (float complex*) realloc(_q->payload_syms, _q->payload_syms_cap*sizeof(float complex));
+        }
 #if DEBUG_OFDMFLEXFRAMESYNC
         printf("      * payload mod syms:   %u symbols\n", _q->payload_mod_len);
 #endif
@@ -706,7 +805,23 @@ void ofdmflexframesync_rxpayload(ofdmflexframesync _q,
             // increment symbol counter
             _q->payload_symbol_index++;
 
-            if (_q->payload_symbol_index == _q->payload_mod_len) {
+            if (_q->payload_symbol_index == _q->payload_mod_len &&
+                _q->decq != NULL)
+            {
+                // hand off payload to decoder queue
+                if (_q->callback != NULL) {
+                    _q->framestats.rssi             = ofdmframesync_get_rssi(_q->fs);
+                    _q->framestats.cfo              = ofdmframesync_get_cfo(_q->fs);
+                    _q->framestats.mod_scheme       = _q->ms_payload;
+                    _q->framestats.mod_bps          = _q->bps_payload;
+                    _q->framestats.check            = _q->check;
+                    _q->framestats.fec0             = _q->fec0;
+                    _q->framestats.fec1             = _q->fec1;
+                    ofdmflexframesync_submit(_q);
+                }
+                ofdmflexframesync_reset(_q);
+                break;
+            } else if (_q->payload_symbol_index == _q->payload_mod_len) {
                 // payload extracted
                 if (_q->payload_soft) {
                     _q->payload_valid = packetizer_decode_soft(_q->p_payload, _q->payload_enc, _q->payload_dec);
@@ -753,5 +868,24 @@ void ofdmflexframesync_rxpayload(ofdmflexframesync _q,
     }
 }
 
-
+// submit frame to asynchronous payload decoder queue; the header and frame
+// statistics are taken from the object, and the demodulated payload is
+// copied only if the header is valid
+void ofdmflexframesync_submit(ofdmflexframesync _q)
+{
+    framedecq_job_s * job = framedecq_get_slot(_q->decq);
+    framedecq_job_set_header(job, _q->header, _q->header_dec_len, _q->header_valid);
+    job->stats = _q->framestats;
+    if (_q->header_valid) {
+        job->decoder = FRAMEDECQ_DECODER_PACKETIZER;
+        job->soft    = _q->payload_soft;
+        job->dec_len = _q->payload_len;
+        job->check   = _q->check;
+        job->fec0    = _q->fec0;
+        job->fec1    = _q->fec1;
+        framedecq_job_set_enc (job, _q->payload_enc,  _q->payload_enc_len);
+        framedecq_job_set_syms(job, _q->payload_syms, _q->payload_mod_len);
+    }
+    framedecq_submit(_q->decq);
+}
 
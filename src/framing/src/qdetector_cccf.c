@@ -36,6 +36,15 @@
 #define DEBUG_QDETECTOR_PRINT        0
 #define DEBUG_QDETECTOR_FILENAME     "qdetector_cccf_debug.m"
 
+// energy gate: noise floor smoothing factor and number of windows observed
+// before windows are allowed to be rejected
+#define QDETECTOR_GATE_ALPHA         (1.0f/32.0f)
+#define QDETECTOR_GATE_WARMUP        (32)
+
+// minimum correlation amplitude retained half a coarse search step off the
+// true carrier offset
+#define QDETECTOR_COARSE_LOSS_MIN    (0.5f)
+
 // seek signal (initial detection)
 void qdetector_cccf_execute_seek(qdetector_cccf _q,
                                  float complex  _x);
@@ -44,11 +53,33 @@ void qdetector_cccf_execute_seek(qdetector_cccf _q,
 void qdetector_cccf_execute_align(qdetector_cccf _q,
                                   float complex  _x);
 
+// search full buffer for signal
+void qdetector_cccf_seek_window(qdetector_cccf _q);
+
+// compute offset estimates from aligned buffer
+void qdetector_cccf_align_window(qdetector_cccf _q);
+
+// energy gate: returns 1 if window with mean power _x2 cannot contain a
+// sequence at or above the minimum SNR (within the miss-rate bound)
+int qdetector_cccf_gate_reject(qdetector_cccf _q,
+                               float          _x2);
+
+// cross-multiply received spectrum with template shifted by carrier offset
+// index, storing result in IFFT input buffer
+void qdetector_cccf_crossmul(qdetector_cccf _q,
+                             int            _offset);
+
+// correlate against template at carrier offset index, returning peak
+// squared magnitude (unscaled) and its time index
+float qdetector_cccf_correlate(qdetector_cccf _q,
+                               int            _offset,
+                               unsigned int * _index);
+
 // main object definition
 struct qdetector_cccf_s {
     unsigned int    s_len;          // template (time) length: k * (sequence_len + 2*m)
     float complex * s;              // template (time), [size: s_len x 1]
-    float complex * S;              // template (freq), [size: nfft x 1]
+    float complex * S;              // conjugated template (freq), [size: nfft x 1]
     float           s2_sum;         // sum{ s^2 }
 
     float complex * buf_time_0;     // time-domain buffer (FFT)
@@ -62,11 +93,18 @@ struct qdetector_cccf_s {
     unsigned int    counter;        // sample counter for determining when to compute FFTs
     float           threshold;      // detection threshold
     int             range;          // carrier offset search range (subcarriers)
+    unsigned int    coarse_step;    // carrier offset coarse search step (subcarriers)
+    float           coarse_loss2;   // worst-case squared amplitude loss of coarse step
     unsigned int    num_transforms; // number of transforms taken (debugging)
 
     float           x2_sum_0;       // sum{ |x|^2 } of first half of buffer
     float           x2_sum_1;       // sum{ |x|^2 } of second half of buffer
 
+    float           gate_eta;       // energy gate threshold relative to noise floor (0: disabled)
+    float           gate_floor;     // energy gate noise floor estimate (mean |x|^2)
+    unsigned int    gate_count;     // energy gate: number of windows observed
+    unsigned int    num_gated;      // number of windows rejected by energy gate
+
     int             offset;         // FFT offset index for peak correlation (coarse carrier estimate)
     float           tau_hat;        // timing offset estimate
     float           gamma_hat;      // signal level estimate (channel gain)
@@ -116,13 +154,19 @@ qdetector_cccf qdetector_cccf_create(float complex * _s,
     memset(q->buf_time_0, 0x00, q->nfft*sizeof(float complex));
     memmove(q->buf_time_0, q->s, q->s_len*sizeof(float complex));
     fft_execute(q->fft);
-    memmove(q->S, q->buf_freq_0, q->nfft*sizeof(float complex));
+    unsigned int i;
+    for (i=0; i<q->nfft; i++)
+        q->S[i] = conjf(q->buf_freq_0[i]);
 
     // reset state variables
     q->counter        = q->nfft/2;
     q->num_transforms = 0;
     q->x2_sum_0       = 0.0f;
     q->x2_sum_1       = 0.0f;
+    q->gate_eta       = 0.0f;
+    q->gate_floor     = 0.0f;
+    q->gate_count     = 0;
+    q->num_gated      = 0;
     q->state          = QDETECTOR_STATE_SEEK;
     q->frame_detected = 0;
     memset(q->buf_time_0, 0x00, q->nfft*sizeof(float complex));
@@ -135,6 +179,8 @@ qdetector_cccf qdetector_cccf_create(float complex * _s,
 
     qdetector_cccf_set_threshold(q,0.5f);
     qdetector_cccf_set_range    (q,0.3f); // set initial range for higher detection
+    q->coarse_step = 1;                   // exhaustive carrier offset search
+    q->coarse_loss2 = 1.0f;
 
     // return object
     return q;
@@ -259,7 +305,12 @@ void qdetector_cccf_print(qdetector_cccf _q)
     printf("  template length (time):   %-u\n",   _q->s_len);
     printf("  FFT size              :   %-u\n",   _q->nfft);
     printf("  detection threshold   :   %6.4f\n", _q->threshold);
+    printf("  carrier offset range  :   %-d subcarriers (step %u)\n", _q->range, _q->coarse_step);
     printf("  sum{ s^2 }            :   %.2f\n",  _q->s2_sum);
+    if (_q->gate_eta > 0.0f) {
+        printf("  energy gate           :   %6.4f x floor (%u / %u windows rejected)\n",
+                _q->gate_eta, _q->num_gated, _q->num_transforms);
+    }
 }
 
 void qdetector_cccf_reset(qdetector_cccf _q)
@@ -294,6 +345,63 @@ void * qdetector_cccf_execute(qdetector_cccf _q,
     return NULL;
 }
 
+// run detector on block of samples, stopping as soon as a frame is detected
+//  _q          :   detector object
+//  _x          :   input samples [size: _n x 1]
+//  _n          :   number of input samples
+//  _num_read   :   number of samples consumed from input
+void * qdetector_cccf_execute_block(qdetector_cccf  _q,
+                                    float complex * _x,
+                                    unsigned int    _n,
+                                    unsigned int *  _num_read)
+{
+    unsigned int n = 0;
+    while (n < _n) {
+        // copy as many samples as possible into buffer
+        unsigned int k = _q->nfft - _q->counter;
+        k = k < _n - n ? k : _n - n;
+        memmove(_q->buf_time_0 + _q->counter, _x + n, k*sizeof(float complex));
+        if (_q->state == QDETECTOR_STATE_SEEK)
+            _q->x2_sum_1 += liquid_sumsqcf(_x + n, k);
+        _q->counter += k;
+        n += k;
+
+        if (_q->counter < _q->nfft)
+            break;
+
+        // buffer is full
+        if (_q->state == QDETECTOR_STATE_SEEK)
+            qdetector_cccf_seek_window(_q);
+        else
+            qdetector_cccf_align_window(_q);
+
+        // check if frame was detected
+        if (_q->frame_detected) {
+            _q->frame_detected = 0;
+            *_num_read = n;
+            return (void*)(_q->buf_time_1);
+        }
+    }
+
+    *_num_read = n;
+    return NULL;
+}
+
+// start aligning signal detected externally (e.g. by qdetectorbank_cccf);
+// the samples following the start of the sequence are to be pushed through
+// the detector which then computes its estimates as if it had detected the
+// sequence itself
+//  _q      :   detector object
+//  _offset :   coarse carrier offset (FFT bins of this detector)
+void qdetector_cccf_start_align(qdetector_cccf _q,
+                                int            _offset)
+{
+    _q->state          = QDETECTOR_STATE_ALIGN;
+    _q->offset         = _offset;
+    _q->counter        = 0;
+    _q->frame_detected = 0;
+}
+
 // set detection threshold (should be between 0 and 1, good starting point is 0.5)
 void qdetector_cccf_set_threshold(qdetector_cccf _q,
                                   float          _threshold)
@@ -322,6 +430,82 @@ void qdetector_cccf_set_range(qdetector_cccf _q,
     //printf("range: %d / %u\n", _q->range, _q->nfft);
 }
 
+// set carrier offset coarse search step; a value greater than one searches
+// only every _step subcarriers and refines around the best coarse offset
+// when its correlation is close enough to the detection threshold. A
+// carrier offset of d subcarriers scales the correlation by about
+// sinc(d*s_len/nfft), so the step is limited such that half a step off the
+// true offset retains at least QDETECTOR_COARSE_LOSS_MIN of the amplitude.
+void qdetector_cccf_set_coarse_step(qdetector_cccf _q,
+                                    unsigned int   _step)
+{
+    if (_step == 0) {
+        fprintf(stderr,"warning: carrier offset coarse search step cannot be zero; ignoring\n");
+        return;
+    }
+
+    // limit step to retain enough of the correlation between grid points
+    float r = (float)(_q->s_len) / (float)(_q->nfft);
+    unsigned int step = _step;
+    while (step > 1 && sincf(0.5f*step*r) < QDETECTOR_COARSE_LOSS_MIN)
+        step--;
+    if (step < _step)
+        fprintf(stderr,"warning: carrier offset coarse search step %u too large; using %u\n", _step, step);
+
+    // set internal search step and worst-case loss
+    float loss = sincf(0.5f*step*r);
+    _q->coarse_step  = step;
+    _q->coarse_loss2 = loss*loss;
+}
+
+// set energy gate which skips the correlation for buffers whose power is too
+// close to the estimated noise floor to contain the sequence
+//  _q          :   detector object
+//  _pmiss      :   bound on probability of rejecting a buffer containing the
+//                  sequence at _snr_min (0: disable gate)
+//  _snr_min    :   minimum signal-to-noise ratio of sequence [dB]
+void qdetector_cccf_set_gate(qdetector_cccf _q,
+                             float          _pmiss,
+                             float          _snr_min)
+{
+    if (_pmiss < 0.0f || _pmiss >= 1.0f) {
+        fprintf(stderr,"warning: gate miss probability (%12.4e) out of range; ignoring\n", _pmiss);
+        return;
+    } else if (_pmiss == 0.0f) {
+        _q->gate_eta = 0.0f;
+        return;
+    }
+
+    // Gaussian approximation of mean power over a full buffer relative to the
+    // noise floor when it contains the whole sequence at the minimum SNR:
+    //   mean  : 1 + r*f
+    //   var   : (1 + 2*r*f)/nfft
+    // where r is the SNR and f = s_len/nfft is the fraction of the buffer
+    // occupied by the sequence; the variance of the (smoothed) noise floor
+    // estimate over overlapping buffers is included as well
+    float r   = powf(10.0f, _snr_min/10.0f);
+    float f   = (float)(_q->s_len) / (float)(_q->nfft);
+    float mu  = 1.0f + r*f;
+    float v0  = (1.0f + 2.0f*r*f) / (float)(_q->nfft);
+    float v1  = 2.0f*mu*mu * QDETECTOR_GATE_ALPHA / (2.0f - QDETECTOR_GATE_ALPHA) / (float)(_q->nfft);
+
+    // invert Q-function by bisection: find z such that Q(z) = pmiss
+    float z0 = -10.0f;
+    float z1 =  10.0f;
+    unsigned int i;
+    for (i=0; i<40; i++) {
+        float z = 0.5f*(z0 + z1);
+        if (liquid_Qf(z) > _pmiss) z0 = z;
+        else                       z1 = z;
+    }
+    float z = 0.5f*(z0 + z1);
+
+    // set threshold; reset noise floor estimate
+    _q->gate_eta   = mu - z*sqrtf(v0 + v1);
+    _q->gate_eta   = _q->gate_eta > 0.0f ? _q->gate_eta : 0.0f;
+    _q->gate_count = 0;
+}
+
 // get sequence length
 unsigned int qdetector_cccf_get_seq_len(qdetector_cccf _q)
 {
@@ -364,6 +548,18 @@ float qdetector_cccf_get_phi(qdetector_cccf _q)
     return _q->phi_hat;
 }
 
+// number of windows correlated against sequence
+unsigned int qdetector_cccf_get_num_transforms(qdetector_cccf _q)
+{
+    return _q->num_transforms;
+}
+
+// number of windows rejected by energy gate
+unsigned int qdetector_cccf_get_num_gated(qdetector_cccf _q)
+{
+    return _q->num_gated;
+}
+
 
 //
 // internal methods
@@ -381,10 +577,29 @@ void qdetector_cccf_execute_seek(qdetector_cccf _q,
 
     if (_q->counter < _q->nfft)
         return;
-    
+
+    // search full buffer
+    qdetector_cccf_seek_window(_q);
+}
+
+// search full buffer for signal
+void qdetector_cccf_seek_window(qdetector_cccf _q)
+{
     // reset counter (last half of time buffer)
     _q->counter = _q->nfft/2;
 
+    // increment number of transforms (debugging)
+    _q->num_transforms++;
+
+    // skip correlation if buffer power is too low to contain sequence
+    if (qdetector_cccf_gate_reject(_q, (_q->x2_sum_0 + _q->x2_sum_1) / (float)(_q->nfft))) {
+        _q->num_gated++;
+        memmove(_q->buf_time_0, _q->buf_time_0 + _q->nfft/2, (_q->nfft/2)*sizeof(float complex));
+        _q->x2_sum_0 = _q->x2_sum_1;
+        _q->x2_sum_1 = 0.0f;
+        return;
+    }
+
     // run forward transform
     fft_execute(_q->fft);
 
@@ -392,62 +607,44 @@ void qdetector_cccf_execute_seek(qdetector_cccf _q,
     float g0 = sqrtf(_q->x2_sum_0 + _q->x2_sum_1) * sqrtf((float)(_q->s_len) / (float)(_q->nfft));
     float g = 1.0f / ( (float)(_q->nfft) * g0 * sqrtf(_q->s2_sum) );
     
-    // sweep over carrier frequency offset range
-    int offset;
-    unsigned int i;
-    float        rxy_peak   = 0.0f;
+    // sweep over carrier frequency offset range, comparing squared
+    // magnitudes of unscaled correlator output against scaled threshold
+    // NOTE: this offset may be coarse as a fine carrier estimate is computed later
+    int          offset;
+    unsigned int index;
+    float        rxy2_peak  = 0.0f;
     unsigned int rxy_index  = 0;
     int          rxy_offset = 0;
-    // NOTE: this offset may be coarse as a fine carrier estimate is computed later
-    for (offset=-_q->range; offset<=_q->range; offset++) {
-
-        // cross-multiply, aligning appropriately
-        for (i=0; i<_q->nfft; i++) {
-            // shifted index
-            unsigned int j = (i + _q->nfft - offset) % _q->nfft;
-
-            _q->buf_freq_1[i] = _q->buf_freq_0[i] * conjf(_q->S[j]);
+    int          step       = (int)_q->coarse_step;
+    int          kmax       = _q->range / step;
+    for (offset=-kmax*step; offset<=kmax*step; offset+=step) {
+        float rxy2 = qdetector_cccf_correlate(_q, offset, &index);
+        if (rxy2 > rxy2_peak) {
+            rxy2_peak  = rxy2;
+            rxy_index  = index;
+            rxy_offset = offset;
         }
+    }
 
-        // run inverse transform
-        fft_execute(_q->ifft);
-        
-        // scale output appropriately
-        liquid_vectorcf_mulscalar(_q->buf_time_1, _q->nfft, g, _q->buf_time_1);
-
-#if DEBUG_QDETECTOR
-        // debug output
-        char filename[64];
-        sprintf(filename,"qdetector_out_%u_%d.m", _q->num_transforms, offset+2);
-        FILE * fid = fopen(filename, "w");
-        fprintf(fid,"clear all; close all;\n");
-        fprintf(fid,"nfft = %u;\n", _q->nfft);
-        for (i=0; i<_q->nfft; i++)
-            fprintf(fid,"rxy(%6u) = %12.4e + 1i*%12.4e;\n", i+1, crealf(_q->buf_time_1[i]), cimagf(_q->buf_time_1[i]));
-        fprintf(fid,"figure;\n");
-        fprintf(fid,"t=[0:(nfft-1)];\n");
-        fprintf(fid,"plot(t,abs(rxy));\n");
-        fprintf(fid,"grid on;\n");
-        fprintf(fid,"axis([0 %u 0 1.5]);\n", _q->nfft);
-        fprintf(fid,"[v i] = max(abs(rxy));\n");
-        fprintf(fid,"title(sprintf('peak of %%12.8f at index %%u', v, i));\n");
-        fclose(fid);
-        printf("debug: %s\n", filename);
-#endif
-        // search for peak
-        // TODO: only search over range [-nfft/2, nfft/2)
-        for (i=0; i<_q->nfft; i++) {
-            float rxy_abs = cabsf(_q->buf_time_1[i]);
-            if (rxy_abs > rxy_peak) {
-                rxy_peak   = rxy_abs;
-                rxy_index  = i;
+    // refine around coarse peak, but only if it is within the worst-case
+    // mismatch loss of the threshold (half a coarse step off the true offset)
+    float rxy2_refine = _q->coarse_loss2 * _q->threshold * _q->threshold / (g*g);
+    if (step > 1 && rxy2_peak > rxy2_refine) {
+        int coarse_offset = rxy_offset;
+        for (offset = coarse_offset-step+1; offset < coarse_offset+step; offset++) {
+            if (offset == coarse_offset || offset < -_q->range || offset > _q->range)
+                continue;
+            float rxy2 = qdetector_cccf_correlate(_q, offset, &index);
+            if (rxy2 > rxy2_peak) {
+                rxy2_peak  = rxy2;
+                rxy_index  = index;
                 rxy_offset = offset;
             }
         }
     }
 
-    // increment number of transforms (debugging)
-    _q->num_transforms++;
+    // scale peak appropriately
+    float rxy_peak = sqrtf(rxy2_peak) * g;
 
     if (rxy_peak > _q->threshold && rxy_index < _q->nfft - _q->s_len) {
 #if DEBUG_QDETECTOR_PRINT
@@ -471,6 +668,12 @@ void qdetector_cccf_execute_seek(qdetector_cccf _q,
     // copy last half of fft input buffer to front
     memmove(_q->buf_time_0, _q->buf_time_0 + _q->nfft/2, (_q->nfft/2)*sizeof(float complex));
 
+    // update noise floor estimate
+    if (_q->gate_eta > 0.0f) {
+        float x2 = (_q->x2_sum_0 + _q->x2_sum_1) / (float)(_q->nfft);
+        _q->gate_floor += QDETECTOR_GATE_ALPHA*(fminf(x2, 2*_q->gate_floor) - _q->gate_floor);
+    }
+
     // swap accumulated signal levels
     _q->x2_sum_0 = _q->x2_sum_1;
     _q->x2_sum_1 = 0.0f;
@@ -486,6 +689,13 @@ void qdetector_cccf_execute_align(qdetector_cccf _q,
     if (_q->counter < _q->nfft)
         return;
 
+    // compute estimates from full buffer
+    qdetector_cccf_align_window(_q);
+}
+
+// compute offset estimates from aligned buffer
+void qdetector_cccf_align_window(qdetector_cccf _q)
+{
     //printf("signal is aligned!\n");
 
     // estimate timing offset
@@ -493,11 +703,7 @@ void qdetector_cccf_execute_align(qdetector_cccf _q,
     // cross-multiply frequency-domain components, aligning appropriately with
     // estimated FFT offset index due to carrier frequency offset in received signal
     unsigned int i;
-    for (i=0; i<_q->nfft; i++) {
-        // shifted index
-        unsigned int j = (i + _q->nfft - _q->offset) % _q->nfft;
-        _q->buf_freq_1[i] = _q->buf_freq_0[i] * conjf(_q->S[j]);
-    }
+    qdetector_cccf_crossmul(_q, _q->offset);
     fft_execute(_q->ifft);
     // time aligned to index 0
     // NOTE: taking the sqrt removes bias in the timing estimate, but messes up gamma estimate
@@ -606,3 +812,89 @@ void qdetector_cccf_execute_align(qdetector_cccf _q,
     _q->counter = _q->nfft/2;
 }
 
+// cross-multiply received spectrum with template shifted by carrier offset
+// index, storing result in IFFT input buffer; the circular shift is split
+// into two contiguous vector multiplications
+void qdetector_cccf_crossmul(qdetector_cccf _q,
+                             int            _offset)
+{
+    // buf_freq_1[i] = buf_freq_0[i] * S[(i - offset) mod nfft]
+    unsigned int n = _q->nfft;
+    unsigned int k = (unsigned int)((_offset % (int)n + (int)n) % (int)n);
+    liquid_vectorcf_mul(_q->buf_freq_0,     _q->S + n - k, k,   _q->buf_freq_1);
+    liquid_vectorcf_mul(_q->buf_freq_0 + k, _q->S,         n-k, _q->buf_freq_1 + k);
+}
+
+// correlate against template at carrier offset index, returning peak
+// squared magnitude (unscaled) and its time index
+float qdetector_cccf_correlate(qdetector_cccf _q,
+                               int            _offset,
+                               unsigned int * _index)
+{
+    // cross-multiply and run inverse transform
+    qdetector_cccf_crossmul(_q, _offset);
+    fft_execute(_q->ifft);
+
+    // search for peak
+    // TODO: only search over range [-nfft/2, nfft/2)
+    unsigned int i;
+    float        rxy2_peak = 0.0f;
+    unsigned int rxy_index = 0;
+    for (i=0; i<_q->nfft; i++) {
+        float re = crealf(_q->buf_time_1[i]);
+        float im = cimagf(_q->buf_time_1[i]);
+        float rxy2 = re*re + im*im;
+        if (rxy2 > rxy2_peak) {
+            rxy2_peak = rxy2;
+            rxy_index = i;
+        }
+    }
+
+#if DEBUG_QDETECTOR
+    // debug output
+    char filename[64];
+    sprintf(filename,"qdetector_out_%u_%d.m", _q->num_transforms, _offset+2);
+    FILE * fid = fopen(filename, "w");
+    fprintf(fid,"clear all; close all;\n");
+    fprintf(fid,"nfft = %u;\n", _q->nfft);
+    for (i=0; i<_q->nfft; i++)
+        fprintf(fid,"rxy(%6u) = %12.4e + 1i*%12.4e;\n", i+1, crealf(_q->buf_time_1[i]), cimagf(_q->buf_time_1[i]));
+    fprintf(fid,"figure;\n");
+    fprintf(fid,"t=[0:(nfft-1)];\n");
+    fprintf(fid,"plot(t,abs(rxy));\n");
+    fprintf(fid,"grid on;\n");
+    fprintf(fid,"[v i] = max(abs(rxy));\n");
+    fprintf(fid,"title(sprintf('peak of %%12.8f at index %%u', v, i));\n");
+    fclose(fid);
+    printf("debug: %s\n", filename);
+#endif
+
+    *_index = rxy_index;
+    return rxy2_peak;
+}
+
+// energy gate: returns 1 if window with mean power _x2 cannot contain a
+// sequence at or above the minimum SNR (within the miss-rate bound)
+int qdetector_cccf_gate_reject(qdetector_cccf _q,
+                               float          _x2)
+{
+    if (_q->gate_eta <= 0.0f)
+        return 0;
+
+    // initialize noise floor estimate with first window
+    if (_q->gate_count == 0)
+        _q->gate_floor = _x2;
+
+    // accept all windows until noise floor estimate has settled
+    if (_q->gate_count < QDETECTOR_GATE_WARMUP) {
+        _q->gate_count++;
+        return 0;
+    }
+
+    if (_x2 >= _q->gate_eta * _q->gate_floor)
+        return 0;
+
+    // window rejected; update noise floor estimate
+    _q->gate_floor += QDETECTOR_GATE_ALPHA*(_x2 - _q->gate_floor);
+    return 1;
+}
@@ -0,0 +1,523 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+//
+// qdetectorbank_cccf.c
+//
+// Bank of frame detectors sharing a single input stream. The forward
+// transform of each input buffer is computed once and correlated against
+// every registered template across the carrier offset search range. On
+// detection the template's own qdetector_cccf object aligns the signal and
+// computes offset estimates, and the aligned samples are dispatched to the
+// receivers registered with that template.
+//
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+#include "liquid.internal.h"
+
+// template
+struct qdetectorbank_template_s {
+    qdetector_cccf  detector;       // detector (alignment, estimates)
+    float complex * S;              // conjugated template (freq), [size: nfft x 1]
+    unsigned int    s_len;          // template (time) length
+    float           s2_sum;         // sum{ s^2 }
+    int             aligning;       // detector is aligning signal?
+    unsigned long   last_start;     // stream index of last detected sequence
+    int             detected;       // has template been detected yet?
+};
+
+// receiver
+struct qdetectorbank_receiver_s {
+    unsigned int          id;       // template identifier
+    qdetectorbank_callback callback;// dispatch callback
+    void *                userdata; // user-defined data pointer
+    int                   active;   // receiver requires stream samples?
+};
+
+// main object definition
+struct qdetectorbank_cccf_s {
+    struct qdetectorbank_template_s * templates;
+    unsigned int                      num_templates;
+    struct qdetectorbank_receiver_s * receivers;
+    unsigned int                      num_receivers;
+
+    float complex * buf_time_0;     // time-domain buffer (FFT)
+    float complex * buf_freq_0;     // frequence-domain buffer (FFT)
+    float complex * buf_freq_1;     // frequence-domain buffer (IFFT)
+    float complex * buf_time_1;     // time-domain buffer (IFFT)
+    unsigned int    nfft;           // fft size (largest of all templates)
+    fftplan         fft;            // FFT object:  buf_time_0 > buf_freq_0
+    fftplan         ifft;           // IFFT object: buf_freq_1 > buf_time_1
+
+    unsigned int    counter;        // sample counter for determining when to compute FFTs
+    unsigned long   num_samples;    // stream index of next sample written to buffer
+    float           threshold;      // detection threshold
+    float           dphi_max;       // carrier offset search range (radians/sample)
+    float           x2_sum_0;       // sum{ |x|^2 } of first half of buffer
+    float           x2_sum_1;       // sum{ |x|^2 } of second half of buffer
+
+    unsigned int    num_transforms; // number of forward transforms taken
+    unsigned int    num_detections; // number of detections dispatched
+};
+
+// re-allocate transforms and template spectra for new FFT size
+void qdetectorbank_cccf_configure(qdetectorbank_cccf _q,
+                                  unsigned int       _nfft);
+
+// search full buffer for all templates
+void qdetectorbank_cccf_seek_window(qdetectorbank_cccf _q);
+
+// push samples through aligning detector of template, dispatching
+// aligned samples to receivers upon completion
+void qdetectorbank_cccf_align(qdetectorbank_cccf _q,
+                              unsigned int       _id,
+                              float complex *    _x,
+                              unsigned int       _n);
+
+// forward stream samples to active receivers
+void qdetectorbank_cccf_forward(qdetectorbank_cccf _q,
+                                float complex *    _x,
+                                unsigned int       _n);
+
+// does template have any receivers ready for a new frame?
+int qdetectorbank_cccf_template_ready(qdetectorbank_cccf _q,
+                                      unsigned int       _id);
+
+// create empty detector bank
+qdetectorbank_cccf qdetectorbank_cccf_create()
+{
+    qdetectorbank_cccf q = (qdetectorbank_cccf) malloc(sizeof(struct qdetectorbank_cccf_s));
+    q->templates     = NULL;
+    q->num_templates = 0;
+    q->receivers     = NULL;
+    q->num_receivers = 0;
+
+    q->buf_time_0 = NULL;
+    q->buf_freq_0 = NULL;
+    q->buf_freq_1 = NULL;
+    q->buf_time_1 = NULL;
+    q->nfft       = 0;
+
+    q->threshold = 0.5f;
+    q->dphi_max  = 0.3f;
+
+    q->num_transforms = 0;
+    q->num_detections = 0;
+
+    qdetectorbank_cccf_reset(q);
+    return q;
+}
+
+void qdetectorbank_cccf_destroy(qdetectorbank_cccf _q)
+{
+    unsigned int i;
+    for (i=0; i<_q->num_templates; i++) {
+        qdetector_cccf_destroy(_q->templates[i].detector);
+        free(_q->templates[i].S);
+    }
+    free(_q->templates);
+    free(_q->receivers);
+
+    if (_q->nfft > 0) {
+        free(_q->buf_time_0);
+        free(_q->buf_freq_0);
+        free(_q->buf_freq_1);
+        free(_q->buf_time_1);
+        fft_destroy_plan(_q->fft);
+        fft_destroy_plan(_q->ifft);
+    }
+
+    // free main object memory
+    free(_q);
+}
+
+void qdetectorbank_cccf_print(qdetectorbank_cccf _q)
+{
+    printf("qdetectorbank_cccf:\n");
+    printf("  templates             :   %u\n", _q->num_templates);
+    printf("  receivers             :   %u\n", _q->num_receivers);
+    printf("  FFT size              :   %u\n", _q->nfft);
+    printf("  detection threshold   :   %6.4f\n", _q->threshold);
+    printf("  transforms            :   %u\n", _q->num_transforms);
+    printf("  detections            :   %u\n", _q->num_detections);
+}
+
+// reset detector bank, discarding buffered samples and releasing receivers
+void qdetectorbank_cccf_reset(qdetectorbank_cccf _q)
+{
+    unsigned int i;
+    for (i=0; i<_q->num_templates; i++) {
+        _q->templates[i].aligning = 0;
+        _q->templates[i].detected = 0;
+    }
+    for (i=0; i<_q->num_receivers; i++)
+        _q->receivers[i].active = 0;
+
+    _q->counter     = _q->nfft/2;
+    _q->num_samples = _q->nfft/2;   // includes initial zero-padding
+    _q->x2_sum_0    = 0.0f;
+    _q->x2_sum_1    = 0.0f;
+    if (_q->nfft > 0)
+        memset(_q->buf_time_0, 0x00, _q->nfft*sizeof(float complex));
+}
+
+// add template to bank, returning its identifier; if an identical
+// template already exists its identifier is returned instead
+//  _q      :   detector bank
+//  _s      :   sample sequence
+//  _s_len  :   length of sample sequence
+unsigned int qdetectorbank_cccf_add_template(qdetectorbank_cccf _q,
+                                             float complex *    _s,
+                                             unsigned int       _s_len)
+{
+    if (_s_len == 0) {
+        fprintf(stderr,"error: qdetectorbank_cccf_add_template(), sequence length cannot be zero\n");
+        exit(1);
+    }
+
+    // search for identical template
+    unsigned int i;
+    for (i=0; i<_q->num_templates; i++) {
+        qdetector_cccf d = _q->templates[i].detector;
+        if (qdetector_cccf_get_seq_len(d) == _s_len &&
+            memcmp(qdetector_cccf_get_sequence(d), _s, _s_len*sizeof(float complex)) == 0)
+        {
+            return i;
+        }
+    }
+
+    // append new template
+    _q->templates = (struct qdetectorbank_template_s*)
+        realloc(_q->templates, (_q->num_templates+1)*sizeof(struct qdetectorbank_template_s));
+    struct qdetectorbank_template_s * t = &_q->templates[_q->num_templates];
+    t->detector = qdetector_cccf_create(_s, _s_len);
+    t->S        = NULL;
+    t->s_len    = _s_len;
+    t->s2_sum   = liquid_sumsqcf(_s, _s_len);
+    qdetector_cccf_set_threshold(t->detector, _q->threshold);
+    _q->num_templates++;
+
+    // re-configure transforms (size may grow with new template)
+    unsigned int nfft = _q->nfft;
+    unsigned int buf_len = qdetector_cccf_get_buf_len(t->detector);
+    qdetectorbank_cccf_configure(_q, buf_len > nfft ? buf_len : nfft);
+
+    return _q->num_templates - 1;
+}
+
+// register receiver with template
+//  _q          :   detector bank
+//  _id         :   template identifier
+//  _callback   :   dispatch callback
+//  _userdata   :   user-defined data pointer passed to callback
+void qdetectorbank_cccf_add_receiver(qdetectorbank_cccf     _q,
+                                     unsigned int           _id,
+                                     qdetectorbank_callback _callback,
+                                     void *                 _userdata)
+{
+    if (_id >= _q->num_templates) {
+        fprintf(stderr,"error: qdetectorbank_cccf_add_receiver(), template id (%u) out of range\n", _id);
+        exit(1);
+    } else if (_callback == NULL) {
+        fprintf(stderr,"error: qdetectorbank_cccf_add_receiver(), callback cannot be NULL\n");
+        exit(1);
+    }
+
+    _q->receivers = (struct qdetectorbank_receiver_s*)
+        realloc(_q->receivers, (_q->num_receivers+1)*sizeof(struct qdetectorbank_receiver_s));
+    _q->receivers[_q->num_receivers].id       = _id;
+    _q->receivers[_q->num_receivers].callback = _callback;
+    _q->receivers[_q->num_receivers].userdata = _userdata;
+    _q->receivers[_q->num_receivers].active   = 0;
+    _q->num_receivers++;
+}
+
+// set detection threshold (should be between 0 and 1, good starting point is 0.5)
+void qdetectorbank_cccf_set_threshold(qdetectorbank_cccf _q,
+                                      float              _threshold)
+{
+    if (_threshold <= 0.0f || _threshold > 2.0f) {
+        fprintf(stderr,"warning: threshold (%12.4e) out of range; ignoring\n", _threshold);
+        return;
+    }
+
+    _q->threshold = _threshold;
+    unsigned int i;
+    for (i=0; i<_q->num_templates; i++)
+        qdetector_cccf_set_threshold(_q->templates[i].detector, _threshold);
+}
+
+// set carrier offset search range
+void qdetectorbank_cccf_set_range(qdetectorbank_cccf _q,
+                                  float              _dphi_max)
+{
+    if (_dphi_max < 0.0f || _dphi_max > 0.5f) {
+        fprintf(stderr,"warning: carrier offset search range (%12.4e) out of range; ignoring\n", _dphi_max);
+        return;
+    }
+
+    _q->dphi_max = _dphi_max;
+}
+
+// get number of templates
+unsigned int qdetectorbank_cccf_get_num_templates(qdetectorbank_cccf _q)
+{
+    return _q->num_templates;
+}
+
+// get number of detections dispatched to receivers
+unsigned int qdetectorbank_cccf_get_num_detections(qdetectorbank_cccf _q)
+{
+    return _q->num_detections;
+}
+
+// run detector bank on block of samples
+//  _q      :   detector bank
+//  _x      :   input samples [size: _n x 1]
+//  _n      :   number of input samples
+void qdetectorbank_cccf_execute(qdetectorbank_cccf _q,
+                                float complex *    _x,
+                                unsigned int       _n)
+{
+    if (_q->num_templates == 0)
+        return;
+
+    unsigned int i = 0;
+    unsigned int t;
+    while (i < _n) {
+        // process up to end of current search buffer
+        unsigned int k = _q->nfft - _q->counter;
+        k = k < _n - i ? k : _n - i;
+
+        // forward samples to receivers still processing a frame
+        qdetectorbank_cccf_forward(_q, _x + i, k);
+
+        // push samples through aligning detectors
+        for (t=0; t<_q->num_templates; t++) {
+            if (_q->templates[t].aligning)
+                qdetectorbank_cccf_align(_q, t, _x + i, k);
+        }
+
+        // write samples to search buffer
+        memmove(_q->buf_time_0 + _q->counter, _x + i, k*sizeof(float complex));
+        _q->x2_sum_1    += liquid_sumsqcf(_x + i, k);
+        _q->counter     += k;
+        _q->num_samples += k;
+        i += k;
+
+        // search buffer once full
+        if (_q->counter == _q->nfft)
+            qdetectorbank_cccf_seek_window(_q);
+    }
+}
+
+//
+// internal methods
+//
+
+// re-allocate transforms and template spectra for new FFT size
+void qdetectorbank_cccf_configure(qdetectorbank_cccf _q,
+                                  unsigned int       _nfft)
+{
+    unsigned int i;
+    if (_nfft != _q->nfft) {
+        // destroy existing transforms
+        if (_q->nfft > 0) {
+            fft_destroy_plan(_q->fft);
+            fft_destroy_plan(_q->ifft);
+        }
+
+        // allocate buffers and create transforms
+        _q->nfft       = _nfft;
+        _q->buf_time_0 = (float complex*) realloc(_q->buf_time_0, _q->nfft*sizeof(float complex));
+        _q->buf_freq_0 = (float complex*) realloc(_q->buf_freq_0, _q->nfft*sizeof(float complex));
+        _q->buf_freq_1 = (float complex*) realloc(_q->buf_freq_1, _q->nfft*sizeof(float complex));
+        _q->buf_time_1 = (float complex*) realloc(_q->buf_time_1, _q->nfft*sizeof(float complex));
+        _q->fft  = fft_create_plan(_q->nfft, _q->buf_time_0, _q->buf_freq_0, LIQUID_FFT_FORWARD,  0);
+        _q->ifft = fft_create_plan(_q->nfft, _q->buf_freq_1, _q->buf_time_1, LIQUID_FFT_BACKWARD, 0);
+    }
+
+    // compute conjugated frequency-domain templates
+    for (i=0; i<_q->num_templates; i++) {
+        struct qdetectorbank_template_s * t = &_q->templates[i];
+        t->S = (float complex*) realloc(t->S, _q->nfft*sizeof(float complex));
+        memset(_q->buf_time_0, 0x00, _q->nfft*sizeof(float complex));
+        memmove(_q->buf_time_0, qdetector_cccf_get_sequence(t->detector), t->s_len*sizeof(float complex));
+        fft_execute(_q->fft);
+        unsigned int j;
+        for (j=0; j<_q->nfft; j++)
+            t->S[j] = conjf(_q->buf_freq_0[j]);
+    }
+
+    // reset search state
+    qdetectorbank_cccf_reset(_q);
+}
+
+// search full buffer for all templates
+void qdetectorbank_cccf_seek_window(qdetectorbank_cccf _q)
+{
+    unsigned int nfft = _q->nfft;
+
+    // reset counter (last half of time buffer)
+    _q->counter = nfft/2;
+
+    // determine if any template is awaiting detection
+    unsigned int t;
+    int search = 0;
+    for (t=0; t<_q->num_templates; t++)
+        search |= !_q->templates[t].aligning && qdetectorbank_cccf_template_ready(_q, t);
+
+    if (search) {
+        // run forward transform once for all templates
+        fft_execute(_q->fft);
+        _q->num_transforms++;
+
+        int range = (int)(_q->dphi_max * nfft / (2*M_PI));
+        float x2_sum = _q->x2_sum_0 + _q->x2_sum_1;
+
+        for (t=0; t<_q->num_templates; t++) {
+            struct qdetectorbank_template_s * tp = &_q->templates[t];
+            if (tp->aligning || !qdetectorbank_cccf_template_ready(_q, t))
+                continue;
+
+            // scaling factor
+            float g0 = sqrtf(x2_sum) * sqrtf((float)(tp->s_len) / (float)nfft);
+            float g  = 1.0f / ( (float)nfft * g0 * sqrtf(tp->s2_sum) );
+
+            // sweep over carrier frequency offset range
+            int          offset;
+            float        rxy2_peak  = 0.0f;
+            unsigned int rxy_index  = 0;
+            int          rxy_offset = 0;
+            for (offset=-range; offset<=range; offset++) {
+                // cross-multiply with shifted template
+                unsigned int k = (unsigned int)((offset % (int)nfft + (int)nfft) % (int)nfft);
+                liquid_vectorcf_mul(_q->buf_freq_0,     tp->S + nfft - k, k,      _q->buf_freq_1);
+                liquid_vectorcf_mul(_q->buf_freq_0 + k, tp->S,            nfft-k, _q->buf_freq_1 + k);
+                fft_execute(_q->ifft);
+
+                // search for peak
+                unsigned int i;
+                for (i=0; i<nfft; i++) {
+                    float re = crealf(_q->buf_time_1[i]);
+                    float im = cimagf(_q->buf_time_1[i]);
+                    if (re*re + im*im > rxy2_peak) {
+                        rxy2_peak  = re*re + im*im;
+                        rxy_index  = i;
+                        rxy_offset = offset;
+                    }
+                }
+            }
+            float rxy_peak = sqrtf(rxy2_peak) * g;
+            if (rxy_peak <= _q->threshold || rxy_index >= nfft - tp->s_len)
+                continue;
+
+            // ignore sequence which has already been detected
+            unsigned long start = _q->num_samples - nfft + rxy_index;
+            if (tp->detected && start < tp->last_start + tp->s_len)
+                continue;
+            tp->detected   = 1;
+            tp->last_start = start;
+
+            // hand off remainder of buffer to template detector for alignment
+            unsigned int buf_len = qdetector_cccf_get_buf_len(tp->detector);
+            qdetector_cccf_start_align(tp->detector,
+                    (int)roundf((float)rxy_offset * (float)buf_len / (float)nfft));
+            tp->aligning = 1;
+            qdetectorbank_cccf_align(_q, t, _q->buf_time_0 + rxy_index, nfft - rxy_index);
+        }
+    }
+
+    // copy last half of fft input buffer to front
+    memmove(_q->buf_time_0, _q->buf_time_0 + nfft/2, (nfft/2)*sizeof(float complex));
+
+    // swap accumulated signal levels
+    _q->x2_sum_0 = _q->x2_sum_1;
+    _q->x2_sum_1 = 0.0f;
+}
+
+// push samples through aligning detector of template, dispatching
+// aligned samples to receivers upon completion
+void qdetectorbank_cccf_align(qdetectorbank_cccf _q,
+                              unsigned int       _id,
+                              float complex *    _x,
+                              unsigned int       _n)
+{
+    struct qdetectorbank_template_s * tp = &_q->templates[_id];
+    unsigned int num_read = 0;
+    float complex * v = qdetector_cccf_execute_block(tp->detector, _x, _n, &num_read);
+    if (v == NULL)
+        return;
+
+    // signal aligned; dispatch to available receivers
+    tp->aligning = 0;
+    qdetectorbank_detection_s d;
+    d.id    = _id;
+    d.tau   = qdetector_cccf_get_tau  (tp->detector);
+    d.gamma = qdetector_cccf_get_gamma(tp->detector);
+    d.dphi  = qdetector_cccf_get_dphi (tp->detector);
+    d.phi   = qdetector_cccf_get_phi  (tp->detector);
+    unsigned int buf_len = qdetector_cccf_get_buf_len(tp->detector);
+    unsigned int i;
+    for (i=0; i<_q->num_receivers; i++) {
+        struct qdetectorbank_receiver_s * r = &_q->receivers[i];
+        if (r->id != _id || r->active)
+            continue;
+        r->active = r->callback(v, buf_len, &d, r->userdata);
+
+        // forward remaining samples
+        if (r->active && num_read < _n)
+            r->active = r->callback(_x + num_read, _n - num_read, NULL, r->userdata);
+    }
+    _q->num_detections++;
+}
+
+// forward stream samples to active receivers
+void qdetectorbank_cccf_forward(qdetectorbank_cccf _q,
+                                float complex *    _x,
+                                unsigned int       _n)
+{
+    unsigned int i;
+    for (i=0; i<_q->num_receivers; i++) {
+        if (_q->receivers[i].active) {
+            _q->receivers[i].active = _q->receivers[i].callback(_x, _n, NULL,
+                                                                _q->receivers[i].userdata);
+        }
+    }
+}
+
+// does template have any receivers ready for a new frame?
+int qdetectorbank_cccf_template_ready(qdetectorbank_cccf _q,
+                                      unsigned int       _id)
+{
+    unsigned int i;
+    for (i=0; i<_q->num_receivers; i++) {
+        if (_q->receivers[i].id == _id && !_q->receivers[i].active)
+            return 1;
+    }
+    return 0;
+}
@@ -35,6 +35,47 @@
 
 #include "liquid.internal.h"
 
+#if LIQUID_PTHREADS_ENABLED
+#   include <pthread.h>
+#endif
+
+// Batches are demodulated into a shared buffer of encoded payloads which
+// is then decoded by the packetizer in a single batch call; the number of
+// packets per block is set so that the buffer of soft bits stays near this
+// size (bytes).
+#define QPACKETMODEM_BATCH_BUFFER_LEN   (16384)
+#define QPACKETMODEM_BATCH_MAX          (32)
+
+// batch operations
+enum {
+    QPACKETMODEM_BATCH_ENCODE=0,
+    QPACKETMODEM_BATCH_DECODE,
+    QPACKETMODEM_BATCH_DECODE_SOFT,
+};
+
+// update block length and buffer for batch processing
+void qpacketmodem_update_batch(qpacketmodem _q);
+
+// grow payload arrays to hold _mod_len symbols (and their soft bits)
+void qpacketmodem_realloc_payload(qpacketmodem _q,
+                                  unsigned int _mod_len);
+
+// pack 'bps'-bit demodulated symbols into _enc_len bytes, dropping any
+// bits which pad the last symbol
+void qpacketmodem_pack_syms(const unsigned char * _syms,
+                            unsigned int          _bps,
+                            unsigned char *       _enc,
+                            unsigned int          _enc_len);
+
+// run batch operation, splitting packets across threads
+unsigned int qpacketmodem_batch(qpacketmodem          _q,
+                                int                   _op,
+                                unsigned int          _num,
+                                const unsigned char * _payload_in,
+                                float complex *       _frame,
+                                unsigned char *       _payload_out,
+                                int *                 _valid);
+
 struct qpacketmodem_s {
     // properties
     modem           mod_payload;        // payload modulator/demodulator
@@ -46,6 +87,16 @@ struct qpacketmodem_s {
     unsigned int    payload_enc_len;    // number of encoded payload bytes
     unsigned int    payload_bit_len;    // number of bits in encoded payload
     unsigned int    payload_mod_len;    // number of symbols in encoded payload
+    unsigned int    payload_enc_cap;    // allocated length of payload_enc
+    unsigned int    payload_mod_cap;    // allocated length of payload_mod
+    unsigned int    max_payload_len;    // largest payload memory is reserved for
+
+    // batch processing
+    unsigned int    batch_len;          // number of packets per block
+    unsigned char * batch_buf;          // encoded payloads (soft bits) for block
+    unsigned int    batch_buf_cap;      // allocated length of batch_buf
+    unsigned int    num_threads;        // number of threads for batch processing
+    qpacketmodem *  workers;            // modems for additional threads
 };
 
 // create packet encoder
@@ -76,11 +127,21 @@ qpacketmodem qpacketmodem_create()
     q->payload_mod_len = d.quot + (d.rem ? 1 : 0);
 
     // soft demodulator uses one byte to represent each soft bit
-    q->payload_enc = (unsigned char*) malloc(q->bits_per_symbol*q->payload_mod_len*sizeof(unsigned char));
+    q->payload_enc_cap = q->bits_per_symbol*q->payload_mod_len;
+    q->payload_enc = (unsigned char*) malloc(q->payload_enc_cap*sizeof(unsigned char));
 
     // set symbol length appropriately
     q->payload_mod_len = q->payload_enc_len * q->bits_per_symbol;   // for QPSK
-    q->payload_mod = (unsigned char*) malloc(q->payload_mod_len*sizeof(unsigned char));
+    q->payload_mod_cap = q->payload_mod_len;
+    q->payload_mod = (unsigned char*) malloc(q->payload_mod_cap*sizeof(unsigned char));
+    q->max_payload_len = 0;
+
+    // batch processing
+    q->batch_buf   = NULL;
+    q->batch_buf_cap = 0;
+    q->num_threads = 1;
+    q->workers     = NULL;
+    qpacketmodem_update_batch(q);
 
     // return pointer to main object
     return q;
@@ -93,9 +154,16 @@ void qpacketmodem_destroy(qpacketmodem _q)
     packetizer_destroy(_q->p);
     modem_destroy(_q->mod_payload);
 
+    // destroy modems for additional threads
+    unsigned int i;
+    for (i=0; i+1<_q->num_threads; i++)
+        qpacketmodem_destroy(_q->workers[i]);
+    free(_q->workers);
+
     // free arrays
     free(_q->payload_enc);
     free(_q->payload_mod);
+    free(_q->batch_buf);
 
     free(_q);
 }
@@ -146,17 +214,62 @@ int qpacketmodem_configure(qpacketmodem _q,
     div_t d = div(_q->payload_bit_len, _q->bits_per_symbol);
     _q->payload_mod_len = d.quot + (d.rem ? 1 : 0);
 
-    // encoded payload array (leave room for soft-decision decoding)
-    _q->payload_enc = (unsigned char*) realloc(_q->payload_enc,
-            _q->bits_per_symbol*_q->payload_mod_len*sizeof(unsigned char));
+    // grow payload arrays if necessary
+    qpacketmodem_realloc_payload(_q, _q->payload_mod_len);
 
-    // reallocate memory for modem symbols
-    _q->payload_mod = (unsigned char*) realloc(_q->payload_mod,
-                                               _q->payload_mod_len*sizeof(unsigned char));
+    // update batch processing buffer and configure modems for additional threads
+    qpacketmodem_update_batch(_q);
+    unsigned int i;
+    for (i=0; i+1<_q->num_threads; i++)
+        qpacketmodem_configure(_q->workers[i], _payload_len, _check, _fec0, _fec1, _ms);
 
     return 0;
 }
 
+// pre-allocate memory for payloads of up to _payload_len bytes with
+// any error-detection scheme, the current and listed error-correction
+// schemes, and the current modulation scheme
+void qpacketmodem_reserve(qpacketmodem       _q,
+                          unsigned int       _payload_len,
+                          const fec_scheme * _fec,
+                          unsigned int       _num_fec)
+{
+    if (_payload_len > _q->max_payload_len)
+        _q->max_payload_len = _payload_len;
+
+    // packetizer
+    packetizer_reserve(_q->p, _q->max_payload_len, _fec, _num_fec);
+
+    // payload arrays
+    unsigned int enc_len = packetizer_get_max_enc_msg_len(_q->p);
+    unsigned int mod_len = (8*enc_len + _q->bits_per_symbol - 1) / _q->bits_per_symbol;
+    qpacketmodem_realloc_payload(_q, mod_len);
+
+    // batch buffer holds up to QPACKETMODEM_BATCH_BUFFER_LEN soft bits of
+    // packets unless a single packet is longer
+    unsigned int len = QPACKETMODEM_BATCH_BUFFER_LEN;
+    if (len > QPACKETMODEM_BATCH_MAX*8*enc_len) len = QPACKETMODEM_BATCH_MAX*8*enc_len;
+    if (len < 8*enc_len)                        len = 8*enc_len;
+    len += 8;
+    if (len > _q->batch_buf_cap) {
+        _q->batch_buf_cap = len;
+        _q->batch_buf = (unsigned char*) realloc(_q->batch_buf,
+                                                 _q->batch_buf_cap*sizeof(unsigned char));
+    }
+
+    // modems for additional threads
+    unsigned int i;
+    for (i=0; i+1<_q->num_threads; i++)
+        qpacketmodem_reserve(_q->workers[i], _q->max_payload_len, _fec, _num_fec);
+}
+
+// get the longest frame (symbols) memory has been reserved for
+unsigned int qpacketmodem_get_max_frame_len(qpacketmodem _q)
+{
+    unsigned int enc_len = packetizer_get_max_enc_msg_len(_q->p);
+    return (8*enc_len + _q->bits_per_symbol - 1) / _q->bits_per_symbol;
+}
+
 // get length of encoded frame in symbols
 unsigned int qpacketmodem_get_frame_len(qpacketmodem _q)
 {
@@ -190,6 +303,55 @@ unsigned int qpacketmodem_get_modscheme(qpacketmodem _q)
     return modem_get_scheme(_q->mod_payload);
 }
 
+// get number of threads used for batch processing
+unsigned int qpacketmodem_get_num_threads(qpacketmodem _q)
+{
+    return _q->num_threads;
+}
+
+// set number of threads used for batch processing
+//  _q      :   qpacketmodem object
+//  _n      :   number of threads, _n > 0
+void qpacketmodem_set_num_threads(qpacketmodem _q,
+                                  unsigned int _n)
+{
+    if (_n == 0) {
+        fprintf(stderr,"error: qpacketmodem_set_num_threads(), number of threads must be greater than zero\n");
+        exit(1);
+    }
+#if !LIQUID_PTHREADS_ENABLED
+    // no thread support: process batches in calling thread
+    _n = 1;
+#endif
+
+    // destroy old modems for additional threads
+    unsigned int i;
+    for (i=0; i+1<_q->num_threads; i++)
+        qpacketmodem_destroy(_q->workers[i]);
+    free(_q->workers);
+    _q->workers = NULL;
+
+    // each additional thread gets its own modem and packetizer
+    _q->num_threads = _n;
+    if (_n > 1) {
+        _q->workers = (qpacketmodem*) malloc((_n-1)*sizeof(qpacketmodem));
+        for (i=0; i<_n-1; i++) {
+            _q->workers[i] = qpacketmodem_create();
+            qpacketmodem_configure(_q->workers[i],
+                                   _q->payload_dec_len,
+                                   packetizer_get_crc (_q->p),
+                                   packetizer_get_fec0(_q->p),
+                                   packetizer_get_fec1(_q->p),
+                                   modem_get_scheme(_q->mod_payload));
+            if (_q->max_payload_len > 0) {
+                fec_scheme fec[LIQUID_FEC_NUM_SCHEMES];
+                unsigned int num_fec = packetizer_get_fec_pool(_q->p, fec);
+                qpacketmodem_reserve(_q->workers[i], _q->max_payload_len, fec, num_fec);
+            }
+        }
+    }
+}
+
 // encode packet into un-modulated frame symbol indices
 //  _q          :   qpacketmodem object
 //  _payload    :   unencoded payload bytes
@@ -258,9 +420,7 @@ void qpacketmodem_encode(qpacketmodem          _q,
     qpacketmodem_encode_syms(_q, _payload, _q->payload_mod);
 
     // modulate symbols
-    unsigned int i;
-    for (i=0; i<_q->payload_mod_len; i++)
-        modem_modulate(_q->mod_payload, _q->payload_mod[i], &_frame[i]);
+    modem_modulate_block(_q->mod_payload, _q->payload_mod, _q->payload_mod_len, _frame);
 }
 
 // decode packet from modulated frame samples, returning flag if CRC passed
@@ -271,22 +431,10 @@ int qpacketmodem_decode(qpacketmodem    _q,
                         float complex * _frame,
                         unsigned char * _payload)
 {
-    unsigned int i;
-
     // demodulate and pack bytes into decoder input buffer
-    unsigned int sym;
-    //memset(_q->payload_enc, 0x00, _q->payload_enc_len*sizeof(unsigned char));
-    for (i=0; i<_q->payload_mod_len; i++) {
-        // demodulate symbol
-        modem_demodulate(_q->mod_payload, _frame[i], &sym);
-
-        // pack decoded symbol into array
-        liquid_pack_array(_q->payload_enc,
-                          _q->payload_enc_len,
-                          i * _q->bits_per_symbol,
-                          _q->bits_per_symbol,
-                          sym);
-    }
+    modem_demodulate_block(_q->mod_payload, _frame, _q->payload_mod_len, _q->payload_mod);
+    qpacketmodem_pack_syms(_q->payload_mod, _q->bits_per_symbol,
+                           _q->payload_enc, _q->payload_enc_len);
 
     // decode payload, returning flag if decoded payload is valid
     return packetizer_decode(_q->p, _q->payload_enc, _payload);
@@ -300,21 +448,282 @@ int qpacketmodem_decode_soft(qpacketmodem    _q,
                              float complex * _frame,
                              unsigned char * _payload)
 {
-    unsigned int i;
-
-    // demodulate and pack bytes into decoder input buffer
-    unsigned int sym;
-    //memset(_q->payload_enc, 0x00, _q->payload_enc_len*sizeof(unsigned char));
-    unsigned int n = 0;
-    for (i=0; i<_q->payload_mod_len; i++) {
-        // demodulate symbol
-        modem_demodulate_soft(_q->mod_payload, _frame[i], &sym, _q->payload_enc+n);
-        n += _q->bits_per_symbol;
-    }
-    //printf("received %u bits (expected %u)\n", n, _q->payload_mod_len * _q->bits_per_symbol);
-    assert( n == _q->payload_mod_len * _q->bits_per_symbol);
+    // demodulate soft bits into decoder input buffer
+    modem_demodulate_soft_block(_q->mod_payload, _frame, _q->payload_mod_len,
+                                _q->payload_mod, _q->payload_enc);
 
     // decode payload, returning flag if decoded payload is valid
     return packetizer_decode_soft(_q->p, _q->payload_enc, _payload);
 }
 
+// encode and modulate a batch of packets
+//  _q          :   qpacketmodem object
+//  _num        :   number of packets
+//  _payload    :   unencoded payload bytes, [size: _num*payload_len x 1]
+//  _frame      :   encoded/modulated payload symbols, [size: _num*frame_len x 1]
+void qpacketmodem_encode_batch(qpacketmodem          _q,
+                               unsigned int          _num,
+                               const unsigned char * _payload,
+                               float complex *       _frame)
+{
+    qpacketmodem_batch(_q, QPACKETMODEM_BATCH_ENCODE, _num, _payload, _frame, NULL, NULL);
+}
+
+// decode a batch of packets from modulated frame samples (hard-decision
+// decoding), returning the number of packets which passed the CRC
+//  _q          :   qpacketmodem object
+//  _num        :   number of packets
+//  _frame      :   encoded/modulated payload symbols, [size: _num*frame_len x 1]
+//  _payload    :   recovered decoded payload bytes, [size: _num*payload_len x 1]
+//  _valid      :   CRC flag of each packet, [size: _num x 1] (can be NULL)
+unsigned int qpacketmodem_decode_batch(qpacketmodem    _q,
+                                       unsigned int    _num,
+                                       float complex * _frame,
+                                       unsigned char * _payload,
+                                       int *           _valid)
+{
+    return qpacketmodem_batch(_q, QPACKETMODEM_BATCH_DECODE, _num, NULL, _frame, _payload, _valid);
+}
+
+// decode a batch of packets from modulated frame samples (soft-decision
+// decoding), returning the number of packets which passed the CRC
+//  _q          :   qpacketmodem object
+//  _num        :   number of packets
+//  _frame      :   encoded/modulated payload symbols, [size: _num*frame_len x 1]
+//  _payload    :   recovered decoded payload bytes, [size: _num*payload_len x 1]
+//  _valid      :   CRC flag of each packet, [size: _num x 1] (can be NULL)
+unsigned int qpacketmodem_decode_soft_batch(qpacketmodem    _q,
+                                            unsigned int    _num,
+                                            float complex * _frame,
+                                            unsigned char * _payload,
+                                            int *           _valid)
+{
+    return qpacketmodem_batch(_q, QPACKETMODEM_BATCH_DECODE_SOFT, _num, NULL, _frame, _payload, _valid);
+}
+
+// 
+// internal methods
+//
+
+// update block length and buffer for batch processing
+void qpacketmodem_update_batch(qpacketmodem _q)
+{
+    _q->batch_len = QPACKETMODEM_BATCH_BUFFER_LEN / (8*_q->payload_enc_len);
+    if (_q->batch_len < 1)                     _q->batch_len = 1;
+    if (_q->batch_len > QPACKETMODEM_BATCH_MAX) _q->batch_len = QPACKETMODEM_BATCH_MAX;
+
+    // soft bits of each packet are written with a stride of 8*payload_enc_len
+    // so the packetizer can decode the block in place; the final symbol of
+    // a packet can spill up to bits_per_symbol-1 soft bits past its end
+    // (overwritten by the next packet), hence the extra space
+    unsigned int len = 8*_q->batch_len*_q->payload_enc_len + 8;
+    if (len > _q->batch_buf_cap) {
+        _q->batch_buf_cap = len;
+        _q->batch_buf = (unsigned char*) realloc(_q->batch_buf,
+                                                 _q->batch_buf_cap*sizeof(unsigned char));
+    }
+}
+
+// grow payload arrays to hold _mod_len symbols (and their soft bits)
+void qpacketmodem_realloc_payload(qpacketmodem _q,
+                                  unsigned int _mod_len)
+{
+    // encoded payload array (leave room for soft-decision decoding)
+    if (_q->bits_per_symbol*_mod_len > _q->payload_enc_cap) {
+        _q->payload_enc_cap = _q->bits_per_symbol*_mod_len;
+        _q->payload_enc = (unsigned char*) realloc(_q->payload_enc,
+                _q->payload_enc_cap*sizeof(unsigned char));
+    }
+
+    // modem symbols
+    if (_mod_len > _q->payload_mod_cap) {
+        _q->payload_mod_cap = _mod_len;
+        _q->payload_mod = (unsigned char*) realloc(_q->payload_mod,
+                _q->payload_mod_cap*sizeof(unsigned char));
+    }
+}
+
+// pack 'bps'-bit demodulated symbols into _enc_len bytes, dropping any
+// bits which pad the last symbol
+void qpacketmodem_pack_syms(const unsigned char * _syms,
+                            unsigned int          _bps,
+                            unsigned char *       _enc,
+                            unsigned int          _enc_len)
+{
+    unsigned int acc   = 0;     // bit accumulator
+    unsigned int nbits = 0;     // number of bits in accumulator
+    unsigned int n     = 0;     // number of bytes written
+    while (n < _enc_len) {
+        acc = (acc << _bps) | *_syms++;
+        nbits += _bps;
+        if (nbits >= 8) {
+            nbits -= 8;
+            _enc[n++] = (acc >> nbits) & 0xff;
+        }
+    }
+}
+
+// encode and modulate block of packets
+static void qpacketmodem_encode_block(qpacketmodem          _q,
+                                      unsigned int          _num,
+                                      const unsigned char * _payload,
+                                      float complex *       _frame)
+{
+    // encode payloads
+    packetizer_encode_batch(_q->p, _num, _payload, _q->batch_buf);
+
+    unsigned int bps = _q->bits_per_symbol;
+    unsigned int j;
+    for (j=0; j<_num; j++) {
+        // repack 8-bit payload bytes into 'bps'-bit payload symbols
+        unsigned int num_written;
+        liquid_repack_bytes(&_q->batch_buf[j*_q->payload_enc_len],  8,  _q->payload_enc_len,
+                            _q->payload_mod,                       bps, _q->payload_mod_len,
+                            &num_written);
+
+        // modulate symbols
+        modem_modulate_block(_q->mod_payload, _q->payload_mod, _q->payload_mod_len,
+                             &_frame[j*_q->payload_mod_len]);
+    }
+}
+
+// demodulate and decode block of packets, returning number valid
+static unsigned int qpacketmodem_decode_block(qpacketmodem    _q,
+                                              unsigned int    _num,
+                                              float complex * _frame,
+                                              unsigned char * _payload,
+                                              int *           _valid)
+{
+    unsigned int j;
+    for (j=0; j<_num; j++) {
+        // demodulate and pack bytes into decoder input buffer
+        modem_demodulate_block(_q->mod_payload, &_frame[j*_q->payload_mod_len],
+                               _q->payload_mod_len, _q->payload_mod);
+        qpacketmodem_pack_syms(_q->payload_mod, _q->bits_per_symbol,
+                               &_q->batch_buf[j*_q->payload_enc_len], _q->payload_enc_len);
+    }
+
+    // decode payloads
+    return packetizer_decode_batch(_q->p, _num, _q->batch_buf, _payload, _valid);
+}
+
+// demodulate (soft bits) and decode block of packets, returning number valid
+static unsigned int qpacketmodem_decode_soft_block(qpacketmodem    _q,
+                                                   unsigned int    _num,
+                                                   float complex * _frame,
+                                                   unsigned char * _payload,
+                                                   int *           _valid)
+{
+    unsigned int j;
+    for (j=0; j<_num; j++) {
+        // demodulate soft bits in order of packets (see qpacketmodem_update_batch)
+        modem_demodulate_soft_block(_q->mod_payload, &_frame[j*_q->payload_mod_len],
+                                    _q->payload_mod_len, _q->payload_mod,
+                                    &_q->batch_buf[8*j*_q->payload_enc_len]);
+    }
+
+    // decode payloads
+    return packetizer_decode_soft_batch(_q->p, _num, _q->batch_buf, _payload, _valid);
+}
+
+// batch job for a single thread
+struct qpacketmodem_batch_s {
+    qpacketmodem            q;              // modem for this thread
+    int                     op;             // batch operation
+    unsigned int            num;            // number of packets
+    const unsigned char *   payload_in;     // payloads to encode
+    float complex *         frame;          // modulated frames
+    unsigned char *         payload_out;    // decoded payloads
+    int *                   valid;          // CRC flags of decoded payloads
+    unsigned int            num_valid;      // number of valid decoded payloads
+#if LIQUID_PTHREADS_ENABLED
+    pthread_t               thread;
+#endif
+};
+
+// run batch job in blocks of packets
+static void * qpacketmodem_batch_run(void * _context)
+{
+    struct qpacketmodem_batch_s * b = (struct qpacketmodem_batch_s*) _context;
+    qpacketmodem q = b->q;
+
+    unsigned int i;
+    b->num_valid = 0;
+    for (i=0; i<b->num; i+=q->batch_len) {
+        unsigned int num = b->num - i < q->batch_len ? b->num - i : q->batch_len;
+        float complex * frame = &b->frame[i*q->payload_mod_len];
+        int * valid = b->valid == NULL ? NULL : &b->valid[i];
+        switch (b->op) {
+        case QPACKETMODEM_BATCH_ENCODE:
+            qpacketmodem_encode_block(q, num, b->payload_in == NULL ? NULL :
+                                      &b->payload_in[i*q->payload_dec_len], frame);
+            break;
+        case QPACKETMODEM_BATCH_DECODE:
+            b->num_valid += qpacketmodem_decode_block(q, num, frame,
+                                      &b->payload_out[i*q->payload_dec_len], valid);
+            break;
+        case QPACKETMODEM_BATCH_DECODE_SOFT:
+            b->num_valid += qpacketmodem_decode_soft_block(q, num, frame,
+                                      &b->payload_out[i*q->payload_dec_len], valid);
+            break;
+        }
+    }
+    return NULL;
+}
+
+// run batch operation, splitting packets across threads
+//  _q              :   qpacketmodem object
+//  _op             :   batch operation
+//  _num            :   number of packets
+//  _payload_in     :   payloads to encode (encoder only)
+//  _frame          :   modulated frames
+//  _payload_out    :   decoded payloads (decoder only)
+//  _valid          :   CRC flags of decoded payloads (can be NULL)
+unsigned int qpacketmodem_batch(qpacketmodem          _q,
+                                int                   _op,
+                                unsigned int          _num,
+                                const unsigned char * _payload_in,
+                                float complex *       _frame,
+                                unsigned char *       _payload_out,
+                                int *                 _valid)
+{
+    // number of threads (each gets a contiguous range of packets)
+    unsigned int num_threads = _q->num_threads < _num ? _q->num_threads : _num;
+    if (num_threads < 1)
+        num_threads = 1;
+
+    struct qpacketmodem_batch_s b[num_threads];
+    unsigned int i;
+    for (i=0; i<num_threads; i++) {
+        unsigned int i0 = (i  )*_num / num_threads;
+        unsigned int i1 = (i+1)*_num / num_threads;
+        b[i].q           = i==0 ? _q : _q->workers[i-1];
+        b[i].op          = _op;
+        b[i].num         = i1 - i0;
+        b[i].payload_in  = _payload_in  == NULL ? NULL : &_payload_in [i0*_q->payload_dec_len];
+        b[i].frame       = &_frame[i0*_q->payload_mod_len];
+        b[i].payload_out = _payload_out == NULL ? NULL : &_payload_out[i0*_q->payload_dec_len];
+        b[i].valid       = _valid       == NULL ? NULL : &_valid[i0];
+    }
+
+#if LIQUID_PTHREADS_ENABLED
+    // run additional threads, then first range in calling thread
+    for (i=1; i<num_threads; i++) {
+        if (pthread_create(&b[i].thread, NULL, qpacketmodem_batch_run, &b[i]) != 0) {
+            fprintf(stderr,"error: qpacketmodem_batch(), could not create thread\n");
+            exit(1);
+        }
+    }
+    qpacketmodem_batch_run(&b[0]);
+    for (i=1; i<num_threads; i++)
+        pthread_join(b[i].thread, NULL);
+#else
+    for (i=0; i<num_threads; i++)
+        qpacketmodem_batch_run(&b[i]);
+#endif
+
+    unsigned int num_valid = 0;
+    for (i=0; i<num_threads; i++)
+        num_valid += b[i].num_valid;
+    return num_valid;
+}
@@ -89,3 +89,146 @@ void autotest_flexframesync()
     flexframesync_destroy(fs);
 }
 
+
+// callback for asynchronous decoding test: record header sequence number
+static int flexframesync_autotest_callback(unsigned char *  _header,
+                                           int              _header_valid,
+                                           unsigned char *  _payload,
+                                           unsigned int     _payload_len,
+                                           int              _payload_valid,
+                                           framesyncstats_s _stats,
+                                           void *           _userdata)
+{
+    unsigned int * log = (unsigned int*) _userdata;
+    if (_header_valid && _payload_valid && log[0] < 16)
+        log[1 + log[0]++] = _header[0];
+    return 0;
+}
+
+// 
+// AUTOTEST : asynchronous payload decoding delivers every frame in order
+//
+void autotest_flexframesync_async()
+{
+    unsigned int i;
+    unsigned int num_frames   = 8;
+    unsigned int payload_len  = 200;
+
+    // create flexframegen object
+    flexframegenprops_s fgprops;
+    flexframegenprops_init_default(&fgprops);
+    fgprops.mod_scheme  = LIQUID_MODEM_QPSK;
+    fgprops.check       = LIQUID_CRC_32;
+    fgprops.fec0        = LIQUID_FEC_HAMMING128;
+    fgprops.fec1        = LIQUID_FEC_NONE;
+    flexframegen fg = flexframegen_create(&fgprops);
+
+    // create flexframesync object with asynchronous decoding
+    unsigned int log[17] = {0};
+    flexframesync fs = flexframesync_create(flexframesync_autotest_callback, log);
+    flexframesync_decode_payload_async(fs, 2);
+
+    unsigned char header[14] = {0};
+    unsigned char payload[payload_len];
+    float complex buf[64];
+    unsigned int n;
+    for (n=0; n<num_frames; n++) {
+        header[0] = n;
+        for (i=0; i<payload_len; i++)
+            payload[i] = rand() & 0xff;
+        flexframegen_assemble(fg, header, payload, payload_len);
+
+        int frame_complete = 0;
+        while (!frame_complete) {
+            frame_complete = flexframegen_write_samples(fg, buf, 64);
+            flexframesync_execute(fs, buf, 64);
+        }
+    }
+
+    // push through a few extra samples and wait for all frames
+    for (i=0; i<64; i++)
+        buf[i] = 0.0f;
+    flexframesync_execute(fs, buf, 64);
+    flexframesync_flush(fs);
+
+    if (liquid_autotest_verbose)
+        flexframesync_print(fs);
+
+    // check that all frames were recovered in order
+    framedatastats_s stats = flexframesync_get_framedatastats(fs);
+    CONTEND_EQUALITY( stats.num_payloads_valid, num_frames );
+    CONTEND_EQUALITY( log[0], num_frames );
+    for (n=0; n<num_frames; n++)
+        CONTEND_EQUALITY( log[1+n], n );
+
+    framedecqstats_s qstats = flexframesync_get_framedecqstats(fs);
+    CONTEND_EQUALITY( qstats.num_decoded, num_frames );
+    CONTEND_EQUALITY( qstats.num_pending, 0 );
+
+    // decoding time is part of (and no longer than) time to delivery
+    CONTEND_GREATER_THAN( qstats.latency_avg, 0.0f );
+    CONTEND_EXPRESSION( qstats.latency_avg <= qstats.delivery_avg );
+    CONTEND_EXPRESSION( qstats.latency_max <= qstats.delivery_max );
+
+    // destroy objects
+    flexframegen_destroy(fg);
+    flexframesync_destroy(fs);
+}
+
+// 
+// AUTOTEST : frames are recovered after reserving memory, including frames
+//            with shorter payloads and other schemes
+//
+void autotest_flexframesync_reserve()
+{
+    unsigned int i;
+    unsigned int n;
+    unsigned int num_frames      = 8;
+    unsigned int max_payload_len = 600;
+    unsigned int payload_len[8]  = {600, 17, 256, 1, 599, 100, 400, 33};
+    crc_scheme   check[8] = {LIQUID_CRC_32, LIQUID_CRC_NONE, LIQUID_CRC_8, LIQUID_CRC_16,
+                             LIQUID_CRC_24, LIQUID_CRC_CHECKSUM, LIQUID_CRC_32, LIQUID_CRC_16};
+    fec_scheme   fec0[8]  = {LIQUID_FEC_HAMMING128, LIQUID_FEC_GOLAY2412, LIQUID_FEC_NONE,
+                             LIQUID_FEC_SECDED7264, LIQUID_FEC_REP3, LIQUID_FEC_HAMMING74,
+                             LIQUID_FEC_REP5, LIQUID_FEC_SECDED2216};
+    fec_scheme   fec1[8]  = {LIQUID_FEC_NONE, LIQUID_FEC_SECDED3932, LIQUID_FEC_HAMMING84,
+                             LIQUID_FEC_NONE, LIQUID_FEC_GOLAY2412, LIQUID_FEC_REP3,
+                             LIQUID_FEC_HAMMING128, LIQUID_FEC_HAMMING74};
+
+    // create frame generator and synchronizer, reserving memory for all
+    // schemes used
+    flexframegenprops_s fgprops;
+    flexframegenprops_init_default(&fgprops);
+    fgprops.mod_scheme = LIQUID_MODEM_QPSK;
+    flexframegen fg = flexframegen_create(&fgprops);
+    flexframesync fs = flexframesync_create(NULL,NULL);
+    flexframesync_reserve(fs, max_payload_len, fec0, num_frames);
+    flexframesync_reserve(fs, max_payload_len, fec1, num_frames);
+
+    unsigned char header[14] = {0};
+    unsigned char payload[max_payload_len];
+    float complex buf[64];
+    for (n=0; n<num_frames; n++) {
+        fgprops.check = check[n];
+        fgprops.fec0  = fec0[n];
+        fgprops.fec1  = fec1[n];
+        flexframegen_setprops(fg, &fgprops);
+        for (i=0; i<payload_len[n]; i++)
+            payload[i] = rand() & 0xff;
+        flexframegen_assemble(fg, header, payload, payload_len[n]);
+
+        int frame_complete = 0;
+        while (!frame_complete) {
+            frame_complete = flexframegen_write_samples(fg, buf, 64);
+            flexframesync_execute(fs, buf, 64);
+        }
+    }
+
+    // check that all frames were recovered
+    framedatastats_s stats = flexframesync_get_framedatastats(fs);
+    CONTEND_EQUALITY( stats.num_payloads_valid, num_frames );
+
+    // destroy objects
+    flexframegen_destroy(fg);
+    flexframesync_destroy(fs);
+}
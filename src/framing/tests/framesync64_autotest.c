@@ -90,3 +90,72 @@ void autotest_framesync64()
     framesync64_destroy(fs);
 }
 
+
+static int framesync64_autotest_counter(unsigned char *  _header,
+                                        int              _header_valid,
+                                        unsigned char *  _payload,
+                                        unsigned int     _payload_len,
+                                        int              _payload_valid,
+                                        framesyncstats_s _stats,
+                                        void *           _userdata)
+{
+    unsigned int * num_recovered = (unsigned int*) _userdata;
+    if (_header_valid && _payload_valid)
+        (*num_recovered)++;
+    return 0;
+}
+
+// 
+// AUTOTEST : recovery of frames separated by idle channel with energy gate
+//
+void autotest_framesync64_seek_gate()
+{
+    unsigned int i;
+    unsigned int n;
+    unsigned int num_frames = 8;    // number of frames to transmit
+    unsigned int idle_len   = 8192; // idle samples before each frame
+    float        nstd       = 0.1f; // noise standard deviation
+
+    framegen64 fg = framegen64_create();
+
+    // create framesync64 object with energy gate enabled
+    unsigned int num_recovered = 0;
+    framesync64 fs = framesync64_create(framesync64_autotest_counter, &num_recovered);
+    framesync64_set_seek_gate(fs, 1e-3f, 3.0f);
+
+    unsigned char header[8];
+    unsigned char payload[64];
+    unsigned int frame_len = LIQUID_FRAME64_LEN;
+    float complex frame[frame_len];
+    float complex idle[idle_len];
+    unsigned int num_gated = 0;
+    for (n=0; n<num_frames; n++) {
+        // idle channel
+        for (i=0; i<idle_len; i++)
+            idle[i] = nstd*(randnf() + _Complex_I*randnf())*M_SQRT1_2;
+        framesync64_execute(fs, idle, idle_len);
+
+        // gate must reject windows of the idle channel once the noise floor
+        // estimate has settled over the first idle segment
+        if (liquid_autotest_verbose)
+            printf("  idle segment %u : %u windows gated\n", n, framesync64_get_seek_num_gated(fs) - num_gated);
+        if (n > 0)
+            CONTEND_GREATER_THAN( framesync64_get_seek_num_gated(fs), num_gated );
+        num_gated = framesync64_get_seek_num_gated(fs);
+
+        // generate frame and add noise
+        for (i=0; i<8;  i++) header[i]  = n + i;
+        for (i=0; i<64; i++) payload[i] = (n*64 + i) & 0xff;
+        framegen64_execute(fg, header, payload, frame);
+        for (i=0; i<frame_len; i++)
+            frame[i] += nstd*(randnf() + _Complex_I*randnf())*M_SQRT1_2;
+        framesync64_execute(fs, frame, frame_len);
+    }
+
+    // check to see that all frames were recovered
+    CONTEND_EQUALITY( num_recovered, num_frames );
+
+    // destroy objects
+    framegen64_destroy(fg);
+    framesync64_destroy(fs);
+}
@@ -27,7 +27,11 @@
 
 // autotest helper functions
 //  _sequence_len   :   sequence length
-void qdetector_cccf_runtest_linear(unsigned int _sequence_len);
+//  _dphi           :   carrier frequency offset
+//  _coarse_step    :   carrier offset coarse search step
+void qdetector_cccf_runtest_linear(unsigned int _sequence_len,
+                                   float        _dphi,
+                                   unsigned int _coarse_step);
 void qdetector_cccf_runtest_gmsk  (unsigned int _sequence_len);
 
 //
@@ -35,16 +39,26 @@ void qdetector_cccf_runtest_gmsk  (unsigned int _sequence_len);
 //
 
 // linear tests
-void autotest_qdetector_cccf_linear_n64()   { qdetector_cccf_runtest_linear(  64); }
-void autotest_qdetector_cccf_linear_n83()   { qdetector_cccf_runtest_linear(  83); }
-void autotest_qdetector_cccf_linear_n128()  { qdetector_cccf_runtest_linear( 128); }
-void autotest_qdetector_cccf_linear_n167()  { qdetector_cccf_runtest_linear( 167); }
-void autotest_qdetector_cccf_linear_n256()  { qdetector_cccf_runtest_linear( 256); }
-void autotest_qdetector_cccf_linear_n335()  { qdetector_cccf_runtest_linear( 335); }
-void autotest_qdetector_cccf_linear_n512()  { qdetector_cccf_runtest_linear( 512); }
-void autotest_qdetector_cccf_linear_n671()  { qdetector_cccf_runtest_linear( 671); }
-void autotest_qdetector_cccf_linear_n1024() { qdetector_cccf_runtest_linear(1024); }
-void autotest_qdetector_cccf_linear_n1341() { qdetector_cccf_runtest_linear(1341); }
+void autotest_qdetector_cccf_linear_n64()   { qdetector_cccf_runtest_linear(  64, 0.0f, 1); }
+void autotest_qdetector_cccf_linear_n83()   { qdetector_cccf_runtest_linear(  83, 0.0f, 1); }
+void autotest_qdetector_cccf_linear_n128()  { qdetector_cccf_runtest_linear( 128, 0.0f, 1); }
+void autotest_qdetector_cccf_linear_n167()  { qdetector_cccf_runtest_linear( 167, 0.0f, 1); }
+void autotest_qdetector_cccf_linear_n256()  { qdetector_cccf_runtest_linear( 256, 0.0f, 1); }
+void autotest_qdetector_cccf_linear_n335()  { qdetector_cccf_runtest_linear( 335, 0.0f, 1); }
+void autotest_qdetector_cccf_linear_n512()  { qdetector_cccf_runtest_linear( 512, 0.0f, 1); }
+void autotest_qdetector_cccf_linear_n671()  { qdetector_cccf_runtest_linear( 671, 0.0f, 1); }
+void autotest_qdetector_cccf_linear_n1024() { qdetector_cccf_runtest_linear(1024, 0.0f, 1); }
+void autotest_qdetector_cccf_linear_n1341() { qdetector_cccf_runtest_linear(1341, 0.0f, 1); }
+
+// linear tests with carrier offset, exhaustive and coarse-then-fine search
+void autotest_qdetector_cccf_linear_dphi_step1() { qdetector_cccf_runtest_linear(256, 0.07f, 1); }
+void autotest_qdetector_cccf_linear_dphi_step2() { qdetector_cccf_runtest_linear(256, 0.07f, 2); }
+void autotest_qdetector_cccf_linear_dphi_step4() { qdetector_cccf_runtest_linear(256,-0.11f, 4); }
+
+// carrier offset about half a coarse step off the grid (5.9 and 3.1 of
+// 512 subcarriers) where the requested step would lose the correlation
+void autotest_qdetector_cccf_linear_dphi_offgrid_step4() { qdetector_cccf_runtest_linear(110, 2*M_PI*5.9f/512, 4); }
+void autotest_qdetector_cccf_linear_dphi_offgrid_step6() { qdetector_cccf_runtest_linear(110,-2*M_PI*3.1f/512, 6); }
 
 // gmsk tests
 void autotest_qdetector_cccf_gmsk_n64()     { qdetector_cccf_runtest_gmsk  (  64); }
@@ -60,7 +74,11 @@ void autotest_qdetector_cccf_gmsk_n1341()   { qdetector_cccf_runtest_gmsk  (1341
 
 // autotest helper function
 //  _sequence_len   :   sequence length
-void qdetector_cccf_runtest_linear(unsigned int _sequence_len)
+//  _dphi           :   carrier frequency offset
+//  _coarse_step    :   carrier offset coarse search step
+void qdetector_cccf_runtest_linear(unsigned int _sequence_len,
+                                   float        _dphi,
+                                   unsigned int _coarse_step)
 {
     unsigned int k     =     2;     // samples per symbol
     unsigned int m     =     7;     // filter delay [symbols]
@@ -68,11 +86,14 @@ void qdetector_cccf_runtest_linear(unsigned int _sequence_len)
     int          ftype = LIQUID_FIRFILT_ARKAISER; // filter type
     float        gamma =  1.0f;     // channel gain
     float        tau   = -0.3f;     // fractional sample timing offset
-    float        dphi  = -0.000f;   // carrier frequency offset (zero for now)
+    float        dphi  = _dphi;     // carrier frequency offset
     float        phi   =  0.5f;     // carrier phase offset
 
     unsigned int i;
 
+    // seed generator so results do not depend upon tests run before
+    srand(_sequence_len);
+
     // derived values
     unsigned int num_symbols = 8*_sequence_len + 2*m;
     unsigned int num_samples = k * num_symbols;
@@ -122,6 +143,7 @@ void qdetector_cccf_runtest_linear(unsigned int _sequence_len)
 
     // create detector
     qdetector_cccf q = qdetector_cccf_create_linear(sequence, _sequence_len, ftype, k, m, beta);
+    qdetector_cccf_set_coarse_step(q, _coarse_step);
     if (liquid_autotest_verbose)
         qdetector_cccf_print(q);
 
@@ -197,6 +219,9 @@ void qdetector_cccf_runtest_gmsk(unsigned int _sequence_len)
 
     unsigned int i;
 
+    // seed generator so results do not depend upon tests run before
+    srand(_sequence_len);
+
     // derived values
     unsigned int num_symbols = 8*_sequence_len + 2*m;
     unsigned int num_samples = k * num_symbols;
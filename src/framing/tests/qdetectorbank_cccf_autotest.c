@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "autotest/autotest.h"
+#include "liquid.h"
+
+// count valid frames received
+static int qdetectorbank_cccf_autotest_callback(unsigned char *  _header,
+                                                int              _header_valid,
+                                                unsigned char *  _payload,
+                                                unsigned int     _payload_len,
+                                                int              _payload_valid,
+                                                framesyncstats_s _stats,
+                                                void *           _userdata)
+{
+    unsigned int * num_valid = (unsigned int*) _userdata;
+    if (_header_valid && _payload_valid)
+        (*num_valid)++;
+    return 0;
+}
+
+// 
+// AUTOTEST : framesync64 and flexframesync objects sharing one detector bank
+//
+void autotest_qdetectorbank_cccf_framesync()
+{
+    unsigned int i;
+    unsigned int n;
+    unsigned int num_frames = 4;    // number of frames of each type
+    unsigned int idle_len   = 4096; // idle samples between frames
+    float        nstd       = 0.1f; // noise standard deviation
+
+    // create frame generators
+    framegen64 fg64 = framegen64_create();
+    flexframegenprops_s fgprops;
+    flexframegenprops_init_default(&fgprops);
+    fgprops.mod_scheme = LIQUID_MODEM_QPSK;
+    flexframegen fg = flexframegen_create(&fgprops);
+
+    // create frame synchronizers (two of the same type) and attach to bank
+    unsigned int num_valid[3] = {0, 0, 0};
+    framesync64   fs64 = framesync64_create  (qdetectorbank_cccf_autotest_callback, &num_valid[0]);
+    flexframesync fs0  = flexframesync_create(qdetectorbank_cccf_autotest_callback, &num_valid[1]);
+    flexframesync fs1  = flexframesync_create(qdetectorbank_cccf_autotest_callback, &num_valid[2]);
+    qdetectorbank_cccf bank = qdetectorbank_cccf_create();
+    framesync64_attach_qdetectorbank  (fs64, bank);
+    flexframesync_attach_qdetectorbank(fs0,  bank);
+    flexframesync_attach_qdetectorbank(fs1,  bank);
+
+    // all synchronizers share the same preamble
+    CONTEND_EQUALITY( qdetectorbank_cccf_get_num_templates(bank), 1 );
+
+    // alternate frame types, separated by idle channel
+    unsigned char header[14];
+    unsigned char payload[64];
+    float complex buf[idle_len];
+    for (n=0; n<2*num_frames; n++) {
+        for (i=0; i<idle_len; i++)
+            buf[i] = nstd*(randnf() + _Complex_I*randnf())*M_SQRT1_2;
+        qdetectorbank_cccf_execute(bank, buf, idle_len);
+
+        for (i=0; i<14; i++) header[i]  = n + i;
+        for (i=0; i<64; i++) payload[i] = (n*64 + i) & 0xff;
+        if (n % 2 == 0) {
+            // framegen64
+            float complex frame[LIQUID_FRAME64_LEN];
+            framegen64_execute(fg64, header, payload, frame);
+            for (i=0; i<LIQUID_FRAME64_LEN; i++)
+                frame[i] += nstd*(randnf() + _Complex_I*randnf())*M_SQRT1_2;
+            qdetectorbank_cccf_execute(bank, frame, LIQUID_FRAME64_LEN);
+        } else {
+            // flexframegen, written in blocks of 256 samples
+            flexframegen_assemble(fg, header, payload, 64);
+            int frame_complete = 0;
+            while (!frame_complete) {
+                frame_complete = flexframegen_write_samples(fg, buf, 256);
+                for (i=0; i<256; i++)
+                    buf[i] += nstd*(randnf() + _Complex_I*randnf())*M_SQRT1_2;
+                qdetectorbank_cccf_execute(bank, buf, 256);
+            }
+        }
+    }
+
+    // flush remaining frame
+    for (i=0; i<idle_len; i++)
+        buf[i] = nstd*(randnf() + _Complex_I*randnf())*M_SQRT1_2;
+    qdetectorbank_cccf_execute(bank, buf, idle_len);
+
+    if (liquid_autotest_verbose)
+        qdetectorbank_cccf_print(bank);
+
+    // every preamble detected (possibly with false alarms within payloads);
+    // each synchronizer recovers its own frames
+    CONTEND_GREATER_THAN( qdetectorbank_cccf_get_num_detections(bank), 2*num_frames-1 );
+    CONTEND_EQUALITY( num_valid[0], num_frames );
+    CONTEND_EQUALITY( num_valid[1], num_frames );
+    CONTEND_EQUALITY( num_valid[2], num_frames );
+
+    // destroy objects
+    qdetectorbank_cccf_destroy(bank);
+    framegen64_destroy(fg64);
+    flexframegen_destroy(fg);
+    framesync64_destroy(fs64);
+    flexframesync_destroy(fs0);
+    flexframesync_destroy(fs1);
+}
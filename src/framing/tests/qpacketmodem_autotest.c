@@ -140,3 +140,76 @@ void autotest_qpacketmodem_unmod_qam64()  { qpacketmodem_unmodulated(400,LIQUID_
 void autotest_qpacketmodem_unmod_sqam128(){ qpacketmodem_unmodulated(400,LIQUID_CRC_32,LIQUID_FEC_NONE,LIQUID_FEC_NONE, LIQUID_MODEM_SQAM128); }
 void autotest_qpacketmodem_unmod_qam256() { qpacketmodem_unmodulated(400,LIQUID_CRC_32,LIQUID_FEC_NONE,LIQUID_FEC_NONE, LIQUID_MODEM_QAM256);  }
 
+
+// 
+// AUTOTEST : batch encoding/decoding matches packet-by-packet processing
+//
+void qpacketmodem_test_batch(unsigned int _payload_len,
+                             int          _check,
+                             int          _fec0,
+                             int          _fec1,
+                             int          _ms,
+                             unsigned int _num_threads)
+{
+    unsigned int num_packets = 23;
+    unsigned int i;
+    unsigned int j;
+
+    // create and configure packet encoder/decoder objects
+    qpacketmodem q0 = qpacketmodem_create();    // batch
+    qpacketmodem q1 = qpacketmodem_create();    // reference
+    qpacketmodem_set_num_threads(q0, _num_threads);
+    qpacketmodem_configure(q0, _payload_len, _check, _fec0, _fec1, _ms);
+    qpacketmodem_configure(q1, _payload_len, _check, _fec0, _fec1, _ms);
+    unsigned int frame_len = qpacketmodem_get_frame_len(q0);
+
+    unsigned char * payload_tx  = (unsigned char*) malloc(num_packets*_payload_len*sizeof(unsigned char));
+    unsigned char * payload_rx  = (unsigned char*) malloc(num_packets*_payload_len*sizeof(unsigned char));
+    unsigned char * payload_ref = (unsigned char*) malloc(_payload_len*sizeof(unsigned char));
+    float complex * frame       = (float complex*) malloc(num_packets*frame_len*sizeof(float complex));
+    float complex * frame_ref   = (float complex*) malloc(frame_len*sizeof(float complex));
+    int valid[num_packets];
+    for (i=0; i<num_packets*_payload_len; i++)
+        payload_tx[i] = rand() & 0xff;
+
+    // encode
+    qpacketmodem_encode_batch(q0, num_packets, payload_tx, frame);
+    for (j=0; j<num_packets; j++) {
+        qpacketmodem_encode(q1, &payload_tx[j*_payload_len], frame_ref);
+        CONTEND_SAME_DATA(&frame[j*frame_len], frame_ref, frame_len*sizeof(float complex));
+    }
+
+    // corrupt one packet
+    for (i=0; i<frame_len; i++)
+        frame[3*frame_len+i] *= -1.0f;
+
+    // decode (hard and soft decisions)
+    unsigned int s;
+    for (s=0; s<2; s++) {
+        unsigned int num_valid = s==0 ?
+            qpacketmodem_decode_batch     (q0, num_packets, frame, payload_rx, valid) :
+            qpacketmodem_decode_soft_batch(q0, num_packets, frame, payload_rx, valid);
+        CONTEND_EQUALITY(num_valid, num_packets-1);
+        for (j=0; j<num_packets; j++) {
+            int valid_ref = s==0 ?
+                qpacketmodem_decode     (q1, &frame[j*frame_len], payload_ref) :
+                qpacketmodem_decode_soft(q1, &frame[j*frame_len], payload_ref);
+            CONTEND_EQUALITY(valid[j], valid_ref);
+            CONTEND_EQUALITY(valid[j], j==3 ? 0 : 1);
+            CONTEND_SAME_DATA(&payload_rx[j*_payload_len], payload_ref, _payload_len);
+        }
+    }
+
+    // destroy objects
+    qpacketmodem_destroy(q0);
+    qpacketmodem_destroy(q1);
+    free(payload_tx);
+    free(payload_rx);
+    free(payload_ref);
+    free(frame);
+    free(frame_ref);
+}
+
+void autotest_qpacketmodem_batch_qpsk()  { qpacketmodem_test_batch(64, LIQUID_CRC_32,LIQUID_FEC_NONE,      LIQUID_FEC_NONE,     LIQUID_MODEM_QPSK,  1); }
+void autotest_qpacketmodem_batch_psk8()  { qpacketmodem_test_batch(57, LIQUID_CRC_32,LIQUID_FEC_HAMMING128,LIQUID_FEC_GOLAY2412,LIQUID_MODEM_PSK8,  3); }
+void autotest_qpacketmodem_batch_qam64() { qpacketmodem_test_batch(99, LIQUID_CRC_16,LIQUID_FEC_NONE,      LIQUID_FEC_HAMMING84,LIQUID_MODEM_QAM64, 2); }
@@ -76,3 +76,48 @@ void benchmark_freqdem(struct rusage *     _start,
 }
 
 
+
+// frequency demodulator benchmark (block)
+void freqdem_block_bench(struct rusage *     _start,
+                         struct rusage *     _finish,
+                         unsigned long int * _num_iterations,
+                         float               _tol)
+{
+    // create demodulator
+    float   kf  = 0.05f; // modulation index
+    freqdem dem = freqdem_create(kf);
+    freqdem_set_tolerance(dem, _tol);
+
+    unsigned int  n = 1024;
+    float complex r[n];     // modulated signal
+    float         m[n];     // message signal
+
+    unsigned long int i;
+
+    // generate modulated signal
+    for (i=0; i<n; i++)
+        r[i] = 0.3f*cexpf(_Complex_I*2*M_PI*i/20.0f);
+
+    // start trials
+    *_num_iterations /= 50;
+    getrusage(RUSAGE_SELF, _start);
+    for (i=0; i<(*_num_iterations); i++)
+        freqdem_demodulate_block(dem, r, n, m);
+    getrusage(RUSAGE_SELF, _finish);
+    *_num_iterations *= n;
+
+    // destroy demodulator
+    freqdem_destroy(dem);
+}
+
+#define FREQDEM_BLOCK_BENCH_API(TOL)        \
+(   struct rusage *_start,                  \
+    struct rusage *_finish,                 \
+    unsigned long int *_num_iterations)     \
+{ freqdem_block_bench(_start, _finish, _num_iterations, TOL); }
+
+void benchmark_freqdem_block_exact  FREQDEM_BLOCK_BENCH_API(0.0f)
+void benchmark_freqdem_block_tol1e5 FREQDEM_BLOCK_BENCH_API(1.5e-5f)
+void benchmark_freqdem_block_tol1e4 FREQDEM_BLOCK_BENCH_API(1e-4f)
+void benchmark_freqdem_block_tol1e3 FREQDEM_BLOCK_BENCH_API(1e-3f)
+void benchmark_freqdem_block_tol1e2 FREQDEM_BLOCK_BENCH_API(1e-2f)
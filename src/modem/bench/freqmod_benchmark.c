@@ -79,3 +79,37 @@ void benchmark_freqmod(struct rusage *     _start,
 }
 
 
+
+// frequency modulator benchmark (block)
+void benchmark_freqmod_block(struct rusage *     _start,
+                             struct rusage *     _finish,
+                             unsigned long int * _num_iterations)
+{
+    // create modulator
+    float   kf  = 0.05f; // modulation index
+    freqmod mod = freqmod_create(kf);
+
+    unsigned int  n = 1024;
+    float         m[n];     // message signal
+    float complex r[n];     // modulated signal
+
+    unsigned long int i;
+
+    // generate message signal (sum of sines)
+    for (i=0; i<n; i++) {
+        m[i] = 0.3f*cosf(2*M_PI*1*i/20.0f + 0.0f) +
+               0.2f*cosf(2*M_PI*2*i/20.0f + 0.4f) +
+               0.4f*cosf(2*M_PI*3*i/20.0f + 1.7f);
+    }
+
+    // start trials
+    *_num_iterations /= 50;
+    getrusage(RUSAGE_SELF, _start);
+    for (i=0; i<(*_num_iterations); i++)
+        freqmod_modulate_block(mod, m, n, r);
+    getrusage(RUSAGE_SELF, _finish);
+    *_num_iterations *= n;
+
+    // destroy modulator
+    freqmod_destroy(mod);
+}
@@ -93,3 +93,57 @@ void benchmark_gmskmodem_demodulate(struct rusage *_start,
     gmskdem_destroy(demod);
 }
 
+// demodulate blocks of symbols
+void gmskmodem_demodulate_block_bench(struct rusage *     _start,
+                                      struct rusage *     _finish,
+                                      unsigned long int * _num_iterations,
+                                      int                 _soft)
+{
+    // options
+    unsigned int k=2;   // filter samples/symbol
+    unsigned int m=3;   // filter delay (symbols)
+    float BT=0.3f;      // bandwidth-time product
+    unsigned int n=256; // symbols per block
+
+    // create modem object
+    gmskdem demod = gmskdem_create(k, m, BT);
+
+    float complex x[n*k];
+    unsigned int  sym_out[n];
+    unsigned char soft[n];
+
+    unsigned long int i;
+    for (i=0; i<n*k; i++)
+        x[i] = randnf()*cexpf(_Complex_I*2*M_PI*randf());
+
+    // start trials
+    *_num_iterations /= 64;
+    getrusage(RUSAGE_SELF, _start);
+    if (_soft) {
+        for (i=0; i<(*_num_iterations); i++)
+            gmskdem_demodulate_soft_block(demod, x, n, sym_out, soft);
+    } else {
+        for (i=0; i<(*_num_iterations); i++)
+            gmskdem_demodulate_block(demod, x, n, sym_out);
+    }
+    getrusage(RUSAGE_SELF, _finish);
+    *_num_iterations *= n;
+
+    // destroy modem objects
+    gmskdem_destroy(demod);
+}
+
+void benchmark_gmskmodem_demodulate_block(struct rusage *_start,
+                                          struct rusage *_finish,
+                                          unsigned long int *_num_iterations)
+{
+    gmskmodem_demodulate_block_bench(_start, _finish, _num_iterations, 0);
+}
+
+void benchmark_gmskmodem_demodsoft_block(struct rusage *_start,
+                                         struct rusage *_finish,
+                                         unsigned long int *_num_iterations)
+{
+    gmskmodem_demodulate_block_bench(_start, _finish, _num_iterations, 1);
+}
+
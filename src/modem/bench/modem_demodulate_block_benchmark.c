@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <sys/resource.h>
+#include "liquid.h"
+
+#define MODEM_DEMODULATE_BLOCK_BENCH_API(MS,SOFT)   \
+(   struct rusage *_start,                          \
+    struct rusage *_finish,                         \
+    unsigned long int *_num_iterations)             \
+{ modem_demodulate_block_bench(_start, _finish, _num_iterations, MS, SOFT); }
+
+// Helper function to keep code base small
+void modem_demodulate_block_bench(struct rusage *_start,
+                                  struct rusage *_finish,
+                                  unsigned long int *_num_iterations,
+                                  modulation_scheme _ms,
+                                  int _soft)
+{
+    // normalize number of iterations (block of 256 samples)
+    *_num_iterations /= _soft ? 256 : 64;
+    if (*_num_iterations < 1) *_num_iterations = 1;
+
+    // initialize demodulator
+    modem demod = modem_create(_ms);
+
+    unsigned long int i;
+
+    // generate input vector to demodulate (spiral)
+    unsigned int n = 256;
+    float complex x[n];
+    for (i=0; i<n; i++)
+        x[i] = 0.07 * (i % 20) * cexpf(_Complex_I*2*M_PI*0.1*i);
+
+    unsigned char s[n];
+    unsigned char soft_bits[8*n];
+
+    // start trials
+    getrusage(RUSAGE_SELF, _start);
+    if (_soft) {
+        for (i=0; i<(*_num_iterations); i++)
+            modem_demodulate_soft_block(demod, x, n, s, soft_bits);
+    } else {
+        for (i=0; i<(*_num_iterations); i++)
+            modem_demodulate_block(demod, x, n, s);
+    }
+    getrusage(RUSAGE_SELF, _finish);
+    *_num_iterations *= n;
+
+    modem_destroy(demod);
+}
+
+// hard decisions
+void benchmark_demodulate_block_bpsk    MODEM_DEMODULATE_BLOCK_BENCH_API(LIQUID_MODEM_BPSK,    0)
+void benchmark_demodulate_block_qpsk    MODEM_DEMODULATE_BLOCK_BENCH_API(LIQUID_MODEM_QPSK,    0)
+void benchmark_demodulate_block_psk8    MODEM_DEMODULATE_BLOCK_BENCH_API(LIQUID_MODEM_PSK8,    0)
+void benchmark_demodulate_block_psk64   MODEM_DEMODULATE_BLOCK_BENCH_API(LIQUID_MODEM_PSK64,   0)
+void benchmark_demodulate_block_qam16   MODEM_DEMODULATE_BLOCK_BENCH_API(LIQUID_MODEM_QAM16,   0)
+void benchmark_demodulate_block_qam64   MODEM_DEMODULATE_BLOCK_BENCH_API(LIQUID_MODEM_QAM64,   0)
+void benchmark_demodulate_block_qam256  MODEM_DEMODULATE_BLOCK_BENCH_API(LIQUID_MODEM_QAM256,  0)
+void benchmark_demodulate_block_apsk16  MODEM_DEMODULATE_BLOCK_BENCH_API(LIQUID_MODEM_APSK16,  0)
+void benchmark_demodulate_block_apsk256 MODEM_DEMODULATE_BLOCK_BENCH_API(LIQUID_MODEM_APSK256, 0)
+
+// soft decisions
+void benchmark_demodsoft_block_bpsk     MODEM_DEMODULATE_BLOCK_BENCH_API(LIQUID_MODEM_BPSK,    1)
+void benchmark_demodsoft_block_qpsk     MODEM_DEMODULATE_BLOCK_BENCH_API(LIQUID_MODEM_QPSK,    1)
+void benchmark_demodsoft_block_qam16    MODEM_DEMODULATE_BLOCK_BENCH_API(LIQUID_MODEM_QAM16,   1)
+void benchmark_demodsoft_block_qam64    MODEM_DEMODULATE_BLOCK_BENCH_API(LIQUID_MODEM_QAM64,   1)
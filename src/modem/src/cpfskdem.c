@@ -32,6 +32,13 @@
 
 #define DEBUG_CPFSKDEM  0
 
+// number of symbols demodulated per pass (coherent)
+#define CPFSKDEM_BLOCK_LEN  (64)
+
+// phase error tolerance of frequency estimates [radians] (coherent);
+// selects the highest-order polynomial arctangent rather than cargf()
+#define CPFSKDEM_FREQDEM_TOLERANCE  (1.5e-5f)
+
 // 
 // internal methods
 //
@@ -55,13 +62,17 @@ void cpfskdem_demodulate_noncoherent(cpfskdem        _q,
                                      unsigned int  * _s,
                                      unsigned int  * _nw);
 #else
-// demodulate array of samples (coherent)
-unsigned int cpfskdem_demodulate_coherent(cpfskdem        _q,
-                                          float complex * _y);
+// demodulate block of symbols (coherent)
+void cpfskdem_demodulate_coherent(cpfskdem        _q,
+                                  float complex * _y,
+                                  unsigned int    _n,
+                                  unsigned int  * _s);
 
-// demodulate array of samples (non-coherent)
-unsigned int cpfskdem_demodulate_noncoherent(cpfskdem        _q,
-                                             float complex * _y);
+// demodulate block of symbols (non-coherent)
+void cpfskdem_demodulate_noncoherent(cpfskdem        _q,
+                                     float complex * _y,
+                                     unsigned int    _n,
+                                     unsigned int  * _s);
 #endif
 
 // cpfskdem
@@ -89,8 +100,10 @@ struct cpfskdem_s {
                        unsigned int  * _s,
                        unsigned int  * _nw);
 #else
-    unsigned int (*demodulate)(cpfskdem        _q,
-                               float complex * _y);
+    void (*demodulate)(cpfskdem        _q,
+                       float complex * _y,
+                       unsigned int    _n,
+                       unsigned int  * _s);
 #endif
 
     // common data structure shared between coherent and non-coherent
@@ -105,6 +118,7 @@ struct cpfskdem_s {
             */
             
             firfilt_crcf mf;    // matched filter
+            freqdem fdem;       // phase differences of filter outputs
         } coherent;
 
         // non-coherent demodulator
@@ -118,7 +132,6 @@ struct cpfskdem_s {
     // state variables
     unsigned int  index;    // debug
     unsigned int  counter;  // sample counter
-    float complex z_prime;  // (coherent only)
 };
 
 // create cpfskdem object (frequency demodulator)
@@ -235,6 +248,10 @@ void cpfskdem_init_coherent(cpfskdem _q)
         fprintf(stderr,"error: cpfskdem_init_coherent(), invalid tx filter type\n");
         exit(1);
     }
+
+    // phase difference scaled by modulation index: 1/(2*pi*kf) = 1/(h*pi)
+    _q->data.coherent.fdem = freqdem_create(0.5f*_q->h);
+    freqdem_set_tolerance(_q->data.coherent.fdem, CPFSKDEM_FREQDEM_TOLERANCE);
 }
 
 // initialize non-coherent demodulator
@@ -263,6 +280,7 @@ void cpfskdem_destroy(cpfskdem _q)
     switch(_q->demod_type) {
     case CPFSKDEM_COHERENT:
         firfilt_crcf_destroy(_q->data.coherent.mf);
+        freqdem_destroy(_q->data.coherent.fdem);
         break;
     case CPFSKDEM_NONCOHERENT:
         break;
@@ -285,6 +303,7 @@ void cpfskdem_reset(cpfskdem _q)
     switch(_q->demod_type) {
     case CPFSKDEM_COHERENT:
         firfilt_crcf_reset(_q->data.coherent.mf);
+        freqdem_reset(_q->data.coherent.fdem);
         break;
     case CPFSKDEM_NONCOHERENT:
         break;
@@ -294,7 +313,6 @@ void cpfskdem_reset(cpfskdem _q)
 
     _q->index   = 0;
     _q->counter = _q->k-1;
-    _q->z_prime = 0;
 }
 
 // get transmit delay [symbols]
@@ -401,60 +419,87 @@ void cpfskdem_demodulate_noncoherent(cpfskdem        _q,
 unsigned int cpfskdem_demodulate(cpfskdem        _q,
                                  float complex * _y)
 {
-    return _q->demodulate(_q, _y);
+    unsigned int sym_out;
+    _q->demodulate(_q, _y, 1, &sym_out);
+    return sym_out;
 }
 
-// demodulate array of samples (coherent)
-unsigned int cpfskdem_demodulate_coherent(cpfskdem        _q,
-                                          float complex * _y)
+// demodulate block of symbols, assuming perfect timing
+//  _q      :   continuous-phase frequency demodulator object
+//  _y      :   input sample array [size: _n*k x 1]
+//  _n      :   number of symbols
+//  _s      :   output symbols [size: _n x 1]
+void cpfskdem_demodulate_block(cpfskdem        _q,
+                               float complex * _y,
+                               unsigned int    _n,
+                               unsigned int  * _s)
 {
-    unsigned int i;
-    unsigned int sym_out = 0;
+    _q->demodulate(_q, _y, _n, _s);
+}
 
-    for (i=0; i<_q->k; i++) {
-        // push input sample through filter
-        firfilt_crcf_push(_q->data.coherent.mf, _y[i]);
+// demodulate block of symbols (coherent)
+void cpfskdem_demodulate_coherent(cpfskdem        _q,
+                                  float complex * _y,
+                                  unsigned int    _n,
+                                  unsigned int  * _s)
+{
+    unsigned int i;
+    unsigned int j;
+    float complex z[CPFSKDEM_BLOCK_LEN];    // matched filter outputs
+    float phi_hat[CPFSKDEM_BLOCK_LEN];      // frequency estimates
+    while (_n > 0) {
+        unsigned int n = _n < CPFSKDEM_BLOCK_LEN ? _n : CPFSKDEM_BLOCK_LEN;
+
+        // run matched filter, computing output only at first sample of
+        // each symbol
+        for (i=0; i<n; i++) {
+            for (j=0; j<_q->k; j++) {
+                // push input sample through filter
+                firfilt_crcf_push(_q->data.coherent.mf, _y[i*_q->k + j]);
 
 #if DEBUG_CPFSKDEM
-        // compute output sample
-        float complex zp;
-        firfilt_crcf_execute(_q->data.coherent.mf, &zp);
-        printf("y(end+1) = %12.8f + 1i*%12.8f;\n", crealf(_y), cimagf(_y));
-        printf("z(end+1) = %12.8f + 1i*%12.8f;\n", crealf(zp), cimagf(zp));
+                // compute output sample
+                float complex zp;
+                firfilt_crcf_execute(_q->data.coherent.mf, &zp);
+                printf("y(end+1) = %12.8f + 1i*%12.8f;\n", crealf(_y[i*_q->k+j]), cimagf(_y[i*_q->k+j]));
+                printf("z(end+1) = %12.8f + 1i*%12.8f;\n", crealf(zp), cimagf(zp));
 #endif
 
-        // decimate output
-        if ( i == 0 ) {
-            // compute output sample
-            float complex z;
-            firfilt_crcf_execute(_q->data.coherent.mf, &z);
+                // decimate output
+                if ( j == 0 )
+                    firfilt_crcf_execute(_q->data.coherent.mf, &z[i]);
+            }
+        }
 
-            // compute instantaneous frequency scaled by modulation index
-            // TODO: pre-compute scaling factor
-            float phi_hat = cargf(conjf(_q->z_prime) * z) / (_q->h * M_PI);
+        // compute instantaneous frequency scaled by modulation index
+        freqdem_demodulate_block(_q->data.coherent.fdem, z, n, phi_hat);
 
+        for (i=0; i<n; i++) {
             // estimate transmitted symbol
-            float v = (phi_hat + (_q->M-1.0))*0.5f;
-            sym_out = ((int) roundf(v)) % _q->M;
-
-            // save current point
-            _q->z_prime = z;
+            float v = (phi_hat[i] + (_q->M-1.0))*0.5f;
+            _s[i] = ((int) roundf(v)) % _q->M;
 
 #if DEBUG_CPFSKDEM
             // print result to screen
             printf("  %3u : %12.8f + j%12.8f, <f=%8.4f : %8.4f> (%1u)\n",
-                    _q->index++, crealf(z), cimagf(z), phi_hat, v, sym_out);
+                    _q->index++, crealf(z[i]), cimagf(z[i]), phi_hat[i], v, _s[i]);
 #endif
         }
+
+        _y += n*_q->k;
+        _s += n;
+        _n -= n;
     }
-    return sym_out;
 }
 
-// demodulate array of samples (non-coherent)
-unsigned int cpfskdem_demodulate_noncoherent(cpfskdem        _q,
-                                             float complex * _y)
+// demodulate block of symbols (non-coherent)
+void cpfskdem_demodulate_noncoherent(cpfskdem        _q,
+                                     float complex * _y,
+                                     unsigned int    _n,
+                                     unsigned int  * _s)
 {
-    return 0;
+    unsigned int i;
+    for (i=0; i<_n; i++)
+        _s[i] = 0;
 }
 #endif
-
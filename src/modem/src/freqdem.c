@@ -23,6 +23,14 @@
 //
 // Frequency demodulator
 //
+// The phase difference between consecutive samples is computed with a
+// polynomial arctangent (see MODEM(_atan2_poly)()) of the lowest order
+// meeting the tolerance set with FREQDEM(_set_tolerance)(), or with
+// cargf() when the tolerance is zero (the default). The polynomials are
+// those of modem_block.c, which precedes this file in modemf.c. Blocks
+// of samples are demodulated four at a time with SSE2; single samples
+// and blocks give identical results.
+//
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -30,6 +38,16 @@
 
 #include "liquid.internal.h"
 
+#if HAVE_EMMINTRIN_H && defined __SSE2__
+#include <emmintrin.h>  // SSE2
+#define FREQDEM_USE_SSE2 1
+#else
+#define FREQDEM_USE_SSE2 0
+#endif
+
+// default phase error tolerance [radians]; exact computation with cargf()
+#define FREQDEM_DEFAULT_TOLERANCE   (0.0f)
+
 // freqdem
 struct FREQDEM(_s) {
     // common
@@ -37,6 +55,11 @@ struct FREQDEM(_s) {
     T     ref;  // 1/(2*pi*kf)
 
     TC r_prime; // previous received sample
+
+    // arctangent approximation
+    float        tol;       // phase error tolerance
+    const T *    atan_poly; // polynomial coefficients (NULL: use cargf)
+    unsigned int atan_len;  // number of coefficients
 };
 
 // create freqdem object
@@ -58,6 +81,9 @@ FREQDEM() FREQDEM(_create)(float _kf)
     // compute derived values
     q->ref = 1.0f / (2*M_PI*q->kf);
 
+    // set arctangent approximation
+    FREQDEM(_set_tolerance)(q, FREQDEM_DEFAULT_TOLERANCE);
+
     // reset modem object
     FREQDEM(_reset)(q);
 
@@ -77,6 +103,10 @@ void FREQDEM(_print)(FREQDEM() _q)
 {
     printf("freqdem:\n");
     printf("    mod. factor :   %8.4f\n", _q->kf);
+    if (_q->atan_poly == NULL)
+        printf("    arctangent  :   exact\n");
+    else
+        printf("    arctangent  :   order %u (tol. %8.2e rad)\n", 2*_q->atan_len-1, _q->tol);
 }
 
 // reset modem object
@@ -86,6 +116,32 @@ void FREQDEM(_reset)(FREQDEM() _q)
     _q->r_prime = 0;
 }
 
+// set phase error tolerance of arctangent approximation
+//  _q      :   FM demodulator object
+//  _tol    :   maximum phase error [radians], 0 for exact computation
+void FREQDEM(_set_tolerance)(FREQDEM() _q,
+                             float     _tol)
+{
+    if (_tol < 0.0f) {
+        fprintf(stderr,"error: freqdem_set_tolerance(), tolerance must be non-negative\n");
+        exit(1);
+    }
+
+    // choose lowest-order polynomial which meets the tolerance
+    _q->atan_poly = NULL;
+    _q->atan_len  = 0;
+    _q->tol       = 0.0f;
+    unsigned int i;
+    for (i=0; i<4; i++) {
+        if (modem_atan_tol[i] <= _tol) {
+            _q->atan_poly = modem_atan_poly[i];
+            _q->atan_len  = i + 2;
+            _q->tol       = modem_atan_tol[i];
+            break;
+        }
+    }
+}
+
 // demodulate sample
 //  _q      :   FM demodulator object
 //  _r      :   received signal
@@ -94,13 +150,51 @@ void FREQDEM(_demodulate)(FREQDEM() _q,
                           TC        _r,
                           T *       _m)
 {
-    // compute phase difference and normalize by modulation index
-    *_m = cargf( conjf(_q->r_prime)*_r ) * _q->ref;
+    if (_q->atan_poly == NULL) {
+        // compute phase difference and normalize by modulation index
+        *_m = cargf( conjf(_q->r_prime)*_r ) * _q->ref;
+    } else {
+        // same operations as block method
+        T re = crealf(_q->r_prime)*crealf(_r) + cimagf(_q->r_prime)*cimagf(_r);
+        T im = crealf(_q->r_prime)*cimagf(_r) - cimagf(_q->r_prime)*crealf(_r);
+        *_m = MODEM(_atan2_poly)(im, re, _q->atan_poly, _q->atan_len) * _q->ref;
+    }
 
     // save previous input sample
     _q->r_prime = _r;
 }
 
+#if FREQDEM_USE_SSE2
+// demodulate block of samples with polynomial of _len coefficients (a
+// constant at each call site so the polynomial is unrolled); _r[-1] must
+// be valid
+static inline void freqdem_demodulate_block_sse2(FREQDEM()    _q,
+                                                 TC *         _r,
+                                                 unsigned int _n,
+                                                 T *          _m,
+                                                 unsigned int _len)
+{
+    __m128 ref = _mm_set1_ps(_q->ref);
+    TC * p = _r - 1;    // previous samples
+    unsigned int i;
+    for (i=0; i+4<=_n; i+=4) {
+        __m128 cr, ci, pr, pi;
+        modem_load4_sse2(&_r[i],   &cr, &ci);
+        modem_load4_sse2(&p[i],    &pr, &pi);
+        __m128 re = _mm_add_ps(_mm_mul_ps(pr, cr), _mm_mul_ps(pi, ci));
+        __m128 im = _mm_sub_ps(_mm_mul_ps(pr, ci), _mm_mul_ps(pi, cr));
+        __m128 theta = modem_atan2_poly_sse2(im, re, _q->atan_poly, _len);
+        _mm_storeu_ps(&_m[i], _mm_mul_ps(theta, ref));
+    }
+
+    // remaining samples
+    for ( ; i<_n; i++) {
+        _q->r_prime = p[i];
+        FREQDEM(_demodulate)(_q, _r[i], &_m[i]);
+    }
+}
+#endif
+
 // demodulate block of samples
 //  _q      :   frequency demodulator object
 //  _r      :   received signal r(t) [size: _n x 1]
@@ -111,9 +205,27 @@ void FREQDEM(_demodulate_block)(FREQDEM()    _q,
                                 unsigned int _n,
                                 T *          _m)
 {
-    // TODO: implement more efficient method
+    if (_n == 0)
+        return;
+
+    // first sample uses stored state
+    FREQDEM(_demodulate)(_q, _r[0], &_m[0]);
+
+#if FREQDEM_USE_SSE2
+    switch (_q->atan_len) {
+    case 2: freqdem_demodulate_block_sse2(_q, _r+1, _n-1, _m+1, 2); break;
+    case 3: freqdem_demodulate_block_sse2(_q, _r+1, _n-1, _m+1, 3); break;
+    case 4: freqdem_demodulate_block_sse2(_q, _r+1, _n-1, _m+1, 4); break;
+    case 5: freqdem_demodulate_block_sse2(_q, _r+1, _n-1, _m+1, 5); break;
+    default:;
+    }
+    if (_q->atan_poly != NULL) {
+        _q->r_prime = _r[_n-1];
+        return;
+    }
+#endif
+
     unsigned int i;
-    for (i=0; i<_n; i++)
+    for (i=1; i<_n; i++)
         FREQDEM(_demodulate)(_q, _r[i], &_m[i]);
 }
-
@@ -23,6 +23,11 @@
 //
 // Frequency modulator
 //
+// The phase is accumulated with 16 bits of precision and the output taken
+// from a 1024-point sin|cos table. Blocks of samples accumulate four
+// phase increments at once with a prefix sum in SSE2 registers; the
+// result is identical to modulating sample by sample.
+//
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -31,6 +36,13 @@
 
 #include "liquid.internal.h"
 
+#if HAVE_EMMINTRIN_H && defined __SSE2__
+#include <emmintrin.h>  // SSE2
+#define FREQMOD_USE_SSE2 1
+#else
+#define FREQMOD_USE_SSE2 0
+#endif
+
 // freqmod
 struct FREQMOD(_s) {
     float kf;   // modulation factor for FM
@@ -131,9 +143,41 @@ void FREQMOD(_modulate_block)(FREQMOD()    _q,
                               unsigned int _n,
                               TC *         _s)
 {
-    // TODO: implement more efficient method
-    unsigned int i;
-    for (i=0; i<_n; i++)
+    unsigned int i=0;
+#if FREQMOD_USE_SSE2
+    __m128  ref   = _mm_set1_ps(_q->ref);
+    __m128  half  = _mm_set1_ps(0.5f);
+    __m128i phase = _mm_set1_epi32(_q->sincos_table_phase);
+    __m128i one   = _mm_set1_epi32(1);
+    int index[4];
+    for (i=0; i+4<=_n; i+=4) {
+        // phase increments: same as (int)roundf(ref*m), rounding half
+        // away from zero
+        __m128  v = _mm_mul_ps(ref, _mm_loadu_ps(&_m[i]));
+        __m128i t = _mm_cvttps_epi32(v);
+        __m128  d = _mm_sub_ps(v, _mm_cvtepi32_ps(t));
+        t = _mm_add_epi32(t, _mm_and_si128(_mm_castps_si128(_mm_cmpge_ps(d, half)), one));
+        t = _mm_sub_epi32(t, _mm_and_si128(_mm_castps_si128(_mm_cmple_ps(d, _mm_sub_ps(_mm_setzero_ps(),half))), one));
+
+        // accumulate: prefix sum across lanes plus previous phase
+        t = _mm_add_epi32(t, _mm_slli_si128(t, 4));
+        t = _mm_add_epi32(t, _mm_slli_si128(t, 8));
+        t = _mm_add_epi32(t, phase);
+        phase = _mm_shuffle_epi32(t, _MM_SHUFFLE(3,3,3,3));
+
+        // table indices (upper 10 of 16 bits, with rounding)
+        t = _mm_and_si128(_mm_srli_epi32(_mm_add_epi32(t, _mm_set1_epi32(0x0020)), 6),
+                          _mm_set1_epi32(0x03ff));
+        _mm_storeu_si128((__m128i*)index, t);
+        _s[i  ] = _q->sincos_table[index[0]];
+        _s[i+1] = _q->sincos_table[index[1]];
+        _s[i+2] = _q->sincos_table[index[2]];
+        _s[i+3] = _q->sincos_table[index[3]];
+    }
+    _q->sincos_table_phase = _mm_cvtsi128_si32(phase) & 0xffff;
+#endif
+
+    // remaining samples
+    for ( ; i<_n; i++)
         FREQMOD(_modulate)(_q, _m[i], &_s[i]);
 }
-
@@ -23,6 +23,13 @@
 //
 // M-ary frequency-shift keying demodulator
 //
+// Only the M tone bins of the K-point transform are needed to demodulate
+// a symbol; when correlating k samples against each bin is cheaper than
+// the K log2(K) transform, the bins are computed directly with a multi-
+// tone detector (tonedet) instead. The detector handles four bins per
+// vector operation, hence ceil(M/4)*k is compared against K log2(K). The
+// transform is still run on demand for the frequency error estimate.
+//
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -52,9 +59,11 @@ struct fskdem_s {
     float complex * buf_freq;   // FFT output buffer
     FFT_PLAN        fft;        // FFT object
     unsigned int *  demod_map;  // demodulation map
+    tonedet         bank;       // tone bank (NULL if using FFT)
 
     // state variables
     unsigned int    s_demod;    // demodulated symbol (used for frequency error)
+    int             fft_valid;  // 'buf_freq' holds transform of 'buf_time'
 };
 
 // create fskdem object (frequency demodulator)
@@ -145,6 +154,15 @@ fskdem fskdem_create(unsigned int _m,
     q->buf_freq = (float complex*) malloc(q->K * sizeof(float complex));
     q->fft = FFT_CREATE_PLAN(q->K, q->buf_time, q->buf_freq, FFT_DIR_FORWARD, 0);
 
+    // compute tone bins directly if cheaper than the full transform
+    q->bank = NULL;
+    if ((float)(((q->M+3)/4) * q->k) < (float)q->K * log2f((float)q->K)) {
+        float freqs[q->M];
+        for (i=0; i<q->M; i++)
+            freqs[i] = (float)q->demod_map[i] / (float)q->K;
+        q->bank = tonedet_create(q->k, q->M, freqs);
+    }
+
     // reset modem object
     fskdem_reset(q);
 
@@ -160,6 +178,8 @@ void fskdem_destroy(fskdem _q)
     free(_q->buf_time);
     free(_q->buf_freq);
     FFT_DESTROY_PLAN(_q->fft);
+    if (_q->bank != NULL)
+        tonedet_destroy(_q->bank);
 
     // free main object memory
     free(_q);
@@ -172,6 +192,8 @@ void fskdem_print(fskdem _q)
     printf("    bits/symbol     :   %u\n", _q->m);
     printf("    samples/symbol  :   %u\n", _q->k);
     printf("    bandwidth       :   %8.5f\n", _q->bandwidth);
+    printf("    FFT size        :   %u\n", _q->K);
+    printf("    engine          :   %s\n", _q->bank != NULL ? "tone bank" : "FFT");
 }
 
 // reset state
@@ -185,7 +207,8 @@ void fskdem_reset(fskdem _q)
     }
 
     // clear state variables
-    _q->s_demod = 0;
+    _q->s_demod   = 0;
+    _q->fft_valid = 1;
 }
 
 // demodulate symbol, assuming perfect symbol timing
@@ -197,6 +220,13 @@ unsigned int fskdem_demodulate(fskdem          _q,
     // copy input to internal time buffer
     memmove(_q->buf_time, _y, _q->k*sizeof(float complex));
 
+    // correlate against tone bins only; defer transform
+    if (_q->bank != NULL) {
+        _q->s_demod   = tonedet_detect(_q->bank, _y);
+        _q->fft_valid = 0;
+        return _q->s_demod;
+    }
+
     // compute transform, storing result in 'buf_freq'
     FFT_EXECUTE(_q->fft);
 
@@ -226,6 +256,12 @@ float fskdem_get_frequency_error(fskdem _q)
     // get index of peak bin
     //unsigned int index = _q->buf_freq[ _q->s_demod ];
 
+    // compute transform if demodulated with tone bank
+    if (!_q->fft_valid) {
+        FFT_EXECUTE(_q->fft);
+        _q->fft_valid = 1;
+    }
+
     // extract peak value of previous, post FFT index
     float vm = cabsf(_q->buf_freq[(_q->s_demod+_q->K-1)%_q->K]);  // previous
     float v0 = cabsf(_q->buf_freq[ _q->s_demod               ]);  // peak
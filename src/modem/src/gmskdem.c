@@ -23,11 +23,18 @@
 //
 // gmskdem.c : Gauss minimum-shift keying modem
 //
+// Symbols are demodulated in blocks: the phase differences of all samples
+// are computed at once (freqdem with a polynomial arctangent, vectorized
+// with SSE2 where available) into a linear buffer which follows the matched
+// filter history, and the filter output is computed only at the first
+// sample of each symbol.
+//
 
 #include <stdio.h>
 #include <assert.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "liquid.internal.h"
 
@@ -37,9 +44,23 @@
 
 #define GMSKDEM_USE_EQUALIZER   0
 
+// number of symbols demodulated per pass through the internal buffer
+#define GMSKDEM_BLOCK_LEN       (64)
+
+// phase error tolerance of phase differentiator [radians]; selects the
+// highest-order polynomial arctangent rather than cargf()
+#define GMSKDEM_FREQDEM_TOLERANCE   (1.5e-5f)
+
 void gmskdem_debug_print(gmskdem _q,
                          const char * _filename);
 
+// compute matched filter output for each symbol (at most
+// GMSKDEM_BLOCK_LEN symbols)
+void gmskdem_filter_block(gmskdem         _q,
+                          float complex * _x,
+                          unsigned int    _n,
+                          float *         _d);
+
 struct gmskdem_s {
     unsigned int k;         // samples/symbol
     unsigned int m;         // symbol delay
@@ -52,10 +73,12 @@ struct gmskdem_s {
     eqlms_rrrf eq;          // receiver matched filter/equalizer
     float k_inv;            // 1 / k
 #else
-    firfilt_rrrf filter;    // receiver matched filter
+    dotprod_rrrf dp;        // receiver matched filter (reversed taps)
+    float * buf;            // filter history and phase differences
+    float d_nom;            // nominal filter output
 #endif
 
-    float complex x_prime;  // received signal state
+    freqdem fdem;           // phase differentiator (received signal state)
 
     // demodulated symbols counter
     unsigned int num_symbols_demod;
@@ -109,10 +132,26 @@ gmskdem gmskdem_create(unsigned int _k,
     eqlms_rrrf_set_bw(q->eq, 0.01f);
     q->k_inv = 1.0f / (float)(q->k);
 #else
-    // create filter object
-    q->filter = firfilt_rrrf_create(q->h, q->h_len);
+    // create matched filter: dot product with reversed taps over a linear
+    // buffer of h_len-1 past and GMSKDEM_BLOCK_LEN*k new phase differences
+    float hr[q->h_len];
+    unsigned int i;
+    q->d_nom = 0.0f;
+    for (i=0; i<q->h_len; i++) {
+        hr[i] = q->h[q->h_len-i-1];
+        q->d_nom += q->h[i];
+    }
+    q->dp  = dotprod_rrrf_create(hr, q->h_len);
+    q->buf = (float*) malloc((q->h_len-1 + GMSKDEM_BLOCK_LEN*q->k)*sizeof(float));
+
+    // nominal output: phase advances by pi/(2k) each sample
+    q->d_nom *= M_PI / (2.0f*q->k);
 #endif
 
+    // phase differentiator with unity gain: 1/(2*pi*kf) = 1
+    q->fdem = freqdem_create(0.5f / M_PI);
+    freqdem_set_tolerance(q->fdem, GMSKDEM_FREQDEM_TOLERANCE);
+
     // reset modem state
     gmskdem_reset(q);
 
@@ -138,8 +177,10 @@ void gmskdem_destroy(gmskdem _q)
 #if GMSKDEM_USE_EQUALIZER
     eqlms_rrrf_destroy(_q->eq);
 #else
-    firfilt_rrrf_destroy(_q->filter);
+    dotprod_rrrf_destroy(_q->dp);
+    free(_q->buf);
 #endif
+    freqdem_destroy(_q->fdem);
 
     // free filter array
     free(_q->h);
@@ -162,7 +203,7 @@ void gmskdem_print(gmskdem _q)
 void gmskdem_reset(gmskdem _q)
 {
     // reset phase state
-    _q->x_prime = 0.0f;
+    freqdem_reset(_q->fdem);
 
     // set demod. counter to zero
     _q->num_symbols_demod = 0;
@@ -171,7 +212,7 @@ void gmskdem_reset(gmskdem _q)
 #if GMSKDEM_USE_EQUALIZER
     eqlms_rrrf_reset(_q->eq);
 #else
-    firfilt_rrrf_reset(_q->filter);
+    memset(_q->buf, 0x00, (_q->h_len-1)*sizeof(float));
 #endif
 }
 
@@ -197,58 +238,133 @@ void gmskdem_demodulate(gmskdem _q,
                         float complex * _x,
                         unsigned int * _s)
 {
-    // increment symbol counter
-    _q->num_symbols_demod++;
+    gmskdem_demodulate_block(_q, _x, 1, _s);
+}
 
-    // run matched filter
+// demodulate block of symbols
+//  _q      :   demodulator object
+//  _x      :   input samples [size: _n*k x 1]
+//  _n      :   number of symbols
+//  _s      :   output symbols [size: _n x 1]
+void gmskdem_demodulate_block(gmskdem         _q,
+                              float complex * _x,
+                              unsigned int    _n,
+                              unsigned int *  _s)
+{
     unsigned int i;
-    float phi;
-    float d_hat;
-    for (i=0; i<_q->k; i++) {
-        // compute phase difference
-        phi = cargf( conjf(_q->x_prime)*_x[i] );
-        _q->x_prime = _x[i];
+    float d[GMSKDEM_BLOCK_LEN];
+    while (_n > 0) {
+        unsigned int n = _n < GMSKDEM_BLOCK_LEN ? _n : GMSKDEM_BLOCK_LEN;
+        gmskdem_filter_block(_q, _x, n, d);
+
+        // make decisions
+        for (i=0; i<n; i++)
+            _s[i] = d[i] > 0.0f ? 1 : 0;
+
+        _x += n*_q->k;
+        _s += n;
+        _n -= n;
+    }
+}
 
-        // run through matched filter
+// demodulate block of symbols with soft-decision output; soft bits
+// saturate at the nominal filter output
+//  _q      :   demodulator object
+//  _x      :   input samples [size: _n*k x 1]
+//  _n      :   number of symbols
+//  _s      :   output symbols [size: _n x 1]
+//  _soft   :   output soft bits [size: _n x 1]
+void gmskdem_demodulate_soft_block(gmskdem         _q,
+                                   float complex * _x,
+                                   unsigned int    _n,
+                                   unsigned int *  _s,
+                                   unsigned char * _soft)
+{
 #if GMSKDEM_USE_EQUALIZER
-        eqlms_rrrf_push(_q->eq, phi);
+    float gain = 127.0f * (float)_q->k;
 #else
-        firfilt_rrrf_push(_q->filter, phi);
+    float gain = 127.0f / _q->d_nom;
 #endif
+    unsigned int i;
+    float d[GMSKDEM_BLOCK_LEN];
+    while (_n > 0) {
+        unsigned int n = _n < GMSKDEM_BLOCK_LEN ? _n : GMSKDEM_BLOCK_LEN;
+        gmskdem_filter_block(_q, _x, n, d);
+
+        // make decisions
+        for (i=0; i<n; i++) {
+            _s[i] = d[i] > 0.0f ? 1 : 0;
+            int v = (int)(127.0f + gain*d[i]);
+            _soft[i] = v < 0 ? 0 : (v > 255 ? 255 : v);
+        }
+
+        _x += n*_q->k;
+        _s += n;
+        _soft += n;
+        _n -= n;
+    }
+}
 
-#if DEBUG_GMSKDEM
-        // compute output
-        float d_tmp;
-#  if GMSKDEM_USE_EQUALIZER
-        eqlms_rrrf_execute(_q->eq, &d_tmp);
-#  else
-        firfilt_rrrf_execute(_q->filter, &d_tmp);
-#  endif
-        windowf_push(_q->debug_mfout, d_tmp);
-#endif
-
-        // decimate by k
-        if ( i != 0 ) continue;
-
+// compute matched filter output for each symbol
+//  _q      :   demodulator object
+//  _x      :   input samples [size: _n*k x 1]
+//  _n      :   number of symbols, at most GMSKDEM_BLOCK_LEN
+//  _d      :   filter output at first sample of each symbol [size: _n x 1]
+void gmskdem_filter_block(gmskdem         _q,
+                          float complex * _x,
+                          unsigned int    _n,
+                          float *         _d)
+{
+    unsigned int i;
 #if GMSKDEM_USE_EQUALIZER
-        // compute filter/equalizer output
-        eqlms_rrrf_execute(_q->eq, &d_hat);
+    float phi[_q->k];
+    for (i=0; i<_n; i++) {
+        // increment symbol counter
+        _q->num_symbols_demod++;
+
+        // compute phase difference
+        freqdem_demodulate_block(_q->fdem, &_x[i*_q->k], _q->k, phi);
+
+        // run through matched filter, decimating by k
+        unsigned int j;
+        for (j=0; j<_q->k; j++) {
+            eqlms_rrrf_push(_q->eq, phi[j]);
+#  if DEBUG_GMSKDEM
+            float d_tmp;
+            eqlms_rrrf_execute(_q->eq, &d_tmp);
+            windowf_push(_q->debug_mfout, d_tmp);
+#  endif
+            if (j == 0)
+                eqlms_rrrf_execute(_q->eq, &_d[i]);
+        }
+
+        // update equalizer, after appropriate delay
+        if (_q->num_symbols_demod >= 2*_q->m) {
+            // compute expected output, scaling by samples/symbol
+            float d_prime = _d[i] > 0 ? _q->k_inv : -_q->k_inv;
+            eqlms_rrrf_step(_q->eq, d_prime, _d[i]);
+        }
+    }
 #else
-        // compute filter output
-        firfilt_rrrf_execute(_q->filter, &d_hat);
-#endif
+    // compute phase differences following filter history
+    unsigned int h = _q->h_len - 1;
+    freqdem_demodulate_block(_q->fdem, _x, _n*_q->k, _q->buf + h);
+
+#  if DEBUG_GMSKDEM
+    for (i=0; i<_n*_q->k; i++) {
+        float d_tmp;
+        dotprod_rrrf_execute(_q->dp, _q->buf + i, &d_tmp);
+        windowf_push(_q->debug_mfout, d_tmp);
     }
+#  endif
 
-    // make decision
-    *_s = d_hat > 0.0f ? 1 : 0;
+    // matched filter output at first sample of each symbol
+    for (i=0; i<_n; i++)
+        dotprod_rrrf_execute(_q->dp, _q->buf + i*_q->k, &_d[i]);
 
-#if GMSKDEM_USE_EQUALIZER
-    // update equalizer, after appropriate delay
-    if (_q->num_symbols_demod >= 2*_q->m) {
-        // compute expected output, scaling by samples/symbol
-        float d_prime = d_hat > 0 ? _q->k_inv : -_q->k_inv;
-        eqlms_rrrf_step(_q->eq, d_prime, d_hat);
-    }
+    // retain filter history
+    memmove(_q->buf, _q->buf + _n*_q->k, h*sizeof(float));
+    _q->num_symbols_demod += _n;
 #endif
 }
 
@@ -65,6 +65,11 @@ MODEM() MODEM(_create_apsk)(unsigned int _bits_per_symbol)
     q->data.apsk.map = (unsigned char *) malloc(q->M*sizeof(unsigned char));
     memmove(q->data.apsk.map, apskdef->map, q->M*sizeof(unsigned char));
 
+    // reverse symbol map
+    q->data.apsk.demap = (unsigned char *) malloc(q->M*sizeof(unsigned char));
+    for (i=0; i<q->M; i++)
+        q->data.apsk.demap[ q->data.apsk.map[i] ] = i;
+
     // set modulation/demodulation function pointers
     q->modulate_func = &MODEM(_modulate_apsk);
     q->demodulate_func = &MODEM(_demodulate_apsk);
@@ -165,13 +170,7 @@ void MODEM(_demodulate_apsk)(MODEM()        _q,
     //assert(s_hat < _q->M);
 
     // reverse symbol mapping
-    unsigned int s_prime=0;
-    for (i=0; i<_q->M; i++) {
-        if ( _q->data.apsk.map[i] == s_hat) {
-            s_prime = i;
-            break;
-        }
-    }
+    unsigned int s_prime = _q->data.apsk.demap[s_hat];
 
 #if 0
     printf("              x : %12.8f + j*%12.8f\n", crealf(_x), cimagf(_x));
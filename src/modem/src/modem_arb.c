@@ -61,6 +61,11 @@ MODEM() MODEM(_create_arb)(unsigned int _bits_per_symbol)
     q->modulate_func   = &MODEM(_modulate_arb);
     q->demodulate_func = &MODEM(_demodulate_arb);
 
+    // search grid is built once the constellation is set
+    q->data.arb.grid = 0;
+    q->data.arb.cell = NULL;
+    q->data.arb.cand = NULL;
+
     return q;
 }
 
@@ -83,22 +88,28 @@ void MODEM(_demodulate_arb)(MODEM()        _q,
                             TC             _x,
                             unsigned int * _sym_out)
 {
-    //printf("modem_demodulate_arb() invoked with I=%d, Q=%d\n", x);
-    
-    // search for symbol nearest to received sample
+    // find grid cell of received sample (samples outside the grid fall
+    // into the edge cells which extend to infinity)
+    unsigned int G = _q->data.arb.grid;
+    T tx = (crealf(_x) - _q->data.arb.x0) * _q->data.arb.inv_dx;
+    T ty = (cimagf(_x) - _q->data.arb.y0) * _q->data.arb.inv_dy;
+    if (!(tx >= 0.0f)) tx = 0.0f; else if (tx > G-1) tx = G-1;
+    if (!(ty >= 0.0f)) ty = 0.0f; else if (ty > G-1) ty = G-1;
+    unsigned int c = (unsigned int)ty * G + (unsigned int)tx;
+
+    // search candidates of cell for symbol nearest to received sample
     unsigned int i;
-    unsigned int s=0;
-    T d;            // distance
-    T d_min = 0.0f; // minimum distance
-
-    for (i=0; i<_q->M; i++) {
+    unsigned int s = _q->data.arb.cand[_q->data.arb.cell[c]];
+    T d_min = 0.0f; // minimum distance (squared)
+    for (i=_q->data.arb.cell[c]; i<_q->data.arb.cell[c+1]; i++) {
         // compute distance from received symbol to constellation point
-        d = cabsf(_x - _q->symbol_map[i]);
+        TC e = _x - _q->symbol_map[_q->data.arb.cand[i]];
+        T  d = crealf(e)*crealf(e) + cimagf(e)*cimagf(e);
 
         // retain symbol with minimum distance
-        if ( i==0 || d < d_min ) {
+        if ( i==_q->data.arb.cell[c] || d < d_min ) {
             d_min = d;
-            s = i;
+            s = _q->data.arb.cand[i];
         }
     }
 
@@ -209,6 +220,8 @@ void MODEM(_arb_init)(MODEM()      _q,
     // scale modem to have unity energy
     MODEM(_arb_scale)(_q);
 
+    // build search grid
+    MODEM(_arb_init_index)(_q);
 }
 
 // initialize an arbitrary modem object on a file
@@ -250,6 +263,9 @@ void MODEM(_arb_init_file)(MODEM() _q,
 
     // scale modem to have unity energy
     MODEM(_arb_scale)(_q);
+
+    // build search grid
+    MODEM(_arb_init_index)(_q);
 }
 
 // scale arbitrary modem constellation points
@@ -289,68 +305,196 @@ void MODEM(_arb_balance_iq)(MODEM() _q)
     }
 }
 
-// demodulate arbitrary modem type (soft)
-void MODEM(_demodulate_soft_arb)(MODEM()         _q,
-                                 TC              _r,
-                                 unsigned int  * _s,
-                                 unsigned char * _soft_bits)
+// Build nearest-symbol search grid of arbitrary modem constellation
+//
+// The bounding box of the constellation is divided into a uniform grid of
+// G x G cells (about four per symbol); the cells on the edges extend to
+// infinity. For each cell the symbols which may be nearest to some point in
+// the cell are listed: bounded cells first discard symbols farther from the
+// cell than the smallest worst-case distance of any symbol, then symbols
+// which are closer to another symbol everywhere in the cell (linear test on
+// the corners) are dropped. A hard decision then only searches the few
+// candidates of one cell.
+//
+// The soft-demodulation table lists, for each symbol and each bit, the
+// nearest symbol with that bit flipped; these are found with a ring search
+// over the symbols located in each cell of the same grid.
+void MODEM(_arb_init_index)(MODEM() _q)
 {
-    unsigned int bps = _q->m;
     unsigned int M   = _q->M;
-
-    // gamma = 1/(2*sigma^2), approximate for constellation size
-    T gamma = 1.2f*_q->M;
-
-    unsigned int s=0;       // hard decision output
-    unsigned int k;         // bit index
-    unsigned int i;         // symbol index
-    T d;                // distance for this symbol
-    TC x_hat;    // re-modulated symbol
-
-    T dmin_0[bps];
-    T dmin_1[bps];
-    for (k=0; k<bps; k++) {
-        dmin_0[k] = 4.0f;
-        dmin_1[k] = 4.0f;
+    unsigned int bps = _q->m;
+    TC * c = _q->symbol_map;
+    unsigned int i, j, k;
+
+    // grid dimensions
+    unsigned int G = 2*(unsigned int)ceilf(sqrtf((float)M));
+    T xmin = crealf(c[0]), xmax = xmin;
+    T ymin = cimagf(c[0]), ymax = ymin;
+    for (i=1; i<M; i++) {
+        if (crealf(c[i]) < xmin) xmin = crealf(c[i]);
+        if (crealf(c[i]) > xmax) xmax = crealf(c[i]);
+        if (cimagf(c[i]) < ymin) ymin = cimagf(c[i]);
+        if (cimagf(c[i]) > ymax) ymax = cimagf(c[i]);
     }
-    T dmin = 0.0f;
+    T dx = (xmax - xmin) / G;
+    T dy = (ymax - ymin) / G;
+    if (dx < 1e-6f) dx = 1e-6f;
+    if (dy < 1e-6f) dy = 1e-6f;
+    _q->data.arb.grid   = G;
+    _q->data.arb.x0     = xmin;
+    _q->data.arb.y0     = ymin;
+    _q->data.arb.inv_dx = 1.0f / dx;
+    _q->data.arb.inv_dy = 1.0f / dy;
+
+    // (re-)allocate candidate lists for worst case, shrink when done
+    free(_q->data.arb.cell);
+    free(_q->data.arb.cand);
+    _q->data.arb.cell = (unsigned int*)  malloc((G*G+1)*sizeof(unsigned int));
+    _q->data.arb.cand = (unsigned char*) malloc(G*G*M*sizeof(unsigned char));
+
+    // symbol energies
+    T e[M];
+    for (i=0; i<M; i++)
+        e[i] = crealf(c[i])*crealf(c[i]) + cimagf(c[i])*cimagf(c[i]);
+
+    unsigned int n = 0;
+    unsigned int ix, iy;
+    for (iy=0; iy<G; iy++) {
+        for (ix=0; ix<G; ix++) {
+            _q->data.arb.cell[iy*G+ix] = n;
+
+            // cell boundaries and flags for unbounded sides
+            T x0 = xmin + ix*dx,  x1 = x0 + dx;
+            T y0 = ymin + iy*dy,  y1 = y0 + dy;
+            int x0_inf = ix==0, x1_inf = ix==G-1;
+            int y0_inf = iy==0, y1_inf = iy==G-1;
+            int bounded = !(x0_inf || x1_inf || y0_inf || y1_inf);
+
+            // smallest worst-case (squared) distance of any symbol
+            T u = 0.0f;
+            if (bounded) {
+                for (i=0; i<M; i++) {
+                    T ax = fabsf(crealf(c[i]) - x0) > fabsf(crealf(c[i]) - x1) ? crealf(c[i]) - x0 : crealf(c[i]) - x1;
+                    T ay = fabsf(cimagf(c[i]) - y0) > fabsf(cimagf(c[i]) - y1) ? cimagf(c[i]) - y0 : cimagf(c[i]) - y1;
+                    T d = ax*ax + ay*ay;
+                    if (i==0 || d < u) u = d;
+                }
+                u = u*(1.0f + 1e-4f) + 1e-9f;
+            }
 
-    for (i=0; i<M; i++) {
-        // compute distance from received symbol
-        x_hat = _q->symbol_map[i];
-        d = crealf( (_r-x_hat)*conjf(_r-x_hat) );
-
-        // set hard-decision...
-        if (d < dmin || i==0) {
-            s = i;
-            dmin = d;
+            for (i=0; i<M; i++) {
+                // discard symbols farther than all of u
+                if (bounded) {
+                    T ax = crealf(c[i]) < x0 ? x0 - crealf(c[i]) : (crealf(c[i]) > x1 ? crealf(c[i]) - x1 : 0.0f);
+                    T ay = cimagf(c[i]) < y0 ? y0 - cimagf(c[i]) : (cimagf(c[i]) > y1 ? cimagf(c[i]) - y1 : 0.0f);
+                    if (ax*ax + ay*ay > u)
+                        continue;
+                }
+
+                // symbol j is closer than i everywhere in the cell if
+                // 2 x.(c_i - c_j) < |c_i|^2 - |c_j|^2 at every corner x
+                int dominated = 0;
+                for (j=0; j<M && !dominated; j++) {
+                    if (j == i) continue;
+                    T a = 2.0f*(crealf(c[i]) - crealf(c[j]));
+                    T b = 2.0f*(cimagf(c[i]) - cimagf(c[j]));
+                    if ( (a > 0 && x1_inf) || (a < 0 && x0_inf) ) continue;
+                    if ( (b > 0 && y1_inf) || (b < 0 && y0_inf) ) continue;
+                    T v = (a > 0 ? a*x1 : a*x0) + (b > 0 ? b*y1 : b*y0);
+                    dominated = v < e[i] - e[j] - 1e-5f;
+                }
+                if (!dominated)
+                    _q->data.arb.cand[n++] = i;
+            }
         }
-
-        for (k=0; k<bps; k++) {
-            // strip bit
-            if ( (s >> (bps-k-1)) & 0x01 ) {
-                if (d < dmin_1[k]) dmin_1[k] = d;
-            } else {
-                if (d < dmin_0[k]) dmin_0[k] = d;
+    }
+    _q->data.arb.cell[G*G] = n;
+    _q->data.arb.cand = (unsigned char*) realloc(_q->data.arb.cand, n*sizeof(unsigned char));
+
+    // symbols located in each cell
+    unsigned int sym_cell[M];
+    unsigned int loc[G*G+1];
+    unsigned int sym[M];
+    for (i=0; i<=G*G; i++)
+        loc[i] = 0;
+    for (i=0; i<M; i++) {
+        ix = (unsigned int)((crealf(c[i]) - xmin) / dx);
+        iy = (unsigned int)((cimagf(c[i]) - ymin) / dy);
+        if (ix > G-1) ix = G-1;
+        if (iy > G-1) iy = G-1;
+        sym_cell[i] = iy*G + ix;
+        loc[sym_cell[i]+1]++;
+    }
+    for (i=0; i<G*G; i++)
+        loc[i+1] += loc[i];
+    unsigned int fill[G*G];
+    for (i=0; i<G*G; i++)
+        fill[i] = loc[i];
+    for (i=0; i<M; i++)
+        sym[fill[sym_cell[i]]++] = i;
+
+    // soft-demodulation neighbors: nearest symbol with each bit flipped;
+    // symbols in ring r of cells around the cell of symbol i are at least
+    // (r-1) cell widths away
+    free(_q->demod_soft_neighbors);
+    _q->demod_soft_p = bps;
+    _q->demod_soft_neighbors = (unsigned char*)malloc(M*bps*sizeof(unsigned char));
+    T h = dx < dy ? dx : dy;
+    for (i=0; i<M; i++) {
+        T dmin[bps];
+        for (k=0; k<bps; k++)
+            dmin[k] = -1.0f;
+        int cx = sym_cell[i] % G;
+        int cy = sym_cell[i] / G;
+        int r;
+        for (r=0; r<(int)G; r++) {
+            // stop once no closer symbol can be found in this ring
+            T lb = r > 0 ? (r-1)*h : 0.0f;
+            for (k=0; k<bps; k++) {
+                if (dmin[k] < 0 || dmin[k] > lb*lb)
+                    break;
+            }
+            if (k == bps)
+                break;
+
+            int x, y;
+            for (y=cy-r; y<=cy+r; y++) {
+                if (y < 0 || y >= (int)G) continue;
+                for (x=cx-r; x<=cx+r; x++) {
+                    if (x < 0 || x >= (int)G) continue;
+                    if (abs(x-cx) != r && abs(y-cy) != r) continue;
+                    for (j=loc[y*G+x]; j<loc[y*G+x+1]; j++) {
+                        unsigned int s = sym[j];
+                        TC err = c[s] - c[i];
+                        T d = crealf(err)*crealf(err) + cimagf(err)*cimagf(err);
+                        for (k=0; k<bps; k++) {
+                            if ( ((s ^ i) >> (bps-k-1)) & 1 ) {
+                                if (dmin[k] < 0 || d < dmin[k]) {
+                                    dmin[k] = d;
+                                    _q->demod_soft_neighbors[i*bps + k] = s;
+                                }
+                            }
+                        }
+                    }
+                }
             }
         }
     }
+}
 
-    // make assignments
-    for (k=0; k<bps; k++) {
-        int soft_bit = ((dmin_0[k] - dmin_1[k])*gamma)*16 + 127;
-        if (soft_bit > 255) soft_bit = 255;
-        if (soft_bit <   0) soft_bit = 0;
-        _soft_bits[k] = (unsigned char)soft_bit;
-    }
+// demodulate arbitrary modem type (soft)
+void MODEM(_demodulate_soft_arb)(MODEM()         _q,
+                                 TC              _r,
+                                 unsigned int  * _s,
+                                 unsigned char * _soft_bits)
+{
+    // hard decision from search grid; this stores re-modulated sample
+    unsigned int s;
+    MODEM(_demodulate_arb)(_q, _r, &s);
 
-    // hard decision
+    // compute soft bits from nearest neighbors of hard decision
+    MODEM(_demodulate_soft_table_llr)(_q, _r, s, _q->x_hat, _soft_bits);
 
     // set hard output symbol
     *_s = s;
-
-    // re-modulate symbol and store state
-    MODEM(_modulate_arb)(_q, *_s, &_q->x_hat);
-    _q->r = _r;
 }
-
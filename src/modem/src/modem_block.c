@@ -0,0 +1,607 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+//
+// modem_block.c : block modulation/demodulation
+//
+// Block methods run the slicer of a scheme over an entire array of
+// samples. QAM is sliced by successive approximation on interleaved
+// in-phase/quadrature lanes; PSK and APSK use a polynomial arctangent
+// rather than cargf(). The SSE2 kernels and their scalar fall-backs
+// perform the same operations in the same order so results do not depend
+// on the instruction set. QAM soft bits are computed in closed form on
+// each axis. Schemes without a block kernel (DPSK, ASK, OOK, 'square' QAM
+// and arbitrary constellations) demodulate symbol by symbol.
+//
+// The demodulator state (received and estimated sample) is only updated
+// for the last sample of a block; use the per-symbol methods when the
+// phase error or EVM of every symbol is needed.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "liquid.internal.h"
+
+#if HAVE_EMMINTRIN_H && defined __SSE2__
+#include <emmintrin.h>  // SSE2
+#define MODEM_BLOCK_USE_SSE2 1
+#else
+#define MODEM_BLOCK_USE_SSE2 0
+#endif
+
+// odd arctangent polynomials on [0,1] in powers of a^2, in order of
+// increasing accuracy, and their maximum phase error [radians]; the last
+// is Abramowitz & Stegun 4.4.49. Shared with freqdem.
+static const float modem_atan_tol[4] = {5.0e-3f, 6.2e-4f, 8.5e-5f, 1.5e-5f};
+static const T modem_atan_poly[4][5] = {
+    { 0.9723937f, -0.1919470f},
+    { 0.9953579f, -0.2886898f,  0.0793386f},
+    { 0.9992138f, -0.3211749f,  0.1462642f, -0.0389863f},
+    { 0.9998660f, -0.3302995f,  0.1801410f, -0.0851330f,  0.0208351f}};
+
+// four-quadrant arctangent from polynomial approximation, in [-pi,pi]
+T MODEM(_atan2)(T _y,
+                T _x)
+{
+    return MODEM(_atan2_poly)(_y, _x, modem_atan_poly[3], 5);
+}
+
+// four-quadrant arctangent from odd polynomial on [0,1]
+//  _y, _x  :   input coordinates
+//  _c      :   polynomial coefficients, a*(c[0] + c[1]*a^2 + ...)
+//  _n      :   number of coefficients
+T MODEM(_atan2_poly)(T            _y,
+                     T            _x,
+                     const T *    _c,
+                     unsigned int _n)
+{
+    T ax = fabsf(_x);
+    T ay = fabsf(_y);
+    T mx = ax > ay ? ax : ay;
+    T mn = ax > ay ? ay : ax;
+    T a  = mx > 0.0f ? mn / mx : 0.0f;
+    T s  = a*a;
+    T t  = _c[_n-1];
+    unsigned int k;
+    for (k=_n-1; k>0; k--)
+        t = t*s + _c[k-1];
+    t *= a;
+    if (ay > ax)   t = (T)M_PI_2 - t;
+    if (_x < 0.0f) t = (T)M_PI   - t;
+    if (_y < 0.0f) t = -t;
+    return t;
+}
+
+#if MODEM_BLOCK_USE_SSE2
+// four-quadrant arctangent of four values at once; identical to
+// MODEM(_atan2_poly)() for each lane
+static inline __m128 modem_atan2_poly_sse2(__m128       _y,
+                                           __m128       _x,
+                                           const T *    _c,
+                                           unsigned int _n)
+{
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128 zero = _mm_setzero_ps();
+    __m128 ax = _mm_andnot_ps(sign, _x);
+    __m128 ay = _mm_andnot_ps(sign, _y);
+    __m128 mx = _mm_max_ps(ax, ay);
+    __m128 mn = _mm_min_ps(ax, ay);
+    __m128 a  = _mm_and_ps(_mm_div_ps(mn, mx), _mm_cmpgt_ps(mx, zero));
+    __m128 s  = _mm_mul_ps(a, a);
+    __m128 t  = _mm_set1_ps(_c[_n-1]);
+    unsigned int k;
+    for (k=_n-1; k>0; k--)
+        t = _mm_add_ps(_mm_mul_ps(t, s), _mm_set1_ps(_c[k-1]));
+    t = _mm_mul_ps(t, a);
+
+    // octant, quadrant and sign corrections
+    __m128 m;
+    m = _mm_cmpgt_ps(ay, ax);
+    t = _mm_or_ps(_mm_and_ps(m, _mm_sub_ps(_mm_set1_ps((T)M_PI_2), t)), _mm_andnot_ps(m, t));
+    m = _mm_cmplt_ps(_x, zero);
+    t = _mm_or_ps(_mm_and_ps(m, _mm_sub_ps(_mm_set1_ps((T)M_PI), t)), _mm_andnot_ps(m, t));
+    m = _mm_cmplt_ps(_y, zero);
+    return _mm_xor_ps(t, _mm_and_ps(m, sign));
+}
+
+// MODEM(_atan2)() for each of four lanes
+static inline __m128 modem_atan2_sse2(__m128 _y,
+                                      __m128 _x)
+{
+    return modem_atan2_poly_sse2(_y, _x, modem_atan_poly[3], 5);
+}
+
+// load four complex samples as separate real and imaginary vectors
+static inline void modem_load4_sse2(const TC * _x,
+                                    __m128 *   _re,
+                                    __m128 *   _im)
+{
+    __m128 v0 = _mm_loadu_ps((const float*)&_x[0]);
+    __m128 v1 = _mm_loadu_ps((const float*)&_x[2]);
+    *_re = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2,0,2,0));
+    *_im = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3,1,3,1));
+}
+
+// store four 32-bit values (each less than 256) as bytes
+static inline void modem_store4_sse2(__m128i         _v,
+                                     unsigned char * _y)
+{
+    _v = _mm_packs_epi32(_v, _v);
+    _v = _mm_packus_epi16(_v, _v);
+    int b = _mm_cvtsi128_si32(_v);
+    memmove(_y, &b, 4);
+}
+#endif
+
+// modulate block of symbols
+//  _q  :   modem object
+//  _s  :   input symbols [size: _n x 1]
+//  _n  :   number of symbols
+//  _y  :   output samples [size: _n x 1]
+void MODEM(_modulate_block)(MODEM()               _q,
+                            const unsigned char * _s,
+                            unsigned int          _n,
+                            TC *                  _y)
+{
+    unsigned int i;
+    for (i=0; i<_n; i++) {
+        if (_s[i] >= _q->M) {
+            fprintf(stderr,"error: modem_modulate_block(), input symbol exceeds constellation size\n");
+            exit(1);
+        }
+    }
+
+    if (_q->modulate_using_map) {
+        // look-up table
+        for (i=0; i<_n; i++)
+            _y[i] = _q->symbol_map[_s[i]];
+    } else {
+        // scheme-specific method (differential schemes keep state)
+        for (i=0; i<_n; i++)
+            _q->modulate_func(_q, _s[i], &_y[i]);
+    }
+}
+
+// demodulate block of samples (hard decisions)
+//  _q  :   modem object
+//  _x  :   input samples [size: _n x 1]
+//  _n  :   number of samples
+//  _s  :   output symbols [size: _n x 1]
+void MODEM(_demodulate_block)(MODEM()         _q,
+                              const TC *      _x,
+                              unsigned int    _n,
+                              unsigned char * _s)
+{
+    if (_n == 0)
+        return;
+
+    unsigned int i;
+    unsigned int sym;
+    if (liquid_modem_is_qam(_q->scheme)) {
+        MODEM(_demodulate_block_qam)(_q, _x, _n, _s);
+    } else if (liquid_modem_is_psk(_q->scheme)) {
+        MODEM(_demodulate_block_psk)(_q, _x, _n, _s);
+    } else if (liquid_modem_is_apsk(_q->scheme)) {
+        MODEM(_demodulate_block_apsk)(_q, _x, _n, _s);
+    } else if (_q->scheme == LIQUID_MODEM_BPSK) {
+        for (i=0; i<_n; i++)
+            _s[i] = crealf(_x[i]) > 0 ? 0 : 1;
+    } else if (_q->scheme == LIQUID_MODEM_QPSK) {
+        for (i=0; i<_n; i++)
+            _s[i] = (crealf(_x[i]) > 0 ? 0 : 1) + (cimagf(_x[i]) > 0 ? 0 : 2);
+    } else {
+        // no block kernel; demodulate one sample at a time
+        for (i=0; i<_n; i++) {
+            _q->demodulate_func(_q, _x[i], &sym);
+            _s[i] = sym;
+        }
+        return;
+    }
+
+    // store state of last sample
+    _q->r = _x[_n-1];
+    MODEM(_modulate)(_q, _s[_n-1], &_q->x_hat);
+}
+
+// demodulate block of samples (soft decisions)
+//  _q          :   modem object
+//  _x          :   input samples [size: _n x 1]
+//  _n          :   number of samples
+//  _s          :   output hard symbols [size: _n x 1]
+//  _soft_bits  :   output soft bits [size: _n*bps x 1]
+void MODEM(_demodulate_soft_block)(MODEM()         _q,
+                                   const TC *      _x,
+                                   unsigned int    _n,
+                                   unsigned char * _s,
+                                   unsigned char * _soft_bits)
+{
+    if (_n == 0)
+        return;
+
+    unsigned int bps = _q->m;
+    unsigned int i;
+    unsigned int sym;
+    switch (_q->scheme) {
+    case LIQUID_MODEM_BPSK:
+        MODEM(_demodulate_soft_block_bpsk)(_q, _x, _n, _s, _soft_bits);
+        break;
+    case LIQUID_MODEM_QPSK:
+        MODEM(_demodulate_soft_block_qpsk)(_q, _x, _n, _s, _soft_bits);
+        break;
+    default:
+        if (liquid_modem_is_qam(_q->scheme)) {
+            // hard decisions, then closed-form soft bits
+            MODEM(_demodulate_block)(_q, _x, _n, _s);
+            MODEM(_demodulate_soft_block_qam)(_q, _x, _n, _soft_bits);
+            return;
+        }
+        if (!liquid_modem_is_psk(_q->scheme) &&
+            !liquid_modem_is_apsk(_q->scheme))
+        {
+            // no block kernel; demodulate one sample at a time
+            for (i=0; i<_n; i++) {
+                MODEM(_demodulate_soft)(_q, _x[i], &sym, &_soft_bits[i*bps]);
+                _s[i] = sym;
+            }
+            return;
+        }
+
+        // slice entire block, then evaluate nearest neighbors of each
+        // decision (or simply unpack hard decisions)
+        MODEM(_demodulate_block)(_q, _x, _n, _s);
+        if (_q->demod_soft_neighbors != NULL && _q->demod_soft_p != 0) {
+            for (i=0; i<_n; i++)
+                MODEM(_demodulate_soft_table_llr)(_q, _x[i], _s[i],
+                        _q->symbol_map[_s[i]], &_soft_bits[i*bps]);
+        } else {
+            for (i=0; i<_n; i++)
+                liquid_unpack_soft_bits(_s[i], bps, &_soft_bits[i*bps]);
+        }
+        return;
+    }
+
+    // store state of last sample
+    _q->r = _x[_n-1];
+    MODEM(_modulate)(_q, _s[_n-1], &_q->x_hat);
+}
+
+// demodulate block of QAM samples by successive approximation
+void MODEM(_demodulate_block_qam)(MODEM()         _q,
+                                  const TC *      _x,
+                                  unsigned int    _n,
+                                  unsigned char * _s)
+{
+    unsigned int m_i = _q->data.qam.m_i;
+    unsigned int m_q = _q->data.qam.m_q;
+    unsigned int i = 0;
+    unsigned int j;
+
+#if MODEM_BLOCK_USE_SSE2
+    // thresholds for each step of in-phase and quadrature lanes; the
+    // quadrature component of rectangular QAM has one fewer bit so its
+    // first step has no threshold (and its first bit is masked off)
+    __m128 ref[MAX_MOD_BITS_PER_SYMBOL];
+    for (j=0; j<m_i; j++) {
+        T r_i = _q->ref[m_i-j-1];
+        T r_q = j < m_i-m_q ? 0.0f : r_i;
+        ref[j] = _mm_setr_ps(r_i, r_q, r_i, r_q);
+    }
+    const __m128  zero = _mm_setzero_ps();
+    const __m128  sign = _mm_set1_ps(-0.0f);
+    const __m128i mask = _mm_setr_epi32(_q->data.qam.M_i-1, _q->data.qam.M_q-1,
+                                        _q->data.qam.M_i-1, _q->data.qam.M_q-1);
+    const __m128i sh   = _mm_cvtsi32_si128(m_q);
+
+    for ( ; i+4<=_n; i+=4) {
+        // interleaved [I,Q,I,Q] lanes of two samples per register
+        __m128  v0 = _mm_loadu_ps((const float*)&_x[i  ]);
+        __m128  v1 = _mm_loadu_ps((const float*)&_x[i+2]);
+        __m128i s0 = _mm_setzero_si128();
+        __m128i s1 = _mm_setzero_si128();
+        for (j=0; j<m_i; j++) {
+            __m128 c0 = _mm_cmpgt_ps(v0, zero);
+            __m128 c1 = _mm_cmpgt_ps(v1, zero);
+            s0 = _mm_sub_epi32(_mm_slli_epi32(s0,1), _mm_castps_si128(c0));
+            s1 = _mm_sub_epi32(_mm_slli_epi32(s1,1), _mm_castps_si128(c1));
+            v0 = _mm_add_ps(v0, _mm_xor_ps(ref[j], _mm_and_ps(c0, sign)));
+            v1 = _mm_add_ps(v1, _mm_xor_ps(ref[j], _mm_and_ps(c1, sign)));
+        }
+
+        // 'decode' (gray encoding) and combine components
+        s0 = _mm_and_si128(s0, mask);
+        s1 = _mm_and_si128(s1, mask);
+        s0 = _mm_xor_si128(s0, _mm_srli_epi32(s0,1));
+        s1 = _mm_xor_si128(s1, _mm_srli_epi32(s1,1));
+        __m128i si = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(s0),
+                                                     _mm_castsi128_ps(s1), _MM_SHUFFLE(2,0,2,0)));
+        __m128i sq = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(s0),
+                                                     _mm_castsi128_ps(s1), _MM_SHUFFLE(3,1,3,1)));
+        modem_store4_sse2(_mm_or_si128(_mm_sll_epi32(si, sh), sq), &_s[i]);
+    }
+#endif
+
+    // remaining samples
+    unsigned int s_i;
+    unsigned int s_q;
+    T res;
+    for ( ; i<_n; i++) {
+        MODEM(_demodulate_linear_array_ref)(crealf(_x[i]), m_i, _q->ref, &s_i, &res);
+        MODEM(_demodulate_linear_array_ref)(cimagf(_x[i]), m_q, _q->ref, &s_q, &res);
+        _s[i] = (gray_encode(s_i) << m_q) + gray_encode(s_q);
+    }
+}
+
+// closed-form soft bits of block of QAM samples; each axis as in
+// MODEM(_demodulate_soft_pam)()
+void MODEM(_demodulate_soft_block_qam)(MODEM()         _q,
+                                       const TC *      _x,
+                                       unsigned int    _n,
+                                       unsigned char * _soft_bits)
+{
+    unsigned int m_i = _q->data.qam.m_i;
+    unsigned int m_q = _q->data.qam.m_q;
+    unsigned int bps = _q->m;
+    T gamma = 1.2f*_q->M*_q->llr_scale;
+    T c = 4.0f*_q->data.qam.alpha*gamma*16;
+    unsigned int i = 0;
+
+#if MODEM_BLOCK_USE_SSE2
+    const __m128 vc   = _mm_set1_ps(c);
+    const __m128 v127 = _mm_set1_ps(127.0f);
+    const __m128 vmax = _mm_set1_ps(255.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    unsigned char b[4*MAX_MOD_BITS_PER_SYMBOL];   // [bit][sample]
+    unsigned int j;
+    unsigned int k;
+    for ( ; i+4<=_n; i+=4) {
+        __m128 re, im;
+        modem_load4_sse2(&_x[i], &re, &im);
+
+        // in-phase bits, then quadrature bits
+        for (k=0; k<m_i; k++) {
+            if (k > 0)
+                re = _mm_sub_ps(_mm_set1_ps(_q->ref[m_i-k]), _mm_andnot_ps(sign, re));
+            __m128 v = _mm_add_ps(_mm_mul_ps(re, vc), v127);
+            v = _mm_min_ps(_mm_max_ps(v, zero), vmax);
+            modem_store4_sse2(_mm_cvttps_epi32(v), &b[4*k]);
+        }
+        for (k=0; k<m_q; k++) {
+            if (k > 0)
+                im = _mm_sub_ps(_mm_set1_ps(_q->ref[m_q-k]), _mm_andnot_ps(sign, im));
+            __m128 v = _mm_add_ps(_mm_mul_ps(im, vc), v127);
+            v = _mm_min_ps(_mm_max_ps(v, zero), vmax);
+            modem_store4_sse2(_mm_cvttps_epi32(v), &b[4*(m_i+k)]);
+        }
+
+        // re-order as [sample][bit]
+        for (j=0; j<4; j++) {
+            for (k=0; k<bps; k++)
+                _soft_bits[(i+j)*bps + k] = b[4*k + j];
+        }
+    }
+#endif
+
+    // remaining samples
+    for ( ; i<_n; i++) {
+        MODEM(_demodulate_soft_pam)(crealf(_x[i]), m_i, _q->ref, c, &_soft_bits[i*bps]);
+        MODEM(_demodulate_soft_pam)(cimagf(_x[i]), m_q, _q->ref, c, &_soft_bits[i*bps + m_i]);
+    }
+}
+
+// demodulate block of PSK samples: nearest phase index of polynomial
+// arctangent, k = round(theta*M/(2*pi)) mod M
+void MODEM(_demodulate_block_psk)(MODEM()         _q,
+                                  const TC *      _x,
+                                  unsigned int    _n,
+                                  unsigned char * _s)
+{
+    T scale  = (T)(_q->M) / (2.0f*M_PI);
+    T offset = 0.5f + (T)(_q->M);   // keeps argument positive for truncation
+    unsigned int i = 0;
+
+#if MODEM_BLOCK_USE_SSE2
+    const __m128  vscale  = _mm_set1_ps(scale);
+    const __m128  voffset = _mm_set1_ps(offset);
+    const __m128i mask    = _mm_set1_epi32(_q->M-1);
+    for ( ; i+4<=_n; i+=4) {
+        __m128 re, im;
+        modem_load4_sse2(&_x[i], &re, &im);
+        __m128  theta = modem_atan2_sse2(im, re);
+        __m128i k = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(theta, vscale), voffset));
+        k = _mm_and_si128(k, mask);
+        modem_store4_sse2(_mm_xor_si128(k, _mm_srli_epi32(k,1)), &_s[i]);
+    }
+#endif
+
+    // remaining samples
+    for ( ; i<_n; i++) {
+        T theta = MODEM(_atan2)(cimagf(_x[i]), crealf(_x[i]));
+        unsigned int k = (unsigned int)(theta*scale + offset) & (_q->M-1);
+        _s[i] = gray_encode(k);
+    }
+}
+
+// demodulate block of APSK samples: ring from squared magnitude, nearest
+// point on ring from polynomial arctangent
+void MODEM(_demodulate_block_apsk)(MODEM()         _q,
+                                   const TC *      _x,
+                                   unsigned int    _n,
+                                   unsigned char * _s)
+{
+    // per-ring constants
+    unsigned int num_levels = _q->data.apsk.num_levels;
+    T            r2_slicer[8];  // squared slicer radii
+    T            scale[8];      // points per radian
+    unsigned int offset[8];     // index of first point on ring
+    unsigned int i;
+    unsigned int t = 0;
+    for (i=0; i<num_levels; i++) {
+        if (i < num_levels-1)
+            r2_slicer[i] = _q->data.apsk.r_slicer[i]*_q->data.apsk.r_slicer[i];
+        scale[i]  = (T)(_q->data.apsk.p[i]) / (2.0f*M_PI);
+        offset[i] = t;
+        t += _q->data.apsk.p[i];
+    }
+
+    T r2[4];
+    T theta[4];
+    unsigned int k;
+    for (i=0; i<_n; i+=4) {
+        unsigned int num = _n - i < 4 ? _n - i : 4;
+#if MODEM_BLOCK_USE_SSE2
+        if (num == 4) {
+            __m128 re, im;
+            modem_load4_sse2(&_x[i], &re, &im);
+            _mm_storeu_ps(r2,    _mm_add_ps(_mm_mul_ps(re,re), _mm_mul_ps(im,im)));
+            _mm_storeu_ps(theta, modem_atan2_sse2(im, re));
+        } else
+#endif
+        {
+            for (k=0; k<num; k++) {
+                T re = crealf(_x[i+k]);
+                T im = cimagf(_x[i+k]);
+                r2[k]    = re*re + im*im;
+                theta[k] = MODEM(_atan2)(im, re);
+            }
+        }
+
+        for (k=0; k<num; k++) {
+            // ring index is number of slicer radii exceeded
+            unsigned int j;
+            unsigned int p = 0;
+            for (j=0; j<num_levels-1; j++)
+                p += r2[k] >= r2_slicer[j] ? 1 : 0;
+
+            // closest point on ring
+            T phi = theta[k] < 0.0f ? theta[k] + 2.0f*M_PI : theta[k];
+            int   np = (int)_q->data.apsk.p[p];
+            int   s  = (int)floorf((phi - _q->data.apsk.phi[p])*scale[p] + 0.5f) % np;
+            if (s < 0) s += np;
+
+            // reverse symbol mapping
+            _s[i+k] = _q->data.apsk.demap[offset[p] + s];
+        }
+    }
+}
+
+// demodulate block of BPSK samples (soft)
+void MODEM(_demodulate_soft_block_bpsk)(MODEM()         _q,
+                                        const TC *      _x,
+                                        unsigned int    _n,
+                                        unsigned char * _s,
+                                        unsigned char * _soft_bits)
+{
+    // same scaling as MODEM(_demodulate_soft_bpsk)()
+    T gamma = 4.0f*_q->llr_scale;
+    unsigned int i = 0;
+#if MODEM_BLOCK_USE_SSE2
+    const __m128 vgamma = _mm_set1_ps(gamma);
+    const __m128 vm2    = _mm_set1_ps(-2.0f);
+    const __m128 v16    = _mm_set1_ps(16.0f);
+    const __m128 v127   = _mm_set1_ps(127.0f);
+    const __m128 vmax   = _mm_set1_ps(255.0f);
+    const __m128 zero   = _mm_setzero_ps();
+    for ( ; i+4<=_n; i+=4) {
+        __m128 re, im;
+        modem_load4_sse2(&_x[i], &re, &im);
+        __m128 llr = _mm_mul_ps(_mm_mul_ps(vm2, re), vgamma);
+        __m128 v   = _mm_add_ps(_mm_mul_ps(llr, v16), v127);
+        v = _mm_min_ps(_mm_max_ps(v, zero), vmax);
+        modem_store4_sse2(_mm_cvttps_epi32(v), &_soft_bits[i]);
+
+        // hard decisions
+        __m128i h = _mm_castps_si128(_mm_cmpgt_ps(re, zero));
+        modem_store4_sse2(_mm_add_epi32(h, _mm_set1_epi32(1)), &_s[i]);
+    }
+#endif
+    for ( ; i<_n; i++) {
+        T   llr = -2.0f * crealf(_x[i]) * gamma;
+        int soft_bit = llr*16 + 127;
+        if (soft_bit > 255) soft_bit = 255;
+        if (soft_bit <   0) soft_bit = 0;
+        _soft_bits[i] = (unsigned char)soft_bit;
+        _s[i] = crealf(_x[i]) > 0 ? 0 : 1;
+    }
+}
+
+// demodulate block of QPSK samples (soft)
+void MODEM(_demodulate_soft_block_qpsk)(MODEM()         _q,
+                                        const TC *      _x,
+                                        unsigned int    _n,
+                                        unsigned char * _s,
+                                        unsigned char * _soft_bits)
+{
+    // same scaling as MODEM(_demodulate_soft_qpsk)()
+    T gamma = 5.8f*_q->llr_scale;
+    unsigned int i = 0;
+#if MODEM_BLOCK_USE_SSE2
+    const __m128 vgamma = _mm_set1_ps(gamma);
+    const __m128 vm2    = _mm_set1_ps(-2.0f);
+    const __m128 v16    = _mm_set1_ps(16.0f);
+    const __m128 v127   = _mm_set1_ps(127.0f);
+    const __m128 vmax   = _mm_set1_ps(255.0f);
+    const __m128 zero   = _mm_setzero_ps();
+    for ( ; i+4<=_n; i+=4) {
+        // soft bits in order [Q,I] for each sample
+        __m128 v0 = _mm_loadu_ps((const float*)&_x[i  ]);
+        __m128 v1 = _mm_loadu_ps((const float*)&_x[i+2]);
+        __m128 w0 = _mm_shuffle_ps(v0, v0, _MM_SHUFFLE(2,3,0,1));
+        __m128 w1 = _mm_shuffle_ps(v1, v1, _MM_SHUFFLE(2,3,0,1));
+        w0 = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(_mm_mul_ps(vm2, w0), vgamma), v16), v127);
+        w1 = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(_mm_mul_ps(vm2, w1), vgamma), v16), v127);
+        w0 = _mm_min_ps(_mm_max_ps(w0, zero), vmax);
+        w1 = _mm_min_ps(_mm_max_ps(w1, zero), vmax);
+        __m128i b = _mm_packs_epi32(_mm_cvttps_epi32(w0), _mm_cvttps_epi32(w1));
+        _mm_storel_epi64((__m128i*)&_soft_bits[2*i], _mm_packus_epi16(b, b));
+
+        // hard decisions
+        __m128 re = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2,0,2,0));
+        __m128 im = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3,1,3,1));
+        __m128i h = _mm_add_epi32(_mm_castps_si128(_mm_cmpgt_ps(re, zero)),
+                    _mm_add_epi32(_mm_castps_si128(_mm_cmpgt_ps(im, zero)),
+                                  _mm_castps_si128(_mm_cmpgt_ps(im, zero))));
+        modem_store4_sse2(_mm_add_epi32(h, _mm_set1_epi32(3)), &_s[i]);
+    }
+#endif
+    for ( ; i<_n; i++) {
+        T   llr;
+        int soft_bit;
+
+        llr = -2.0f * cimagf(_x[i]) * gamma;
+        soft_bit = llr*16 + 127;
+        if (soft_bit > 255) soft_bit = 255;
+        if (soft_bit <   0) soft_bit = 0;
+        _soft_bits[2*i+0] = (unsigned char)soft_bit;
+
+        llr = -2.0f * crealf(_x[i]) * gamma;
+        soft_bit = llr*16 + 127;
+        if (soft_bit > 255) soft_bit = 255;
+        if (soft_bit <   0) soft_bit = 0;
+        _soft_bits[2*i+1] = (unsigned char)soft_bit;
+
+        _s[i] = (crealf(_x[i]) > 0 ? 0 : 1) + (cimagf(_x[i]) > 0 ? 0 : 2);
+    }
+}
@@ -77,7 +77,7 @@ void MODEM(_demodulate_soft_bpsk)(MODEM()         _q,
                                   unsigned char * _soft_bits)
 {
     // gamma = 1/(2*sigma^2), approximate for constellation size
-    T gamma = 4.0f;
+    T gamma = 4.0f*_q->llr_scale;
 
     // approximate log-likelihood ratio
     T LLR = -2.0f * crealf(_x) * gamma;
@@ -64,6 +64,7 @@ struct MODEM(_s)
     // demodulation
     TC r;                // received state vector
     TC x_hat;            // estimated symbol (demodulator)
+    T llr_scale;         // soft-decision scaling relative to default
 
     // common data structure shared between specific modem types
     union {
@@ -102,6 +103,7 @@ struct MODEM(_s)
             T r_slicer[8];              // slicer radii of levels
             T phi[8];                   // phase offset of levels
             unsigned char * map;        // symbol mapping (allocated)
+            unsigned char * demap;      // reverse symbol mapping (allocated)
         } apsk;
 
         // 'square' 32-QAM
@@ -113,6 +115,18 @@ struct MODEM(_s)
         struct {
             TC * map;           // 32-sample sub-map (first quadrant)
         } sqam128;
+
+        // arbitrary modem: uniform grid over the constellation, each cell
+        // listing every symbol which can be nearest to a point in the cell
+        struct {
+            unsigned int grid;  // number of cells along each axis
+            T x0;               // grid origin, in-phase
+            T y0;               // grid origin, quadrature
+            T inv_dx;           // inverse cell width, in-phase
+            T inv_dy;           // inverse cell width, quadrature
+            unsigned int * cell;    // offset of each cell's list [grid^2+1]
+            unsigned char * cand;   // candidate symbols of all cells
+        } arb;
     } data;
 
     // modulate function pointer
@@ -248,6 +262,10 @@ void MODEM(_destroy)(MODEM() _q)
         free(_q->data.sqam128.map);
     } else if (liquid_modem_is_apsk(_q->scheme)) {
         free(_q->data.apsk.map);
+        free(_q->data.apsk.demap);
+    } else if (_q->scheme == LIQUID_MODEM_ARB) {
+        free(_q->data.arb.cell);
+        free(_q->data.arb.cand);
     }
 
     // free main object memory
@@ -299,6 +317,7 @@ void MODEM(_init)(MODEM() _q,
     // soft demodulation
     _q->demod_soft_neighbors = NULL;
     _q->demod_soft_p = 0;
+    _q->llr_scale = 1.0f;
 }
 
 // initialize symbol map for fast modulation
@@ -321,6 +340,25 @@ void MODEM(_init_map)(MODEM() _q)
         _q->modulate_func(_q, i, &_q->symbol_map[i]);
 }
 
+// set soft-decision scaling relative to default; soft bits are
+// 127 + _scale*LLR*16 (clipped to [0,255]) with the approximate
+// log-likelihood ratio LLR of each scheme
+void MODEM(_set_llr_scale)(MODEM() _q,
+                           T       _scale)
+{
+    if (_scale <= 0.0f) {
+        fprintf(stderr,"error: modem_set_llr_scale(), scale must be greater than zero\n");
+        exit(1);
+    }
+    _q->llr_scale = _scale;
+}
+
+// get soft-decision scaling relative to default
+T MODEM(_get_llr_scale)(MODEM() _q)
+{
+    return _q->llr_scale;
+}
+
 // Generate random symbol
 unsigned int MODEM(_gen_rand_sym)(MODEM() _q)
 {
@@ -399,9 +437,17 @@ void MODEM(_demodulate_soft)(MODEM() _q,
     case LIQUID_MODEM_ARB:  MODEM(_demodulate_soft_arb)( _q,_x,_s,_soft_bits); return;
     case LIQUID_MODEM_BPSK: MODEM(_demodulate_soft_bpsk)(_q,_x,_s,_soft_bits); return;
     case LIQUID_MODEM_QPSK: MODEM(_demodulate_soft_qpsk)(_q,_x,_s,_soft_bits); return;
+    case LIQUID_MODEM_SQAM32:  MODEM(_demodulate_soft_sqam32)( _q,_x,_s,_soft_bits); return;
+    case LIQUID_MODEM_SQAM128: MODEM(_demodulate_soft_sqam128)(_q,_x,_s,_soft_bits); return;
     default:;
     }
 
+    // closed-form (per-axis) log-likelihood ratios for QAM
+    if (liquid_modem_is_qam(_q->scheme)) {
+        MODEM(_demodulate_soft_qam)(_q, _x, _s, _soft_bits);
+        return;
+    }
+
     // check if...
     if (_q->demod_soft_neighbors != NULL && _q->demod_soft_p != 0) {
         // demodulate using approximate log-likelihood method with
@@ -447,20 +493,30 @@ void MODEM(_demodulate_soft_table)(MODEM() _q,
     unsigned int s;
     MODEM(_demodulate)(_q, _r, &s);
 
+    // compute soft bits from nearest neighbors of hard decision
+    MODEM(_demodulate_soft_table_llr)(_q, _r, s, _q->x_hat, _soft_bits);
+
+    // set hard output symbol
+    *_s = s;
+}
+
+// soft bits from look-up table of nearest neighbors of hard decision
+//  _q          :   demodulator object
+//  _r          :   received sample
+//  _s          :   hard demodulator output
+//  _x_hat      :   re-modulated hard demodulator output
+//  _soft_bits  :   soft bit ouput (approximate log-likelihood ratio)
+void MODEM(_demodulate_soft_table_llr)(MODEM()         _q,
+                                       TC              _r,
+                                       unsigned int    _s,
+                                       TC              _x_hat,
+                                       unsigned char * _soft_bits)
+{
+    unsigned int s = _s;
     unsigned int bps = MODEM(_get_bps)(_q);
 
     // gamma = 1/(2*sigma^2), approximate for constellation size
-    T gamma = 1.2f*_q->M;
-
-    // set and initialize minimum bit values
-    unsigned int i;
-    unsigned int k;
-    T dmin_0[bps];
-    T dmin_1[bps];
-    for (k=0; k<bps; k++) {
-        dmin_0[k] = 8.0f;
-        dmin_1[k] = 8.0f;
-    }
+    T gamma = 1.2f*_q->M*_q->llr_scale;
 
     unsigned int bit;
     T d;
@@ -469,7 +525,19 @@ void MODEM(_demodulate_soft_table)(MODEM() _q,
     unsigned int p = _q->demod_soft_p;
 
     // check hard demodulation
-    d = crealf( (_r-_q->x_hat)*conjf(_r-_q->x_hat) );
+    d = crealf( (_r-_x_hat)*conjf(_r-_x_hat) );
+
+    // set and initialize minimum bit values (relative to the hard
+    // decision so samples far outside the constellation keep their sign)
+    unsigned int i;
+    unsigned int k;
+    T dmin_0[bps];
+    T dmin_1[bps];
+    for (k=0; k<bps; k++) {
+        dmin_0[k] = d + 8.0f;
+        dmin_1[k] = d + 8.0f;
+    }
+
     for (k=0; k<bps; k++) {
         bit = (s >> (bps-k-1)) & 0x01;
         if (bit) dmin_1[k] = d;
@@ -509,9 +577,6 @@ void MODEM(_demodulate_soft_table)(MODEM() _q,
         if (soft_bit <   0) soft_bit = 0;
         _soft_bits[k] = (unsigned char)soft_bit;
     }
-
-    // set hard output symbol
-    *_s = s;
 }
 
 
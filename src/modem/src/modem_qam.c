@@ -90,9 +90,8 @@ MODEM() MODEM(_create_qam)(unsigned int _bits_per_symbol)
     MODEM(_init_map)(q);
     q->modulate_using_map = 1;
 
-    // initialize soft-demodulation look-up table
-    if      (q->m == 3) MODEM(_demodsoft_gentab)(q, 3);
-    else if (q->m >= 4) MODEM(_demodsoft_gentab)(q, 4);
+    // soft demodulation uses closed-form log-likelihood ratios (no
+    // nearest-neighbor look-up table)
 
     // reset and return
     MODEM(_reset)(q);
@@ -143,3 +142,50 @@ void MODEM(_demodulate_qam)(MODEM()      _q,
     _q->r = _x;
 }
 
+
+// demodulate QAM (soft) with closed-form log-likelihood ratios
+void MODEM(_demodulate_soft_qam)(MODEM()         _q,
+                                 TC              _x,
+                                 unsigned int  * _s,
+                                 unsigned char * _soft_bits)
+{
+    // hard decision (and state)
+    MODEM(_demodulate_qam)(_q, _x, _s);
+
+    // soft bits of each axis; squared-distance difference of Gray-coded
+    // levels is 4*alpha*llr (see MODEM(_demodulate_soft_pam)())
+    T gamma = 1.2f*_q->M*_q->llr_scale;
+    T c = 4.0f*_q->data.qam.alpha*gamma*16;
+    MODEM(_demodulate_soft_pam)(crealf(_x), _q->data.qam.m_i, _q->ref, c, _soft_bits);
+    MODEM(_demodulate_soft_pam)(cimagf(_x), _q->data.qam.m_q, _q->ref, c,
+                                &_soft_bits[_q->data.qam.m_i]);
+}
+
+// soft bits of Gray-coded amplitude levels (2k-M+1)*alpha on one axis
+// from simplified max-log likelihood ratios: the first bit is the sign of
+// _v; each following bit k is the distance to the threshold 2^(m-k)*alpha
+// folded about the previous one, llr_k = 2^(m-k)*alpha - |llr_{k-1}|
+//  _v          :   input value
+//  _m          :   bits per axis
+//  _ref        :   array of thresholds, _ref[k] = 2^k*alpha
+//  _c          :   soft-bit scaling
+//  _soft_bits  :   soft bit output [size: _m x 1]
+void MODEM(_demodulate_soft_pam)(T               _v,
+                                 unsigned int    _m,
+                                 T *             _ref,
+                                 T               _c,
+                                 unsigned char * _soft_bits)
+{
+    unsigned int k;
+    T llr = _v;
+    for (k=0; k<_m; k++) {
+        if (k > 0)
+            llr = _ref[_m-k] - fabsf(llr);
+
+        // scale, clip and quantize
+        T b = llr*_c + 127.0f;
+        b = b < 0.0f   ? 0.0f   : b;
+        b = b > 255.0f ? 255.0f : b;
+        _soft_bits[k] = (unsigned char)b;
+    }
+}
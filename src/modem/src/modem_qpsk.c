@@ -80,7 +80,7 @@ void MODEM(_demodulate_soft_qpsk)(MODEM()         _q,
                                   unsigned char * _soft_bits)
 {
     // gamma = 1/(2*sigma^2), approximate for constellation size
-    T gamma = 5.8f;
+    T gamma = 5.8f*_q->llr_scale;
 
     // approximate log-likelihood ratios
     T LLR;
@@ -104,7 +104,9 @@ void MODEM(_demodulate_sqam128)(MODEM()        _q,
     T d = 0.0f;
     unsigned int i;
     for (i=0; i<32; i++) {
-        d = cabsf(x_prime - _q->data.sqam128.map[i]);
+        // squared distance (same decision as magnitude)
+        TC e = x_prime - _q->data.sqam128.map[i];
+        d = crealf(e)*crealf(e) + cimagf(e)*cimagf(e);
         if (i==0 || d < dmin) {
             dmin = d;
             *_sym_out = i;
@@ -119,3 +121,13 @@ void MODEM(_demodulate_sqam128)(MODEM()        _q,
     _q->r = _x;
 }
 
+
+// demodulate 'square' 128-QAM (soft)
+void MODEM(_demodulate_soft_sqam128)(MODEM()         _q,
+                                     TC              _x,
+                                     unsigned int  * _s,
+                                     unsigned char * _soft_bits)
+{
+    MODEM(_demodulate_sqam128)(_q, _x, _s);
+    MODEM(_demodulate_soft_sqam)(_q, _x, *_s, _q->data.sqam128.map, _soft_bits);
+}
@@ -103,7 +103,9 @@ void MODEM(_demodulate_sqam32)(MODEM()        _q,
     T d = 0.0f;
     unsigned int i;
     for (i=0; i<8; i++) {
-        d = cabsf(x_prime - _q->data.sqam32.map[i]);
+        // squared distance (same decision as magnitude)
+        TC e = x_prime - _q->data.sqam32.map[i];
+        d = crealf(e)*crealf(e) + cimagf(e)*cimagf(e);
         if (i==0 || d < dmin) {
             dmin = d;
             *_sym_out = i;
@@ -118,3 +120,76 @@ void MODEM(_demodulate_sqam32)(MODEM()        _q,
     _q->r = _x;
 }
 
+
+// demodulate 'square' 32-QAM (soft)
+void MODEM(_demodulate_soft_sqam32)(MODEM()         _q,
+                                    TC              _x,
+                                    unsigned int  * _s,
+                                    unsigned char * _soft_bits)
+{
+    MODEM(_demodulate_sqam32)(_q, _x, _s);
+    MODEM(_demodulate_soft_sqam)(_q, _x, *_s, _q->data.sqam32.map, _soft_bits);
+}
+
+// soft bits of 'square' QAM (sqam32, sqam128) from approximate
+// log-likelihood ratios: the quadrant bits from the distance of the
+// received sample to each axis (scaled by the coordinates of the hard
+// decision), the remaining bits from max-log ratios over the points of the
+// first-quadrant sub-map
+//  _q          :   modem object
+//  _x          :   received sample
+//  _s          :   hard decision
+//  _map        :   first-quadrant sub-map [size: 2^(m-2) x 1]
+//  _soft_bits  :   soft bit output [size: m x 1]
+void MODEM(_demodulate_soft_sqam)(MODEM()         _q,
+                                  TC              _x,
+                                  unsigned int    _s,
+                                  TC *            _map,
+                                  unsigned char * _soft_bits)
+{
+    unsigned int nb = _q->m - 2;    // bits in sub-map
+    unsigned int P  = 1 << nb;      // points in sub-map
+
+    // gamma = 1/(2*sigma^2), approximate for constellation size
+    T gamma = 1.2f*_q->M*_q->llr_scale;
+
+    // log-likelihood ratios (squared-distance differences)
+    T llr[MAX_MOD_BITS_PER_SYMBOL];
+
+    // quadrant bits: mirror images of the hard decision across each axis
+    TC p = _map[_s & (P-1)];
+    llr[0] = -4.0f*crealf(p)*crealf(_x);
+    llr[1] = -4.0f*cimagf(p)*cimagf(_x);
+
+    // remaining bits: minimum distance to sub-map points with each bit
+    // value, with the sample de-rotated to the first quadrant
+    T xr = fabsf(crealf(_x));
+    T xi = fabsf(cimagf(_x));
+    T dmin_0[MAX_MOD_BITS_PER_SYMBOL];
+    T dmin_1[MAX_MOD_BITS_PER_SYMBOL];
+    unsigned int j;
+    unsigned int k;
+    for (k=0; k<nb; k++) {
+        dmin_0[k] = 1e9f;
+        dmin_1[k] = 1e9f;
+    }
+    for (j=0; j<P; j++) {
+        T er = xr - crealf(_map[j]);
+        T ei = xi - cimagf(_map[j]);
+        T d  = er*er + ei*ei;
+        for (k=0; k<nb; k++) {
+            T * dmin = ((j >> (nb-k-1)) & 1) ? dmin_1 : dmin_0;
+            dmin[k] = d < dmin[k] ? d : dmin[k];
+        }
+    }
+    for (k=0; k<nb; k++)
+        llr[2+k] = dmin_0[k] - dmin_1[k];
+
+    // scale, clip and quantize
+    for (k=0; k<_q->m; k++) {
+        T b = llr[k]*gamma*16 + 127.0f;
+        b = b < 0.0f   ? 0.0f   : b;
+        b = b > 255.0f ? 255.0f : b;
+        _soft_bits[k] = (unsigned char)b;
+    }
+}
@@ -59,6 +59,9 @@
 // arbitary modems
 #include "modem_arb.c"
 
+// block modulation/demodulation
+#include "modem_block.c"
+
 // analog modems
 #include "freqmod.c"
 #include "freqdem.c"
@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+//
+// tonedet : multi-tone detector
+//
+// Correlates a block of samples against a small set of tones, computing
+// one DFT bin per tone directly. For a handful of tones this is cheaper
+// than a full transform: the cost is proportional to the number of tones
+// times the block length rather than K log K. Tones are processed in
+// groups of four, one per SIMD lane, against a table of pre-computed
+// twiddle factors; samples alternate between two sets of accumulators to
+// shorten the dependency chain. The SSE2 kernel and its scalar fall-back
+// perform the same operations in the same order.
+//
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+
+#include "liquid.internal.h"
+
+#if HAVE_EMMINTRIN_H && defined __SSE2__
+#include <emmintrin.h>  // SSE2
+#define TONEDET_USE_SSE2 1
+#else
+#define TONEDET_USE_SSE2 0
+#endif
+
+// correlate one group of four tones against the input block
+//  _w      :   twiddle table for group [size: 8*_n x 1]
+//  _x      :   input samples (interleaved real/imag) [size: 2*_n x 1]
+//  _n      :   number of samples
+//  _re     :   real part of correlation [size: 4 x 1]
+//  _im     :   imag part of correlation [size: 4 x 1]
+static void tonedet_correlate_group(const float *  _w,
+                                    const float *  _x,
+                                    unsigned int   _n,
+                                    float *        _re,
+                                    float *        _im);
+
+// tonedet
+struct tonedet_s {
+    unsigned int    n;          // samples per block
+    unsigned int    num_tones;  // number of tones
+    unsigned int    num_groups; // number of four-tone groups
+    float *         freqs;      // tone frequencies [size: num_tones x 1]
+    float *         w;          // twiddle table [size: num_groups x n x 8]
+    float complex * X;          // correlator output [size: num_tones x 1]
+};
+
+// create multi-tone detector
+//  _n          :   samples per block, _n > 0
+//  _num_tones  :   number of tones, _num_tones > 0
+//  _freqs      :   normalized tone frequencies [size: _num_tones x 1]
+tonedet tonedet_create(unsigned int _n,
+                       unsigned int _num_tones,
+                       float *      _freqs)
+{
+    // validate input
+    if (_n == 0) {
+        fprintf(stderr,"error: tonedet_create(), block length must be greater than 0\n");
+        exit(1);
+    } else if (_num_tones == 0) {
+        fprintf(stderr,"error: tonedet_create(), number of tones must be greater than 0\n");
+        exit(1);
+    }
+
+    // create main object memory
+    tonedet q = (tonedet) malloc(sizeof(struct tonedet_s));
+
+    q->n          = _n;
+    q->num_tones  = _num_tones;
+    q->num_groups = (_num_tones + 3) / 4;
+
+    q->freqs = (float*)         malloc(q->num_tones*sizeof(float));
+    q->X     = (float complex*) malloc(q->num_tones*sizeof(float complex));
+    memmove(q->freqs, _freqs, q->num_tones*sizeof(float));
+
+    // twiddle factors exp(-j*2*pi*f*i), grouped by four tones and
+    // interleaved as four real then four imaginary values for each
+    // sample; unused lanes of the last group are zero
+    q->w = (float*) malloc(8*q->num_groups*q->n*sizeof(float));
+    unsigned int g, i, l;
+    for (g=0; g<q->num_groups; g++) {
+        for (i=0; i<q->n; i++) {
+            float * w = &q->w[8*(g*q->n + i)];
+            for (l=0; l<4; l++) {
+                unsigned int t = 4*g + l;
+                if (t >= q->num_tones) {
+                    w[l]   = 0.0f;
+                    w[l+4] = 0.0f;
+                    continue;
+                }
+                // reduce phase in double precision to keep long blocks accurate
+                double phi = (double)q->freqs[t] * (double)i;
+                phi = 2*M_PI*(phi - floor(phi));
+                w[l]   =  (float)cos(phi);
+                w[l+4] = -(float)sin(phi);
+            }
+        }
+    }
+
+    return q;
+}
+
+// destroy multi-tone detector
+void tonedet_destroy(tonedet _q)
+{
+    free(_q->freqs);
+    free(_q->w);
+    free(_q->X);
+    free(_q);
+}
+
+// print multi-tone detector internals
+void tonedet_print(tonedet _q)
+{
+    printf("tonedet : multi-tone detector\n");
+    printf("    block length    :   %u\n", _q->n);
+    printf("    number of tones :   %u\n", _q->num_tones);
+    unsigned int i;
+    for (i=0; i<_q->num_tones; i++)
+        printf("    tone %-3u        :   %12.8f\n", i, _q->freqs[i]);
+}
+
+// get block length
+unsigned int tonedet_get_length(tonedet _q)
+{
+    return _q->n;
+}
+
+// get number of tones
+unsigned int tonedet_get_num_tones(tonedet _q)
+{
+    return _q->num_tones;
+}
+
+// correlate input block against each tone
+//  _q      :   multi-tone detector
+//  _x      :   input block [size: _n x 1]
+//  _X      :   correlator output for each tone [size: _num_tones x 1]
+void tonedet_execute(tonedet         _q,
+                     float complex * _x,
+                     float complex * _X)
+{
+    unsigned int g, l;
+    float re[4];
+    float im[4];
+    for (g=0; g<_q->num_groups; g++) {
+        tonedet_correlate_group(&_q->w[8*g*_q->n], (const float*)_x, _q->n, re, im);
+        for (l=0; l<4 && 4*g+l<_q->num_tones; l++)
+            _X[4*g+l] = re[l] + _Complex_I*im[l];
+    }
+}
+
+// find strongest tone in input block, returning its index
+//  _q      :   multi-tone detector
+//  _x      :   input block [size: _n x 1]
+unsigned int tonedet_detect(tonedet         _q,
+                            float complex * _x)
+{
+    tonedet_execute(_q, _x, _q->X);
+
+    // compare energy (no square root needed)
+    unsigned int i;
+    unsigned int imax = 0;
+    float        vmax = 0.0f;
+    for (i=0; i<_q->num_tones; i++) {
+        float v = crealf(_q->X[i])*crealf(_q->X[i]) + cimagf(_q->X[i])*cimagf(_q->X[i]);
+        if (i==0 || v > vmax) {
+            imax = i;
+            vmax = v;
+        }
+    }
+    return imax;
+}
+
+//
+// internal methods
+//
+
+#if TONEDET_USE_SSE2
+static void tonedet_correlate_group(const float *  _w,
+                                    const float *  _x,
+                                    unsigned int   _n,
+                                    float *        _re,
+                                    float *        _im)
+{
+    __m128 ar0 = _mm_setzero_ps();
+    __m128 ai0 = _mm_setzero_ps();
+    __m128 ar1 = _mm_setzero_ps();
+    __m128 ai1 = _mm_setzero_ps();
+    unsigned int i;
+    for (i=0; i+1<_n; i+=2) {
+        __m128 yr0 = _mm_set1_ps(_x[2*i  ]);
+        __m128 yi0 = _mm_set1_ps(_x[2*i+1]);
+        __m128 yr1 = _mm_set1_ps(_x[2*i+2]);
+        __m128 yi1 = _mm_set1_ps(_x[2*i+3]);
+        __m128 wr0 = _mm_loadu_ps(&_w[8*i   ]);
+        __m128 wi0 = _mm_loadu_ps(&_w[8*i+ 4]);
+        __m128 wr1 = _mm_loadu_ps(&_w[8*i+ 8]);
+        __m128 wi1 = _mm_loadu_ps(&_w[8*i+12]);
+        ar0 = _mm_add_ps(ar0, _mm_sub_ps(_mm_mul_ps(yr0,wr0), _mm_mul_ps(yi0,wi0)));
+        ai0 = _mm_add_ps(ai0, _mm_add_ps(_mm_mul_ps(yr0,wi0), _mm_mul_ps(yi0,wr0)));
+        ar1 = _mm_add_ps(ar1, _mm_sub_ps(_mm_mul_ps(yr1,wr1), _mm_mul_ps(yi1,wi1)));
+        ai1 = _mm_add_ps(ai1, _mm_add_ps(_mm_mul_ps(yr1,wi1), _mm_mul_ps(yi1,wr1)));
+    }
+    if (i < _n) {
+        __m128 yr0 = _mm_set1_ps(_x[2*i  ]);
+        __m128 yi0 = _mm_set1_ps(_x[2*i+1]);
+        __m128 wr0 = _mm_loadu_ps(&_w[8*i   ]);
+        __m128 wi0 = _mm_loadu_ps(&_w[8*i+ 4]);
+        ar0 = _mm_add_ps(ar0, _mm_sub_ps(_mm_mul_ps(yr0,wr0), _mm_mul_ps(yi0,wi0)));
+        ai0 = _mm_add_ps(ai0, _mm_add_ps(_mm_mul_ps(yr0,wi0), _mm_mul_ps(yi0,wr0)));
+    }
+    _mm_storeu_ps(_re, _mm_add_ps(ar0, ar1));
+    _mm_storeu_ps(_im, _mm_add_ps(ai0, ai1));
+}
+#else
+static void tonedet_correlate_group(const float *  _w,
+                                    const float *  _x,
+                                    unsigned int   _n,
+                                    float *        _re,
+                                    float *        _im)
+{
+    unsigned int i, l;
+    for (l=0; l<4; l++) {
+        float ar0 = 0.0f, ai0 = 0.0f;
+        float ar1 = 0.0f, ai1 = 0.0f;
+        for (i=0; i+1<_n; i+=2) {
+            const float * w0 = &_w[8*i  ];
+            const float * w1 = &_w[8*i+8];
+            ar0 += _x[2*i  ]*w0[l] - _x[2*i+1]*w0[l+4];
+            ai0 += _x[2*i  ]*w0[l+4] + _x[2*i+1]*w0[l];
+            ar1 += _x[2*i+2]*w1[l] - _x[2*i+3]*w1[l+4];
+            ai1 += _x[2*i+2]*w1[l+4] + _x[2*i+3]*w1[l];
+        }
+        if (i < _n) {
+            const float * w0 = &_w[8*i];
+            ar0 += _x[2*i  ]*w0[l] - _x[2*i+1]*w0[l+4];
+            ai0 += _x[2*i  ]*w0[l+4] + _x[2*i+1]*w0[l];
+        }
+        _re[l] = ar0 + ar1;
+        _im[l] = ai0 + ai1;
+    }
+}
+#endif
+
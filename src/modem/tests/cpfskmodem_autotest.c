@@ -118,3 +118,42 @@ void autotest_cpfskmodem_bps2_h0p0250_k4_m3_square()    { cpfskmodem_test_mod_de
 void autotest_cpfskmodem_bps3_h0p1250_k4_m3_square()    { cpfskmodem_test_mod_demod( 3, 0.1250f, 4, 3, 0.25f, LIQUID_CPFSK_SQUARE ); }
 void autotest_cpfskmodem_bps4_h0p0625_k4_m3_square()    { cpfskmodem_test_mod_demod( 4, 0.0625f, 4, 3, 0.25f, LIQUID_CPFSK_SQUARE ); }
 
+
+// Compare block demodulation against symbol-by-symbol method
+void cpfskmodem_test_block(unsigned int _bps,
+                           float        _h,
+                           int          _filter_type)
+{
+    unsigned int k = 4;
+    unsigned int m = 3;
+    unsigned int num_symbols = 150;    // more than one internal block
+
+    cpfskmod mod  = cpfskmod_create(_bps, _h, k, m, 0.25f, _filter_type);
+    cpfskdem dem0 = cpfskdem_create(_bps, _h, k, m, 0.25f, _filter_type);
+    cpfskdem dem1 = cpfskdem_create(_bps, _h, k, m, 0.25f, _filter_type);
+    msequence ms = msequence_create_default(7);
+
+    unsigned int i;
+    float complex buf[num_symbols*k];
+    for (i=0; i<num_symbols; i++)
+        cpfskmod_modulate(mod, msequence_generate_symbol(ms, _bps), &buf[i*k]);
+
+    // demodulate in two blocks to check state across calls
+    unsigned int sym0[num_symbols];
+    unsigned int sym1[num_symbols];
+    for (i=0; i<num_symbols; i++)
+        sym0[i] = cpfskdem_demodulate(dem0, &buf[i*k]);
+    cpfskdem_demodulate_block(dem1, buf,      37,              sym1);
+    cpfskdem_demodulate_block(dem1, buf+37*k, num_symbols-37,  sym1+37);
+    for (i=0; i<num_symbols; i++)
+        CONTEND_EQUALITY(sym0[i], sym1[i]);
+
+    msequence_destroy(ms);
+    cpfskmod_destroy(mod);
+    cpfskdem_destroy(dem0);
+    cpfskdem_destroy(dem1);
+}
+
+// AUTOTESTS: block demodulation
+void autotest_cpfskmodem_block_bps1_gmsk()      { cpfskmodem_test_block(1, 0.5000f, LIQUID_CPFSK_GMSK);   }
+void autotest_cpfskmodem_block_bps2_square()    { cpfskmodem_test_block(2, 0.2500f, LIQUID_CPFSK_SQUARE); }
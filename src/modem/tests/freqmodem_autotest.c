@@ -20,6 +20,7 @@
  * THE SOFTWARE.
  */
 
+#include <math.h>
 #include "autotest/autotest.h"
 #include "liquid.h"
 
@@ -69,3 +70,66 @@ void autotest_freqmodem_kf_0_02() { freqmodem_test(0.02f); }
 void autotest_freqmodem_kf_0_04() { freqmodem_test(0.04f); }
 void autotest_freqmodem_kf_0_08() { freqmodem_test(0.08f); }
 
+
+// Compare block modulation/demodulation against sample-by-sample methods
+// (results must be identical) and check the phase error of the arctangent
+// approximation against exact demodulation
+//  _tol    :   demodulator phase error tolerance
+void freqmodem_test_block(float _tol)
+{
+    float kf = 0.1f;
+    unsigned int n = 1027;  // not a multiple of the SIMD width
+    unsigned int i;
+
+    freqmod mod0 = freqmod_create(kf);
+    freqmod mod1 = freqmod_create(kf);
+    freqdem dem0 = freqdem_create(kf);
+    freqdem dem1 = freqdem_create(kf);
+    freqdem dem2 = freqdem_create(kf);
+    freqdem_set_tolerance(dem0, _tol);
+    freqdem_set_tolerance(dem1, _tol);
+    freqdem_set_tolerance(dem2, 0.0f);
+
+    // chirp message signal
+    float m[n];
+    for (i=0; i<n; i++)
+        m[i] = 0.9f*sinf(0.01f*i*i);
+
+    // modulate
+    float complex r0[n];
+    float complex r1[n];
+    for (i=0; i<n; i++)
+        freqmod_modulate(mod0, m[i], &r0[i]);
+    freqmod_modulate_block(mod1, m, n, r1);
+    for (i=0; i<n; i++) {
+        CONTEND_EQUALITY(crealf(r0[i]), crealf(r1[i]));
+        CONTEND_EQUALITY(cimagf(r0[i]), cimagf(r1[i]));
+    }
+
+    // demodulate in two blocks to check state across calls
+    float y0[n];
+    float y1[n];
+    float y2[n];
+    for (i=0; i<n; i++)
+        freqdem_demodulate(dem0, r0[i], &y0[i]);
+    freqdem_demodulate_block(dem1, r0,     501,   y1);
+    freqdem_demodulate_block(dem1, r0+501, n-501, y1+501);
+    freqdem_demodulate_block(dem2, r0,     n,     y2);
+    for (i=0; i<n; i++) {
+        CONTEND_EQUALITY(y0[i], y1[i]);
+        CONTEND_DELTA(y1[i]*2*M_PI*kf, y2[i]*2*M_PI*kf, _tol + 1e-6f);
+    }
+
+    freqmod_destroy(mod0);
+    freqmod_destroy(mod1);
+    freqdem_destroy(dem0);
+    freqdem_destroy(dem1);
+    freqdem_destroy(dem2);
+}
+
+// AUTOTESTS: block methods with arctangent tolerance
+void autotest_freqmodem_block_exact() { freqmodem_test_block(0.0f);    }
+void autotest_freqmodem_block_tol1e5(){ freqmodem_test_block(1.5e-5f); }
+void autotest_freqmodem_block_tol1e4(){ freqmodem_test_block(1e-4f);   }
+void autotest_freqmodem_block_tol1e3(){ freqmodem_test_block(1e-3f);   }
+void autotest_freqmodem_block_tol1e2(){ freqmodem_test_block(1e-2f);   }
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "autotest/autotest.h"
+#include "liquid.h"
+
+// Modulate and demodulate random symbols symbol by symbol, in blocks and
+// with soft-decision output; all methods must agree and recover the
+// transmitted symbols after the filter delay (soft bits near the
+// threshold may round to the erasure value)
+void gmskmodem_test_mod_demod(unsigned int _k,
+                              unsigned int _m,
+                              float        _BT)
+{
+    unsigned int num_symbols = 200;    // more than one internal block
+    unsigned int delay = 2*_m;         // transmit and receive filter delay
+
+    gmskmod mod  = gmskmod_create(_k, _m, _BT);
+    gmskdem dem0 = gmskdem_create(_k, _m, _BT);
+    gmskdem dem1 = gmskdem_create(_k, _m, _BT);
+    gmskdem dem2 = gmskdem_create(_k, _m, _BT);
+    msequence ms = msequence_create_default(7);
+
+    unsigned int i;
+    unsigned int sym_in[num_symbols];
+    float complex buf[num_symbols*_k];
+    for (i=0; i<num_symbols; i++) {
+        sym_in[i] = msequence_generate_symbol(ms, 1);
+        gmskmod_modulate(mod, sym_in[i], &buf[i*_k]);
+    }
+
+    unsigned int  sym0[num_symbols];
+    unsigned int  sym1[num_symbols];
+    unsigned int  sym2[num_symbols];
+    unsigned char soft[num_symbols];
+    for (i=0; i<num_symbols; i++)
+        gmskdem_demodulate(dem0, &buf[i*_k], &sym0[i]);
+    gmskdem_demodulate_block(dem1, buf,       71,             sym1);
+    gmskdem_demodulate_block(dem1, buf+71*_k, num_symbols-71, sym1+71);
+    gmskdem_demodulate_soft_block(dem2, buf, num_symbols, sym2, soft);
+
+    for (i=0; i<num_symbols; i++) {
+        CONTEND_EQUALITY(sym0[i], sym1[i]);
+        CONTEND_EQUALITY(sym0[i], sym2[i]);
+        if (sym2[i]) {
+            CONTEND_GREATER_THAN(soft[i], 126);
+        } else {
+            CONTEND_LESS_THAN(soft[i], 128);
+        }
+        if (i >= delay)
+            CONTEND_EQUALITY(sym0[i], sym_in[i-delay]);
+    }
+
+    msequence_destroy(ms);
+    gmskmod_destroy(mod);
+    gmskdem_destroy(dem0);
+    gmskdem_destroy(dem1);
+    gmskdem_destroy(dem2);
+}
+
+// AUTOTESTS
+void autotest_gmskmodem_k2_m3_b025()    { gmskmodem_test_mod_demod(2, 3, 0.25f); }
+void autotest_gmskmodem_k4_m3_b033()    { gmskmodem_test_mod_demod(4, 3, 0.33f); }
+void autotest_gmskmodem_k8_m5_b050()    { gmskmodem_test_mod_demod(8, 5, 0.50f); }
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include "autotest/autotest.h"
+#include "liquid.h"
+
+// Compare grid search of arbitrary constellations against an exhaustive
+// search over random samples (including samples far outside the
+// constellation); soft bits must agree with the hard decision and be at
+// least as confident as exact max-log ratios (the flipped-bit distance is
+// taken over a subset of the symbols).
+void modem_test_arb_search(modem _q)
+{
+    unsigned int bps = modem_get_bps(_q);
+    unsigned int M   = 1 << bps;
+    float gamma = 1.2f*M;
+
+    unsigned int i, j, k;
+    float complex c[M];
+    for (i=0; i<M; i++)
+        modem_modulate(_q, i, &c[i]);
+
+    unsigned int num_trials = 2000;
+    unsigned char soft[bps];
+    for (i=0; i<num_trials; i++) {
+        float a = (i % 10) == 0 ? 20.0f : 1.5f;
+        float complex x = a*(2.0f*randf()-1.0f) + _Complex_I*a*(2.0f*randf()-1.0f);
+
+        // exhaustive search
+        unsigned int s_ref = 0;
+        float d[M];
+        for (j=0; j<M; j++) {
+            d[j] = crealf((x-c[j])*conjf(x-c[j]));
+            if (d[j] < d[s_ref]) s_ref = j;
+        }
+
+        unsigned int s;
+        modem_demodulate(_q, x, &s);
+        CONTEND_EQUALITY(s, s_ref);
+
+        modem_demodulate_soft(_q, x, &s, soft);
+        CONTEND_EQUALITY(s, s_ref);
+        for (k=0; k<bps; k++) {
+            float d0 = 1e9f, d1 = 1e9f;
+            for (j=0; j<M; j++) {
+                if ((j >> (bps-k-1)) & 1) d1 = d[j] < d1 ? d[j] : d1;
+                else                      d0 = d[j] < d0 ? d[j] : d0;
+            }
+            float llr = (d0 - d1)*gamma*16 + 127;
+            llr = llr > 255 ? 255 : (llr < 0 ? 0 : llr);
+            if ((s_ref >> (bps-k-1)) & 1) {
+                CONTEND_GREATER_THAN((int)soft[k], (int)llr - 2);
+            } else {
+                CONTEND_LESS_THAN((int)soft[k], (int)llr + 2);
+            }
+        }
+    }
+}
+
+void modem_test_arb_scheme(modulation_scheme _ms)
+{
+    modem q = modem_create(_ms);
+    modem_test_arb_search(q);
+    modem_destroy(q);
+}
+
+// AUTOTESTS: pre-defined arbitrary constellations
+void autotest_modem_arb_V29()       { modem_test_arb_scheme(LIQUID_MODEM_V29);      }
+void autotest_modem_arb_arb16opt()  { modem_test_arb_scheme(LIQUID_MODEM_ARB16OPT); }
+void autotest_modem_arb_arb32opt()  { modem_test_arb_scheme(LIQUID_MODEM_ARB32OPT); }
+void autotest_modem_arb_arb64opt()  { modem_test_arb_scheme(LIQUID_MODEM_ARB64OPT); }
+void autotest_modem_arb_arb128opt() { modem_test_arb_scheme(LIQUID_MODEM_ARB128OPT);}
+void autotest_modem_arb_arb256opt() { modem_test_arb_scheme(LIQUID_MODEM_ARB256OPT);}
+void autotest_modem_arb_arb64vt()   { modem_test_arb_scheme(LIQUID_MODEM_ARB64VT);  }
+
+// AUTOTEST: random constellation
+void autotest_modem_arb_random256()
+{
+    unsigned int i;
+    float complex c[256];
+    for (i=0; i<256; i++)
+        c[i] = randnf() + _Complex_I*randnf();
+    modem q = modem_create_arbitrary(c, 256);
+    modem_test_arb_search(q);
+    modem_destroy(q);
+}
+
+// AUTOTEST: all symbols on the in-phase axis (degenerate grid)
+void autotest_modem_arb_line8()
+{
+    unsigned int i;
+    float complex c[8];
+    for (i=0; i<8; i++)
+        c[i] = (float)i*i;
+    modem q = modem_create_arbitrary(c, 8);
+    modem_test_arb_search(q);
+    modem_destroy(q);
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include "autotest/autotest.h"
+#include "liquid.h"
+
+// Compare block modulation/demodulation against symbol-by-symbol methods;
+// noise is kept well inside the decision regions so hard decisions must
+// match exactly, and soft bits within one unit (re-modulated samples may
+// differ in rounding).
+void modem_test_block(modulation_scheme _ms)
+{
+    unsigned int n = 203;   // not a multiple of the SIMD width
+
+    // separate objects for each path (differential schemes keep state)
+    modem mod0   = modem_create(_ms);
+    modem mod1   = modem_create(_ms);
+    modem demod0 = modem_create(_ms);
+    modem demod1 = modem_create(_ms);
+
+    unsigned int bps = modem_get_bps(mod0);
+    unsigned int M   = 1 << bps;
+
+    // minimum distance of constellation
+    unsigned int i, j;
+    float complex c[M];
+    for (i=0; i<M; i++) {
+        modem_reset(mod0);
+        modem_modulate(mod0, i, &c[i]);
+    }
+    modem_reset(mod0);
+    float dmin = 1e9f;
+    for (i=0; i<M; i++) {
+        for (j=i+1; j<M; j++) {
+            float d = cabsf(c[i] - c[j]);
+            dmin = d < dmin ? d : dmin;
+        }
+    }
+
+    unsigned char s[n];
+    float complex y0[n];
+    float complex y1[n];
+    for (i=0; i<n; i++)
+        s[i] = modem_gen_rand_sym(mod0);
+
+    // modulate
+    for (i=0; i<n; i++)
+        modem_modulate(mod0, s[i], &y0[i]);
+    modem_modulate_block(mod1, s, n, y1);
+    for (i=0; i<n; i++) {
+        CONTEND_EQUALITY(crealf(y0[i]), crealf(y1[i]));
+        CONTEND_EQUALITY(cimagf(y0[i]), cimagf(y1[i]));
+    }
+
+    // add noise within decision regions
+    float a = 0.1f*dmin;
+    for (i=0; i<n; i++) {
+        y0[i] += a*(2.0f*randf() - 1.0f) + _Complex_I*a*(2.0f*randf() - 1.0f);
+        y1[i] = y0[i];
+    }
+
+    // hard demodulation
+    unsigned int sym;
+    unsigned char s_hat[n];
+    modem_demodulate_block(demod1, y1, n, s_hat);
+    for (i=0; i<n; i++) {
+        modem_demodulate(demod0, y0[i], &sym);
+        CONTEND_EQUALITY(sym,      s[i]);
+        CONTEND_EQUALITY(s_hat[i], s[i]);
+    }
+
+    // soft demodulation
+    modem_reset(demod0);
+    modem_reset(demod1);
+    unsigned char soft0[n*bps];
+    unsigned char soft1[n*bps];
+    modem_demodulate_soft_block(demod1, y1, n, s_hat, soft1);
+    for (i=0; i<n; i++) {
+        modem_demodulate_soft(demod0, y0[i], &sym, &soft0[i*bps]);
+        CONTEND_EQUALITY(s_hat[i], s[i]);
+    }
+    for (i=0; i<n*bps; i++)
+        CONTEND_DELTA((int)soft0[i], (int)soft1[i], 1);
+
+    modem_destroy(mod0);
+    modem_destroy(mod1);
+    modem_destroy(demod0);
+    modem_destroy(demod1);
+}
+
+// AUTOTESTS: schemes with block kernels
+void autotest_modem_block_psk2()    { modem_test_block(LIQUID_MODEM_PSK2);    }
+void autotest_modem_block_psk8()    { modem_test_block(LIQUID_MODEM_PSK8);    }
+void autotest_modem_block_psk64()   { modem_test_block(LIQUID_MODEM_PSK64);   }
+void autotest_modem_block_psk256()  { modem_test_block(LIQUID_MODEM_PSK256);  }
+void autotest_modem_block_qam4()    { modem_test_block(LIQUID_MODEM_QAM4);    }
+void autotest_modem_block_qam8()    { modem_test_block(LIQUID_MODEM_QAM8);    }
+void autotest_modem_block_qam16()   { modem_test_block(LIQUID_MODEM_QAM16);   }
+void autotest_modem_block_qam32()   { modem_test_block(LIQUID_MODEM_QAM32);   }
+void autotest_modem_block_qam64()   { modem_test_block(LIQUID_MODEM_QAM64);   }
+void autotest_modem_block_qam128()  { modem_test_block(LIQUID_MODEM_QAM128);  }
+void autotest_modem_block_qam256()  { modem_test_block(LIQUID_MODEM_QAM256);  }
+void autotest_modem_block_apsk4()   { modem_test_block(LIQUID_MODEM_APSK4);   }
+void autotest_modem_block_apsk16()  { modem_test_block(LIQUID_MODEM_APSK16);  }
+void autotest_modem_block_apsk64()  { modem_test_block(LIQUID_MODEM_APSK64);  }
+void autotest_modem_block_apsk256() { modem_test_block(LIQUID_MODEM_APSK256); }
+void autotest_modem_block_bpsk()    { modem_test_block(LIQUID_MODEM_BPSK);    }
+void autotest_modem_block_qpsk()    { modem_test_block(LIQUID_MODEM_QPSK);    }
+
+// AUTOTESTS: symbol-by-symbol fall-backs
+void autotest_modem_block_dpsk4()   { modem_test_block(LIQUID_MODEM_DPSK4);   }
+void autotest_modem_block_ask8()    { modem_test_block(LIQUID_MODEM_ASK8);    }
+void autotest_modem_block_sqam32()  { modem_test_block(LIQUID_MODEM_SQAM32);  }
+void autotest_modem_block_arb64opt(){ modem_test_block(LIQUID_MODEM_ARB64OPT);}
+
@@ -24,6 +24,8 @@
 // soft demodulation tests
 //
 
+#include <stdlib.h>
+#include <math.h>
 #include "autotest/autotest.h"
 #include "liquid.h"
 
@@ -128,3 +130,58 @@ void autotest_demodsoft_arb128opt() { modem_test_demodsoft(LIQUID_MODEM_ARB128OP
 void autotest_demodsoft_arb256opt() { modem_test_demodsoft(LIQUID_MODEM_ARB256OPT); }
 void autotest_demodsoft_arb64vt()   { modem_test_demodsoft(LIQUID_MODEM_ARB64VT);   }
 
+
+// Compare closed-form soft bits against exact max-log likelihood ratios
+// computed over the entire constellation: the decision (side of 127) must
+// agree wherever the exact ratio is not ambiguous, and bits closest to a
+// decision boundary (where both are linear) must be close.
+void modem_test_demodsoft_llr(modulation_scheme _ms)
+{
+    modem q = modem_create(_ms);
+    float scale = 0.02f;    // keep most soft bits from saturating
+    modem_set_llr_scale(q, scale);
+    CONTEND_EQUALITY(modem_get_llr_scale(q), scale);
+
+    unsigned int bps = modem_get_bps(q);
+    unsigned int M   = 1 << bps;
+    unsigned int i, j, k;
+    float complex c[M];
+    for (i=0; i<M; i++)
+        modem_modulate(q, i, &c[i]);
+
+    unsigned int  s;
+    unsigned char soft_bits[bps];
+    for (i=0; i<1000; i++) {
+        float complex x = c[rand() % M] + 0.3f*(randnf() + _Complex_I*randnf())/sqrtf((float)M);
+        modem_demodulate_soft(q, x, &s, soft_bits);
+        for (k=0; k<bps; k++) {
+            float dmin_0 = 1e9f;
+            float dmin_1 = 1e9f;
+            for (j=0; j<M; j++) {
+                float d = crealf((x-c[j])*conjf(x-c[j]));
+                if ((j >> (bps-k-1)) & 1) dmin_1 = d < dmin_1 ? d : dmin_1;
+                else                      dmin_0 = d < dmin_0 ? d : dmin_0;
+            }
+            float v = (dmin_0 - dmin_1)*1.2f*M*scale*16;
+            if (v > 3.0f) {
+                CONTEND_GREATER_THAN(soft_bits[k], 127);
+            } else if (v < -3.0f) {
+                CONTEND_LESS_THAN(soft_bits[k], 127);
+            } else {
+                CONTEND_DELTA((float)soft_bits[k], v + 127.0f, 4.0f);
+            }
+        }
+    }
+    modem_destroy(q);
+}
+
+// AUTOTESTS: closed-form soft bits
+void autotest_demodsoft_llr_qam4()    { modem_test_demodsoft_llr(LIQUID_MODEM_QAM4);    }
+void autotest_demodsoft_llr_qam8()    { modem_test_demodsoft_llr(LIQUID_MODEM_QAM8);    }
+void autotest_demodsoft_llr_qam16()   { modem_test_demodsoft_llr(LIQUID_MODEM_QAM16);   }
+void autotest_demodsoft_llr_qam32()   { modem_test_demodsoft_llr(LIQUID_MODEM_QAM32);   }
+void autotest_demodsoft_llr_qam64()   { modem_test_demodsoft_llr(LIQUID_MODEM_QAM64);   }
+void autotest_demodsoft_llr_qam128()  { modem_test_demodsoft_llr(LIQUID_MODEM_QAM128);  }
+void autotest_demodsoft_llr_qam256()  { modem_test_demodsoft_llr(LIQUID_MODEM_QAM256);  }
+void autotest_demodsoft_llr_sqam32()  { modem_test_demodsoft_llr(LIQUID_MODEM_SQAM32);  }
+void autotest_demodsoft_llr_sqam128() { modem_test_demodsoft_llr(LIQUID_MODEM_SQAM128); }
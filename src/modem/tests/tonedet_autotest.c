@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include "autotest/autotest.h"
+#include "liquid.h"
+
+// Compare multi-tone detector output against direct DFT computed in
+// double precision
+void tonedet_test_execute(unsigned int _n,
+                          unsigned int _num_tones)
+{
+    float tol = 1e-4f * _n;
+
+    // random tones, including negative and out-of-band frequencies
+    unsigned int i, j;
+    float freqs[_num_tones];
+    for (j=0; j<_num_tones; j++)
+        freqs[j] = 1.5f*randf() - 0.75f;
+
+    float complex x[_n];
+    for (i=0; i<_n; i++)
+        x[i] = randnf() + _Complex_I*randnf();
+
+    tonedet q = tonedet_create(_n, _num_tones, freqs);
+    CONTEND_EQUALITY(tonedet_get_length(q),    _n);
+    CONTEND_EQUALITY(tonedet_get_num_tones(q), _num_tones);
+
+    float complex X[_num_tones];
+    tonedet_execute(q, x, X);
+
+    for (j=0; j<_num_tones; j++) {
+        double complex v = 0;
+        for (i=0; i<_n; i++)
+            v += x[i] * cexp(-_Complex_I*2*M_PI*(double)freqs[j]*(double)i);
+        CONTEND_DELTA(crealf(X[j]), creal(v), tol);
+        CONTEND_DELTA(cimagf(X[j]), cimag(v), tol);
+    }
+
+    tonedet_destroy(q);
+}
+
+// AUTOTESTS: execute
+void autotest_tonedet_execute_n1_t1()       { tonedet_test_execute(   1,  1); }
+void autotest_tonedet_execute_n7_t3()       { tonedet_test_execute(   7,  3); }
+void autotest_tonedet_execute_n16_t4()      { tonedet_test_execute(  16,  4); }
+void autotest_tonedet_execute_n25_t5()      { tonedet_test_execute(  25,  5); }
+void autotest_tonedet_execute_n100_t9()     { tonedet_test_execute( 100,  9); }
+void autotest_tonedet_execute_n2048_t2()    { tonedet_test_execute(2048,  2); }
+
+// Detect tones in noise; bins are spaced so that the transmitted tone is
+// the only strong correlator output
+void autotest_tonedet_detect()
+{
+    unsigned int n         = 64;    // samples per block
+    unsigned int num_tones = 6;     // number of tones
+    float        SNRdB     = 10.0f; // signal-to-noise ratio [dB]
+
+    unsigned int i, j;
+    float freqs[num_tones];
+    for (j=0; j<num_tones; j++)
+        freqs[j] = ((float)j - 2.5f) * 4.0f / (float)n;
+
+    tonedet q = tonedet_create(n, num_tones, freqs);
+
+    float nstd = powf(10.0f, -SNRdB/20.0f);
+    float complex x[n];
+    for (j=0; j<num_tones; j++) {
+        for (i=0; i<n; i++) {
+            x[i] = cexpf(_Complex_I*2*M_PI*freqs[j]*i + _Complex_I*0.3f*j);
+            x[i] += nstd*(randnf() + _Complex_I*randnf())*M_SQRT1_2;
+        }
+        CONTEND_EQUALITY(tonedet_detect(q, x), j);
+    }
+
+    tonedet_destroy(q);
+}
+
@@ -280,34 +280,54 @@ void ofdmframegen_writesymbol(ofdmframegen    _q,
                               float complex * _x,
                               float complex * _y)
 {
-    // move frequency data to internal buffer
+    ofdmframegen_writesymbols(_q, _x, 1, _y);
+}
+
+// write multiple OFDM symbols directly to contiguous output buffer
+//  _q              :   framing generator object
+//  _x              :   input symbols, [size: _num_symbols*_M x 1]
+//  _num_symbols    :   number of OFDM symbols to write
+//  _y              :   output samples, [size: _num_symbols*(_M+_cp_len) x 1]
+void ofdmframegen_writesymbols(ofdmframegen    _q,
+                               float complex * _x,
+                               unsigned int    _num_symbols,
+                               float complex * _y)
+{
+    unsigned int symbol_len = _q->M + _q->cp_len;
     unsigned int i;
     unsigned int k;
+    unsigned int n;
     int sctype;
-    for (i=0; i<_q->M; i++) {
-        // start at mid-point (effective fftshift)
-        k = (i + _q->M/2) % _q->M;
-
-        sctype = _q->p[k];
-        if (sctype==OFDMFRAME_SCTYPE_NULL) {
-            // disabled subcarrier
-            _q->X[k] = 0.0f;
-        } else if (sctype==OFDMFRAME_SCTYPE_PILOT) {
-            // pilot subcarrier
-            _q->X[k] = (msequence_advance(_q->ms_pilot) ? 1.0f : -1.0f) * _q->g_data;
-        } else {
-            // data subcarrier
-            _q->X[k] = _x[k] * _q->g_data;
+    for (n=0; n<_num_symbols; n++) {
+        float complex * x = &_x[n*_q->M];
+        float complex * y = &_y[n*symbol_len];
+
+        // load frequency data into transform buffer (effective fftshift)
+        for (i=0; i<_q->M; i++) {
+            k = (i + _q->M/2) % _q->M;
+
+            sctype = _q->p[k];
+            if (sctype==OFDMFRAME_SCTYPE_NULL)
+                _q->X[k] = 0.0f;
+            else if (sctype==OFDMFRAME_SCTYPE_PILOT)
+                _q->X[k] = (msequence_advance(_q->ms_pilot) ? 1.0f : -1.0f) * _q->g_data;
+            else
+                _q->X[k] = x[k] * _q->g_data;
         }
 
-        //printf("X[%3u] = %12.8f + j*%12.8f;\n",i+1,crealf(_q->X[i]),cimagf(_q->X[i]));
-    }
+        // execute transform
+        FFT_EXECUTE(_q->ifft);
 
-    // execute transform
-    FFT_EXECUTE(_q->ifft);
+        // write symbol to output; for all but the first symbol the post-fix
+        // of the previous symbol is read from the output buffer itself, the
+        // head of its body which remains untouched by the taper
+        float complex * postfix = n == 0 ? _q->postfix : &_y[(n-1)*symbol_len + _q->cp_len];
+        ofdmframegen_gensymbol_overlap(_q, postfix, y);
+    }
 
-    // copy result to output, adding cyclic prefix and tapering window
-    ofdmframegen_gensymbol(_q, _y);
+    // retain post-fix of last symbol for the next call
+    if (_num_symbols > 0)
+        memmove(_q->postfix, _q->x, _q->taper_len*sizeof(float complex));
 }
 
 // write tail to output
@@ -345,18 +365,34 @@ void ofdmframegen_writetail(ofdmframegen    _q,
 void ofdmframegen_gensymbol(ofdmframegen    _q,
                             float complex * _buffer)
 {
-    // copy input symbol with cyclic prefix to output symbol
-    memmove( &_buffer[0],          &_q->x[_q->M-_q->cp_len], _q->cp_len*sizeof(float complex));
-    memmove( &_buffer[_q->cp_len], &_q->x[               0], _q->M    * sizeof(float complex));
-    
-    // apply tapering window to over-lapping regions
-    unsigned int i;
-    for (i=0; i<_q->taper_len; i++) {
-        _buffer[i] *= _q->taper[i];
-        _buffer[i] += _q->postfix[i] * _q->taper[_q->taper_len-i-1];
-    }
+    // copy input symbol with cyclic prefix to output symbol, overlapping
+    // with post-fix of previous symbol
+    ofdmframegen_gensymbol_overlap(_q, _q->postfix, _buffer);
 
     // copy post-fix to output (first 'taper_len' samples of input symbol)
     memmove(_q->postfix, _q->x, _q->taper_len*sizeof(float complex));
 }
 
+// generate symbol (add cyclic prefix) and overlap with external post-fix
+//  _q              :   framing generator object
+//  _postfix        :   post-fix from previous symbol [size: _q->taper_len x 1]
+//  _buffer         :   output sample buffer [size: (_q->M + _q->cp_len) x 1]
+void ofdmframegen_gensymbol_overlap(ofdmframegen    _q,
+                                    float complex * _postfix,
+                                    float complex * _buffer)
+{
+    // copy input symbol with cyclic prefix to output symbol
+    memmove( &_buffer[0],          &_q->x[_q->M-_q->cp_len], _q->cp_len*sizeof(float complex));
+    memmove( &_buffer[_q->cp_len], &_q->x[               0], _q->M    * sizeof(float complex));
+
+    // apply tapering window to over-lapping regions in a single pass; the
+    // real-valued window is applied to each in-phase/quadrature component
+    // independently so the loop is trivially vectorizable
+    float * b = (float*) _buffer;
+    float * p = (float*) _postfix;
+    float * w = _q->taper;
+    unsigned int L = _q->taper_len;
+    unsigned int i;
+    for (i=0; i<2*L; i++)
+        b[i] = b[i]*w[i>>1] + p[i]*w[L-(i>>1)-1];
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2007 - 2016 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <complex.h>
+#include <math.h>
+
+#include "autotest/autotest.h"
+#include "liquid.h"
+
+// Helper function to keep code base small; compares block symbol writer
+// against symbol-by-symbol generation
+//  _num_subcarriers    :   number of subcarriers
+//  _cp_len             :   cyclic prefix lenght
+//  _taper_len          :   taper length
+void ofdmframegen_writesymbols_test(unsigned int _num_subcarriers,
+                                    unsigned int _cp_len,
+                                    unsigned int _taper_len)
+{
+    // options
+    unsigned int M         = _num_subcarriers;  // number of subcarriers
+    unsigned int cp_len    = _cp_len;           // cyclic prefix lenght
+    unsigned int taper_len = _taper_len;        // taper length
+    unsigned int num_symbols = 6;               // number of data symbols
+    float tol              = 1e-6f;             // error tolerance
+
+    // derived values
+    unsigned int symbol_len = M + cp_len;
+
+    // create frame generators
+    ofdmframegen fg0 = ofdmframegen_create(M, cp_len, taper_len, NULL);
+    ofdmframegen fg1 = ofdmframegen_create(M, cp_len, taper_len, NULL);
+
+    // generate random subcarrier symbols
+    unsigned int i;
+    float complex X[num_symbols*M];
+    for (i=0; i<num_symbols*M; i++)
+        X[i] = cexpf(_Complex_I*2*M_PI*randf());
+
+    // generate frames: preamble, data symbols (block writer split into two
+    // calls to test carrying post-fix across calls), and tail
+    float complex y0[(num_symbols+4)*symbol_len];
+    float complex y1[(num_symbols+4)*symbol_len];
+    memset(y0, 0x00, sizeof(y0));
+    memset(y1, 0x00, sizeof(y1));
+
+    ofdmframegen_write_S0a(fg0, &y0[0*symbol_len]);
+    ofdmframegen_write_S0b(fg0, &y0[1*symbol_len]);
+    ofdmframegen_write_S1 (fg0, &y0[2*symbol_len]);
+    for (i=0; i<num_symbols; i++)
+        ofdmframegen_writesymbol(fg0, &X[i*M], &y0[(3+i)*symbol_len]);
+    ofdmframegen_writetail(fg0, &y0[(3+num_symbols)*symbol_len]);
+
+    ofdmframegen_write_S0a(fg1, &y1[0*symbol_len]);
+    ofdmframegen_write_S0b(fg1, &y1[1*symbol_len]);
+    ofdmframegen_write_S1 (fg1, &y1[2*symbol_len]);
+    ofdmframegen_writesymbols(fg1, X, 2, &y1[3*symbol_len]);
+    ofdmframegen_writesymbols(fg1, &X[2*M], num_symbols-2, &y1[5*symbol_len]);
+    ofdmframegen_writetail(fg1, &y1[(3+num_symbols)*symbol_len]);
+
+    // compare outputs
+    for (i=0; i<(num_symbols+4)*symbol_len; i++) {
+        CONTEND_DELTA( crealf(y0[i]), crealf(y1[i]), tol );
+        CONTEND_DELTA( cimagf(y0[i]), cimagf(y1[i]), tol );
+    }
+
+    // destroy objects
+    ofdmframegen_destroy(fg0);
+    ofdmframegen_destroy(fg1);
+}
+
+void autotest_ofdmframegen_writesymbols_n64()   { ofdmframegen_writesymbols_test(  64,  8,  4); }
+void autotest_ofdmframegen_writesymbols_n128()  { ofdmframegen_writesymbols_test( 128, 16,  0); }
+void autotest_ofdmframegen_writesymbols_n256()  { ofdmframegen_writesymbols_test( 256, 32, 32); }
+
+// test writing OFDM flexframe directly into output buffer
+void autotest_ofdmflexframegen_write_symbols()
+{
+    // options
+    unsigned int M           = 64;      // number of subcarriers
+    unsigned int cp_len      = 16;      // cyclic prefix length
+    unsigned int taper_len   = 4;       // taper length
+    unsigned int payload_len = 120;     // payload length
+    float        tol         = 1e-6f;   // error tolerance
+
+    // create frame generators
+    ofdmflexframegen fg0 = ofdmflexframegen_create(M, cp_len, taper_len, NULL, NULL);
+    ofdmflexframegen fg1 = ofdmflexframegen_create(M, cp_len, taper_len, NULL, NULL);
+
+    unsigned int i;
+    unsigned char header[8];
+    unsigned char payload[payload_len];
+    for (i=0; i<8; i++)           header[i]  = rand() & 0xff;
+    for (i=0; i<payload_len; i++) payload[i] = rand() & 0xff;
+
+    ofdmflexframegen_assemble(fg0, header, payload, payload_len);
+    ofdmflexframegen_assemble(fg1, header, payload, payload_len);
+
+    // frame length including tail symbol
+    unsigned int num_symbols = ofdmflexframegen_getframelen(fg0) + 1;
+    unsigned int num_samples = num_symbols * (M + cp_len);
+    float complex y0[num_samples];
+    float complex y1[num_samples];
+
+    // write sample-by-sample and block-wise, re-seeding the generator as
+    // unused subcarriers are filled with random symbols
+    srand(1);
+    int complete0 = ofdmflexframegen_write(fg0, y0, num_samples);
+    srand(1);
+    int complete1 = ofdmflexframegen_write_symbols(fg1, y1, num_symbols);
+    CONTEND_EQUALITY(complete0, 1);
+    CONTEND_EQUALITY(complete1, 1);
+
+    for (i=0; i<num_samples; i++) {
+        CONTEND_DELTA( crealf(y0[i]), crealf(y1[i]), tol );
+        CONTEND_DELTA( cimagf(y0[i]), cimagf(y1[i]), tol );
+    }
+
+    ofdmflexframegen_destroy(fg0);
+    ofdmflexframegen_destroy(fg1);
+}
+
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <sys/resource.h>
+#include <stdlib.h>
+#include <math.h>
+#include "liquid.h"
+
+#define DDC_BENCH_BLOCK (1024)  // input samples per block
+
+// Helper function to keep code base small; trials are counted per input
+// sample
+//  _M      :   decimation rate
+//  _m      :   filter delay (Kaiser filter of length 2*_M*_m)
+//  _agc    :   run automatic gain control?
+//  _ddc    :   use down-converter (1) or nco_crcf/firdecim_crcf/agc_crcf chain (0)
+void ddc_bench(struct rusage *     _start,
+               struct rusage *     _finish,
+               unsigned long int * _num_iterations,
+               unsigned int        _M,
+               unsigned int        _m,
+               int                 _agc,
+               int                 _ddc)
+{
+    unsigned long int num_blocks = *_num_iterations / 64 + 1;
+    unsigned int n = DDC_BENCH_BLOCK / _M;  // outputs per block
+    float fc = 0.2f;
+    unsigned int i;
+
+    float complex x[DDC_BENCH_BLOCK];
+    float complex v[DDC_BENCH_BLOCK];
+    float complex y[DDC_BENCH_BLOCK];
+    for (i=0; i<DDC_BENCH_BLOCK; i++)
+        x[i] = (i%2) ? 1.0f : -1.0f;
+
+    unsigned long int t;
+    if (_ddc) {
+        ddc_crcf q = ddc_crcf_create_kaiser(fc, _M, _m, 60.0f);
+        if (_agc)
+            ddc_crcf_agc_enable(q);
+        getrusage(RUSAGE_SELF, _start);
+        for (t=0; t<num_blocks; t++)
+            ddc_crcf_execute_block(q, x, n, y);
+        getrusage(RUSAGE_SELF, _finish);
+        ddc_crcf_destroy(q);
+    } else {
+        // same oscillator type as the down-converter
+        nco_crcf      nco = nco_crcf_create(LIQUID_NCO_INTERP);
+        firdecim_crcf dec = firdecim_crcf_create_kaiser(_M, _m, 60.0f);
+        agc_crcf      agc = agc_crcf_create();
+        nco_crcf_set_frequency(nco, fc);
+        getrusage(RUSAGE_SELF, _start);
+        for (t=0; t<num_blocks; t++) {
+            nco_crcf_mix_block_down(nco, x, v, DDC_BENCH_BLOCK);
+            firdecim_crcf_execute_block(dec, v, n, y);
+            if (_agc)
+                agc_crcf_execute_block(agc, y, n, y);
+        }
+        getrusage(RUSAGE_SELF, _finish);
+        nco_crcf_destroy(nco);
+        firdecim_crcf_destroy(dec);
+        agc_crcf_destroy(agc);
+    }
+    *_num_iterations = num_blocks * DDC_BENCH_BLOCK;
+}
+
+#define DDC_BENCHMARK_API(M,m,AGC,DDC)          \
+(   struct rusage *_start,                      \
+    struct rusage *_finish,                     \
+    unsigned long int *_num_iterations)         \
+{ ddc_bench(_start, _finish, _num_iterations, M, m, AGC, DDC); }
+
+// down-converter vs. chain of objects
+void benchmark_ddc_crcf_M4              DDC_BENCHMARK_API( 4, 4, 0, 1)
+void benchmark_ddc_crcf_M16             DDC_BENCHMARK_API(16, 4, 0, 1)
+void benchmark_ddc_crcf_M4_agc          DDC_BENCHMARK_API( 4, 4, 1, 1)
+void benchmark_ddc_crcf_M16_agc         DDC_BENCHMARK_API(16, 4, 1, 1)
+void benchmark_ddc_chain_M4             DDC_BENCHMARK_API( 4, 4, 0, 0)
+void benchmark_ddc_chain_M16            DDC_BENCHMARK_API(16, 4, 0, 0)
+void benchmark_ddc_chain_M4_agc         DDC_BENCHMARK_API( 4, 4, 1, 0)
+void benchmark_ddc_chain_M16_agc        DDC_BENCHMARK_API(16, 4, 1, 0)
@@ -99,3 +99,101 @@ void benchmark_nco_mix_block_up(struct rusage *_start,
     nco_crcf_destroy(p);
 }
 
+
+void benchmark_nco_interp_sincos(struct rusage *_start,
+                                 struct rusage *_finish,
+                                 unsigned long int *_num_iterations)
+{
+    float s, c;
+    nco_crcf p = nco_crcf_create(LIQUID_NCO_INTERP);
+    nco_crcf_set_phase(p, 0.0f);
+    nco_crcf_set_frequency(p, 0.1f);
+
+    unsigned int i;
+
+    // increase number of iterations for NCO
+    *_num_iterations *= 100;
+
+    getrusage(RUSAGE_SELF, _start);
+    for (i=0; i<(*_num_iterations); i++) {
+        nco_crcf_sincos(p, &s, &c);
+        nco_crcf_step(p);
+    }
+    getrusage(RUSAGE_SELF, _finish);
+
+    nco_crcf_destroy(p);
+}
+
+void benchmark_nco_interp_mix_block_up(struct rusage *_start,
+                                       struct rusage *_finish,
+                                       unsigned long int *_num_iterations)
+{
+    float complex x[256], y[256];
+    memset(x, 0, 256*sizeof(float complex));
+
+    nco_crcf p = nco_crcf_create(LIQUID_NCO_INTERP);
+    nco_crcf_set_phase(p, 0.0f);
+    nco_crcf_set_frequency(p, 0.1f);
+
+    unsigned int i;
+
+    getrusage(RUSAGE_SELF, _start);
+    for (i=0; i<(*_num_iterations); i++) {
+        nco_crcf_mix_block_up(p, x, y, 256);
+    }
+    getrusage(RUSAGE_SELF, _finish);
+
+    *_num_iterations *= 256;
+    nco_crcf_destroy(p);
+}
+
+// phase-locked loop, per-sample phase detector and loop-filter update
+void benchmark_nco_interp_pll_step(struct rusage *_start,
+                                   struct rusage *_finish,
+                                   unsigned long int *_num_iterations)
+{
+    float complex x[256], y[256];
+    unsigned int i, j;
+    for (i=0; i<256; i++)
+        x[i] = cexpf(_Complex_I*0.01f*i);
+
+    nco_crcf p = nco_crcf_create(LIQUID_NCO_INTERP);
+    nco_crcf_pll_set_bandwidth(p, 1e-4f);
+
+    getrusage(RUSAGE_SELF, _start);
+    for (i=0; i<(*_num_iterations); i++) {
+        for (j=0; j<256; j++) {
+            nco_crcf_mix_down(p, x[j], &y[j]);
+            nco_crcf_pll_step(p, cargf(y[j]));
+            nco_crcf_step(p);
+        }
+    }
+    getrusage(RUSAGE_SELF, _finish);
+
+    *_num_iterations *= 256;
+    nco_crcf_destroy(p);
+}
+
+// block phase-locked loop, loop-filter update every 32 samples
+void benchmark_nco_interp_pll_mix_block_down(struct rusage *_start,
+                                             struct rusage *_finish,
+                                             unsigned long int *_num_iterations)
+{
+    float complex x[256], y[256];
+    unsigned int i;
+    for (i=0; i<256; i++)
+        x[i] = cexpf(_Complex_I*0.01f*i);
+
+    nco_crcf p = nco_crcf_create(LIQUID_NCO_INTERP);
+    nco_crcf_pll_set_bandwidth(p, 1e-4f);
+    nco_crcf_pll_set_interval(p, 32);
+
+    getrusage(RUSAGE_SELF, _start);
+    for (i=0; i<(*_num_iterations); i++) {
+        nco_crcf_pll_mix_block_down(p, x, y, 256);
+    }
+    getrusage(RUSAGE_SELF, _finish);
+
+    *_num_iterations *= 256;
+    nco_crcf_destroy(p);
+}
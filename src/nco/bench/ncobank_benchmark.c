@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <sys/resource.h>
+#include <stdlib.h>
+#include <math.h>
+#include "liquid.h"
+
+#define NCOBANK_BENCH_BLOCK (256)   // input samples per block
+
+// Helper function to keep code base small; trials are counted per
+// carrier and input sample
+//  _num    :   number of carriers
+//  _M      :   decimation rate (0: no decimator)
+//  _h_len  :   filter length
+//  _bank   :   use nco bank (1) or separate nco_crcf/firdecim_crcf objects (0)
+void ncobank_bench(struct rusage *     _start,
+                   struct rusage *     _finish,
+                   unsigned long int * _num_iterations,
+                   unsigned int        _num,
+                   unsigned int        _M,
+                   unsigned int        _h_len,
+                   int                 _bank)
+{
+    unsigned long int num_blocks = *_num_iterations / (2*_num) + 1;
+    unsigned int M = _M == 0 ? 1 : _M;
+    unsigned int n = NCOBANK_BENCH_BLOCK / M;   // outputs per block
+    unsigned int i, k;
+
+    float freqs[_num];
+    for (k=0; k<_num; k++)
+        freqs[k] = 2*M_PI*((float)k/(float)_num - 0.5f);
+    float h[_h_len > 0 ? _h_len : 1];
+    for (i=0; i<_h_len; i++)
+        h[i] = 1.0f / (float)_h_len;
+
+    float complex x[NCOBANK_BENCH_BLOCK];
+    float complex v[NCOBANK_BENCH_BLOCK];
+    float complex * y = (float complex*) malloc(_num*NCOBANK_BENCH_BLOCK*sizeof(float complex));
+    for (i=0; i<NCOBANK_BENCH_BLOCK; i++)
+        x[i] = (i%2) ? 1.0f : -1.0f;
+
+    unsigned long int t;
+    if (_bank) {
+        ncobank_crcf q = _M == 0 ? ncobank_crcf_create(_num, freqs) :
+                                   ncobank_crcf_create_decim(_num, freqs, _M, h, _h_len);
+        getrusage(RUSAGE_SELF, _start);
+        for (t=0; t<num_blocks; t++)
+            ncobank_crcf_execute(q, x, n, y);
+        getrusage(RUSAGE_SELF, _finish);
+        ncobank_crcf_destroy(q);
+    } else {
+        nco_crcf      nco[_num];
+        firdecim_crcf dec[_num];
+        for (k=0; k<_num; k++) {
+            nco[k] = nco_crcf_create(LIQUID_NCO);
+            nco_crcf_set_frequency(nco[k], freqs[k]);
+            dec[k] = _M == 0 ? NULL : firdecim_crcf_create(_M, h, _h_len);
+        }
+        getrusage(RUSAGE_SELF, _start);
+        for (t=0; t<num_blocks; t++) {
+            for (k=0; k<_num; k++) {
+                if (_M == 0) {
+                    nco_crcf_mix_block_down(nco[k], x, &y[k*n], NCOBANK_BENCH_BLOCK);
+                } else {
+                    nco_crcf_mix_block_down(nco[k], x, v, NCOBANK_BENCH_BLOCK);
+                    firdecim_crcf_execute_block(dec[k], v, n, &y[k*n]);
+                }
+            }
+        }
+        getrusage(RUSAGE_SELF, _finish);
+        for (k=0; k<_num; k++) {
+            nco_crcf_destroy(nco[k]);
+            if (_M != 0) firdecim_crcf_destroy(dec[k]);
+        }
+    }
+    *_num_iterations = num_blocks * NCOBANK_BENCH_BLOCK * _num;
+    free(y);
+}
+
+#define NCOBANK_BENCHMARK_API(NUM,M,H_LEN,BANK) \
+(   struct rusage *_start,                      \
+    struct rusage *_finish,                     \
+    unsigned long int *_num_iterations)         \
+{ ncobank_bench(_start, _finish, _num_iterations, NUM, M, H_LEN, BANK); }
+
+// mixing only: bank vs. separate oscillators
+void benchmark_ncobank_crcf_n8          NCOBANK_BENCHMARK_API( 8, 0,  0, 1)
+void benchmark_ncobank_crcf_n32         NCOBANK_BENCHMARK_API(32, 0,  0, 1)
+void benchmark_ncobank_nco_crcf_n8      NCOBANK_BENCHMARK_API( 8, 0,  0, 0)
+void benchmark_ncobank_nco_crcf_n32     NCOBANK_BENCHMARK_API(32, 0,  0, 0)
+
+// mixing and decimation: bank vs. oscillator/decimator chains
+void benchmark_ncobank_crcf_n8_m4_h32           NCOBANK_BENCHMARK_API( 8, 4, 32, 1)
+void benchmark_ncobank_crcf_n32_m16_h128        NCOBANK_BENCHMARK_API(32,16,128, 1)
+void benchmark_ncobank_firdecim_crcf_n8_m4_h32  NCOBANK_BENCHMARK_API( 8, 4, 32, 0)
+void benchmark_ncobank_firdecim_crcf_n32_m16_h128 NCOBANK_BENCHMARK_API(32,16,128, 0)
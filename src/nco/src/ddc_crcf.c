@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+//
+// ddc_crcf : digital down-converter
+//
+// Fuses the chain nco_crcf (mix down) -> firdecim_crcf -> agc_crcf into a
+// single object. The input is processed in chunks: each chunk is optionally
+// stripped of its DC offset and mixed down directly into the tail of the
+// filter buffer, the decimator computes only the retained outputs from that
+// buffer while it is still in cache, and the gain is applied to the
+// (decimated) output.
+//
+// The DC offset and the output energy are both tracked by single-pole
+// averages as in iirfilt_crcf_create_dc_blocker() and agc_crcf; rather than
+// updating per sample, each estimate (and the gain) is held over a chunk
+// and then updated once by the amount the per-sample loop would move it for
+// a chunk of constant level. This removes the per-sample exponential and
+// logarithm of the gain control loop.
+//
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "liquid.internal.h"
+
+#define DDC_CHUNK   (256)   // input samples per chunk
+
+struct ddc_crcf_s {
+    // mixer
+    nco_crcf        nco;            // oscillator (LIQUID_NCO_INTERP)
+
+    // decimator
+    unsigned int    M;              // decimation rate
+    unsigned int    h_len;          // filter length
+    unsigned int    C;              // outputs per chunk
+    dotprod_crcf    dp;             // filter dot product (reversed taps)
+    float complex * buf;            // filter buffer [size: buf_len x 1]
+    unsigned int    buf_len;        // h_len-1 + C*M
+
+    // DC offset removal
+    int             dc_enabled;     // DC removal enabled?
+    float           dc_alpha;       // DC estimate bandwidth
+    float complex   dc;             // DC offset estimate
+
+    // automatic gain control
+    int             agc_enabled;    // AGC enabled?
+    float           agc_alpha;      // AGC bandwidth (output rate)
+    float           g;              // gain
+};
+
+// create digital down-converter; filter and decimation rate are as for
+// firdecim_crcf_create()
+//  _fc     :   carrier frequency [radians/sample]
+//  _M      :   decimation rate, _M > 0
+//  _h      :   filter coefficients [size: _h_len x 1]
+//  _h_len  :   filter length, _h_len > 0
+ddc_crcf ddc_crcf_create(float        _fc,
+                         unsigned int _M,
+                         float *      _h,
+                         unsigned int _h_len)
+{
+    // validate input
+    if (_M == 0) {
+        fprintf(stderr,"error: ddc_crcf_create(), decimation rate must be greater than zero\n");
+        exit(1);
+    } else if (_h_len == 0) {
+        fprintf(stderr,"error: ddc_crcf_create(), filter length must be greater than zero\n");
+        exit(1);
+    }
+
+    ddc_crcf q = (ddc_crcf) malloc(sizeof(struct ddc_crcf_s));
+
+    // mixer
+    q->nco = nco_crcf_create(LIQUID_NCO_INTERP);
+    nco_crcf_set_frequency(q->nco, _fc);
+
+    // load filter in reverse order
+    float hr[_h_len];
+    unsigned int i;
+    for (i=0; i<_h_len; i++)
+        hr[i] = _h[_h_len-i-1];
+    q->dp = dotprod_crcf_create(hr, _h_len);
+
+    q->M       = _M;
+    q->h_len   = _h_len;
+    q->C       = _M < DDC_CHUNK ? DDC_CHUNK / _M : 1;
+    q->buf_len = _h_len - 1 + q->C*_M;
+    q->buf     = (float complex*) malloc(q->buf_len*sizeof(float complex));
+
+    // DC removal and AGC are disabled by default
+    q->dc_enabled  = 0;
+    q->dc_alpha    = 1e-3f;
+    q->agc_enabled = 0;
+    q->agc_alpha   = 1e-2f;
+
+    ddc_crcf_reset(q);
+    return q;
+}
+
+// create digital down-converter with Kaiser filter; filter design is as
+// for firdecim_crcf_create_kaiser()
+//  _fc     :   carrier frequency [radians/sample]
+//  _M      :   decimation rate, _M > 1
+//  _m      :   filter delay (output samples), _m > 0
+//  _As     :   stop-band attenuation [dB]
+ddc_crcf ddc_crcf_create_kaiser(float        _fc,
+                                unsigned int _M,
+                                unsigned int _m,
+                                float        _As)
+{
+    // validate input
+    if (_M < 2) {
+        fprintf(stderr,"error: ddc_crcf_create_kaiser(), decimation rate must be greater than 1\n");
+        exit(1);
+    } else if (_m == 0) {
+        fprintf(stderr,"error: ddc_crcf_create_kaiser(), filter delay must be greater than 0\n");
+        exit(1);
+    } else if (_As < 0.0f) {
+        fprintf(stderr,"error: ddc_crcf_create_kaiser(), stop-band attenuation must be positive\n");
+        exit(1);
+    }
+
+    // compute filter coefficients
+    unsigned int h_len = 2*_M*_m + 1;
+    float h[h_len];
+    liquid_firdes_kaiser(h_len, 0.5f/(float)_M, _As, 0.0f, h);
+
+    return ddc_crcf_create(_fc, _M, h, 2*_M*_m);
+}
+
+// destroy digital down-converter
+void ddc_crcf_destroy(ddc_crcf _q)
+{
+    nco_crcf_destroy(_q->nco);
+    dotprod_crcf_destroy(_q->dp);
+    free(_q->buf);
+    free(_q);
+}
+
+// print digital down-converter
+void ddc_crcf_print(ddc_crcf _q)
+{
+    printf("ddc_crcf: freq %12.8f, decimation %u, filter length %u\n",
+            nco_crcf_get_frequency(_q->nco), _q->M, _q->h_len);
+    if (_q->dc_enabled)
+        printf("  dc removal  : bandwidth %12.4e\n", _q->dc_alpha);
+    if (_q->agc_enabled)
+        printf("  agc         : bandwidth %12.4e, rssi %8.2f dB\n",
+                _q->agc_alpha, ddc_crcf_agc_get_rssi(_q));
+}
+
+// reset phase, filter buffer, DC estimate and gain; frequency is retained
+void ddc_crcf_reset(ddc_crcf _q)
+{
+    nco_crcf_set_phase(_q->nco, 0.0f);
+    memset(_q->buf, 0x00, _q->buf_len*sizeof(float complex));
+    _q->dc = 0.0f;
+    _q->g  = 1.0f;
+}
+
+// get decimation rate
+unsigned int ddc_crcf_get_decim_rate(ddc_crcf _q)
+{
+    return _q->M;
+}
+
+// set/get carrier frequency [radians/sample]
+void ddc_crcf_set_frequency(ddc_crcf _q,
+                            float    _fc)
+{
+    nco_crcf_set_frequency(_q->nco, _fc);
+}
+
+float ddc_crcf_get_frequency(ddc_crcf _q)
+{
+    return nco_crcf_get_frequency(_q->nco);
+}
+
+// set/get carrier phase [radians]
+void ddc_crcf_set_phase(ddc_crcf _q,
+                        float    _phi)
+{
+    nco_crcf_set_phase(_q->nco, _phi);
+}
+
+float ddc_crcf_get_phase(ddc_crcf _q)
+{
+    return nco_crcf_get_phase(_q->nco);
+}
+
+// enable/disable DC offset removal on input
+void ddc_crcf_dc_enable(ddc_crcf _q)
+{
+    _q->dc_enabled = 1;
+}
+
+void ddc_crcf_dc_disable(ddc_crcf _q)
+{
+    _q->dc_enabled = 0;
+}
+
+// set DC offset removal bandwidth; _alpha is as for
+// iirfilt_crcf_create_dc_blocker()
+//  _q      :   digital down-converter
+//  _alpha  :   bandwidth, 0 < _alpha <= 1
+void ddc_crcf_dc_set_bandwidth(ddc_crcf _q,
+                               float    _alpha)
+{
+    if (_alpha <= 0.0f || _alpha > 1.0f) {
+        fprintf(stderr,"error: ddc_crcf_dc_set_bandwidth(), bandwidth must be in (0,1]\n");
+        exit(1);
+    }
+    _q->dc_alpha = _alpha;
+}
+
+// get DC offset estimate
+float complex ddc_crcf_dc_get_offset(ddc_crcf _q)
+{
+    return _q->dc;
+}
+
+// enable/disable automatic gain control on output
+void ddc_crcf_agc_enable(ddc_crcf _q)
+{
+    _q->agc_enabled = 1;
+}
+
+void ddc_crcf_agc_disable(ddc_crcf _q)
+{
+    _q->agc_enabled = 0;
+}
+
+// set automatic gain control bandwidth, as for agc_crcf_set_bandwidth();
+// the loop runs at the output (decimated) rate
+//  _q      :   digital down-converter
+//  _bt     :   bandwidth, 0 < _bt <= 1
+void ddc_crcf_agc_set_bandwidth(ddc_crcf _q,
+                                float    _bt)
+{
+    if (_bt <= 0.0f || _bt > 1.0f) {
+        fprintf(stderr,"error: ddc_crcf_agc_set_bandwidth(), bandwidth must be in (0,1]\n");
+        exit(1);
+    }
+    _q->agc_alpha = _bt;
+}
+
+// get signal level of (filtered) input relative to unity output [dB]
+float ddc_crcf_agc_get_rssi(ddc_crcf _q)
+{
+    return -20*log10f(_q->g);
+}
+
+// execute digital down-converter on _M input samples
+//  _q      :   digital down-converter
+//  _x      :   input samples [size: _M x 1]
+//  _y      :   output sample pointer
+void ddc_crcf_execute(ddc_crcf        _q,
+                      float complex * _x,
+                      float complex * _y)
+{
+    ddc_crcf_execute_block(_q, _x, 1, _y);
+}
+
+// execute digital down-converter on block of _n*_M input samples
+//  _q      :   digital down-converter
+//  _x      :   input samples [size: _n*_M x 1]
+//  _n      :   number of output samples
+//  _y      :   output samples [size: _n x 1]
+void ddc_crcf_execute_block(ddc_crcf        _q,
+                            float complex * _x,
+                            unsigned int    _n,
+                            float complex * _y)
+{
+    float complex * b = &_q->buf[_q->h_len - 1];
+    unsigned int i, j;
+    unsigned int n0 = 0;    // output index
+    while (n0 < _n) {
+        unsigned int nc = _n - n0 < _q->C ? _n - n0 : _q->C;   // outputs in chunk
+        unsigned int nx = nc*_q->M;                             // inputs in chunk
+        float complex * x = &_x[n0*_q->M];
+
+        if (_q->dc_enabled) {
+            // remove DC estimate from chunk, accumulating residual
+            float complex dc = _q->dc;
+            float sr = 0.0f, si = 0.0f;
+            for (i=0; i<nx; i++) {
+                b[i] = x[i] - dc;
+                sr += crealf(b[i]);
+                si += cimagf(b[i]);
+            }
+
+            // update estimate as nx steps of the single-pole average
+            // would for a chunk of constant mean
+            float g = 1.0f - powf(1.0f - _q->dc_alpha, (float)nx);
+            _q->dc += g * (sr + _Complex_I*si) / (float)nx;
+            x = b;
+        }
+
+        // mix chunk down into filter buffer
+        nco_crcf_mix_block(_q->nco, x, b, nx, 1);
+
+        // compute retained outputs and retain history
+        for (j=0; j<nc; j++)
+            dotprod_crcf_execute(_q->dp, &_q->buf[j*_q->M], &_y[n0 + j]);
+        memmove(_q->buf, &_q->buf[nx], (_q->h_len-1)*sizeof(float complex));
+
+        // gain control on output
+        if (_q->agc_enabled) {
+            float e = 0.0f;
+            for (j=0; j<nc; j++) {
+                _y[n0+j] *= _q->g;
+                e += crealf(_y[n0+j])*crealf(_y[n0+j]) + cimagf(_y[n0+j])*cimagf(_y[n0+j]);
+            }
+            e /= (float)nc;
+
+            // drive output energy towards unity, clamping to 120 dB gain
+            if (e > 1e-12f) {
+                float g = 1.0f - powf(1.0f - _q->agc_alpha, (float)nc);
+                _q->g *= powf(e, -0.5f*g);
+            }
+            if (_q->g > 1e6f)
+                _q->g = 1e6f;
+        }
+
+        n0 += nc;
+    }
+}
+
@@ -24,44 +24,96 @@
 // Numerically-controlled oscillator (nco) with internal phase-locked
 // loop (pll) implementation
 //
+// The phase is kept in a 32-bit unsigned accumulator (2^32 = 2 pi) so
+// that it wraps exactly and never needs constraining. LIQUID_NCO looks up
+// a 256-point sine table, LIQUID_NCO_INTERP linearly interpolates a
+// quarter-wave table of configurable length, and LIQUID_VCO computes
+// sinf()/cosf() directly.
+//
 
 #include <math.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <assert.h>
 
+#if HAVE_EMMINTRIN_H && defined __SSE2__
+#include <emmintrin.h>  // SSE2
+#define NCO_USE_SSE2 1
+#else
+#define NCO_USE_SSE2 0
+#endif
+
 #define NCO_PLL_BANDWIDTH_DEFAULT   (0.1)
+
+// maximum loop bandwidth per block pll update (bandwidth x interval);
+// larger values make the loop ring or diverge
+#define NCO_PLL_UPDATE_BANDWIDTH_MAX    (0.5f)
 #define NCO_PLL_GAIN_DEFAULT        (1000)
+#define NCO_INTERP_TABLE_DEFAULT    (10)    // log2 of quarter-wave table length
 
 #define LIQUID_DEBUG_NCO            (0)
 
 struct NCO(_s) {
     liquid_ncotype type;
-    T theta;            // NCO phase
-    T d_theta;          // NCO frequency
+    uint32_t theta;     // NCO phase (fixed-point, 2^32 = 2 pi)
+    uint32_t d_theta;   // NCO frequency (fixed-point)
     T sintab[256];      // sine table
     unsigned int index; // table index
     T sine;
     T cosine;
     void (*compute_sincos)(NCO() _q);
 
+    // interpolated quarter-wave table (LIQUID_NCO_INTERP); each entry
+    // holds the end points for sine and cosine: sin(x_k), sin(x_{k+1}),
+    // cos(x_k), cos(x_{k+1}) where x_k = k pi/2 / 2^qtab_m
+    T *          qtab;      // quarter-wave table [size: 2^qtab_m x 4]
+    unsigned int qtab_m;    // log2 of table length
+    T            qtab_frac; // fraction scale: 2^-(30 - qtab_m)
+
     // phase-locked loop
     T alpha;
     T beta;
+
+    // block phase-locked loop: the phase detector output is accumulated
+    // over pll_interval samples before each loop-filter update
+    unsigned int pll_interval;  // samples per loop-filter update
+    unsigned int pll_order;     // detector power (1, 2, 4 or 8)
+    unsigned int pll_count;     // samples accumulated so far
+    TC           pll_acc;       // detector accumulator
+    T            pll_alpha;     // frequency gain per update
+    T            pll_beta;      // phase gain per update
 };
 
+// sine and cosine of fixed-point phase from interpolated quarter-wave
+// table; identical to the operations of the block method
+static void NCO(_interp)(NCO()    _q,
+                         uint32_t _theta,
+                         T *      _s,
+                         T *      _c);
+
+// sum of _x^_m over block (block pll phase detector)
+static TC NCO(_pll_detect)(TC *         _x,
+                           unsigned int _n,
+                           unsigned int _m);
+
+// compute block pll loop gains from bandwidth and update interval
+static void NCO(_pll_set_gains)(NCO() _q);
+
 // create nco/vco object
 NCO() NCO(_create)(liquid_ncotype _type)
 {
     NCO() q = (NCO()) malloc(sizeof(struct NCO(_s)));
     q->type = _type;
+    q->qtab = NULL;
 
     // initialize sine table
     unsigned int i;
     for (i=0; i<256; i++)
         q->sintab[i] = SIN(2.0f*M_PI*(float)(i)/256.0f);
 
-    // set default pll bandwidth
+    // set default pll bandwidth, per-sample updates of block pll
+    q->pll_interval = 1;
+    q->pll_order    = 1;
     NCO(_pll_set_bandwidth)(q, NCO_PLL_BANDWIDTH_DEFAULT);
 
     // set internal method
@@ -69,6 +121,9 @@ NCO() NCO(_create)(liquid_ncotype _type)
         q->compute_sincos = &NCO(_compute_sincos_nco);
     } else if (q->type == LIQUID_VCO) {
         q->compute_sincos = &NCO(_compute_sincos_vco);
+    } else if (q->type == LIQUID_NCO_INTERP) {
+        q->compute_sincos = &NCO(_compute_sincos_interp);
+        NCO(_set_table_length)(q, NCO_INTERP_TABLE_DEFAULT);
     } else {
         fprintf(stderr,"error: NCO(_create)(), unknown type : %u\n", q->type);
         exit(1);
@@ -79,12 +134,61 @@ NCO() NCO(_create)(liquid_ncotype _type)
     return q;
 }
 
+// create nco object with interpolated quarter-wave table
+//  _m      :   log2 of table length, 2 <= _m <= 16
+NCO() NCO(_create_interp)(unsigned int _m)
+{
+    NCO() q = NCO(_create)(LIQUID_NCO_INTERP);
+    NCO(_set_table_length)(q, _m);
+    return q;
+}
+
 // destroy nco object
 void NCO(_destroy)(NCO() _q)
 {
+    free(_q->qtab);
     free(_q);
 }
 
+// print nco object internals
+void NCO(_print)(NCO() _q)
+{
+    printf("nco [%s]", _q->type == LIQUID_NCO ? "nco" :
+                       _q->type == LIQUID_VCO ? "vco" : "nco/interp");
+    if (_q->type == LIQUID_NCO_INTERP)
+        printf(" table: %u", 1U << _q->qtab_m);
+    printf(" phase: %12.8f, freq: %12.8f\n", NCO(_get_phase)(_q), NCO(_get_frequency)(_q));
+}
+
+// set length of interpolated quarter-wave table (LIQUID_NCO_INTERP only)
+//  _q      :   nco object
+//  _m      :   log2 of table length, 2 <= _m <= 16
+void NCO(_set_table_length)(NCO()        _q,
+                            unsigned int _m)
+{
+    if (_q->type != LIQUID_NCO_INTERP) {
+        fprintf(stderr,"error: nco_set_table_length(), object is not of type LIQUID_NCO_INTERP\n");
+        exit(1);
+    } else if (_m < 2 || _m > 16) {
+        fprintf(stderr,"error: nco_set_table_length(), table length must be 2^m, 2 <= m <= 16\n");
+        exit(1);
+    }
+
+    // table covers x in [0,pi/2]; cos(x_k) = sin(x_{n-k}) is stored
+    // from the same values so that quadrant symmetry holds exactly
+    unsigned int n = 1U << _m;
+    _q->qtab_m    = _m;
+    _q->qtab_frac = 1.0f / (float)(1U << (30 - _m));
+    _q->qtab      = (T*) realloc(_q->qtab, 4*n*sizeof(T));
+    unsigned int i;
+    for (i=0; i<n; i++) {
+        _q->qtab[4*i+0] = (T) sin(0.5*M_PI*(double)(i  )/(double)n);
+        _q->qtab[4*i+1] = (T) sin(0.5*M_PI*(double)(i+1)/(double)n);
+        _q->qtab[4*i+2] = (T) sin(0.5*M_PI*(double)(n-i  )/(double)n);
+        _q->qtab[4*i+3] = (T) sin(0.5*M_PI*(double)(n-i-1)/(double)n);
+    }
+}
+
 // reset internal state of nco object
 void NCO(_reset)(NCO() _q)
 {
@@ -106,47 +210,44 @@ void NCO(_reset)(NCO() _q)
 void NCO(_set_frequency)(NCO() _q,
                          T _f)
 {
-    _q->d_theta = _f;
+    _q->d_theta = NCO(_constrain)(_f);
 }
 
 // adjust frequency of nco object
 void NCO(_adjust_frequency)(NCO() _q,
                             T _df)
 {
-    _q->d_theta += _df;
+    _q->d_theta += NCO(_constrain)(_df);
 }
 
-// set phase of nco object, constraining phase
+// set phase of nco object
 void NCO(_set_phase)(NCO() _q, T _phi)
 {
-    _q->theta = _phi;
-    NCO(_constrain_phase)(_q);
+    _q->theta = NCO(_constrain)(_phi);
 }
 
-// adjust phase of nco object, constraining phase
+// adjust phase of nco object
 void NCO(_adjust_phase)(NCO() _q, T _dphi)
 {
-    _q->theta += _dphi;
-    NCO(_constrain_phase)(_q);
+    _q->theta += NCO(_constrain)(_dphi);
 }
 
 // increment internal phase of nco object
 void NCO(_step)(NCO() _q)
 {
     _q->theta += _q->d_theta;
-    NCO(_constrain_phase)(_q);
 }
 
-// get phase
+// get phase, in [-pi,pi)
 T NCO(_get_phase)(NCO() _q)
 {
-    return _q->theta;
+    return NCO(_fixed_to_float)(_q->theta);
 }
 
-// ge frequency
+// get frequency, in [-pi,pi)
 T NCO(_get_frequency)(NCO() _q)
 {
-    return _q->d_theta;
+    return NCO(_fixed_to_float)(_q->d_theta);
 }
 
 
@@ -198,6 +299,8 @@ void NCO(_cexpf)(NCO() _q,
 // reset pll state, retaining base frequency
 void NCO(_pll_reset)(NCO() _q)
 {
+    _q->pll_count = 0;
+    _q->pll_acc   = 0;
 }
 
 // set pll bandwidth
@@ -212,6 +315,7 @@ void NCO(_pll_set_bandwidth)(NCO() _q,
 
     _q->alpha = _bandwidth;         // frequency proportion
     _q->beta  = sqrtf(_q->alpha);   // phase proportion
+    NCO(_pll_set_gains)(_q);
 }
 
 // advance pll phase
@@ -230,6 +334,92 @@ void NCO(_pll_step)(NCO() _q,
     //NCO(_constrain_frequency)(_q);
 }
 
+// set block pll loop-filter update interval
+//  _q          :   nco object
+//  _interval   :   samples per loop-filter update, _interval > 0
+void NCO(_pll_set_interval)(NCO()        _q,
+                            unsigned int _interval)
+{
+    if (_interval == 0) {
+        fprintf(stderr,"error: nco_pll_set_interval(), interval must be greater than zero\n");
+        exit(1);
+    }
+    _q->pll_interval = _interval;
+    NCO(_pll_set_gains)(_q);
+    NCO(_pll_reset)(_q);
+}
+
+// set block pll phase detector order; the mixed signal is raised to the
+// _m-th power to strip the modulation of an M-PSK signal
+//  _q      :   nco object
+//  _m      :   detector order: 1 (carrier/pilot), 2 (BPSK), 4 (QPSK), 8
+void NCO(_pll_set_order)(NCO()        _q,
+                         unsigned int _m)
+{
+    if (_m != 1 && _m != 2 && _m != 4 && _m != 8) {
+        fprintf(stderr,"error: nco_pll_set_order(), order must be 1, 2, 4, or 8\n");
+        exit(1);
+    }
+    _q->pll_order = _m;
+    NCO(_pll_reset)(_q);
+}
+
+// compute block pll loop gains; the loop runs at the update rate, where
+// the per-sample loop bandwidth scales to bandwidth x interval^2 (limited
+// to NCO_PLL_UPDATE_BANDWIDTH_MAX to keep the loop stable). The frequency
+// gain is expressed per sample.
+static void NCO(_pll_set_gains)(NCO() _q)
+{
+    T g = (T)(_q->pll_interval);
+    T b = _q->alpha * g * g;
+    if (b > NCO_PLL_UPDATE_BANDWIDTH_MAX)
+        b = NCO_PLL_UPDATE_BANDWIDTH_MAX;
+    _q->pll_alpha = b / g;
+    _q->pll_beta  = sqrtf(b);
+}
+
+// Rotate input vector array down by NCO angle while tracking its carrier.
+// The phase is advanced linearly (at the current frequency) across each
+// update interval; the phase detector is accumulated over the interval and
+// the loop filter updated once with gains for the update rate, i.e. the
+// trajectory is piecewise-linear. The detector measures the phase error at
+// the middle of the interval, so the phase is also advanced by the
+// frequency correction over the remaining half interval. State carries
+// across calls so that the output does not depend on how the input is
+// divided into blocks (aside from rounding of the detector sum).
+//  _q      :   nco object
+//  _x      :   input array [size: _n x 1]
+//  _y      :   output array [size: _n x 1]
+//  _n      :   number of input, output samples
+void NCO(_pll_mix_block_down)(NCO()        _q,
+                              TC *         _x,
+                              TC *         _y,
+                              unsigned int _n)
+{
+    unsigned int i = 0;
+    while (i < _n) {
+        // mix as many samples as remain in this update interval
+        unsigned int ns = _q->pll_interval - _q->pll_count;
+        if (ns > _n - i)
+            ns = _n - i;
+        NCO(_mix_block)(_q, &_x[i], &_y[i], ns, 1);
+        _q->pll_acc   += NCO(_pll_detect)(&_y[i], ns, _q->pll_order);
+        _q->pll_count += ns;
+        i += ns;
+
+        if (_q->pll_count < _q->pll_interval)
+            break;
+
+        // update loop filter with average phase error over interval
+        T dphi = cargf(_q->pll_acc) / (T)(_q->pll_order);
+        T df   = dphi*_q->pll_alpha;
+        NCO(_adjust_frequency)(_q, df);
+        NCO(_adjust_phase)(    _q, dphi*_q->pll_beta + df*0.5f*(T)(_q->pll_interval-1));
+        _q->pll_count = 0;
+        _q->pll_acc   = 0;
+    }
+}
+
 // mixing functions
 
 // Rotate input vector up by NCO angle, y = x exp{+j theta}
@@ -266,7 +456,6 @@ void NCO(_mix_down)(NCO() _q,
 
 // Rotate input vector array up by NCO angle:
 //      y(t) = x(t) exp{+j (f*t + theta)}
-// TODO : implement NCO/VCO-specific versions
 //  _q      :   nco object
 //  _x      :   input array [size: _n x 1]
 //  _y      :   output sample [size: _n x 1]
@@ -276,34 +465,11 @@ void NCO(_mix_block_up)(NCO() _q,
                         TC *_y,
                         unsigned int _n)
 {
-    unsigned int i;
-    // FIXME: this method should be more efficient but is causing occasional
-    //        errors so instead favor slower but more reliable algorithm
-#if 0
-    T theta =   _q->theta;
-    T d_theta = _q->d_theta;
-    for (i=0; i<_n; i++) {
-        // multiply _x[i] by [cos(theta) + _Complex_I*sin(theta)]
-        _y[i] = _x[i] * liquid_cexpjf(theta);
-        
-        theta += d_theta;
-    }
-
-    NCO(_set_phase)(_q, theta);
-#else
-    for (i=0; i<_n; i++) {
-        // mix single sample up
-        NCO(_mix_up)(_q, _x[i], &_y[i]);
-
-        // step NCO phase
-        NCO(_step)(_q);
-    }
-#endif
+    NCO(_mix_block)(_q, _x, _y, _n, 0);
 }
 
 // Rotate input vector array down by NCO angle:
 //      y(t) = x(t) exp{-j (f*t + theta)}
-// TODO : implement NCO/VCO-specific versions
 //  _q      :   nco object
 //  _x      :   input array [size: _n x 1]
 //  _y      :   output sample [size: _n x 1]
@@ -313,63 +479,34 @@ void NCO(_mix_block_down)(NCO() _q,
                           TC *_y,
                           unsigned int _n)
 {
-    unsigned int i;
-    // FIXME: this method should be more efficient but is causing occasional
-    //        errors so instead favor slower but more reliable algorithm
-#if 0
-    T theta =   _q->theta;
-    T d_theta = _q->d_theta;
-    for (i=0; i<_n; i++) {
-        // multiply _x[i] by [cos(-theta) + _Complex_I*sin(-theta)]
-        _y[i] = _x[i] * liquid_cexpjf(-theta);
-        
-        theta += d_theta;
-    }
-
-    NCO(_set_phase)(_q, theta);
-#else
-    for (i=0; i<_n; i++) {
-        // mix single sample down
-        NCO(_mix_down)(_q, _x[i], &_y[i]);
-
-        // step NCO phase
-        NCO(_step)(_q);
-    }
-#endif
+    NCO(_mix_block)(_q, _x, _y, _n, 1);
 }
 
 //
 // internal methods
 //
 
-// constrain frequency of NCO object to be in (-pi,pi)
-void NCO(_constrain_frequency)(NCO() _q)
+// convert phase/frequency in radians to fixed-point, wrapping to [0,2pi)
+uint32_t NCO(_constrain)(T _theta)
 {
-    if (_q->d_theta > M_PI)
-        _q->d_theta -= 2*M_PI;
-    else if (_q->d_theta < -M_PI)
-        _q->d_theta += 2*M_PI;
+    double v = (double)_theta / (2*M_PI);
+    v -= floor(v);
+
+    // rounding may produce 2^32 which wraps to zero
+    return (uint32_t)(uint64_t)(v*4294967296.0 + 0.5);
 }
 
-// constrain phase of NCO object to be in (-pi,pi)
-void NCO(_constrain_phase)(NCO() _q)
+// convert fixed-point phase/frequency to radians in [-pi,pi)
+T NCO(_fixed_to_float)(uint32_t _theta)
 {
-    if (_q->theta > M_PI)
-        _q->theta -= 2*M_PI;
-    else if (_q->theta < -M_PI)
-        _q->theta += 2*M_PI;
+    return (T)((int32_t)_theta) * (T)(2*M_PI/4294967296.0);
 }
 
 // compute sin, cos of internal phase of nco
 void NCO(_compute_sincos_nco)(NCO() _q)
 {
-    // assume phase is constrained to be in (-pi,pi)
-
-    // compute index
-    // NOTE : 40.743665 ~ 256 / (2*pi)
-    // NOTE : add 512 to ensure positive value, add 0.5 for rounding precision
-    // TODO : move away from floating-point specific code
-    _q->index = ((unsigned int)((_q->theta)*40.743665f + 512.0f + 0.5f))&0xff;
+    // nearest of 256 table entries: round top eight bits of phase
+    _q->index = ((_q->theta + (1U<<23)) >> 24) & 0xff;
     assert(_q->index < 256);
     
     _q->sine = _q->sintab[_q->index];
@@ -379,7 +516,216 @@ void NCO(_compute_sincos_nco)(NCO() _q)
 // compute sin, cos of internal phase of vco
 void NCO(_compute_sincos_vco)(NCO() _q)
 {
-    _q->sine   = SIN(_q->theta);
-    _q->cosine = COS(_q->theta);
+    T theta = NCO(_fixed_to_float)(_q->theta);
+    _q->sine   = SIN(theta);
+    _q->cosine = COS(theta);
+}
+
+// compute sin, cos of internal phase from interpolated quarter-wave table
+void NCO(_compute_sincos_interp)(NCO() _q)
+{
+    NCO(_interp)(_q, _q->theta, &_q->sine, &_q->cosine);
+}
+
+// Rotate input vector array by NCO angle, stepping phase; the SSE2
+// kernel for LIQUID_NCO_INTERP computes four phases at once (the table
+// look-ups remain scalar) and produces the same values as the scalar
+// path and as _mix_up()/_mix_down() with _step().
+//  _q      :   nco object
+//  _x      :   input array [size: _n x 1]
+//  _y      :   output sample [size: _n x 1]
+//  _n      :   number of input, output samples
+//  _down   :   rotate down (conjugate) if non-zero
+void NCO(_mix_block)(NCO()        _q,
+                     TC *         _x,
+                     TC *         _y,
+                     unsigned int _n,
+                     int          _down)
+{
+    uint32_t theta   = _q->theta;
+    uint32_t d_theta = _q->d_theta;
+    unsigned int i = 0;
+
+#if NCO_USE_SSE2
+    if (_q->type == LIQUID_NCO_INTERP && _n >= 4) {
+        const T *    tab   = _q->qtab;
+        unsigned int shift = 30 - _q->qtab_m;
+        const float * x = (const float*) _x;
+        float *       y = (float*) _y;
+
+        __m128i p     = _mm_setr_epi32((int)theta,             (int)(theta +   d_theta),
+                                       (int)(theta+2*d_theta), (int)(theta + 3*d_theta));
+        __m128i dp    = _mm_set1_epi32((int)(4*d_theta));
+        __m128i mr    = _mm_set1_epi32(0x3fffffff);
+        __m128i mf    = _mm_set1_epi32((int)((1U << shift) - 1));
+        __m128i sh    = _mm_cvtsi32_si128((int)shift);
+        __m128i one   = _mm_set1_epi32(1);
+        __m128i sdown = _mm_set1_epi32(_down ? (int)0x80000000 : 0);
+        __m128  frac  = _mm_set1_ps(_q->qtab_frac);
+        __m128  neg   = _mm_setr_ps(-1.0f, 1.0f, -1.0f, 1.0f);
+        int k[4];
+
+        for (; i+4<=_n; i+=4) {
+            // quadrant, table index and interpolation fraction
+            __m128i quad = _mm_srli_epi32(p, 30);
+            __m128i r    = _mm_and_si128(p, mr);
+            __m128i kv   = _mm_slli_epi32(_mm_srl_epi32(r, sh), 2);
+            k[0] = _mm_cvtsi128_si32(kv);
+            k[1] = _mm_cvtsi128_si32(_mm_shuffle_epi32(kv, _MM_SHUFFLE(1,1,1,1)));
+            k[2] = _mm_cvtsi128_si32(_mm_shuffle_epi32(kv, _MM_SHUFFLE(2,2,2,2)));
+            k[3] = _mm_cvtsi128_si32(_mm_shuffle_epi32(kv, _MM_SHUFFLE(3,3,3,3)));
+            __m128  f    = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(r, mf)), frac);
+
+            // gather table entries and transpose, then interpolate sine
+            // and cosine within quadrant
+            __m128 a = _mm_loadu_ps(&tab[k[0]]);
+            __m128 b = _mm_loadu_ps(&tab[k[1]]);
+            __m128 c = _mm_loadu_ps(&tab[k[2]]);
+            __m128 d = _mm_loadu_ps(&tab[k[3]]);
+            _MM_TRANSPOSE4_PS(a, b, c, d);
+            __m128 s0 = _mm_add_ps(a, _mm_mul_ps(f, _mm_sub_ps(b, a)));
+            __m128 c0 = _mm_add_ps(c, _mm_mul_ps(f, _mm_sub_ps(d, c)));
+
+            // map to quadrant: swap for odd quadrants, then apply signs
+            __m128 swap = _mm_castsi128_ps(_mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(quad, one)));
+            __m128 s1 = _mm_or_ps(_mm_and_ps(swap, c0), _mm_andnot_ps(swap, s0));
+            __m128 c1 = _mm_or_ps(_mm_and_ps(swap, s0), _mm_andnot_ps(swap, c0));
+            __m128i q1 = _mm_srli_epi32(quad, 1);
+            s1 = _mm_xor_ps(s1, _mm_castsi128_ps(_mm_xor_si128(_mm_slli_epi32(q1, 31), sdown)));
+            c1 = _mm_xor_ps(c1, _mm_castsi128_ps(_mm_slli_epi32(_mm_xor_si128(quad, q1), 31)));
+
+            // complex multiply with input
+            __m128 w0 = _mm_unpacklo_ps(c1, s1);
+            __m128 w1 = _mm_unpackhi_ps(c1, s1);
+            __m128 x0 = _mm_loadu_ps(&x[2*i  ]);
+            __m128 x1 = _mm_loadu_ps(&x[2*i+4]);
+            __m128 y0 = _mm_add_ps(_mm_mul_ps(_mm_shuffle_ps(x0, x0, _MM_SHUFFLE(2,2,0,0)), w0),
+                                   _mm_mul_ps(_mm_mul_ps(_mm_shuffle_ps(x0, x0, _MM_SHUFFLE(3,3,1,1)),
+                                                         _mm_shuffle_ps(w0, w0, _MM_SHUFFLE(2,3,0,1))), neg));
+            __m128 y1 = _mm_add_ps(_mm_mul_ps(_mm_shuffle_ps(x1, x1, _MM_SHUFFLE(2,2,0,0)), w1),
+                                   _mm_mul_ps(_mm_mul_ps(_mm_shuffle_ps(x1, x1, _MM_SHUFFLE(3,3,1,1)),
+                                                         _mm_shuffle_ps(w1, w1, _MM_SHUFFLE(2,3,0,1))), neg));
+            _mm_storeu_ps(&y[2*i  ], y0);
+            _mm_storeu_ps(&y[2*i+4], y1);
+
+            p = _mm_add_epi32(p, dp);
+        }
+        theta += i*d_theta;
+    }
+#endif
+
+    for (; i<_n; i++) {
+        T s, c;
+        NCO(_sincos_fixed)(_q, theta, &s, &c);
+        if (_down)
+            s = -s;
+
+        // multiply _x[i] by [c + _Complex_I*s]
+        T xr = crealf(_x[i]);
+        T xi = cimagf(_x[i]);
+        _y[i] = (xr*c - xi*s) + _Complex_I*(xr*s + xi*c);
+
+        theta += d_theta;
+    }
+
+    _q->theta = theta;
+}
+
+// compute sin, cos of arbitrary fixed-point phase without changing the
+// state of the object; values are identical to those of _sincos()
+void NCO(_sincos_fixed)(NCO()    _q,
+                        uint32_t _theta,
+                        T *      _s,
+                        T *      _c)
+{
+    if (_q->type == LIQUID_NCO_INTERP) {
+        NCO(_interp)(_q, _theta, _s, _c);
+    } else if (_q->type == LIQUID_NCO) {
+        unsigned int index = ((_theta + (1U<<23)) >> 24) & 0xff;
+        *_s = _q->sintab[index];
+        *_c = _q->sintab[(index+64)&0xff];
+    } else {
+        T phi = NCO(_fixed_to_float)(_theta);
+        *_s = SIN(phi);
+        *_c = COS(phi);
+    }
+}
+
+// sum of _x^_m over block (block pll phase detector); powers are formed
+// by repeated squaring, four samples per SSE2 vector
+//  _x      :   input array [size: _n x 1]
+//  _n      :   number of samples
+//  _m      :   power: 1, 2, 4 or 8
+static TC NCO(_pll_detect)(TC *         _x,
+                           unsigned int _n,
+                           unsigned int _m)
+{
+    T sr = 0, si = 0;
+    unsigned int i = 0, k;
+
+#if NCO_USE_SSE2
+    const float * x = (const float*) _x;
+    __m128 ar = _mm_setzero_ps();
+    __m128 ai = _mm_setzero_ps();
+    for (; i+4<=_n; i+=4) {
+        // de-interleave four samples
+        __m128 x0 = _mm_loadu_ps(&x[2*i  ]);
+        __m128 x1 = _mm_loadu_ps(&x[2*i+4]);
+        __m128 vr = _mm_shuffle_ps(x0, x1, _MM_SHUFFLE(2,0,2,0));
+        __m128 vi = _mm_shuffle_ps(x0, x1, _MM_SHUFFLE(3,1,3,1));
+        for (k=1; k<_m; k<<=1) {
+            __m128 ur = _mm_sub_ps(_mm_mul_ps(vr,vr), _mm_mul_ps(vi,vi));
+            __m128 ui = _mm_mul_ps(_mm_add_ps(vr,vr), vi);
+            vr = ur;
+            vi = ui;
+        }
+        ar = _mm_add_ps(ar, vr);
+        ai = _mm_add_ps(ai, vi);
+    }
+    float v[4];
+    _mm_storeu_ps(v, ar); sr = (v[0] + v[1]) + (v[2] + v[3]);
+    _mm_storeu_ps(v, ai); si = (v[0] + v[1]) + (v[2] + v[3]);
+#endif
+
+    for (; i<_n; i++) {
+        T vr = crealf(_x[i]);
+        T vi = cimagf(_x[i]);
+        for (k=1; k<_m; k<<=1) {
+            T ur = vr*vr - vi*vi;
+            vi = 2*vr*vi;
+            vr = ur;
+        }
+        sr += vr;
+        si += vi;
+    }
+    return sr + _Complex_I*si;
+}
+
+// sine and cosine of fixed-point phase from interpolated quarter-wave table
+static void NCO(_interp)(NCO()    _q,
+                         uint32_t _theta,
+                         T *      _s,
+                         T *      _c)
+{
+    unsigned int shift = 30 - _q->qtab_m;
+
+    // quadrant, table index and interpolation fraction
+    unsigned int quad = _theta >> 30;
+    uint32_t     r    = _theta & 0x3fffffff;
+    unsigned int k    = r >> shift;
+    T            f    = (T)(int32_t)(r & ((1U << shift) - 1)) * _q->qtab_frac;
+
+    // interpolate sine and cosine within quadrant
+    const T * e = &_q->qtab[4*k];
+    T s = e[0] + f*(e[1] - e[0]);
+    T c = e[2] + f*(e[3] - e[2]);
+
+    // map to quadrant
+    switch (quad) {
+    case 0: *_s =  s; *_c =  c; break;
+    case 1: *_s =  c; *_c = -s; break;
+    case 2: *_s = -s; *_c = -c; break;
+    default:*_s = -c; *_c =  s; break;
+    }
 }
 
@@ -0,0 +1,444 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+//
+// ncobank_crcf : bank of numerically-controlled oscillators mixing one
+// input stream down to many carriers, optionally followed by a
+// decimating filter on each carrier
+//
+// Carriers are processed four at a time, one per SIMD lane, so each input
+// sample is loaded once and mixed with four oscillators. The oscillators
+// keep fixed-point phase accumulators as nco_crcf does; every
+// NCOBANK_ANCHOR samples each lane is re-anchored exactly from the
+// interpolated quarter-wave table and in between its phasor is advanced
+// by complex rotation. Even and odd samples use separate phasors rotated
+// by twice the frequency, which halves the length of the dependency
+// chain. The input is processed in chunks so that with the decimator the
+// mixed samples are filtered while still in cache.
+//
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "liquid.internal.h"
+
+#if HAVE_EMMINTRIN_H && defined __SSE2__
+#include <emmintrin.h>  // SSE2
+#define NCOBANK_USE_SSE2 1
+#else
+#define NCOBANK_USE_SSE2 0
+#endif
+
+#define NCOBANK_ANCHOR  (32)    // samples between exact phase anchors
+#define NCOBANK_CHUNK   (256)   // input samples per chunk
+
+// set frequency of lane _i, including unused lanes
+static void ncobank_crcf_set_lane_frequency(ncobank_crcf _q,
+                                            unsigned int _i,
+                                            float        _f);
+
+// mix chunk of input down for one group of four carriers
+//  _q      :   nco bank object
+//  _g      :   carrier group index
+//  _x      :   input samples [size: _n x 1]
+//  _n      :   number of input samples, _n <= NCOBANK_CHUNK
+//  _y      :   output pointer for each lane [size: 4 x 1]
+static void ncobank_crcf_mix_group(ncobank_crcf    _q,
+                                   unsigned int    _g,
+                                   float complex * _x,
+                                   unsigned int    _n,
+                                   float complex **_y);
+
+struct ncobank_crcf_s {
+    unsigned int    num_carriers;   // number of carriers
+    unsigned int    num_groups;     // number of four-carrier groups
+    nco_crcf        nco;            // oscillator providing phase anchors
+    uint32_t *      theta;          // phase of each lane [size: 4*num_groups]
+    uint32_t *      d_theta;        // frequency of each lane
+    float *         rot;            // rotator exp(-j 2 d_theta) of each lane, interleaved
+                                    // by group: 4 real, 4 imag [size: 8*num_groups]
+    float complex * dummy;          // output of unused lanes [size: NCOBANK_CHUNK]
+
+    // decimator (M = 1 and h_len = 0 if not used)
+    unsigned int    M;              // decimation rate
+    unsigned int    h_len;          // filter length
+    unsigned int    C;              // outputs per chunk
+    dotprod_crcf    dp;             // filter dot product (reversed taps)
+    float complex * buf;            // carrier buffers [size: num_carriers x buf_len]
+    unsigned int    buf_len;        // h_len-1 + C*M
+};
+
+// create nco bank
+//  _num_carriers   :   number of carriers, _num_carriers > 0
+//  _freqs          :   carrier frequencies [radians/sample] [size: _num_carriers x 1]
+ncobank_crcf ncobank_crcf_create(unsigned int _num_carriers,
+                                 float *      _freqs)
+{
+    // validate input
+    if (_num_carriers == 0) {
+        fprintf(stderr,"error: ncobank_crcf_create(), number of carriers must be greater than zero\n");
+        exit(1);
+    }
+
+    ncobank_crcf q = (ncobank_crcf) malloc(sizeof(struct ncobank_crcf_s));
+    q->num_carriers = _num_carriers;
+    q->num_groups   = (_num_carriers + 3) / 4;
+    q->nco          = nco_crcf_create(LIQUID_NCO_INTERP);
+
+    unsigned int n = 4*q->num_groups;
+    q->theta   = (uint32_t*)      malloc(n*sizeof(uint32_t));
+    q->d_theta = (uint32_t*)      malloc(n*sizeof(uint32_t));
+    q->rot     = (float*)         malloc(2*n*sizeof(float));
+    q->dummy   = (float complex*) malloc(NCOBANK_CHUNK*sizeof(float complex));
+
+    // no decimator
+    q->M       = 1;
+    q->h_len   = 0;
+    q->C       = NCOBANK_CHUNK;
+    q->dp      = NULL;
+    q->buf     = NULL;
+    q->buf_len = 0;
+
+    // set frequencies; unused lanes run at zero frequency
+    unsigned int i;
+    for (i=0; i<n; i++)
+        ncobank_crcf_set_lane_frequency(q, i, i < _num_carriers ? _freqs[i] : 0.0f);
+
+    ncobank_crcf_reset(q);
+    return q;
+}
+
+// create nco bank with decimating filter on each carrier; filter and
+// decimation rate are as for firdecim_crcf_create()
+//  _num_carriers   :   number of carriers, _num_carriers > 0
+//  _freqs          :   carrier frequencies [radians/sample] [size: _num_carriers x 1]
+//  _M              :   decimation rate, _M > 0
+//  _h              :   filter coefficients [size: _h_len x 1]
+//  _h_len          :   filter length, _h_len > 0
+ncobank_crcf ncobank_crcf_create_decim(unsigned int _num_carriers,
+                                       float *      _freqs,
+                                       unsigned int _M,
+                                       float *      _h,
+                                       unsigned int _h_len)
+{
+    // validate input
+    if (_M == 0) {
+        fprintf(stderr,"error: ncobank_crcf_create_decim(), decimation rate must be greater than zero\n");
+        exit(1);
+    } else if (_h_len == 0) {
+        fprintf(stderr,"error: ncobank_crcf_create_decim(), filter length must be greater than zero\n");
+        exit(1);
+    }
+
+    ncobank_crcf q = ncobank_crcf_create(_num_carriers, _freqs);
+
+    // load filter in reverse order
+    float hr[_h_len];
+    unsigned int i;
+    for (i=0; i<_h_len; i++)
+        hr[i] = _h[_h_len-i-1];
+    q->dp = dotprod_crcf_create(hr, _h_len);
+
+    q->M       = _M;
+    q->h_len   = _h_len;
+    q->C       = _M < NCOBANK_CHUNK ? NCOBANK_CHUNK / _M : 1;
+    q->buf_len = _h_len - 1 + q->C*_M;
+    q->buf     = (float complex*) malloc(q->num_carriers*q->buf_len*sizeof(float complex));
+    if (q->C*_M > NCOBANK_CHUNK) {
+        free(q->dummy);
+        q->dummy = (float complex*) malloc(q->C*_M*sizeof(float complex));
+    }
+
+    ncobank_crcf_reset(q);
+    return q;
+}
+
+// destroy nco bank
+void ncobank_crcf_destroy(ncobank_crcf _q)
+{
+    nco_crcf_destroy(_q->nco);
+    free(_q->theta);
+    free(_q->d_theta);
+    free(_q->rot);
+    free(_q->dummy);
+    if (_q->dp != NULL) {
+        dotprod_crcf_destroy(_q->dp);
+        free(_q->buf);
+    }
+    free(_q);
+}
+
+// print nco bank
+void ncobank_crcf_print(ncobank_crcf _q)
+{
+    printf("ncobank_crcf: %u carriers", _q->num_carriers);
+    if (_q->dp != NULL)
+        printf(", decimation %u, filter length %u", _q->M, _q->h_len);
+    printf("\n");
+    unsigned int i;
+    for (i=0; i<_q->num_carriers; i++) {
+        printf("  %3u : freq %12.8f, phase %12.8f\n", i,
+                ncobank_crcf_get_frequency(_q,i),
+                ncobank_crcf_get_phase(_q,i));
+    }
+}
+
+// reset phases to zero and clear filter buffers
+void ncobank_crcf_reset(ncobank_crcf _q)
+{
+    memset(_q->theta, 0x00, 4*_q->num_groups*sizeof(uint32_t));
+    if (_q->buf != NULL)
+        memset(_q->buf, 0x00, _q->num_carriers*_q->buf_len*sizeof(float complex));
+}
+
+// get number of carriers
+unsigned int ncobank_crcf_get_num_carriers(ncobank_crcf _q)
+{
+    return _q->num_carriers;
+}
+
+// get decimation rate
+unsigned int ncobank_crcf_get_decim_rate(ncobank_crcf _q)
+{
+    return _q->M;
+}
+
+// set/get frequency of carrier _i [radians/sample]
+void ncobank_crcf_set_frequency(ncobank_crcf _q,
+                                unsigned int _i,
+                                float        _f)
+{
+    if (_i >= _q->num_carriers) {
+        fprintf(stderr,"error: ncobank_crcf_set_frequency(), carrier index (%u) out of range\n", _i);
+        exit(1);
+    }
+    ncobank_crcf_set_lane_frequency(_q, _i, _f);
+}
+
+float ncobank_crcf_get_frequency(ncobank_crcf _q,
+                                 unsigned int _i)
+{
+    if (_i >= _q->num_carriers) {
+        fprintf(stderr,"error: ncobank_crcf_get_frequency(), carrier index (%u) out of range\n", _i);
+        exit(1);
+    }
+    return nco_crcf_fixed_to_float(_q->d_theta[_i]);
+}
+
+// set/get phase of carrier _i [radians]
+void ncobank_crcf_set_phase(ncobank_crcf _q,
+                            unsigned int _i,
+                            float        _phi)
+{
+    if (_i >= _q->num_carriers) {
+        fprintf(stderr,"error: ncobank_crcf_set_phase(), carrier index (%u) out of range\n", _i);
+        exit(1);
+    }
+    _q->theta[_i] = nco_crcf_constrain(_phi);
+}
+
+float ncobank_crcf_get_phase(ncobank_crcf _q,
+                             unsigned int _i)
+{
+    if (_i >= _q->num_carriers) {
+        fprintf(stderr,"error: ncobank_crcf_get_phase(), carrier index (%u) out of range\n", _i);
+        exit(1);
+    }
+    return nco_crcf_fixed_to_float(_q->theta[_i]);
+}
+
+// mix input down to each carrier and decimate
+//  _q      :   nco bank object
+//  _x      :   input samples [size: _n*M x 1]
+//  _n      :   number of output samples per carrier
+//  _y      :   output samples, one block of _n per carrier
+//              [size: num_carriers*_n x 1]
+void ncobank_crcf_execute(ncobank_crcf    _q,
+                          float complex * _x,
+                          unsigned int    _n,
+                          float complex * _y)
+{
+    float complex * y[4];
+    unsigned int g, l, k, j;
+    unsigned int n0 = 0;    // output index
+    while (n0 < _n) {
+        unsigned int nc = _n - n0 < _q->C ? _n - n0 : _q->C;  // outputs in chunk
+        float complex * x = &_x[n0*_q->M];
+
+        // mix chunk of input into output (or filter buffers)
+        for (g=0; g<_q->num_groups; g++) {
+            for (l=0; l<4; l++) {
+                k = 4*g + l;
+                if (k >= _q->num_carriers)
+                    y[l] = _q->dummy;
+                else if (_q->dp == NULL)
+                    y[l] = &_y[k*_n + n0];
+                else
+                    y[l] = &_q->buf[k*_q->buf_len + _q->h_len - 1];
+            }
+            ncobank_crcf_mix_group(_q, g, x, nc*_q->M, y);
+        }
+
+        // run decimators over chunk and retain history
+        if (_q->dp != NULL) {
+            for (k=0; k<_q->num_carriers; k++) {
+                float complex * b = &_q->buf[k*_q->buf_len];
+                for (j=0; j<nc; j++)
+                    dotprod_crcf_execute(_q->dp, &b[j*_q->M], &_y[k*_n + n0 + j]);
+                memmove(b, &b[nc*_q->M], (_q->h_len-1)*sizeof(float complex));
+            }
+        }
+
+        n0 += nc;
+    }
+}
+
+//
+// internal methods
+//
+
+static void ncobank_crcf_set_lane_frequency(ncobank_crcf _q,
+                                            unsigned int _i,
+                                            float        _f)
+{
+    _q->d_theta[_i] = nco_crcf_constrain(_f);
+
+    // rotator exp(-j 2 d_theta) from the fixed-point frequency
+    double dphi = 4*M_PI*(double)_q->d_theta[_i]/4294967296.0;
+    _q->rot[8*(_i/4) + (_i%4)    ] = (float) cos(dphi);
+    _q->rot[8*(_i/4) + (_i%4) + 4] = (float)-sin(dphi);
+}
+
+#if NCOBANK_USE_SSE2
+static void ncobank_crcf_mix_group(ncobank_crcf    _q,
+                                   unsigned int    _g,
+                                   float complex * _x,
+                                   unsigned int    _n,
+                                   float complex **_y)
+{
+    uint32_t *    theta   = &_q->theta[4*_g];
+    uint32_t *    d_theta = &_q->d_theta[4*_g];
+    const float * x = (const float*) _x;
+    __m128 rr = _mm_loadu_ps(&_q->rot[8*_g  ]);
+    __m128 ri = _mm_loadu_ps(&_q->rot[8*_g+4]);
+    float p[16];
+    unsigned int i, t, l;
+    for (i=0; i<_n; i+=NCOBANK_ANCHOR) {
+        unsigned int ns = _n - i < NCOBANK_ANCHOR ? _n - i : NCOBANK_ANCHOR;
+
+        // anchor even and odd phasors exp(-j theta), exp(-j (theta+d_theta))
+        for (l=0; l<4; l++) {
+            nco_crcf_sincos_fixed(_q->nco, theta[l],            &p[l+ 4], &p[l   ]);
+            nco_crcf_sincos_fixed(_q->nco, theta[l]+d_theta[l], &p[l+12], &p[l+ 8]);
+            p[l+ 4] = -p[l+ 4];
+            p[l+12] = -p[l+12];
+            theta[l] += ns*d_theta[l];
+        }
+        __m128 vr0 = _mm_loadu_ps(&p[ 0]);
+        __m128 vi0 = _mm_loadu_ps(&p[ 4]);
+        __m128 vr1 = _mm_loadu_ps(&p[ 8]);
+        __m128 vi1 = _mm_loadu_ps(&p[12]);
+
+        for (t=i; t+1<i+ns; t+=2) {
+            // mix two input samples with all four phasors each
+            __m128 xr0 = _mm_set1_ps(x[2*t  ]);
+            __m128 xi0 = _mm_set1_ps(x[2*t+1]);
+            __m128 xr1 = _mm_set1_ps(x[2*t+2]);
+            __m128 xi1 = _mm_set1_ps(x[2*t+3]);
+            __m128 yr0 = _mm_sub_ps(_mm_mul_ps(xr0,vr0), _mm_mul_ps(xi0,vi0));
+            __m128 yi0 = _mm_add_ps(_mm_mul_ps(xr0,vi0), _mm_mul_ps(xi0,vr0));
+            __m128 yr1 = _mm_sub_ps(_mm_mul_ps(xr1,vr1), _mm_mul_ps(xi1,vi1));
+            __m128 yi1 = _mm_add_ps(_mm_mul_ps(xr1,vi1), _mm_mul_ps(xi1,vr1));
+
+            // advance phasors by two samples
+            __m128 ur0 = _mm_sub_ps(_mm_mul_ps(vr0,rr), _mm_mul_ps(vi0,ri));
+            __m128 ui0 = _mm_add_ps(_mm_mul_ps(vr0,ri), _mm_mul_ps(vi0,rr));
+            __m128 ur1 = _mm_sub_ps(_mm_mul_ps(vr1,rr), _mm_mul_ps(vi1,ri));
+            __m128 ui1 = _mm_add_ps(_mm_mul_ps(vr1,ri), _mm_mul_ps(vi1,rr));
+            vr0 = ur0; vi0 = ui0;
+            vr1 = ur1; vi1 = ui1;
+
+            // transpose to carriers: {y[t], y[t+1]} for each lane
+            __m128 a01 = _mm_unpacklo_ps(yr0, yi0);
+            __m128 a23 = _mm_unpackhi_ps(yr0, yi0);
+            __m128 b01 = _mm_unpacklo_ps(yr1, yi1);
+            __m128 b23 = _mm_unpackhi_ps(yr1, yi1);
+            _mm_storeu_ps((float*)&_y[0][t], _mm_movelh_ps(a01, b01));
+            _mm_storeu_ps((float*)&_y[1][t], _mm_movehl_ps(b01, a01));
+            _mm_storeu_ps((float*)&_y[2][t], _mm_movelh_ps(a23, b23));
+            _mm_storeu_ps((float*)&_y[3][t], _mm_movehl_ps(b23, a23));
+        }
+        if (t < i+ns) {
+            // remaining (even) input sample
+            __m128 xr = _mm_set1_ps(x[2*t  ]);
+            __m128 xi = _mm_set1_ps(x[2*t+1]);
+            __m128 yr = _mm_sub_ps(_mm_mul_ps(xr,vr0), _mm_mul_ps(xi,vi0));
+            __m128 yi = _mm_add_ps(_mm_mul_ps(xr,vi0), _mm_mul_ps(xi,vr0));
+            __m128 y01 = _mm_unpacklo_ps(yr, yi);
+            __m128 y23 = _mm_unpackhi_ps(yr, yi);
+            _mm_storel_pi((__m64*)&_y[0][t], y01);
+            _mm_storeh_pi((__m64*)&_y[1][t], y01);
+            _mm_storel_pi((__m64*)&_y[2][t], y23);
+            _mm_storeh_pi((__m64*)&_y[3][t], y23);
+        }
+    }
+}
+#else
+static void ncobank_crcf_mix_group(ncobank_crcf    _q,
+                                   unsigned int    _g,
+                                   float complex * _x,
+                                   unsigned int    _n,
+                                   float complex **_y)
+{
+    uint32_t *    theta   = &_q->theta[4*_g];
+    uint32_t *    d_theta = &_q->d_theta[4*_g];
+    const float * rr = &_q->rot[8*_g  ];
+    const float * ri = &_q->rot[8*_g+4];
+    unsigned int i, t, l, k;
+    for (i=0; i<_n; i+=NCOBANK_ANCHOR) {
+        unsigned int ns = _n - i < NCOBANK_ANCHOR ? _n - i : NCOBANK_ANCHOR;
+        for (l=0; l<4; l++) {
+            for (k=0; k<2; k++) {
+                // anchor even (k=0) or odd (k=1) phasor exp(-j theta)
+                float vr, vi;
+                nco_crcf_sincos_fixed(_q->nco, theta[l] + k*d_theta[l], &vi, &vr);
+                vi = -vi;
+
+                for (t=i+k; t<i+ns; t+=2) {
+                    float xr = crealf(_x[t]);
+                    float xi = cimagf(_x[t]);
+                    _y[l][t] = (xr*vr - xi*vi) + _Complex_I*(xr*vi + xi*vr);
+
+                    float ur = vr*rr[l] - vi*ri[l];
+                    float ui = vr*ri[l] + vi*rr[l];
+                    vr = ur;
+                    vi = ui;
+                }
+            }
+            theta[l] += ns*d_theta[l];
+        }
+    }
+}
+#endif
+
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <complex.h>
+#include "autotest/autotest.h"
+#include "liquid.h"
+
+// Compare digital down-converter against the chain of objects it
+// replaces: nco_crcf (mix down) -> firdecim_crcf, calling the
+// down-converter with blocks of varying size
+//  _M      :   decimation rate
+//  _h_len  :   filter length (0: Kaiser design with delay 4)
+void ddc_crcf_test(unsigned int _M,
+                   unsigned int _h_len)
+{
+    float        fc          = 0.7123f;
+    unsigned int num_outputs = 611;
+    unsigned int num_inputs  = num_outputs*_M;
+    float        tol         = 1e-4f;
+
+    // objects
+    nco_crcf      nco = nco_crcf_create(LIQUID_NCO_INTERP);
+    firdecim_crcf decim;
+    ddc_crcf      q;
+    nco_crcf_set_frequency(nco, fc);
+    if (_h_len == 0) {
+        decim = firdecim_crcf_create_kaiser(_M, 4, 60.0f);
+        q     = ddc_crcf_create_kaiser(fc, _M, 4, 60.0f);
+    } else {
+        float h[_h_len];
+        liquid_firdes_kaiser(_h_len, 0.4f/(float)_M, 60.0f, 0.0f, h);
+        decim = firdecim_crcf_create(_M, h, _h_len);
+        q     = ddc_crcf_create(fc, _M, h, _h_len);
+    }
+
+    // input: signal near carrier frequency plus noise
+    unsigned int i;
+    float complex x[num_inputs];
+    float complex v[num_inputs];
+    float complex y0[num_outputs];
+    float complex y1[num_outputs];
+    for (i=0; i<num_inputs; i++)
+        x[i] = 3.0f*cexpf(_Complex_I*(fc + 0.01f)*i) + 0.1f*(randnf() + _Complex_I*randnf());
+
+    // reference chain
+    nco_crcf_mix_block_down(nco, x, v, num_inputs);
+    firdecim_crcf_execute_block(decim, v, num_outputs, y0);
+
+    // down-converter in blocks of varying size
+    unsigned int n = 0;
+    unsigned int b = 1;
+    while (n < num_outputs) {
+        unsigned int m = b < num_outputs - n ? b : num_outputs - n;
+        if (m == 1)
+            ddc_crcf_execute(q, &x[n*_M], &y1[n]);
+        else
+            ddc_crcf_execute_block(q, &x[n*_M], m, &y1[n]);
+        n += m;
+        b = 2*b + 1;
+    }
+
+    for (i=0; i<num_outputs; i++) {
+        CONTEND_DELTA(crealf(y1[i]), crealf(y0[i]), tol);
+        CONTEND_DELTA(cimagf(y1[i]), cimagf(y0[i]), tol);
+    }
+    CONTEND_DELTA(ddc_crcf_get_frequency(q), nco_crcf_get_frequency(nco), 1e-6f);
+    CONTEND_DELTA(ddc_crcf_get_phase(q),     nco_crcf_get_phase(nco),     1e-5f);
+
+    nco_crcf_destroy(nco);
+    firdecim_crcf_destroy(decim);
+    ddc_crcf_destroy(q);
+}
+
+// AUTOTESTS: mixing and decimation
+void autotest_ddc_crcf_M1_h7()      { ddc_crcf_test(  1,   7); }
+void autotest_ddc_crcf_M4_h33()     { ddc_crcf_test(  4,  33); }
+void autotest_ddc_crcf_M7_h20()     { ddc_crcf_test(  7,  20); }
+void autotest_ddc_crcf_M300_h601()  { ddc_crcf_test(300, 601); }
+void autotest_ddc_crcf_kaiser_M8()  { ddc_crcf_test(  8,   0); }
+
+// Test automatic gain control: output level converges to unity and the
+// signal level agrees with that of agc_crcf run on the reference chain
+//  _M      :   decimation rate
+//  _level  :   input signal level
+void ddc_crcf_agc_test(unsigned int _M,
+                       float        _level)
+{
+    float        fc          = -0.4f;
+    unsigned int num_outputs = 4000;
+    unsigned int num_inputs  = num_outputs*_M;
+    float        bt          = 0.02f;
+
+    ddc_crcf      q     = ddc_crcf_create_kaiser(fc, _M, 4, 60.0f);
+    nco_crcf      nco   = nco_crcf_create(LIQUID_NCO_INTERP);
+    firdecim_crcf decim = firdecim_crcf_create_kaiser(_M, 4, 60.0f);
+    agc_crcf      agc   = agc_crcf_create();
+    ddc_crcf_agc_enable(q);
+    ddc_crcf_agc_set_bandwidth(q, bt);
+    nco_crcf_set_frequency(nco, fc);
+    agc_crcf_set_bandwidth(agc, bt);
+
+    // modulated signal near carrier frequency
+    unsigned int i;
+    float complex * x = (float complex*) malloc(num_inputs*sizeof(float complex));
+    float complex * v = (float complex*) malloc(num_inputs*sizeof(float complex));
+    float complex * y = (float complex*) malloc(num_outputs*sizeof(float complex));
+    for (i=0; i<num_inputs; i++)
+        x[i] = _level*cexpf(_Complex_I*(fc*i + 0.3f*sinf(0.01f*i)));
+
+    ddc_crcf_execute_block(q, x, num_outputs, y);
+    nco_crcf_mix_block_down(nco, x, v, num_inputs);
+    firdecim_crcf_execute_block(decim, v, num_outputs, v);
+    agc_crcf_execute_block(agc, v, num_outputs, v);
+
+    // output energy over last quarter
+    float e = 0.0f;
+    for (i=3*num_outputs/4; i<num_outputs; i++)
+        e += crealf(y[i]*conjf(y[i]));
+    e /= (float)(num_outputs/4);
+    CONTEND_DELTA(e, 1.0f, 0.02f);
+    CONTEND_DELTA(ddc_crcf_agc_get_rssi(q), agc_crcf_get_rssi(agc), 0.1f);
+
+    if (liquid_autotest_verbose) {
+        printf("  output energy : %8.5f, rssi : %8.3f dB (agc_crcf: %8.3f dB)\n",
+                e, ddc_crcf_agc_get_rssi(q), agc_crcf_get_rssi(agc));
+    }
+
+    free(x);
+    free(v);
+    free(y);
+    ddc_crcf_destroy(q);
+    nco_crcf_destroy(nco);
+    firdecim_crcf_destroy(decim);
+    agc_crcf_destroy(agc);
+}
+
+// AUTOTESTS: automatic gain control
+void autotest_ddc_crcf_agc_M4()     { ddc_crcf_agc_test( 4,  3.0f); }
+void autotest_ddc_crcf_agc_M16()    { ddc_crcf_agc_test(16,  0.01f); }
+void autotest_ddc_crcf_agc_M64()    { ddc_crcf_agc_test(64, 50.0f); }
+
+// AUTOTEST: DC offset on input is removed
+void autotest_ddc_crcf_dc()
+{
+    float         fc  = 0.3f;
+    unsigned int  M   = 4;
+    unsigned int  n   = 20000;  // output samples
+    float complex dc  = 0.5f - 0.3f*_Complex_I;
+    float         tol = 2e-3f;
+
+    ddc_crcf q0 = ddc_crcf_create_kaiser(fc, M, 6, 60.0f);
+    ddc_crcf q1 = ddc_crcf_create_kaiser(fc, M, 6, 60.0f);
+    ddc_crcf_dc_enable(q1);
+    ddc_crcf_dc_set_bandwidth(q1, 2e-4f);
+
+    // tone near carrier without (q0) and with (q1) DC offset
+    unsigned int i;
+    float complex * x0 = (float complex*) malloc(n*M*sizeof(float complex));
+    float complex * x1 = (float complex*) malloc(n*M*sizeof(float complex));
+    float complex * y0 = (float complex*) malloc(n*sizeof(float complex));
+    float complex * y1 = (float complex*) malloc(n*sizeof(float complex));
+    for (i=0; i<n*M; i++) {
+        x0[i] = cexpf(_Complex_I*(fc + 0.05f)*i);
+        x1[i] = x0[i] + dc;
+    }
+    ddc_crcf_execute_block(q0, x0, n, y0);
+    ddc_crcf_execute_block(q1, x1, n, y1);
+
+    // estimate converges to offset and outputs agree once settled (the
+    // filter has a pass-band gain of M)
+    float complex e = ddc_crcf_dc_get_offset(q1);
+    CONTEND_DELTA(crealf(e), crealf(dc), tol);
+    CONTEND_DELTA(cimagf(e), cimagf(dc), tol);
+    for (i=3*n/4; i<n; i++) {
+        CONTEND_DELTA(crealf(y1[i]), crealf(y0[i]), M*tol);
+        CONTEND_DELTA(cimagf(y1[i]), cimagf(y0[i]), M*tol);
+    }
+
+    free(x0);
+    free(x1);
+    free(y0);
+    free(y1);
+    ddc_crcf_destroy(q0);
+    ddc_crcf_destroy(q1);
+}
+
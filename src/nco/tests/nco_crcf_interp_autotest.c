@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <complex.h>
+#include "autotest/autotest.h"
+#include "liquid.h"
+
+// test accuracy of interpolated quarter-wave table against the bound of
+// linear interpolation, (pi/2/L)^2/8, plus single-precision round-off
+//  _m      :   log2 of table length
+void nco_crcf_interp_accuracy_test(unsigned int _m)
+{
+    nco_crcf q = nco_crcf_create_interp(_m);
+
+    float dx  = 0.5f*M_PI / (float)(1U << _m);
+    float tol = dx*dx/8.0f + 4e-7f;
+
+    // step through phases not aligned to the table
+    nco_crcf_set_phase(q, -M_PI);
+    nco_crcf_set_frequency(q, 0.001234567f);
+    unsigned int i;
+    float emax = 0.0f;
+    for (i=0; i<6000; i++) {
+        double theta = nco_crcf_get_phase(q);
+        float s, c;
+        nco_crcf_sincos(q, &s, &c);
+        float es = fabsf(s - sin(theta));
+        float ec = fabsf(c - cos(theta));
+        emax = es > emax ? es : emax;
+        emax = ec > emax ? ec : emax;
+        nco_crcf_step(q);
+    }
+    if (liquid_autotest_verbose)
+        printf("  table 2^%-2u : max error %12.4e (bound %12.4e)\n", _m, emax, tol);
+    CONTEND_LESS_THAN(emax, tol);
+
+    nco_crcf_destroy(q);
+}
+
+void autotest_nco_crcf_interp_accuracy_m4()  { nco_crcf_interp_accuracy_test( 4); }
+void autotest_nco_crcf_interp_accuracy_m6()  { nco_crcf_interp_accuracy_test( 6); }
+void autotest_nco_crcf_interp_accuracy_m8()  { nco_crcf_interp_accuracy_test( 8); }
+void autotest_nco_crcf_interp_accuracy_m10() { nco_crcf_interp_accuracy_test(10); }
+void autotest_nco_crcf_interp_accuracy_m12() { nco_crcf_interp_accuracy_test(12); }
+
+// test spurious-free dynamic range of the interpolated table; a Kaiser
+// window keeps leakage of the carrier well below the spurs, and bins
+// within its main lobe are ignored
+//  _m          :   log2 of table length
+//  _sfdr_min   :   minimum spurious-free dynamic range [dB]
+void nco_crcf_interp_sfdr_test(unsigned int _m,
+                               float        _sfdr_min)
+{
+    unsigned int nfft = 1 << 16;
+    unsigned int bin  = 5003;   // approximate carrier bin
+    unsigned int w    = 24;     // main lobe half-width [bins]
+
+    nco_crcf q = nco_crcf_create_interp(_m);
+    nco_crcf_set_frequency(q, 2*M_PI*(float)bin/(float)nfft);
+    nco_crcf_set_phase(q, 0.3f);
+
+    float complex * x = (float complex*) malloc(nfft*sizeof(float complex));
+    float complex * X = (float complex*) malloc(nfft*sizeof(float complex));
+    unsigned int i;
+    for (i=0; i<nfft; i++)
+        x[i] = kaiser(i, nfft, 20.0f, 0.0f);
+    nco_crcf_mix_block_up(q, x, x, nfft);
+    fft_run(nfft, x, X, LIQUID_FFT_FORWARD, 0);
+
+    // largest spur relative to carrier
+    float spur    = 0.0f;
+    float carrier = 0.0f;
+    for (i=0; i<nfft; i++) {
+        float v = crealf(X[i])*crealf(X[i]) + cimagf(X[i])*cimagf(X[i]);
+        if (i + w < bin || i > bin + w)
+            spur = v > spur ? v : spur;
+        else
+            carrier = v > carrier ? v : carrier;
+    }
+    float sfdr = 10*log10f(carrier / spur);
+    if (liquid_autotest_verbose)
+        printf("  table 2^%-2u : SFDR %8.2f dB\n", _m, sfdr);
+    CONTEND_GREATER_THAN(sfdr, _sfdr_min);
+
+    free(x);
+    free(X);
+    nco_crcf_destroy(q);
+}
+
+void autotest_nco_crcf_interp_sfdr_m4()  { nco_crcf_interp_sfdr_test( 4,  65.0f); }
+void autotest_nco_crcf_interp_sfdr_m6()  { nco_crcf_interp_sfdr_test( 6,  90.0f); }
+void autotest_nco_crcf_interp_sfdr_m8()  { nco_crcf_interp_sfdr_test( 8, 110.0f); }
+void autotest_nco_crcf_interp_sfdr_m10() { nco_crcf_interp_sfdr_test(10, 120.0f); }
+
+// block mixing must match single-sample mixing and stepping exactly
+//  _type   :   NCO type
+void nco_crcf_mix_block_test(liquid_ncotype _type)
+{
+    unsigned int n = 203;   // not a multiple of the SIMD width
+
+    nco_crcf q0 = nco_crcf_create(_type);
+    nco_crcf q1 = nco_crcf_create(_type);
+
+    float complex x[n];
+    float complex y0[n];
+    float complex y1[n];
+    unsigned int i;
+    for (i=0; i<n; i++)
+        x[i] = randnf() + _Complex_I*randnf();
+
+    // up, then down, with large frequency to cover all quadrants
+    unsigned int d;
+    for (d=0; d<2; d++) {
+        nco_crcf_set_phase(q0, -2.9f);
+        nco_crcf_set_phase(q1, -2.9f);
+        nco_crcf_set_frequency(q0, 1.234567f);
+        nco_crcf_set_frequency(q1, 1.234567f);
+        for (i=0; i<n; i++) {
+            if (d==0) nco_crcf_mix_up  (q0, x[i], &y0[i]);
+            else      nco_crcf_mix_down(q0, x[i], &y0[i]);
+            nco_crcf_step(q0);
+        }
+        if (d==0) nco_crcf_mix_block_up  (q1, x, y1, n);
+        else      nco_crcf_mix_block_down(q1, x, y1, n);
+
+        for (i=0; i<n; i++) {
+            CONTEND_EQUALITY(crealf(y0[i]), crealf(y1[i]));
+            CONTEND_EQUALITY(cimagf(y0[i]), cimagf(y1[i]));
+        }
+        CONTEND_EQUALITY(nco_crcf_get_phase(q0), nco_crcf_get_phase(q1));
+    }
+
+    nco_crcf_destroy(q0);
+    nco_crcf_destroy(q1);
+}
+
+void autotest_nco_crcf_mix_block_nco()    { nco_crcf_mix_block_test(LIQUID_NCO);        }
+void autotest_nco_crcf_mix_block_vco()    { nco_crcf_mix_block_test(LIQUID_VCO);        }
+void autotest_nco_crcf_mix_block_interp() { nco_crcf_mix_block_test(LIQUID_NCO_INTERP); }
+
+// fixed-point phase accumulator wraps exactly: a frequency of 3/256
+// cycles per sample returns to the initial phase after 2^20 steps
+void autotest_nco_crcf_phase_wrap()
+{
+    nco_crcf q = nco_crcf_create(LIQUID_NCO_INTERP);
+    float phi = 1.0f;
+    nco_crcf_set_phase(q, phi);
+    nco_crcf_set_frequency(q, 2*M_PI*3.0f/256.0f);
+    float phi0 = nco_crcf_get_phase(q);
+
+    unsigned int i;
+    for (i=0; i<(1U<<20); i++)
+        nco_crcf_step(q);
+
+    CONTEND_EQUALITY(nco_crcf_get_phase(q), phi0);
+    CONTEND_DELTA(phi0, phi, 1e-6f);
+    nco_crcf_destroy(q);
+}
+
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <complex.h>
+#include "autotest/autotest.h"
+#include "liquid.h"
+
+//
+// test block phase-locked loop
+//  _type           :   NCO type (e.g. LIQUID_NCO)
+//  _order          :   detector order (M-PSK modulation with M = _order)
+//  _interval       :   loop-filter update interval
+//  _phase_offset   :   initial phase offset
+//  _freq_offset    :   initial frequency offset
+//  _pll_bandwidth  :   bandwidth of phase-locked loop
+//  _num_samples    :   number of samples to run
+//  _tol            :   error tolerance
+void nco_crcf_pll_block_test(int          _type,
+                             unsigned int _order,
+                             unsigned int _interval,
+                             float        _phase_offset,
+                             float        _freq_offset,
+                             float        _pll_bandwidth,
+                             unsigned int _num_samples,
+                             float        _tol)
+{
+    nco_crcf nco_tx = nco_crcf_create(LIQUID_VCO);
+    nco_crcf nco_rx = nco_crcf_create(_type);
+
+    nco_crcf_set_phase(nco_tx, _phase_offset);
+    nco_crcf_set_frequency(nco_tx, _freq_offset);
+    nco_crcf_pll_set_bandwidth(nco_rx, _pll_bandwidth);
+    nco_crcf_pll_set_interval(nco_rx, _interval);
+    nco_crcf_pll_set_order(nco_rx, _order);
+
+    // generate M-PSK symbols with carrier offset
+    unsigned int i;
+    float complex s[_num_samples];
+    float complex x[_num_samples];
+    float complex y[_num_samples];
+    for (i=0; i<_num_samples; i++) {
+        s[i] = cexpf(_Complex_I*2*M_PI*(float)(rand() % _order)/(float)_order);
+        nco_crcf_mix_up(nco_tx, s[i], &x[i]);
+        nco_crcf_step(nco_tx);
+    }
+
+    // track carrier in blocks of varying size
+    unsigned int n = 0;
+    while (n < _num_samples) {
+        unsigned int b = 1 + rand() % 100;
+        b = b < _num_samples - n ? b : _num_samples - n;
+        nco_crcf_pll_mix_block_down(nco_rx, &x[n], &y[n], b);
+        n += b;
+    }
+
+    // ensure output is de-rotated over last quarter of samples (the
+    // M-PSK phase ambiguity is resolved by the M-th power)
+    for (i=3*_num_samples/4; i<_num_samples; i++) {
+        float e = cargf(cpowf(y[i]*conjf(s[i]), (float)_order)) / (float)_order;
+        CONTEND_DELTA(e, 0.0f, _tol);
+    }
+
+    // ensure frequency of oscillators is locked
+    float nco_tx_freq = nco_crcf_get_frequency(nco_tx);
+    float nco_rx_freq = nco_crcf_get_frequency(nco_rx);
+    CONTEND_DELTA(nco_tx_freq, nco_rx_freq, _tol);
+
+    if (liquid_autotest_verbose) {
+        printf("  phase error : %12.4e, frequency error : %12.4e\n",
+                cargf(y[_num_samples-1]*conjf(s[_num_samples-1])),
+                nco_tx_freq-nco_rx_freq);
+    }
+
+    nco_crcf_destroy(nco_tx);
+    nco_crcf_destroy(nco_rx);
+}
+
+// AUTOTEST: carrier (pilot) tracking
+void autotest_nco_crcf_pll_block_carrier()
+{
+    nco_crcf_pll_block_test(LIQUID_VCO, 1,  1,  M_PI/1.1f, 0.0f, 0.10f, 256, 1e-3f);
+    nco_crcf_pll_block_test(LIQUID_VCO, 1,  8, -M_PI/2.0f, 0.0f, 0.01f, 2000, 1e-3f);
+    nco_crcf_pll_block_test(LIQUID_VCO, 1, 16,  0.0f,      0.1f, 0.01f, 4000, 1e-3f);
+    nco_crcf_pll_block_test(LIQUID_VCO, 1, 32,  1.0f,    -0.05f, 1e-3f, 8000, 1e-3f);
+}
+
+// AUTOTEST: long update intervals at default and narrow bandwidths (loop
+// gains must be limited for the update rate to remain stable)
+void autotest_nco_crcf_pll_block_interval()
+{
+    unsigned int interval;
+    for (interval=8; interval<=64; interval*=2) {
+        nco_crcf_pll_block_test(LIQUID_VCO, 1, interval, 0.5f, 0.0f,  0.10f, 2000, 1e-3f);
+        nco_crcf_pll_block_test(LIQUID_VCO, 1, interval, 0.5f, 0.02f, 0.10f, 4000, 1e-3f);
+        nco_crcf_pll_block_test(LIQUID_VCO, 1, interval, 0.5f, 0.02f, 0.01f, 4000, 1e-3f);
+    }
+}
+
+// AUTOTEST: suppressed-carrier tracking of M-PSK
+void autotest_nco_crcf_pll_block_bpsk()
+{
+    nco_crcf_pll_block_test(LIQUID_VCO,        2, 16,  0.5f,  0.02f, 0.005f, 4000, 1e-3f);
+}
+void autotest_nco_crcf_pll_block_qpsk()
+{
+    nco_crcf_pll_block_test(LIQUID_VCO,        4, 16, -0.3f, -0.01f, 0.005f, 4000, 1e-3f);
+    nco_crcf_pll_block_test(LIQUID_NCO_INTERP, 4, 32,  0.2f,  0.01f, 0.002f, 8000, 1e-3f);
+}
+void autotest_nco_crcf_pll_block_8psk()
+{
+    nco_crcf_pll_block_test(LIQUID_NCO_INTERP, 8, 32,  0.1f, 0.001f, 0.001f, 8000, 1e-3f);
+}
+
+// AUTOTEST: output does not depend on block size (aside from rounding
+// of the phase detector sum)
+void autotest_nco_crcf_pll_block_invariance()
+{
+    unsigned int n = 1000;
+    nco_crcf q0 = nco_crcf_create(LIQUID_NCO_INTERP);
+    nco_crcf q1 = nco_crcf_create(LIQUID_NCO_INTERP);
+    nco_crcf_pll_set_bandwidth(q0, 0.01f);
+    nco_crcf_pll_set_bandwidth(q1, 0.01f);
+    nco_crcf_pll_set_interval(q0, 12);
+    nco_crcf_pll_set_interval(q1, 12);
+    nco_crcf_pll_set_order(q0, 4);
+    nco_crcf_pll_set_order(q1, 4);
+
+    unsigned int i;
+    float complex x[n], y0[n], y1[n];
+    for (i=0; i<n; i++)
+        x[i] = cexpf(_Complex_I*(0.03f*i + 0.5f*M_PI*(rand() % 4)));
+
+    nco_crcf_pll_mix_block_down(q0, x, y0, n);
+    unsigned int b, j = 0;
+    for (b=1; j<n; b++) {
+        unsigned int m = b < n - j ? b : n - j;
+        nco_crcf_pll_mix_block_down(q1, &x[j], &y1[j], m);
+        j += m;
+    }
+    for (i=0; i<n; i++) {
+        CONTEND_DELTA(crealf(y0[i]), crealf(y1[i]), 1e-4f);
+        CONTEND_DELTA(cimagf(y0[i]), cimagf(y1[i]), 1e-4f);
+    }
+
+    nco_crcf_destroy(q0);
+    nco_crcf_destroy(q1);
+}
+
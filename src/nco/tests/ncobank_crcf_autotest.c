@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2007 - 2015 Joseph Gaeddert
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <complex.h>
+#include "autotest/autotest.h"
+#include "liquid.h"
+
+// compare nco bank against separate oscillators (precise VCO type)
+// followed by decimators; the input is processed in several calls of
+// different length to cover chunk boundaries
+//  _num    :   number of carriers
+//  _M      :   decimation rate (0: no decimator)
+//  _h_len  :   filter length
+void ncobank_crcf_test(unsigned int _num,
+                       unsigned int _M,
+                       unsigned int _h_len)
+{
+    float tol = 2e-5f;
+    unsigned int M = _M == 0 ? 1 : _M;
+    unsigned int n[3] = {37, 300, 1};  // outputs per call
+    unsigned int num_outputs = n[0] + n[1] + n[2];
+    unsigned int num_inputs  = num_outputs * M;
+
+    // carriers with random frequency and phase
+    unsigned int i, k;
+    float freqs[_num];
+    float phase[_num];
+    for (k=0; k<_num; k++) {
+        freqs[k] = 2*M_PI*(randf() - 0.5f);
+        phase[k] = 2*M_PI*randf();
+    }
+    float h[_h_len > 0 ? _h_len : 1];
+    for (i=0; i<_h_len; i++)
+        h[i] = randnf() / (float)_h_len;
+
+    ncobank_crcf q = _M == 0 ? ncobank_crcf_create(_num, freqs) :
+                               ncobank_crcf_create_decim(_num, freqs, _M, h, _h_len);
+    CONTEND_EQUALITY(ncobank_crcf_get_num_carriers(q), _num);
+    CONTEND_EQUALITY(ncobank_crcf_get_decim_rate(q),   M);
+    for (k=0; k<_num; k++)
+        ncobank_crcf_set_phase(q, k, phase[k]);
+
+    float complex * x  = (float complex*) malloc(num_inputs*sizeof(float complex));
+    float complex * v  = (float complex*) malloc(num_inputs*sizeof(float complex));
+    float complex * y0 = (float complex*) malloc(num_outputs*sizeof(float complex));
+    float complex * y1 = (float complex*) malloc(_num*num_outputs*sizeof(float complex));
+    for (i=0; i<num_inputs; i++)
+        x[i] = randnf() + _Complex_I*randnf();
+
+    // run bank
+    unsigned int j, n0 = 0;
+    for (j=0; j<3; j++) {
+        float complex y[_num*n[j]];
+        ncobank_crcf_execute(q, &x[n0*M], n[j], y);
+        for (k=0; k<_num; k++)
+            memmove(&y1[k*num_outputs + n0], &y[k*n[j]], n[j]*sizeof(float complex));
+        n0 += n[j];
+    }
+
+    // compare each carrier against reference chain
+    for (k=0; k<_num; k++) {
+        nco_crcf nco = nco_crcf_create(LIQUID_VCO);
+        nco_crcf_set_frequency(nco, freqs[k]);
+        nco_crcf_set_phase(nco, phase[k]);
+        nco_crcf_mix_block_down(nco, x, v, num_inputs);
+        if (_M == 0) {
+            memmove(y0, v, num_outputs*sizeof(float complex));
+        } else {
+            firdecim_crcf d = firdecim_crcf_create(_M, h, _h_len);
+            firdecim_crcf_execute_block(d, v, num_outputs, y0);
+            firdecim_crcf_destroy(d);
+        }
+
+        for (i=0; i<num_outputs; i++) {
+            CONTEND_DELTA(crealf(y1[k*num_outputs+i]), crealf(y0[i]), tol);
+            CONTEND_DELTA(cimagf(y1[k*num_outputs+i]), cimagf(y0[i]), tol);
+        }
+
+        // oscillator state must agree
+        CONTEND_DELTA(ncobank_crcf_get_frequency(q,k), nco_crcf_get_frequency(nco), 1e-6f);
+        CONTEND_DELTA(cargf(cexpf(_Complex_I*(ncobank_crcf_get_phase(q,k) - nco_crcf_get_phase(nco)))), 0.0f, 1e-5f);
+        nco_crcf_destroy(nco);
+    }
+
+    free(x);
+    free(v);
+    free(y0);
+    free(y1);
+    ncobank_crcf_destroy(q);
+}
+
+// AUTOTESTS: mixing only
+void autotest_ncobank_crcf_n1()         { ncobank_crcf_test( 1,   0,   0); }
+void autotest_ncobank_crcf_n5()         { ncobank_crcf_test( 5,   0,   0); }
+void autotest_ncobank_crcf_n16()        { ncobank_crcf_test(16,   0,   0); }
+
+// AUTOTESTS: mixing and decimation
+void autotest_ncobank_crcf_decim_n8_M4()    { ncobank_crcf_test( 8,   4,  33); }
+void autotest_ncobank_crcf_decim_n13_M3()   { ncobank_crcf_test(13,   3,  20); }
+void autotest_ncobank_crcf_decim_n2_M1()    { ncobank_crcf_test( 2,   1,   7); }
+void autotest_ncobank_crcf_decim_n3_M300()  { ncobank_crcf_test( 3, 300, 601); }
+